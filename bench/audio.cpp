@@ -0,0 +1,270 @@
+#include <benchmark/benchmark.h>
+#include <audio_decoder.h>
+#include <audio_generic.h>
+#include <audio_secache.h>
+#include <decoder_fmmidi.h>
+#include <decoder_midigeneric.h>
+#include <output.h>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+/*
+ * Audio decoding, SE caching and mixing through GenericAudio::Decode.
+ * The clips are generated: a PCM WAV and a short MIDI song. The other
+ * decoders need encoded files that are not part of the repository.
+ * Rates are in output sample frames per second.
+ */
+
+namespace {
+
+constexpr int output_frequency = 44100;
+constexpr int output_chunk_frames = 1024;
+constexpr int max_se = 16;
+
+void WriteLE(std::string& out, uint32_t value, int bytes) {
+	for (int i = 0; i < bytes; ++i) {
+		out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+	}
+}
+
+void WriteBE(std::string& out, uint32_t value, int bytes) {
+	for (int i = bytes - 1; i >= 0; --i) {
+		out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+	}
+}
+
+/** @return PCM S16 WAV file of a sine tone */
+std::string MakeWav(int frequency, int channels, int frames) {
+	const uint32_t data_size = frames * channels * 2;
+
+	std::string wav = "RIFF";
+	WriteLE(wav, 36 + data_size, 4);
+	wav += "WAVEfmt ";
+	WriteLE(wav, 16, 4);
+	WriteLE(wav, 1, 2);
+	WriteLE(wav, channels, 2);
+	WriteLE(wav, frequency, 4);
+	WriteLE(wav, frequency * channels * 2, 4);
+	WriteLE(wav, channels * 2, 2);
+	WriteLE(wav, 16, 2);
+	wav += "data";
+	WriteLE(wav, data_size, 4);
+
+	for (int i = 0; i < frames; ++i) {
+		const auto sample = static_cast<int16_t>(std::sin(i * 0.05) * 20000);
+		for (int c = 0; c < channels; ++c) {
+			WriteLE(wav, static_cast<uint16_t>(sample), 2);
+		}
+	}
+	return wav;
+}
+
+/** @return SMF format 0 with chords on four channels, 16 beats at 120 bpm */
+std::string MakeMidi() {
+	std::string track;
+	// Tempo 500000 us per beat
+	track += std::string("\x00\xFF\x51\x03\x07\xA1\x20", 7);
+	for (int ch = 0; ch < 4; ++ch) {
+		// Program change
+		track.push_back(0);
+		track.push_back(static_cast<char>(0xC0 | ch));
+		track.push_back(static_cast<char>(ch * 8));
+	}
+	for (int beat = 0; beat < 16; ++beat) {
+		for (int ch = 0; ch < 4; ++ch) {
+			track.push_back(0);
+			track.push_back(static_cast<char>(0x90 | ch));
+			track.push_back(static_cast<char>(48 + ch * 7 + beat % 5));
+			track.push_back(100);
+		}
+		for (int ch = 0; ch < 4; ++ch) {
+			// Delta 96 ticks, one beat
+			track.push_back(ch == 0 ? 96 : 0);
+			track.push_back(static_cast<char>(0x80 | ch));
+			track.push_back(static_cast<char>(48 + ch * 7 + beat % 5));
+			track.push_back(0);
+		}
+	}
+	track += std::string("\x00\xFF\x2F\x00", 4);
+
+	std::string midi = "MThd";
+	WriteBE(midi, 6, 4);
+	WriteBE(midi, 0, 2);
+	WriteBE(midi, 1, 2);
+	WriteBE(midi, 96, 2);
+	midi += "MTrk";
+	WriteBE(midi, track.size(), 4);
+	midi += track;
+	return midi;
+}
+
+Filesystem_Stream::InputStream MakeStream(const std::string& data) {
+	return Filesystem_Stream::InputStream(new std::stringbuf(data, std::ios_base::in));
+}
+
+/** File in the working directory, removed again on destruction */
+class TempFile {
+public:
+	TempFile(std::string name, const std::string& data) : name(std::move(name)) {
+		std::ofstream out(this->name, std::ios_base::binary);
+		out << data;
+	}
+	~TempFile() {
+		std::remove(name.c_str());
+	}
+	const std::string& GetName() const {
+		return name;
+	}
+private:
+	std::string name;
+};
+
+class BenchAudio : public GenericAudio {
+public:
+	BenchAudio() {
+		SetFormat(output_frequency, AudioDecoder::Format::S16, 2);
+	}
+	void LockMutex() const override {}
+	void UnlockMutex() const override {}
+};
+
+/** Decodes the stream in output sized chunks and counts the frames */
+void DecodeChunks(AudioDecoder& dec, int64_t& frames) {
+	int frequency;
+	AudioDecoder::Format format;
+	int channels;
+	dec.GetFormat(frequency, format, channels);
+	const int frame_size = AudioDecoder::GetSamplesizeForFormat(format) * channels;
+
+	std::vector<uint8_t> buffer(output_chunk_frames * frame_size);
+	while (!dec.IsFinished()) {
+		const int read = dec.Decode(buffer.data(), buffer.size());
+		if (read <= 0) {
+			break;
+		}
+		benchmark::DoNotOptimize(buffer.data());
+		frames += read / frame_size;
+	}
+}
+
+}
+
+static void BM_DecoderWav(benchmark::State& state) {
+	const auto wav = MakeWav(output_frequency, 2, output_frequency * 2);
+
+	int64_t frames = 0;
+	for (auto _: state) {
+		auto is = MakeStream(wav);
+		auto dec = AudioDecoder::Create(is, "clip.wav", false);
+		if (!dec || !dec->Open(std::move(is))) {
+			state.SkipWithError("WAV not supported");
+			return;
+		}
+		DecodeChunks(*dec, frames);
+	}
+
+	state.counters["frames"] = benchmark::Counter(static_cast<double>(frames), benchmark::Counter::kIsRate);
+}
+
+BENCHMARK(BM_DecoderWav);
+
+#ifdef WANT_FMMIDI
+static void BM_DecoderFmMidi(benchmark::State& state) {
+	const auto midi = MakeMidi();
+
+	int64_t frames = 0;
+	for (auto _: state) {
+		GenericMidiDecoder dec(new FmMidiDecoder());
+		if (!dec.Open(MakeStream(midi))) {
+			state.SkipWithError("MIDI not loaded");
+			return;
+		}
+		dec.SetFormat(output_frequency, AudioDecoder::Format::S16, 2);
+		DecodeChunks(dec, frames);
+	}
+
+	state.counters["frames"] = benchmark::Counter(static_cast<double>(frames), benchmark::Counter::kIsRate);
+}
+
+BENCHMARK(BM_DecoderFmMidi);
+#endif
+
+static void BM_SeCache(benchmark::State& state) {
+	// Arg 0: Decoded on every play, 1: played from the cache
+	const bool cached = state.range(0) != 0;
+	TempFile se("bench_audio_se.wav", MakeWav(22050, 1, 22050));
+
+	int64_t frames = 0;
+	for (auto _: state) {
+		if (!cached) {
+			AudioSeCache::Clear();
+		}
+		auto cache = AudioSeCache::Create(se.GetName());
+		if (!cache) {
+			state.SkipWithError("SE not supported");
+			return;
+		}
+		auto dec = cache->CreateSeDecoder(output_frequency, AudioDecoder::Format::S16, 2, 100);
+		auto out = dec->DecodeAll();
+		benchmark::DoNotOptimize(out.data());
+		frames += out.size() / 4;
+	}
+
+	AudioSeCache::Clear();
+	state.counters["frames"] = benchmark::Counter(static_cast<double>(frames), benchmark::Counter::kIsRate);
+}
+
+BENCHMARK(BM_SeCache)->Arg(0)->Arg(1);
+
+static void BM_GenericAudioDecode(benchmark::State& state) {
+	// Arg 0: BGM playing, Arg 1: number of SE playing
+	const bool bgm = state.range(0) != 0;
+	const int num_se = static_cast<int>(state.range(1));
+
+	auto lvl = Output::GetLogLevel();
+	Output::SetLogLevel(LogLevel::Error);
+
+	// The SE last longer than the frames decoded between two restarts
+	constexpr int restart_chunks = 64;
+	TempFile bgm_file("bench_audio_bgm.wav", MakeWav(output_frequency, 2, output_frequency * 4));
+	std::vector<std::unique_ptr<TempFile>> se_files;
+	for (int i = 0; i < num_se; ++i) {
+		se_files.push_back(std::make_unique<TempFile>("bench_audio_se" + std::to_string(i) + ".wav",
+			MakeWav(22050, 1, 22050 * 2)));
+	}
+
+	BenchAudio audio;
+	if (bgm) {
+		audio.BGM_Play(bgm_file.GetName(), 100, 100, 0);
+	}
+
+	std::vector<uint8_t> buffer(output_chunk_frames * 4);
+	int64_t frames = 0;
+	int chunk = 0;
+	for (auto _: state) {
+		if (chunk++ % restart_chunks == 0) {
+			state.PauseTiming();
+			audio.SE_Stop();
+			for (auto& se : se_files) {
+				audio.SE_Play(se->GetName(), 100, 100);
+			}
+			state.ResumeTiming();
+		}
+		audio.Decode(buffer.data(), buffer.size());
+		benchmark::DoNotOptimize(buffer.data());
+		frames += output_chunk_frames;
+	}
+
+	state.counters["frames"] = benchmark::Counter(static_cast<double>(frames), benchmark::Counter::kIsRate);
+
+	audio.SE_Stop();
+	audio.BGM_Stop();
+	AudioSeCache::Clear();
+	Output::SetLogLevel(lvl);
+}
+
+BENCHMARK(BM_GenericAudioDecode)->Args({1, 0})->Args({0, 4})->Args({1, 4})->Args({1, max_se});
+
+BENCHMARK_MAIN();
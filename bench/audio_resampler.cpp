@@ -0,0 +1,81 @@
+#include <benchmark/benchmark.h>
+#include <audio_resampler.h>
+#include <audio_secache.h>
+#include <cmath>
+#include <cstring>
+
+/*
+ * Sound effects converted through AudioResampler to the usual output
+ * format of 44.1 kHz stereo float, at normal and shifted pitch.
+ */
+
+#ifdef USE_AUDIO_RESAMPLER
+
+namespace {
+
+constexpr int se_frames = 22050;
+
+AudioSeRef MakeSe(int frequency) {
+	auto se = std::make_shared<AudioSeData>();
+	se->frequency = frequency;
+	se->format = AudioDecoder::Format::S16;
+	se->channels = 1;
+
+	std::vector<int16_t> samples(se_frames);
+	for (int i = 0; i < se_frames; ++i) {
+		samples[i] = static_cast<int16_t>(std::sin(i * 0.05) * 20000);
+	}
+	se->buffer.resize(samples.size() * sizeof(int16_t));
+	std::memcpy(se->buffer.data(), samples.data(), se->buffer.size());
+	return se;
+}
+
+void Resample(benchmark::State& state, int frequency, AudioResampler::Quality quality) {
+	auto se = MakeSe(frequency);
+	const int pitch = static_cast<int>(state.range(0));
+
+	int64_t frames = 0;
+	for (auto _: state) {
+		AudioResampler resampler(std::make_unique<AudioSeDecoder>(se), quality);
+		Filesystem_Stream::InputStream is;
+		resampler.Open(std::move(is));
+		resampler.SetPitch(pitch);
+		resampler.SetFormat(44100, AudioDecoder::Format::F32, 2);
+
+		auto out = resampler.DecodeAll();
+		benchmark::DoNotOptimize(out.data());
+		frames += se_frames;
+	}
+
+	state.counters["frames"] = benchmark::Counter(static_cast<double>(frames), benchmark::Counter::kIsRate);
+}
+
+}
+
+static void BM_ResampleLow22050(benchmark::State& state) {
+	Resample(state, 22050, AudioResampler::Quality::Low);
+}
+
+BENCHMARK(BM_ResampleLow22050)->Arg(100)->Arg(150);
+
+static void BM_ResampleFast22050(benchmark::State& state) {
+	Resample(state, 22050, AudioResampler::Quality::Fast);
+}
+
+BENCHMARK(BM_ResampleFast22050)->Arg(100)->Arg(150);
+
+static void BM_ResampleLow48000(benchmark::State& state) {
+	Resample(state, 48000, AudioResampler::Quality::Low);
+}
+
+BENCHMARK(BM_ResampleLow48000)->Arg(100)->Arg(150);
+
+static void BM_ResampleFast48000(benchmark::State& state) {
+	Resample(state, 48000, AudioResampler::Quality::Fast);
+}
+
+BENCHMARK(BM_ResampleFast48000)->Arg(100)->Arg(150);
+
+#endif
+
+BENCHMARK_MAIN();
@@ -0,0 +1,226 @@
+#include <benchmark/benchmark.h>
+#include "test_mock_actor.h"
+#include <autobattle.h>
+#include <battle_simulator.h>
+#include <enemyai.h>
+#include <game_battle.h>
+#include <game_battlealgorithm.h>
+#include <game_enemy.h>
+#include <rand.h>
+#include <memory>
+#include <vector>
+
+/*
+ * Battle actions without the battle scene: Execute and Apply of normal
+ * attacks and skills, the action selection of the enemy AI and of the
+ * auto battle and whole battles of the BattleSimulator.
+ * The party has four actors with skills, the troop eight enemies with
+ * attack, skill and defend actions. HP and SP are restored after every
+ * action, so nobody dies.
+ * Rates are in actions, decisions or battles per second.
+ */
+
+namespace {
+
+constexpr int num_actors = 4;
+constexpr int num_enemies = 8;
+constexpr int num_skills = 8;
+constexpr int skill_single = 1;
+constexpr int skill_all = 2;
+
+/** Database, party and troop of the benchmarks, removed again on destruction */
+class BattleFixture {
+public:
+	BattleFixture() : running(Game_Battle::battle_running) {
+		for (int i = 1; i <= num_skills; ++i) {
+			auto* skill = MakeDBSkill(i, 90, 20 + i * 5, 2, 3, 4);
+			skill->sp_cost = i;
+			skill->scope = i == skill_all ? lcf::rpg::Skill::Scope_enemies : lcf::rpg::Skill::Scope_enemy;
+		}
+
+		for (int i = 1; i <= num_actors; ++i) {
+			MakeDBActor(i, 1, 99, 500, 100, 100 + i * 10, 80, 60, 50 + i);
+			Main_Data::game_party->AddActor(i);
+			auto* actor = Main_Data::game_actors->GetActor(i);
+			actor->SetBaseMaxHp(500);
+			actor->SetHp(actor->GetMaxHp());
+			actor->SetBaseMaxSp(100);
+			actor->SetSp(actor->GetMaxSp());
+			actor->SetBaseAtk(100 + i * 10);
+			actor->SetBaseDef(80);
+			actor->SetBaseSpi(60);
+			actor->SetBaseAgi(50 + i);
+			for (int s = 1; s <= num_skills; ++s) {
+				actor->LearnSkill(s, nullptr);
+			}
+		}
+
+		auto& troop = lcf::Data::troops[0];
+		troop.members.resize(num_enemies);
+		for (int i = 1; i <= num_enemies; ++i) {
+			auto* enemy = MakeDBEnemy(i, 800, 100, 90 + i * 5, 70, 50, 40 + i);
+			enemy->actions.push_back(MakeAction(lcf::rpg::EnemyAction::Kind_basic, lcf::rpg::EnemyAction::Basic_attack, 0, 8));
+			enemy->actions.push_back(MakeAction(lcf::rpg::EnemyAction::Kind_skill, 0, skill_single, 6));
+			enemy->actions.push_back(MakeAction(lcf::rpg::EnemyAction::Kind_skill, 0, skill_all, 4));
+			enemy->actions.push_back(MakeAction(lcf::rpg::EnemyAction::Kind_basic, lcf::rpg::EnemyAction::Basic_defense, 0, 2));
+			troop.members[i - 1].enemy_id = i;
+		}
+		Main_Data::game_enemyparty->ResetBattle(1);
+
+		Game_Battle::battle_running = true;
+		Rand::SeedRandomNumberGenerator(1234);
+	}
+
+	~BattleFixture() {
+		Game_Battle::battle_running = running;
+	}
+
+	Game_Actor& GetActor(int i) {
+		return *Main_Data::game_party->GetActors()[i % num_actors];
+	}
+
+	Game_Enemy& GetEnemy(int i) {
+		return *Main_Data::game_enemyparty->GetEnemies()[i % num_enemies];
+	}
+
+	/** Restores HP and SP of everyone after an action */
+	void Restore() {
+		for (auto* actor : Main_Data::game_party->GetActors()) {
+			actor->SetHp(actor->GetMaxHp());
+			actor->SetSp(actor->GetMaxSp());
+			actor->SetBattleAlgorithm(nullptr);
+		}
+		for (auto* enemy : Main_Data::game_enemyparty->GetEnemies()) {
+			enemy->SetHp(enemy->GetMaxHp());
+			enemy->SetSp(enemy->GetMaxSp());
+			enemy->SetBattleAlgorithm(nullptr);
+		}
+	}
+
+private:
+	static lcf::rpg::EnemyAction MakeAction(int kind, int basic, int skill_id, int rating) {
+		lcf::rpg::EnemyAction action;
+		action.kind = kind;
+		action.basic = basic;
+		action.skill_id = skill_id;
+		action.condition_type = lcf::rpg::EnemyAction::ConditionType_always;
+		action.rating = rating;
+		return action;
+	}
+
+	MockActor mock;
+	bool running;
+};
+
+/** Executes and applies the action on all of its targets, as BattleSimulator does */
+void RunAction(Game_BattleAlgorithm::AlgorithmBase& action) {
+	action.TargetFirst();
+	do {
+		action.Execute();
+		action.Apply();
+	} while (action.TargetNext());
+}
+
+}
+
+static void BM_BattleNormal(benchmark::State& state) {
+	BattleFixture fixture;
+
+	int64_t actions = 0;
+	for (auto _: state) {
+		Game_BattleAlgorithm::Normal action(&fixture.GetActor(actions), &fixture.GetEnemy(actions));
+		RunAction(action);
+		fixture.Restore();
+		++actions;
+	}
+
+	state.counters["actions"] = benchmark::Counter(static_cast<double>(actions), benchmark::Counter::kIsRate);
+}
+
+BENCHMARK(BM_BattleNormal);
+
+static void BM_BattleSkill(benchmark::State& state) {
+	// Arg 0: single target or all enemies
+	const bool all = state.range(0) != 0;
+	BattleFixture fixture;
+	const auto& skill = lcf::Data::skills[(all ? skill_all : skill_single) - 1];
+
+	int64_t actions = 0;
+	for (auto _: state) {
+		auto& source = fixture.GetActor(actions);
+		if (all) {
+			Game_BattleAlgorithm::Skill action(&source, Main_Data::game_enemyparty.get(), skill);
+			RunAction(action);
+		} else {
+			Game_BattleAlgorithm::Skill action(&source, &fixture.GetEnemy(actions), skill);
+			RunAction(action);
+		}
+		fixture.Restore();
+		++actions;
+	}
+
+	state.counters["actions"] = benchmark::Counter(static_cast<double>(actions), benchmark::Counter::kIsRate);
+}
+
+BENCHMARK(BM_BattleSkill)->Arg(0)->Arg(1);
+
+static void BM_EnemyAi(benchmark::State& state) {
+	// Arg 0: emulate the RPG_RT bugs
+	const bool emulate_bugs = state.range(0) != 0;
+	BattleFixture fixture;
+
+	int64_t decisions = 0;
+	for (auto _: state) {
+		auto& enemy = fixture.GetEnemy(decisions);
+		EnemyAi::SelectEnemyAiActionRpgRtCompat(enemy, emulate_bugs);
+		benchmark::DoNotOptimize(enemy.GetBattleAlgorithm().get());
+		enemy.SetBattleAlgorithm(nullptr);
+		++decisions;
+	}
+
+	state.counters["decisions"] = benchmark::Counter(static_cast<double>(decisions), benchmark::Counter::kIsRate);
+}
+
+BENCHMARK(BM_EnemyAi)->Arg(0)->Arg(1);
+
+static void BM_AutoBattle(benchmark::State& state) {
+	// Arg 0: normal attacks only or with skills
+	const bool do_skills = state.range(0) != 0;
+	BattleFixture fixture;
+
+	int64_t decisions = 0;
+	for (auto _: state) {
+		auto& actor = fixture.GetActor(decisions);
+		AutoBattle::SelectAutoBattleAction(actor, Game_Battler::WeaponAll, lcf::rpg::System::BattleCondition_none,
+			do_skills, false, true, true);
+		benchmark::DoNotOptimize(actor.GetBattleAlgorithm().get());
+		actor.SetBattleAlgorithm(nullptr);
+		++decisions;
+	}
+
+	state.counters["decisions"] = benchmark::Counter(static_cast<double>(decisions), benchmark::Counter::kIsRate);
+}
+
+BENCHMARK(BM_AutoBattle)->Arg(0)->Arg(1);
+
+static void BM_BattleSimulator(benchmark::State& state) {
+	BattleFixture fixture;
+
+	BattleSimulator::Config config;
+	config.troop_id = 1;
+	config.battles = 10;
+	config.seed = 1234;
+
+	int64_t battles = 0;
+	for (auto _: state) {
+		auto result = BattleSimulator::Run(config);
+		benchmark::DoNotOptimize(result.turns);
+		battles += result.battles;
+	}
+
+	state.counters["battles"] = benchmark::Counter(static_cast<double>(battles), benchmark::Counter::kIsRate);
+}
+
+BENCHMARK(BM_BattleSimulator);
+
+BENCHMARK_MAIN();
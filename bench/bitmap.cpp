@@ -5,6 +5,8 @@
 #include <bitmap.h>
 #include <pixel_format.h>
 #include <transform.h>
+#include <bitmap_simd.h>
+#include <vector>
 
 constexpr auto opacity_100 = Opacity::Opaque();
 constexpr auto opacity_0 = Opacity(0);
@@ -73,6 +75,16 @@ static void BM_ComputeImageOpacityChipset(benchmark::State& state) {
 
 BENCHMARK(BM_ComputeImageOpacityChipset);
 
+static void BM_CheckPixelsChipset(benchmark::State& state) {
+	Bitmap::SetFormat(format_R8G8B8A8_a().format());
+	auto bm = Bitmap::Create(480, 256);
+	for (auto _: state) {
+		bm->CheckPixels(Bitmap::Flag_Chipset);
+	}
+}
+
+BENCHMARK(BM_CheckPixelsChipset);
+
 static void BM_Create(benchmark::State& state) {
 	Bitmap::SetFormat(format);
 	for (auto _: state) {
@@ -265,18 +277,63 @@ static void BM_HueChangeBlit(benchmark::State& state) {
 
 BENCHMARK(BM_HueChangeBlit);
 
+// Tone types: 0 = color, 1 = saturation, 2 = saturation + color
+static Tone GetBenchTone(int type) {
+	switch (type) {
+		case 0:
+			return Tone(255, 96, 160, 128);
+		case 1:
+			return Tone(128, 128, 128, 0);
+		default:
+			return Tone(255, 96, 160, 200);
+	}
+}
+
 static void BM_ToneBlit(benchmark::State& state) {
 	Bitmap::SetFormat(format);
 	auto dest = Bitmap::Create(320, 240);
 	auto src = Bitmap::Create(320, 240);
 	auto rect = src->GetRect();
-	auto tone = Tone(255,255,255,128);
+	auto tone = GetBenchTone(state.range(0));
 	for (auto _: state) {
 		dest->ToneBlit(0, 0, *src, rect, tone, opacity, false);
 	}
 }
 
-BENCHMARK(BM_ToneBlit);
+BENCHMARK(BM_ToneBlit)->Arg(0)->Arg(1)->Arg(2);
+
+static void BM_ToneBlitSelf(benchmark::State& state) {
+	Bitmap::SetFormat(format);
+	auto dest = Bitmap::Create(320, 240);
+	auto rect = dest->GetRect();
+	auto tone = GetBenchTone(state.range(0));
+	bool check_alpha = state.range(1);
+	for (auto _: state) {
+		dest->ToneBlit(0, 0, *dest, rect, tone, opacity, check_alpha);
+	}
+}
+
+BENCHMARK(BM_ToneBlitSelf)->Args({0, 0})->Args({1, 0})->Args({2, 0})->Args({0, 1})->Args({1, 1})->Args({2, 1});
+
+template <void (*F)(uint32_t*, int, const BitmapSimd::ToneParams&)>
+static void BM_ToneRow(benchmark::State& state) {
+	std::vector<uint32_t> pixels(320 * 240, 0x80ff4020);
+	BitmapSimd::ToneParams params;
+	params.rs = 0;
+	params.gs = 8;
+	params.bs = 16;
+	params.as = 24;
+	params.tone = GetBenchTone(state.range(0));
+	params.saturation = params.tone.gray != 128;
+	params.color = params.tone.red != 128 || params.tone.green != 128 || params.tone.blue != 128;
+	for (auto _: state) {
+		F(pixels.data(), static_cast<int>(pixels.size()), params);
+	}
+	state.SetLabel(F == BitmapSimd::ToneRowScalar ? "Scalar" : BitmapSimd::GetToneRowVariant());
+}
+
+BENCHMARK_TEMPLATE(BM_ToneRow, BitmapSimd::ToneRowScalar)->Arg(0)->Arg(1)->Arg(2);
+BENCHMARK_TEMPLATE(BM_ToneRow, BitmapSimd::ToneRow)->Arg(0)->Arg(1)->Arg(2);
 
 static void BM_BlendBlit(benchmark::State& state) {
 	Bitmap::SetFormat(format);
@@ -340,6 +397,35 @@ static void BM_Blit2x(benchmark::State& state) {
 
 BENCHMARK(BM_Blit2x);
 
+static void BM_Blit2xScreen(benchmark::State& state) {
+	// The whole frame of a software scaled frontend, pixman reference for BM_ScaleBlit
+	Bitmap::SetFormat(format);
+	auto dest = Bitmap::Create(640, 480);
+	auto dst_rect = dest->GetRect();
+	auto src = Bitmap::Create(320, 240);
+	auto rect = src->GetRect();
+	for (auto _: state) {
+		dest->Blit2x(dst_rect, *src, rect);
+	}
+}
+
+BENCHMARK(BM_Blit2xScreen);
+
+static void BM_ScaleBlit(benchmark::State& state) {
+	// Arg 0: zoom, Arg 1: bands
+	const int zoom = static_cast<int>(state.range(0));
+	const int bands = static_cast<int>(state.range(1));
+	Bitmap::SetFormat(format);
+	auto dest = Bitmap::Create(320 * zoom, 240 * zoom);
+	auto src = Bitmap::Create(320, 240);
+	auto rect = src->GetRect();
+	for (auto _: state) {
+		dest->ScaleBlit(0, 0, *src, rect, zoom, bands);
+	}
+}
+
+BENCHMARK(BM_ScaleBlit)->Args({2, 1})->Args({2, 2})->Args({2, 4})->Args({3, 1})->Args({3, 4});
+
 static void BM_TransformRectangle(benchmark::State& state) {
 	Bitmap::SetFormat(format);
 	auto dest = Bitmap::Create(320, 240);
@@ -0,0 +1,283 @@
+#include <benchmark/benchmark.h>
+#include "mock_game.h"
+#include <bitmap.h>
+#include <cache.h>
+#include <filefinder.h>
+#include <filesystem_stream.h>
+#include <main_data.h>
+#include <options.h>
+#include <output.h>
+#include <pixel_format.h>
+#include <algorithm>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <zlib.h>
+
+/*
+ * Bitmap cache lookups, eviction and the sprite effect cache, and
+ * Bitmap::Create of PNG and XYZ files in memory.
+ * The game directory is the test project in tests/game. Only its charset
+ * exists, the other names are missing files which are cached as dummies.
+ * Lookup names follow a Zipf distribution, few graphics are requested
+ * much more often than the rest, as on real maps.
+ * Rates are in lookups, entries or decoded pixels per second.
+ */
+
+namespace {
+
+constexpr int num_lookups = 4096;
+
+/** Mock game with the test project as game directory and an empty cache */
+class CacheFixture {
+public:
+	CacheFixture() : game(MockMap::ePass40x30), lvl(Output::GetLogLevel()) {
+		Bitmap::SetFormat(format_R8G8B8A8_a().format());
+		Main_Data::Init();
+		FileFinder::SetDirectoryTree(FileFinder::CreateDirectoryTree(EP_TEST_PATH "/game"));
+		// Every missing file is a warning
+		Output::SetLogLevel(LogLevel::Error);
+		Cache::Clear();
+	}
+
+	~CacheFixture() {
+		Cache::Clear();
+		Output::SetLogLevel(lvl);
+	}
+
+private:
+	MockGame game;
+	LogLevel lvl;
+};
+
+std::vector<std::string> MakeNames(int count) {
+	std::vector<std::string> names;
+	for (int i = 0; i < count; ++i) {
+		names.push_back("Face" + std::to_string(i));
+	}
+	return names;
+}
+
+/** @return num_lookups indices into count names, Zipf distributed */
+std::vector<int> MakeLookups(int count) {
+	std::vector<double> weights;
+	for (int i = 0; i < count; ++i) {
+		weights.push_back(1.0 / (i + 1));
+	}
+	std::mt19937 gen(1234);
+	std::discrete_distribution<int> dist(weights.begin(), weights.end());
+
+	std::vector<int> lookups(num_lookups);
+	for (auto& i : lookups) {
+		i = dist(gen);
+	}
+	return lookups;
+}
+
+/** @return 160x80 bitmap of a gradient with 256 colors */
+BitmapRef MakeImage() {
+	auto bitmap = Bitmap::Create(160, 80, false);
+	for (int y = 0; y < bitmap->GetHeight(); ++y) {
+		for (int x = 0; x < bitmap->GetWidth(); ++x) {
+			const int index = (x / 4 + y / 8) % 256;
+			bitmap->FillRect(Rect(x, y, 1, 1), Color(index, 255 - index, index * 7 % 256, 255));
+		}
+	}
+	return bitmap;
+}
+
+std::string MakePNG() {
+	auto* buf = new std::stringbuf(std::ios_base::out);
+	Filesystem_Stream::OutputStream os(buf);
+	MakeImage()->WritePNG(os);
+	return buf->str();
+}
+
+/** @return XYZ of the same gradient as MakePNG */
+std::string MakeXYZ() {
+	constexpr int w = 160;
+	constexpr int h = 80;
+
+	std::vector<uint8_t> data;
+	for (int i = 0; i < 256; ++i) {
+		data.push_back(i);
+		data.push_back(255 - i);
+		data.push_back(i * 7 % 256);
+	}
+	for (int y = 0; y < h; ++y) {
+		for (int x = 0; x < w; ++x) {
+			data.push_back((x / 4 + y / 8) % 256);
+		}
+	}
+
+	uLongf size = compressBound(data.size());
+	std::string out(8 + size, '\0');
+	if (compress(reinterpret_cast<Bytef*>(&out[8]), &size, data.data(), data.size()) != Z_OK) {
+		return {};
+	}
+	out.resize(8 + size);
+	out.replace(0, 4, "XYZ1");
+	out[4] = w & 0xFF;
+	out[5] = w >> 8;
+	out[6] = h & 0xFF;
+	out[7] = h >> 8;
+	return out;
+}
+
+}
+
+static void BM_CacheHit(benchmark::State& state) {
+	// Arg 0: number of cached names
+	const int count = static_cast<int>(state.range(0));
+	CacheFixture fixture;
+	const auto names = MakeNames(count);
+	const auto lookups = MakeLookups(count);
+	for (auto& name : names) {
+		Cache::Faceset(name);
+	}
+
+	int64_t hits = 0;
+	for (auto _: state) {
+		for (int i : lookups) {
+			benchmark::DoNotOptimize(Cache::Faceset(names[i]));
+		}
+		hits += lookups.size();
+	}
+
+	state.counters["lookups"] = benchmark::Counter(static_cast<double>(hits), benchmark::Counter::kIsRate);
+}
+
+BENCHMARK(BM_CacheHit)->Arg(16)->Arg(256);
+
+static void BM_CacheMiss(benchmark::State& state) {
+	// Arg 0: missing file or the PNG of the test project
+	const bool existing = state.range(0) != 0;
+	CacheFixture fixture;
+
+	int64_t misses = 0;
+	for (auto _: state) {
+		state.PauseTiming();
+		Cache::Clear();
+		state.ResumeTiming();
+
+		benchmark::DoNotOptimize(existing ? Cache::Charset("chara1") : Cache::Charset("Missing"));
+		++misses;
+	}
+
+	state.counters["lookups"] = benchmark::Counter(static_cast<double>(misses), benchmark::Counter::kIsRate);
+}
+
+BENCHMARK(BM_CacheMiss)->Arg(0)->Arg(1);
+
+static void BM_CacheLimited(benchmark::State& state) {
+	// Arg 0: number of names, Arg 1: cache limit in cached facesets
+	const int count = static_cast<int>(state.range(0));
+	const int limit = static_cast<int>(state.range(1));
+	CacheFixture fixture;
+	const auto names = MakeNames(count);
+	const auto lookups = MakeLookups(count);
+
+	// The dummy faceset is 192x192
+	Cache::SetLimit(limit * 192 * 192 * 4);
+
+	const auto before = Cache::GetStats();
+	int64_t done = 0;
+	for (auto _: state) {
+		for (int i : lookups) {
+			benchmark::DoNotOptimize(Cache::Faceset(names[i]));
+		}
+		done += lookups.size();
+	}
+
+	const auto after = Cache::GetStats();
+	state.counters["lookups"] = benchmark::Counter(static_cast<double>(done), benchmark::Counter::kIsRate);
+	state.counters["hit_ratio"] = static_cast<double>(after.hits - before.hits) /
+		std::max<size_t>(after.hits + after.misses - before.hits - before.misses, 1);
+
+	Cache::SetLimit(DEFAULT_CACHE_SIZE * 1024 * 1024);
+}
+
+BENCHMARK(BM_CacheLimited)->Args({256, 64})->Args({1024, 64});
+
+static void BM_CacheTrim(benchmark::State& state) {
+	// Arg 0: cached entries, Arg 1: all entries still referenced
+	const int count = static_cast<int>(state.range(0));
+	const bool referenced = state.range(1) != 0;
+	CacheFixture fixture;
+	const auto names = MakeNames(count);
+
+	std::vector<BitmapRef> refs;
+	int64_t entries = 0;
+	for (auto _: state) {
+		state.PauseTiming();
+		if (!referenced || refs.empty()) {
+			for (auto& name : names) {
+				auto bitmap = Cache::Faceset(name);
+				if (referenced) {
+					refs.push_back(bitmap);
+				}
+			}
+		}
+		state.ResumeTiming();
+
+		// Referenced entries are visited but not freed
+		Cache::Trim(0);
+		entries += count;
+	}
+
+	refs.clear();
+	state.counters["entries"] = benchmark::Counter(static_cast<double>(entries), benchmark::Counter::kIsRate);
+}
+
+BENCHMARK(BM_CacheTrim)->Args({64, 0})->Args({512, 0})->Args({64, 1})->Args({512, 1});
+
+static void BM_CacheSpriteEffect(benchmark::State& state) {
+	// Arg 0: number of tones used in turn
+	const int num_tones = static_cast<int>(state.range(0));
+	CacheFixture fixture;
+	auto src = MakeImage();
+	const Rect rect(0, 0, 48, 64);
+
+	std::vector<Tone> tones;
+	for (int i = 0; i < num_tones; ++i) {
+		tones.emplace_back(128 + i % 128, 128 - i % 128, (i * 37) % 256, (i * 11) % 256);
+	}
+
+	const auto before = Cache::GetEffectStats();
+	int64_t lookups = 0;
+	for (auto _: state) {
+		benchmark::DoNotOptimize(Cache::SpriteEffect(src, rect, false, false, tones[lookups % num_tones], Color()));
+		++lookups;
+	}
+
+	const auto after = Cache::GetEffectStats();
+	state.counters["lookups"] = benchmark::Counter(static_cast<double>(lookups), benchmark::Counter::kIsRate);
+	state.counters["hit_ratio"] = static_cast<double>(after.hits - before.hits) /
+		std::max<size_t>(after.hits + after.misses - before.hits - before.misses, 1);
+}
+
+BENCHMARK(BM_CacheSpriteEffect)->Arg(4)->Arg(64)->Arg(4096);
+
+static void BM_BitmapCreateFile(benchmark::State& state) {
+	// Arg 0: PNG or XYZ
+	const bool xyz = state.range(0) != 0;
+	Bitmap::SetFormat(format_R8G8B8A8_a().format());
+	const auto file = xyz ? MakeXYZ() : MakePNG();
+
+	int64_t decoded = 0;
+	for (auto _: state) {
+		auto bitmap = Bitmap::Create(reinterpret_cast<const uint8_t*>(file.data()), file.size(), true, Bitmap::Flag_ReadOnly);
+		if (!bitmap) {
+			state.SkipWithError("Image not decoded");
+			return;
+		}
+		decoded += bitmap->GetWidth() * bitmap->GetHeight();
+	}
+
+	state.counters["pixels"] = benchmark::Counter(static_cast<double>(decoded), benchmark::Counter::kIsRate);
+}
+
+BENCHMARK(BM_BitmapCreateFile)->Arg(0)->Arg(1);
+
+BENCHMARK_MAIN();
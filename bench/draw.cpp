@@ -7,6 +7,8 @@
 #include <drawable_list.h>
 #include <drawable_mgr.h>
 #include <iostream>
+#include <limits>
+#include <options.h>
 
 constexpr int num_sprites = 5000;
 
@@ -45,4 +47,40 @@ static void BM_DrawSortLocality(benchmark::State& state) {
 
 BENCHMARK(BM_DrawSortLocality);
 
+constexpr int num_pictures = 100;
+
+static void BM_DrawPictures(benchmark::State& state) {
+	Bitmap::SetFormat(format_R8G8B8A8_a().format());
+	auto dst = Bitmap::Create(SCREEN_TARGET_WIDTH, SCREEN_TARGET_HEIGHT, false);
+	auto picture = Bitmap::Create(160, 120, Color(255, 128, 64, 200));
+
+	DrawableList list;
+	DrawableMgr::SetLocalList(&list);
+
+	std::vector<std::unique_ptr<Sprite>> sprites;
+	for (int i = 0; i < num_pictures; ++i) {
+		auto sprite = std::make_unique<Sprite>();
+		sprite->SetBitmap(picture);
+		sprite->SetX((i * 37) % SCREEN_TARGET_WIDTH - 40);
+		sprite->SetY((i * 53) % SCREEN_TARGET_HEIGHT - 30);
+		sprite->SetZ(i);
+		sprite->SetOpacity(128 + i % 128);
+		sprites.push_back(std::move(sprite));
+	}
+
+	const int min_z = std::numeric_limits<int>::min();
+	const int max_z = std::numeric_limits<int>::max();
+	const int threads = state.range(0);
+
+	for (auto _: state) {
+		if (threads > 1) {
+			list.DrawBanded(*dst, min_z, max_z, threads);
+		} else {
+			list.Draw(*dst, min_z, max_z);
+		}
+	}
+}
+
+BENCHMARK(BM_DrawPictures)->Arg(1)->Arg(2)->Arg(4)->Arg(8);
+
 BENCHMARK_MAIN();
@@ -6,6 +6,7 @@
 #include <cache.h>
 
 const std::string text = "Alex landed a critical hit on Slime!";
+const std::string text_cjk = "アレックスの攻撃！スライムに痛恨の一撃！";
 char32_t symbol = '\\';
 constexpr int width = 240;
 constexpr int height = 80;
@@ -20,6 +21,16 @@ static void BM_FontSizeStr(benchmark::State& state) {
 
 BENCHMARK(BM_FontSizeStr);
 
+static void BM_FontSizeStrCJK(benchmark::State& state) {
+	auto font = Font::Default();
+	for (auto _: state) {
+		auto rect = font->GetSize(text_cjk);
+		(void)rect;
+	}
+}
+
+BENCHMARK(BM_FontSizeStrCJK);
+
 static void BM_FontSizeChar(benchmark::State& state) {
 	auto font = Font::Default();
 	for (auto _: state) {
@@ -0,0 +1,276 @@
+#include <benchmark/benchmark.h>
+#include "mock_game.h"
+#include <bitmap.h>
+#include <cache.h>
+#include <drawable_mgr.h>
+#include <filefinder.h>
+#include <font.h>
+#include <graphics.h>
+#include <sprite.h>
+#include <tilemap.h>
+#include <window_base.h>
+#include <window_command.h>
+#include <options.h>
+
+/*
+ * Whole frames of canned scenes drawn through Graphics::Draw.
+ * The map uses the charset of the test project in tests/game, the other
+ * graphics are generated because the project does not contain them.
+ */
+
+namespace {
+
+constexpr int num_events = 30;
+constexpr int num_enemies = 6;
+
+BitmapRef MakeChipset() {
+	auto chipset = Bitmap::Create(480, 256, true);
+	for (int y = 0; y < 256; y += 16) {
+		for (int x = 0; x < 480; x += 16) {
+			// Leave some tiles transparent, the upper layer is drawn over the lower one
+			if ((x / 16 + y / 16) % 5 != 0) {
+				chipset->FillRect(Rect(x, y, 16, 16), Color(x / 2, y, (x + y) % 256, 255));
+				chipset->FillRect(Rect(x + 4, y + 4, 8, 8), Color(y, x / 2, 128, 255));
+			}
+		}
+	}
+	return chipset;
+}
+
+BitmapRef MakeCharset() {
+	auto charset = Cache::Charset("Chara1");
+	if (!charset || charset->GetWidth() < 288) {
+		charset = Bitmap::Create(288, 256, Color(200, 100, 50, 255));
+	}
+	return charset;
+}
+
+/** Mock game with the test project as game directory and an empty scene */
+class FrameFixture {
+public:
+	FrameFixture() : game(MockMap::ePass40x30) {
+		Bitmap::SetFormat(format_R8G8B8A8_a().format());
+		Main_Data::Init();
+		FileFinder::SetDirectoryTree(FileFinder::CreateDirectoryTree(EP_TEST_PATH "/game"));
+
+		Graphics::Init();
+		dst = Bitmap::Create(SCREEN_TARGET_WIDTH, SCREEN_TARGET_HEIGHT, false);
+	}
+
+	~FrameFixture() {
+		Graphics::Quit();
+	}
+
+	/** Draws a frame, invalidated first when full is set */
+	void Draw(bool full) {
+		if (full) {
+			Graphics::InvalidateFrame();
+		}
+		Graphics::Draw(*dst);
+	}
+
+private:
+	MockGame game;
+	BitmapRef dst;
+};
+
+/** Scrolling map with events */
+struct MapScene {
+	MapScene() {
+		const int w = Game_Map::GetWidth();
+		const int h = Game_Map::GetHeight();
+
+		std::vector<short> down(w * h);
+		std::vector<short> up(w * h);
+		for (int i = 0; i < w * h; ++i) {
+			down[i] = BLOCK_E + (i * 7) % BLOCK_E_TILES;
+			up[i] = (i % 3 == 0) ? BLOCK_F + (i * 5) % BLOCK_F_TILES : BLOCK_F;
+		}
+
+		tilemap.SetWidth(w);
+		tilemap.SetHeight(h);
+		tilemap.SetChipset(MakeChipset());
+		tilemap.SetMapDataDown(std::move(down));
+		tilemap.SetMapDataUp(std::move(up));
+		tilemap.SetPassableDown(std::vector<unsigned char>(NUM_LOWER_TILES, 0x0F));
+		tilemap.SetPassableUp(std::vector<unsigned char>(BLOCK_F_TILES, 0x0F));
+
+		auto charset = MakeCharset();
+		for (int i = 0; i < num_events; ++i) {
+			auto sprite = std::make_unique<Sprite>();
+			sprite->SetBitmap(charset);
+			sprite->SetSrcRect(Rect((i % 12) * 24, (i % 8) * 32, 24, 32));
+			sprite->SetX((i * 47) % SCREEN_TARGET_WIDTH);
+			sprite->SetY((i * 31) % SCREEN_TARGET_HEIGHT);
+			sprite->SetZ(Priority_Player + i);
+			events.push_back(std::move(sprite));
+		}
+	}
+
+	void Update(int frame) {
+		tilemap.SetOx(frame % (Game_Map::GetWidth() * TILE_SIZE));
+		tilemap.SetOy((frame / 2) % (Game_Map::GetHeight() * TILE_SIZE));
+		for (size_t i = 0; i < events.size(); ++i) {
+			events[i]->SetX((events[i]->GetX() + 1) % SCREEN_TARGET_WIDTH);
+		}
+	}
+
+	Tilemap tilemap;
+	std::vector<std::unique_ptr<Sprite>> events;
+};
+
+/** Main menu with command, status and gold windows */
+struct MenuScene {
+	MenuScene() {
+		command.reset(new Window_Command({ "Item", "Skill", "Equipment", "Save", "Status", "Row", "Order", "Wait", "Quit" }, 88));
+		command->SetActive(true);
+
+		for (int i = 0; i < 4; ++i) {
+			auto status = std::make_unique<Window_Base>(88, i * 60, SCREEN_TARGET_WIDTH - 88, 60);
+			status->SetContents(Bitmap::Create(status->GetWidth() - 16, status->GetHeight() - 16));
+			status->GetContents()->TextDraw(0, 0, Font::ColorDefault, "Actor " + std::to_string(i + 1));
+			status->GetContents()->TextDraw(0, 16, Font::ColorDefault, "HP 999/999  MP 99/99");
+			status->GetContents()->TextDraw(0, 32, Font::ColorCritical, "Level 50  Poison");
+			windows.push_back(std::move(status));
+		}
+
+		gold.reset(new Window_Base(0, SCREEN_TARGET_HEIGHT - 32, 88, 32));
+		gold->SetContents(Bitmap::Create(72, 16));
+		gold->GetContents()->TextDraw(0, 0, Font::ColorDefault, "12345 G");
+	}
+
+	void Update(int frame) {
+		command->SetIndex((frame / 8) % 9);
+		command->Update();
+	}
+
+	std::unique_ptr<Window_Command> command;
+	std::vector<std::unique_ptr<Window_Base>> windows;
+	std::unique_ptr<Window_Base> gold;
+};
+
+/** Battle with background, enemies and the status window */
+struct BattleScene {
+	BattleScene() {
+		background = std::make_unique<Sprite>();
+		background->SetBitmap(Bitmap::Create(SCREEN_TARGET_WIDTH, SCREEN_TARGET_HEIGHT, Color(40, 80, 120, 255)));
+		background->SetZ(Priority_Background);
+
+		auto enemy_bmp = Bitmap::Create(64, 64, Color(180, 40, 40, 220));
+		for (int i = 0; i < num_enemies; ++i) {
+			auto enemy = std::make_unique<Sprite>();
+			enemy->SetBitmap(enemy_bmp);
+			enemy->SetX(20 + (i % 3) * 80);
+			enemy->SetY(20 + (i / 3) * 70);
+			enemy->SetZ(Priority_Battler + i);
+			enemies.push_back(std::move(enemy));
+		}
+
+		status.reset(new Window_Base(0, SCREEN_TARGET_HEIGHT - 80, SCREEN_TARGET_WIDTH, 80));
+		status->SetContents(Bitmap::Create(status->GetWidth() - 16, status->GetHeight() - 16));
+		for (int i = 0; i < 4; ++i) {
+			status->GetContents()->TextDraw(0, i * 16, Font::ColorDefault, "Actor " + std::to_string(i + 1) + "  HP 999  MP 99");
+		}
+	}
+
+	void Update(int frame) {
+		// Flashing and toned enemies are redrawn every frame
+		for (size_t i = 0; i < enemies.size(); ++i) {
+			enemies[i]->SetTone(Tone((frame + i * 20) % 256, 128, 128, 128));
+		}
+	}
+
+	std::unique_ptr<Sprite> background;
+	std::vector<std::unique_ptr<Sprite>> enemies;
+	std::unique_ptr<Window_Base> status;
+};
+
+/** Map with an open message window */
+struct MessageScene {
+	MessageScene() {
+		message.reset(new Window_Base(0, SCREEN_TARGET_HEIGHT - 80, SCREEN_TARGET_WIDTH, 80));
+		message->SetContents(Bitmap::Create(message->GetWidth() - 16, message->GetHeight() - 16));
+	}
+
+	void Update(int frame) {
+		map.Update(frame);
+
+		// The message is typed a character per frame
+		const std::string text = "The quick brown fox jumps over the lazy dog.";
+		const auto len = static_cast<size_t>(frame) % text.size();
+		message->GetContents()->Clear();
+		message->GetContents()->TextDraw(0, 0, Font::ColorDefault, text.substr(0, len));
+	}
+
+	MapScene map;
+	std::unique_ptr<Window_Base> message;
+};
+
+template <typename T>
+void RunScene(benchmark::State& state) {
+	FrameFixture fixture;
+	T scene;
+	const bool full = state.range(0) != 0;
+
+	int frame = 0;
+	for (auto _: state) {
+		scene.Update(frame++);
+		fixture.Draw(full);
+	}
+}
+
+}
+
+static void BM_FrameMap(benchmark::State& state) {
+	RunScene<MapScene>(state);
+}
+
+BENCHMARK(BM_FrameMap)->Arg(0)->Arg(1);
+
+static void BM_FrameMenu(benchmark::State& state) {
+	RunScene<MenuScene>(state);
+}
+
+BENCHMARK(BM_FrameMenu)->Arg(0)->Arg(1);
+
+static void BM_FrameBattle(benchmark::State& state) {
+	RunScene<BattleScene>(state);
+}
+
+BENCHMARK(BM_FrameBattle)->Arg(0)->Arg(1);
+
+static void BM_FrameMessage(benchmark::State& state) {
+	RunScene<MessageScene>(state);
+}
+
+BENCHMARK(BM_FrameMessage)->Arg(0)->Arg(1);
+
+static void BM_FrameTilemap(benchmark::State& state) {
+	FrameFixture fixture;
+	MapScene scene;
+	scene.events.clear();
+
+	int frame = 0;
+	for (auto _: state) {
+		scene.Update(frame++);
+		fixture.Draw(true);
+	}
+}
+
+BENCHMARK(BM_FrameTilemap);
+
+static void BM_FrameSprites(benchmark::State& state) {
+	FrameFixture fixture;
+	MapScene scene;
+	scene.tilemap.SetVisible(false);
+
+	int frame = 0;
+	for (auto _: state) {
+		scene.Update(frame++);
+		fixture.Draw(true);
+	}
+}
+
+BENCHMARK(BM_FrameSprites);
+
+BENCHMARK_MAIN();
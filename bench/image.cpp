@@ -0,0 +1,124 @@
+#include <benchmark/benchmark.h>
+#include <bitmap.h>
+#include <image_png.h>
+#include <pixel_format.h>
+#include <png.h>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+/*
+ * PNG decode throughput of ImagePNG and of Bitmap::Create.
+ * The images are generated with libpng. Build once with and once without
+ * PLAYER_WITH_SPNG to compare libpng against libspng.
+ * Rates are in decoded pixels per second.
+ */
+
+namespace {
+
+constexpr int image_width = 480;
+constexpr int image_height = 256;
+
+void WriteString(png_structp png_ptr, png_bytep data, png_size_t length) {
+	auto* out = reinterpret_cast<std::string*>(png_get_io_ptr(png_ptr));
+	out->append(reinterpret_cast<const char*>(data), length);
+}
+
+/** @return PNG of a gradient, RGB or with a palette of 256 colors */
+std::string MakePNG(bool paletted) {
+	std::string out;
+
+	png_structp png_ptr = png_create_write_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
+	png_infop info_ptr = png_create_info_struct(png_ptr);
+	if (setjmp(png_jmpbuf(png_ptr))) {
+		png_destroy_write_struct(&png_ptr, &info_ptr);
+		return {};
+	}
+	png_set_write_fn(png_ptr, &out, WriteString, nullptr);
+
+	png_set_IHDR(png_ptr, info_ptr, image_width, image_height, 8,
+		paletted ? PNG_COLOR_TYPE_PALETTE : PNG_COLOR_TYPE_RGB, PNG_INTERLACE_NONE,
+		PNG_COMPRESSION_TYPE_BASE, PNG_FILTER_TYPE_BASE);
+
+	std::vector<png_color> palette(256);
+	for (int i = 0; i < 256; ++i) {
+		palette[i] = { static_cast<png_byte>(i), static_cast<png_byte>(255 - i), static_cast<png_byte>(i * 7) };
+	}
+	if (paletted) {
+		png_set_PLTE(png_ptr, info_ptr, palette.data(), palette.size());
+	}
+	png_write_info(png_ptr, info_ptr);
+
+	const int bpp = paletted ? 1 : 3;
+	std::vector<png_byte> row(image_width * bpp);
+	for (int y = 0; y < image_height; ++y) {
+		for (int x = 0; x < image_width; ++x) {
+			const int index = (x / 4 + y / 8) % 256;
+			if (paletted) {
+				row[x] = index;
+			} else {
+				row[x * 3] = palette[index].red;
+				row[x * 3 + 1] = palette[index].green;
+				row[x * 3 + 2] = palette[index].blue;
+			}
+		}
+		png_write_row(png_ptr, row.data());
+	}
+	png_write_end(png_ptr, nullptr);
+	png_destroy_write_struct(&png_ptr, &info_ptr);
+	return out;
+}
+
+}
+
+static void BM_ReadPNG(benchmark::State& state) {
+	// Arg 0: RGB or paletted, Arg 1: no target or a direct RGBA target
+	const bool paletted = state.range(0) != 0;
+	const bool direct = state.range(1) != 0;
+	const auto png = MakePNG(paletted);
+	const auto format = format_R8G8B8A8_a().format();
+
+	int64_t decoded = 0;
+	for (auto _: state) {
+		ImagePalette::Target target;
+		target.format = &format;
+
+		int w, h;
+		void* pixels = nullptr;
+		if (!ImagePNG::ReadPNG(png.data(), png.size(), true, w, h, pixels, direct ? &target : nullptr)) {
+			free(pixels);
+			state.SkipWithError("PNG not decoded");
+			return;
+		}
+		benchmark::DoNotOptimize(pixels);
+		free(pixels);
+		decoded += w * h;
+	}
+
+	state.counters["pixels"] = benchmark::Counter(static_cast<double>(decoded), benchmark::Counter::kIsRate);
+}
+
+BENCHMARK(BM_ReadPNG)->Args({0, 0})->Args({1, 0})->Args({1, 1});
+
+static void BM_BitmapCreatePNG(benchmark::State& state) {
+	// Arg 0: RGB or paletted
+	const bool paletted = state.range(0) != 0;
+	const auto png = MakePNG(paletted);
+	Bitmap::SetFormat(format_R8G8B8A8_a().format());
+
+	int64_t decoded = 0;
+	for (auto _: state) {
+		auto bitmap = Bitmap::Create(reinterpret_cast<const uint8_t*>(png.data()), png.size(), true);
+		if (!bitmap) {
+			state.SkipWithError("PNG not decoded");
+			return;
+		}
+		decoded += bitmap->GetWidth() * bitmap->GetHeight();
+	}
+
+	state.counters["pixels"] = benchmark::Counter(static_cast<double>(decoded), benchmark::Counter::kIsRate);
+}
+
+BENCHMARK(BM_BitmapCreatePNG)->Arg(0)->Arg(1);
+
+BENCHMARK_MAIN();
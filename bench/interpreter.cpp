@@ -0,0 +1,179 @@
+#include <benchmark/benchmark.h>
+#include "mock_game.h"
+#include <game_interpreter_map.h>
+#include <scene.h>
+#include <initializer_list>
+#include <lcf/data.h>
+#include <lcf/rpg/eventcommand.h>
+
+/*
+ * Event commands executed per second by Game_Interpreter::Update.
+ * Every list runs a loop of loop_iterations, short enough to finish
+ * within the 10000 commands an interpreter may execute per frame.
+ */
+
+namespace {
+
+using Cmd = lcf::rpg::EventCommand::Code;
+
+constexpr int loop_iterations = 500;
+constexpr int num_common_events = 8;
+
+constexpr int var_counter = 1;
+constexpr int var_a = 2;
+constexpr int var_b = 3;
+
+lcf::rpg::EventCommand MakeCommand(Cmd code, int indent, std::initializer_list<int32_t> params) {
+	lcf::rpg::EventCommand com;
+	com.code = static_cast<int>(code);
+	com.indent = indent;
+	com.parameters = lcf::DBArray<int32_t>(params.begin(), params.end());
+	return com;
+}
+
+/** ControlVars on a single variable: op 0 set, 1 add, 2 sub, 3 mul, 4 div, 5 mod */
+lcf::rpg::EventCommand ControlVar(int indent, int var_id, int op, int value) {
+	return MakeCommand(Cmd::ControlVars, indent, { 0, var_id, var_id, op, 0, value });
+}
+
+/** ControlVars of a variable with another variable as operand */
+lcf::rpg::EventCommand ControlVarVar(int indent, int var_id, int op, int operand_id) {
+	return MakeCommand(Cmd::ControlVars, indent, { 0, var_id, var_id, op, 1, operand_id });
+}
+
+/** Appends: counter += 1, if counter < loop_iterations jump to the label */
+void AppendLoopEnd(std::vector<lcf::rpg::EventCommand>& list, int label_id) {
+	list.push_back(ControlVar(0, var_counter, 1, 1));
+	list.push_back(MakeCommand(Cmd::ConditionalBranch, 0, { 1, var_counter, 0, loop_iterations, 4, 0 }));
+	list.push_back(MakeCommand(Cmd::JumpToLabel, 1, { label_id }));
+	list.push_back(MakeCommand(Cmd::END, 1, {}));
+	list.push_back(MakeCommand(Cmd::EndBranch, 0, {}));
+}
+
+std::vector<lcf::rpg::EventCommand> MakeVariableLoop() {
+	std::vector<lcf::rpg::EventCommand> list;
+	list.push_back(ControlVar(0, var_counter, 0, 0));
+	list.push_back(MakeCommand(Cmd::Label, 0, { 1 }));
+	list.push_back(ControlVarVar(0, var_a, 0, var_counter));
+	list.push_back(ControlVar(0, var_a, 3, 31));
+	list.push_back(ControlVar(0, var_a, 5, 977));
+	list.push_back(ControlVarVar(0, var_b, 1, var_a));
+	list.push_back(ControlVar(0, var_b, 4, 2));
+	AppendLoopEnd(list, 1);
+	return list;
+}
+
+std::vector<lcf::rpg::EventCommand> MakeBranchLoop() {
+	std::vector<lcf::rpg::EventCommand> list;
+	list.push_back(ControlVar(0, var_counter, 0, 0));
+	list.push_back(MakeCommand(Cmd::Label, 0, { 1 }));
+	list.push_back(ControlVarVar(0, var_a, 0, var_counter));
+	list.push_back(ControlVar(0, var_a, 5, 3));
+	// if a == 0 ... else if a == 1 ... else ...
+	list.push_back(MakeCommand(Cmd::ConditionalBranch, 0, { 1, var_a, 0, 0, 0, 1 }));
+	list.push_back(ControlVar(1, var_b, 1, 1));
+	list.push_back(MakeCommand(Cmd::END, 1, {}));
+	list.push_back(MakeCommand(Cmd::ElseBranch, 0, {}));
+	list.push_back(MakeCommand(Cmd::ConditionalBranch, 1, { 1, var_a, 0, 1, 0, 1 }));
+	list.push_back(ControlVar(2, var_b, 2, 1));
+	list.push_back(MakeCommand(Cmd::END, 2, {}));
+	list.push_back(MakeCommand(Cmd::ElseBranch, 1, {}));
+	list.push_back(ControlVar(2, var_b, 3, 1));
+	list.push_back(MakeCommand(Cmd::END, 2, {}));
+	list.push_back(MakeCommand(Cmd::EndBranch, 1, {}));
+	list.push_back(MakeCommand(Cmd::END, 1, {}));
+	list.push_back(MakeCommand(Cmd::EndBranch, 0, {}));
+	AppendLoopEnd(list, 1);
+	return list;
+}
+
+std::vector<lcf::rpg::EventCommand> MakeLabelLoop() {
+	// Labels at the end of a long list, JumpToLabel searches the list from the start
+	std::vector<lcf::rpg::EventCommand> list;
+	list.push_back(ControlVar(0, var_counter, 0, 0));
+	list.push_back(MakeCommand(Cmd::JumpToLabel, 0, { 2 }));
+	for (int i = 0; i < 100; ++i) {
+		list.push_back(MakeCommand(Cmd::Comment, 0, {}));
+	}
+	list.push_back(MakeCommand(Cmd::Label, 0, { 1 }));
+	list.push_back(ControlVar(0, var_a, 1, 1));
+	list.push_back(MakeCommand(Cmd::Label, 0, { 2 }));
+	list.push_back(ControlVar(0, var_b, 1, 1));
+	AppendLoopEnd(list, 1);
+	return list;
+}
+
+std::vector<lcf::rpg::EventCommand> MakeCallLoop() {
+	std::vector<lcf::rpg::EventCommand> list;
+	list.push_back(ControlVar(0, var_counter, 0, 0));
+	list.push_back(MakeCommand(Cmd::Label, 0, { 1 }));
+	list.push_back(MakeCommand(Cmd::CallEvent, 0, { 0, 1, 0 }));
+	AppendLoopEnd(list, 1);
+	return list;
+}
+
+/** Common events 1 to N, every one calls the next */
+void MakeCommonEventChain() {
+	for (int i = 1; i <= num_common_events; ++i) {
+		lcf::rpg::CommonEvent ce;
+		ce.ID = i;
+		ce.trigger = lcf::rpg::CommonEvent::Trigger_call;
+		ce.event_commands.push_back(ControlVar(0, var_a, 1, i));
+		if (i < num_common_events) {
+			ce.event_commands.push_back(MakeCommand(Cmd::CallEvent, 0, { 0, i + 1, 0 }));
+		}
+		lcf::Data::commonevents.push_back(std::move(ce));
+	}
+}
+
+void RunInterpreter(benchmark::State& state, const std::vector<lcf::rpg::EventCommand>& list) {
+	auto lvl = Output::GetLogLevel();
+	Output::SetLogLevel(LogLevel::Error);
+
+	MockGame game(MockMap::ePass40x30);
+	Scene::Push(std::make_shared<Scene>());
+
+	Game_Interpreter_Map interpreter(true);
+
+	int64_t commands = 0;
+	for (auto _: state) {
+		interpreter.Push(list, 0);
+		interpreter.Update();
+		commands += interpreter.GetLoopCount();
+	}
+
+	state.counters["commands"] = benchmark::Counter(static_cast<double>(commands), benchmark::Counter::kIsRate);
+
+	Scene::instance.reset();
+	Output::SetLogLevel(lvl);
+}
+
+}
+
+static void BM_InterpreterVariables(benchmark::State& state) {
+	RunInterpreter(state, MakeVariableLoop());
+}
+
+BENCHMARK(BM_InterpreterVariables);
+
+static void BM_InterpreterBranches(benchmark::State& state) {
+	RunInterpreter(state, MakeBranchLoop());
+}
+
+BENCHMARK(BM_InterpreterBranches);
+
+static void BM_InterpreterLabels(benchmark::State& state) {
+	RunInterpreter(state, MakeLabelLoop());
+}
+
+BENCHMARK(BM_InterpreterLabels);
+
+static void BM_InterpreterCallEvent(benchmark::State& state) {
+	// Read by Game_Map::Init in the MockGame constructor
+	MakeCommonEventChain();
+	RunInterpreter(state, MakeCallLoop());
+}
+
+BENCHMARK(BM_InterpreterCallEvent);
+
+BENCHMARK_MAIN();
@@ -5,6 +5,8 @@
 #include <bitmap.h>
 #include <pixel_format.h>
 #include <transform.h>
+#include <bitmap_kernels.h>
+#include <vector>
 
 static void BlitTest(benchmark::State& state, DynamicFormat fmt) {
 	Bitmap::SetFormat(fmt);
@@ -64,4 +66,86 @@ static void BM_BlitARGB_n(benchmark::State& state) {
 
 BENCHMARK(BM_BlitARGB_n);
 
+static void OverRowTest(benchmark::State& state, DynamicFormat fmt, bool dynamic) {
+	Bitmap::SetFormat(fmt);
+	const auto& kernels = dynamic ? BitmapKernels::Dynamic() : *BitmapKernels::Select(fmt);
+	std::vector<uint32_t> dst(320, 0x80808080);
+	std::vector<uint32_t> src(320, 0x7F402010);
+	for (auto _: state) {
+		for (int y = 0; y < 240; ++y) {
+			kernels.over(dst.data(), src.data(), 320, 1, 128, 0);
+		}
+		benchmark::DoNotOptimize(dst.data());
+	}
+}
+
+static void BM_OverRowRGBA_specialized(benchmark::State& state) {
+	OverRowTest(state, format_R8G8B8A8_a().format(), false);
+}
+
+BENCHMARK(BM_OverRowRGBA_specialized);
+
+static void BM_OverRowRGBA_dynamic(benchmark::State& state) {
+	OverRowTest(state, format_R8G8B8A8_a().format(), true);
+}
+
+BENCHMARK(BM_OverRowRGBA_dynamic);
+
+static void BM_OverRowARGB_specialized(benchmark::State& state) {
+	OverRowTest(state, format_A8R8G8B8_a().format(), false);
+}
+
+BENCHMARK(BM_OverRowARGB_specialized);
+
+static void BM_OverRowARGB_dynamic(benchmark::State& state) {
+	OverRowTest(state, format_A8R8G8B8_a().format(), true);
+}
+
+BENCHMARK(BM_OverRowARGB_dynamic);
+
+static void BlendRowTest(benchmark::State& state, DynamicFormat fmt, bool dynamic) {
+	Bitmap::SetFormat(fmt);
+	const auto& kernels = dynamic ? BitmapKernels::Dynamic() : *BitmapKernels::Select(fmt);
+	std::vector<uint32_t> dst(320, 0x80808080);
+	const uint32_t color = Bitmap::pixel_format.rgba_to_uint32_t(64, 32, 16, 128);
+	for (auto _: state) {
+		for (int y = 0; y < 240; ++y) {
+			kernels.blend(dst.data(), dst.data(), 320, color, 0);
+		}
+		benchmark::DoNotOptimize(dst.data());
+	}
+}
+
+static void BM_BlendRowRGBA_specialized(benchmark::State& state) {
+	BlendRowTest(state, format_R8G8B8A8_a().format(), false);
+}
+
+BENCHMARK(BM_BlendRowRGBA_specialized);
+
+static void BM_BlendRowRGBA_dynamic(benchmark::State& state) {
+	BlendRowTest(state, format_R8G8B8A8_a().format(), true);
+}
+
+BENCHMARK(BM_BlendRowRGBA_dynamic);
+
+static void FlipTest(benchmark::State& state, DynamicFormat fmt) {
+	Bitmap::SetFormat(fmt);
+	auto bm = Bitmap::Create(320, 240);
+	for (auto _: state) {
+		bm->Flip(true, true);
+	}
+}
+
+static void BM_FlipRGBA_a(benchmark::State& state) {
+	FlipTest(state, format_R8G8B8A8_a().format());
+}
+
+BENCHMARK(BM_FlipRGBA_a);
+
+static void BM_FlipRGBA_n(benchmark::State& state) {
+	FlipTest(state, format_R8G8B8A8_n().format());
+}
+
+BENCHMARK(BM_FlipRGBA_n);
+
 BENCHMARK_MAIN();
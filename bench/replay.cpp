@@ -0,0 +1,371 @@
+#include <benchmark/benchmark.h>
+#include "mock_game.h"
+#include <bitmap.h>
+#include <filefinder.h>
+#include <game_config.h>
+#include <game_system.h>
+#include <graphics.h>
+#include <headless_ui.h>
+#include <input.h>
+#include <input_source.h>
+#include <main_data.h>
+#include <memory_stats.h>
+#include <options.h>
+#include <picojson.h>
+#include <pixel_format.h>
+#include <spriteset_map.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <new>
+#include <string>
+#include <vector>
+
+/*
+ * Steady-state frames of a map replaying an input log through
+ * Input::LogSource: Game_Map::Update with the player walking by the
+ * replayed buttons, the spriteset update and Graphics::Draw on a headless
+ * display. The log restarts when it ends.
+ * tests/game has no maps, the map is the 40x30 mock map with the graphics
+ * of the test project. Without --replay_log a generated walk is replayed.
+ * Every frame is timed: the results are p50, p99 and max of the update and
+ * of the draw time, frames over the 60 FPS budget, heap allocations per
+ * frame and the peak of the MemoryStats.
+ *
+ * Options after the benchmark flags:
+ *   --replay_log=FILE       input log to replay, text or binary format
+ *   --replay_report=FILE    writes the results as JSON
+ *   --replay_baseline=FILE  report of an earlier run, exits with 1 when a
+ *                           result is worse than in it by the tolerance
+ *   --replay_tolerance=PCT  allowed regression in percent, default 10
+ * Rates are in frames per second.
+ */
+
+namespace {
+
+std::atomic<int64_t> num_allocs(0);
+std::atomic<int64_t> num_alloc_bytes(0);
+
+constexpr double frame_budget_us = 1000000.0 / 60;
+constexpr int warmup_frames = 60;
+constexpr int walk_side_frames = 128;
+
+const char* const generated_log = "bench_replay.log";
+
+struct Options {
+	std::string log = generated_log;
+	std::string report;
+	std::string baseline;
+	double tolerance = 10.0;
+} options;
+
+/** Results of the last run of every benchmark */
+std::map<std::string, picojson::object> results;
+
+/** Results which are not compared with the baseline, a higher value is no regression or too noisy */
+const char* const uncompared[] = { "frames", "update_max_us", "draw_max_us" };
+
+/** Writes a walk around a square with a DECISION every second in the text format */
+bool WriteWalkLog(const std::string& path) {
+	std::ofstream out(path, std::ios_base::out | std::ios_base::trunc);
+	out << "H EasyRPG Player Recording\n";
+	out << "V 2\n";
+
+	const char* const sides[] = { "RIGHT", "DOWN", "LEFT", "UP" };
+	int frame = 0;
+	for (auto* side : sides) {
+		for (int i = 0; i < walk_side_frames; ++i, ++frame) {
+			out << "F " << frame << ',' << side;
+			if (frame % 60 == 0) {
+				out << ",DECISION";
+			}
+			out << '\n';
+		}
+	}
+	return bool(out);
+}
+
+/** @return bytes of memory accounted by MemoryStats */
+int64_t GetAccountedMemory() {
+	int64_t bytes = 0;
+	for (int i = 0; i < static_cast<int>(MemoryStats::Category::END); ++i) {
+		const auto category = static_cast<MemoryStats::Category>(i);
+		// Already included in Bitmap
+		if (category != MemoryStats::Category::Font) {
+			bytes += MemoryStats::Get(category);
+		}
+	}
+	return bytes;
+}
+
+double Percentile(std::vector<double> values, double p) {
+	if (values.empty()) {
+		return 0.0;
+	}
+	auto it = values.begin() + std::min(values.size() - 1, static_cast<size_t>(p * values.size()));
+	std::nth_element(values.begin(), it, values.end());
+	return *it;
+}
+
+/** Per frame measurements of a run */
+struct FrameStats {
+	std::vector<double> update_us;
+	std::vector<double> draw_us;
+	int64_t allocs = 0;
+	int64_t alloc_bytes = 0;
+	int64_t peak_memory = 0;
+	int over_budget = 0;
+
+	picojson::object ToJson() const {
+		const double frames = std::max<size_t>(update_us.size(), 1);
+		picojson::object obj;
+		obj["frames"] = picojson::value(static_cast<double>(update_us.size()));
+		obj["update_p50_us"] = picojson::value(Percentile(update_us, 0.5));
+		obj["update_p99_us"] = picojson::value(Percentile(update_us, 0.99));
+		obj["update_max_us"] = picojson::value(Percentile(update_us, 1.0));
+		obj["draw_p50_us"] = picojson::value(Percentile(draw_us, 0.5));
+		obj["draw_p99_us"] = picojson::value(Percentile(draw_us, 0.99));
+		obj["draw_max_us"] = picojson::value(Percentile(draw_us, 1.0));
+		obj["over_budget_frames"] = picojson::value(static_cast<double>(over_budget));
+		obj["allocs_per_frame"] = picojson::value(allocs / frames);
+		obj["alloc_bytes_per_frame"] = picojson::value(alloc_bytes / frames);
+		obj["peak_memory_bytes"] = picojson::value(static_cast<double>(peak_memory));
+		return obj;
+	}
+};
+
+/** Mock game with the test project as game directory, a map spriteset and the replayed log */
+class ReplayFixture {
+public:
+	ReplayFixture() : game(MockMap::ePass40x30) {
+		Bitmap::SetFormat(format_R8G8B8A8_a().format());
+		Main_Data::Init();
+		FileFinder::SetDirectoryTree(FileFinder::CreateDirectoryTree(EP_TEST_PATH "/game"));
+		if (!DisplayUi) {
+			DisplayUi = std::make_shared<HeadlessUi>(SCREEN_TARGET_WIDTH, SCREEN_TARGET_HEIGHT, Game_ConfigVideo());
+			owns_ui = true;
+		}
+
+		Graphics::Init();
+		spriteset.reset(new Spriteset_Map());
+		dst = Bitmap::Create(SCREEN_TARGET_WIDTH, SCREEN_TARGET_HEIGHT, false);
+		Restart();
+	}
+
+	~ReplayFixture() {
+		spriteset.reset();
+		Input::source.reset();
+		Player::exit_flag = false;
+		Graphics::Quit();
+		if (owns_ui) {
+			DisplayUi.reset();
+		}
+	}
+
+	/** @return whether the replayed log ended */
+	bool AtEnd() const {
+		return Player::exit_flag;
+	}
+
+	/** Replays the log from the start, the player continues from its position */
+	void Restart() {
+		Player::exit_flag = false;
+		Main_Data::game_system->ResetFrameCounter();
+		Input::Init(Input::GetDefaultButtonMappings(), Input::GetDefaultDirectionMappings(), options.log, "");
+	}
+
+	/** Runs a frame, the draw is invalidated first when full is set */
+	void Step(bool full, FrameStats* stats) {
+		using clock = std::chrono::steady_clock;
+		const auto allocs = num_allocs.load(std::memory_order_relaxed);
+		const auto alloc_bytes = num_alloc_bytes.load(std::memory_order_relaxed);
+
+		const auto start = clock::now();
+		Input::Update();
+		MapUpdateAsyncContext actx;
+		Game_Map::Update(actx);
+		spriteset->Update();
+
+		const auto drawn = clock::now();
+		if (full) {
+			Graphics::InvalidateFrame();
+		}
+		Graphics::Draw(*dst);
+		const auto end = clock::now();
+		const auto frame_allocs = num_allocs.load(std::memory_order_relaxed) - allocs;
+		const auto frame_alloc_bytes = num_alloc_bytes.load(std::memory_order_relaxed) - alloc_bytes;
+
+		Main_Data::game_system->IncFrameCounter();
+		if (!stats) {
+			return;
+		}
+
+		const double update_us = std::chrono::duration<double, std::micro>(drawn - start).count();
+		const double draw_us = std::chrono::duration<double, std::micro>(end - drawn).count();
+		stats->update_us.push_back(update_us);
+		stats->draw_us.push_back(draw_us);
+		if (update_us + draw_us > frame_budget_us) {
+			++stats->over_budget;
+		}
+		stats->allocs += frame_allocs;
+		stats->alloc_bytes += frame_alloc_bytes;
+		stats->peak_memory = std::max(stats->peak_memory, GetAccountedMemory());
+	}
+
+private:
+	MockGame game;
+	std::unique_ptr<Spriteset_Map> spriteset;
+	BitmapRef dst;
+	bool owns_ui = false;
+};
+
+bool ParseOption(const std::string& arg, const char* name, std::string& value) {
+	const std::string prefix = std::string("--") + name + "=";
+	if (arg.compare(0, prefix.size(), prefix) != 0) {
+		return false;
+	}
+	value = arg.substr(prefix.size());
+	return true;
+}
+
+bool WriteReport(const std::string& path) {
+	picojson::object benchmarks;
+	for (auto& result : results) {
+		benchmarks[result.first] = picojson::value(result.second);
+	}
+	picojson::object report;
+	report["budget_us"] = picojson::value(frame_budget_us);
+	report["benchmarks"] = picojson::value(benchmarks);
+
+	std::ofstream out(path, std::ios_base::out | std::ios_base::trunc);
+	out << picojson::value(report).serialize(true);
+	return bool(out);
+}
+
+/** @return whether no result is worse than in the baseline by more than the tolerance */
+bool CompareBaseline(const std::string& path) {
+	std::ifstream in(path);
+	picojson::value baseline;
+	const std::string err = in ? picojson::parse(baseline, in) : "not readable";
+	if (!err.empty() || !baseline.is<picojson::object>() || !baseline.get("benchmarks").is<picojson::object>()) {
+		std::fprintf(stderr, "Baseline %s not loaded: %s\n", path.c_str(), err.c_str());
+		return false;
+	}
+
+	bool ok = true;
+	for (auto& bench : baseline.get("benchmarks").get<picojson::object>()) {
+		auto it = results.find(bench.first);
+		if (it == results.end() || !bench.second.is<picojson::object>()) {
+			continue;
+		}
+		for (auto& value : bench.second.get<picojson::object>()) {
+			if (std::find(std::begin(uncompared), std::end(uncompared), value.first) != std::end(uncompared)
+					|| !value.second.is<double>() || !it->second[value.first].is<double>()) {
+				continue;
+			}
+			const double base = value.second.get<double>();
+			const double current = it->second[value.first].get<double>();
+			if (current > base * (1.0 + options.tolerance / 100.0)) {
+				std::fprintf(stderr, "Regression in %s %s: %.2f, baseline %.2f\n",
+					bench.first.c_str(), value.first.c_str(), current, base);
+				ok = false;
+			}
+		}
+	}
+	return ok;
+}
+
+}
+
+void* operator new(std::size_t size) {
+	num_allocs.fetch_add(1, std::memory_order_relaxed);
+	num_alloc_bytes.fetch_add(size, std::memory_order_relaxed);
+	if (void* ptr = std::malloc(size ? size : 1)) {
+		return ptr;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+	std::free(ptr);
+}
+
+static void BM_ReplayMap(benchmark::State& state) {
+	// Arg 0: every frame invalidated or only the changed parts drawn
+	const bool full = state.range(0) != 0;
+	ReplayFixture fixture;
+
+	for (int i = 0; i < warmup_frames; ++i) {
+		fixture.Step(full, nullptr);
+	}
+
+	FrameStats stats;
+	for (auto _: state) {
+		if (fixture.AtEnd()) {
+			state.PauseTiming();
+			fixture.Restart();
+			state.ResumeTiming();
+		}
+		fixture.Step(full, &stats);
+	}
+
+	auto result = stats.ToJson();
+	for (auto* name : { "update_p50_us", "update_p99_us", "draw_p50_us", "draw_p99_us", "allocs_per_frame", "peak_memory_bytes" }) {
+		state.counters[name] = result[name].get<double>();
+	}
+	state.counters["frames"] = benchmark::Counter(static_cast<double>(stats.update_us.size()), benchmark::Counter::kIsRate);
+	results["BM_ReplayMap/" + std::to_string(state.range(0))] = std::move(result);
+}
+
+BENCHMARK(BM_ReplayMap)->Arg(0)->Arg(1);
+
+int main(int argc, char** argv) {
+	benchmark::Initialize(&argc, argv);
+
+	int remaining = 1;
+	for (int i = 1; i < argc; ++i) {
+		const std::string arg = argv[i];
+		std::string tolerance;
+		if (!ParseOption(arg, "replay_log", options.log) && !ParseOption(arg, "replay_report", options.report)
+				&& !ParseOption(arg, "replay_baseline", options.baseline)) {
+			if (ParseOption(arg, "replay_tolerance", tolerance)) {
+				options.tolerance = std::atof(tolerance.c_str());
+			} else {
+				argv[remaining++] = argv[i];
+			}
+		}
+	}
+	argc = remaining;
+	if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+		return 1;
+	}
+
+	const bool generated = options.log == generated_log;
+	if (generated && !WriteWalkLog(options.log)) {
+		std::fprintf(stderr, "Log %s not written\n", options.log.c_str());
+		return 1;
+	}
+
+	benchmark::RunSpecifiedBenchmarks();
+
+	if (generated) {
+		std::remove(options.log.c_str());
+	}
+
+	if (!options.report.empty() && !WriteReport(options.report)) {
+		std::fprintf(stderr, "Report %s not written\n", options.report.c_str());
+		return 1;
+	}
+	if (!options.baseline.empty() && !CompareBaseline(options.baseline)) {
+		return 1;
+	}
+	return 0;
+}
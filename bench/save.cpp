@@ -0,0 +1,170 @@
+#include <benchmark/benchmark.h>
+#include "mock_game.h"
+#include <game_event.h>
+#include <lcf/lsd/reader.h>
+#include <lcf/rpg/eventcommand.h>
+#include <lcf/rpg/save.h>
+#include <iterator>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/*
+ * Savegame serialization through LSD_Reader and the collection of the
+ * event states by Game_Event::GetSaveData.
+ * The save is generated: thousands of switches and variables, many
+ * pictures and map events with move routes and running parallel events.
+ * Rates are in savegame bytes or in events per second.
+ */
+
+namespace {
+
+using Cmd = lcf::rpg::EventCommand::Code;
+
+constexpr int num_switches = 5000;
+constexpr int num_variables = 5000;
+constexpr int num_pictures = 1000;
+constexpr int num_commands = 30;
+
+std::vector<lcf::rpg::EventCommand> MakeCommands() {
+	std::vector<lcf::rpg::EventCommand> list;
+	for (int i = 0; i < num_commands; ++i) {
+		lcf::rpg::EventCommand com;
+		com.code = static_cast<int>(i % 2 ? Cmd::ControlVars : Cmd::Wait);
+		const int32_t params[] = { 0, i + 1, i + 1, 1, 0, i };
+		com.parameters = lcf::DBArray<int32_t>(std::begin(params), std::end(params));
+		list.push_back(std::move(com));
+	}
+	return list;
+}
+
+lcf::rpg::SaveEventExecState MakeExecState(int event_id) {
+	lcf::rpg::SaveEventExecState state;
+	state.stack.emplace_back();
+	state.stack.back().event_id = event_id;
+	state.stack.back().current_command = event_id % num_commands;
+	state.stack.back().commands = MakeCommands();
+	return state;
+}
+
+lcf::rpg::SaveMapEvent MakeEventSave(int event_id) {
+	lcf::rpg::SaveMapEvent ev;
+	ev.ID = event_id;
+	ev.position_x = event_id % 100;
+	ev.position_y = event_id / 100;
+	ev.sprite_name = "Chara" + std::to_string(event_id % 8);
+	for (int i = 0; i < 8; ++i) {
+		lcf::rpg::MoveCommand move;
+		move.command_id = i % 4;
+		ev.move_route.move_commands.push_back(move);
+	}
+	ev.parallel_event_execstate = MakeExecState(event_id);
+	return ev;
+}
+
+lcf::rpg::Save MakeSave(int num_events) {
+	lcf::rpg::Save save;
+	save.title.hero_name = "Alex";
+	save.system.switches.resize(num_switches);
+	for (int i = 0; i < num_switches; i += 3) {
+		save.system.switches[i] = true;
+	}
+	save.system.variables.resize(num_variables);
+	for (int i = 0; i < num_variables; ++i) {
+		save.system.variables[i] = i * 7919;
+	}
+	for (int i = 0; i < num_pictures; ++i) {
+		lcf::rpg::SavePicture pic;
+		pic.ID = i + 1;
+		pic.name = "Picture" + std::to_string(i);
+		pic.start_x = pic.current_x = pic.finish_x = i % 320;
+		pic.start_y = pic.current_y = pic.finish_y = i % 240;
+		pic.current_magnify = pic.finish_magnify = 100;
+		save.pictures.push_back(std::move(pic));
+	}
+	for (int i = 0; i < num_events; ++i) {
+		save.map_info.events.push_back(MakeEventSave(i + 1));
+	}
+	return save;
+}
+
+std::string Serialize(const lcf::rpg::Save& save) {
+	std::ostringstream os(std::ios_base::out | std::ios_base::binary);
+	lcf::LSD_Reader::Save(os, save, lcf::EngineVersion::e2k3, "1252");
+	return os.str();
+}
+
+}
+
+static void BM_SaveWrite(benchmark::State& state) {
+	// Arg 0: number of map events
+	const auto save = MakeSave(static_cast<int>(state.range(0)));
+
+	int64_t bytes = 0;
+	for (auto _: state) {
+		std::ostringstream os(std::ios_base::out | std::ios_base::binary);
+		lcf::LSD_Reader::Save(os, save, lcf::EngineVersion::e2k3, "1252");
+		bytes += os.tellp();
+	}
+
+	state.counters["bytes"] = benchmark::Counter(static_cast<double>(bytes), benchmark::Counter::kIsRate);
+}
+
+BENCHMARK(BM_SaveWrite)->Arg(100)->Arg(1000);
+
+static void BM_SaveLoad(benchmark::State& state) {
+	// Arg 0: number of map events
+	const auto data = Serialize(MakeSave(static_cast<int>(state.range(0))));
+
+	int64_t bytes = 0;
+	for (auto _: state) {
+		std::istringstream is(data, std::ios_base::in | std::ios_base::binary);
+		auto save = lcf::LSD_Reader::Load(is, "1252");
+		if (!save) {
+			state.SkipWithError("Save not loaded");
+			return;
+		}
+		benchmark::DoNotOptimize(save.get());
+		bytes += data.size();
+	}
+
+	state.counters["bytes"] = benchmark::Counter(static_cast<double>(bytes), benchmark::Counter::kIsRate);
+}
+
+BENCHMARK(BM_SaveLoad)->Arg(100)->Arg(1000);
+
+static void BM_EventGetSaveData(benchmark::State& state) {
+	// Arg 0: number of parallel events with a running interpreter
+	const int num_events = static_cast<int>(state.range(0));
+	MockGame game(MockMap::ePass40x30);
+
+	lcf::rpg::Event event;
+	event.ID = 1;
+	event.pages.emplace_back();
+	event.pages.back().ID = 1;
+	event.pages.back().trigger = lcf::rpg::EventPage::Trigger_parallel;
+	event.pages.back().event_commands = MakeCommands();
+
+	std::vector<std::unique_ptr<Game_Event>> events;
+	for (int i = 0; i < num_events; ++i) {
+		events.emplace_back(new Game_Event(1, &event));
+		auto save = MakeEventSave(1);
+		save.active = true;
+		events.back()->SetSaveData(std::move(save));
+	}
+
+	int64_t done = 0;
+	for (auto _: state) {
+		for (auto& ev : events) {
+			benchmark::DoNotOptimize(ev->GetSaveData());
+		}
+		done += num_events;
+	}
+
+	state.counters["events"] = benchmark::Counter(static_cast<double>(done), benchmark::Counter::kIsRate);
+}
+
+BENCHMARK(BM_EventGetSaveData)->Arg(100)->Arg(1000);
+
+BENCHMARK_MAIN();
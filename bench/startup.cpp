@@ -0,0 +1,285 @@
+#include <benchmark/benchmark.h>
+#include <asset_cache.h>
+#include <filefinder.h>
+#include <output.h>
+#include <player.h>
+#include <rtp.h>
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#ifdef _WIN32
+#  include <direct.h>
+#else
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+/*
+ * Startup work on the game directory: the directory tree, with and without
+ * the on-disk index of the AssetCache, file lookups, RTP detection and the
+ * extension guessing.
+ * The game trees are generated in the working directory and removed again.
+ * They have the RPG Maker folders with files in mixed case and nested
+ * picture folders.
+ * Rates are in files or lookups per second.
+ */
+
+namespace {
+
+const char* const folders[] = {
+	"Backdrop", "Battle", "CharSet", "ChipSet", "FaceSet", "GameOver", "Monster",
+	"Movie", "Music", "Panorama", "Picture", "Sound", "System", "Title"
+};
+constexpr int num_folders = sizeof(folders) / sizeof(folders[0]);
+constexpr int num_nested = 8;
+constexpr int num_lookups = 1024;
+
+bool MakeDirectory(const std::string& path) {
+#ifdef _WIN32
+	return _mkdir(path.c_str()) == 0;
+#else
+	return mkdir(path.c_str(), 0755) == 0;
+#endif
+}
+
+void RemoveDirectory(const std::string& path) {
+#ifdef _WIN32
+	_rmdir(path.c_str());
+#else
+	rmdir(path.c_str());
+#endif
+}
+
+/** @return file name number i, in mixed case as in old games */
+std::string FileName(int i) {
+	switch (i % 3) {
+		case 0:
+			return "file" + std::to_string(i) + ".png";
+		case 1:
+			return "File_" + std::to_string(i) + ".PNG";
+		default:
+			return "FILE" + std::to_string(i) + ".Png";
+	}
+}
+
+/** Game directory with num_files empty files, removed again on destruction */
+class GameTree {
+public:
+	explicit GameTree(int num_files) : path("bench_startup_" + std::to_string(num_files)) {
+		AddDirectory(path);
+		AddFile(path + "/RPG_RT.ldb");
+		AddFile(path + "/RPG_RT.lmt");
+		AddFile(path + "/RPG_RT.ini");
+
+		for (auto* folder : folders) {
+			AddDirectory(path + "/" + folder);
+		}
+		for (int i = 0; i < num_nested; ++i) {
+			AddDirectory(path + "/Picture/Sub" + std::to_string(i));
+		}
+
+		for (int i = 0; i < num_files; ++i) {
+			const std::string folder = folders[i % num_folders];
+			std::string name = FileName(i);
+			if (folder == "Picture" && i % 2 == 0) {
+				name = "Sub" + std::to_string(i / 2 % num_nested) + "/" + name;
+			}
+			AddFile(path + "/" + folder + "/" + name);
+			// Looked up without extension and in another case
+			name = name.substr(0, name.rfind('.'));
+			std::transform(name.begin(), name.end(), name.begin(), [](char c) { return std::toupper(c); });
+			entries.emplace_back(folder, std::move(name));
+		}
+	}
+
+	~GameTree() {
+		for (auto it = files.rbegin(); it != files.rend(); ++it) {
+			std::remove(it->c_str());
+		}
+		for (auto it = directories.rbegin(); it != directories.rend(); ++it) {
+			RemoveDirectory(*it);
+		}
+	}
+
+	const std::string& GetPath() const {
+		return path;
+	}
+
+	/** @return lookups of existing and missing files, spread over all folders */
+	std::vector<std::pair<std::string, std::string>> MakeLookups() const {
+		std::vector<std::pair<std::string, std::string>> lookups;
+		for (int i = 0; i < num_lookups; ++i) {
+			auto lookup = entries[(i * 7919L) % entries.size()];
+			if (i % 4 == 0) {
+				lookup.second += "_missing";
+			}
+			lookups.push_back(std::move(lookup));
+		}
+		return lookups;
+	}
+
+private:
+	void AddDirectory(const std::string& dir) {
+		MakeDirectory(dir);
+		directories.push_back(dir);
+	}
+
+	void AddFile(const std::string& file) {
+		std::ofstream(file, std::ios_base::binary);
+		files.push_back(file);
+	}
+
+	std::string path;
+	std::vector<std::string> directories;
+	std::vector<std::string> files;
+	std::vector<std::pair<std::string, std::string>> entries;
+};
+
+/** Enables the AssetCache in a directory of the working directory while alive */
+class AssetCacheDirectory {
+public:
+	AssetCacheDirectory() {
+		MakeDirectory(path);
+		AssetCache::SetDirectory(path);
+	}
+
+	~AssetCacheDirectory() {
+		AssetCache::SetDirectory("");
+		for (auto& file : FileFinder::GetDirectoryMembers(path, FileFinder::FILES).files) {
+			std::remove(FileFinder::MakePath(path, file.second).c_str());
+		}
+		RemoveDirectory(path);
+	}
+
+private:
+	std::string path = "bench_startup_cache";
+};
+
+/** Looks up every file of a lazy tree so that all folders are listed */
+void ListAll(const FileFinder::DirectoryTree& tree) {
+	for (auto& dir : tree.directories) {
+		benchmark::DoNotOptimize(tree.FindSubMembers(dir.first));
+	}
+}
+
+}
+
+static void BM_CreateDirectoryTree(benchmark::State& state) {
+	// Arg 0: number of files, Arg 1: lazy tree or tree from the index of the AssetCache
+	const int num_files = static_cast<int>(state.range(0));
+	const bool indexed = state.range(1) != 0;
+	GameTree game(num_files);
+
+	std::unique_ptr<AssetCacheDirectory> cache;
+	if (indexed) {
+		cache.reset(new AssetCacheDirectory());
+		// The index is written by the first tree
+		FileFinder::CreateDirectoryTree(game.GetPath());
+	}
+
+	int64_t files = 0;
+	for (auto _: state) {
+		auto tree = FileFinder::CreateDirectoryTree(game.GetPath());
+		if (!tree) {
+			state.SkipWithError("Game tree not created");
+			return;
+		}
+		// Startup looks up files in most folders
+		ListAll(*tree);
+		files += num_files;
+	}
+
+	state.counters["files"] = benchmark::Counter(static_cast<double>(files), benchmark::Counter::kIsRate);
+}
+
+BENCHMARK(BM_CreateDirectoryTree)
+	->Args({10000, 0})->Args({50000, 0})->Args({10000, 1})->Args({50000, 1});
+
+static void BM_FindImage(benchmark::State& state) {
+	// Arg 0: number of files, Arg 1: lookups repeated or lookup cache reset before them
+	const int num_files = static_cast<int>(state.range(0));
+	const bool cached = state.range(1) != 0;
+	GameTree game(num_files);
+	auto tree = FileFinder::CreateDirectoryTree(game.GetPath());
+	ListAll(*tree);
+	FileFinder::SetDirectoryTree(tree);
+	const auto lookups = game.MakeLookups();
+
+	auto lvl = Output::GetLogLevel();
+	Output::SetLogLevel(LogLevel::Error);
+
+	int64_t done = 0;
+	for (auto _: state) {
+		if (!cached) {
+			// Resets the lookup cache
+			FileFinder::SetDirectoryTree(tree);
+		}
+		for (auto& lookup : lookups) {
+			benchmark::DoNotOptimize(FileFinder::FindImage(lookup.first, lookup.second));
+		}
+		done += lookups.size();
+	}
+
+	FileFinder::SetDirectoryTree(nullptr);
+	Output::SetLogLevel(lvl);
+	state.counters["lookups"] = benchmark::Counter(static_cast<double>(done), benchmark::Counter::kIsRate);
+}
+
+BENCHMARK(BM_FindImage)->Args({10000, 0})->Args({50000, 0})->Args({10000, 1});
+
+static void BM_FindDefault(benchmark::State& state) {
+	// Arg 0: number of files
+	const int num_files = static_cast<int>(state.range(0));
+	GameTree game(num_files);
+	auto tree = FileFinder::CreateDirectoryTree(game.GetPath());
+	ListAll(*tree);
+	const auto lookups = game.MakeLookups();
+
+	int64_t done = 0;
+	for (auto _: state) {
+		for (auto& lookup : lookups) {
+			benchmark::DoNotOptimize(FileFinder::FindDefault(*tree, lookup.first, lookup.second + ".png"));
+		}
+		done += lookups.size();
+	}
+
+	state.counters["lookups"] = benchmark::Counter(static_cast<double>(done), benchmark::Counter::kIsRate);
+}
+
+BENCHMARK(BM_FindDefault)->Arg(10000)->Arg(50000);
+
+static void BM_RtpDetect(benchmark::State& state) {
+	// Arg 0: number of files
+	const int num_files = static_cast<int>(state.range(0));
+	GameTree game(num_files);
+	auto tree = FileFinder::CreateDirectoryTree(game.GetPath());
+	ListAll(*tree);
+
+	for (auto _: state) {
+		benchmark::DoNotOptimize(RTP::Detect(tree, 0));
+	}
+}
+
+BENCHMARK(BM_RtpDetect)->Arg(10000)->Arg(50000);
+
+static void BM_GuessNonStandardExtensions(benchmark::State& state) {
+	// Arg 0: number of files
+	const int num_files = static_cast<int>(state.range(0));
+	GameTree game(num_files);
+	FileFinder::SetDirectoryTree(FileFinder::CreateDirectoryTree(game.GetPath()));
+
+	for (auto _: state) {
+		Player::GuessNonStandardExtensions();
+	}
+
+	FileFinder::SetDirectoryTree(nullptr);
+}
+
+BENCHMARK(BM_GuessNonStandardExtensions)->Arg(10000)->Arg(50000);
+
+BENCHMARK_MAIN();
@@ -64,5 +64,39 @@ static void BM_SwitchFlipRange(benchmark::State& state) {
 
 BENCHMARK(BM_SwitchFlipRange);
 
+static void BM_SwitchSetRangeUnaligned(benchmark::State& state) {
+	BM_SwitchOp(state, [](auto& s, auto, bool val) { s.SetRange(3, max_sws - 5, val); });
+}
+
+BENCHMARK(BM_SwitchSetRangeUnaligned);
+
+static void BM_SwitchFlipRangeChanges(benchmark::State& state) {
+	// The change log is emptied every time like a frame would
+	BM_SwitchOp(state, [](auto& s, auto, bool) { s.FlipRange(1, max_sws); s.ClearChanges(); });
+}
+
+BENCHMARK(BM_SwitchFlipRangeChanges);
+
+static void BM_SwitchSetChanges(benchmark::State& state) {
+	volatile int x = 0;
+	BM_SwitchOp(state, [&x](auto& s, auto id, bool) {
+		x = s.Flip(id);
+		x = s.GetChanges().size();
+		s.ClearChanges();
+	});
+}
+
+BENCHMARK(BM_SwitchSetChanges);
+
+static void BM_SwitchGetData(benchmark::State& state) {
+	auto s = make();
+	for (auto _: state) {
+		auto data = s.GetData();
+		benchmark::DoNotOptimize(data);
+	}
+}
+
+BENCHMARK(BM_SwitchGetData);
+
 
 BENCHMARK_MAIN();
@@ -5,6 +5,7 @@
 #include <text.h>
 #include <pixel_format.h>
 #include <cache.h>
+#include <utils.h>
 
 const std::string text = "Alex $A landed a critical hit on Slime $B!";
 char32_t symbol = '\\';
@@ -81,4 +82,20 @@ static void BM_TextDrawCharColorEx(benchmark::State& state) {
 
 BENCHMARK(BM_TextDrawCharColorEx);
 
+static void BM_TextNext(benchmark::State& state) {
+	const auto* end = text.data() + text.size();
+
+	for (auto _: state) {
+		uint32_t sum = 0;
+		for (const auto* iter = text.data(); iter != end;) {
+			auto ret = Utils::TextNext(iter, end, symbol);
+			sum += ret.ch;
+			iter = ret.next;
+		}
+		benchmark::DoNotOptimize(sum);
+	}
+}
+
+BENCHMARK(BM_TextNext);
+
 BENCHMARK_MAIN();
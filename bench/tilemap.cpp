@@ -0,0 +1,214 @@
+#include <benchmark/benchmark.h>
+#include "mock_game.h"
+#include <baseui.h>
+#include <bitmap.h>
+#include <drawable_list.h>
+#include <drawable_mgr.h>
+#include <game_config.h>
+#include <game_system.h>
+#include <headless_ui.h>
+#include <main_data.h>
+#include <map_data.h>
+#include <options.h>
+#include <pixel_format.h>
+#include <tilemap_layer.h>
+#include <algorithm>
+#include <vector>
+
+/*
+ * TilemapLayer drawing of both layers to a 320x240 screen and the tile
+ * cache build of SetMapData. The chipset and the maps are generated:
+ * the lower layer mixes static, autotile and animated tiles and the
+ * upper layer has transparent, translucent and opaque tiles.
+ * Rates are in frames or in map tiles per second.
+ */
+
+namespace {
+
+enum Mode {
+	eStatic,
+	eScrolling,
+	eAnimated,
+	eToned,
+	eToneTween
+};
+
+/** @return 480x256 chipset, tiles of the right half are partially transparent */
+BitmapRef MakeChipset() {
+	auto bitmap = Bitmap::Create(480, 256, true);
+	for (int y = 0; y < bitmap->GetHeight(); ++y) {
+		auto* row = reinterpret_cast<uint32_t*>(static_cast<uint8_t*>(bitmap->pixels()) + y * bitmap->pitch());
+		for (int x = 0; x < bitmap->GetWidth(); ++x) {
+			const int tx = x / TILE_SIZE;
+			const int ty = y / TILE_SIZE;
+			uint8_t a = 255;
+			if (tx >= 18 && (tx + ty) % 3 == 0) {
+				a = 0;
+			} else if (tx >= 18 && (tx + ty) % 3 == 1 && (x + y) % 2 == 0) {
+				a = 128;
+			}
+			row[x] = Bitmap::pixel_format.rgba_to_uint32_t((x * 7 + ty * 13) * a / 255 % 256,
+					(y * 5 + tx * 11) * a / 255 % 256, (tx * ty) * a / 255 % 256, a);
+		}
+	}
+	bitmap->CheckPixels(Bitmap::Flag_Chipset);
+	return bitmap;
+}
+
+/** @return lower layer tile, one in animated_every is an animated A or C tile */
+short LowerTile(int i, int animated_every) {
+	if (i % animated_every == 0) {
+		const int n = i / animated_every;
+		if (n % 4 == 0) {
+			return BLOCK_C + (n / 4 % BLOCK_C_TILES) * BLOCK_C_STRIDE;
+		}
+		return BLOCK_A + (n % 3) * 1000 + (n / 3 % 16) * 50 + n % 47;
+	}
+	if (i % 3 == 0) {
+		return BLOCK_D + (i / 3 % BLOCK_D_TILES) * BLOCK_D_STRIDE + i % 47;
+	}
+	return BLOCK_E + i % BLOCK_E_TILES;
+}
+
+std::vector<short> MakeMapData(int width, int height, int layer, int animated_every) {
+	std::vector<short> data(width * height);
+	for (int i = 0; i < static_cast<int>(data.size()); ++i) {
+		// Scatter the tiles, neighbours should not repeat in rows
+		const int n = (i * 31 + i / width * 17) % 1009;
+		data[i] = layer == 0 ? LowerTile(n, animated_every) : BLOCK_F + n % BLOCK_F_TILES;
+	}
+	return data;
+}
+
+std::vector<unsigned char> MakePassable(int layer) {
+	std::vector<unsigned char> passable(layer == 0 ? NUM_LOWER_TILES : NUM_UPPER_TILES, 0x0F);
+	for (size_t i = 0; i < passable.size(); i += 5) {
+		passable[i] |= layer == 0 ? Passable::Wall : Passable::Above;
+	}
+	return passable;
+}
+
+/** Both layers of a map with the game state Draw needs */
+class BenchTilemap {
+public:
+	BenchTilemap(int width, int height, int animated_every) : game(MockMap::ePass40x30) {
+		Bitmap::SetFormat(format_R8G8B8A8_a().format());
+		if (!DisplayUi) {
+			DisplayUi = std::make_shared<HeadlessUi>(SCREEN_TARGET_WIDTH, SCREEN_TARGET_HEIGHT, Game_ConfigVideo());
+			owns_ui = true;
+		}
+		DrawableMgr::SetLocalList(&list);
+
+		auto chipset = MakeChipset();
+		for (int i = 0; i < 2; ++i) {
+			layers.emplace_back(new TilemapLayer(i));
+			auto& layer = *layers.back();
+			layer.SetWidth(width);
+			layer.SetHeight(height);
+			layer.SetChipset(chipset);
+			layer.SetMapData(MakeMapData(width, height, i, animated_every));
+			layer.SetPassable(MakePassable(i));
+		}
+		screen = Bitmap::Create(SCREEN_TARGET_WIDTH, SCREEN_TARGET_HEIGHT, Color(0, 0, 0, 255));
+	}
+
+	~BenchTilemap() {
+		layers.clear();
+		DrawableMgr::SetLocalList(nullptr);
+		if (owns_ui) {
+			DisplayUi.reset();
+		}
+	}
+
+	void Draw() {
+		for (int i = 0; i < 2; ++i) {
+			layers[i]->Draw(*screen, Priority_TilesetBelow + i);
+			layers[i]->Draw(*screen, Priority_TilesetAbove + i);
+		}
+		benchmark::DoNotOptimize(screen->pixels());
+	}
+
+	void SetOrigin(int ox, int oy) {
+		for (auto& layer : layers) {
+			layer->SetOx(ox);
+			layer->SetOy(oy);
+		}
+	}
+
+	void SetTone(Tone tone) {
+		for (auto& layer : layers) {
+			layer->SetTone(tone);
+		}
+	}
+
+private:
+	MockGame game;
+	DrawableList list;
+	std::vector<std::unique_ptr<TilemapLayer>> layers;
+	BitmapRef screen;
+	bool owns_ui = false;
+};
+
+}
+
+static void BM_TilemapDraw(benchmark::State& state) {
+	// Arg 0: map width and height in tiles, Arg 1: Mode
+	const int size = static_cast<int>(state.range(0));
+	const auto mode = static_cast<Mode>(state.range(1));
+
+	// Without animation the animated tiles are drawn with the same step every frame
+	BenchTilemap tilemap(size, size, mode == eAnimated ? 4 : 16);
+	if (mode == eToned) {
+		tilemap.SetTone(Tone(160, 100, 100, 64));
+	}
+
+	const int scroll_w = std::max(size * TILE_SIZE - SCREEN_TARGET_WIDTH, 1);
+	const int scroll_h = std::max(size * TILE_SIZE - SCREEN_TARGET_HEIGHT, 1);
+
+	int64_t frame = 0;
+	for (auto _: state) {
+		if (mode == eScrolling) {
+			// Diagonal at 2 pixels per frame, partial tiles at the borders
+			tilemap.SetOrigin(frame * 2 % scroll_w, frame * 3 % scroll_h);
+		} else if (mode == eAnimated) {
+			Main_Data::game_system->IncFrameCounter();
+		} else if (mode == eToneTween) {
+			const int step = frame % 64;
+			tilemap.SetTone(Tone(128 + step, 128 - step, 128, step * 2));
+		}
+		tilemap.Draw();
+		++frame;
+	}
+
+	state.counters["frames"] = benchmark::Counter(static_cast<double>(frame), benchmark::Counter::kIsRate);
+}
+
+BENCHMARK(BM_TilemapDraw)
+	->Args({20, eStatic})->Args({128, eStatic})
+	->Args({128, eScrolling})->Args({500, eScrolling})
+	->Args({128, eAnimated})
+	->Args({128, eToned})->Args({128, eToneTween});
+
+static void BM_TilemapSetMapData(benchmark::State& state) {
+	// Arg 0: map width and height in tiles
+	const int size = static_cast<int>(state.range(0));
+	// Only for the game state, the layer substitutions come from the map
+	BenchTilemap tilemap(20, 15, 16);
+	TilemapLayer layer(0);
+	layer.SetPassable(MakePassable(0));
+	layer.SetWidth(size);
+	layer.SetHeight(size);
+	const auto data = MakeMapData(size, size, 0, 16);
+
+	int64_t tiles = 0;
+	for (auto _: state) {
+		layer.SetMapData(data);
+		tiles += data.size();
+	}
+
+	state.counters["tiles"] = benchmark::Counter(static_cast<double>(tiles), benchmark::Counter::kIsRate);
+}
+
+BENCHMARK(BM_TilemapSetMapData)->Arg(20)->Arg(128)->Arg(500);
+
+BENCHMARK_MAIN();
@@ -5,6 +5,7 @@
 #include <text.h>
 #include <pixel_format.h>
 #include <cache.h>
+#include <utils.h>
 
 static void BM_ReplacePlaceholders(benchmark::State& state) {
 	for (auto _: state) {
@@ -16,4 +17,92 @@ static void BM_ReplacePlaceholders(benchmark::State& state) {
 
 BENCHMARK(BM_ReplacePlaceholders);
 
+namespace {
+
+/** @return message sized text, Arg 0: ASCII, 1: Cyrillic and ASCII, 2: Japanese */
+std::string MakeText(int kind) {
+	const char* words[] = { "Alex takes 300 damage! ", u8"Алекс получает 300 урона! ", u8"アレックスは３００のダメージを受けた！" };
+	std::string text;
+	while (text.size() < 4096) {
+		text += words[kind];
+	}
+	return text;
+}
+
+}
+
+static void BM_DecodeUTF32(benchmark::State& state) {
+	const auto text = MakeText(state.range(0));
+
+	for (auto _: state) {
+		auto u32 = Utils::DecodeUTF32(text);
+		benchmark::DoNotOptimize(u32.data());
+	}
+
+	state.SetBytesProcessed(state.iterations() * text.size());
+}
+
+BENCHMARK(BM_DecodeUTF32)->Arg(0)->Arg(1)->Arg(2);
+
+static void BM_DecodeUTF32Buffer(benchmark::State& state) {
+	const auto text = MakeText(state.range(0));
+
+	std::u32string u32;
+	for (auto _: state) {
+		Utils::DecodeUTF32(text, u32);
+		benchmark::DoNotOptimize(u32.data());
+	}
+
+	state.SetBytesProcessed(state.iterations() * text.size());
+}
+
+BENCHMARK(BM_DecodeUTF32Buffer)->Arg(0)->Arg(1)->Arg(2);
+
+static void BM_UTF8Next(benchmark::State& state) {
+	const auto text = MakeText(state.range(0));
+	const auto* end = text.data() + text.size();
+
+	for (auto _: state) {
+		uint32_t sum = 0;
+		for (const auto* iter = text.data(); iter != end;) {
+			auto ret = Utils::UTF8Next(iter, end);
+			sum += ret.ch;
+			iter = ret.next;
+		}
+		benchmark::DoNotOptimize(sum);
+	}
+
+	state.SetBytesProcessed(state.iterations() * text.size());
+}
+
+BENCHMARK(BM_UTF8Next)->Arg(0)->Arg(1)->Arg(2);
+
+static void BM_UTF8SkipAscii(benchmark::State& state) {
+	const auto text = MakeText(0) + u8"ぽ";
+	const auto* end = text.data() + text.size();
+
+	for (auto _: state) {
+		benchmark::DoNotOptimize(Utils::UTF8SkipAscii(text.data(), end));
+	}
+
+	state.SetBytesProcessed(state.iterations() * text.size());
+}
+
+BENCHMARK(BM_UTF8SkipAscii);
+
+static void BM_CRC32(benchmark::State& state) {
+	std::vector<uint8_t> data(state.range(0));
+	for (size_t i = 0; i < data.size(); ++i) {
+		data[i] = static_cast<uint8_t>(i * 31);
+	}
+
+	for (auto _: state) {
+		benchmark::DoNotOptimize(Utils::CRC32(Span<const uint8_t>(data.data(), data.size())));
+	}
+
+	state.SetBytesProcessed(state.iterations() * data.size());
+}
+
+BENCHMARK(BM_CRC32)->Arg(4096)->Arg(4 << 20);
+
 BENCHMARK_MAIN();
@@ -124,4 +124,64 @@ static void BM_VariableSetRangeRandom(benchmark::State& state) {
 
 BENCHMARK(BM_VariableSetRangeRandom);
 
+static void BM_VariableAddRandom(benchmark::State& state) {
+	BM_VariableOp(state, [](auto& v, auto, auto) { v.AddRangeRandom(1, max_vars, -100, 100); });
+}
+
+BENCHMARK(BM_VariableAddRandom);
+
+// Ranges of the size some games clear or adjust every frame
+constexpr int large_range = 5000;
+
+template <typename F>
+static void BM_VariableLargeRangeOp(benchmark::State& state, F&& op) {
+	auto v = make(large_range);
+	for (auto _: state) {
+		op(v);
+	}
+	state.SetItemsProcessed(state.iterations() * large_range);
+}
+
+static void BM_VariableLargeSetRange(benchmark::State& state) {
+	BM_VariableLargeRangeOp(state, [](auto& v) { v.SetRange(1, large_range, 0); });
+}
+
+BENCHMARK(BM_VariableLargeSetRange);
+
+static void BM_VariableLargeAddRange(benchmark::State& state) {
+	BM_VariableLargeRangeOp(state, [](auto& v) { v.AddRange(1, large_range, 3); });
+}
+
+BENCHMARK(BM_VariableLargeAddRange);
+
+static void BM_VariableLargeSubRange(benchmark::State& state) {
+	BM_VariableLargeRangeOp(state, [](auto& v) { v.SubRange(1, large_range, 3); });
+}
+
+BENCHMARK(BM_VariableLargeSubRange);
+
+static void BM_VariableLargeMultRange(benchmark::State& state) {
+	BM_VariableLargeRangeOp(state, [](auto& v) { v.MultRange(1, large_range, -1); });
+}
+
+BENCHMARK(BM_VariableLargeMultRange);
+
+static void BM_VariableLargeDivRange(benchmark::State& state) {
+	BM_VariableLargeRangeOp(state, [](auto& v) { v.DivRange(1, large_range, 1); });
+}
+
+BENCHMARK(BM_VariableLargeDivRange);
+
+static void BM_VariableLargeAddRangeVariable(benchmark::State& state) {
+	BM_VariableLargeRangeOp(state, [](auto& v) { v.AddRangeVariable(1, large_range, large_range / 2); });
+}
+
+BENCHMARK(BM_VariableLargeAddRangeVariable);
+
+static void BM_VariableLargeSetRangeRandom(benchmark::State& state) {
+	BM_VariableLargeRangeOp(state, [](auto& v) { v.SetRangeRandom(1, large_range, -100, 100); });
+}
+
+BENCHMARK(BM_VariableLargeSetRangeRandom);
+
 BENCHMARK_MAIN();
@@ -0,0 +1,67 @@
+#.rst:
+# FindSpng
+# --------
+#
+# Find the libspng Library
+#
+# Imported Targets
+# ^^^^^^^^^^^^^^^^
+#
+# This module defines the following :prop_tgt:`IMPORTED` targets:
+#
+# ``Spng::Spng``
+#   The ``Spng`` library, if found.
+#
+# Result Variables
+# ^^^^^^^^^^^^^^^^
+#
+# This module will set the following variables in your project:
+#
+# ``Spng_INCLUDE_DIRS``
+#   where to find Spng headers.
+# ``Spng_LIBRARIES``
+#   the libraries to link against to use Spng.
+# ``Spng_FOUND``
+#   true if the Spng headers and libraries were found.
+
+find_package(PkgConfig QUIET)
+
+pkg_check_modules(PC_Spng QUIET spng)
+
+# Look for the header file.
+find_path(Spng_INCLUDE_DIR
+	NAMES spng.h
+	HINTS ${PC_Spng_INCLUDE_DIRS})
+
+# Look for the library.
+# Allow Spng_LIBRARY to be set manually, as the location of the Spng library
+if(NOT Spng_LIBRARY)
+	find_library(Spng_LIBRARY
+		NAMES spng spng_static
+		HINTS ${PC_Spng_LIBRARY_DIRS})
+endif()
+
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(Spng
+	REQUIRED_VARS Spng_LIBRARY Spng_INCLUDE_DIR)
+
+if(Spng_FOUND)
+	set(Spng_INCLUDE_DIRS ${Spng_INCLUDE_DIR})
+
+	if(NOT Spng_LIBRARIES)
+		set(Spng_LIBRARIES ${Spng_LIBRARIES})
+	endif()
+
+	if(NOT TARGET Spng::Spng)
+		add_library(Spng::Spng UNKNOWN IMPORTED)
+		set_target_properties(Spng::Spng PROPERTIES
+			INTERFACE_INCLUDE_DIRECTORIES "${Spng_INCLUDE_DIRS}"
+			IMPORTED_LOCATION "${Spng_LIBRARY}")
+		if(WIN32)
+			set_target_properties(Spng::Spng PROPERTIES
+				INTERFACE_COMPILE_DEFINITIONS "SPNG_STATIC=1")
+		endif()
+	endif()
+endif()
+
+mark_as_advanced(Spng_INCLUDE_DIR Spng_LIBRARY)
@@ -0,0 +1,105 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_ACCELERATED_RENDERER_H
+#define EP_ACCELERATED_RENDERER_H
+
+// Headers
+#include "opacity.h"
+#include "rect.h"
+
+class Bitmap;
+
+/**
+ * Interface of renderers which draw bitmaps with the GPU.
+ *
+ * Drawables which support it emit textured quads, all other drawables are
+ * drawn by the software compositor into a transparent layer. The layer is
+ * drawn by the renderer before the next quad, this keeps the z order.
+ */
+class AcceleratedRenderer {
+public:
+	/** Placement of a bitmap on the screen */
+	struct Quad {
+		/** Screen position of the origin */
+		int x = 0;
+		int y = 0;
+		/** Origin relative to the source rect */
+		int ox = 0;
+		int oy = 0;
+		double zoom_x = 1.0;
+		double zoom_y = 1.0;
+		/** Clockwise rotation in radians around the origin */
+		double angle = 0.0;
+		Opacity opacity;
+	};
+
+	virtual ~AcceleratedRenderer() = default;
+
+	/**
+	 * Starts a new frame and clears the screen.
+	 */
+	virtual void BeginFrame() = 0;
+
+	/**
+	 * Draws the pending layer. The frame is shown by the next UpdateDisplay call.
+	 */
+	virtual void EndFrame() = 0;
+
+	/**
+	 * @return the area of the screen
+	 */
+	virtual Rect GetScreenRect() const = 0;
+
+	/**
+	 * Returns the software layer for drawables which can't be drawn with quads.
+	 * The layer is transparent and drawn before the next quad.
+	 *
+	 * @return layer to draw into
+	 */
+	virtual Bitmap& GetLayer() = 0;
+
+	/**
+	 * @param bitmap bitmap to draw
+	 * @return whether the bitmap can be drawn with DrawBitmap and DrawTiled
+	 */
+	virtual bool CanDraw(const Bitmap& bitmap) const = 0;
+
+	/**
+	 * Draws a part of a bitmap as a textured quad.
+	 *
+	 * @param bitmap source bitmap
+	 * @param src_rect part of the bitmap to draw
+	 * @param quad placement on the screen
+	 */
+	virtual void DrawBitmap(const Bitmap& bitmap, const Rect& src_rect, const Quad& quad) = 0;
+
+	/**
+	 * Fills a screen area by repeating a part of a bitmap.
+	 *
+	 * @param bitmap source bitmap
+	 * @param src_rect part of the bitmap to repeat
+	 * @param ox horizontal offset of the pattern
+	 * @param oy vertical offset of the pattern
+	 * @param dst_rect screen area to fill
+	 * @param opacity opacity of the bitmap
+	 * @see Bitmap::TiledBlit
+	 */
+	virtual void DrawTiled(const Bitmap& bitmap, const Rect& src_rect, int ox, int oy, const Rect& dst_rect, int opacity) = 0;
+};
+
+#endif
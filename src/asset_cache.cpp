@@ -0,0 +1,699 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+// Headers
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <sstream>
+#include <vector>
+#include <lcf/data.h>
+#include <lcf/ldb/reader.h>
+#include <lcf/lmt/reader.h>
+#include "asset_cache.h"
+#include "bitmap.h"
+#include "filefinder.h"
+#include "output.h"
+#include "platform.h"
+#include "utils.h"
+
+namespace {
+	std::string cache_directory;
+
+	constexpr char magic[4] = { 'E', 'P', 'A', 'C' };
+	constexpr uint32_t version = 2;
+	/** Alignment of the pixels in a cache file */
+	constexpr size_t pixel_alignment = 64;
+	/** Images with more pixel bytes are mapped instead of read */
+	constexpr size_t min_mapped_size = 64 * 1024;
+	/** Largest width and height accepted from a cache file */
+	constexpr uint32_t max_image_size = std::numeric_limits<int16_t>::max();
+
+	/** Layout of a cache file, followed by the path, padding and the pixels */
+	struct Header {
+		char magic[4];
+		uint32_t version;
+		int64_t file_time;
+		int64_t file_size;
+		uint32_t width;
+		uint32_t height;
+		uint32_t pitch;
+		uint32_t bits;
+		uint32_t masks[4];
+		uint32_t transparent;
+		uint32_t path_size;
+	};
+
+	constexpr char tree_magic[4] = { 'E', 'P', 'D', 'T' };
+	constexpr uint32_t tree_version = 1;
+	/** Longest string read from a tree file, protects against corrupted sizes */
+	constexpr uint32_t max_tree_string = 4096;
+
+	constexpr char database_magic[4] = { 'E', 'P', 'D', 'B' };
+	constexpr uint32_t database_version = 1;
+	/** Codepage of the strings in a database snapshot, UTF-8 */
+	constexpr char snapshot_encoding[] = "65001";
+
+	constexpr char scan_magic[4] = { 'E', 'P', 'G', 'S' };
+	constexpr uint32_t scan_version = 1;
+
+	constexpr char translation_magic[4] = { 'E', 'P', 'T', 'C' };
+	constexpr uint32_t translation_version = 1;
+
+	/** Identifies the file a snapshot was made from */
+	struct SourceInfo {
+		int64_t file_time;
+		int64_t file_size;
+		uint32_t crc;
+		uint32_t padding;
+	};
+
+	/** Layout of a database snapshot, followed by encoding, database and map tree */
+	struct DatabaseHeader {
+		char magic[4];
+		uint32_t version;
+		SourceInfo ldb;
+		SourceInfo lmt;
+		uint32_t encoding_size;
+		uint32_t database_size;
+		uint32_t treemap_size;
+		uint32_t padding;
+	};
+
+	bool GetSourceInfo(const std::string& path, SourceInfo& info) {
+		Platform::File file(path);
+		info = {};
+		info.file_time = file.GetModificationTime();
+		info.file_size = file.GetSize();
+		if (info.file_time < 0 || info.file_size < 0) {
+			return false;
+		}
+
+		auto is = FileFinder::OpenInputStream(path);
+		if (!is) {
+			return false;
+		}
+		info.crc = Utils::CRC32(is);
+		return true;
+	}
+
+	bool SameSource(const SourceInfo& l, const SourceInfo& r) {
+		return l.file_time == r.file_time && l.file_size == r.file_size && l.crc == r.crc;
+	}
+
+	/** Layout of a translation cache file, followed by the catalog */
+	struct TranslationHeader {
+		char magic[4];
+		uint32_t version;
+		SourceInfo po;
+	};
+
+	/** Stream over a part of the snapshot */
+	class MemoryStreamBuf : public Filesystem_Stream::SpanStreamBuf {
+	public:
+		MemoryStreamBuf(const uint8_t* data, size_t size) {
+			SetData(reinterpret_cast<const char*>(data), size);
+		}
+	};
+
+	std::string CacheFileName(const std::string& path, char kind, const char* ext) {
+		// FNV-1a
+		uint64_t hash = 14695981039346656037ULL;
+		for (char c: path) {
+			hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ULL;
+		}
+		hash = (hash ^ static_cast<unsigned char>(kind)) * 1099511628211ULL;
+
+		char name[24];
+		snprintf(name, sizeof(name), "%016llx.%s", static_cast<unsigned long long>(hash), ext);
+		return FileFinder::MakePath(cache_directory, name);
+	}
+
+	std::string CacheFileName(const std::string& path, bool transparent) {
+		return CacheFileName(path, transparent ? 'T' : ' ', "epac");
+	}
+
+	void WriteU32(std::ostream& os, uint32_t value) {
+		os.write(reinterpret_cast<const char*>(&value), sizeof(value));
+	}
+
+	bool ReadU32(std::istream& is, uint32_t& value) {
+		return static_cast<bool>(is.read(reinterpret_cast<char*>(&value), sizeof(value)));
+	}
+
+	void WriteString(std::ostream& os, const std::string& s) {
+		WriteU32(os, s.size());
+		os.write(s.data(), s.size());
+	}
+
+	bool ReadString(std::istream& is, std::string& s) {
+		uint32_t size;
+		if (!ReadU32(is, size) || size > max_tree_string) {
+			return false;
+		}
+		s.resize(size);
+		return size == 0 || is.read(&s[0], size);
+	}
+
+	void WriteMap(std::ostream& os, const FileFinder::string_map& map) {
+		WriteU32(os, map.size());
+		for (const auto& entry: map) {
+			WriteString(os, entry.first);
+			WriteString(os, entry.second);
+		}
+	}
+
+	bool ReadMap(std::istream& is, FileFinder::string_map& map) {
+		uint32_t count;
+		if (!ReadU32(is, count)) {
+			return false;
+		}
+		std::string key, value;
+		for (uint32_t i = 0; i < count; ++i) {
+			if (!ReadString(is, key) || !ReadString(is, value)) {
+				return false;
+			}
+			map[key] = value;
+		}
+		return true;
+	}
+
+	/**
+	 * Directories whose modification time validates the tree, relative to it.
+	 * Nested directories are taken from the paths of the files in them.
+	 */
+	std::vector<std::string> TreeDirectories(const FileFinder::DirectoryTree& tree) {
+		std::vector<std::string> dirs;
+		for (const auto& dir: tree.directories) {
+			dirs.push_back(dir.second);
+			auto it = tree.sub_members.find(dir.first);
+			if (it == tree.sub_members.end()) {
+				continue;
+			}
+			for (const auto& file: it->second) {
+				const auto pos = file.second.find_last_of('/');
+				if (pos != std::string::npos) {
+					dirs.push_back(FileFinder::MakePath(dir.second, file.second.substr(0, pos)));
+				}
+			}
+		}
+		std::sort(dirs.begin(), dirs.end());
+		dirs.erase(std::unique(dirs.begin(), dirs.end()), dirs.end());
+		return dirs;
+	}
+
+	bool Matches(const Header& l, const Header& r) {
+		return std::memcmp(l.magic, r.magic, sizeof(l.magic)) == 0
+			&& l.version == r.version
+			&& l.file_time == r.file_time
+			&& l.file_size == r.file_size
+			&& l.width == r.width
+			&& l.height == r.height
+			&& l.pitch == r.pitch
+			&& l.bits == r.bits
+			&& std::memcmp(l.masks, r.masks, sizeof(l.masks)) == 0
+			&& l.transparent == r.transparent
+			&& l.path_size == r.path_size;
+	}
+
+	Header MakeHeader(const std::string& path, bool transparent, int width, int height, int pitch) {
+		const auto& format = transparent ? Bitmap::pixel_format : Bitmap::opaque_pixel_format;
+		Platform::File file(path);
+
+		Header header = {};
+		std::memcpy(header.magic, magic, sizeof(magic));
+		header.version = version;
+		header.file_time = file.GetModificationTime();
+		header.file_size = file.GetSize();
+		header.width = width;
+		header.height = height;
+		header.pitch = pitch;
+		header.bits = format.bits;
+		header.masks[0] = format.r.mask;
+		header.masks[1] = format.g.mask;
+		header.masks[2] = format.b.mask;
+		header.masks[3] = format.a.mask;
+		header.transparent = transparent;
+		header.path_size = path.size();
+		return header;
+	}
+
+	/** @return offset of the pixels in a cache file */
+	size_t PixelOffset(const Header& header) {
+		const size_t end = sizeof(Header) + header.path_size;
+		return (end + pixel_alignment - 1) / pixel_alignment * pixel_alignment;
+	}
+
+	/**
+	 * Checks the size of the bitmap read from a cache file, a corrupted or
+	 * truncated file is a miss.
+	 *
+	 * @param header header of the cache file
+	 * @param file_size size of the cache file
+	 * @return whether the file holds a bitmap of that size
+	 */
+	bool ValidSize(const Header& header, int64_t file_size) {
+		if (header.width == 0 || header.height == 0 || header.width > max_image_size || header.height > max_image_size) {
+			return false;
+		}
+		if (header.pitch % 4 != 0 || header.pitch < header.width * (header.bits / 8)) {
+			return false;
+		}
+		const uint64_t end = PixelOffset(header) + static_cast<uint64_t>(header.pitch) * header.height;
+		return file_size >= 0 && end <= static_cast<uint64_t>(file_size);
+	}
+
+	/**
+	 * Maps a cache file copy on write. The pixels stay shared with all
+	 * processes running the same game with the same cache directory, e.g.
+	 * several sessions on a streaming server, until the image is drawn on.
+	 */
+	BitmapRef LoadMapped(const std::string& cache_file, const std::string& path, bool transparent, const Header& header) {
+		auto mapping = std::make_shared<Platform::FileMapping>(cache_file, true);
+		if (!*mapping) {
+			return nullptr;
+		}
+
+		const size_t offset = PixelOffset(header);
+		if (!ValidSize(header, static_cast<int64_t>(mapping->GetSize()))
+				|| std::memcmp(mapping->GetData(), &header, sizeof(header)) != 0
+				|| std::memcmp(mapping->GetData() + sizeof(header), path.data(), path.size()) != 0) {
+			return nullptr;
+		}
+
+		return Bitmap::Create(mapping, mapping->GetWritableData() + offset, header.width, header.height, header.pitch, transparent);
+	}
+}
+
+void AssetCache::SetDirectory(std::string path) {
+	cache_directory = std::move(path);
+}
+
+bool AssetCache::IsEnabled() {
+	return !cache_directory.empty();
+}
+
+BitmapRef AssetCache::Load(const std::string& path, bool transparent, uint32_t flags) {
+	if (!IsEnabled()) {
+		return nullptr;
+	}
+
+	// The cache stores 32 bit pixels, decoding keeps the indices
+	if ((flags & Bitmap::Flag_Paletted) && Bitmap::GetPalettedStorage()) {
+		return nullptr;
+	}
+
+	const std::string cache_file = CacheFileName(path, transparent);
+	auto is = FileFinder::OpenInputStream(cache_file, std::ios::ios_base::binary | std::ios::ios_base::in);
+	if (!is) {
+		return nullptr;
+	}
+
+	Header header;
+	if (!is.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+		return nullptr;
+	}
+
+	// Size of the bitmap is taken from the file, the rest must match
+	Header expected = MakeHeader(path, transparent, header.width, header.height, header.pitch);
+	if (expected.file_time < 0 || expected.file_size < 0 || !Matches(header, expected)) {
+		return nullptr;
+	}
+	if (!ValidSize(header, Platform::File(cache_file).GetSize())) {
+		return nullptr;
+	}
+
+	BitmapRef bitmap;
+	if (static_cast<size_t>(header.pitch) * header.height >= min_mapped_size) {
+		bitmap = LoadMapped(cache_file, path, transparent, header);
+		if (bitmap) {
+			bitmap->CheckPixels(flags);
+			return bitmap;
+		}
+	}
+
+	std::string cached_path(header.path_size, '\0');
+	if (!is.read(&cached_path[0], cached_path.size()) || cached_path != path) {
+		return nullptr;
+	}
+
+	bitmap = Bitmap::Create(header.width, header.height, transparent);
+	if (bitmap->pitch() != static_cast<int>(header.pitch)) {
+		return nullptr;
+	}
+
+	// Read directly into the pixel buffer, no conversion needed
+	if (!is.seekg(PixelOffset(header)) || !is.read(static_cast<char*>(bitmap->pixels()), static_cast<std::streamsize>(header.pitch) * header.height)) {
+		return nullptr;
+	}
+
+	bitmap->CheckPixels(flags);
+	return bitmap;
+}
+
+void AssetCache::Store(const std::string& path, bool transparent, const Bitmap& bitmap) {
+	if (!IsEnabled() || bitmap.IsPaletted()) {
+		return;
+	}
+
+	Header header = MakeHeader(path, transparent, bitmap.width(), bitmap.height(), bitmap.pitch());
+	if (header.file_time < 0 || header.file_size < 0) {
+		return;
+	}
+
+	// Written next to the cache file and renamed, other processes can have the old one mapped
+	const std::string cache_file = CacheFileName(path, transparent);
+	const std::string temp_file = cache_file + ".tmp";
+	{
+		auto os = FileFinder::OpenOutputStream(temp_file, std::ios::ios_base::binary | std::ios::ios_base::out | std::ios::ios_base::trunc);
+		if (!os) {
+			Output::Debug("AssetCache: Couldn't write {}", cache_file);
+			return;
+		}
+
+		os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		os.write(path.data(), path.size());
+		const size_t padding = PixelOffset(header) - sizeof(header) - path.size();
+		os.write(std::string(padding, '\0').data(), padding);
+		os.write(static_cast<const char*>(bitmap.pixels()), static_cast<std::streamsize>(header.pitch) * header.height);
+	}
+
+	if (std::rename(temp_file.c_str(), cache_file.c_str()) != 0) {
+		std::remove(cache_file.c_str());
+		if (std::rename(temp_file.c_str(), cache_file.c_str()) != 0) {
+			Output::Debug("AssetCache: Couldn't write {}", cache_file);
+			std::remove(temp_file.c_str());
+		}
+	}
+}
+
+bool AssetCache::LoadDirectoryTree(FileFinder::DirectoryTree& tree) {
+	if (!IsEnabled()) {
+		return false;
+	}
+
+	auto is = FileFinder::OpenInputStream(CacheFileName(tree.directory_path, 'D', "epdt"), std::ios::ios_base::binary | std::ios::ios_base::in);
+	if (!is) {
+		return false;
+	}
+
+	char file_magic[4];
+	uint32_t file_version;
+	std::string path;
+	if (!is.read(file_magic, sizeof(file_magic)) || std::memcmp(file_magic, tree_magic, sizeof(tree_magic)) != 0
+			|| !ReadU32(is, file_version) || file_version != tree_version
+			|| !ReadString(is, path) || path != tree.directory_path) {
+		return false;
+	}
+
+	// Every listed directory must be unchanged
+	uint32_t count;
+	if (!ReadU32(is, count)) {
+		return false;
+	}
+	std::string dir;
+	for (uint32_t i = 0; i < count; ++i) {
+		int64_t time;
+		if (!ReadString(is, dir) || !is.read(reinterpret_cast<char*>(&time), sizeof(time))) {
+			return false;
+		}
+		const std::string dir_path = dir.empty() ? tree.directory_path : FileFinder::MakePath(tree.directory_path, dir);
+		if (Platform::File(dir_path).GetModificationTime() != time) {
+			return false;
+		}
+	}
+
+	if (!ReadMap(is, tree.files) || !ReadMap(is, tree.directories) || !ReadU32(is, count)) {
+		return false;
+	}
+	for (uint32_t i = 0; i < count; ++i) {
+		if (!ReadString(is, dir) || !ReadMap(is, tree.sub_members[dir])) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void AssetCache::StoreDirectoryTree(const FileFinder::DirectoryTree& tree) {
+	if (!IsEnabled()) {
+		return;
+	}
+
+	std::vector<std::pair<std::string, int64_t>> dirs;
+	dirs.emplace_back("", Platform::File(tree.directory_path).GetModificationTime());
+	for (auto& dir: TreeDirectories(tree)) {
+		const int64_t time = Platform::File(FileFinder::MakePath(tree.directory_path, dir)).GetModificationTime();
+		dirs.emplace_back(std::move(dir), time);
+	}
+	for (const auto& dir: dirs) {
+		if (dir.second < 0) {
+			// Without a modification time the tree can not be validated
+			return;
+		}
+	}
+
+	const std::string cache_file = CacheFileName(tree.directory_path, 'D', "epdt");
+	auto os = FileFinder::OpenOutputStream(cache_file, std::ios::ios_base::binary | std::ios::ios_base::out | std::ios::ios_base::trunc);
+	if (!os) {
+		Output::Debug("AssetCache: Couldn't write {}", cache_file);
+		return;
+	}
+
+	os.write(tree_magic, sizeof(tree_magic));
+	WriteU32(os, tree_version);
+	WriteString(os, tree.directory_path);
+
+	WriteU32(os, dirs.size());
+	for (const auto& dir: dirs) {
+		WriteString(os, dir.first);
+		os.write(reinterpret_cast<const char*>(&dir.second), sizeof(dir.second));
+	}
+
+	WriteMap(os, tree.files);
+	WriteMap(os, tree.directories);
+	WriteU32(os, tree.sub_members.size());
+	for (const auto& members: tree.sub_members) {
+		WriteString(os, members.first);
+		WriteMap(os, members.second);
+	}
+}
+
+bool AssetCache::LoadDatabase(const std::string& ldb, const std::string& lmt, StringView encoding) {
+	if (!IsEnabled()) {
+		return false;
+	}
+
+	auto is = FileFinder::OpenInputStream(CacheFileName(ldb, 'B', "epdb"), std::ios::ios_base::binary | std::ios::ios_base::in);
+	if (!is) {
+		return false;
+	}
+
+	// Parsed in place when the file is mapped, otherwise read at once
+	std::vector<uint8_t> buffer;
+	auto span = is.GetSpan();
+	const uint8_t* data = span.data();
+	size_t size = span.size();
+	if (span.empty()) {
+		buffer = Utils::ReadStream(is);
+		data = buffer.data();
+		size = buffer.size();
+	}
+
+	DatabaseHeader header;
+	if (size < sizeof(header)) {
+		return false;
+	}
+	std::memcpy(&header, data, sizeof(header));
+	if (std::memcmp(header.magic, database_magic, sizeof(database_magic)) != 0 || header.version != database_version ||
+			sizeof(header) + static_cast<uint64_t>(header.encoding_size) + header.database_size + header.treemap_size != size) {
+		return false;
+	}
+
+	const uint8_t* encoding_data = data + sizeof(header);
+	const uint8_t* database_data = encoding_data + header.encoding_size;
+	const uint8_t* treemap_data = database_data + header.database_size;
+	if (StringView(reinterpret_cast<const char*>(encoding_data), header.encoding_size) != encoding) {
+		return false;
+	}
+
+	SourceInfo ldb_info, lmt_info;
+	if (!GetSourceInfo(ldb, ldb_info) || !GetSourceInfo(lmt, lmt_info) ||
+			!SameSource(ldb_info, header.ldb) || !SameSource(lmt_info, header.lmt)) {
+		return false;
+	}
+
+	Filesystem_Stream::InputStream database_stream(new MemoryStreamBuf(database_data, header.database_size));
+	auto db = lcf::LDB_Reader::Load(database_stream, snapshot_encoding);
+	Filesystem_Stream::InputStream treemap_stream(new MemoryStreamBuf(treemap_data, header.treemap_size));
+	auto treemap = lcf::LMT_Reader::Load(treemap_stream, snapshot_encoding);
+	if (!db || !treemap) {
+		Output::Debug("AssetCache: Invalid database snapshot of {}", ldb);
+		return false;
+	}
+
+	lcf::Data::data = std::move(*db);
+	lcf::Data::treemap = std::move(*treemap);
+	Output::Debug("AssetCache: Loaded database snapshot of {}", ldb);
+	return true;
+}
+
+void AssetCache::StoreDatabase(const std::string& ldb, const std::string& lmt, StringView encoding) {
+	if (!IsEnabled()) {
+		return;
+	}
+
+	DatabaseHeader header = {};
+	if (!GetSourceInfo(ldb, header.ldb) || !GetSourceInfo(lmt, header.lmt)) {
+		return;
+	}
+
+	// The map tree is written with the fields of both engines, unset ones are not read
+	std::ostringstream database_data, treemap_data;
+	if (!lcf::LDB_Reader::Save(database_data, lcf::Data::data, snapshot_encoding) ||
+			!lcf::LMT_Reader::Save(treemap_data, lcf::Data::treemap, lcf::EngineVersion::e2k3, snapshot_encoding)) {
+		return;
+	}
+	const std::string database = database_data.str();
+	const std::string treemap = treemap_data.str();
+
+	std::memcpy(header.magic, database_magic, sizeof(database_magic));
+	header.version = database_version;
+	header.encoding_size = encoding.size();
+	header.database_size = database.size();
+	header.treemap_size = treemap.size();
+
+	const std::string cache_file = CacheFileName(ldb, 'B', "epdb");
+	auto os = FileFinder::OpenOutputStream(cache_file, std::ios::ios_base::binary | std::ios::ios_base::out | std::ios::ios_base::trunc);
+	if (!os) {
+		Output::Debug("AssetCache: Couldn't write {}", cache_file);
+		return;
+	}
+
+	os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	os.write(encoding.data(), encoding.size());
+	os.write(database.data(), database.size());
+	os.write(treemap.data(), treemap.size());
+}
+
+bool AssetCache::LoadGameScan(const std::string& path, std::vector<GameScanEntry>& entries) {
+	if (!IsEnabled()) {
+		return false;
+	}
+
+	auto is = FileFinder::OpenInputStream(CacheFileName(path, 'G', "epgs"), std::ios::ios_base::binary | std::ios::ios_base::in);
+	if (!is) {
+		return false;
+	}
+
+	char file_magic[4];
+	uint32_t file_version;
+	std::string file_path;
+	uint32_t count;
+	if (!is.read(file_magic, sizeof(file_magic)) || std::memcmp(file_magic, scan_magic, sizeof(scan_magic)) != 0
+			|| !ReadU32(is, file_version) || file_version != scan_version
+			|| !ReadString(is, file_path) || file_path != path
+			|| !ReadU32(is, count)) {
+		return false;
+	}
+
+	entries.clear();
+	for (uint32_t i = 0; i < count; ++i) {
+		GameScanEntry entry;
+		uint32_t valid;
+		if (!ReadString(is, entry.directory) || !is.read(reinterpret_cast<char*>(&entry.time), sizeof(entry.time))
+				|| !ReadU32(is, valid)) {
+			entries.clear();
+			return false;
+		}
+		entry.valid = valid != 0;
+		entries.push_back(std::move(entry));
+	}
+	return true;
+}
+
+void AssetCache::StoreGameScan(const std::string& path, const std::vector<GameScanEntry>& entries) {
+	if (!IsEnabled()) {
+		return;
+	}
+
+	const std::string cache_file = CacheFileName(path, 'G', "epgs");
+	auto os = FileFinder::OpenOutputStream(cache_file, std::ios::ios_base::binary | std::ios::ios_base::out | std::ios::ios_base::trunc);
+	if (!os) {
+		Output::Debug("AssetCache: Couldn't write {}", cache_file);
+		return;
+	}
+
+	os.write(scan_magic, sizeof(scan_magic));
+	WriteU32(os, scan_version);
+	WriteString(os, path);
+	WriteU32(os, entries.size());
+	for (const auto& entry: entries) {
+		WriteString(os, entry.directory);
+		os.write(reinterpret_cast<const char*>(&entry.time), sizeof(entry.time));
+		WriteU32(os, entry.valid ? 1 : 0);
+	}
+}
+
+bool AssetCache::LoadTranslation(const std::string& path, std::vector<uint8_t>& catalog) {
+	if (!IsEnabled()) {
+		return false;
+	}
+
+	auto is = FileFinder::OpenInputStream(CacheFileName(path, 'P', "eptc"), std::ios::ios_base::binary | std::ios::ios_base::in);
+	if (!is) {
+		return false;
+	}
+
+	TranslationHeader header;
+	if (!is.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+			std::memcmp(header.magic, translation_magic, sizeof(translation_magic)) != 0 || header.version != translation_version) {
+		return false;
+	}
+
+	SourceInfo info;
+	if (!GetSourceInfo(path, info) || !SameSource(info, header.po)) {
+		return false;
+	}
+
+	catalog = Utils::ReadStream(is);
+	return true;
+}
+
+void AssetCache::StoreTranslation(const std::string& path, const std::vector<uint8_t>& catalog) {
+	if (!IsEnabled() || catalog.empty()) {
+		return;
+	}
+
+	TranslationHeader header = {};
+	if (!GetSourceInfo(path, header.po)) {
+		return;
+	}
+	std::memcpy(header.magic, translation_magic, sizeof(translation_magic));
+	header.version = translation_version;
+
+	const std::string cache_file = CacheFileName(path, 'P', "eptc");
+	auto os = FileFinder::OpenOutputStream(cache_file, std::ios::ios_base::binary | std::ios::ios_base::out | std::ios::ios_base::trunc);
+	if (!os) {
+		Output::Debug("AssetCache: Couldn't write {}", cache_file);
+		return;
+	}
+
+	os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	os.write(reinterpret_cast<const char*>(catalog.data()), catalog.size());
+}
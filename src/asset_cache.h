@@ -0,0 +1,166 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef EP_ASSET_CACHE_H
+#define EP_ASSET_CACHE_H
+
+// Headers
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "memory_management.h"
+#include "string_view.h"
+
+namespace FileFinder {
+	struct DirectoryTree;
+}
+
+/**
+ * Optional cache of decoded images on disk.
+ *
+ * Images are stored already converted to the screen format. Loading them
+ * skips decoding and the format conversion, which is slow on platforms
+ * with slow CPUs and SD cards. A cached image is only used when the path,
+ * modification time and size of the image file and the screen format
+ * match.
+ *
+ * The listings of recursive directory trees are cached as well, they are
+ * used until the modification time of a listed directory changes.
+ *
+ * The loaded database and map tree are kept as a snapshot with UTF-8 strings,
+ * loading it skips the conversion of all strings from the game encoding.
+ *
+ * The game browser keeps which of its subdirectories are games, a directory
+ * is only scanned again when its modification time changes.
+ *
+ * Translation files are kept as compiled catalogs, loading them skips
+ * parsing the .po file.
+ */
+namespace AssetCache {
+	/** Scan result of a subdirectory of the game browser */
+	struct GameScanEntry {
+		/** name of the subdirectory */
+		std::string directory;
+		/** modification time of the subdirectory */
+		int64_t time;
+		/** whether the subdirectory contains a game */
+		bool valid;
+	};
+
+	/**
+	 * Enables the cache.
+	 *
+	 * @param path existing directory for the cache files, empty disables the cache
+	 */
+	void SetDirectory(std::string path);
+
+	/** @return whether a cache directory is set */
+	bool IsEnabled();
+
+	/**
+	 * Loads a cached image.
+	 *
+	 * @param path path of the image file
+	 * @param transparent whether the image was loaded with transparency
+	 * @param flags Bitmap::Flags the image was loaded with
+	 * @return image or nullptr when not cached or outdated
+	 */
+	BitmapRef Load(const std::string& path, bool transparent, uint32_t flags);
+
+	/**
+	 * Stores a decoded image.
+	 *
+	 * @param path path of the image file
+	 * @param transparent whether the image was loaded with transparency
+	 * @param bitmap the decoded image
+	 */
+	void Store(const std::string& path, bool transparent, const Bitmap& bitmap);
+
+	/**
+	 * Loads the cached listing of a directory tree.
+	 *
+	 * @param tree tree with directory_path set, receives the listing
+	 * @return false when not cached or a directory changed since it was stored
+	 */
+	bool LoadDirectoryTree(FileFinder::DirectoryTree& tree);
+
+	/**
+	 * Stores the listing of a completely listed directory tree.
+	 *
+	 * @param tree the tree, sub_members must contain all directories
+	 */
+	void StoreDirectoryTree(const FileFinder::DirectoryTree& tree);
+
+	/**
+	 * Loads the database snapshot into lcf::Data.
+	 * The snapshot is used when modification time, size and CRC32 of both
+	 * files and the encoding match.
+	 *
+	 * @param ldb path of the database file
+	 * @param lmt path of the map tree file
+	 * @param encoding encoding the files are read with
+	 * @return false when not cached or outdated, lcf::Data is unchanged then
+	 */
+	bool LoadDatabase(const std::string& ldb, const std::string& lmt, StringView encoding);
+
+	/**
+	 * Stores lcf::Data as database snapshot.
+	 *
+	 * @param ldb path of the database file it was loaded from
+	 * @param lmt path of the map tree file it was loaded from
+	 * @param encoding encoding the files were read with
+	 */
+	void StoreDatabase(const std::string& ldb, const std::string& lmt, StringView encoding);
+
+	/**
+	 * Loads the scan results of the game browser.
+	 *
+	 * @param path directory shown in the game browser
+	 * @param entries receives the results of the subdirectories as stored
+	 * @return false when not cached
+	 */
+	bool LoadGameScan(const std::string& path, std::vector<GameScanEntry>& entries);
+
+	/**
+	 * Stores the scan results of the game browser.
+	 *
+	 * @param path directory shown in the game browser
+	 * @param entries results of the subdirectories
+	 */
+	void StoreGameScan(const std::string& path, const std::vector<GameScanEntry>& entries);
+
+	/**
+	 * Loads the compiled catalog of a translation file.
+	 * The catalog is used when modification time, size and CRC32 of the file match.
+	 *
+	 * @param path path of the .po file
+	 * @param catalog receives the catalog
+	 * @return false when not cached or outdated
+	 */
+	bool LoadTranslation(const std::string& path, std::vector<uint8_t>& catalog);
+
+	/**
+	 * Stores the compiled catalog of a translation file.
+	 *
+	 * @param path path of the .po file
+	 * @param catalog the catalog, see Dictionary::GetCatalog
+	 */
+	void StoreTranslation(const std::string& path, const std::vector<uint8_t>& catalog);
+}
+
+#endif
@@ -15,6 +15,8 @@
  * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
+#include <chrono>
 #include <cstdlib>
 #include <fstream>
 #include <map>
@@ -36,6 +38,8 @@
 #include "utils.h"
 #include "transition.h"
 #include "rand.h"
+#include "request_index.h"
+#include "job_system.h"
 
 // When this option is enabled async requests are randomly delayed.
 // This allows testing some aspects of async file fetching locally.
@@ -44,9 +48,41 @@
 namespace {
 	std::unordered_map<std::string, FileRequestAsync> async_requests;
 	std::unordered_map<std::string, std::string> file_mapping;
+	/** Requests waiting for Cache::DecodeAsync */
+	std::vector<FileRequestAsync*> decoding_requests;
 	int next_id = 0;
 #ifdef EMSCRIPTEN
 	int index_version = 1;
+	/** Used instead of file_mapping when index.bin was loaded */
+	RequestIndex request_index;
+
+	/** Downloads running at once, browsers limit connections per host to about six */
+	constexpr int max_concurrent_downloads = 6;
+	int active_downloads = 0;
+	/** Started requests waiting for a free download slot */
+	std::vector<FileRequestAsync*> queued_requests;
+	/** Browser cache of the downloaded files, empty until the index was loaded */
+	std::string asset_cache_name;
+
+	void ProcessQueue() {
+		while (!queued_requests.empty()) {
+			// The first of the highest priority, keeps the start order within a priority
+			auto it = std::min_element(queued_requests.begin(), queued_requests.end(),
+				[](const FileRequestAsync* l, const FileRequestAsync* r) {
+					return l->GetPriority() < r->GetPriority();
+				});
+
+			if (active_downloads >= max_concurrent_downloads
+					&& (*it)->GetPriority() != FileRequestAsync::Priority_Blocking) {
+				return;
+			}
+
+			auto* request = *it;
+			queued_requests.erase(it);
+			++active_downloads;
+			request->StartDownload();
+		}
+	}
 #endif
 
 	FileRequestAsync* GetRequest(const std::string& path) {
@@ -69,6 +105,46 @@ namespace {
 		return std::make_shared<int>(next_id++);
 	}
 
+#ifndef EMSCRIPTEN
+	/**
+	 * Reads a music or sound file on a worker. The decoder opening it later
+	 * is served from the file cache of the OS then.
+	 *
+	 * @return whether the JobSystem finishes the request
+	 */
+	bool ReadAsync(const FileRequestAsync& request, const std::string& directory, const std::string& file) {
+		if (JobSystem::GetThreadCount() == 0) {
+			return false;
+		}
+
+		std::string path;
+		if (directory == "Music") {
+			path = FileFinder::FindMusic(file);
+		} else if (directory == "Sound") {
+			path = FileFinder::FindSound(file);
+		}
+		if (path.empty() || FileFinder::IsInArchive(path)) {
+			// Reported by the synchronous load
+			return false;
+		}
+
+		JobSystem::Submit([path]() {
+			auto stream = FileFinder::OpenNativeInputStream(path);
+			if (!stream) {
+				return;
+			}
+			std::vector<char> buffer(64 * 1024);
+			while (stream.read(buffer.data(), buffer.size())) {
+			}
+		}, [key = request.GetPath()]() {
+			if (auto* request = GetRequest(key)) {
+				request->DownloadDone(true);
+			}
+		});
+		return true;
+	}
+#endif
+
 #ifdef EMSCRIPTEN
 	void download_success(unsigned, void* userData, const char*) {
 		FileRequestAsync* req = static_cast<FileRequestAsync*>(userData);
@@ -84,11 +160,122 @@ namespace {
 #endif
 }
 
-void AsyncHandler::CreateRequestMapping(const std::string& file) {
+#ifdef EMSCRIPTEN
+extern "C" EMSCRIPTEN_KEEPALIVE void async_handler_cache_fetch_done(void* request, int success) {
+	if (success) {
+		download_success(0, request, nullptr);
+	} else {
+		download_failure(0, request, 0);
+	}
+}
+
+/**
+ * Serves a file from the Cache API store when it was downloaded before and
+ * revalidates it in the background, otherwise downloads and stores it.
+ * The file is written to the file system like emscripten_async_wget2 does.
+ *
+ * @return 0 when the browser has no Cache API, nothing was started then
+ */
+EM_JS(int, async_handler_cache_fetch, (const char* url_ptr, const char* file_ptr, const char* cache_ptr, void* request), {
+	if (typeof caches === 'undefined') {
+		return 0;
+	}
+
+	const url = UTF8ToString(url_ptr);
+	const file = UTF8ToString(file_ptr);
+	const cacheName = UTF8ToString(cache_ptr);
+
+	let finished = false;
+	const done = (data) => {
+		if (finished) {
+			return;
+		}
+		finished = true;
+		if (data) {
+			const dir = file.substring(0, file.lastIndexOf('/'));
+			if (dir) {
+				try { FS.mkdirTree(dir); } catch (e) {}
+			}
+			FS.writeFile(file, data);
+		}
+		_async_handler_cache_fetch_done(request, data ? 1 : 0);
+	};
+
+	const download = (cache, options) => fetch(url, options).then((response) => {
+		if (!response.ok) {
+			throw new Error(response.status);
+		}
+		if (cache) {
+			cache.put(url, response.clone()).catch(() => {});
+		}
+		return response.arrayBuffer();
+	});
+
+	caches.open(cacheName).then((cache) => cache.match(url).then((hit) => {
+		if (!hit) {
+			return download(cache).then((buf) => done(new Uint8Array(buf)));
+		}
+		// Revalidated with the server, the next session gets the new file
+		download(cache, { cache: 'no-cache' }).catch(() => {});
+		return hit.arrayBuffer().then((buf) => done(new Uint8Array(buf)));
+	})).catch(() => {
+		// Cache API failed (e.g. storage disabled), plain download
+		download(null).then((buf) => done(new Uint8Array(buf)), () => done(null));
+	});
+	return 1;
+});
+
+/** Deletes the stores of other index versions of the game */
+EM_JS(void, async_handler_cache_cleanup, (const char* prefix_ptr, const char* cache_ptr), {
+	if (typeof caches === 'undefined') {
+		return;
+	}
+
+	const prefix = UTF8ToString(prefix_ptr);
+	const cacheName = UTF8ToString(cache_ptr);
+	caches.keys().then((names) => {
+		names.filter((name) => name.startsWith(prefix) && name !== cacheName).forEach((name) => caches.delete(name));
+	}).catch(() => {});
+});
+
+namespace {
+	/** The store is keyed by the game and a hash of its index file */
+	void SetAssetCache(const std::vector<uint8_t>& index_data) {
+		StringView data(reinterpret_cast<const char*>(index_data.data()), index_data.size());
+		const std::string prefix = "easyrpg-" + (Player::emscripten_game_name.empty() ? std::string("default") : Player::emscripten_game_name) + "-";
+		asset_cache_name = fmt::format("{}{:08x}", prefix, RequestIndex::Hash(data));
+		async_handler_cache_cleanup(prefix.c_str(), asset_cache_name.c_str());
+	}
+}
+#endif
+
+bool AsyncHandler::CreateRequestMapping(const std::string& file) {
 #ifdef EMSCRIPTEN
 	auto f = FileFinder::OpenInputStream(file);
+	if (!f) {
+		return false;
+	}
+
+	auto data = Utils::ReadStream(f);
+
+	if (StringView(file).ends_with(".bin")) {
+		SetAssetCache(data);
+		if (!request_index.Load(std::move(data))) {
+			Output::Warning("{} is not a valid index", file);
+			asset_cache_name.clear();
+			return false;
+		}
+		// Keys are normalized like in version 2
+		index_version = 2;
+		Output::Debug("Loaded {} with {} entries", file, request_index.GetSize());
+		return true;
+	}
+
+	SetAssetCache(data);
+
 	picojson::value v;
-	picojson::parse(v, f);
+	const char* json = reinterpret_cast<const char*>(data.data());
+	picojson::parse(v, json, json + data.size(), nullptr);
 
 	const auto& metadata = v.get("metadata");
 	if (metadata.is<picojson::object>()) {
@@ -132,9 +319,11 @@ void AsyncHandler::CreateRequestMapping(const std::string& file) {
 			parse(cache.get<picojson::object>(), "");
 		}
 	}
+	return true;
 #else
 	// no-op
 	(void)file;
+	return true;
 #endif
 }
 
@@ -165,6 +354,7 @@ bool AsyncHandler::IsFilePending(bool important, bool graphic) {
 #endif
 
 		if (!request.IsReady()
+				&& !request.IsPrefetch()
 				&& (!important || request.IsImportantFile())
 				&& (!graphic || request.IsGraphicFile())
 				) {
@@ -175,6 +365,46 @@ bool AsyncHandler::IsFilePending(bool important, bool graphic) {
 	return false;
 }
 
+void AsyncHandler::CancelPrefetch() {
+#ifdef EMSCRIPTEN
+	auto it = std::remove_if(queued_requests.begin(), queued_requests.end(), [](FileRequestAsync* request) {
+		if (!request->IsPrefetch()) {
+			return false;
+		}
+		request->CancelDownload();
+		return true;
+	});
+	queued_requests.erase(it, queued_requests.end());
+#endif
+}
+
+void AsyncHandler::PrefetchGraphic(StringView folder_name, StringView file_name) {
+	if (file_name.empty()) {
+		return;
+	}
+	FileRequestAsync* request = RequestFile(folder_name, file_name);
+	request->SetGraphicFile(true);
+	request->StartPrefetch();
+}
+
+void AsyncHandler::Update() {
+	if (decoding_requests.empty()) {
+		return;
+	}
+
+	// DownloadDone can start new requests
+	auto requests = std::move(decoding_requests);
+	decoding_requests.clear();
+
+	for (auto* request: requests) {
+		if (request->IsDecoded()) {
+			request->DownloadDone(true);
+		} else {
+			decoding_requests.push_back(request);
+		}
+	}
+}
+
 bool AsyncHandler::IsImportantFilePending() {
 	return IsFilePending(true, false);
 }
@@ -200,7 +430,29 @@ void FileRequestAsync::SetGraphicFile(bool graphic) {
 	}
 }
 
+FileRequestAsync::Priority FileRequestAsync::GetPriority() const {
+	if (prefetch) {
+		return Priority_Prefetch;
+	}
+	if (important) {
+		return Priority_Blocking;
+	}
+	return graphic ? Priority_Graphic : Priority_Normal;
+}
+
 void FileRequestAsync::Start() {
+	prefetch = false;
+	StartRequest();
+}
+
+void FileRequestAsync::StartPrefetch() {
+	if (state == State_WaitForStart) {
+		prefetch = true;
+	}
+	StartRequest();
+}
+
+void FileRequestAsync::StartRequest() {
 	if (file == CACHE_DEFAULT_BITMAP) {
 		// Embedded asset -> Fire immediately
 		DownloadDone(true);
@@ -208,6 +460,10 @@ void FileRequestAsync::Start() {
 	}
 
 	if (state == State_Pending) {
+#ifdef EMSCRIPTEN
+		// A queued prefetch may have turned into a request of higher priority
+		ProcessQueue();
+#endif
 		return;
 	}
 
@@ -219,6 +475,33 @@ void FileRequestAsync::Start() {
 
 	state = State_Pending;
 
+#ifdef EMSCRIPTEN
+	// Downloaded by StartDownload when a slot is free
+	queued_requests.push_back(this);
+	ProcessQueue();
+#else
+#  ifdef EM_GAME_URL
+#    warning EM_GAME_URL set and not an Emscripten build!
+#  endif
+
+#  ifndef EP_DEBUG_SIMULATE_ASYNC
+	if (graphic) {
+		decode = Cache::DecodeAsync(directory, file);
+	}
+
+	if (decode.valid()) {
+		// Finished by AsyncHandler::Update
+		decoding_requests.push_back(this);
+	} else if (!ReadAsync(*this, directory, file)) {
+		DownloadDone(true);
+	}
+#  endif
+#endif
+}
+
+void FileRequestAsync::StartDownload() {
+	downloading = true;
+
 #ifdef EMSCRIPTEN
 	std::string request_path;
 #  ifdef EM_GAME_URL
@@ -240,9 +523,18 @@ void FileRequestAsync::Start() {
 		modified_path = Utils::LowerCase(path);
 	}
 
-	auto it = file_mapping.find(modified_path);
-	if (it != file_mapping.end()) {
-		request_path += it->second;
+	StringView mapped_path;
+	if (request_index.IsLoaded()) {
+		mapped_path = request_index.Find(modified_path);
+	} else {
+		auto it = file_mapping.find(modified_path);
+		if (it != file_mapping.end()) {
+			mapped_path = it->second;
+		}
+	}
+
+	if (!mapped_path.empty()) {
+		request_path.append(mapped_path.data(), mapped_path.size());
 	} else {
 		// Fall through if not found, will fail in the ajax request
 		request_path += path;
@@ -252,6 +544,11 @@ void FileRequestAsync::Start() {
 	request_path = std::regex_replace(request_path, std::regex("%"), "%25");
 	request_path = std::regex_replace(request_path, std::regex("#"), "%23");
 
+	if (!asset_cache_name.empty()
+			&& async_handler_cache_fetch(request_path.c_str(), path.c_str(), asset_cache_name.c_str(), this)) {
+		return;
+	}
+
 	emscripten_async_wget2(
 		request_path.c_str(),
 		path.c_str(),
@@ -261,17 +558,18 @@ void FileRequestAsync::Start() {
 		download_success,
 		download_failure,
 		NULL);
-#else
-#  ifdef EM_GAME_URL
-#    warning EM_GAME_URL set and not an Emscripten build!
-#  endif
-
-#  ifndef EP_DEBUG_SIMULATE_ASYNC
-	DownloadDone(true);
-#  endif
 #endif
 }
 
+void FileRequestAsync::CancelDownload() {
+	// Still flagged as prefetch, so it does not count as pending
+	state = State_WaitForStart;
+}
+
+bool FileRequestAsync::IsDecoded() const {
+	return !decode.valid() || decode.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
 void FileRequestAsync::UpdateProgress() {
 #ifndef EMSCRIPTEN
 	// Fake download for testing event handlers
@@ -318,6 +616,17 @@ void FileRequestAsync::DownloadDone(bool success) {
 		success = state == State_DoneSuccess;
 	}
 
+	// The decoded image is owned by the Cache now
+	decode = {};
+
+#ifdef EMSCRIPTEN
+	if (downloading) {
+		// Listeners may start new requests, they can use the slot
+		downloading = false;
+		--active_downloads;
+	}
+#endif
+
 	if (success) {
 
 #ifdef EMSCRIPTEN
@@ -336,4 +645,8 @@ void FileRequestAsync::DownloadDone(bool success) {
 
 		CallListeners(false);
 	}
+
+#ifdef EMSCRIPTEN
+	ProcessQueue();
+#endif
 }
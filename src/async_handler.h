@@ -22,6 +22,7 @@
 #include <memory>
 #include <string>
 #include <vector>
+#include "cache.h"
 #include "string_view.h"
 
 class FileRequestAsync;
@@ -30,13 +31,19 @@ struct FileRequestResult;
 /**
  * AsyncHandler supports asynchronous file requests for platforms that don't
  * support synchronous IO (e.g. Emscripten).
+ * On the other platforms images, music and sound are read in the background
+ * on the JobSystem, the requests finish on the main thread like downloads.
  */
 namespace AsyncHandler {
 	/**
-	 * Parses the specified JSON file. The file mapping read from this file
-	 * will be used for further ajax requests.
+	 * Reads the file mapping used for further ajax requests.
+	 * Files ending in .bin are loaded as a RequestIndex, other files are
+	 * parsed as index.json.
+	 *
+	 * @param file index file
+	 * @return false when the file is not a valid index
 	 */
-	void CreateRequestMapping(const std::string& file);
+	bool CreateRequestMapping(const std::string& file);
 
 	/**
 	 * Creates a request to a file.
@@ -86,6 +93,29 @@ namespace AsyncHandler {
 	 * @return If any file with params is pending.
 	 */
 	bool IsFilePending(bool important, bool graphic);
+
+	/**
+	 * Drops all prefetch requests that did not start downloading yet.
+	 * Used when the prefetched content is not expected to be needed anymore.
+	 * A dropped request can be started again later.
+	 */
+	void CancelPrefetch();
+
+	/**
+	 * Starts a prefetch request of an image. The image is downloaded and
+	 * decoded in the background (see Cache::DecodeAsync) while the first
+	 * lookup is not needed yet.
+	 *
+	 * @param folder_name folder where the image is stored
+	 * @param file_name name of the image, nothing happens when empty
+	 */
+	void PrefetchGraphic(StringView folder_name, StringView file_name);
+
+	/**
+	 * Finishes requests whose images were decoded in the background.
+	 * Called once per frame.
+	 */
+	void Update();
 }
 
 using FileRequestBinding = std::shared_ptr<int>;
@@ -103,6 +133,21 @@ public:
 		State_Pending
 	};
 
+	/**
+	 * Download order of pending requests, the lowest value goes first.
+	 * Requests of the same priority are downloaded in the order they were started.
+	 */
+	enum Priority {
+		/** Blocks the Player update loop, ignores the download limit */
+		Priority_Blocking,
+		/** Graphics, may block transitions */
+		Priority_Graphic,
+		/** Audio and all other files */
+		Priority_Normal,
+		/** Speculative request, see StartPrefetch */
+		Priority_Prefetch
+	};
+
 	/**
 	 * Don't use this API directly. Use AsyncHandler::RequestFile.
 	 *
@@ -147,6 +192,16 @@ public:
 	 */
 	void SetGraphicFile(bool graphic);
 
+	/**
+	 * @return If the request was only started by StartPrefetch.
+	 */
+	bool IsPrefetch() const;
+
+	/**
+	 * @return Download priority derived from the request flags.
+	 */
+	Priority GetPriority() const;
+
 	/**
 	 * Starts the async requests.
 	 * When the request was already started earlier and is pending this call
@@ -155,6 +210,14 @@ public:
 	 */
 	void Start();
 
+	/**
+	 * Starts the request speculatively: It is downloaded after all other
+	 * requests, does not count as pending and can be dropped by
+	 * AsyncHandler::CancelPrefetch. A later call to Start turns it into a
+	 * normal request. Does nothing special when the request was already started.
+	 */
+	void StartPrefetch();
+
 	/**
 	 * @return Path to the requested file.
 	 */
@@ -199,16 +262,25 @@ public:
 	// don't call these directly
 	void DownloadDone(bool success);
 	void UpdateProgress();
+	bool IsDecoded() const;
+	void StartDownload();
+	void CancelDownload();
 private:
+	void StartRequest();
 	void CallListeners(bool success);
 
 	std::vector<std::pair<FileRequestBindingWeak, std::function<void(FileRequestResult*)> > > listeners;
 	std::string directory;
 	std::string file;
 	std::string path;
+	/** Background decode of graphic files, see Cache::DecodeAsync */
+	Cache::DecodeHandle decode;
 	int state = State_DoneFailure;
 	bool important = false;
 	bool graphic = false;
+	bool prefetch = false;
+	/** Counted in the concurrent downloads */
+	bool downloading = false;
 };
 
 /**
@@ -245,6 +317,10 @@ inline bool FileRequestAsync::IsGraphicFile() const {
 	return graphic;
 }
 
+inline bool FileRequestAsync::IsPrefetch() const {
+	return prefetch;
+}
+
 inline const std::string& FileRequestAsync::GetPath() const {
 	return path;
 }
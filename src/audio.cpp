@@ -22,6 +22,18 @@
 #include "player.h"
 #include "game_clock.h"
 
+namespace {
+	int buffer_size = 0;
+}
+
+void AudioInterface::SetBufferSize(int frames) {
+	buffer_size = frames;
+}
+
+int AudioInterface::GetBufferSize(int default_frames) {
+	return buffer_size > 0 ? buffer_size : default_frames;
+}
+
 AudioInterface& Audio() {
 	static EmptyAudio default_;
 #ifdef SUPPORT_AUDIO
@@ -96,6 +96,14 @@ struct AudioInterface {
 	 */
 	virtual void BGM_Pitch(int pitch) = 0;
 
+	/**
+	 * Opens a background music in advance, a later BGM_Play of the same
+	 * file starts without opening it again. Optional.
+	 *
+	 * @param file file to open.
+	 */
+	virtual void BGM_Prefetch(std::string const&) {}
+
 	/**
 	 * Plays a sound effect.
 	 *
@@ -109,6 +117,42 @@ struct AudioInterface {
 	 * Stops the currently playing sound effect.
 	 */
 	virtual void SE_Stop() = 0;
+
+	/** Output statistics of a backend */
+	struct Stats {
+		/** Frames of the output buffer, 0 when unknown */
+		int buffer_frames = 0;
+		/** Output frequency in Hz */
+		int frequency = 0;
+		/** Output buffers that were filled too late or without BGM data */
+		int underruns = 0;
+
+		/** @return latency of the output buffer in ms */
+		double GetLatency() const {
+			return frequency > 0 ? buffer_frames * 1000.0 / frequency : 0.0;
+		}
+	};
+
+	/**
+	 * Returns latency and underrun statistics. Optional.
+	 *
+	 * @return output statistics
+	 */
+	virtual Stats GetStats() const { return {}; }
+
+	/**
+	 * Sets the output buffer size the backends use when opening the device.
+	 * Must be called before the UI is created.
+	 *
+	 * @param frames frames per buffer, 0 for the backend default
+	 */
+	static void SetBufferSize(int frames);
+
+	/**
+	 * @param default_frames buffer size of the backend
+	 * @return configured buffer size or default_frames when not configured
+	 */
+	static int GetBufferSize(int default_frames);
 };
 
 struct EmptyAudio : public AudioInterface {
@@ -25,7 +25,9 @@
 #include <functional>
 
 #include "audio_al.h"
+#include "audio_secache.h"
 #include "filefinder.h"
+#include "game_clock.h"
 #include "output.h"
 #include "sndfile.h"
 
@@ -134,8 +136,34 @@ namespace {
 	enum { BUFFER_NUMBER = 3 };
 
 	double const SECOND_PER_BUFFER = 0.5;
+
+	/** Decoded SE buffers kept for replaying */
+	constexpr size_t max_cached_se_buffers = 32;
+	/** Stopped SE sources kept for reuse */
+	constexpr size_t max_pooled_se_sources = 16;
 }
 
+/** Sound effect decoded once into a static OpenAL buffer */
+struct ALAudio::se_buffer {
+	se_buffer(std::shared_ptr<ALCcontext> const &c) : ctx_(c) {
+		SET_CONTEXT(c);
+		alGenBuffers(1, &buf_);
+	}
+
+	~se_buffer() {
+		SET_CONTEXT(ctx_);
+		alDeleteBuffers(1, &buf_);
+	}
+
+	ALuint get() const {
+		return buf_;
+	}
+
+private:
+	std::shared_ptr<ALCcontext> ctx_;
+	ALuint buf_ = AL_NONE;
+};
+
 struct ALAudio::buffer_loader {
 	virtual ~buffer_loader() {
 	}
@@ -191,8 +219,10 @@ struct ALAudio::source {
 
 	~source() {
 		SET_CONTEXT(ctx_);
-		alSourcePlay(src_);
+		alSourceStop(src_);
+		alSourcei(src_, AL_BUFFER, AL_NONE);
 		alDeleteSources(1, &src_);
+		alDeleteBuffers(BUFFER_NUMBER, buffers_.data());
 	}
 
 	int loop_count() {
@@ -218,6 +248,7 @@ private:
 	bool loop_play_;
 	std::array<ALuint, BUFFER_NUMBER> buffers_;
 	std::shared_ptr<buffer_loader> loader_;
+	std::shared_ptr<se_buffer> static_;
 	std::deque<unsigned> ticks_, buf_sizes_;
 
 	unsigned progress_milli() const {
@@ -254,6 +285,25 @@ public:
 	}
 
 	void update() {
+		if (loader_) {
+			update_stream();
+		}
+
+		if (fade_milli_ != 0) {
+			SET_CONTEXT(ctx_);
+			fade_count_++;
+
+			if (fade_ended()) {
+				fade_milli_ = 0;
+				if (!is_fade_in_)
+					alSourceStop(src_);
+			} else {
+				alSourcef(src_, AL_GAIN, current_volume());
+			}
+		}
+	}
+
+	void update_stream() {
 		ALint processed;
 		alGetSourceiv(src_, AL_BUFFERS_PROCESSED, &processed);
 		std::vector<ALuint> unqueued(processed);
@@ -276,25 +326,30 @@ public:
 			ticks_.push_back(loader_->midi_ticks());
 		}
 		alSourceQueueBuffers(src_, queuing_count, &unqueued.front());
+	}
 
-		if (fade_milli_ != 0) {
-			SET_CONTEXT(ctx_);
-			fade_count_++;
+	/** Stops playback and releases the loader and buffer, the source can be reused afterwards */
+	void reset() {
+		SET_CONTEXT(ctx_);
+		alSourceStop(src_);
+		alSourcei(src_, AL_BUFFER, AL_NONE);
+		loader_.reset();
+		static_.reset();
+		fade_milli_ = 0;
+	}
 
-			if (fade_ended()) {
-				fade_milli_ = 0;
-				if (!is_fade_in_)
-					alSourceStop(src_);
-			} else {
-				alSourcef(src_, AL_GAIN, current_volume());
-			}
-		}
+	void set_static_buffer(std::shared_ptr<se_buffer> const &b) {
+		reset();
+		static_ = b;
+		alSourcei(src_, AL_BUFFER, b->get());
+		alSourcePlay(src_);
 	}
 
 	void set_buffer_loader(std::shared_ptr<buffer_loader> const &l) {
 		SET_CONTEXT(ctx_);
 		alSourceStop(src_);
 		alSourcei(src_, AL_BUFFER, AL_NONE);
+		static_.reset();
 
 		if (!l) {
 			loader_.reset();
@@ -468,16 +523,71 @@ ALAudio::getSound(source &src, std::string const &file) const {
 	return create_loader(src, file);
 }
 
+std::shared_ptr<ALAudio::se_buffer> ALAudio::getSoundBuffer(std::string const &file) {
+	for (auto i = se_buffers_.begin(); i != se_buffers_.end(); ++i) {
+		if (i->first == file) {
+			// Most recently used at the back
+			auto entry = *i;
+			se_buffers_.erase(i);
+			se_buffers_.push_back(entry);
+			return entry.second;
+		}
+	}
+
+	// Decoded through AudioSeCache, the sample is shared with GenericAudio
+	auto se = AudioSeCache::Create(file);
+	if (!se) {
+		return nullptr;
+	}
+
+	int frequency;
+	AudioDecoder::Format format;
+	int channels;
+	se->GetFormat(frequency, format, channels);
+	channels = channels >= 2 ? 2 : 1;
+
+	auto dec = se->CreateSeDecoder(frequency, AudioDecoder::Format::S16, channels, 100);
+	std::vector<uint8_t> data = dec->DecodeAll();
+	if (data.empty()) {
+		return nullptr;
+	}
+
+	SET_CONTEXT(ctx_);
+	auto buf = std::make_shared<se_buffer>(ctx_);
+	alBufferData(buf->get(), channels == 2 ? AL_FORMAT_STEREO16 : AL_FORMAT_MONO16,
+	             data.data(), data.size(), frequency);
+	if (!print_al_error()) {
+		return nullptr;
+	}
+
+	// Buffers still attached to a source stay alive through the source
+	if (se_buffers_.size() >= max_cached_se_buffers) {
+		se_buffers_.pop_front();
+	}
+	se_buffers_.emplace_back(file, buf);
+	return buf;
+}
+
+void ALAudio::release_se_source(std::shared_ptr<source> const &src) {
+	src->reset();
+	if (se_pool_.size() < max_pooled_se_sources) {
+		se_pool_.push_back(src);
+	}
+}
+
 void ALAudio::Update() {
 	bgm_src_->update();
 
-	for (source_list::iterator i = se_src_.begin(); i < se_src_.end(); ++i) {
-		i->get()->update();
+	for (source_map::iterator i = se_src_.begin(); i != se_src_.end();) {
+		i->second->update();
 
 		ALenum state = AL_INVALID_VALUE;
-		alGetSourcei(i->get()->get(), AL_SOURCE_STATE, &state);
+		alGetSourcei(i->second->get(), AL_SOURCE_STATE, &state);
 		if (state == AL_STOPPED) {
+			release_se_source(i->second);
 			i = se_src_.erase(i);
+		} else {
+			++i;
 		}
 	}
 }
@@ -572,21 +682,50 @@ void ALAudio::BGM_Pitch(int pitch) {
 void ALAudio::SE_Play(std::string const &file, int volume, int pitch) {
 	SET_CONTEXT(ctx_);
 
-	std::shared_ptr<source> src = create_source(false);
+	const int frame = Game_Clock::GetFrame();
+	se_limiter_.RemoveFinished([this](int id) { return se_src_.count(id) != 0; });
+
+	auto decision = se_limiter_.Request(file, frame);
+	if (decision.action == AudioSeLimiter::Action::Drop) {
+		return;
+	}
+	if (decision.action == AudioSeLimiter::Action::Retrigger) {
+		release_se_source(se_src_[decision.voice]);
+		se_src_.erase(decision.voice);
+		se_limiter_.Stop(decision.voice);
+	}
+
+	std::shared_ptr<source> src;
+	if (se_pool_.empty()) {
+		src = create_source(false);
+	} else {
+		src = se_pool_.back();
+		se_pool_.pop_back();
+	}
 
 	alSourcef(src->get(), AL_PITCH, pitch * 0.01f);
 	src->set_volume(volume * 0.01f);
-	src->set_buffer_loader(getSound(*src, file));
 
-	se_src_.push_back(src);
+	auto buf = getSoundBuffer(file);
+	if (buf) {
+		src->set_static_buffer(buf);
+	} else {
+		// Formats AudioSeCache can't decode (e.g. MIDI) are streamed
+		src->set_buffer_loader(getSound(*src, file));
+	}
+
+	const int id = se_next_id_++;
+	se_src_[id] = src;
+	se_limiter_.Start(id, file, frame);
 }
 
 void ALAudio::SE_Stop() {
 	SET_CONTEXT(ctx_);
-	for (source_list::iterator i = se_src_.begin(); i < se_src_.end(); ++i) {
-		alSourceStop(i->get()->get());
+	for (source_map::iterator i = se_src_.begin(); i != se_src_.end(); ++i) {
+		release_se_source(i->second);
 	}
 	se_src_.clear();
+	se_limiter_.Clear();
 }
 
 #endif
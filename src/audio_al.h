@@ -29,8 +29,12 @@
 
 #include "system.h"
 #include "audio.h"
+#include "audio_se_limiter.h"
 
+#include <deque>
 #include <map>
+#include <string>
+#include <utility>
 #include <vector>
 
 struct ALAudio : public AudioInterface {
@@ -58,20 +62,32 @@ private:
 	struct buffer_loader;
 	struct sndfile_loader;
 	struct midi_loader;
+	struct se_buffer;
 
 	std::shared_ptr<source> create_source(bool loop) const;
 	std::shared_ptr<buffer_loader> create_loader(source &src, std::string const &file) const;
 
 	std::shared_ptr<buffer_loader> getMusic(source &src, std::string const &file) const;
 	std::shared_ptr<buffer_loader> getSound(source &src, std::string const &file) const;
+	/** @return SE decoded into a static buffer, null when AudioSeCache can't decode it */
+	std::shared_ptr<se_buffer> getSoundBuffer(std::string const &file);
+	/** Stops the SE source and keeps it for reuse */
+	void release_se_source(std::shared_ptr<source> const &src);
 
 	std::shared_ptr<ALCdevice> dev_;
 	std::shared_ptr<ALCcontext> ctx_;
 
 	std::shared_ptr<source> bgm_src_;
 
-	typedef std::vector<std::shared_ptr<source> > source_list;
-	source_list se_src_;
+	typedef std::map<int, std::shared_ptr<source> > source_map;
+	/** SE sources by voice id of se_limiter_ */
+	source_map se_src_;
+	int se_next_id_ = 0;
+	AudioSeLimiter se_limiter_;
+	/** Stopped SE sources, reused by SE_Play */
+	std::vector<std::shared_ptr<source> > se_pool_;
+	/** Decoded SE buffers, most recently used at the back */
+	std::deque<std::pair<std::string, std::shared_ptr<se_buffer> > > se_buffers_;
 };  // struct ALAudio
 
 #endif  // _AUDIO_AL_H_
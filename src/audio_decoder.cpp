@@ -17,7 +17,12 @@
 
 // Headers
 #include <cassert>
+#include <algorithm>
 #include <cstring>
+#include <unordered_map>
+#ifdef HAVE_THREADS
+#  include <mutex>
+#endif
 #include "audio_decoder.h"
 #include "audio_midi.h"
 #include "audio_resampler.h"
@@ -82,6 +87,16 @@ std::vector<uint8_t> AudioDecoder::DecodeAll() {
 	const int buffer_size = 8192;
 
 	std::vector<uint8_t> buffer;
+
+	const int remaining = GetRemainingSize();
+	if (remaining >= 0) {
+		// Read straight into the final buffer
+		buffer.resize(remaining);
+		int read = remaining > 0 ? Decode(buffer.data(), remaining) : 0;
+		buffer.resize(static_cast<size_t>(std::max(read, 0)));
+		return buffer;
+	}
+
 	buffer.resize(buffer_size);
 
 	while (!IsFinished()) {
@@ -112,7 +127,102 @@ private:
 };
 const char wma_magic[] = { (char)0x30, (char)0x26, (char)0xB2, (char)0x75 };
 
-std::unique_ptr<AudioDecoder> AudioDecoder::Create(Filesystem_Stream::InputStream& stream, const std::string& filename, bool resample) {
+namespace {
+/** Decoders selected by the format detection of AudioDecoder::Create */
+enum class DecoderType {
+	Midi,
+	Opus,
+	OggVorbis,
+	Wav,
+	Libsndfile,
+	Wma,
+	Xmp,
+	Mpg123
+};
+
+/**
+ * Decoder type detected per file. Opening the file again creates the
+ * decoder directly, without reading the header or parsing MP3 frames.
+ */
+std::unordered_map<std::string, DecoderType> detected_types;
+#ifdef HAVE_THREADS
+// The BGM is opened by the decoder thread
+std::mutex detected_types_mutex;
+#endif
+
+bool FindDetectedType(const std::string& filename, DecoderType& type) {
+#ifdef HAVE_THREADS
+	std::lock_guard<std::mutex> lock(detected_types_mutex);
+#endif
+	auto it = detected_types.find(filename);
+	if (it == detected_types.end()) {
+		return false;
+	}
+	type = it->second;
+	return true;
+}
+
+void SetDetectedType(const std::string& filename, DecoderType type) {
+#ifdef HAVE_THREADS
+	std::lock_guard<std::mutex> lock(detected_types_mutex);
+#endif
+	detected_types[filename] = type;
+}
+
+std::unique_ptr<AudioDecoder> AddResampler(std::unique_ptr<AudioDecoder> dec, bool resample) {
+#ifdef USE_AUDIO_RESAMPLER
+	if (resample)
+		return std::make_unique<AudioResampler>(std::move(dec));
+#else
+	(void)resample;
+#endif
+	return dec;
+}
+
+/** Creates the decoder of an already detected type, null when this fails */
+std::unique_ptr<AudioDecoder> CreateDecoder(DecoderType type, Filesystem_Stream::InputStream& stream, bool resample) {
+	switch (type) {
+		case DecoderType::Midi:
+			return MidiDecoder::Create(stream, resample);
+#ifdef HAVE_OPUS
+		case DecoderType::Opus:
+			return AddResampler(std::make_unique<OpusDecoder>(), resample);
+#endif
+#if defined(HAVE_TREMOR) || defined(HAVE_OGGVORBIS)
+		case DecoderType::OggVorbis:
+			return AddResampler(std::make_unique<OggVorbisDecoder>(), resample);
+#endif
+#ifdef WANT_FASTWAV
+		case DecoderType::Wav:
+			return AddResampler(std::make_unique<WavDecoder>(), resample);
+#endif
+#ifdef HAVE_LIBSNDFILE
+		case DecoderType::Libsndfile:
+			return AddResampler(std::make_unique<LibsndfileDecoder>(), resample);
+#endif
+		case DecoderType::Wma:
+			return std::make_unique<WMAUnsupportedFormatDecoder>();
+#ifdef HAVE_XMP
+		case DecoderType::Xmp:
+			return AddResampler(std::make_unique<XMPDecoder>(), resample);
+#endif
+#ifdef HAVE_MPG123
+		case DecoderType::Mpg123: {
+			auto mp3dec = AddResampler(std::make_unique<Mpg123Decoder>(), resample);
+			if (mp3dec->WasInited()) {
+				return mp3dec;
+			}
+			break;
+		}
+#endif
+		default:
+			break;
+	}
+	return nullptr;
+}
+
+/** Sniffs the stream and creates the decoder, type is set to the decoder type */
+std::unique_ptr<AudioDecoder> DetectDecoder(Filesystem_Stream::InputStream& stream, const std::string& filename, bool resample, DecoderType& type) {
 	char magic[4] = { 0 };
 	if (!stream.ReadIntoObj(magic)) {
 		return nullptr;
@@ -126,18 +236,15 @@ std::unique_ptr<AudioDecoder> AudioDecoder::Create(Filesystem_Stream::InputStrea
 	(void)filename;
 #endif
 
-	auto add_resampler = [resample](std::unique_ptr<AudioDecoder> dec) -> std::unique_ptr<AudioDecoder> {
-#ifdef USE_AUDIO_RESAMPLER
-		if (resample)
-			return std::make_unique<AudioResampler>(std::move(dec));
-#endif
-		return dec;
+	auto add_resampler = [resample](std::unique_ptr<AudioDecoder> dec) {
+		return AddResampler(std::move(dec), resample);
 	};
 
 	// Try to use MIDI decoder, use fallback(s) if available
 	if (!strncmp(magic, "MThd", 4)) {
 		auto midi = MidiDecoder::Create(stream, resample);
 		if (midi) {
+			type = DecoderType::Midi;
 			return midi;
 		}
 	}
@@ -152,6 +259,7 @@ std::unique_ptr<AudioDecoder> AudioDecoder::Create(Filesystem_Stream::InputStrea
 		stream.seekg(0, std::ios::ios_base::beg);
 
 		if (!strncmp(magic, "Opus", 4)) {
+			type = DecoderType::Opus;
 			return add_resampler(std::make_unique<OpusDecoder>());
 		}
 #endif
@@ -164,6 +272,7 @@ std::unique_ptr<AudioDecoder> AudioDecoder::Create(Filesystem_Stream::InputStrea
 		stream.seekg(0, std::ios::ios_base::beg);
 
 		if (!strncmp(magic, "vorb", 4)) {
+			type = DecoderType::OggVorbis;
 			return add_resampler(std::make_unique<OggVorbisDecoder>());
 		}
 #endif
@@ -179,6 +288,7 @@ std::unique_ptr<AudioDecoder> AudioDecoder::Create(Filesystem_Stream::InputStrea
 		Utils::SwapByteOrder(raw_enc);
 		stream.seekg(0, std::ios::ios_base::beg);
 		if (raw_enc == 0x01) { // Codec is normal PCM
+			type = DecoderType::Wav;
 			return add_resampler(std::make_unique<WavDecoder>());
 		}
 	}
@@ -191,6 +301,7 @@ std::unique_ptr<AudioDecoder> AudioDecoder::Create(Filesystem_Stream::InputStrea
 		!strncmp(magic, "OggS", 4) || // OGG
 		!strncmp(magic, "fLaC", 4)) { // FLAC
 #ifdef HAVE_LIBSNDFILE
+		type = DecoderType::Libsndfile;
 		return add_resampler(std::make_unique<LibsndfileDecoder>());
 #endif
 		return nullptr;
@@ -198,12 +309,14 @@ std::unique_ptr<AudioDecoder> AudioDecoder::Create(Filesystem_Stream::InputStrea
 
 	// Inform about WMA issue
 	if (!memcmp(magic, wma_magic, 4)) {
+		type = DecoderType::Wma;
 		return std::make_unique<WMAUnsupportedFormatDecoder>();
 	}
 
 	// Test for tracker modules
 #ifdef HAVE_XMP
 	if (XMPDecoder::IsModule(filename)) {
+		type = DecoderType::Xmp;
 		return add_resampler(std::make_unique<XMPDecoder>());
 	}
 #endif
@@ -215,6 +328,7 @@ std::unique_ptr<AudioDecoder> AudioDecoder::Create(Filesystem_Stream::InputStrea
 		auto mp3dec = add_resampler(std::make_unique<Mpg123Decoder>());
 		if (mp3dec->WasInited()) {
 			if (strncmp(magic, "ID3", 3) == 0) {
+				type = DecoderType::Mpg123;
 				return mp3dec;
 			}
 
@@ -222,6 +336,7 @@ std::unique_ptr<AudioDecoder> AudioDecoder::Create(Filesystem_Stream::InputStrea
 			if (Mpg123Decoder::IsMp3(stream)) {
 				stream.clear();
 				stream.seekg(0, std::ios_base::beg);
+				type = DecoderType::Mpg123;
 				return mp3dec;
 			}
 		} else {
@@ -234,6 +349,30 @@ std::unique_ptr<AudioDecoder> AudioDecoder::Create(Filesystem_Stream::InputStrea
 	stream.seekg(0, std::ios::ios_base::beg);
 	return nullptr;
 }
+} // namespace
+
+std::unique_ptr<AudioDecoder> AudioDecoder::Create(Filesystem_Stream::InputStream& stream, const std::string& filename, bool resample) {
+	DecoderType type = DecoderType::Midi;
+	if (FindDetectedType(filename, type)) {
+		auto dec = CreateDecoder(type, stream, resample);
+		if (dec) {
+			return dec;
+		}
+	}
+
+	auto dec = DetectDecoder(stream, filename, resample, type);
+	if (dec) {
+		SetDetectedType(filename, type);
+	}
+	return dec;
+}
+
+void AudioDecoder::ClearDetectedTypes() {
+#ifdef HAVE_THREADS
+	std::lock_guard<std::mutex> lock(detected_types_mutex);
+#endif
+	detected_types.clear();
+}
 
 void AudioDecoder::SetFade(int begin, int end, int duration) {
 	fade_time = 0.0;
@@ -326,6 +465,10 @@ int AudioDecoder::GetTicks() const {
 	return 0;
 }
 
+int AudioDecoder::GetRemainingSize() const {
+	return -1;
+}
+
 int AudioDecoder::GetSamplesizeForFormat(AudioDecoder::Format format) {
 	switch (format) {
 		case Format::S8:
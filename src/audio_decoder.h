@@ -74,6 +74,8 @@ public:
 	 * the beginning.
 	 * The filename is used for debug purposes but should match the FILE handle.
 	 * Upon failure the FILE handle is valid and points at the beginning.
+	 * The detected decoder is remembered per filename, opening the same file
+	 * again skips the format detection.
 	 *
 	 * @param stream handle to parse
 	 * @param filename Path to the file handle
@@ -82,6 +84,12 @@ public:
 	 */
 	static std::unique_ptr<AudioDecoder> Create(Filesystem_Stream::InputStream& stream, const std::string& filename, bool resample = true);
 
+	/**
+	 * Forgets the decoders detected by Create.
+	 * Must be called when the files can change, e.g. when another game is loaded.
+	 */
+	static void ClearDetectedTypes();
+
 	/**
 	 * Updates the volume for the fade in/out effect.
 	 * Volume changes will not really modify the volume but are only helper
@@ -271,6 +279,15 @@ public:
 	 */
 	virtual int GetTicks() const;
 
+	/**
+	 * Returns the amount of bytes the decoder will still output when this is
+	 * known in advance, e.g. for uncompressed formats.
+	 * DecodeAll uses this to read the whole sample at once.
+	 *
+	 * @return Remaining bytes or -1 when unknown
+	 */
+	virtual int GetRemainingSize() const;
+
 	/**
 	 * Returns the amount of bytes per sample.
 	 *
@@ -17,11 +17,20 @@
 
 #include "system.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <cstring>
 #include <cassert>
 #include "audio_generic.h"
+#include "audio_simd.h"
+#include "capture.h"
 #include "filefinder.h"
+#include "frame_stats.h"
+#include "game_clock.h"
+#include "instrumentation.h"
 #include "output.h"
+#include "thread_affinity.h"
 
 GenericAudio::BgmChannel GenericAudio::BGM_Channels[nr_of_bgm_channels];
 GenericAudio::SeChannel GenericAudio::SE_Channels[nr_of_se_channels];
@@ -32,6 +41,101 @@ std::vector<uint8_t> GenericAudio::scrap_buffer;
 unsigned GenericAudio::scrap_buffer_size = 0;
 std::vector<float> GenericAudio::mixer_buffer;
 
+namespace {
+#ifdef HAVE_THREADS
+	/** Stereo samples a BGM ring buffer holds */
+	constexpr size_t bgm_buffer_samples = 8192 * 2;
+	/** Callback sized chunks of samples decoded in advance */
+	constexpr int bgm_buffer_chunks = 3;
+	/** Frames per chunk until the first Decode call tells the real size */
+	constexpr int default_bgm_chunk_frames = 1024;
+	/** Upper limit of GenericAudio::bgm_extra_chunks */
+	constexpr int max_bgm_extra_chunks = 8;
+#endif
+
+	/**
+	 * Converts the samples of a channel to float and mixes them into the
+	 * stereo mixer buffer. There is a loop without branches for every format
+	 * and channel layout so the compiler can vectorize them.
+	 *
+	 * @param mixer mixer buffer, two floats per frame
+	 * @param samples samples of the channel
+	 * @param frames number of frames to mix
+	 * @param channels number of channels of the samples, only the first two are mixed
+	 * @param gain volume divided by the maximum of the sample type
+	 * @param bias added to every sample, to center unsigned formats
+	 * @param overwrite replace the mixer content instead of adding to it
+	 */
+	template <typename T>
+	void MixSamples(float* mixer, const uint8_t* samples, int frames, int channels, float gain, float bias, bool overwrite) {
+		const T* src = reinterpret_cast<const T*>(samples);
+
+		if (channels == 1) {
+			if (overwrite) {
+				for (int i = 0; i < frames; ++i) {
+					const float val = src[i] * gain + bias;
+					mixer[i * 2] = val;
+					mixer[i * 2 + 1] = val;
+				}
+			} else {
+				for (int i = 0; i < frames; ++i) {
+					const float val = src[i] * gain + bias;
+					mixer[i * 2] += val;
+					mixer[i * 2 + 1] += val;
+				}
+			}
+		} else {
+			if (overwrite) {
+				for (int i = 0; i < frames; ++i) {
+					mixer[i * 2] = src[i * channels] * gain + bias;
+					mixer[i * 2 + 1] = src[i * channels + 1] * gain + bias;
+				}
+			} else {
+				for (int i = 0; i < frames; ++i) {
+					mixer[i * 2] += src[i * channels] * gain + bias;
+					mixer[i * 2 + 1] += src[i * channels + 1] * gain + bias;
+				}
+			}
+		}
+	}
+
+	void MixSamples(float* mixer, const uint8_t* samples, AudioDecoder::Format format, int frames, int channels, float volume, bool overwrite) {
+		// The common stereo formats use the vectorized kernels
+		if (channels == 2 && format == AudioDecoder::Format::F32) {
+			AudioSimd::MixF32(mixer, reinterpret_cast<const float*>(samples), frames * 2, volume, overwrite);
+			return;
+		}
+		if (channels == 2 && format == AudioDecoder::Format::S16) {
+			AudioSimd::MixS16(mixer, reinterpret_cast<const int16_t*>(samples), frames * 2, volume / 32768.0f, overwrite);
+			return;
+		}
+
+		switch (format) {
+			case AudioDecoder::Format::S8:
+				MixSamples<int8_t>(mixer, samples, frames, channels, volume / 128.0f, 0.0f, overwrite);
+				break;
+			case AudioDecoder::Format::U8:
+				MixSamples<uint8_t>(mixer, samples, frames, channels, volume / 128.0f, -volume, overwrite);
+				break;
+			case AudioDecoder::Format::S16:
+				MixSamples<int16_t>(mixer, samples, frames, channels, volume / 32768.0f, 0.0f, overwrite);
+				break;
+			case AudioDecoder::Format::U16:
+				MixSamples<uint16_t>(mixer, samples, frames, channels, volume / 32768.0f, -volume, overwrite);
+				break;
+			case AudioDecoder::Format::S32:
+				MixSamples<int32_t>(mixer, samples, frames, channels, volume / 2147483648.0f, 0.0f, overwrite);
+				break;
+			case AudioDecoder::Format::U32:
+				MixSamples<uint32_t>(mixer, samples, frames, channels, volume / 2147483648.0f, -volume, overwrite);
+				break;
+			case AudioDecoder::Format::F32:
+				MixSamples<float>(mixer, samples, frames, channels, volume, 0.0f, overwrite);
+				break;
+		}
+	}
+}
+
 GenericAudio::GenericAudio() {
 	for (auto& BGM_Channel : BGM_Channels) {
 		BGM_Channel.decoder.reset();
@@ -44,48 +148,125 @@ GenericAudio::GenericAudio() {
 	// Initialize to some arbitrary (low-quality) format to prevent crashes
 	// when the inheriting class doesn't call SetFormat
 	SetFormat(12345, AudioDecoder::Format::S8, 1);
+
+#ifdef HAVE_THREADS
+	// Before the inheriting class starts calling Decode
+	for (auto& BGM_Channel : BGM_Channels) {
+		BGM_Channel.samples.Resize(bgm_buffer_samples);
+		BGM_Channel.flush = false;
+	}
+	bgm_thread = std::thread([this]() { DecodeBgm(); });
+#endif
 }
 
 GenericAudio::~GenericAudio() {
+#ifdef HAVE_THREADS
+	{
+		std::lock_guard<std::mutex> lock(bgm_mutex);
+		bgm_quit = true;
+	}
+	bgm_cv.notify_all();
+	bgm_thread.join();
+#endif
+}
+
+void GenericAudio::LockBgm() const {
+#ifdef HAVE_THREADS
+	bgm_mutex.lock();
+#else
+	LockMutex();
+#endif
+}
+
+void GenericAudio::UnlockBgm() const {
+#ifdef HAVE_THREADS
+	bgm_mutex.unlock();
+#else
+	UnlockMutex();
+#endif
 }
 
 void GenericAudio::BGM_Play(const std::string& file, int volume, int pitch, int fadein) {
 	bool bgm_set = false;
 	for (auto& BGM_Channel : BGM_Channels) {
 		BGM_Channel.stopped = true; //Stop all running background music
-		if (!BGM_Channel.decoder && !bgm_set) {
+		LockBgm();
+#ifdef HAVE_THREADS
+		// Not opened yet, discard it
+		BGM_Channel.request.reset();
+		++BGM_Channel.request_id;
+#endif
+		const bool unused = !IsBgmUsed(BGM_Channel);
+		UnlockBgm();
+		if (unused && !bgm_set) {
 			//If there is an unused bgm channel
 			bgm_set = true;
-			LockMutex();
+			LockBgm();
 			BGM_PlayedOnceIndicator = false;
-			UnlockMutex();
+			UnlockBgm();
 			PlayOnChannel(BGM_Channel, file, volume, pitch, fadein);
 		}
 	}
 }
 
+void GenericAudio::BGM_Prefetch(std::string const& file) {
+#ifdef HAVE_THREADS
+	{
+		std::lock_guard<std::mutex> lock(bgm_mutex);
+		if (bgm_prefetched_file == file) {
+			return;
+		}
+	}
+
+	auto request = std::make_unique<BgmRequest>();
+	request->file = file;
+	request->stream = FileFinder::OpenInputStream(file);
+	if (!request->stream) {
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(bgm_mutex);
+		bgm_prefetch_request = std::move(request);
+		bgm_prefetched_file = file;
+		bgm_prefetched.reset();
+	}
+	bgm_cv.notify_one();
+#else
+	(void)file;
+#endif
+}
+
 void GenericAudio::BGM_Pause() {
+	LockBgm();
 	for (auto& BGM_Channel : BGM_Channels) {
-		if (BGM_Channel.decoder) {
+		if (IsBgmUsed(BGM_Channel)) {
 			BGM_Channel.paused = true;
 		}
 	}
+	UnlockBgm();
 }
 
 void GenericAudio::BGM_Resume() {
+	LockBgm();
 	for (auto& BGM_Channel : BGM_Channels) {
-		if (BGM_Channel.decoder) {
+		if (IsBgmUsed(BGM_Channel)) {
 			BGM_Channel.paused = false;
 		}
 	}
+	UnlockBgm();
 }
 
 void GenericAudio::BGM_Stop() {
 	for (auto& BGM_Channel : BGM_Channels) {
 		BGM_Channel.stopped = true; //Stop all running background music
-		LockMutex();
+		LockBgm();
 		BGM_Channel.decoder.reset();
-		UnlockMutex();
+#ifdef HAVE_THREADS
+		BGM_Channel.request.reset();
+		++BGM_Channel.request_id;
+#endif
+		UnlockBgm();
 	}
 }
 
@@ -104,75 +285,153 @@ bool GenericAudio::BGM_IsPlaying() const {
 
 int GenericAudio::BGM_GetTicks() const {
 	unsigned ticks = 0;
-	LockMutex();
+	LockBgm();
 	for (auto& BGM_Channel : BGM_Channels) {
 		if (BGM_Channel.decoder) {
 			ticks = BGM_Channel.decoder->GetTicks();
 			break;
 		}
 	}
-	UnlockMutex();
+	UnlockBgm();
 	return ticks;
 }
 
 void GenericAudio::BGM_Fade(int fade) {
-	LockMutex();
+	LockBgm();
 	for (auto& BGM_Channel : BGM_Channels) {
 		if (BGM_Channel.decoder) {
 			BGM_Channel.decoder->SetFade(BGM_Channel.decoder->GetVolume(), 0, fade);
 		}
+#ifdef HAVE_THREADS
+		if (BGM_Channel.request) {
+			BGM_Channel.request->fadeout = fade;
+		}
+#endif
 	}
-	UnlockMutex();
+	UnlockBgm();
 }
 
 void GenericAudio::BGM_Volume(int volume) {
-	LockMutex();
+	LockBgm();
 	for (auto& BGM_Channel : BGM_Channels) {
 		if (BGM_Channel.decoder) {
 			BGM_Channel.decoder->SetVolume(volume);
 		}
+#ifdef HAVE_THREADS
+		if (BGM_Channel.request) {
+			BGM_Channel.request->volume = volume;
+			BGM_Channel.request->fadein = 0;
+		}
+#endif
 	}
-	UnlockMutex();
+	UnlockBgm();
 }
 
 void GenericAudio::BGM_Pitch(int pitch) {
-	LockMutex();
+	LockBgm();
 	for (auto& BGM_Channel : BGM_Channels) {
 		if (BGM_Channel.decoder) {
 			BGM_Channel.decoder->SetPitch(pitch);
 		}
+#ifdef HAVE_THREADS
+		if (BGM_Channel.request) {
+			BGM_Channel.request->pitch = pitch;
+		}
+#endif
 	}
-	UnlockMutex();
+	UnlockBgm();
 }
 
 void GenericAudio::SE_Play(std::string const &file, int volume, int pitch) {
-	for (auto& SE_Channel : SE_Channels) {
-		if (!SE_Channel.decoder) {
-			//If there is an unused se channel
-			PlayOnChannel(SE_Channel, file, volume, pitch);
+	const int frame = Game_Clock::GetFrame();
+	se_limiter.RemoveFinished([](int voice) { return SE_Channels[voice].decoder != nullptr; });
+
+	auto decision = se_limiter.Request(file, frame);
+	if (decision.action == AudioSeLimiter::Action::Drop) {
+		return;
+	}
+
+	int voice = decision.voice;
+	if (decision.action == AudioSeLimiter::Action::Play) {
+		for (unsigned i = 0; i < nr_of_se_channels; ++i) {
+			if (!SE_Channels[i].decoder) {
+				//If there is an unused se channel
+				voice = static_cast<int>(i);
+				break;
+			}
+		}
+	}
+
+	if (voice < 0) {
+		// All channels are busy: Replace the SE that plays the longest
+		voice = se_limiter.GetOldest();
+		if (voice < 0) {
+			Output::Debug("Couldn't play {} SE. No free channel available", FileFinder::GetPathInsideGamePath(file));
 			return;
 		}
 	}
-	// FIXME Not displaying as warning because multiple games exhaust free channels available, see #1356
-	Output::Debug("Couldn't play {} SE. No free channel available", FileFinder::GetPathInsideGamePath(file));
+
+	SeChannel& chan = SE_Channels[voice];
+	if (chan.decoder) {
+		// The audio thread may be mixing the channel right now
+		LockMutex();
+		chan.decoder.reset();
+		UnlockMutex();
+	}
+
+	if (PlayOnChannel(chan, file, volume, pitch)) {
+		se_limiter.Start(voice, file, frame);
+	} else {
+		se_limiter.Stop(voice);
+	}
 }
 
 void GenericAudio::SE_Stop() {
 	for (auto& SE_Channel : SE_Channels) {
 		SE_Channel.stopped = true; //Stop all running sound effects
 	}
+	se_limiter.Clear();
 }
 
 void GenericAudio::Update() {
 	// no-op, handled by the Decode function called through a thread
 }
 
+AudioInterface::Stats GenericAudio::GetStats() const {
+	Stats stats;
+	stats.buffer_frames = output_frames;
+	stats.frequency = output_format.frequency;
+	stats.underruns = underruns;
+	return stats;
+}
+
 void GenericAudio::SetFormat(int frequency, AudioDecoder::Format format, int channels) {
 	output_format.frequency = frequency;
 	output_format.format = format;
 	output_format.channels = channels;
 }
 
+bool GenericAudio::IsBgmUsed(const BgmChannel& chan) {
+#ifdef HAVE_THREADS
+	if (chan.request) {
+		return true;
+	}
+#endif
+	return chan.decoder != nullptr;
+}
+
+std::unique_ptr<AudioDecoder> GenericAudio::OpenBgm(Filesystem_Stream::InputStream stream, const std::string& file, int pitch) const {
+	auto decoder = AudioDecoder::Create(stream, file);
+	if (!decoder || !decoder->Open(std::move(stream))) {
+		return nullptr;
+	}
+
+	decoder->SetPitch(pitch);
+	decoder->SetFormat(output_format.frequency, output_format.format, output_format.channels);
+	decoder->SetLooping(true);
+	return decoder;
+}
+
 bool GenericAudio::PlayOnChannel(BgmChannel& chan, const std::string& file, int volume, int pitch, int fadein) {
 	chan.paused = true; // Pause channel so the audio thread doesn't work on it
 	chan.stopped = false; // Unstop channel so the audio thread doesn't delete it
@@ -183,13 +442,33 @@ bool GenericAudio::PlayOnChannel(BgmChannel& chan, const std::string& file, int
 		return false;
 	}
 
-	chan.decoder = AudioDecoder::Create(filestream, file);
-	if (chan.decoder && chan.decoder->Open(std::move(filestream))) {
-		chan.decoder->SetPitch(pitch);
-		chan.decoder->SetFormat(output_format.frequency, output_format.format, output_format.channels);
-		chan.decoder->SetFade(0, volume, fadein);
-		chan.decoder->SetLooping(true);
+#ifdef HAVE_THREADS
+	// Opened by DecodeBgm, the caller does not wait for the decoder
+	auto request = std::make_unique<BgmRequest>();
+	request->stream = std::move(filestream);
+	request->file = file;
+	request->volume = volume;
+	request->pitch = pitch;
+	request->fadein = fadein;
+
+	{
+		std::lock_guard<std::mutex> lock(bgm_mutex);
+		chan.request = std::move(request);
+		++chan.request_id;
+		chan.paused = false; // Unpause channel -> Play it.
+	}
+	bgm_cv.notify_one();
+
+	return true;
+#else
+	auto decoder = OpenBgm(std::move(filestream), file, pitch);
+	if (decoder) {
+		decoder->SetFade(0, volume, fadein);
+
+		LockBgm();
+		chan.decoder = std::move(decoder);
 		chan.paused = false; // Unpause channel -> Play it.
+		UnlockBgm();
 
 		return true;
 	} else {
@@ -197,6 +476,7 @@ bool GenericAudio::PlayOnChannel(BgmChannel& chan, const std::string& file, int
 	}
 
 	return false;
+#endif
 }
 
 bool GenericAudio::PlayOnChannel(SeChannel& chan, const std::string& file, int volume, int pitch) {
@@ -205,9 +485,7 @@ bool GenericAudio::PlayOnChannel(SeChannel& chan, const std::string& file, int v
 
 	std::unique_ptr<AudioSeCache> cache = AudioSeCache::Create(file);
 	if (cache) {
-		chan.decoder = cache->CreateSeDecoder();
-		chan.decoder->SetPitch(pitch);
-		chan.decoder->SetFormat(output_format.frequency, output_format.format, output_format.channels);
+		chan.decoder = cache->CreateSeDecoder(output_format.frequency, output_format.format, output_format.channels, pitch);
 		chan.volume = volume;
 		chan.paused = false; // Unpause channel -> Play it.
 		return true;
@@ -218,7 +496,159 @@ bool GenericAudio::PlayOnChannel(SeChannel& chan, const std::string& file, int v
 	return false;
 }
 
+#ifdef HAVE_THREADS
+void GenericAudio::DecodeBgm() {
+	ThreadAffinity::Apply(ThreadAffinity::Role::Audio);
+	std::unique_lock<std::mutex> lock(bgm_mutex);
+
+	while (!bgm_quit) {
+		// The decoders are opened without the lock, this can take a while
+		if (bgm_prefetch_request) {
+			auto request = std::move(bgm_prefetch_request);
+			lock.unlock();
+			auto decoder = OpenBgm(std::move(request->stream), request->file, 100);
+			if (decoder && decoder->GetType() == "midi") {
+				// The MIDI decoders share the synthesizer with the playing BGM
+				decoder.reset();
+			}
+			lock.lock();
+
+			if (!bgm_prefetch_request && bgm_prefetched_file == request->file) {
+				bgm_prefetched = std::move(decoder);
+				if (!bgm_prefetched) {
+					bgm_prefetched_file.clear();
+				}
+			}
+			continue;
+		}
+
+		bool opened = false;
+		for (auto& chan : BGM_Channels) {
+			if (!chan.request || opened) {
+				continue;
+			}
+			if (chan.stopped) {
+				chan.request.reset();
+				continue;
+			}
+
+			// The request stays in the channel, BGM_Volume and others change it meanwhile
+			auto stream = std::move(chan.request->stream);
+			const std::string file = chan.request->file;
+			const int pitch = chan.request->pitch;
+			const unsigned request_id = chan.request_id;
+
+			std::unique_ptr<AudioDecoder> decoder;
+			if (bgm_prefetched && bgm_prefetched_file == file) {
+				decoder = std::move(bgm_prefetched);
+				bgm_prefetched_file.clear();
+			}
+
+			lock.unlock();
+			if (decoder) {
+				decoder->SetPitch(pitch);
+			} else {
+				decoder = OpenBgm(std::move(stream), file, pitch);
+			}
+			lock.lock();
+			opened = true;
+
+			if (chan.request_id != request_id || !chan.request) {
+				// Stopped or replaced while opening
+				continue;
+			}
+
+			auto request = std::move(chan.request);
+			if (!decoder) {
+				Output::Warning("Couldn't play BGM {}. Format not supported", FileFinder::GetPathInsideGamePath(file));
+				continue;
+			}
+
+			if (request->pitch != pitch) {
+				decoder->SetPitch(request->pitch);
+			}
+			if (request->fadeout >= 0) {
+				decoder->SetVolume(request->volume);
+				decoder->SetFade(request->volume, 0, request->fadeout);
+			} else {
+				decoder->SetFade(0, request->volume, request->fadein);
+			}
+			chan.decoder = std::move(decoder);
+			chan.flush = true;
+		}
+		if (opened) {
+			// The lock was released, check the requests again
+			continue;
+		}
+
+		int frames = bgm_chunk_frames;
+		if (frames <= 0) {
+			frames = default_bgm_chunk_frames;
+		}
+		const size_t chunk_samples = frames * 2;
+
+		bool decoded = false;
+		for (auto& chan : BGM_Channels) {
+			if (!chan.decoder) {
+				continue;
+			}
+			if (chan.stopped) {
+				chan.decoder.reset();
+				continue;
+			}
+			if (chan.paused || chan.flush) {
+				continue;
+			}
+
+			const size_t target = std::min(chan.samples.GetCapacity(), chunk_samples * (bgm_buffer_chunks + bgm_extra_chunks));
+			const size_t buffered = chan.samples.GetCapacity() - chan.samples.GetWriteAvailable();
+			if (buffered + chunk_samples > target) {
+				continue;
+			}
+
+			// The fade advances per chunk, as it did when the callback decoded
+			chan.decoder->Update(1000 / 60);
+			const float volume = chan.decoder->GetVolume() / 100.0f;
+
+			int frequency;
+			AudioDecoder::Format sampleformat;
+			int channels;
+			chan.decoder->GetFormat(frequency, sampleformat, channels);
+			const int samplesize = AudioDecoder::GetSamplesizeForFormat(sampleformat);
+
+			bgm_decode_buffer.resize(samplesize * channels * frames);
+			const int read_bytes = chan.decoder->Decode(bgm_decode_buffer.data(), bgm_decode_buffer.size());
+			if (read_bytes < 0) {
+				// An error occured when reading - the channel is faulty - discard
+				chan.decoder.reset();
+				continue;
+			}
+
+			BGM_PlayedOnceIndicator = chan.decoder->GetLoopCount() > 0;
+
+			const int read_frames = read_bytes / (samplesize * channels);
+			if (read_frames == 0) {
+				continue;
+			}
+
+			bgm_chunk.resize(read_frames * 2);
+			MixSamples(bgm_chunk.data(), bgm_decode_buffer.data(), sampleformat, read_frames, channels, volume, true);
+			chan.volume = volume;
+			chan.samples.Write(bgm_chunk.data(), bgm_chunk.size());
+			decoded = true;
+		}
+
+		if (!decoded) {
+			bgm_cv.wait_for(lock, std::chrono::milliseconds(10));
+		}
+	}
+}
+#endif
+
 void GenericAudio::Decode(uint8_t* output_buffer, int buffer_length) {
+	FrameStats::Scope stats_scope(FrameStats::Phase::Audio);
+	INSTRUMENTATION_SCOPE("GenericAudio::Decode");
+
 	bool channel_active = false;
 	float total_volume = 0;
 	int samples_per_frame = buffer_length / output_format.channels / 2;
@@ -236,6 +666,23 @@ void GenericAudio::Decode(uint8_t* output_buffer, int buffer_length) {
 		scrap_buffer.resize(scrap_buffer_size);
 	}
 
+	const auto decode_time = Game_Clock::now();
+	if (last_decode_time != Game_Clock::time_point() && output_format.frequency > 0) {
+		// Called later than the previous buffer lasted: The device ran out of samples
+		const auto buffer_time = std::chrono::microseconds(static_cast<int64_t>(samples_per_frame) * 1000000 / output_format.frequency);
+		if (decode_time - last_decode_time > buffer_time * 3 / 2) {
+			++underruns;
+		}
+	}
+	last_decode_time = decode_time;
+	output_frames = samples_per_frame;
+
+#ifdef HAVE_THREADS
+	bgm_chunk_frames = samples_per_frame;
+	// Refill the ring buffers of the BGM
+	bgm_cv.notify_one();
+#endif
+
 	for (unsigned i = 0; i < nr_of_bgm_channels + nr_of_se_channels; i++) {
 		int read_bytes = 0;
 		int channels = 0;
@@ -250,6 +697,41 @@ void GenericAudio::Decode(uint8_t* output_buffer, int buffer_length) {
 
 		if (is_bgm_channel) {
 			BgmChannel& currently_mixed_channel = BGM_Channels[i];
+#ifdef HAVE_THREADS
+			// Decoded by DecodeBgm: Stereo float samples with the volume applied
+			if (currently_mixed_channel.flush) {
+				currently_mixed_channel.samples.Clear();
+				currently_mixed_channel.flush = false;
+				currently_mixed_channel.filled = false;
+			}
+
+			if (currently_mixed_channel.paused || currently_mixed_channel.stopped) {
+				currently_mixed_channel.filled = false;
+			} else {
+				const size_t read_samples = currently_mixed_channel.samples.Read(
+					reinterpret_cast<float*>(scrap_buffer.data()), samples_per_frame * 2);
+
+				const bool filled = read_samples == static_cast<size_t>(samples_per_frame * 2);
+				if (!filled && currently_mixed_channel.filled) {
+					// The decoder thread fell behind, decode further ahead
+					++underruns;
+					if (bgm_extra_chunks < max_bgm_extra_chunks) {
+						++bgm_extra_chunks;
+					}
+				}
+				currently_mixed_channel.filled = filled;
+
+				if (read_samples > 0) {
+					total_volume += currently_mixed_channel.volume;
+					volume = 1.0f;
+					sampleformat = AudioDecoder::Format::F32;
+					channels = 2;
+					samplesize = sizeof(float);
+					read_bytes = read_samples * sizeof(float);
+					channel_used = true;
+				}
+			}
+#else
 			float current_master_volume = 1.0;
 
 			if (currently_mixed_channel.decoder && !currently_mixed_channel.paused) {
@@ -282,6 +764,7 @@ void GenericAudio::Decode(uint8_t* output_buffer, int buffer_length) {
 					channel_used = true;
 				}
 			}
+#endif
 		} else {
 			SeChannel& currently_mixed_channel = SE_Channels[i - nr_of_bgm_channels];
 			float current_master_volume = 1.0;
@@ -324,88 +807,38 @@ void GenericAudio::Decode(uint8_t* output_buffer, int buffer_length) {
 		//--------------------------------------------------------------------------------------------------------------------//
 
 		if (channel_used) {
-			for (unsigned ii = 0; ii < (unsigned)(read_bytes / (samplesize * channels)); ii++) {
-
-				float vall = volume;
-				float valr = vall;
-
-				// Convert to floating point
-				switch (sampleformat) {
-					case AudioDecoder::Format::S8:
-						vall *= (((int8_t *) scrap_buffer.data())[ii * channels] / 128.0);
-						valr *= (((int8_t *) scrap_buffer.data())[ii * channels + 1] / 128.0);
-						break;
-					case AudioDecoder::Format::U8:
-						vall *= (((uint8_t *) scrap_buffer.data())[ii * channels] / 128.0 - 1.0);
-						valr *= (((uint8_t *) scrap_buffer.data())[ii * channels + 1] / 128.0 - 1.0);
-						break;
-					case AudioDecoder::Format::S16:
-						vall *= (((int16_t *) scrap_buffer.data())[ii * channels] / 32768.0);
-						valr *= (((int16_t *) scrap_buffer.data())[ii * channels + 1] / 32768.0);
-						break;
-					case AudioDecoder::Format::U16:
-						vall *= (((uint16_t *) scrap_buffer.data())[ii * channels] / 32768.0 - 1.0);
-						valr *= (((uint16_t *) scrap_buffer.data())[ii * channels + 1] / 32768.0 - 1.0);
-						break;
-					case AudioDecoder::Format::S32:
-						vall *= (((int32_t *) scrap_buffer.data())[ii * channels] / 2147483648.0);
-						valr *= (((int32_t *) scrap_buffer.data())[ii * channels + 1] / 2147483648.0);
-						break;
-					case AudioDecoder::Format::U32:
-						vall *= (((uint32_t *) scrap_buffer.data())[ii * channels] / 2147483648.0 - 1.0);
-						valr *= (((uint32_t *) scrap_buffer.data())[ii * channels + 1] / 2147483648.0 - 1.0);
-						break;
-					case AudioDecoder::Format::F32:
-						vall *= (((float *) scrap_buffer.data())[ii * channels]);
-						valr *= (((float *) scrap_buffer.data())[ii * channels + 1]);
-						break;
-				}
-
-				if (!channel_active) {
-					// first channel
-					mixer_buffer[ii * output_format.channels] = vall;
-					if (channels > 1) {
-						mixer_buffer[ii * output_format.channels + 1] = valr;
-					} else {
-						mixer_buffer[ii * output_format.channels + 1] = mixer_buffer[ii * output_format.channels];
-					}
-				} else {
-					mixer_buffer[ii * output_format.channels] += vall;
-					if (channels > 1) {
-						mixer_buffer[ii * output_format.channels + 1] += valr;
-					} else {
-						mixer_buffer[ii * output_format.channels + 1] = mixer_buffer[ii * output_format.channels];
-					}
-				}
-
+			const int frames = read_bytes / (samplesize * channels);
+			MixSamples(mixer_buffer.data(), scrap_buffer.data(), sampleformat, frames, channels, volume, !channel_active);
+			if (!channel_active) {
+				// The first channel may end before the buffer is full
+				std::fill(mixer_buffer.begin() + frames * 2, mixer_buffer.end(), 0.0f);
 			}
 			channel_active = true;
 		}
 	}
 
 	if (channel_active) {
+		const int num_samples = samples_per_frame * 2;
 		if (total_volume > 1.0) {
-			float threshold = 0.8;
-			for (unsigned i = 0; i < (unsigned)(samples_per_frame * 2); i++) {
+			const float threshold = 0.8f;
+			const float ratio = (1.0f - threshold) / (total_volume - threshold);
+			for (int i = 0; i < num_samples; i++) {
 				float sample = mixer_buffer[i];
-				float sign = (sample < 0) ? -1.0 : 1.0;
-				sample /= sign;
+				const float magnitude = std::abs(sample);
 				//dynamic range compression
-				if (sample > threshold) {
-					sample_buffer[i] = sign * 32768.0 * (threshold + (1.0 - threshold) * (sample - threshold) / (total_volume - threshold));
-				} else {
-					sample_buffer[i] = sign * sample * 32768.0;
+				if (magnitude > threshold) {
+					sample = std::copysign(threshold + (magnitude - threshold) * ratio, sample);
 				}
-			}
-		} else {
-			//No dynamic range compression necessary
-			for (unsigned i = 0; i < (unsigned)(samples_per_frame * 2); i++) {
-				sample_buffer[i] = mixer_buffer[i] * 32768.0;
+				mixer_buffer[i] = sample;
 			}
 		}
 
+		AudioSimd::ToS16(sample_buffer.data(), mixer_buffer.data(), num_samples);
+
 		memcpy(output_buffer, sample_buffer.data(), buffer_length);
 	} else {
 		memset(output_buffer, '\0', buffer_length);
 	}
+
+	Capture::OnAudio(output_buffer, buffer_length, output_format.frequency, output_format.channels);
 }
@@ -18,9 +18,18 @@
 #ifndef EP_AUDIO_GENERIC_H
 #define EP_AUDIO_GENERIC_H
 
+#include <atomic>
+#ifdef HAVE_THREADS
+#  include <condition_variable>
+#  include <mutex>
+#  include <thread>
+#endif
 #include "audio.h"
 #include "audio_decoder.h"
+#include "audio_ring_buffer.h"
+#include "audio_se_limiter.h"
 #include "audio_secache.h"
+#include "game_clock.h"
 
 /**
  * A software implementation for handling EasyRPG Audio utilizing the
@@ -35,6 +44,9 @@
  * 4. Implement LockMutex and UnlockMutex. Locking and Unlocking when
  *    calling Decode must be done manually.
  * 5. Implement update function (optional)
+ *
+ * When threads are available the BGM is decoded by a worker thread into a
+ * ring buffer per channel, the Decode function only mixes the ready samples.
  */
 struct GenericAudio : public AudioInterface {
 public:
@@ -51,9 +63,11 @@ public:
 	void BGM_Fade(int fade) override;
 	void BGM_Volume(int volume) override;
 	void BGM_Pitch(int pitch) override;
+	void BGM_Prefetch(std::string const& file) override;
 	void SE_Play(std::string const& file, int volume, int pitch) override;
 	void SE_Stop() override;
 	virtual void Update() override;
+	Stats GetStats() const override;
 
 	void SetFormat(int frequency, AudioDecoder::Format format, int channels);
 
@@ -63,10 +77,36 @@ public:
 	void Decode(uint8_t* output_buffer, int buffer_length);
 
 private:
+#ifdef HAVE_THREADS
+	/** BGM opened by DecodeBgm */
+	struct BgmRequest {
+		Filesystem_Stream::InputStream stream;
+		std::string file;
+		int volume = 0;
+		int pitch = 100;
+		int fadein = 0;
+		/** BGM_Fade was called before the decoder was opened */
+		int fadeout = -1;
+	};
+#endif
 	struct BgmChannel {
 		std::unique_ptr<AudioDecoder> decoder;
-		bool paused;
-		bool stopped;
+		std::atomic<bool> paused;
+		std::atomic<bool> stopped;
+#ifdef HAVE_THREADS
+		/** Decoded stereo samples with the volume applied */
+		AudioRingBuffer samples;
+		/** Volume of the samples in the buffer */
+		std::atomic<float> volume;
+		/** A new decoder was set, the samples of the old one are discarded by Decode */
+		std::atomic<bool> flush;
+		/** The last Decode call read a full buffer, only used by Decode */
+		bool filled = false;
+		/** BGM to open, the channel has no decoder yet */
+		std::unique_ptr<BgmRequest> request;
+		/** Changes with every request, a decoder opened for an old one is discarded */
+		unsigned request_id = 0;
+#endif
 	};
 	struct SeChannel {
 		std::unique_ptr<AudioDecoder> decoder;
@@ -81,6 +121,20 @@ private:
 	};
 	Format output_format = {};
 
+	/** Locks the BGM decoders against the thread decoding them */
+	void LockBgm() const;
+	void UnlockBgm() const;
+
+	/** @return whether the channel has a decoder or is about to get one */
+	static bool IsBgmUsed(const BgmChannel& chan);
+
+	/**
+	 * Opens a BGM decoder, converting to the output format and looping.
+	 *
+	 * @return decoder or null when the format is not supported
+	 */
+	std::unique_ptr<AudioDecoder> OpenBgm(Filesystem_Stream::InputStream stream, const std::string& file, int pitch) const;
+
 	bool PlayOnChannel(BgmChannel& chan,std::string const& file, int volume, int pitch, int fadein);
 	bool PlayOnChannel(SeChannel& chan,std::string const& file, int volume, int pitch);
 
@@ -96,6 +150,37 @@ private:
 	static std::vector<uint8_t> scrap_buffer;
 	static unsigned scrap_buffer_size;
 	static std::vector<float> mixer_buffer;
+
+	/** Voice ids are indices into SE_Channels */
+	AudioSeLimiter se_limiter;
+
+	/** Frames requested by the last Decode call */
+	std::atomic<int> output_frames{0};
+	std::atomic<int> underruns{0};
+	/** Start of the last Decode call, only used by Decode */
+	Game_Clock::time_point last_decode_time;
+
+#ifdef HAVE_THREADS
+	/** Fills the ring buffers of the BGM channels until the audio is destroyed */
+	void DecodeBgm();
+
+	std::thread bgm_thread;
+	mutable std::mutex bgm_mutex;
+	std::condition_variable bgm_cv;
+	bool bgm_quit = false;
+	/** Frames requested by the last Decode call */
+	std::atomic<int> bgm_chunk_frames{0};
+	/** Chunks decoded in advance in addition to bgm_buffer_chunks, grows after underruns */
+	std::atomic<int> bgm_extra_chunks{0};
+	std::vector<uint8_t> bgm_decode_buffer;
+	std::vector<float> bgm_chunk;
+
+	/** BGM to open for BGM_Prefetch */
+	std::unique_ptr<BgmRequest> bgm_prefetch_request;
+	/** File of the prefetched decoder, set while it is opened */
+	std::string bgm_prefetched_file;
+	std::unique_ptr<AudioDecoder> bgm_prefetched;
+#endif
 };
 
 #endif
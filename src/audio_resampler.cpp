@@ -19,6 +19,7 @@
 
 #ifdef USE_AUDIO_RESAMPLER
 
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 #include "audio_resampler.h"
@@ -202,6 +203,10 @@ AudioResampler::AudioResampler(std::unique_ptr<AudioDecoder> wrapped, AudioResam
 			case Quality::High:
 				sampling_quality = 5;
 				break;
+			case Quality::Fast:
+				sampling_quality = 0;
+				linear = true;
+				break;
 		}
 	#elif defined(HAVE_LIBSAMPLERATE)
 		switch (quality) {
@@ -214,6 +219,10 @@ AudioResampler::AudioResampler(std::unique_ptr<AudioDecoder> wrapped, AudioResam
 			case Quality::High:
 				sampling_quality = SRC_SINC_BEST_QUALITY;
 				break;
+			case Quality::Fast:
+				sampling_quality = SRC_LINEAR;
+				linear = true;
+				break;
 		}
 	#endif
 
@@ -253,6 +262,18 @@ bool AudioResampler::Open(Filesystem_Stream::InputStream stream) {
 		wrapped_decoder->GetFormat(input_rate, input_format, nr_of_channels);
 		output_rate = input_rate;
 
+		//Init the conversion data structure
+		conversion_data.input_frames = 0;
+		conversion_data.input_frames_used = 0;
+		linear_pos = 0.0;
+		linear_frames = 0;
+		finished = false;
+
+		if (linear) {
+			// No library state needed
+			return true;
+		}
+
 		#if defined(HAVE_LIBSPEEXDSP)
 			conversion_state = speex_resampler_init(nr_of_channels, input_rate, output_rate, sampling_quality, &lasterror);
 			conversion_data.ratio_num = input_rate;
@@ -262,11 +283,6 @@ bool AudioResampler::Open(Filesystem_Stream::InputStream stream) {
 			conversion_state = src_new(sampling_quality, nr_of_channels, &lasterror);
 		#endif
 
-		//Init the conversion data structure
-		conversion_data.input_frames = 0;
-		conversion_data.input_frames_used = 0;
-		finished = false;
-
 		if (conversion_state)
 			return true;
 	}
@@ -280,12 +296,16 @@ bool AudioResampler::Seek(std::streamoff offset, std::ios_base::seekdir origin)
 		//reset conversion data
 		conversion_data.input_frames = 0;
 		conversion_data.input_frames_used = 0;
+		linear_pos = 0.0;
+		linear_frames = 0;
 		finished = wrapped_decoder->IsFinished();
+		if (conversion_state) {
 		#if defined(HAVE_LIBSPEEXDSP)
 			speex_resampler_reset_mem(conversion_state);
 		#elif defined(HAVE_LIBSAMPLERATE)
 			src_reset(conversion_state);
 		#endif
+		}
 		return true;
 	}
 	return false;
@@ -357,6 +377,8 @@ int AudioResampler::FillBuffer(uint8_t* buffer, int length) {
 	if ((input_rate == output_rate) && ((pitch == STANDARD_PITCH) || pitch_handled_by_decoder)) {
 		// Do only format conversion
 		amount_filled = FillBufferSameRate(buffer, bytes_to_read);
+	} else if (linear) {
+		amount_filled = FillBufferLinear(buffer, bytes_to_read);
 	} else {
 		if (!conversion_state) {
 			error_message = "internal error: state pointer is a nullptr";
@@ -583,4 +605,68 @@ int AudioResampler::FillBufferDifferentRate(uint8_t* buffer, int length) {
 	return length;
 }
 
+int AudioResampler::FillBufferLinear(uint8_t* buffer, int length) {
+	const int input_samplesize = GetSamplesizeForFormat(input_format);
+	const int output_samplesize = GetSamplesizeForFormat(output_format);
+	// The input is converted to float in the internal_buffer
+	float* input = reinterpret_cast<float*>(internal_buffer);
+	const int capacity = sizeof(internal_buffer) / (sizeof(float) * nr_of_channels);
+
+	double step = static_cast<double>(input_rate) / output_rate;
+	if (!pitch_handled_by_decoder) {
+		step = step * pitch / STANDARD_PITCH;
+	}
+
+	const int total_output_frames = length / (output_samplesize * nr_of_channels);
+	float* out_float = reinterpret_cast<float*>(buffer);
+	int16_t* out_int16 = reinterpret_cast<int16_t*>(buffer);
+
+	int frames = 0;
+	while (frames < total_output_frames) {
+		const int index = static_cast<int>(linear_pos);
+
+		if (index + 1 >= linear_frames) {
+			// Interpolating needs the frame after index: Drop the consumed frames and decode more
+			const int consumed = std::min(index, linear_frames);
+			memmove(input, input + consumed * nr_of_channels, (linear_frames - consumed) * nr_of_channels * sizeof(float));
+			linear_frames -= consumed;
+			linear_pos -= consumed;
+
+			const int samples_read = DecodeAndConvertFloat(wrapped_decoder.get(),
+				reinterpret_cast<uint8_t*>(input + linear_frames * nr_of_channels),
+				(capacity - linear_frames) * nr_of_channels, input_samplesize, input_format);
+			if (samples_read < 0) {
+				error_message = wrapped_decoder->GetError();
+				return samples_read;
+			}
+			if (samples_read == 0) {
+				finished = true;
+				break;
+			}
+			linear_frames += samples_read / nr_of_channels;
+			continue;
+		}
+
+		const float frac = static_cast<float>(linear_pos - index);
+		const float* cur = input + index * nr_of_channels;
+		const float* next = cur + nr_of_channels;
+
+		if (output_format == Format::F32) {
+			for (int c = 0; c < nr_of_channels; ++c) {
+				out_float[frames * nr_of_channels + c] = cur[c] + (next[c] - cur[c]) * frac;
+			}
+		} else {
+			for (int c = 0; c < nr_of_channels; ++c) {
+				const float sample = (cur[c] + (next[c] - cur[c]) * frac) * 32768.0f;
+				out_int16[frames * nr_of_channels + c] = static_cast<int16_t>(std::min(std::max(sample, -32768.0f), 32767.0f));
+			}
+		}
+
+		++frames;
+		linear_pos += step;
+	}
+
+	return frames * nr_of_channels * output_samplesize;
+}
+
 #endif
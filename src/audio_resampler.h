@@ -41,7 +41,9 @@ public:
 	enum class Quality {
 		High,
 		Medium,
-		Low
+		Low,
+		/** Linear interpolation without the library, for pitch shifted sound effects */
+		Fast
 	};
 	
 	/**
@@ -168,6 +170,11 @@ private:
 	 * Internally used by the FillBuffer function if resampling is necessary
 	 */
 	int FillBufferDifferentRate(uint8_t* buffer, int length);
+
+	/**
+	 * Internally used by the FillBuffer function if resampling is necessary in Fast quality
+	 */
+	int FillBufferLinear(uint8_t* buffer, int length);
 	
 	std::unique_ptr<AudioDecoder> wrapped_decoder;
 	bool pitch_handled_by_decoder = false;
@@ -202,6 +209,13 @@ private:
 	uint8_t internal_buffer[256*sizeof(float)];
 
 	bool mono_to_stereo_resample = false;
+
+	/** Quality::Fast, resamples with FillBufferLinear */
+	bool linear = false;
+	/** Position in the input frames in internal_buffer */
+	double linear_pos = 0.0;
+	/** Number of input frames in internal_buffer */
+	int linear_frames = 0;
 };
 
 #endif
@@ -0,0 +1,74 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include <algorithm>
+#include "audio_ring_buffer.h"
+
+void AudioRingBuffer::Resize(size_t capacity) {
+	data.assign(capacity, 0.0f);
+	read_pos.store(0, std::memory_order_relaxed);
+	write_pos.store(0, std::memory_order_relaxed);
+}
+
+size_t AudioRingBuffer::GetReadAvailable() const {
+	return write_pos.load(std::memory_order_acquire) - read_pos.load(std::memory_order_relaxed);
+}
+
+size_t AudioRingBuffer::GetWriteAvailable() const {
+	return data.size() - (write_pos.load(std::memory_order_relaxed) - read_pos.load(std::memory_order_acquire));
+}
+
+size_t AudioRingBuffer::Write(const float* samples, size_t count) {
+	if (data.empty()) {
+		return 0;
+	}
+
+	const size_t write = write_pos.load(std::memory_order_relaxed);
+	const size_t read = read_pos.load(std::memory_order_acquire);
+	count = std::min(count, data.size() - (write - read));
+
+	const size_t start = write % data.size();
+	const size_t first = std::min(count, data.size() - start);
+	std::copy(samples, samples + first, data.begin() + start);
+	std::copy(samples + first, samples + count, data.begin());
+
+	write_pos.store(write + count, std::memory_order_release);
+	return count;
+}
+
+size_t AudioRingBuffer::Read(float* samples, size_t count) {
+	if (data.empty()) {
+		return 0;
+	}
+
+	const size_t read = read_pos.load(std::memory_order_relaxed);
+	const size_t write = write_pos.load(std::memory_order_acquire);
+	count = std::min(count, write - read);
+
+	const size_t start = read % data.size();
+	const size_t first = std::min(count, data.size() - start);
+	std::copy(data.begin() + start, data.begin() + start + first, samples);
+	std::copy(data.begin(), data.begin() + (count - first), samples + first);
+
+	read_pos.store(read + count, std::memory_order_release);
+	return count;
+}
+
+void AudioRingBuffer::Clear() {
+	read_pos.store(write_pos.load(std::memory_order_acquire), std::memory_order_release);
+}
@@ -0,0 +1,83 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_AUDIO_RING_BUFFER_H
+#define EP_AUDIO_RING_BUFFER_H
+
+// Headers
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+/**
+ * Ring buffer of float samples without locks. One thread may write and
+ * another one read at the same time.
+ */
+class AudioRingBuffer {
+public:
+	AudioRingBuffer() = default;
+
+	/**
+	 * Changes the capacity and discards all samples.
+	 * Must not be called while other threads use the buffer.
+	 *
+	 * @param capacity number of samples the buffer holds
+	 */
+	void Resize(size_t capacity);
+
+	/** @return number of samples the buffer holds */
+	size_t GetCapacity() const;
+
+	/** @return number of samples that can be read */
+	size_t GetReadAvailable() const;
+
+	/** @return number of samples that can be written */
+	size_t GetWriteAvailable() const;
+
+	/**
+	 * Appends samples, only called by the writing thread.
+	 *
+	 * @param samples samples to append
+	 * @param count number of samples
+	 * @return number of samples written, less than count when the buffer is full
+	 */
+	size_t Write(const float* samples, size_t count);
+
+	/**
+	 * Removes samples from the front, only called by the reading thread.
+	 *
+	 * @param samples filled with the samples
+	 * @param count maximum number of samples
+	 * @return number of samples read
+	 */
+	size_t Read(float* samples, size_t count);
+
+	/** Discards all samples, only called by the reading thread */
+	void Clear();
+
+private:
+	std::vector<float> data;
+	// Increase forever, the index into data is the position modulo the capacity
+	std::atomic<size_t> read_pos{0};
+	std::atomic<size_t> write_pos{0};
+};
+
+inline size_t AudioRingBuffer::GetCapacity() const {
+	return data.size();
+}
+
+#endif
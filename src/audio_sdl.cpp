@@ -75,7 +75,7 @@ SdlAudio::SdlAudio() :
 	want.freq = 44100;
 	want.format = AUDIO_S16;
 	want.channels = 2;
-	want.samples = 2048;
+	want.samples = static_cast<Uint16>(GetBufferSize(2048));
 	want.callback = sdl_audio_callback;
 	want.userdata = this;
 
@@ -231,11 +231,13 @@ SdlMixerAudio::SdlMixerAudio() :
 	int const frequency = 44100;
 #endif
 
+	buffer_frames = GetBufferSize(2048);
+
 #if SDL_MIXER_MAJOR_VERSION > 2 || (SDL_MIXER_MAJOR_VERSION == 2 && SDL_MIXER_PATCHLEVEL >= 2)
-	bool init_success = Mix_OpenAudioDevice(frequency, MIX_DEFAULT_FORMAT, MIX_DEFAULT_CHANNELS, 2048,
+	bool init_success = Mix_OpenAudioDevice(frequency, MIX_DEFAULT_FORMAT, MIX_DEFAULT_CHANNELS, buffer_frames,
 		NULL, SDL_AUDIO_ALLOW_FREQUENCY_CHANGE) >= 0;
 #else
-	bool init_success = Mix_OpenAudio(frequency, MIX_DEFAULT_FORMAT, MIX_DEFAULT_CHANNELS, 2048) >= 0;
+	bool init_success = Mix_OpenAudio(frequency, MIX_DEFAULT_FORMAT, MIX_DEFAULT_CHANNELS, buffer_frames) >= 0;
 #endif
 
 	if (!init_success) {
@@ -625,6 +627,14 @@ void SdlMixerAudio::BGS_Volume(int volume) {
 }
 
 void SdlMixerAudio::SE_Play(std::string const& file, int volume, int pitch) {
+	const int frame = Game_Clock::GetFrame();
+	se_limiter.RemoveFinished([](int channel) { return Mix_Playing(channel) != 0; });
+
+	auto decision = se_limiter.Request(file, frame);
+	if (decision.action == AudioSeLimiter::Action::Drop) {
+		return;
+	}
+
 	std::unique_ptr<AudioSeCache> cache = AudioSeCache::Create(file);
 	sound_data snd_data;
 
@@ -663,7 +673,18 @@ void SdlMixerAudio::SE_Play(std::string const& file, int volume, int pitch) {
 		}
 	}
 
-	int channel = Mix_PlayChannel(-1, snd_data.chunk.get(), 0);
+	if (decision.action == AudioSeLimiter::Action::Retrigger) {
+		Mix_HaltChannel(decision.voice);
+	}
+	int channel = Mix_PlayChannel(decision.voice, snd_data.chunk.get(), 0);
+	if (channel == -1 && decision.voice == -1) {
+		// All channels are busy: Replace the SE that plays the longest
+		int oldest = se_limiter.GetOldest();
+		if (oldest >= 0) {
+			Mix_HaltChannel(oldest);
+			channel = Mix_PlayChannel(oldest, snd_data.chunk.get(), 0);
+		}
+	}
 	Mix_Volume(channel, volume * MIX_MAX_VOLUME / 100);
 	if (channel == -1) {
 		// FIXME Not displaying as warning because multiple games exhaust free channels available, see #1356
@@ -671,6 +692,7 @@ void SdlMixerAudio::SE_Play(std::string const& file, int volume, int pitch) {
 		return;
 	}
 	sounds[channel] = std::move(snd_data);
+	se_limiter.Start(channel, file, frame);
 }
 
 void SdlMixerAudio::SE_Stop() {
@@ -678,6 +700,7 @@ void SdlMixerAudio::SE_Stop() {
 		if (Mix_Playing(sound.first)) Mix_HaltChannel(sound.first);
 	}
 	sounds.clear();
+	se_limiter.Clear();
 }
 
 void SdlMixerAudio::Update() {
@@ -689,6 +712,16 @@ void SdlMixerAudio::Update() {
 	}
 }
 
+AudioInterface::Stats SdlMixerAudio::GetStats() const {
+	Stats stats;
+	Uint16 format;
+	int channels;
+	if (Mix_QuerySpec(&stats.frequency, &format, &channels)) {
+		stats.buffer_frames = buffer_frames;
+	}
+	return stats;
+}
+
 AudioDecoder* SdlMixerAudio::GetDecoder() {
 	return audio_decoder.get();
 }
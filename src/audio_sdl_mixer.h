@@ -23,6 +23,7 @@
 
 #include "audio.h"
 #include "audio_decoder.h"
+#include "audio_se_limiter.h"
 #include "audio_secache.h"
 #include "game_clock.h"
 
@@ -55,6 +56,7 @@ public:
 	void SE_Play(std::string const&, int, int) override;
 	void SE_Stop() override;
 	void Update() override;
+	Stats GetStats() const override;
 
 	void BGM_OnPlayedOnce();
 
@@ -71,6 +73,8 @@ private:
 	bool bgs_playing = false;
 	bool bgs_stop = true;
 	bool played_once = false;
+	/** Chunk size passed to the mixer */
+	int buffer_frames = 0;
 
 	struct sound_data {
 		sound_data() = default;
@@ -86,6 +90,8 @@ private:
 
 	typedef std::map<int, sound_data> sounds_type;
 	sounds_type sounds;
+	/** Voice ids are mixer channels */
+	AudioSeLimiter se_limiter;
 
 	std::unique_ptr<AudioDecoder> audio_decoder;
 	SDL_AudioCVT cvt;
@@ -0,0 +1,72 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include "audio_se_limiter.h"
+
+constexpr int AudioSeLimiter::max_instances;
+
+AudioSeLimiter::Decision AudioSeLimiter::Request(const std::string& file, int frame) const {
+	Decision decision;
+
+	int instances = 0;
+	const Voice* oldest = nullptr;
+	for (auto& voice : voices) {
+		if (voice.file != file) {
+			continue;
+		}
+		if (voice.frame == frame) {
+			// Started twice in the same frame: Only louder and clips
+			decision.action = Action::Drop;
+			return decision;
+		}
+		++instances;
+		if (!oldest || voice.order < oldest->order) {
+			oldest = &voice;
+		}
+	}
+
+	if (instances >= max_instances) {
+		decision.action = Action::Retrigger;
+		decision.voice = oldest->id;
+	}
+
+	return decision;
+}
+
+void AudioSeLimiter::Start(int voice, const std::string& file, int frame) {
+	Stop(voice);
+	voices.push_back({ voice, file, frame, next_order++ });
+}
+
+void AudioSeLimiter::Stop(int voice) {
+	RemoveFinished([voice](int id) { return id != voice; });
+}
+
+void AudioSeLimiter::Clear() {
+	voices.clear();
+}
+
+int AudioSeLimiter::GetOldest() const {
+	const Voice* oldest = nullptr;
+	for (auto& voice : voices) {
+		if (!oldest || voice.order < oldest->order) {
+			oldest = &voice;
+		}
+	}
+	return oldest ? oldest->id : -1;
+}
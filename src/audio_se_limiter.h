@@ -0,0 +1,111 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_AUDIO_SE_LIMITER_H
+#define EP_AUDIO_SE_LIMITER_H
+
+// Headers
+#include <string>
+#include <vector>
+
+/**
+ * Decides on which voice of an audio backend a sound effect plays.
+ * Limits how often the same SE plays at once and which voice is
+ * reused when all of them are busy. Voices are identified by an id
+ * chosen by the backend, e.g. the channel number.
+ */
+class AudioSeLimiter {
+public:
+	/** Instances of the same SE that may play at the same time */
+	static constexpr int max_instances = 4;
+
+	enum class Action {
+		/** Play on a free voice */
+		Play,
+		/** Ignore the SE, it started already in this frame */
+		Drop,
+		/** Restart the SE on the voice of its oldest instance */
+		Retrigger
+	};
+
+	struct Decision {
+		Action action = Action::Play;
+		/** Voice to restart for Action::Retrigger, otherwise -1 */
+		int voice = -1;
+	};
+
+	/**
+	 * Decides how a new SE is played.
+	 * Call RemoveFinished before to forget voices that stopped.
+	 *
+	 * @param file SE file
+	 * @param frame current frame number
+	 * @return what the backend shall do
+	 */
+	Decision Request(const std::string& file, int frame) const;
+
+	/**
+	 * Records that a SE started on a voice.
+	 *
+	 * @param voice voice id
+	 * @param file SE file
+	 * @param frame current frame number
+	 */
+	void Start(int voice, const std::string& file, int frame);
+
+	/** Forgets the SE playing on the voice */
+	void Stop(int voice);
+
+	/** Forgets all voices */
+	void Clear();
+
+	/** @return voice that started first or -1 when none plays */
+	int GetOldest() const;
+
+	/**
+	 * Forgets all voices that finished playing.
+	 *
+	 * @param is_playing called with a voice id, returns whether it still plays
+	 */
+	template <typename F>
+	void RemoveFinished(F&& is_playing);
+
+private:
+	struct Voice {
+		int id;
+		std::string file;
+		int frame;
+		unsigned order;
+	};
+
+	std::vector<Voice> voices;
+	unsigned next_order = 0;
+};
+
+template <typename F>
+inline void AudioSeLimiter::RemoveFinished(F&& is_playing) {
+	for (size_t i = 0; i < voices.size();) {
+		if (!is_playing(voices[i].id)) {
+			voices[i] = std::move(voices.back());
+			voices.pop_back();
+		} else {
+			++i;
+		}
+	}
+}
+
+#endif
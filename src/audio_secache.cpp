@@ -16,6 +16,7 @@
  */
 
 // Headers
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 #include <map>
@@ -23,42 +24,69 @@
 #include "audio_resampler.h"
 #include "audio_secache.h"
 #include "game_clock.h"
+#include "memory_stats.h"
 #include "filefinder.h"
 #include "output.h"
 
-using namespace std::chrono_literals;
-
 namespace {
 	typedef std::map<std::string, AudioSeRef> cache_type;
 
 	cache_type cache;
 
-	constexpr int cache_limit = 3 * 1024 * 1024;
-	int cache_size = 0;
+#if defined(_3DS) || defined(PSP2)
+	constexpr int64_t cache_limit = 1 * 1024 * 1024;
+#else
+	constexpr int64_t cache_limit = 3 * 1024 * 1024;
+#endif
+	int64_t cache_size = 0;
+
+	AudioSeCache::Stats stats;
+
+	/** @return Whether a decoder still references the sample or its converted copy */
+	bool IsPlaying(const AudioSeRef& se) {
+		return se.use_count() > 1 || (se->converted && se->converted.use_count() > 1);
+	}
 
-	void FreeCacheMemory() {
-		auto cur_time = Game_Clock::GetFrameTime();
+	int64_t GetMemorySize(const AudioSeData& se) {
+		int64_t size = se.buffer.size();
+		if (se.converted) {
+			size += se.converted->buffer.size();
+		}
+		return size;
+	}
 
-		for (auto it = cache.begin(); it != cache.end(); ) {
-			if (it->second.use_count() > 1) {
-				// SE is currently playing
-				++it;
-				continue;
+	void FreeCacheMemory(int64_t limit = cache_limit) {
+		if (cache_size <= limit) {
+			return;
+		}
+
+		// Free the least recently used samples first, playing ones are pinned
+		std::vector<cache_type::iterator> unused;
+		for (auto it = cache.begin(); it != cache.end(); ++it) {
+			if (!IsPlaying(it->second)) {
+				unused.push_back(it);
 			}
+		}
 
-			if (cache_size <= cache_limit && cur_time - it->second->last_access < 3s) {
-				// Below memory limit and last access < 3s
-				++it;
-				continue;
+		std::sort(unused.begin(), unused.end(), [](const cache_type::iterator& l, const cache_type::iterator& r) {
+			return l->second->last_access < r->second->last_access;
+		});
+
+		for (auto& it: unused) {
+			if (cache_size <= limit) {
+				break;
 			}
 
 #ifdef CACHE_DEBUG
 			Output::Debug("SE: Freeing memory of {}", it->first);
 #endif
 
-			cache_size -= it->second->buffer.size();
+			const int64_t size = GetMemorySize(*it->second);
+			cache_size -= size;
+			MemoryStats::Add(MemoryStats::Category::Audio, -size);
+			++stats.evictions;
 
-			it = cache.erase(it);
+			cache.erase(it);
 		}
 
 #ifdef CACHE_DEBUG
@@ -132,27 +160,18 @@ bool AudioSeCache::GetCachedFormat(int& frequency, AudioDecoder::Format& format,
 	return false;
 }
 
-std::unique_ptr<AudioDecoder> AudioSeCache::CreateSeDecoder() {
-	AudioSeRef se;
-
-	if (IsCached()) {
-		se = cache.find(filename)->second;
-		se->last_access = Game_Clock::GetFrameTime();
-
-		std::unique_ptr<AudioDecoder> dec = std::make_unique<AudioSeDecoder>(se);
-#ifdef USE_AUDIO_RESAMPLER
-		dec = std::make_unique<AudioResampler>(std::move(dec));
-#endif
-		Filesystem_Stream::InputStream is;
-		dec->Open(std::move(is));
-		return dec;
+AudioSeRef AudioSeCache::Decode() {
+	auto it = cache.find(filename);
+	if (it != cache.end()) {
+		it->second->last_access = Game_Clock::GetFrameTime();
+		++stats.hits;
+		return it->second;
 	}
+	++stats.misses;
 
 	// Not cached yet: Decode the sample without any resampling
-
-	if (!se) {
-		se.reset(new AudioSeData());
-	}
+	AudioSeRef se = std::make_shared<AudioSeData>();
+	se->last_access = Game_Clock::GetFrameTime();
 
 	assert(audio_decoder);
 
@@ -162,6 +181,7 @@ std::unique_ptr<AudioDecoder> AudioSeCache::CreateSeDecoder() {
 	cache.insert(std::make_pair(filename, se));
 
 	cache_size += se->buffer.size();
+	MemoryStats::Add(MemoryStats::Category::Audio, se->buffer.size());
 
 #ifdef CACHE_DEBUG
 	Output::Debug("SE cache size (Add): {}", cache_size / 1024.0 / 1024.0);
@@ -169,12 +189,69 @@ std::unique_ptr<AudioDecoder> AudioSeCache::CreateSeDecoder() {
 
 	FreeCacheMemory();
 
-	std::unique_ptr<AudioDecoder> dec = std::unique_ptr<AudioDecoder>(new AudioSeDecoder(se));
+	return se;
+}
+
+std::unique_ptr<AudioDecoder> AudioSeCache::CreateSeDecoder() {
+	std::unique_ptr<AudioDecoder> dec = std::make_unique<AudioSeDecoder>(Decode());
+#ifdef USE_AUDIO_RESAMPLER
+	dec = std::make_unique<AudioResampler>(std::move(dec));
+#endif
+	Filesystem_Stream::InputStream is;
+	dec->Open(std::move(is));
+	return dec;
+}
+
+std::unique_ptr<AudioDecoder> AudioSeCache::CreateSeDecoder(int frequency, AudioDecoder::Format format, int channels, int pitch) {
+#ifdef USE_AUDIO_RESAMPLER
+	if (pitch == 100) {
+		AudioSeRef se = Decode();
+		auto& converted = se->converted;
+
+		// The resampler may not support the requested format and picks another one,
+		// compare with the request to not convert again on every play
+		if (!converted || se->converted_frequency != frequency ||
+				se->converted_format != format || se->converted_channels != channels) {
+			if (converted) {
+				cache_size -= converted->buffer.size();
+				MemoryStats::Add(MemoryStats::Category::Audio, -static_cast<int64_t>(converted->buffer.size()));
+			}
+
+			AudioResampler resampler(std::make_unique<AudioSeDecoder>(se));
+			Filesystem_Stream::InputStream is;
+			resampler.Open(std::move(is));
+			resampler.SetFormat(frequency, format, channels);
+
+			converted = std::make_shared<AudioSeData>();
+			resampler.GetFormat(converted->frequency, converted->format, converted->channels);
+			converted->buffer = resampler.DecodeAll();
+
+			se->converted_frequency = frequency;
+			se->converted_format = format;
+			se->converted_channels = channels;
+
+			cache_size += converted->buffer.size();
+			MemoryStats::Add(MemoryStats::Category::Audio, converted->buffer.size());
+
+			FreeCacheMemory();
+		}
+
+		std::unique_ptr<AudioDecoder> dec = std::make_unique<AudioSeDecoder>(converted);
+		Filesystem_Stream::InputStream is;
+		dec->Open(std::move(is));
+		return dec;
+	}
+#endif
+
+	std::unique_ptr<AudioDecoder> dec = std::make_unique<AudioSeDecoder>(Decode());
 #ifdef USE_AUDIO_RESAMPLER
-	dec = std::unique_ptr<AudioDecoder>(new AudioResampler(std::move(dec)));
+	// Pitch shifted sound effects are resampled on every play, interpolate cheaply
+	dec = std::make_unique<AudioResampler>(std::move(dec), AudioResampler::Quality::Fast);
 #endif
 	Filesystem_Stream::InputStream is;
 	dec->Open(std::move(is));
+	dec->SetPitch(pitch);
+	dec->SetFormat(frequency, format, channels);
 	return dec;
 }
 
@@ -184,9 +261,35 @@ AudioSeRef AudioSeCache::GetSeData() const {
     return cache.find(filename)->second;
 };
 
+bool AudioSeCache::Prefetch(const std::string& filename) {
+	auto se = Create(filename);
+	if (!se) {
+		return false;
+	}
+
+	if (!se->IsCached()) {
+		se->Decode();
+		FreeCacheMemory();
+	}
+	return true;
+}
+
+AudioSeCache::Stats AudioSeCache::GetStats() {
+	auto result = stats;
+	result.bytes = cache_size;
+	return result;
+}
+
 void AudioSeCache::Clear() {
+	MemoryStats::Add(MemoryStats::Category::Audio, -cache_size);
 	cache_size = 0;
 	cache.clear();
+	// The files may be replaced, e.g. by another game
+	AudioDecoder::ClearDetectedTypes();
+}
+
+void AudioSeCache::Trim(int64_t bytes) {
+	FreeCacheMemory(bytes);
 }
 
 AudioSeDecoder::AudioSeDecoder(AudioSeRef se) :
@@ -40,6 +40,13 @@ public:
 	int frequency;
 	AudioDecoder::Format format;
 	int channels;
+
+	/** Copy of the sample already converted to the output format at normal pitch, can be null */
+	std::shared_ptr<AudioSeData> converted;
+	/** Output format requested for the converted copy */
+	int converted_frequency = 0;
+	AudioDecoder::Format converted_format = AudioDecoder::Format::S16;
+	int converted_channels = 0;
 };
 
 typedef std::shared_ptr<AudioSeData> AudioSeRef;
@@ -69,12 +76,25 @@ private:
  * AudioSeCache provides an interface for accessing sound effects.
  * It also provides an automatic cache management, any SE is only decoded
  * once, otherwise returned from the cache.
- * The cache is flushed from recently (>10 seconds by default) unused
- * samples when it reaches the memory limit (5 MB by default).
+ * When the cache exceeds the memory limit (3 MB, 1 MB on 3DS and Vita) the
+ * least recently used samples are freed. Samples that are still playing
+ * are never freed.
  * Uses an internal AudioDecoder for handling the decoding.
  */
 class AudioSeCache {
 public:
+	/** Cache statistics since startup */
+	struct Stats {
+		/** Samples found in the cache */
+		int hits = 0;
+		/** Samples that had to be decoded */
+		int misses = 0;
+		/** Samples freed to stay below the memory limit */
+		int evictions = 0;
+		/** Size of the cached samples and their converted copies */
+		int64_t bytes = 0;
+	};
+
 	/**
 	 * Opens the passed filename with the internal audio decoder.
 	 *
@@ -123,6 +143,19 @@ public:
 	 */
 	std::unique_ptr<AudioDecoder> CreateSeDecoder();
 
+	/**
+	 * Like CreateSeDecoder but the returned decoder outputs the requested format.
+	 * At a pitch of 100 the sample is converted only once, the converted copy
+	 * is cached and later plays copy from it without resampling again.
+	 *
+	 * @param frequency Output frequency
+	 * @param format Output format
+	 * @param channels Output channels
+	 * @param pitch Pitch multiplier
+	 * @return Decoded sound effect
+	 */
+	std::unique_ptr<AudioDecoder> CreateSeDecoder(int frequency, AudioDecoder::Format format, int channels, int pitch);
+
 	/**
 	 * Returns the SE sample data handled by this SeCache.
 	 *
@@ -130,8 +163,30 @@ public:
 	 */
 	AudioSeRef GetSeData() const;
 
+	/**
+	 * Decodes a sound effect into the cache without playing it.
+	 *
+	 * @param filename Path to the file
+	 * @return false when the file can't be decoded
+	 */
+	static bool Prefetch(const std::string& filename);
+
+	/** @return cache statistics */
+	static Stats GetStats();
+
 	static void Clear();
+
+	/**
+	 * Frees samples which are not playing, least recently used first, until
+	 * the cache uses at most bytes. Used on low memory.
+	 *
+	 * @param bytes size to reach
+	 */
+	static void Trim(int64_t bytes);
 private:
+	/** @return the cached sample, decoded and added to the cache when not cached yet */
+	AudioSeRef Decode();
+
 	std::unique_ptr<AudioDecoder> audio_decoder;
 
 	std::string filename;
@@ -0,0 +1,326 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+// Headers
+#include <algorithm>
+#include "audio_simd.h"
+#include "cpu_features.h"
+
+#if defined(EP_CPU_COMPILE_SSE2) || defined(EP_CPU_COMPILE_AVX2)
+#  include <immintrin.h>
+#endif
+#ifdef EP_CPU_COMPILE_NEON
+#  include <arm_neon.h>
+#endif
+#ifdef EP_CPU_COMPILE_WASM_SIMD
+#  include <wasm_simd128.h>
+#endif
+
+namespace {
+
+void MixF32ScalarImpl(float* mixer, const float* src, int count, float gain, bool overwrite) {
+	if (overwrite) {
+		for (int i = 0; i < count; ++i) {
+			mixer[i] = src[i] * gain;
+		}
+	} else {
+		for (int i = 0; i < count; ++i) {
+			mixer[i] += src[i] * gain;
+		}
+	}
+}
+
+void MixS16ScalarImpl(float* mixer, const int16_t* src, int count, float gain, bool overwrite) {
+	if (overwrite) {
+		for (int i = 0; i < count; ++i) {
+			mixer[i] = src[i] * gain;
+		}
+	} else {
+		for (int i = 0; i < count; ++i) {
+			mixer[i] += src[i] * gain;
+		}
+	}
+}
+
+void ToS16ScalarImpl(int16_t* dst, const float* src, int count) {
+	// Saturate, 1.0 does not fit into int16_t
+	for (int i = 0; i < count; ++i) {
+		const float sample = src[i] * 32768.0f;
+		dst[i] = static_cast<int16_t>(std::min(std::max(sample, -32768.0f), 32767.0f));
+	}
+}
+
+#ifdef EP_CPU_COMPILE_SSE2
+void MixF32SSE2(float* mixer, const float* src, int count, float gain, bool overwrite) {
+	const __m128 g = _mm_set1_ps(gain);
+	int i = 0;
+	if (overwrite) {
+		for (; i + 4 <= count; i += 4) {
+			_mm_storeu_ps(mixer + i, _mm_mul_ps(_mm_loadu_ps(src + i), g));
+		}
+	} else {
+		for (; i + 4 <= count; i += 4) {
+			_mm_storeu_ps(mixer + i, _mm_add_ps(_mm_loadu_ps(mixer + i), _mm_mul_ps(_mm_loadu_ps(src + i), g)));
+		}
+	}
+	MixF32ScalarImpl(mixer + i, src + i, count - i, gain, overwrite);
+}
+
+void MixS16SSE2(float* mixer, const int16_t* src, int count, float gain, bool overwrite) {
+	const __m128 g = _mm_set1_ps(gain);
+	int i = 0;
+	for (; i + 8 <= count; i += 8) {
+		const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+		// Sign extension: the sample in the upper half, shifted down
+		__m128 lo = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16)), g);
+		__m128 hi = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16)), g);
+		if (!overwrite) {
+			lo = _mm_add_ps(_mm_loadu_ps(mixer + i), lo);
+			hi = _mm_add_ps(_mm_loadu_ps(mixer + i + 4), hi);
+		}
+		_mm_storeu_ps(mixer + i, lo);
+		_mm_storeu_ps(mixer + i + 4, hi);
+	}
+	MixS16ScalarImpl(mixer + i, src + i, count - i, gain, overwrite);
+}
+
+void ToS16SSE2(int16_t* dst, const float* src, int count) {
+	const __m128 scale = _mm_set1_ps(32768.0f);
+	const __m128 min = _mm_set1_ps(-32768.0f);
+	const __m128 max = _mm_set1_ps(32767.0f);
+	int i = 0;
+	for (; i + 8 <= count; i += 8) {
+		// Clamped before the conversion, out of range floats convert to INT_MIN
+		const __m128 lo = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(src + i), scale), min), max);
+		const __m128 hi = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(src + i + 4), scale), min), max);
+		const __m128i out = _mm_packs_epi32(_mm_cvttps_epi32(lo), _mm_cvttps_epi32(hi));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), out);
+	}
+	ToS16ScalarImpl(dst + i, src + i, count - i);
+}
+#endif
+
+#ifdef EP_CPU_COMPILE_AVX2
+EP_TARGET_AVX2 void MixF32AVX2(float* mixer, const float* src, int count, float gain, bool overwrite) {
+	const __m256 g = _mm256_set1_ps(gain);
+	int i = 0;
+	if (overwrite) {
+		for (; i + 8 <= count; i += 8) {
+			_mm256_storeu_ps(mixer + i, _mm256_mul_ps(_mm256_loadu_ps(src + i), g));
+		}
+	} else {
+		for (; i + 8 <= count; i += 8) {
+			_mm256_storeu_ps(mixer + i, _mm256_add_ps(_mm256_loadu_ps(mixer + i), _mm256_mul_ps(_mm256_loadu_ps(src + i), g)));
+		}
+	}
+	MixF32ScalarImpl(mixer + i, src + i, count - i, gain, overwrite);
+}
+
+EP_TARGET_AVX2 void MixS16AVX2(float* mixer, const int16_t* src, int count, float gain, bool overwrite) {
+	const __m256 g = _mm256_set1_ps(gain);
+	int i = 0;
+	for (; i + 8 <= count; i += 8) {
+		const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+		__m256 out = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(v)), g);
+		if (!overwrite) {
+			out = _mm256_add_ps(_mm256_loadu_ps(mixer + i), out);
+		}
+		_mm256_storeu_ps(mixer + i, out);
+	}
+	MixS16ScalarImpl(mixer + i, src + i, count - i, gain, overwrite);
+}
+
+EP_TARGET_AVX2 void ToS16AVX2(int16_t* dst, const float* src, int count) {
+	const __m256 scale = _mm256_set1_ps(32768.0f);
+	const __m256 min = _mm256_set1_ps(-32768.0f);
+	const __m256 max = _mm256_set1_ps(32767.0f);
+	int i = 0;
+	for (; i + 16 <= count; i += 16) {
+		const __m256 lo = _mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(_mm256_loadu_ps(src + i), scale), min), max);
+		const __m256 hi = _mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(_mm256_loadu_ps(src + i + 8), scale), min), max);
+		// The pack works per 128 bit lane, the permute restores the order
+		const __m256i packed = _mm256_packs_epi32(_mm256_cvttps_epi32(lo), _mm256_cvttps_epi32(hi));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_permute4x64_epi64(packed, 0xD8));
+	}
+	ToS16ScalarImpl(dst + i, src + i, count - i);
+}
+#endif
+
+#ifdef EP_CPU_COMPILE_NEON
+void MixF32NEON(float* mixer, const float* src, int count, float gain, bool overwrite) {
+	const float32x4_t g = vdupq_n_f32(gain);
+	int i = 0;
+	if (overwrite) {
+		for (; i + 4 <= count; i += 4) {
+			vst1q_f32(mixer + i, vmulq_f32(vld1q_f32(src + i), g));
+		}
+	} else {
+		for (; i + 4 <= count; i += 4) {
+			vst1q_f32(mixer + i, vaddq_f32(vld1q_f32(mixer + i), vmulq_f32(vld1q_f32(src + i), g)));
+		}
+	}
+	MixF32ScalarImpl(mixer + i, src + i, count - i, gain, overwrite);
+}
+
+void MixS16NEON(float* mixer, const int16_t* src, int count, float gain, bool overwrite) {
+	const float32x4_t g = vdupq_n_f32(gain);
+	int i = 0;
+	for (; i + 8 <= count; i += 8) {
+		const int16x8_t v = vld1q_s16(src + i);
+		float32x4_t lo = vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(v))), g);
+		float32x4_t hi = vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(v))), g);
+		if (!overwrite) {
+			lo = vaddq_f32(vld1q_f32(mixer + i), lo);
+			hi = vaddq_f32(vld1q_f32(mixer + i + 4), hi);
+		}
+		vst1q_f32(mixer + i, lo);
+		vst1q_f32(mixer + i + 4, hi);
+	}
+	MixS16ScalarImpl(mixer + i, src + i, count - i, gain, overwrite);
+}
+
+void ToS16NEON(int16_t* dst, const float* src, int count) {
+	const float32x4_t scale = vdupq_n_f32(32768.0f);
+	const float32x4_t min = vdupq_n_f32(-32768.0f);
+	const float32x4_t max = vdupq_n_f32(32767.0f);
+	int i = 0;
+	for (; i + 8 <= count; i += 8) {
+		const float32x4_t lo = vminq_f32(vmaxq_f32(vmulq_f32(vld1q_f32(src + i), scale), min), max);
+		const float32x4_t hi = vminq_f32(vmaxq_f32(vmulq_f32(vld1q_f32(src + i + 4), scale), min), max);
+		vst1q_s16(dst + i, vcombine_s16(vqmovn_s32(vcvtq_s32_f32(lo)), vqmovn_s32(vcvtq_s32_f32(hi))));
+	}
+	ToS16ScalarImpl(dst + i, src + i, count - i);
+}
+#endif
+
+#ifdef EP_CPU_COMPILE_WASM_SIMD
+void MixF32WasmSimd(float* mixer, const float* src, int count, float gain, bool overwrite) {
+	const v128_t g = wasm_f32x4_splat(gain);
+	int i = 0;
+	if (overwrite) {
+		for (; i + 4 <= count; i += 4) {
+			wasm_v128_store(mixer + i, wasm_f32x4_mul(wasm_v128_load(src + i), g));
+		}
+	} else {
+		for (; i + 4 <= count; i += 4) {
+			wasm_v128_store(mixer + i, wasm_f32x4_add(wasm_v128_load(mixer + i), wasm_f32x4_mul(wasm_v128_load(src + i), g)));
+		}
+	}
+	MixF32ScalarImpl(mixer + i, src + i, count - i, gain, overwrite);
+}
+
+void MixS16WasmSimd(float* mixer, const int16_t* src, int count, float gain, bool overwrite) {
+	const v128_t g = wasm_f32x4_splat(gain);
+	int i = 0;
+	for (; i + 8 <= count; i += 8) {
+		const v128_t v = wasm_v128_load(src + i);
+		v128_t lo = wasm_f32x4_mul(wasm_f32x4_convert_i32x4(wasm_i32x4_extend_low_i16x8(v)), g);
+		v128_t hi = wasm_f32x4_mul(wasm_f32x4_convert_i32x4(wasm_i32x4_extend_high_i16x8(v)), g);
+		if (!overwrite) {
+			lo = wasm_f32x4_add(wasm_v128_load(mixer + i), lo);
+			hi = wasm_f32x4_add(wasm_v128_load(mixer + i + 4), hi);
+		}
+		wasm_v128_store(mixer + i, lo);
+		wasm_v128_store(mixer + i + 4, hi);
+	}
+	MixS16ScalarImpl(mixer + i, src + i, count - i, gain, overwrite);
+}
+
+void ToS16WasmSimd(int16_t* dst, const float* src, int count) {
+	const v128_t scale = wasm_f32x4_splat(32768.0f);
+	const v128_t min = wasm_f32x4_splat(-32768.0f);
+	const v128_t max = wasm_f32x4_splat(32767.0f);
+	int i = 0;
+	for (; i + 8 <= count; i += 8) {
+		const v128_t lo = wasm_f32x4_min(wasm_f32x4_max(wasm_f32x4_mul(wasm_v128_load(src + i), scale), min), max);
+		const v128_t hi = wasm_f32x4_min(wasm_f32x4_max(wasm_f32x4_mul(wasm_v128_load(src + i + 4), scale), min), max);
+		wasm_v128_store(dst + i, wasm_i16x8_narrow_i32x4(wasm_i32x4_trunc_sat_f32x4(lo), wasm_i32x4_trunc_sat_f32x4(hi)));
+	}
+	ToS16ScalarImpl(dst + i, src + i, count - i);
+}
+#endif
+
+using MixF32Fn = void (*)(float*, const float*, int, float, bool);
+using MixS16Fn = void (*)(float*, const int16_t*, int, float, bool);
+using ToS16Fn = void (*)(int16_t*, const float*, int);
+
+struct Kernels {
+	MixF32Fn mix_f32;
+	MixS16Fn mix_s16;
+	ToS16Fn to_s16;
+	const char* name;
+};
+
+Kernels SelectKernels() {
+#ifdef EP_CPU_COMPILE_AVX2
+	if (CpuFeatures::HasAVX2()) {
+		return { MixF32AVX2, MixS16AVX2, ToS16AVX2, "AVX2" };
+	}
+#endif
+#ifdef EP_CPU_COMPILE_SSE2
+	if (CpuFeatures::HasSSE2()) {
+		return { MixF32SSE2, MixS16SSE2, ToS16SSE2, "SSE2" };
+	}
+#endif
+#ifdef EP_CPU_COMPILE_NEON
+	if (CpuFeatures::HasNEON()) {
+		return { MixF32NEON, MixS16NEON, ToS16NEON, "NEON" };
+	}
+#endif
+#ifdef EP_CPU_COMPILE_WASM_SIMD
+	if (CpuFeatures::HasWasmSimd()) {
+		return { MixF32WasmSimd, MixS16WasmSimd, ToS16WasmSimd, "WASM SIMD" };
+	}
+#endif
+	return { MixF32ScalarImpl, MixS16ScalarImpl, ToS16ScalarImpl, "Scalar" };
+}
+
+const Kernels& GetKernels() {
+	static const Kernels kernels = SelectKernels();
+	return kernels;
+}
+
+} // namespace
+
+void AudioSimd::MixF32(float* mixer, const float* src, int count, float gain, bool overwrite) {
+	GetKernels().mix_f32(mixer, src, count, gain, overwrite);
+}
+
+void AudioSimd::MixF32Scalar(float* mixer, const float* src, int count, float gain, bool overwrite) {
+	MixF32ScalarImpl(mixer, src, count, gain, overwrite);
+}
+
+void AudioSimd::MixS16(float* mixer, const int16_t* src, int count, float gain, bool overwrite) {
+	GetKernels().mix_s16(mixer, src, count, gain, overwrite);
+}
+
+void AudioSimd::MixS16Scalar(float* mixer, const int16_t* src, int count, float gain, bool overwrite) {
+	MixS16ScalarImpl(mixer, src, count, gain, overwrite);
+}
+
+void AudioSimd::ToS16(int16_t* dst, const float* src, int count) {
+	GetKernels().to_s16(dst, src, count);
+}
+
+void AudioSimd::ToS16Scalar(int16_t* dst, const float* src, int count) {
+	ToS16ScalarImpl(dst, src, count);
+}
+
+const char* AudioSimd::GetVariant() {
+	return GetKernels().name;
+}
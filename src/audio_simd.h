@@ -0,0 +1,92 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef EP_AUDIO_SIMD_H
+#define EP_AUDIO_SIMD_H
+
+// Headers
+#include <cstdint>
+
+/**
+ * Sample kernels used by the GenericAudio mixer.
+ * Every kernel has a scalar reference implementation and vectorized
+ * variants. The fastest variant supported by the CPU is picked on first use.
+ */
+namespace AudioSimd {
+
+/**
+ * Mixes float samples into the mixer buffer, mixer[i] += src[i] * gain.
+ *
+ * @param mixer mixer buffer
+ * @param src samples to mix
+ * @param count number of samples
+ * @param gain factor applied to the samples
+ * @param overwrite replace the mixer content instead of adding to it
+ */
+void MixF32(float* mixer, const float* src, int count, float gain, bool overwrite);
+
+/**
+ * Scalar reference implementation of MixF32.
+ *
+ * @see MixF32
+ */
+void MixF32Scalar(float* mixer, const float* src, int count, float gain, bool overwrite);
+
+/**
+ * Mixes signed 16 bit samples into the mixer buffer, mixer[i] += src[i] * gain.
+ *
+ * @param mixer mixer buffer
+ * @param src samples to mix
+ * @param count number of samples
+ * @param gain factor applied to the samples, includes the 1/32768 scale
+ * @param overwrite replace the mixer content instead of adding to it
+ */
+void MixS16(float* mixer, const int16_t* src, int count, float gain, bool overwrite);
+
+/**
+ * Scalar reference implementation of MixS16.
+ *
+ * @see MixS16
+ */
+void MixS16Scalar(float* mixer, const int16_t* src, int count, float gain, bool overwrite);
+
+/**
+ * Converts mixed samples in the range [-1, 1] to signed 16 bit.
+ * Samples out of range are saturated.
+ *
+ * @param dst converted samples
+ * @param src mixed samples
+ * @param count number of samples
+ */
+void ToS16(int16_t* dst, const float* src, int count);
+
+/**
+ * Scalar reference implementation of ToS16.
+ *
+ * @see ToS16
+ */
+void ToS16Scalar(int16_t* dst, const float* src, int count);
+
+/**
+ * @return Name of the kernel variant used by the mixer
+ */
+const char* GetVariant();
+
+} // namespace AudioSimd
+
+#endif
@@ -160,7 +160,11 @@ double CalcSkillDmgAutoBattleTargetRank(const Game_Actor& source, const Game_Bat
 	return rank;
 }
 
-double CalcSkillAutoBattleRank(const Game_Actor& source, const lcf::rpg::Skill& skill, bool apply_variance, bool emulate_bugs) {
+double CalcSkillAutoBattleRank(const Game_Actor& source, const lcf::rpg::Skill& skill, bool apply_variance, bool emulate_bugs, Game_Battler** best_target) {
+	if (best_target) {
+		*best_target = nullptr;
+	}
+
 	if (!source.IsSkillUsable(skill.ID)) {
 		return 0.0;
 	}
@@ -173,6 +177,9 @@ double CalcSkillAutoBattleRank(const Game_Actor& source, const lcf::rpg::Skill&
 		case lcf::rpg::Skill::Scope_ally:
 			for (auto* target: Main_Data::game_party->GetActors()) {
 				auto target_rank = CalcSkillHealAutoBattleTargetRank(source, *target, skill, apply_variance, emulate_bugs);
+				if (best_target && target_rank > rank) {
+					*best_target = target;
+				}
 				rank = std::max(rank, target_rank);
 				DebugLog("AUTOBATTLE: Actor {} Check Skill Single Ally {} Rank : {}({}): {} -> {}", source.GetName(), target->GetName(), skill.name, skill.ID, rank, target_rank);
 			}
@@ -187,6 +194,9 @@ double CalcSkillAutoBattleRank(const Game_Actor& source, const lcf::rpg::Skill&
 		case lcf::rpg::Skill::Scope_enemy:
 			for (auto* target: Main_Data::game_enemyparty->GetEnemies()) {
 				auto target_rank = CalcSkillDmgAutoBattleTargetRank(source, *target, skill, apply_variance, emulate_bugs);
+				if (best_target && target_rank > rank) {
+					*best_target = target;
+				}
 				rank = std::max(rank, target_rank);
 				DebugLog("AUTOBATTLE: Actor {} Check Skill Single Enemy {} Rank : {}({}): {} -> {}", source.GetName(), target->GetName(), skill.name, skill.ID, rank, target_rank);
 			}
@@ -290,17 +300,20 @@ void SelectAutoBattleAction(Game_Actor& source,
 {
 	double skill_rank = 0.0;
 	lcf::rpg::Skill* skill = nullptr;
+	Game_Battler* skill_target = nullptr;
 
 	// Find the highest ranking skill
 	if (do_skills) {
 		for (auto& skill_id: source.GetSkills()) {
 			auto* candidate_skill = lcf::ReaderUtil::GetElement(lcf::Data::skills, skill_id);
 			if (candidate_skill) {
-				const auto rank = CalcSkillAutoBattleRank(source, *candidate_skill, skill_variance, emulate_bugs);
+				Game_Battler* candidate_target = nullptr;
+				const auto rank = CalcSkillAutoBattleRank(source, *candidate_skill, skill_variance, emulate_bugs, &candidate_target);
 				DebugLog("AUTOBATTLE: Actor {} Check Skill Rank : {}({}): {}", source.GetName(), candidate_skill->name, candidate_skill->ID, rank);
 				if (rank > skill_rank) {
 					skill_rank = rank;
 					skill = candidate_skill;
+					skill_target = candidate_target;
 				}
 			}
 		}
@@ -315,6 +328,14 @@ void SelectAutoBattleAction(Game_Actor& source,
 	std::vector<Game_Battler*> targets;
 
 	if (skill != nullptr && normal_attack_rank < skill_rank) {
+		// Without variance the target ranks are the same as during the skill ranking.
+		// With variance RPG_RT rolls them again, which must be kept for the random sequence.
+		if (!skill_variance && skill_target) {
+			DebugLog("AUTOBATTLE: Actor {} Select Skill Target : {}", source.GetName(), skill_target->GetName());
+			source.SetBattleAlgorithm(std::make_shared<Game_BattleAlgorithm::Skill>(&source, skill_target, *skill));
+			return;
+		}
+
 		// Choose Skill Target
 		switch (skill->scope) {
 			case lcf::rpg::Skill::Scope_enemies:
@@ -131,8 +131,9 @@ double CalcSkillDmgAutoBattleTargetRank(const Game_Actor& source, const Game_Bat
  * @param skill the skill
  * @param apply_variance If true, apply variance to the damage
  * @param emulate_bugs Emulate all RPG_RT bugs for accuracy
+ * @param best_target If not null, receives the highest ranking target of a single ally or enemy skill
  */
-double CalcSkillAutoBattleRank(const Game_Actor& source, const lcf::rpg::Skill& skill, bool apply_variance, bool emulate_bugs);
+double CalcSkillAutoBattleRank(const Game_Actor& source, const lcf::rpg::Skill& skill, bool apply_variance, bool emulate_bugs, Game_Battler** best_target = nullptr);
 
 /**
  * Calculate the auto battle effectiveness rank of source attacking target.
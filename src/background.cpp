@@ -121,10 +121,10 @@ void Background::Draw(Bitmap& dst) {
 	dst_rect.y += Main_Data::game_screen->GetShakeOffsetY();
 
 	if (bg_bitmap)
-		dst.TiledBlit(-Scale(bg_x), -Scale(bg_y), bg_bitmap->GetRect(), *bg_bitmap, dst_rect, 255);
+		bg_wrap.TiledBlit(dst, -Scale(bg_x), -Scale(bg_y), bg_bitmap, dst_rect, 255);
 
 	if (fg_bitmap)
-		dst.TiledBlit(-Scale(fg_x), -Scale(fg_y), fg_bitmap->GetRect(), *fg_bitmap, dst_rect, 255);
+		fg_wrap.TiledBlit(dst, -Scale(fg_x), -Scale(fg_y), fg_bitmap, dst_rect, 255);
 
 	if (tone_effect != Tone()) {
 		dst.ToneBlit(0, 0, dst, dst.GetRect(), tone_effect, Opacity::Opaque());
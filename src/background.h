@@ -23,6 +23,7 @@
 #include "system.h"
 #include "drawable.h"
 #include "async_handler.h"
+#include "bitmap_wrap.h"
 #include "tone.h"
 
 class Background : public Drawable {
@@ -49,11 +50,13 @@ private:
 	int bg_vscroll = 0;
 	int bg_x = 0;
 	int bg_y = 0;
+	BitmapWrap bg_wrap;
 	BitmapRef fg_bitmap;
 	int fg_hscroll = 0;
 	int fg_vscroll = 0;
 	int fg_x = 0;
 	int fg_y = 0;
+	BitmapWrap fg_wrap;
 
 	FileRequestBinding request_id;
 };
@@ -18,6 +18,7 @@
 // Headers
 #include "baseui.h"
 #include "bitmap.h"
+#include "headless_ui.h"
 
 #if USE_SDL==2
 #  include "sdl2_ui.h"
@@ -36,6 +37,9 @@
 std::shared_ptr<BaseUi> DisplayUi;
 
 std::shared_ptr<BaseUi> BaseUi::CreateUi(long width, long height, const Game_ConfigVideo& cfg) {
+	if (cfg.headless.Get()) {
+		return std::make_shared<HeadlessUi>(width, height, cfg);
+	}
 #if USE_SDL==2
 	return std::make_shared<Sdl2Ui>(width, height, cfg);
 #elif USE_SDL==1
@@ -63,6 +67,25 @@ BaseUi::BaseUi(const Game_ConfigVideo& cfg)
 	frame_limit = Game_Clock::TimeStepFromFps(fps_limit);
 }
 
+void BaseUi::UploadDisplay() {
+}
+
+void BaseUi::PresentDisplay() {
+	UpdateDisplay();
+}
+
+bool BaseUi::CanPresentWhileDrawing() const {
+	return false;
+}
+
+bool BaseUi::CanSkipPresent() const {
+	return false;
+}
+
+AcceleratedRenderer* BaseUi::GetAcceleratedRenderer() {
+	return nullptr;
+}
+
 BitmapRef BaseUi::CaptureScreen() {
 	return Bitmap::Create(*main_surface, main_surface->GetRect());
 }
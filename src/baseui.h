@@ -35,6 +35,8 @@
 	struct AudioInterface;
 #endif
 
+class AcceleratedRenderer;
+
 /**
  * BaseUi base abstract class.
  */
@@ -79,6 +81,38 @@ public:
 	 */
 	virtual void UpdateDisplay() = 0;
 
+	/**
+	 * First half of UpdateDisplay: takes the frame from the display surface.
+	 * The frame is shown by the next PresentDisplay call.
+	 */
+	virtual void UploadDisplay();
+
+	/**
+	 * Second half of UpdateDisplay: shows the frame taken by UploadDisplay.
+	 * May wait for vertical sync.
+	 */
+	virtual void PresentDisplay();
+
+	/**
+	 * @return whether the display surface may be drawn to on another thread
+	 *         while PresentDisplay runs
+	 */
+	virtual bool CanPresentWhileDrawing() const;
+
+	/**
+	 * @return whether the last presented frame stays visible when
+	 *         UpdateDisplay is not called for an unchanged surface
+	 */
+	virtual bool CanSkipPresent() const;
+
+	/**
+	 * Returns the GPU renderer of the display.
+	 * When available, Graphics::Draw uses it instead of the display surface.
+	 *
+	 * @return renderer or nullptr when frames are only composited in software.
+	 */
+	virtual AcceleratedRenderer* GetAcceleratedRenderer();
+
 	/**
 	 * Gets a copy of the display surface.
 	 *
@@ -15,6 +15,7 @@
  * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <cmath>
 #include "bitmap.h"
 #include <lcf/rpg/animation.h>
 #include "output.h"
@@ -73,7 +74,8 @@ void BattleAnimation::Update() {
 	UpdateScreenFlash();
 	UpdateTargetFlash();
 
-	SetFlashEffect(Main_Data::game_screen->GetFlashColor());
+	flash = Main_Data::game_screen->GetFlashColor();
+	SetFlashEffect(flash);
 
 	frame++;
 }
@@ -90,11 +92,82 @@ void BattleAnimation::OnBattle2SpriteReady(FileRequestResult* result) {
 	SetSrcRect(Rect(0, 0, 0, 0));
 }
 
+Rect BattleAnimation::GetDamage(const Rect& screen_rect) {
+	return Drawable::GetDamage(screen_rect);
+}
+
+Rect BattleAnimation::GetScreenBounds(const Rect& screen_rect) const {
+	return Drawable::GetScreenBounds(screen_rect);
+}
+
+bool BattleAnimation::PrepareBands() {
+	return false;
+}
+
+bool BattleAnimation::DrawAccelerated(AcceleratedRenderer&) {
+	return false;
+}
+
 void BattleAnimation::DrawAt(Bitmap& dst, int x, int y) {
 	if (IsDone()) {
 		return;
 	}
 
+	if (UpdateFrameCache()) {
+		if (frame_cache) {
+			dst.Blit(x + frame_cache_rect.x, y + frame_cache_rect.y, *frame_cache, frame_cache->GetRect(), Opacity::Opaque());
+		}
+		return;
+	}
+
+	DrawCells(dst, x, y);
+}
+
+bool BattleAnimation::UpdateFrameCache() {
+	const auto* sheet = GetBitmap().get();
+	if (frame_cache_frame == GetRealFrame() && frame_cache_flash == flash && frame_cache_sheet == sheet) {
+		return true;
+	}
+
+	frame_cache.reset();
+	frame_cache_frame = GetRealFrame();
+	frame_cache_flash = flash;
+	frame_cache_sheet = sheet;
+
+	if (!sheet) {
+		return true;
+	}
+
+	const lcf::rpg::AnimationFrame& anim_frame = animation.frames[GetRealFrame()];
+	const int size = animation.large ? 128 : 96;
+
+	Rect bounds;
+	for (auto& cell: anim_frame.cells) {
+		if (cell.valid) {
+			const int half = static_cast<int>(std::ceil(size / 2 * cell.zoom / 100.0)) + 1;
+			const int cx = invert ? -cell.x : cell.x;
+			bounds = bounds.GetUnion(Rect(cx - half, cell.y - half, 2 * half, 2 * half));
+		}
+	}
+
+	if (bounds.IsEmpty()) {
+		return true;
+	}
+
+	// Sprite culls unzoomed cells outside of the screen
+	if (bounds.width > SCREEN_TARGET_WIDTH || bounds.height > SCREEN_TARGET_HEIGHT) {
+		frame_cache_frame = -1;
+		return false;
+	}
+
+	frame_cache = Bitmap::Create(bounds.width, bounds.height, true);
+	frame_cache->Clear();
+	DrawCells(*frame_cache, -bounds.x, -bounds.y);
+	frame_cache_rect = bounds;
+	return true;
+}
+
+void BattleAnimation::DrawCells(Bitmap& dst, int x, int y) {
 	const lcf::rpg::AnimationFrame& anim_frame = animation.frames[GetRealFrame()];
 
 	std::vector<lcf::rpg::AnimationCellData>::const_iterator it;
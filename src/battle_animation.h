@@ -62,12 +62,27 @@ public:
 	/** @return true if the animation only plays audio and doesn't display **/
 	bool IsOnlySound() const;
 
+	/** Animations draw their cells directly and are neither tracked nor culled **/
+	Rect GetDamage(const Rect& screen_rect) override;
+	Rect GetScreenBounds(const Rect& screen_rect) const override;
+	bool PrepareBands() override;
+	bool DrawAccelerated(AcceleratedRenderer& renderer) override;
+
 protected:
 	BattleAnimation(const lcf::rpg::Animation& anim, bool only_sound = false, int cutoff = -1);
 
 	virtual void FlashTargets(int r, int g, int b, int p) = 0;
 	virtual void ShakeTargets(int str, int spd, int time) = 0;
 	void DrawAt(Bitmap& dst, int x, int y);
+	void DrawCells(Bitmap& dst, int x, int y);
+
+	/**
+	 * Composes the cells of the current frame into frame_cache.
+	 * Group and global animations draw the same frame several times.
+	 *
+	 * @return whether frame_cache can be used for drawing
+	 */
+	bool UpdateFrameCache();
 	void ProcessAnimationTiming(const lcf::rpg::AnimationTiming& timing);
 	void ProcessAnimationFlash(const lcf::rpg::AnimationTiming& timing);
 	void OnBattleSpriteReady(FileRequestResult* result);
@@ -85,6 +100,14 @@ protected:
 	FileRequestBinding request_id;
 	bool only_sound = false;
 	bool invert = false;
+	Color flash;
+
+	/** Cells of the current frame, frame_cache_rect is relative to the animation position */
+	BitmapRef frame_cache;
+	Rect frame_cache_rect;
+	int frame_cache_frame = -1;
+	Color frame_cache_flash;
+	const Bitmap* frame_cache_sheet = nullptr;
 };
 
 // For playing animations on the map.
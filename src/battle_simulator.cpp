@@ -0,0 +1,221 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include <algorithm>
+#include <memory>
+#include <vector>
+#include "battle_simulator.h"
+#include "autobattle.h"
+#include "enemyai.h"
+#include "game_actor.h"
+#include "game_actors.h"
+#include "game_battle.h"
+#include "game_battlealgorithm.h"
+#include "game_enemy.h"
+#include "game_enemyparty.h"
+#include "game_party.h"
+#include "main_data.h"
+#include "output.h"
+#include "player.h"
+#include "rand.h"
+#include "scene_battle.h"
+
+namespace {
+	using BattlerList = std::vector<Game_Battler*>;
+
+	struct Algorithms {
+		std::unique_ptr<AutoBattle::AlgorithmBase> autobattle;
+		std::unique_ptr<EnemyAi::AlgorithmBase> enemyai;
+	};
+
+	void StartBattle(const BattleSimulator::Config& config) {
+		Game_Battle::SetBattleCondition(config.condition);
+		Main_Data::game_enemyparty->ResetBattle(config.troop_id);
+		Main_Data::game_party->ResetTurns();
+		Main_Data::game_actors->ResetBattle();
+
+		for (auto* actor: Main_Data::game_party->GetActors()) {
+			actor->ResetEquipmentStates(true);
+		}
+	}
+
+	/** Same selection as Scene_Battle_Rpg2k::SelectNextActor and CreateEnemyActions */
+	void SelectActions(Algorithms& algos, BattlerList& actions) {
+		actions.clear();
+
+		for (auto* actor: Main_Data::game_party->GetActors()) {
+			if (!actor->CanAct()) {
+				actor->SetBattleAlgorithm(std::make_shared<Game_BattleAlgorithm::NoMove>(actor));
+			} else if (actor->GetSignificantRestriction() == lcf::rpg::State::Restriction_attack_ally) {
+				actor->SetBattleAlgorithm(std::make_shared<Game_BattleAlgorithm::Normal>(actor, Main_Data::game_party->GetRandomActiveBattler()));
+			} else if (actor->GetSignificantRestriction() == lcf::rpg::State::Restriction_attack_enemy) {
+				actor->SetBattleAlgorithm(std::make_shared<Game_BattleAlgorithm::Normal>(actor, Main_Data::game_enemyparty->GetRandomActiveBattler()));
+			} else {
+				algos.autobattle->SetAutoBattleAction(*actor);
+			}
+			actions.push_back(actor);
+		}
+
+		for (auto* enemy: Main_Data::game_enemyparty->GetEnemies()) {
+			if (!EnemyAi::SetStateRestrictedAction(*enemy)) {
+				algos.enemyai->SetEnemyAiAction(*enemy);
+			}
+			actions.push_back(enemy);
+		}
+
+		// Same order as Scene_Battle_Rpg2k::CreateExecutionOrder
+		for (auto* battler: actions) {
+			int battle_order = battler->GetAgi() + Rand::GetRandomNumber(0, battler->GetAgi() / 4 + 3);
+			if (battler->GetBattleAlgorithm()->GetType() == Game_BattleAlgorithm::Type::Normal && battler->HasPreemptiveAttack()) {
+				battle_order += 100000;
+			}
+			battler->SetBattleOrderAgi(battle_order);
+		}
+		std::sort(actions.begin(), actions.end(), [](Game_Battler* l, Game_Battler* r) {
+			return l->GetBattleOrderAgi() > r->GetBattleOrderAgi();
+		});
+	}
+
+	/** Runs the action of the battler from ProcessActionBegin to ProcessActionFinished without the presentation */
+	void ExecuteAction(Game_Battler& battler, BattleSimulator::Result& result) {
+		Scene_Battle::PrepareBattleAction(&battler);
+		auto* action = battler.GetBattleAlgorithm().get();
+		if (!action) {
+			return;
+		}
+
+		battler.NextBattleTurn();
+		battler.BattleStateHeal();
+		battler.ApplyConditions();
+
+		if (action->GetType() == Game_BattleAlgorithm::Type::Null) {
+			return;
+		}
+
+		action->TargetFirst();
+		if (!action->IsTargetValid()) {
+			if (!action->GetTarget()) {
+				return;
+			}
+			action->SetTarget(action->GetTarget()->GetParty().GetNextActiveBattler(action->GetTarget()));
+			if (!action->IsTargetValid()) {
+				return;
+			}
+		}
+
+		++result.actions;
+		do {
+			auto* target = action->GetTarget();
+			const int hp = target ? target->GetHp() : 0;
+
+			action->Execute();
+			action->Apply();
+
+			if (target && target->GetHp() < hp) {
+				auto& damage = target->GetType() == Game_Battler::Type_Enemy ? result.damage_dealt : result.damage_taken;
+				damage += hp - target->GetHp();
+			}
+		} while (action->TargetNext());
+	}
+
+	/** @return whether the battle ended */
+	bool CheckEnd(BattleSimulator::Result& result) {
+		if (Game_Battle::CheckWin()) {
+			++result.victories;
+			for (auto* actor: Main_Data::game_party->GetActors()) {
+				result.hp_left += actor->GetHp();
+			}
+			return true;
+		}
+		if (Game_Battle::CheckLose()) {
+			++result.defeats;
+			return true;
+		}
+		return false;
+	}
+
+	void RunBattle(const BattleSimulator::Config& config, Algorithms& algos, BattlerList& actions, BattleSimulator::Result& result) {
+		StartBattle(config);
+		++result.battles;
+
+		for (int turn = 0; turn < config.max_turns; ++turn) {
+			if (CheckEnd(result)) {
+				return;
+			}
+
+			Main_Data::game_party->IncTurns();
+			++result.turns;
+
+			SelectActions(algos, actions);
+			for (auto* battler: actions) {
+				if (battler->Exists() && !Game_Battle::CheckWin() && !Game_Battle::CheckLose()) {
+					ExecuteAction(*battler, result);
+				}
+				battler->SetBattleAlgorithm(nullptr);
+			}
+		}
+
+		if (!CheckEnd(result)) {
+			++result.timeouts;
+		}
+	}
+}
+
+BattleSimulator::Result BattleSimulator::Run(const Config& config) {
+	Result result;
+
+	// Restored after every battle, all battles start from the same state
+	const auto actors = Main_Data::game_actors->GetSaveData();
+	const auto inventory = Main_Data::game_party->GetSaveData();
+
+	Algorithms algos;
+	algos.autobattle = AutoBattle::CreateAlgorithm(Player::player_config.autobattle_algo.Get());
+	algos.enemyai = EnemyAi::CreateAlgorithm(Player::player_config.enemyai_algo.Get());
+
+	const auto prev_battle_running = Game_Battle::battle_running;
+	Game_Battle::battle_running = true;
+
+	BattlerList actions;
+	for (int i = 0; i < config.battles; ++i) {
+		Rand::SeedRandomNumberGenerator(config.seed + i);
+		RunBattle(config, algos, actions, result);
+
+		Main_Data::game_actors->SetSaveData(actors);
+		Main_Data::game_party->SetupFromSave(inventory);
+	}
+
+	Game_Battle::battle_running = prev_battle_running;
+	Main_Data::game_enemyparty->ResetBattle(0);
+	Main_Data::game_actors->ResetBattle();
+
+	return result;
+}
+
+void BattleSimulator::PrintResult(const Config& config, const Result& result, double seconds) {
+	const double battles = std::max(result.battles, 1);
+
+	Output::Info("Battle simulation: troop {}, {} battles in {:.2f} s ({:.0f} battles/s)",
+			config.troop_id, result.battles, seconds, seconds > 0 ? result.battles / seconds : 0.0);
+	Output::Info("Victories {} ({:.1f}%), defeats {}, timeouts {} (after {} turns)",
+			result.victories, result.GetWinRate() * 100.0, result.defeats, result.timeouts, config.max_turns);
+	Output::Info("Per battle: {:.2f} turns, {:.2f} actions, {:.1f} damage dealt, {:.1f} damage taken",
+			result.turns / battles, result.actions / battles, result.damage_dealt / battles, result.damage_taken / battles);
+	if (result.victories > 0) {
+		Output::Info("Party HP left per victory: {:.1f}", static_cast<double>(result.hp_left) / result.victories);
+	}
+}
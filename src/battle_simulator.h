@@ -0,0 +1,89 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_BATTLE_SIMULATOR_H
+#define EP_BATTLE_SIMULATOR_H
+
+// Headers
+#include <cstdint>
+#include <lcf/rpg/system.h>
+
+/**
+ * Runs battles of the current party against a troop without a scene.
+ * Both sides pick their actions with the auto battle and enemy AI
+ * algorithms of the player config. Turns are resolved like the RPG2k
+ * battle system, animations, messages, battle events and drawing are
+ * skipped. The game state is restored after every battle.
+ */
+namespace BattleSimulator {
+
+struct Config {
+	/** Troop to fight against */
+	int troop_id = 0;
+	/** Number of battles */
+	int battles = 1;
+	/** Battle i uses seed + i for the random number generator */
+	int32_t seed = 0;
+	/** Battles still running after this many turns are counted as timeouts */
+	int max_turns = 100;
+	lcf::rpg::System::BattleCondition condition = lcf::rpg::System::BattleCondition_none;
+};
+
+struct Result {
+	int battles = 0;
+	int victories = 0;
+	int defeats = 0;
+	int timeouts = 0;
+	/** Turns of all battles */
+	int64_t turns = 0;
+	/** Actions executed in all battles */
+	int64_t actions = 0;
+	/** HP damage dealt to the troop in all battles */
+	int64_t damage_dealt = 0;
+	/** HP damage taken by the party in all battles */
+	int64_t damage_taken = 0;
+	/** HP of the party left after the victories */
+	int64_t hp_left = 0;
+
+	/** @return share of victories (0-1) */
+	double GetWinRate() const;
+};
+
+/**
+ * Simulates the battles.
+ *
+ * @param config simulation parameters, troop_id must be valid
+ * @return statistics of all battles
+ */
+Result Run(const Config& config);
+
+/**
+ * Logs the statistics with Output::Info.
+ *
+ * @param config simulation parameters
+ * @param result statistics returned by Run
+ * @param seconds duration of the simulation
+ */
+void PrintResult(const Config& config, const Result& result, double seconds);
+
+} // namespace BattleSimulator
+
+inline double BattleSimulator::Result::GetWinRate() const {
+	return battles > 0 ? static_cast<double>(victories) / battles : 0.0;
+}
+
+#endif
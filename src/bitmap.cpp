@@ -21,12 +21,16 @@
 #include <cstdlib>
 #include <cstring>
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <iostream>
 #include <unordered_map>
+#include <vector>
 
 #include "utils.h"
 #include "cache.h"
 #include "bitmap.h"
+#include "job_system.h"
 #include "filefinder.h"
 #include "options.h"
 #include <lcf/data.h>
@@ -39,6 +43,10 @@
 #include "output.h"
 #include "util_macro.h"
 #include "bitmap_hslrgb.h"
+#include "bitmap_simd.h"
+#include "bitmap_kernels.h"
+#include "pixel_pool.h"
+#include "memory_stats.h"
 #include <iostream>
 
 BitmapRef Bitmap::Create(int width, int height, const Color& color) {
@@ -79,6 +87,31 @@ BitmapRef Bitmap::Create(void *pixels, int width, int height, int pitch, const D
 	return std::make_shared<Bitmap>(pixels, width, height, pitch, format);
 }
 
+BitmapRef Bitmap::Create(std::shared_ptr<void> storage, void* pixels, int width, int height, int pitch, bool transparent) {
+	assert(reinterpret_cast<uintptr_t>(pixels) % 4 == 0 && pitch % 4 == 0);
+	auto bitmap = Create(pixels, width, height, pitch, transparent ? pixel_format : opaque_pixel_format);
+	bitmap->pixel_storage = std::move(storage);
+	return bitmap;
+}
+
+BitmapRef Bitmap::CreateView(Bitmap& source) {
+	// Paletted bitmaps are not drawn on
+	assert(!source.IsPaletted());
+	auto view = Create(source.pixels(), source.width(), source.height(), source.pitch(), source.format);
+	view->image_opacity = source.image_opacity;
+	return view;
+}
+
+BitmapRef Bitmap::CreateView(const BitmapRef& source, const Rect& rect) {
+	assert(!source->IsPaletted());
+	assert(rect.x >= 0 && rect.y >= 0 && rect.x + rect.width <= source->width() && rect.y + rect.height <= source->height());
+	auto* pixels = static_cast<uint8_t*>(source->pixels()) + rect.y * source->pitch() + rect.x * source->bpp();
+	auto view = Create(pixels, rect.width, rect.height, source->pitch(), source->format);
+	view->view_source = source;
+	view->view_rect = rect;
+	return view;
+}
+
 Bitmap::Bitmap(int width, int height, bool transparent) {
 	format = (transparent ? pixel_format : opaque_pixel_format);
 	pixman_format = find_format(format);
@@ -111,12 +144,24 @@ Bitmap::Bitmap(const std::string& filename, bool transparent, uint32_t flags) {
 
 	bool img_okay = false;
 
+	// Paletted images are expanded straight into the bitmap format
+	ImagePalette::Target target;
+	target.format = &format;
+	target.indices = paletted_storage && (flags & Flag_Paletted) && (flags & Flag_ReadOnly);
+
+	// Memory-mapped files are decoded in place
+	const auto span = stream.GetSpan();
+	const bool in_memory = !span.empty();
+
 	if (bytes >= 4 && strncmp((char*)data, "XYZ1", 4) == 0)
-		img_okay = ImageXYZ::ReadXYZ(stream, transparent, w, h, pixels);
+		img_okay = in_memory ? ImageXYZ::ReadXYZ(span.data(), span.size(), transparent, w, h, pixels, &target) :
+			ImageXYZ::ReadXYZ(stream, transparent, w, h, pixels, &target);
 	else if (bytes > 2 && strncmp((char*)data, "BM", 2) == 0)
-		img_okay = ImageBMP::ReadBMP(stream, transparent, w, h, pixels);
+		img_okay = in_memory ? ImageBMP::ReadBMP(span.data(), span.size(), transparent, w, h, pixels) :
+			ImageBMP::ReadBMP(stream, transparent, w, h, pixels);
 	else if (bytes >= 4 && strncmp((char*)(data + 1), "PNG", 3) == 0)
-		img_okay = ImagePNG::ReadPNG(stream, transparent, w, h, pixels);
+		img_okay = in_memory ? ImagePNG::ReadPNG(span.data(), span.size(), transparent, w, h, pixels, &target) :
+			ImagePNG::ReadPNG(stream, transparent, w, h, pixels, &target);
 	else
 		Output::Warning("Unsupported image file {} (Magic: {:02X})", filename, *reinterpret_cast<uint32_t*>(data));
 
@@ -126,9 +171,14 @@ Bitmap::Bitmap(const std::string& filename, bool transparent, uint32_t flags) {
 		return;
 	}
 
-	Init(w, h, nullptr);
-
-	ConvertImage(w, h, pixels, transparent);
+	if (target.has_indices) {
+		InitPaletted(w, h, pixels, target.palette);
+	} else if (target.converted) {
+		Init(w, h, pixels, 0, true);
+	} else {
+		Init(w, h, nullptr);
+		ConvertImage(w, h, pixels, transparent);
+	}
 
 	CheckPixels(flags);
 }
@@ -142,12 +192,16 @@ Bitmap::Bitmap(const uint8_t* data, unsigned bytes, bool transparent, uint32_t f
 
 	bool img_okay = false;
 
+	ImagePalette::Target target;
+	target.format = &format;
+	target.indices = paletted_storage && (flags & Flag_Paletted) && (flags & Flag_ReadOnly);
+
 	if (bytes > 4 && strncmp((char*) data, "XYZ1", 4) == 0)
-		img_okay = ImageXYZ::ReadXYZ(data, bytes, transparent, w, h, pixels);
+		img_okay = ImageXYZ::ReadXYZ(data, bytes, transparent, w, h, pixels, &target);
 	else if (bytes > 2 && strncmp((char*) data, "BM", 2) == 0)
 		img_okay = ImageBMP::ReadBMP(data, bytes, transparent, w, h, pixels);
 	else if (bytes > 4 && strncmp((char*)(data + 1), "PNG", 3) == 0)
-		img_okay = ImagePNG::ReadPNG((const void*) data, transparent, w, h, pixels);
+		img_okay = ImagePNG::ReadPNG((const void*) data, bytes, transparent, w, h, pixels, &target);
 	else
 		Output::Warning("Unsupported image (Magic: {:02X})", bytes >= 4 ? *reinterpret_cast<const uint32_t*>(data) : 0);
 
@@ -157,9 +211,14 @@ Bitmap::Bitmap(const uint8_t* data, unsigned bytes, bool transparent, uint32_t f
 		return;
 	}
 
-	Init(w, h, nullptr);
-
-	ConvertImage(w, h, pixels, transparent);
+	if (target.has_indices) {
+		InitPaletted(w, h, pixels, target.palette);
+	} else if (target.converted) {
+		Init(w, h, pixels, 0, true);
+	} else {
+		Init(w, h, nullptr);
+		ConvertImage(w, h, pixels, transparent);
+	}
 
 	CheckPixels(flags);
 }
@@ -173,17 +232,22 @@ Bitmap::Bitmap(Bitmap const& source, Rect const& src_rect, bool transparent) {
 	Blit(0, 0, source, src_rect, Opacity::Opaque());
 }
 
-bool Bitmap::WritePNG(Filesystem_Stream::OutputStream& os) const {
+bool Bitmap::WritePNG(Filesystem_Stream::OutputStream& os, int compression) const {
+	std::vector<uint32_t> data;
+	GetPNGPixels(data);
+
+	return ImagePNG::WritePNG(os, GetWidth(), GetHeight(), &data.front(), compression);
+}
+
+void Bitmap::GetPNGPixels(std::vector<uint32_t>& data) const {
 	size_t const width = GetWidth(), height = GetHeight();
 	size_t const stride = width * 4;
 
-	std::vector<uint32_t> data(width * height);
+	data.resize(width * height);
 
 	auto dst = PixmanImagePtr{pixman_image_create_bits(PIXMAN_b8g8r8, width, height, &data.front(), stride)};
 	pixman_image_composite32(PIXMAN_OP_SRC, bitmap.get(), NULL, dst.get(),
 							 0, 0, 0, 0, 0, 0, width, height);
-
-	return ImagePNG::WritePNG(os, width, height, &data.front());
 }
 
 size_t Bitmap::GetSize() const {
@@ -191,33 +255,41 @@ size_t Bitmap::GetSize() const {
 		return 0;
 	}
 
-	return pitch() * height();
+	// Views of a part only account their own pixels
+	const int row_bytes = view_source ? width() * bpp() : pitch();
+	return row_bytes * height() + (IsPaletted() ? sizeof(IndexPalette) : 0);
 }
 
-ImageOpacity Bitmap::ComputeImageOpacity() const {
-	bool all_opaque = true;
-	bool all_transp = true;
-
-	auto* p = reinterpret_cast<const uint32_t*>(pixels());
-	const auto mask = pixel_format.rgba_to_uint32_t(0, 0, 0, 0xFF);
+namespace {
+	ImageOpacity ToImageOpacity(uint32_t and_alpha, uint32_t or_alpha, uint32_t alpha_mask) {
+		return
+			or_alpha == 0 ? ImageOpacity::Transparent :
+			and_alpha == alpha_mask ? ImageOpacity::Opaque :
+			ImageOpacity::Partial;
+	}
 
-	int n = GetSize() / sizeof(uint32_t);
-	for (int i = 0; i < n; ++i ) {
-		auto px = p[i] & mask;
-		all_opaque &= (px == mask);
-		all_transp &= (px == 0);
+	/** BitmapSimd::AlphaRow of palette indices, palette are the colors in pixel_format */
+	void IndexAlphaRow(const uint8_t* indices, int tiles, int tile_width, const uint32_t* palette,
+			uint32_t alpha_mask, uint32_t* and_alpha, uint32_t* or_alpha) {
+		for (int t = 0; t < tiles; ++t) {
+			uint32_t and_a = and_alpha[t];
+			uint32_t or_a = or_alpha[t];
+			for (int x = 0; x < tile_width; ++x) {
+				const uint32_t a = palette[*indices++] & alpha_mask;
+				and_a &= a;
+				or_a |= a;
+			}
+			and_alpha[t] = and_a;
+			or_alpha[t] = or_a;
+		}
 	}
+}
 
-	return
-		all_transp ? ImageOpacity::Transparent :
-		all_opaque ? ImageOpacity::Opaque :
-		ImageOpacity::Partial;
+ImageOpacity Bitmap::ComputeImageOpacity() const {
+	return ComputeImageOpacity(GetRect());
 }
 
 ImageOpacity Bitmap::ComputeImageOpacity(Rect rect) const {
-	bool all_opaque = true;
-	bool all_transp = true;
-
 	const auto full_rect = GetRect();
 	rect = full_rect.GetSubRect(rect);
 
@@ -225,20 +297,21 @@ ImageOpacity Bitmap::ComputeImageOpacity(Rect rect) const {
 	const int stride = pitch() / sizeof(uint32_t);
 	const auto mask = pixel_format.rgba_to_uint32_t(0, 0, 0, 0xFF);
 
-	int xend = (rect.x + rect.width);
-	int yend = (rect.y + rect.height);
-	for (int y = rect.y * stride; y < yend * stride; y += stride) {
-		for (int x = rect.x; x < xend; ++x) {
-			auto px = p[x + y] & mask;
-			all_transp &= (px == 0);
-			all_opaque &= (px == mask);
+	uint32_t and_alpha = mask;
+	uint32_t or_alpha = 0;
+	for (int y = rect.y; y < rect.y + rect.height; ++y) {
+		if (IsPaletted()) {
+			IndexAlphaRow(static_cast<const uint8_t*>(pixels()) + y * pitch() + rect.x, 1, rect.width,
+					index_palette->native, mask, &and_alpha, &or_alpha);
+		} else {
+			BitmapSimd::AlphaRow(p + y * stride + rect.x, 1, rect.width, mask, &and_alpha, &or_alpha);
+		}
+		if (and_alpha != mask && or_alpha != 0) {
+			return ImageOpacity::Partial;
 		}
 	}
 
-	return
-		all_transp ? ImageOpacity::Transparent :
-		all_opaque ? ImageOpacity::Opaque :
-		ImageOpacity::Partial;
+	return ToImageOpacity(and_alpha, or_alpha, mask);
 }
 
 void Bitmap::CheckPixels(uint32_t flags) {
@@ -259,11 +332,26 @@ void Bitmap::CheckPixels(uint32_t flags) {
 		const int w = width() / TILE_SIZE;
 		tile_opacity = TileOpacity(w, h);
 
+		// All tiles of a tile row are classified in one pass over its pixel rows
+		auto* p = reinterpret_cast<const uint32_t*>(pixels());
+		const int stride = pitch() / sizeof(uint32_t);
+		const auto mask = pixel_format.rgba_to_uint32_t(0, 0, 0, 0xFF);
+		std::vector<uint32_t> and_alpha(w);
+		std::vector<uint32_t> or_alpha(w);
+
 		for (int ty = 0; ty < h; ++ty) {
+			std::fill(and_alpha.begin(), and_alpha.end(), mask);
+			std::fill(or_alpha.begin(), or_alpha.end(), 0);
+			for (int y = ty * TILE_SIZE; y < (ty + 1) * TILE_SIZE; ++y) {
+				if (IsPaletted()) {
+					IndexAlphaRow(static_cast<const uint8_t*>(pixels()) + y * pitch(), w, TILE_SIZE,
+							index_palette->native, mask, and_alpha.data(), or_alpha.data());
+				} else {
+					BitmapSimd::AlphaRow(p + y * stride, w, TILE_SIZE, mask, and_alpha.data(), or_alpha.data());
+				}
+			}
 			for (int tx = 0; tx < w; ++tx) {
-				Rect rect(tx * TILE_SIZE, ty * TILE_SIZE, TILE_SIZE, TILE_SIZE);
-				auto op = ComputeImageOpacity(rect);
-				tile_opacity.Set(tx, ty, op);
+				tile_opacity.Set(tx, ty, ToImageOpacity(and_alpha[tx], or_alpha[tx], mask));
 			}
 		}
 	}
@@ -275,7 +363,13 @@ void Bitmap::CheckPixels(uint32_t flags) {
 	}
 }
 
+void Bitmap::CheckTilePixels(int x, int y) {
+	Rect rect(x * TILE_SIZE, y * TILE_SIZE, TILE_SIZE, TILE_SIZE);
+	tile_opacity.Set(x, y, ComputeImageOpacity(rect));
+}
+
 void Bitmap::HueChangeBlit(int x, int y, Bitmap const& src, Rect const& src_rect_, double hue_) {
+	++revision;
 	Rect dst_rect(x, y, 0, 0), src_rect = src_rect_;
 
 	if (!Rect::AdjustRectangles(src_rect, dst_rect, src.GetRect()))
@@ -295,15 +389,33 @@ void Bitmap::HueChangeBlit(int x, int y, Bitmap const& src, Rect const& src_rect
 	Bitmap bmp(reinterpret_cast<void*>(&pixels.front()), src_rect.width, src_rect.height, src_rect.width * 4, format);
 	bmp.Blit(0, 0, src, src_rect, Opacity::Opaque());
 
-	for (std::vector<uint32_t>::iterator p = pixels.begin(); p != pixels.end(); ++p) {
-		uint32_t pixel = *p;
+	// Graphics use few distinct colors, recent conversions are looked up
+	// instead of going through HSL again. A key of 0 never matches because
+	// transparent pixels are skipped.
+	constexpr size_t memo_size = 256;
+	std::array<uint32_t, memo_size> memo_key = {};
+	std::array<uint32_t, memo_size> memo_value = {};
+
+	for (auto& pixel: pixels) {
+		if ((pixel & 0xFF) == 0) {
+			continue;
+		}
+
+		const size_t slot = (pixel * 0x9E3779B1u) >> 24;
+		if (memo_key[slot] == pixel) {
+			pixel = memo_value[slot];
+			continue;
+		}
+
 		uint8_t r = (pixel>>24) & 0xFF;
 		uint8_t g = (pixel>>16) & 0xFF;
 		uint8_t b = (pixel>> 8) & 0xFF;
 		uint8_t a = pixel & 0xFF;
-		if (a > 0)
-			RGB_adjust_HSL(r, g, b, hue);
-		*p = ((uint32_t) r << 24) | ((uint32_t) g << 16) | ((uint32_t) b << 8) | (uint32_t) a;
+		RGB_adjust_HSL(r, g, b, hue);
+
+		memo_key[slot] = pixel;
+		pixel = ((uint32_t) r << 24) | ((uint32_t) g << 16) | ((uint32_t) b << 8) | (uint32_t) a;
+		memo_value[slot] = pixel;
 	}
 
 	Blit(dst_rect.x, dst_rect.y, bmp, bmp.GetRect(), Opacity::Opaque());
@@ -427,7 +539,17 @@ DynamicFormat Bitmap::opaque_pixel_format;
 DynamicFormat Bitmap::image_format;
 DynamicFormat Bitmap::opaque_image_format;
 
+#if defined(_3DS) || defined(GEKKO)
+bool Bitmap::paletted_storage = true;
+#else
+bool Bitmap::paletted_storage = false;
+#endif
+
+/** Blit kernels of pixel_format, nullptr when not supported */
+static const BitmapKernels::Kernels* kernels = nullptr;
+
 void Bitmap::SetFormat(const DynamicFormat& format) {
+	kernels = BitmapKernels::Select(format);
 	pixel_format = format;
 	opaque_pixel_format = format;
 	opaque_pixel_format.alpha_type = PF::NoAlpha;
@@ -458,10 +580,20 @@ DynamicFormat Bitmap::ChooseFormat(const DynamicFormat& format) {
 	}
 }
 
-static void destroy_func(pixman_image_t * /* image */, void *data) {
+static int64_t image_bytes(pixman_image_t* image) {
+	return static_cast<int64_t>(pixman_image_get_stride(image)) * pixman_image_get_height(image);
+}
+
+static void destroy_func(pixman_image_t* image, void *data) {
+	MemoryStats::Add(MemoryStats::Category::Bitmap, -image_bytes(image));
 	free(data);
 }
 
+static void pool_destroy_func(pixman_image_t* image, void *data) {
+	MemoryStats::Add(MemoryStats::Category::Bitmap, -image_bytes(image));
+	PixelPool::Free(data);
+}
+
 static pixman_indexed_t palette;
 static bool palette_initialized = false;
 
@@ -476,9 +608,23 @@ static void initialize_palette() {
 }
 
 void Bitmap::Init(int width, int height, void* data, int pitch, bool destroy) {
+	static std::atomic<uint32_t> next_id{0};
+	id = ++next_id;
+	++revision;
 	if (!pitch)
 		pitch = width * format.bytes;
 
+	// Pixel storage comes from the pool, rows are 32 bit aligned as required by pixman
+	bool pooled = false;
+	if (data == NULL && width > 0 && height > 0) {
+		pitch = (pitch + 3) & ~3;
+		data = PixelPool::Allocate(static_cast<size_t>(pitch) * height);
+		if (data == NULL) {
+			Output::Error("Couldn't allocate {}x{} image.", width, height);
+		}
+		pooled = true;
+	}
+
 	bitmap.reset(pixman_image_create_bits(pixman_format, width, height, (uint32_t*) data, pitch));
 
 	if (bitmap == NULL) {
@@ -490,8 +636,32 @@ void Bitmap::Init(int width, int height, void* data, int pitch, bool destroy) {
 		pixman_image_set_indexed(bitmap.get(), &palette);
 	}
 
-	if (data != NULL && destroy)
+	if (pooled)
+		pixman_image_set_destroy_function(bitmap.get(), pool_destroy_func, data);
+	else if (data != NULL && destroy)
 		pixman_image_set_destroy_function(bitmap.get(), destroy_func, data);
+
+	// Only owned pixels are accounted, the destroy functions subtract them again
+	if (pooled || (data != NULL && destroy))
+		MemoryStats::Add(MemoryStats::Category::Bitmap, image_bytes(bitmap.get()));
+}
+
+void Bitmap::InitPaletted(int width, int height, void* indices, const uint32_t* rgba) {
+	const auto alpha_type = GetTransparent() ? PF::Alpha : PF::NoAlpha;
+	format = DynamicFormat(8,8,0,8,0,8,0,8,0,alpha_type);
+	pixman_format = PIXMAN_c8;
+
+	index_palette = std::make_shared<IndexPalette>();
+	index_palette->indexed.color = true;
+	for (int i = 0; i < 256; ++i) {
+		uint8_t r, g, b, a;
+		image_format.uint32_to_rgba(rgba[i], r, g, b, a);
+		index_palette->indexed.rgba[i] = ((uint32_t)a << 24) | ((uint32_t)r << 16) | ((uint32_t)g << 8) | (uint32_t)b;
+		index_palette->native[i] = pixel_format.rgba_to_uint32_t(r, g, b, a);
+	}
+
+	Init(width, height, indices, ImagePalette::GetIndexPitch(width), true);
+	pixman_image_set_indexed(bitmap.get(), &index_palette->indexed);
 }
 
 void Bitmap::ConvertImage(int& width, int& height, void*& pixels, bool transparent) {
@@ -516,6 +686,7 @@ void Bitmap::ConvertImage(int& width, int& height, void*& pixels, bool transpare
 }
 
 void* Bitmap::pixels() {
+	++revision;
 	if (!bitmap) {
 		return nullptr;
 	}
@@ -568,9 +739,14 @@ namespace {
 
 		return mask;
 	}
+
+	bool IsNativeFormat(const DynamicFormat& format) {
+		return kernels && (Bitmap::pixel_format == format || Bitmap::opaque_pixel_format == format);
+	}
 } // anonymous namespace
 
 void Bitmap::Blit(int x, int y, Bitmap const& src, Rect const& src_rect, Opacity const& opacity) {
+	++revision;
 	if (opacity.IsTransparent()) {
 		return;
 	}
@@ -587,6 +763,7 @@ void Bitmap::Blit(int x, int y, Bitmap const& src, Rect const& src_rect, Opacity
 }
 
 void Bitmap::BlitFast(int x, int y, Bitmap const & src, Rect const & src_rect, Opacity const & opacity) {
+	++revision;
 	if (opacity.IsTransparent()) {
 		return;
 	}
@@ -602,8 +779,12 @@ void Bitmap::BlitFast(int x, int y, Bitmap const & src, Rect const & src_rect, O
 
 PixmanImagePtr Bitmap::GetSubimage(Bitmap const& src, const Rect& src_rect) {
 	uint8_t* pixels = (uint8_t*) src.pixels() + src_rect.x * src.bpp() + src_rect.y * src.pitch();
-	return PixmanImagePtr{ pixman_image_create_bits(src.pixman_format, src_rect.width, src_rect.height,
+	auto image = PixmanImagePtr{ pixman_image_create_bits(src.pixman_format, src_rect.width, src_rect.height,
 									(uint32_t*) pixels, src.pitch()) };
+	if (src.IsPaletted()) {
+		pixman_image_set_indexed(image.get(), &src.index_palette->indexed);
+	}
+	return image;
 }
 
 void Bitmap::TiledBlit(Rect const& src_rect, Bitmap const& src, Rect const& dst_rect, Opacity const& opacity) {
@@ -611,6 +792,7 @@ void Bitmap::TiledBlit(Rect const& src_rect, Bitmap const& src, Rect const& dst_
 }
 
 void Bitmap::TiledBlit(int ox, int oy, Rect const& src_rect, Bitmap const& src, Rect const& dst_rect, Opacity const& opacity) {
+	++revision;
 	if (opacity.IsTransparent()) {
 		return;
 	}
@@ -639,6 +821,7 @@ void Bitmap::StretchBlit(Bitmap const&  src, Rect const& src_rect, Opacity const
 }
 
 void Bitmap::StretchBlit(Rect const& dst_rect, Bitmap const& src, Rect const& src_rect, Opacity const& opacity) {
+	++revision;
 	if (opacity.IsTransparent()) {
 		return;
 	}
@@ -663,6 +846,11 @@ void Bitmap::StretchBlit(Rect const& dst_rect, Bitmap const& src, Rect const& sr
 }
 
 void Bitmap::WaverBlit(int x, int y, double zoom_x, double zoom_y, Bitmap const& src, Rect const& src_rect, int depth, double phase, Opacity const& opacity) {
+	if (zoom_x == 1.0 && zoom_y == 1.0 && WaverRowBlit(x, y, src, src_rect, depth, phase, opacity)) {
+		return;
+	}
+
+	++revision;
 	if (opacity.IsTransparent()) {
 		return;
 	}
@@ -708,6 +896,7 @@ static pixman_color_t PixmanColor(const Color &color) {
 }
 
 void Bitmap::Fill(const Color &color) {
+	++revision;
 	pixman_color_t pcolor = PixmanColor(color);
 
 	pixman_box32_t box = { 0, 0, width(), height() };
@@ -716,6 +905,7 @@ void Bitmap::Fill(const Color &color) {
 }
 
 void Bitmap::FillRect(Rect const& dst_rect, const Color &color) {
+	++revision;
 	pixman_color_t pcolor = PixmanColor(color);
 
 	auto timage = PixmanImagePtr{pixman_image_create_solid_fill(&pcolor)};
@@ -738,6 +928,7 @@ void Bitmap::Clear() {
 }
 
 void Bitmap::ClearRect(Rect const& dst_rect) {
+	++revision;
 	pixman_color_t pcolor = {};
 	pixman_box32_t box = {
 		dst_rect.x,
@@ -749,61 +940,21 @@ void Bitmap::ClearRect(Rect const& dst_rect) {
 	pixman_image_fill_boxes(PIXMAN_OP_CLEAR, bitmap.get(), &pcolor, 1, &box);
 }
 
-// Hard light lookup table mapping source color to destination color
-// FIXME: Replace this with std::array<std::array<uint8_t,256>,256> when we have C++17
-struct HardLightTable {
-	uint8_t table[256][256] = {};
-};
-
-static constexpr HardLightTable make_hard_light_lookup() {
-	HardLightTable hl;
-	for (int i = 0; i < 256; ++i) {
-		for (int j = 0; j < 256; ++j) {
-			int res = 0;
-			if (i <= 128)
-				res = (2 * i * j) / 255;
-			else
-				res = 255 - 2 * (255 - i) * (255 - j) / 255;
-			hl.table[i][j] = res > 255 ? 255 : res < 0 ? 0 : res;
-		}
-	}
-	return hl;
-}
-
-constexpr auto hard_light = make_hard_light_lookup();
-
-// Saturation Tone Inline: Changes a pixel saturation
-static inline void saturation_tone(uint32_t &src_pixel, int saturation, int rs, int gs, int bs, int as) {
-	// Algorithm from OpenPDN (MIT license)
-	// Transformation in Y'CbCr color space
-	uint8_t r = (src_pixel >> rs) & 0xFF;
-	uint8_t g = (src_pixel >> gs) & 0xFF;
-	uint8_t b = (src_pixel >> bs) & 0xFF;
-	uint8_t a = (src_pixel >> as) & 0xFF;
-
-	// Y' = 0.299 R' + 0.587 G' + 0.114 B'
-	uint8_t lum = (7471 * b + 38470 * g + 19595 * r) >> 16;
-
-	// Scale Cb/Cr by scale factor "sat"
-	int red = ((lum * 1024 + (r - lum) * saturation) >> 10);
-	red = red > 255 ? 255 : red < 0 ? 0 : red;
-	int green = ((lum * 1024 + (g - lum) * saturation) >> 10);
-	green = green > 255 ? 255 : green < 0 ? 0 : green;
-	int blue = ((lum * 1024 + (b - lum) * saturation) >> 10);
-	blue = blue > 255 ? 255 : blue < 0 ? 0 : blue;
-
-	src_pixel = ((uint32_t)red << rs) | ((uint32_t)green << gs) | ((uint32_t)blue << bs) | ((uint32_t)a << as);
+void Bitmap::SetClipRect(Rect const& clip_rect) {
+	pixman_region32_t region;
+	pixman_region32_init_rect(&region, clip_rect.x, clip_rect.y, clip_rect.width, clip_rect.height);
+	pixman_image_set_clip_region32(bitmap.get(), &region);
+	pixman_region32_fini(&region);
+	this->clip_rect = clip_rect;
 }
 
-// Color Tone Inline: Changes color of a pixel by hard light table
-static inline void color_tone(uint32_t &src_pixel, Tone tone, int rs, int gs, int bs, int as) {
-	src_pixel = ((uint32_t)hard_light.table[tone.red][(src_pixel >> rs) & 0xFF] << rs)
-		| ((uint32_t)hard_light.table[tone.green][(src_pixel >> gs) & 0xFF] << gs)
-		| ((uint32_t)hard_light.table[tone.blue][(src_pixel >> bs) & 0xFF] << bs)
-		| ((uint32_t)((src_pixel >> as) & 0xFF) << as);
+void Bitmap::ClearClipRect() {
+	pixman_image_set_clip_region32(bitmap.get(), nullptr);
+	clip_rect = Rect();
 }
 
 void Bitmap::ToneBlit(int x, int y, Bitmap const& src, Rect const& src_rect, const Tone &tone, Opacity const& opacity, bool check_alpha) {
+	++revision;
 	if (opacity.IsTransparent()) {
 		return;
 	}
@@ -828,96 +979,35 @@ void Bitmap::ToneBlit(int x, int y, Bitmap const& src, Rect const& src_rect, con
 		x, y,
 		src_rect.width, src_rect.height);
 
-	int as = pixel_format.a.shift;
-	int rs = pixel_format.r.shift;
-	int gs = pixel_format.g.shift;
-	int bs = pixel_format.b.shift;
+	BitmapSimd::ToneParams params;
+	params.rs = pixel_format.r.shift;
+	params.gs = pixel_format.g.shift;
+	params.bs = pixel_format.b.shift;
+	params.as = pixel_format.a.shift;
+	params.saturation = tone.gray != 128;
+	params.color = tone.red != 128 || tone.green != 128 || tone.blue != 128;
+	params.check_alpha = &src != this || check_alpha;
+	params.tone = tone;
+
+	if (!params.saturation && !params.color) {
+		return;
+	}
+
 	int next_row = pitch() / sizeof(uint32_t);
 	uint32_t* pixels = (uint32_t*)this->pixels();
-	pixels = pixels + (y - 1) * next_row + x;
+	pixels = pixels + y * next_row + x;
 
 	uint16_t limit_height = std::min<uint16_t>(src_rect.height, height());
 	uint16_t limit_width = std::min<uint16_t>(src_rect.width, width());
 
-	// If Saturation + Color:
-	if (tone.gray != 128 && (tone.red != 128 || tone.green != 128 || tone.blue != 128)) {
-		int sat = tone.gray > 128 ? 1024 + (tone.gray - 128) * 16 : tone.gray * 8;
-
-		if (&src != this || check_alpha) {
-			for (uint16_t i = 0; i < limit_height; ++i) {
-				pixels += next_row;
-				for (uint16_t j = 0; j < limit_width; ++j) {
-					if ((uint8_t)((pixels[j] >> as) & 0xFF) == 0)
-						continue;
-
-					saturation_tone(pixels[j], sat, rs, gs, bs, as);
-					color_tone(pixels[j], tone, rs, gs, bs, as);
-				}
-			}
-		}
-		else {
-			for (uint16_t i = 0; i < limit_height; ++i) {
-				pixels += next_row;
-				for (uint16_t j = 0; j < limit_width; ++j) {
-					saturation_tone(pixels[j], sat, rs, gs, bs, as);
-					color_tone(pixels[j], tone, rs, gs, bs, as);
-				}
-			}
-		}
-	}
-
-	// If Only Saturation:
-	else if (tone.gray != 128) {
-		int sat = tone.gray > 128 ? 1024 + (tone.gray - 128) * 16 : tone.gray * 8;
-
-		if (&src != this || check_alpha) {
-			for (uint16_t i = 0; i < limit_height; ++i) {
-				pixels += next_row;
-				for (uint16_t j = 0; j < limit_width; ++j) {
-					if ((uint8_t)((pixels[j] >> as) & 0xFF) == 0)
-						continue;
-
-					saturation_tone(pixels[j], sat, rs, gs, bs, as);
-				}
-			}
-		}
-		else {
-			for (uint16_t i = 0; i < limit_height; ++i) {
-				pixels += next_row;
-				for (uint16_t j = 0; j < limit_width; ++j) {
-					saturation_tone(pixels[j], sat, rs, gs, bs, as);
-				}
-			}
-		}
-	}
-
-	// If Only Color:
-	else if (tone.red != 128 || tone.green != 128 || tone.blue != 128) {
-		if (&src != this || check_alpha) {
-			for (uint16_t i = 0; i < limit_height; ++i) {
-				pixels += next_row;
-				for (uint16_t j = 0; j < limit_width; ++j) {
-					if ((uint8_t)((pixels[j] >> as) & 0xFF) == 0)
-						continue;
-
-					color_tone(pixels[j], tone, rs, gs, bs, as);
-				}
-			}
-		}
-		else {
-			for (uint16_t i = 0; i < limit_height; ++i) {
-				pixels += next_row;
-				for (uint16_t j = 0; j < limit_width; ++j) {
-					color_tone(pixels[j], tone, rs, gs, bs, as);
-				}
-			}
-		}
-
+	for (uint16_t i = 0; i < limit_height; ++i) {
+		BitmapSimd::ToneRow(pixels, limit_width, params);
+		pixels += next_row;
 	}
-
 }
 
 void Bitmap::BlendBlit(int x, int y, Bitmap const& src, Rect const& src_rect, const Color& color, Opacity const& opacity) {
+	++revision;
 	if (opacity.IsTransparent()) {
 		return;
 	}
@@ -936,6 +1026,35 @@ void Bitmap::BlendBlit(int x, int y, Bitmap const& src, Rect const& src_rect, co
 								 x, y,
 								 src_rect.width, src_rect.height);
 
+	Rect src_bounds = src_rect;
+	src_bounds.Adjust(src.GetRect());
+	if (IsNativeFormat(format) && IsNativeFormat(src.format) && src_bounds == src_rect) {
+		Rect clip(x, y, src_rect.width, src_rect.height);
+		clip.Adjust(GetClipRect());
+		if (clip.IsEmpty()) {
+			return;
+		}
+
+		// Same conversion of the color as the pixman solid fill
+		const pixman_color_t pcolor = PixmanColor(color);
+		const uint32_t packed = pixel_format.rgba_to_uint32_t(pcolor.red >> 8, pcolor.green >> 8, pcolor.blue >> 8, pcolor.alpha >> 8);
+		// The alpha channel of opaque bitmaps is undefined
+		const uint32_t mask_alpha = src.GetTransparent() ? 0 : pixel_format.a.mask;
+
+		const int dst_stride = pitch() / sizeof(uint32_t);
+		const int src_stride = src.pitch() / sizeof(uint32_t);
+		auto* dst_pixels = static_cast<uint32_t*>(pixels());
+		auto* src_pixels = static_cast<const uint32_t*>(src.pixels());
+		const int mask_x = src_rect.x + clip.x - x;
+
+		for (int dy = clip.y; dy < clip.y + clip.height; ++dy) {
+			const int sy = src_rect.y + dy - y;
+			kernels->blend(dst_pixels + dy * dst_stride + clip.x, src_pixels + sy * src_stride + mask_x,
+					clip.width, packed, mask_alpha);
+		}
+		return;
+	}
+
 	pixman_color_t tcolor = PixmanColor(color);
 	auto timage = PixmanImagePtr{ pixman_image_create_solid_fill(&tcolor) };
 
@@ -948,10 +1067,15 @@ void Bitmap::BlendBlit(int x, int y, Bitmap const& src, Rect const& src_rect, co
 }
 
 void Bitmap::FlipBlit(int x, int y, Bitmap const& src, Rect const& src_rect, bool horizontal, bool vertical, Opacity const& opacity) {
+	++revision;
 	if (opacity.IsTransparent()) {
 		return;
 	}
 
+	if (NearestBlit(x, y, src, src_rect, 1, 1, horizontal, vertical, opacity)) {
+		return;
+	}
+
 	bool has_xform = (horizontal || vertical);
 	const auto img_w = src.GetWidth();
 	const auto img_h = src.GetHeight();
@@ -976,6 +1100,7 @@ void Bitmap::FlipBlit(int x, int y, Bitmap const& src, Rect const& src_rect, boo
 }
 
 void Bitmap::Flip(bool horizontal, bool vertical) {
+	++revision;
 	if (!horizontal && !vertical) {
 		return;
 	}
@@ -983,6 +1108,22 @@ void Bitmap::Flip(bool horizontal, bool vertical) {
 	const auto h = GetHeight();
 	const auto p = pitch();
 
+	if (bpp() == 4 && clip_rect.IsEmpty()) {
+		const int stride = p / sizeof(uint32_t);
+		auto* data = static_cast<uint32_t*>(pixels());
+		if (vertical) {
+			for (int y = 0; y < h / 2; ++y) {
+				std::swap_ranges(data + y * stride, data + y * stride + w, data + (h - 1 - y) * stride);
+			}
+		}
+		if (horizontal) {
+			for (int y = 0; y < h; ++y) {
+				std::reverse(data + y * stride, data + y * stride + w);
+			}
+		}
+		return;
+	}
+
 	auto temp = PixmanImagePtr{ pixman_image_create_bits(pixman_format, w, h, nullptr, p) };
 
 	std::memcpy(pixman_image_get_data(temp.get()),
@@ -1000,6 +1141,7 @@ void Bitmap::Flip(bool horizontal, bool vertical) {
 }
 
 void Bitmap::MaskedBlit(Rect const& dst_rect, Bitmap const& mask, int mx, int my, Color const& color) {
+	++revision;
 	pixman_color_t tcolor = {
 		static_cast<uint16_t>(color.red << 8),
 		static_cast<uint16_t>(color.green << 8),
@@ -1017,6 +1159,7 @@ void Bitmap::MaskedBlit(Rect const& dst_rect, Bitmap const& mask, int mx, int my
 }
 
 void Bitmap::MaskedBlit(Rect const& dst_rect, Bitmap const& mask, int mx, int my, Bitmap const& src, int sx, int sy) {
+	++revision;
 	pixman_image_composite32(PIXMAN_OP_OVER,
 							 src.bitmap.get(), mask.bitmap.get(), bitmap.get(),
 							 sx, sy,
@@ -1040,6 +1183,61 @@ void Bitmap::Blit2x(Rect const& dst_rect, Bitmap const& src, Rect const& src_rec
 	pixman_image_set_transform(src.bitmap.get(), nullptr);
 }
 
+void Bitmap::ScaleBlit(int x, int y, Bitmap const& src, Rect const& src_rect, int zoom, int bands) {
+	assert(zoom >= 1);
+	const Rect dst_rect(x, y, src_rect.width * zoom, src_rect.height * zoom);
+
+	// The alpha channel is only copied when both have the same one
+	const bool same_layout = format.bits == 32 && src.format.bits == 32
+		&& format.r == src.format.r && format.g == src.format.g && format.b == src.format.b
+		&& (format.alpha_type == PF::NoAlpha || (format.a == src.format.a && format.alpha_type == src.format.alpha_type));
+	const bool inside = src_rect.x >= 0 && src_rect.y >= 0
+		&& src_rect.x + src_rect.width <= src.width() && src_rect.y + src_rect.height <= src.height()
+		&& x >= 0 && y >= 0 && dst_rect.x + dst_rect.width <= width() && dst_rect.y + dst_rect.height <= height();
+
+	if (!same_layout || !inside || src.IsPaletted()) {
+		++revision;
+		Transform xform = Transform::Scale(1.0 / zoom, 1.0 / zoom);
+		pixman_image_set_transform(src.bitmap.get(), &xform.matrix);
+		pixman_image_composite32(PIXMAN_OP_SRC,
+								 src.bitmap.get(), nullptr, bitmap.get(),
+								 src_rect.x * zoom, src_rect.y * zoom,
+								 0, 0,
+								 dst_rect.x, dst_rect.y,
+								 dst_rect.width, dst_rect.height);
+		pixman_image_set_transform(src.bitmap.get(), nullptr);
+		return;
+	}
+
+	++revision;
+	const auto* src_pixels = static_cast<const uint8_t*>(src.pixels()) + src_rect.y * src.pitch() + src_rect.x * 4;
+	auto* dst_pixels = static_cast<uint8_t*>(pixels()) + y * pitch() + x * 4;
+	const int src_pitch = src.pitch();
+	const int dst_pitch = pitch();
+	const size_t row_bytes = static_cast<size_t>(dst_rect.width) * 4;
+
+	// Every source row is scaled once, the copies of it are plain copies
+	auto scale_rows = [&](int band) {
+		const int first = src_rect.height * band / bands;
+		const int last = src_rect.height * (band + 1) / bands;
+		for (int sy = first; sy < last; ++sy) {
+			auto* dst_row = dst_pixels + sy * zoom * dst_pitch;
+			BitmapSimd::ScaleRow(reinterpret_cast<uint32_t*>(dst_row),
+				reinterpret_cast<const uint32_t*>(src_pixels + sy * src_pitch), src_rect.width, zoom);
+			for (int z = 1; z < zoom; ++z) {
+				memcpy(dst_row + z * dst_pitch, dst_row, row_bytes);
+			}
+		}
+	};
+
+	bands = std::max(1, std::min(bands, src_rect.height));
+	if (bands == 1) {
+		scale_rows(0);
+	} else {
+		JobSystem::ParallelFor(bands, scale_rows);
+	}
+}
+
 void Bitmap::EffectsBlit(int x, int y, int ox, int oy,
 						 Bitmap const& src, Rect const& src_rect,
 						 Opacity const& opacity,
@@ -1072,6 +1270,7 @@ void Bitmap::RotateZoomOpacityBlit(int x, int y, int ox, int oy,
 		Bitmap const& src, Rect const& src_rect,
 		double angle, double zoom_x, double zoom_y, Opacity const& opacity)
 {
+	++revision;
 	if (opacity.IsTransparent()) {
 		return;
 	}
@@ -1121,6 +1320,14 @@ void Bitmap::ZoomOpacityBlit(int x, int y, int ox, int oy,
 		return;
 	}
 
+	// Integer zoom is pixel repetition, pictures and battle animations mostly use 1x and 2x
+	const int izoom_x = static_cast<int>(zoom_x);
+	const int izoom_y = static_cast<int>(zoom_y);
+	if (izoom_x == zoom_x && izoom_y == zoom_y && izoom_x > 0 && izoom_y > 0
+			&& NearestBlit(x - ox * izoom_x, y - oy * izoom_y, src, src_rect, izoom_x, izoom_y, false, false, opacity)) {
+		return;
+	}
+
 	Rect dst_rect(
 		x - static_cast<int>(std::floor(ox * zoom_x)),
 		y - static_cast<int>(std::floor(oy * zoom_y)),
@@ -1129,6 +1336,154 @@ void Bitmap::ZoomOpacityBlit(int x, int y, int ox, int oy,
 	StretchBlit(dst_rect, src, src_rect, opacity);
 }
 
+bool Bitmap::NearestBlit(int x, int y, Bitmap const& src, Rect const& src_rect,
+		int zoom_x, int zoom_y, bool flip_x, bool flip_y, Opacity const& opacity) {
+	Rect src_bounds = src_rect;
+	src_bounds.Adjust(src.GetRect());
+	if (opacity.IsSplit() || &src == this || !IsNativeFormat(format) || !(src.IsPaletted() || IsNativeFormat(src.format))
+			|| src_rect.IsEmpty() || src_bounds != src_rect) {
+		return false;
+	}
+
+	++revision;
+	if (opacity.IsTransparent()) {
+		return true;
+	}
+
+	const Rect dst_rect(x, y, src_rect.width * zoom_x, src_rect.height * zoom_y);
+	Rect clip = dst_rect;
+	clip.Adjust(GetClipRect());
+	if (clip.IsEmpty()) {
+		return true;
+	}
+
+	// The alpha channel of opaque bitmaps is undefined, palettes have opaque colors
+	const uint32_t src_alpha = src.GetTransparent() || src.IsPaletted() ? 0 : pixel_format.a.mask;
+	const int op = opacity.Value();
+
+	const int dst_stride = pitch() / sizeof(uint32_t);
+	const int src_stride = src.pitch() / sizeof(uint32_t);
+	auto* dst_pixels = static_cast<uint32_t*>(pixels());
+	auto* src_pixels = static_cast<const uint32_t*>(src.pixels());
+
+	// Rows of paletted bitmaps are expanded first
+	std::vector<uint32_t> expanded;
+	if (src.IsPaletted()) {
+		expanded.resize(src_rect.width);
+	}
+
+	const int step_x = flip_x ? -1 : 1;
+	const int first_x = (clip.x - dst_rect.x) / zoom_x;
+	const int first_repeat = (clip.x - dst_rect.x) % zoom_x;
+
+	// Zoomed rows are widened into a buffer first
+	std::vector<uint32_t> row;
+	if (zoom_x > 1) {
+		row.resize(clip.width);
+	}
+
+	for (int dy = clip.y; dy < clip.y + clip.height; ++dy) {
+		int sy = (dy - dst_rect.y) / zoom_y;
+		if (flip_y) {
+			sy = src_rect.height - 1 - sy;
+		}
+
+		const uint32_t* src_row;
+		if (src.IsPaletted()) {
+			auto* indices = static_cast<const uint8_t*>(src.pixels()) + (src_rect.y + sy) * src.pitch() + src_rect.x;
+			ImagePalette::ExpandRow(expanded.data(), indices, src_rect.width, src.index_palette->native);
+			src_row = expanded.data();
+		} else {
+			src_row = src_pixels + (src_rect.y + sy) * src_stride + src_rect.x;
+		}
+		const uint32_t* sp = src_row + (flip_x ? src_rect.width - 1 - first_x : first_x);
+		uint32_t* dp = dst_pixels + dy * dst_stride + clip.x;
+
+		if (zoom_x == 1) {
+			kernels->over(dp, sp, clip.width, step_x, op, src_alpha);
+			continue;
+		}
+
+		int repeat = first_repeat;
+		for (int i = 0; i < clip.width; ++i) {
+			row[i] = *sp;
+			if (++repeat == zoom_x) {
+				repeat = 0;
+				sp += step_x;
+			}
+		}
+		kernels->over(dp, row.data(), clip.width, 1, op, src_alpha);
+	}
+
+	return true;
+}
+
+bool Bitmap::WaverRowBlit(int x, int y, Bitmap const& src, Rect const& src_rect, int depth, double phase, Opacity const& opacity) {
+	Rect src_bounds = src_rect;
+	src_bounds.Adjust(src.GetRect());
+	if (opacity.IsSplit() || &src == this || !IsNativeFormat(format) || !(src.IsPaletted() || IsNativeFormat(src.format))
+			|| src_rect.IsEmpty() || src_bounds != src_rect) {
+		return false;
+	}
+
+	++revision;
+	if (opacity.IsTransparent()) {
+		return true;
+	}
+
+	const Rect clip = GetClipRect();
+	const int first_y = std::max(y, clip.y);
+	const int last_y = std::min(y + src_rect.height, clip.y + clip.height);
+	if (first_y >= last_y) {
+		return true;
+	}
+
+	// The wave repeats every 32 rows, same formula as the pixman path
+	constexpr int wave_rows = 32;
+	int offsets[wave_rows];
+	for (int i = 0; i < wave_rows; ++i) {
+		offsets[i] = 2 * depth * std::sin(phase + i * (2 * M_PI) / 32.0);
+	}
+	// RPG_RT starts the effect from the top of the screen, see WaverBlit
+	const int yclip = y < 0 ? -y : 0;
+
+	const uint32_t src_alpha = src.GetTransparent() || src.IsPaletted() ? 0 : pixel_format.a.mask;
+	const int op = opacity.Value();
+
+	const int dst_stride = pitch() / sizeof(uint32_t);
+	const int src_stride = src.pitch() / sizeof(uint32_t);
+	auto* dst_pixels = static_cast<uint32_t*>(pixels());
+	auto* src_pixels = static_cast<const uint32_t*>(src.pixels());
+
+	std::vector<uint32_t> expanded;
+	if (src.IsPaletted()) {
+		expanded.resize(src_rect.width);
+	}
+
+	for (int dy = first_y; dy < last_y; ++dy) {
+		const int i = dy - y;
+		const int dx = x + offsets[(i - yclip) % wave_rows];
+		const int left = std::max(dx, clip.x);
+		const int right = std::min(dx + src_rect.width, clip.x + clip.width);
+		if (left >= right) {
+			continue;
+		}
+
+		const uint32_t* src_row;
+		if (src.IsPaletted()) {
+			auto* indices = static_cast<const uint8_t*>(src.pixels()) + (src_rect.y + i) * src.pitch() + src_rect.x;
+			ImagePalette::ExpandRow(expanded.data(), indices, src_rect.width, src.index_palette->native);
+			src_row = expanded.data();
+		} else {
+			src_row = src_pixels + (src_rect.y + i) * src_stride + src_rect.x;
+		}
+
+		kernels->over(dst_pixels + dy * dst_stride + left, src_row + (left - dx), right - left, 1, op, src_alpha);
+	}
+
+	return true;
+}
+
 pixman_op_t Bitmap::GetOperator(pixman_image_t* mask) const {
 	if (!mask && (!GetTransparent() || GetImageOpacity() == ImageOpacity::Opaque)) {
 		return PIXMAN_OP_SRC;
@@ -1138,6 +1493,7 @@ pixman_op_t Bitmap::GetOperator(pixman_image_t* mask) const {
 }
 
 void Bitmap::EdgeMirrorBlit(int x, int y, Bitmap const& src, Rect const& src_rect, bool mirror_x, bool mirror_y, Opacity const& opacity) {
+	++revision;
 	if (opacity.IsTransparent())
 		return;
 
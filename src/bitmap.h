@@ -101,6 +101,40 @@ public:
 	 */
 	static BitmapRef Create(void *pixels, int width, int height, int pitch, const DynamicFormat& format);
 
+	/**
+	 * Creates a surface on pixels in the screen format owned by another object,
+	 * e.g. a memory mapped file.
+	 *
+	 * @param storage kept alive as long as the bitmap exists
+	 * @param pixels pointer to pixel data inside of storage, 32 bit aligned.
+	 * @param width surface width.
+	 * @param height surface height.
+	 * @param pitch surface pitch, multiple of 4.
+	 * @param transparent whether the pixels are in the transparent screen format.
+	 * @return surface on the pixels
+	 */
+	static BitmapRef Create(std::shared_ptr<void> storage, void* pixels, int width, int height, int pitch, bool transparent);
+
+	/**
+	 * Creates a surface sharing the pixel data of another bitmap.
+	 * The view has its own clip rect, this allows drawing to disjoint
+	 * areas of the source from several threads.
+	 *
+	 * @param source bitmap to draw to, must outlive the view.
+	 * @return view of source
+	 */
+	static BitmapRef CreateView(Bitmap& source);
+
+	/**
+	 * Creates a surface sharing the pixel data of a part of another bitmap.
+	 * The view keeps the source alive.
+	 *
+	 * @param source bitmap containing the pixels
+	 * @param rect part of source, must be inside of it
+	 * @return view of the part of source
+	 */
+	static BitmapRef CreateView(const BitmapRef& source, const Rect& rect);
+
 	Bitmap(int width, int height, bool transparent);
 	Bitmap(const std::string& filename, bool transparent, uint32_t flags);
 	Bitmap(const uint8_t* data, unsigned bytes, bool transparent, uint32_t flags);
@@ -142,12 +176,52 @@ public:
 	 */
 	bool GetTransparent() const;
 
+	/**
+	 * Gets if the bitmap stores 8 bit palette indices.
+	 * Pixman expands the indices while blitting, drawing on the bitmap
+	 * is not supported.
+	 *
+	 * @return if bitmap is paletted.
+	 */
+	bool IsPaletted() const;
+
+	/**
+	 * @return whether the bitmap was checked with Flag_ReadOnly
+	 */
+	bool IsReadOnly() const;
+
+	/**
+	 * @return source of a view created of a part of a bitmap, nullptr otherwise
+	 * @see CreateView
+	 */
+	const Bitmap* GetViewSource() const;
+
+	/**
+	 * @return area of the view in GetViewSource
+	 */
+	const Rect& GetViewRect() const;
+
+	/**
+	 * Enables paletted storage of the images loaded with Flag_Paletted.
+	 * This needs a quarter of the memory, blitting from these bitmaps
+	 * is slower. Enabled by default on low memory platforms.
+	 *
+	 * @param enabled whether paletted storage is used
+	 */
+	static void SetPalettedStorage(bool enabled);
+
+	/** @return whether paletted storage is used */
+	static bool GetPalettedStorage();
+
 	enum Flags {
 		// Special handling for system graphic.
 		Flag_System = 1 << 1,
 		// Special handling for chipset graphic.
 		// Generates a tile opacity list.
 		Flag_Chipset = 1 << 2,
+		// Paletted images keep their 8 bit indices and the palette,
+		// when paletted storage is enabled. Requires Flag_ReadOnly.
+		Flag_Paletted = 1 << 3,
 		// Bitmap will not be written to. This allows blit optimisations because the
 		// opacity information will not change.
 		Flag_ReadOnly = 1 << 16
@@ -177,9 +251,17 @@ public:
 	 * Writes PNG converted bitmap to output stream.
 	 *
 	 * @param os output stream that PNG will be output.
+	 * @param compression zlib level, see ImagePNG::WritePNG
 	 * @return true if success, otherwise false.
 	 */
-	bool WritePNG(Filesystem_Stream::OutputStream&) const;
+	bool WritePNG(Filesystem_Stream::OutputStream& os, int compression = -1) const;
+
+	/**
+	 * Copies the pixels in the layout of ImagePNG::WritePNG.
+	 *
+	 * @param data receives width * height pixels, its capacity is reused
+	 */
+	void GetPNGPixels(std::vector<uint32_t>& data) const;
 
 	/**
 	 * Gets the background color
@@ -199,6 +281,15 @@ public:
 
 	void CheckPixels(uint32_t flags);
 
+	/**
+	 * Updates the opacity information of one tile after it was drawn to.
+	 * Bitmap must have been checked with the Bitmap::Flag_Chipset flag.
+	 *
+	 * @param x tile x coordinate
+	 * @param y tile y coordinate
+	 */
+	void CheckTilePixels(int x, int y);
+
 	/**
 	 * Draws text to bitmap using the Font::Default() font.
 	 *
@@ -419,6 +510,40 @@ public:
 	 */
 	void HueChangeBlit(int x, int y, Bitmap const& src, Rect const& src_rect, double hue);
 
+	/**
+	 * Restricts all following pixman based drawing operations on this
+	 * bitmap to the given rect.
+	 *
+	 * @param clip_rect area which can be drawn to.
+	 */
+	void SetClipRect(Rect const& clip_rect);
+
+	/**
+	 * Removes the clip rect set by SetClipRect.
+	 */
+	void ClearClipRect();
+
+	/**
+	 * @return area which can be drawn to, the whole bitmap when no clip rect is set
+	 */
+	Rect GetClipRect() const;
+
+	/**
+	 * Returns a counter which changes whenever the pixels of the bitmap
+	 * are modified. Used to detect changed images without comparing them.
+	 *
+	 * @return revision of the bitmap contents
+	 */
+	uint32_t GetRevision() const;
+
+	/**
+	 * Returns a number identifying the bitmap. Unlike the address it is
+	 * never reused, data derived from the bitmap can be cached with it.
+	 *
+	 * @return unique id of the bitmap
+	 */
+	uint32_t GetId() const;
+
 	/**
 	 * Adjusts bitmap tone.
 	 *
@@ -484,6 +609,20 @@ public:
 	 */
 	void Blit2x(Rect const& dst_rect, Bitmap const& src, Rect const& src_rect);
 
+	/**
+	 * Blits source bitmap scaled by an integer factor without filtering
+	 * and transparency. 32 bit bitmaps of the same color layout are scaled
+	 * with BitmapSimd::ScaleRow, optionally in bands on worker threads.
+	 *
+	 * @param x destination x position.
+	 * @param y destination y position.
+	 * @param src source bitmap.
+	 * @param src_rect source bitmap rectangle.
+	 * @param zoom scale factor, at least 1.
+	 * @param bands number of horizontal bands scaled by worker threads, 1 or less scales on the calling thread.
+	 */
+	void ScaleBlit(int x, int y, Bitmap const& src, Rect const& src_rect, int zoom, int bands = 1);
+
 	/**
 	 * Calculates the bounding rectangle of a transformed rectangle.
 	 *
@@ -546,6 +685,16 @@ protected:
 	pixman_format_code_t pixman_format;
 
 	void Init(int width, int height, void* data, int pitch = 0, bool destroy = true);
+
+	/**
+	 * Initializes a paletted bitmap.
+	 *
+	 * @param width bitmap width
+	 * @param height bitmap height
+	 * @param indices malloc-ed indices, ImagePalette::GetIndexPitch bytes per row, owned by the bitmap
+	 * @param rgba premultiplied colors of the 256 indices in image_format
+	 */
+	void InitPaletted(int width, int height, void* indices, const uint32_t* rgba);
 	void ConvertImage(int& width, int& height, void*& pixels, bool transparent);
 
 	static PixmanImagePtr GetSubimage(Bitmap const& src, const Rect& src_rect);
@@ -566,10 +715,82 @@ protected:
 
 	static pixman_format_code_t find_format(const DynamicFormat& format);
 
+	/**
+	 * Nearest neighbour blit with integer zoom and optional flipping in a
+	 * plain loop, without setting up a pixman transform.
+	 *
+	 * @param x destination x position.
+	 * @param y destination y position.
+	 * @param src source bitmap.
+	 * @param src_rect source bitmap rect.
+	 * @param zoom_x horizontal integer scale factor.
+	 * @param zoom_y vertical integer scale factor.
+	 * @param flip_x flip horizontally.
+	 * @param flip_y flip vertically.
+	 * @param opacity opacity.
+	 * @return false when the bitmaps or the opacity are not supported, nothing is drawn then.
+	 */
+	bool NearestBlit(int x, int y, Bitmap const& src, Rect const& src_rect,
+			int zoom_x, int zoom_y, bool flip_x, bool flip_y, Opacity const& opacity);
+
+	/**
+	 * Unzoomed WaverBlit in a plain loop, each row is blended by the blit
+	 * kernels instead of a pixman composite per row.
+	 *
+	 * @param x destination x position.
+	 * @param y destination y position.
+	 * @param src source bitmap.
+	 * @param src_rect source bitmap rect.
+	 * @param depth wave magnitude.
+	 * @param phase wave phase.
+	 * @param opacity opacity.
+	 * @return false when the bitmaps or the opacity are not supported, nothing is drawn then.
+	 */
+	bool WaverRowBlit(int x, int y, Bitmap const& src, Rect const& src_rect, int depth, double phase, Opacity const& opacity);
+
 	pixman_op_t GetOperator(pixman_image_t* mask = nullptr) const;
 	bool read_only = false;
+
+	/** Palette of paletted bitmaps, shared with their views */
+	struct IndexPalette {
+		/** Premultiplied a8r8g8b8 colors, used by pixman */
+		pixman_indexed_t indexed;
+		/** The colors in pixel_format, used by the blit kernels */
+		uint32_t native[256];
+	};
+	std::shared_ptr<IndexPalette> index_palette;
+
+	static bool paletted_storage;
+
+	/** Set by CreateView of a part of a bitmap */
+	BitmapRef view_source;
+	Rect view_rect;
+
+	/** Owner of external pixels, set by Create with a storage */
+	std::shared_ptr<void> pixel_storage;
+
+	/** Incremented on every modification of the pixels */
+	uint32_t revision = 0;
+
+	/** Assigned by Init */
+	uint32_t id = 0;
+
+	/** Set by SetClipRect, empty when drawing is not clipped */
+	Rect clip_rect;
 };
 
+inline Rect Bitmap::GetClipRect() const {
+	return clip_rect.IsEmpty() ? GetRect() : clip_rect;
+}
+
+inline uint32_t Bitmap::GetRevision() const {
+	return revision;
+}
+
+inline uint32_t Bitmap::GetId() const {
+	return id;
+}
+
 inline ImageOpacity Bitmap::GetImageOpacity() const {
 	return image_opacity;
 }
@@ -602,4 +823,28 @@ inline bool Bitmap::GetTransparent() const {
 	return format.alpha_type != PF::NoAlpha;
 }
 
+inline bool Bitmap::IsPaletted() const {
+	return index_palette != nullptr;
+}
+
+inline bool Bitmap::IsReadOnly() const {
+	return read_only;
+}
+
+inline const Bitmap* Bitmap::GetViewSource() const {
+	return view_source.get();
+}
+
+inline const Rect& Bitmap::GetViewRect() const {
+	return view_rect;
+}
+
+inline void Bitmap::SetPalettedStorage(bool enabled) {
+	paletted_storage = enabled;
+}
+
+inline bool Bitmap::GetPalettedStorage() {
+	return paletted_storage;
+}
+
 #endif
@@ -0,0 +1,128 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include "bitmap_atlas.h"
+#include "bitmap.h"
+
+constexpr int BitmapAtlas::page_size;
+constexpr int BitmapAtlas::max_image_size;
+
+namespace {
+	/** Transparent gap between the images, filtered GPU sampling does not reach the neighbours */
+	constexpr int spacing = 1;
+}
+
+BitmapRef BitmapAtlas::Pack(const BitmapRef& bitmap) {
+	if (!bitmap || bitmap->IsPaletted() || !bitmap->IsReadOnly() || bitmap->GetViewSource()) {
+		return bitmap;
+	}
+
+	const int width = bitmap->GetWidth();
+	const int height = bitmap->GetHeight();
+	if (width <= 0 || height <= 0 || width > max_image_size || height > max_image_size) {
+		return bitmap;
+	}
+
+	const bool transparent = bitmap->GetTransparent();
+	Page* target = nullptr;
+	Rect rect;
+	for (auto& page: pages) {
+		if (page.bitmap->GetTransparent() != transparent || page.bitmap->bpp() != bitmap->bpp()) {
+			continue;
+		}
+		if (page.bitmap.use_count() == 1 && !page.slots.empty()) {
+			// No view is left, start over
+			page.bitmap->Clear();
+			page.shelves.clear();
+			page.slots.clear();
+			page.used_height = 0;
+		}
+		if (Allocate(page, width, height, rect)) {
+			target = &page;
+			break;
+		}
+	}
+
+	if (!target) {
+		Page page;
+		page.bitmap = Bitmap::Create(page_size, page_size, transparent);
+		if (!page.bitmap || page.bitmap->bpp() != bitmap->bpp()) {
+			return bitmap;
+		}
+		page.bitmap->Clear();
+		pages.push_back(std::move(page));
+		target = &pages.back();
+		Allocate(*target, width, height, rect);
+	}
+
+	target->bitmap->BlitFast(rect.x, rect.y, *bitmap, bitmap->GetRect(), Opacity::Opaque());
+
+	auto view = Bitmap::CreateView(target->bitmap, rect);
+	view->CheckPixels(Bitmap::Flag_ReadOnly);
+	target->slots.push_back({ rect, view });
+	return view;
+}
+
+bool BitmapAtlas::Allocate(Page& page, int width, int height, Rect& rect) {
+	// Reuse the space of a freed view which is not much larger
+	for (auto& slot: page.slots) {
+		if (slot.view.expired() && width <= slot.rect.width && height <= slot.rect.height
+				&& height * 2 > slot.rect.height) {
+			page.bitmap->ClearRect(slot.rect);
+			rect = Rect(slot.rect.x, slot.rect.y, width, height);
+			slot = page.slots.back();
+			page.slots.pop_back();
+			return true;
+		}
+	}
+
+	const int cell_width = width + spacing;
+	const int cell_height = height + spacing;
+
+	// First shelf which is high enough without wasting more than half of it
+	for (auto& shelf: page.shelves) {
+		if (cell_height <= shelf.height && cell_height * 2 > shelf.height
+				&& shelf.used_width + cell_width <= page_size) {
+			rect = Rect(shelf.used_width, shelf.y, width, height);
+			shelf.used_width += cell_width;
+			return true;
+		}
+	}
+
+	if (page.used_height + cell_height > page_size) {
+		return false;
+	}
+
+	Shelf shelf;
+	shelf.y = page.used_height;
+	shelf.height = cell_height;
+	shelf.used_width = cell_width;
+	page.shelves.push_back(shelf);
+	page.used_height += cell_height;
+
+	rect = Rect(0, shelf.y, width, height);
+	return true;
+}
+
+void BitmapAtlas::Clear() {
+	pages.clear();
+}
+
+int BitmapAtlas::GetPageCount() const {
+	return static_cast<int>(pages.size());
+}
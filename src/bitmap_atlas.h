@@ -0,0 +1,80 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_BITMAP_ATLAS_H
+#define EP_BITMAP_ATLAS_H
+
+// Headers
+#include <memory>
+#include <vector>
+#include "system.h"
+#include "rect.h"
+
+/**
+ * Packs small read-only images into shared pages and hands out views of them.
+ * Images drawn from the same page can be batched by an AcceleratedRenderer,
+ * which draws the views with the texture of the page.
+ *
+ * Pages are filled in shelves. The space of a view is reused once the view
+ * was freed, a page without views holds new images only.
+ */
+class BitmapAtlas {
+public:
+	/** Width and height of the pages */
+	static constexpr int page_size = 512;
+	/** Largest width and height of a packed image */
+	static constexpr int max_image_size = 192;
+
+	/**
+	 * Copies an image into a page.
+	 *
+	 * @param bitmap image checked with Flag_ReadOnly
+	 * @return view of the copy, or bitmap when it is not packed
+	 */
+	BitmapRef Pack(const BitmapRef& bitmap);
+
+	/** Releases the pages, views keep their page alive */
+	void Clear();
+
+	/** @return number of pages */
+	int GetPageCount() const;
+
+private:
+	struct Slot {
+		Rect rect;
+		std::weak_ptr<Bitmap> view;
+	};
+
+	struct Shelf {
+		int y = 0;
+		int height = 0;
+		int used_width = 0;
+	};
+
+	struct Page {
+		BitmapRef bitmap;
+		std::vector<Shelf> shelves;
+		std::vector<Slot> slots;
+		int used_height = 0;
+	};
+
+	static bool Allocate(Page& page, int width, int height, Rect& rect);
+
+	std::vector<Page> pages;
+};
+
+#endif
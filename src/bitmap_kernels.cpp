@@ -0,0 +1,118 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include "bitmap_kernels.h"
+#include "bitmap.h"
+
+namespace {
+
+// Same rounding as the pixman combiners: x * a / 255 for all four channels
+inline uint32_t mul_un8x4(uint32_t x, uint32_t a) {
+	uint32_t rb = (x & 0xFF00FF) * a + 0x800080;
+	rb = ((rb + ((rb >> 8) & 0xFF00FF)) >> 8) & 0xFF00FF;
+	uint32_t ag = ((x >> 8) & 0xFF00FF) * a + 0x800080;
+	ag = (ag + ((ag >> 8) & 0xFF00FF)) & 0xFF00FF00;
+	return rb | ag;
+}
+
+// Saturated x + y for all four channels
+inline uint32_t add_un8x4(uint32_t x, uint32_t y) {
+	uint32_t rb = (x & 0xFF00FF) + (y & 0xFF00FF);
+	rb |= 0x1000100 - ((rb >> 8) & 0xFF00FF);
+	uint32_t ag = ((x >> 8) & 0xFF00FF) + ((y >> 8) & 0xFF00FF);
+	ag |= 0x1000100 - ((ag >> 8) & 0xFF00FF);
+	return (rb & 0xFF00FF) | ((ag & 0xFF00FF) << 8);
+}
+
+// Premultiplied (src IN opacity) OVER dst
+inline uint32_t over_un8x4(uint32_t src, uint32_t dst, int opacity, int alpha_shift) {
+	if (opacity < 255) {
+		src = mul_un8x4(src, opacity);
+	}
+	const uint32_t alpha = (src >> alpha_shift) & 0xFF;
+	if (alpha == 255) {
+		return src;
+	}
+	if (src == 0) {
+		return dst;
+	}
+	return add_un8x4(src, mul_un8x4(dst, 255 - alpha));
+}
+
+inline void OverRowImpl(uint32_t* dst, const uint32_t* src, int count, int src_step, int opacity, uint32_t src_alpha, int alpha_shift) {
+	for (int i = 0; i < count; ++i) {
+		dst[i] = over_un8x4(*src | src_alpha, dst[i], opacity, alpha_shift);
+		src += src_step;
+	}
+}
+
+inline void BlendRowImpl(uint32_t* dst, const uint32_t* mask, int count, uint32_t color, uint32_t mask_alpha, int alpha_shift) {
+	for (int i = 0; i < count; ++i) {
+		const int alpha = ((mask[i] | mask_alpha) >> alpha_shift) & 0xFF;
+		if (alpha != 0) {
+			dst[i] = over_un8x4(color, dst[i], alpha, alpha_shift);
+		}
+	}
+}
+
+template <int AS>
+void OverRow(uint32_t* dst, const uint32_t* src, int count, int src_step, int opacity, uint32_t src_alpha) {
+	OverRowImpl(dst, src, count, src_step, opacity, src_alpha, AS);
+}
+
+template <int AS>
+void BlendRow(uint32_t* dst, const uint32_t* mask, int count, uint32_t color, uint32_t mask_alpha) {
+	BlendRowImpl(dst, mask, count, color, mask_alpha, AS);
+}
+
+void OverRowDynamic(uint32_t* dst, const uint32_t* src, int count, int src_step, int opacity, uint32_t src_alpha) {
+	OverRowImpl(dst, src, count, src_step, opacity, src_alpha, Bitmap::pixel_format.a.shift);
+}
+
+void BlendRowDynamic(uint32_t* dst, const uint32_t* mask, int count, uint32_t color, uint32_t mask_alpha) {
+	BlendRowImpl(dst, mask, count, color, mask_alpha, Bitmap::pixel_format.a.shift);
+}
+
+// Alpha in bits 0-7
+constexpr BitmapKernels::Kernels kernels_alpha0 = { "alpha0", OverRow<0>, BlendRow<0> };
+// Alpha in bits 24-31
+constexpr BitmapKernels::Kernels kernels_alpha24 = { "alpha24", OverRow<24>, BlendRow<24> };
+constexpr BitmapKernels::Kernels kernels_dynamic = { "dynamic", OverRowDynamic, BlendRowDynamic };
+
+} // namespace
+
+const BitmapKernels::Kernels* BitmapKernels::Select(const DynamicFormat& format) {
+	// The kernels work on four 8 bit channels
+	if (format.bits != 32 || format.alpha_type != PF::Alpha
+			|| format.r.bits != 8 || format.g.bits != 8 || format.b.bits != 8 || format.a.bits != 8) {
+		return nullptr;
+	}
+
+	switch (format.a.shift) {
+		case 0:
+			return &kernels_alpha0;
+		case 24:
+			return &kernels_alpha24;
+		default:
+			return &kernels_dynamic;
+	}
+}
+
+const BitmapKernels::Kernels& BitmapKernels::Dynamic() {
+	return kernels_dynamic;
+}
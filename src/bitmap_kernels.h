@@ -0,0 +1,84 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_BITMAP_KERNELS_H
+#define EP_BITMAP_KERNELS_H
+
+// Headers
+#include <cstdint>
+#include "pixel_format.h"
+
+/**
+ * Blit kernels for premultiplied 32 bit pixels with 8 bit channels.
+ * The kernels are instantiated for every alpha position at compile time.
+ * The table matching Bitmap::pixel_format is picked once by
+ * Bitmap::SetFormat, so the format is not resolved per pixel or per call.
+ */
+namespace BitmapKernels {
+
+/**
+ * Composites a row: dst = (src IN opacity) OVER dst.
+ *
+ * @param dst destination row
+ * @param src first source pixel
+ * @param count number of pixels
+ * @param src_step distance between source pixels, -1 reads the row mirrored
+ * @param opacity opacity of the source (0-255)
+ * @param src_alpha or-ed into every source pixel, the alpha mask for opaque sources
+ */
+using OverRowFn = void(*)(uint32_t* dst, const uint32_t* src, int count, int src_step, int opacity, uint32_t src_alpha);
+
+/**
+ * Blends a color into a row, weighted by the alpha of a mask row:
+ * dst = (color IN mask alpha) OVER dst. mask may be the same row as dst.
+ *
+ * @param dst destination row
+ * @param mask row providing the alpha
+ * @param count number of pixels
+ * @param color premultiplied color in the pixel format
+ * @param mask_alpha or-ed into every mask pixel, the alpha mask for opaque masks
+ */
+using BlendRowFn = void(*)(uint32_t* dst, const uint32_t* mask, int count, uint32_t color, uint32_t mask_alpha);
+
+/** Kernel table of a pixel format */
+struct Kernels {
+	/** Name of the variant, for benchmarks and logging */
+	const char* name;
+	OverRowFn over;
+	BlendRowFn blend;
+};
+
+/**
+ * Picks the kernels for a pixel format.
+ *
+ * @param format pixel format of the bitmaps
+ * @return specialized kernels, the dynamic kernels when there is no
+ *         specialization or nullptr when the format is not supported
+ */
+const Kernels* Select(const DynamicFormat& format);
+
+/**
+ * Kernels reading the alpha position from Bitmap::pixel_format on every call.
+ * Fallback for 8 bit formats without a specialization.
+ *
+ * @return dynamic kernels
+ */
+const Kernels& Dynamic();
+
+} // namespace BitmapKernels
+
+#endif
@@ -0,0 +1,988 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include <cstring>
+#include "bitmap_simd.h"
+#include "cpu_features.h"
+#include "compiler.h"
+
+#if defined(EP_CPU_COMPILE_SSE2) || defined(EP_CPU_COMPILE_AVX2)
+#  include <immintrin.h>
+#endif
+#ifdef EP_CPU_COMPILE_NEON
+#  include <arm_neon.h>
+#endif
+#ifdef EP_CPU_COMPILE_WASM_SIMD
+#  include <wasm_simd128.h>
+#endif
+
+namespace {
+
+// Hard light lookup table mapping source color to destination color
+// FIXME: Replace this with std::array<std::array<uint8_t,256>,256> when we have C++17
+struct HardLightTable {
+	uint8_t table[256][256] = {};
+};
+
+constexpr HardLightTable make_hard_light_lookup() {
+	HardLightTable hl;
+	for (int i = 0; i < 256; ++i) {
+		for (int j = 0; j < 256; ++j) {
+			int res = 0;
+			if (i <= 128)
+				res = (2 * i * j) / 255;
+			else
+				res = 255 - 2 * (255 - i) * (255 - j) / 255;
+			hl.table[i][j] = res > 255 ? 255 : res < 0 ? 0 : res;
+		}
+	}
+	return hl;
+}
+
+constexpr auto hard_light = make_hard_light_lookup();
+
+// Saturation Tone Inline: Changes a pixel saturation
+inline void saturation_tone(uint32_t &src_pixel, int saturation, int rs, int gs, int bs, int as) {
+	// Algorithm from OpenPDN (MIT license)
+	// Transformation in Y'CbCr color space
+	uint8_t r = (src_pixel >> rs) & 0xFF;
+	uint8_t g = (src_pixel >> gs) & 0xFF;
+	uint8_t b = (src_pixel >> bs) & 0xFF;
+	uint8_t a = (src_pixel >> as) & 0xFF;
+
+	// Y' = 0.299 R' + 0.587 G' + 0.114 B'
+	uint8_t lum = (7471 * b + 38470 * g + 19595 * r) >> 16;
+
+	// Scale Cb/Cr by scale factor "sat"
+	int red = ((lum * 1024 + (r - lum) * saturation) >> 10);
+	red = red > 255 ? 255 : red < 0 ? 0 : red;
+	int green = ((lum * 1024 + (g - lum) * saturation) >> 10);
+	green = green > 255 ? 255 : green < 0 ? 0 : green;
+	int blue = ((lum * 1024 + (b - lum) * saturation) >> 10);
+	blue = blue > 255 ? 255 : blue < 0 ? 0 : blue;
+
+	src_pixel = ((uint32_t)red << rs) | ((uint32_t)green << gs) | ((uint32_t)blue << bs) | ((uint32_t)a << as);
+}
+
+// Color Tone Inline: Changes color of a pixel by hard light table
+inline void color_tone(uint32_t &src_pixel, Tone tone, int rs, int gs, int bs, int as) {
+	src_pixel = ((uint32_t)hard_light.table[tone.red][(src_pixel >> rs) & 0xFF] << rs)
+		| ((uint32_t)hard_light.table[tone.green][(src_pixel >> gs) & 0xFF] << gs)
+		| ((uint32_t)hard_light.table[tone.blue][(src_pixel >> bs) & 0xFF] << bs)
+		| ((uint32_t)((src_pixel >> as) & 0xFF) << as);
+}
+
+template <bool Saturation, bool Color, bool CheckAlpha>
+void ToneRowScalarImpl(uint32_t* pixels, int count, const BitmapSimd::ToneParams& p) {
+	const int sat = p.GetSaturationFactor();
+
+	for (int i = 0; i < count; ++i) {
+		if (CheckAlpha && (uint8_t)((pixels[i] >> p.as) & 0xFF) == 0) {
+			continue;
+		}
+		if (Saturation) {
+			saturation_tone(pixels[i], sat, p.rs, p.gs, p.bs, p.as);
+		}
+		if (Color) {
+			color_tone(pixels[i], p.tone, p.rs, p.gs, p.bs, p.as);
+		}
+	}
+}
+
+/**
+ * The hard light function is evaluated arithmetically by the vector kernels:
+ * For a tone value t <= 128 it is (k * c) / 255 with k = 2 * t,
+ * otherwise it is 255 - (k * (255 - c)) / 255 with k = 2 * (255 - t).
+ * Both forms are expressed as min(((c ^ flip) * k) / 255, 255) ^ flip.
+ */
+struct HardLightCoeff {
+	int k;
+	int flip;
+};
+
+constexpr HardLightCoeff make_hard_light_coeff(int t) {
+	return t <= 128 ? HardLightCoeff{ 2 * t, 0 } : HardLightCoeff{ 2 * (255 - t), 0xFF };
+}
+
+// Luminance weights, green is split because 38470 does not fit into an int16 multiplier
+constexpr int lum_weight_r = 19595;
+constexpr int lum_weight_g_half = 19235;
+constexpr int lum_weight_b = 7471;
+
+template <template <bool, bool, bool> class Impl>
+void DispatchToneRow(uint32_t* pixels, int count, const BitmapSimd::ToneParams& p) {
+	if (p.saturation && p.color) {
+		p.check_alpha ? Impl<true, true, true>::Run(pixels, count, p) : Impl<true, true, false>::Run(pixels, count, p);
+	} else if (p.saturation) {
+		p.check_alpha ? Impl<true, false, true>::Run(pixels, count, p) : Impl<true, false, false>::Run(pixels, count, p);
+	} else if (p.color) {
+		p.check_alpha ? Impl<false, true, true>::Run(pixels, count, p) : Impl<false, true, false>::Run(pixels, count, p);
+	}
+}
+
+template <bool Saturation, bool Color, bool CheckAlpha>
+struct ToneScalar {
+	static void Run(uint32_t* pixels, int count, const BitmapSimd::ToneParams& p) {
+		ToneRowScalarImpl<Saturation, Color, CheckAlpha>(pixels, count, p);
+	}
+};
+
+#ifdef EP_CPU_COMPILE_SSE2
+// Exact floor(x / 255) for 0 <= x < 65535
+inline __m128i div255_sse2(__m128i x) {
+	return _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(x, _mm_set1_epi32(1)), _mm_srli_epi32(x, 8)), 8);
+}
+
+inline __m128i clamp_u8_sse2(__m128i x) {
+	x = _mm_andnot_si128(_mm_srai_epi32(x, 31), x);
+	const __m128i max = _mm_set1_epi32(255);
+	const __m128i over = _mm_cmpgt_epi32(x, max);
+	return _mm_or_si128(_mm_and_si128(over, max), _mm_andnot_si128(over, x));
+}
+
+inline __m128i hard_light_sse2(__m128i c, __m128i k, __m128i flip) {
+	// k and the channel fit into 16 bit, madd with a zero upper half is a 32 bit multiply.
+	// The result is at most 256 (k = 256), a 16 bit min is enough to clamp it.
+	const __m128i q = _mm_min_epi16(div255_sse2(_mm_madd_epi16(_mm_xor_si128(c, flip), k)), _mm_set1_epi32(255));
+	return _mm_xor_si128(q, flip);
+}
+
+template <bool Saturation, bool Color, bool CheckAlpha>
+struct ToneSSE2 {
+	static void Run(uint32_t* pixels, int count, const BitmapSimd::ToneParams& p) {
+		const __m128i rs = _mm_cvtsi32_si128(p.rs);
+		const __m128i gs = _mm_cvtsi32_si128(p.gs);
+		const __m128i bs = _mm_cvtsi32_si128(p.bs);
+		const __m128i byte_mask = _mm_set1_epi32(0xFF);
+		const __m128i alpha_mask = _mm_set1_epi32((int)(0xFFu << p.as));
+
+		const __m128i sat = _mm_set1_epi32(p.GetSaturationFactor());
+		const __m128i wr = _mm_set1_epi32(lum_weight_r);
+		const __m128i wg = _mm_set1_epi32(lum_weight_g_half);
+		const __m128i wb = _mm_set1_epi32(lum_weight_b);
+
+		const auto cr = make_hard_light_coeff(p.tone.red);
+		const auto cg = make_hard_light_coeff(p.tone.green);
+		const auto cb = make_hard_light_coeff(p.tone.blue);
+		const __m128i kr = _mm_set1_epi32(cr.k), fr = _mm_set1_epi32(cr.flip);
+		const __m128i kg = _mm_set1_epi32(cg.k), fg = _mm_set1_epi32(cg.flip);
+		const __m128i kb = _mm_set1_epi32(cb.k), fb = _mm_set1_epi32(cb.flip);
+
+		int i = 0;
+		for (; i + 4 <= count; i += 4) {
+			const __m128i px = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels + i));
+			__m128i r = _mm_and_si128(_mm_srl_epi32(px, rs), byte_mask);
+			__m128i g = _mm_and_si128(_mm_srl_epi32(px, gs), byte_mask);
+			__m128i b = _mm_and_si128(_mm_srl_epi32(px, bs), byte_mask);
+			const __m128i a = _mm_and_si128(px, alpha_mask);
+
+			if (Saturation) {
+				__m128i lum = _mm_add_epi32(_mm_madd_epi16(r, wr), _mm_madd_epi16(b, wb));
+				lum = _mm_add_epi32(lum, _mm_slli_epi32(_mm_madd_epi16(g, wg), 1));
+				lum = _mm_srli_epi32(lum, 16);
+				const __m128i lum10 = _mm_slli_epi32(lum, 10);
+
+				r = clamp_u8_sse2(_mm_srai_epi32(_mm_add_epi32(lum10, _mm_madd_epi16(_mm_sub_epi32(r, lum), sat)), 10));
+				g = clamp_u8_sse2(_mm_srai_epi32(_mm_add_epi32(lum10, _mm_madd_epi16(_mm_sub_epi32(g, lum), sat)), 10));
+				b = clamp_u8_sse2(_mm_srai_epi32(_mm_add_epi32(lum10, _mm_madd_epi16(_mm_sub_epi32(b, lum), sat)), 10));
+			}
+
+			if (Color) {
+				r = hard_light_sse2(r, kr, fr);
+				g = hard_light_sse2(g, kg, fg);
+				b = hard_light_sse2(b, kb, fb);
+			}
+
+			__m128i out = _mm_or_si128(_mm_or_si128(_mm_sll_epi32(r, rs), _mm_sll_epi32(g, gs)),
+					_mm_or_si128(_mm_sll_epi32(b, bs), a));
+
+			if (CheckAlpha) {
+				const __m128i keep = _mm_cmpeq_epi32(a, _mm_setzero_si128());
+				out = _mm_or_si128(_mm_and_si128(keep, px), _mm_andnot_si128(keep, out));
+			}
+
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(pixels + i), out);
+		}
+
+		ToneRowScalarImpl<Saturation, Color, CheckAlpha>(pixels + i, count - i, p);
+	}
+};
+#endif
+
+#ifdef EP_CPU_COMPILE_AVX2
+EP_TARGET_AVX2 inline __m256i div255_avx2(__m256i x) {
+	return _mm256_srli_epi32(_mm256_add_epi32(_mm256_add_epi32(x, _mm256_set1_epi32(1)), _mm256_srli_epi32(x, 8)), 8);
+}
+
+EP_TARGET_AVX2 inline __m256i clamp_u8_avx2(__m256i x) {
+	return _mm256_min_epi32(_mm256_max_epi32(x, _mm256_setzero_si256()), _mm256_set1_epi32(255));
+}
+
+EP_TARGET_AVX2 inline __m256i hard_light_avx2(__m256i c, __m256i k, __m256i flip) {
+	const __m256i q = _mm256_min_epi32(div255_avx2(_mm256_madd_epi16(_mm256_xor_si256(c, flip), k)), _mm256_set1_epi32(255));
+	return _mm256_xor_si256(q, flip);
+}
+
+template <bool Saturation, bool Color, bool CheckAlpha>
+struct ToneAVX2 {
+	EP_TARGET_AVX2 static void Run(uint32_t* pixels, int count, const BitmapSimd::ToneParams& p) {
+		const __m128i rs = _mm_cvtsi32_si128(p.rs);
+		const __m128i gs = _mm_cvtsi32_si128(p.gs);
+		const __m128i bs = _mm_cvtsi32_si128(p.bs);
+		const __m256i byte_mask = _mm256_set1_epi32(0xFF);
+		const __m256i alpha_mask = _mm256_set1_epi32((int)(0xFFu << p.as));
+
+		const __m256i sat = _mm256_set1_epi32(p.GetSaturationFactor());
+		const __m256i wr = _mm256_set1_epi32(lum_weight_r);
+		const __m256i wg = _mm256_set1_epi32(lum_weight_g_half);
+		const __m256i wb = _mm256_set1_epi32(lum_weight_b);
+
+		const auto cr = make_hard_light_coeff(p.tone.red);
+		const auto cg = make_hard_light_coeff(p.tone.green);
+		const auto cb = make_hard_light_coeff(p.tone.blue);
+		const __m256i kr = _mm256_set1_epi32(cr.k), fr = _mm256_set1_epi32(cr.flip);
+		const __m256i kg = _mm256_set1_epi32(cg.k), fg = _mm256_set1_epi32(cg.flip);
+		const __m256i kb = _mm256_set1_epi32(cb.k), fb = _mm256_set1_epi32(cb.flip);
+
+		int i = 0;
+		for (; i + 8 <= count; i += 8) {
+			const __m256i px = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pixels + i));
+			__m256i r = _mm256_and_si256(_mm256_srl_epi32(px, rs), byte_mask);
+			__m256i g = _mm256_and_si256(_mm256_srl_epi32(px, gs), byte_mask);
+			__m256i b = _mm256_and_si256(_mm256_srl_epi32(px, bs), byte_mask);
+			const __m256i a = _mm256_and_si256(px, alpha_mask);
+
+			if (Saturation) {
+				__m256i lum = _mm256_add_epi32(_mm256_madd_epi16(r, wr), _mm256_madd_epi16(b, wb));
+				lum = _mm256_add_epi32(lum, _mm256_slli_epi32(_mm256_madd_epi16(g, wg), 1));
+				lum = _mm256_srli_epi32(lum, 16);
+				const __m256i lum10 = _mm256_slli_epi32(lum, 10);
+
+				r = clamp_u8_avx2(_mm256_srai_epi32(_mm256_add_epi32(lum10, _mm256_madd_epi16(_mm256_sub_epi32(r, lum), sat)), 10));
+				g = clamp_u8_avx2(_mm256_srai_epi32(_mm256_add_epi32(lum10, _mm256_madd_epi16(_mm256_sub_epi32(g, lum), sat)), 10));
+				b = clamp_u8_avx2(_mm256_srai_epi32(_mm256_add_epi32(lum10, _mm256_madd_epi16(_mm256_sub_epi32(b, lum), sat)), 10));
+			}
+
+			if (Color) {
+				r = hard_light_avx2(r, kr, fr);
+				g = hard_light_avx2(g, kg, fg);
+				b = hard_light_avx2(b, kb, fb);
+			}
+
+			__m256i out = _mm256_or_si256(_mm256_or_si256(_mm256_sll_epi32(r, rs), _mm256_sll_epi32(g, gs)),
+					_mm256_or_si256(_mm256_sll_epi32(b, bs), a));
+
+			if (CheckAlpha) {
+				const __m256i keep = _mm256_cmpeq_epi32(a, _mm256_setzero_si256());
+				out = _mm256_blendv_epi8(out, px, keep);
+			}
+
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(pixels + i), out);
+		}
+
+		ToneRowScalarImpl<Saturation, Color, CheckAlpha>(pixels + i, count - i, p);
+	}
+};
+#endif
+
+#ifdef EP_CPU_COMPILE_NEON
+inline uint32x4_t div255_neon(uint32x4_t x) {
+	return vshrq_n_u32(vaddq_u32(vaddq_u32(x, vdupq_n_u32(1)), vshrq_n_u32(x, 8)), 8);
+}
+
+inline uint32x4_t hard_light_neon(uint32x4_t c, uint32_t k, uint32x4_t flip) {
+	const uint32x4_t q = vminq_u32(div255_neon(vmulq_n_u32(veorq_u32(c, flip), k)), vdupq_n_u32(255));
+	return veorq_u32(q, flip);
+}
+
+inline uint32x4_t saturate_neon(uint32x4_t c, int32x4_t lum, int32x4_t lum10, int32_t sat) {
+	int32x4_t x = vmlaq_n_s32(lum10, vsubq_s32(vreinterpretq_s32_u32(c), lum), sat);
+	x = vshrq_n_s32(x, 10);
+	x = vminq_s32(vmaxq_s32(x, vdupq_n_s32(0)), vdupq_n_s32(255));
+	return vreinterpretq_u32_s32(x);
+}
+
+template <bool Saturation, bool Color, bool CheckAlpha>
+struct ToneNEON {
+	static void Run(uint32_t* pixels, int count, const BitmapSimd::ToneParams& p) {
+		const int32x4_t rs = vdupq_n_s32(p.rs), rs_neg = vdupq_n_s32(-p.rs);
+		const int32x4_t gs = vdupq_n_s32(p.gs), gs_neg = vdupq_n_s32(-p.gs);
+		const int32x4_t bs = vdupq_n_s32(p.bs), bs_neg = vdupq_n_s32(-p.bs);
+		const uint32x4_t byte_mask = vdupq_n_u32(0xFF);
+		const uint32x4_t alpha_mask = vdupq_n_u32(0xFFu << p.as);
+		const int32_t sat = p.GetSaturationFactor();
+
+		const auto cr = make_hard_light_coeff(p.tone.red);
+		const auto cg = make_hard_light_coeff(p.tone.green);
+		const auto cb = make_hard_light_coeff(p.tone.blue);
+		const uint32x4_t fr = vdupq_n_u32(cr.flip);
+		const uint32x4_t fg = vdupq_n_u32(cg.flip);
+		const uint32x4_t fb = vdupq_n_u32(cb.flip);
+
+		int i = 0;
+		for (; i + 4 <= count; i += 4) {
+			const uint32x4_t px = vld1q_u32(pixels + i);
+			uint32x4_t r = vandq_u32(vshlq_u32(px, rs_neg), byte_mask);
+			uint32x4_t g = vandq_u32(vshlq_u32(px, gs_neg), byte_mask);
+			uint32x4_t b = vandq_u32(vshlq_u32(px, bs_neg), byte_mask);
+			const uint32x4_t a = vandq_u32(px, alpha_mask);
+
+			if (Saturation) {
+				uint32x4_t lum_u = vmulq_n_u32(r, lum_weight_r);
+				lum_u = vmlaq_n_u32(lum_u, g, 2 * lum_weight_g_half);
+				lum_u = vmlaq_n_u32(lum_u, b, lum_weight_b);
+				const int32x4_t lum = vreinterpretq_s32_u32(vshrq_n_u32(lum_u, 16));
+				const int32x4_t lum10 = vshlq_n_s32(lum, 10);
+
+				r = saturate_neon(r, lum, lum10, sat);
+				g = saturate_neon(g, lum, lum10, sat);
+				b = saturate_neon(b, lum, lum10, sat);
+			}
+
+			if (Color) {
+				r = hard_light_neon(r, cr.k, fr);
+				g = hard_light_neon(g, cg.k, fg);
+				b = hard_light_neon(b, cb.k, fb);
+			}
+
+			uint32x4_t out = vorrq_u32(vorrq_u32(vshlq_u32(r, rs), vshlq_u32(g, gs)),
+					vorrq_u32(vshlq_u32(b, bs), a));
+
+			if (CheckAlpha) {
+				out = vbslq_u32(vceqq_u32(a, vdupq_n_u32(0)), px, out);
+			}
+
+			vst1q_u32(pixels + i, out);
+		}
+
+		ToneRowScalarImpl<Saturation, Color, CheckAlpha>(pixels + i, count - i, p);
+	}
+};
+#endif
+
+#ifdef EP_CPU_COMPILE_WASM_SIMD
+inline v128_t div255_wasm(v128_t x) {
+	return wasm_u32x4_shr(wasm_i32x4_add(wasm_i32x4_add(x, wasm_i32x4_splat(1)), wasm_u32x4_shr(x, 8)), 8);
+}
+
+inline v128_t hard_light_wasm(v128_t c, v128_t k, v128_t flip) {
+	const v128_t q = wasm_u32x4_min(div255_wasm(wasm_i32x4_mul(wasm_v128_xor(c, flip), k)), wasm_i32x4_splat(255));
+	return wasm_v128_xor(q, flip);
+}
+
+inline v128_t saturate_wasm(v128_t c, v128_t lum, v128_t lum10, v128_t sat) {
+	v128_t x = wasm_i32x4_add(lum10, wasm_i32x4_mul(wasm_i32x4_sub(c, lum), sat));
+	x = wasm_i32x4_shr(x, 10);
+	return wasm_i32x4_min(wasm_i32x4_max(x, wasm_i32x4_splat(0)), wasm_i32x4_splat(255));
+}
+
+template <bool Saturation, bool Color, bool CheckAlpha>
+struct ToneWasmSimd {
+	static void Run(uint32_t* pixels, int count, const BitmapSimd::ToneParams& p) {
+		const v128_t byte_mask = wasm_i32x4_splat(0xFF);
+		const v128_t alpha_mask = wasm_i32x4_splat(static_cast<int32_t>(0xFFu << p.as));
+
+		const v128_t sat = wasm_i32x4_splat(p.GetSaturationFactor());
+		const v128_t wr = wasm_i32x4_splat(lum_weight_r);
+		const v128_t wg = wasm_i32x4_splat(2 * lum_weight_g_half);
+		const v128_t wb = wasm_i32x4_splat(lum_weight_b);
+
+		const auto cr = make_hard_light_coeff(p.tone.red);
+		const auto cg = make_hard_light_coeff(p.tone.green);
+		const auto cb = make_hard_light_coeff(p.tone.blue);
+		const v128_t kr = wasm_i32x4_splat(cr.k), fr = wasm_i32x4_splat(cr.flip);
+		const v128_t kg = wasm_i32x4_splat(cg.k), fg = wasm_i32x4_splat(cg.flip);
+		const v128_t kb = wasm_i32x4_splat(cb.k), fb = wasm_i32x4_splat(cb.flip);
+
+		int i = 0;
+		for (; i + 4 <= count; i += 4) {
+			const v128_t px = wasm_v128_load(pixels + i);
+			v128_t r = wasm_v128_and(wasm_u32x4_shr(px, p.rs), byte_mask);
+			v128_t g = wasm_v128_and(wasm_u32x4_shr(px, p.gs), byte_mask);
+			v128_t b = wasm_v128_and(wasm_u32x4_shr(px, p.bs), byte_mask);
+			const v128_t a = wasm_v128_and(px, alpha_mask);
+
+			if (Saturation) {
+				// The weighted sum is below 2^24, a 32 bit multiply does not overflow
+				v128_t lum = wasm_i32x4_add(wasm_i32x4_mul(r, wr), wasm_i32x4_mul(b, wb));
+				lum = wasm_u32x4_shr(wasm_i32x4_add(lum, wasm_i32x4_mul(g, wg)), 16);
+				const v128_t lum10 = wasm_i32x4_shl(lum, 10);
+
+				r = saturate_wasm(r, lum, lum10, sat);
+				g = saturate_wasm(g, lum, lum10, sat);
+				b = saturate_wasm(b, lum, lum10, sat);
+			}
+
+			if (Color) {
+				r = hard_light_wasm(r, kr, fr);
+				g = hard_light_wasm(g, kg, fg);
+				b = hard_light_wasm(b, kb, fb);
+			}
+
+			v128_t out = wasm_v128_or(wasm_v128_or(wasm_i32x4_shl(r, p.rs), wasm_i32x4_shl(g, p.gs)),
+					wasm_v128_or(wasm_i32x4_shl(b, p.bs), a));
+
+			if (CheckAlpha) {
+				out = wasm_v128_bitselect(px, out, wasm_i32x4_eq(a, wasm_i32x4_splat(0)));
+			}
+
+			wasm_v128_store(pixels + i, out);
+		}
+
+		ToneRowScalarImpl<Saturation, Color, CheckAlpha>(pixels + i, count - i, p);
+	}
+};
+#endif
+
+using ToneRowFn = void (*)(uint32_t*, int, const BitmapSimd::ToneParams&);
+
+struct ToneRowKernel {
+	ToneRowFn fn;
+	const char* name;
+};
+
+ToneRowKernel SelectToneRow() {
+#ifdef EP_CPU_COMPILE_AVX2
+	if (CpuFeatures::HasAVX2()) {
+		return { DispatchToneRow<ToneAVX2>, "AVX2" };
+	}
+#endif
+#ifdef EP_CPU_COMPILE_SSE2
+	if (CpuFeatures::HasSSE2()) {
+		return { DispatchToneRow<ToneSSE2>, "SSE2" };
+	}
+#endif
+#ifdef EP_CPU_COMPILE_NEON
+	if (CpuFeatures::HasNEON()) {
+		return { DispatchToneRow<ToneNEON>, "NEON" };
+	}
+#endif
+#ifdef EP_CPU_COMPILE_WASM_SIMD
+	if (CpuFeatures::HasWasmSimd()) {
+		return { DispatchToneRow<ToneWasmSimd>, "WASM SIMD" };
+	}
+#endif
+	return { DispatchToneRow<ToneScalar>, "Scalar" };
+}
+
+const ToneRowKernel& GetToneRowKernel() {
+	static const ToneRowKernel kernel = SelectToneRow();
+	return kernel;
+}
+
+// Exact rounded (x * (255 - opacity) + y * opacity) / 255 of one channel
+inline uint32_t blend_channel(uint32_t x, uint32_t y, int inv_opacity, int opacity) {
+	return (x * inv_opacity + y * opacity + 127) / 255;
+}
+
+void BlendRowScalarImpl(uint32_t* dst, const uint32_t* src1, const uint32_t* src2, int count, int opacity) {
+	const int inv_opacity = 255 - opacity;
+
+	for (int i = 0; i < count; ++i) {
+		const uint32_t a = src1[i];
+		const uint32_t b = src2[i];
+		dst[i] = blend_channel(a & 0xFF, b & 0xFF, inv_opacity, opacity)
+			| (blend_channel((a >> 8) & 0xFF, (b >> 8) & 0xFF, inv_opacity, opacity) << 8)
+			| (blend_channel((a >> 16) & 0xFF, (b >> 16) & 0xFF, inv_opacity, opacity) << 16)
+			| (blend_channel(a >> 24, b >> 24, inv_opacity, opacity) << 24);
+	}
+}
+
+void SelectRowScalarImpl(uint32_t* dst, const uint32_t* src1, const uint32_t* src2, const uint8_t* mask, int threshold, int count) {
+	for (int i = 0; i < count; ++i) {
+		dst[i] = mask[i] <= threshold ? src2[i] : src1[i];
+	}
+}
+
+void AlphaRowScalarImpl(const uint32_t* pixels, int tiles, int tile_width, uint32_t alpha_mask, uint32_t* and_alpha, uint32_t* or_alpha) {
+	for (int t = 0; t < tiles; ++t) {
+		uint32_t all = alpha_mask;
+		uint32_t any = 0;
+		for (int i = 0; i < tile_width; ++i) {
+			const uint32_t a = pixels[i] & alpha_mask;
+			all &= a;
+			any |= a;
+		}
+		and_alpha[t] &= all;
+		or_alpha[t] |= any;
+		pixels += tile_width;
+	}
+}
+
+void ScaleRowScalarImpl(uint32_t* dst, const uint32_t* src, int count, int zoom) {
+	for (int i = 0; i < count; ++i) {
+		for (int z = 0; z < zoom; ++z) {
+			*dst++ = src[i];
+		}
+	}
+}
+
+#ifdef EP_CPU_COMPILE_SSE2
+// The weighted sum of two channels is at most 255 * 255, the rounding and the
+// division by 255 stay within 16 bit.
+inline __m128i blend_u16_sse2(__m128i x, __m128i y, __m128i inv_opacity, __m128i opacity) {
+	__m128i v = _mm_add_epi16(_mm_mullo_epi16(x, inv_opacity), _mm_mullo_epi16(y, opacity));
+	v = _mm_add_epi16(v, _mm_set1_epi16(127));
+	return _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(v, _mm_set1_epi16(1)), _mm_srli_epi16(v, 8)), 8);
+}
+
+void BlendRowSSE2(uint32_t* dst, const uint32_t* src1, const uint32_t* src2, int count, int opacity) {
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i inv_op = _mm_set1_epi16(255 - opacity);
+	const __m128i op = _mm_set1_epi16(opacity);
+
+	int i = 0;
+	for (; i + 4 <= count; i += 4) {
+		const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src1 + i));
+		const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src2 + i));
+		const __m128i lo = blend_u16_sse2(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero), inv_op, op);
+		const __m128i hi = blend_u16_sse2(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero), inv_op, op);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(lo, hi));
+	}
+
+	BlendRowScalarImpl(dst + i, src1 + i, src2 + i, count - i, opacity);
+}
+
+void SelectRowSSE2(uint32_t* dst, const uint32_t* src1, const uint32_t* src2, const uint8_t* mask, int threshold, int count) {
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i thr = _mm_set1_epi32(threshold);
+
+	int i = 0;
+	for (; i + 4 <= count; i += 4) {
+		int32_t m4;
+		std::memcpy(&m4, mask + i, sizeof(m4));
+		__m128i m = _mm_unpacklo_epi8(_mm_cvtsi32_si128(m4), zero);
+		m = _mm_unpacklo_epi16(m, zero);
+		const __m128i use_src1 = _mm_cmpgt_epi32(m, thr);
+
+		const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src1 + i));
+		const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src2 + i));
+		const __m128i out = _mm_or_si128(_mm_and_si128(use_src1, a), _mm_andnot_si128(use_src1, b));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), out);
+	}
+
+	SelectRowScalarImpl(dst + i, src1 + i, src2 + i, mask + i, threshold, count - i);
+}
+void AlphaRowSSE2(const uint32_t* pixels, int tiles, int tile_width, uint32_t alpha_mask, uint32_t* and_alpha, uint32_t* or_alpha) {
+	const __m128i mask = _mm_set1_epi32(static_cast<int>(alpha_mask));
+
+	for (int t = 0; t < tiles; ++t) {
+		__m128i all = mask;
+		__m128i any = _mm_setzero_si128();
+
+		int i = 0;
+		for (; i + 4 <= tile_width; i += 4) {
+			const __m128i a = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels + i)), mask);
+			all = _mm_and_si128(all, a);
+			any = _mm_or_si128(any, a);
+		}
+
+		all = _mm_and_si128(all, _mm_shuffle_epi32(all, _MM_SHUFFLE(1, 0, 3, 2)));
+		all = _mm_and_si128(all, _mm_shuffle_epi32(all, _MM_SHUFFLE(2, 3, 0, 1)));
+		any = _mm_or_si128(any, _mm_shuffle_epi32(any, _MM_SHUFFLE(1, 0, 3, 2)));
+		any = _mm_or_si128(any, _mm_shuffle_epi32(any, _MM_SHUFFLE(2, 3, 0, 1)));
+		and_alpha[t] &= static_cast<uint32_t>(_mm_cvtsi128_si32(all));
+		or_alpha[t] |= static_cast<uint32_t>(_mm_cvtsi128_si32(any));
+
+		AlphaRowScalarImpl(pixels + i, 1, tile_width - i, alpha_mask, and_alpha + t, or_alpha + t);
+		pixels += tile_width;
+	}
+}
+
+void ScaleRowSSE2(uint32_t* dst, const uint32_t* src, int count, int zoom) {
+	int i = 0;
+	if (zoom == 2) {
+		for (; i + 4 <= count; i += 4) {
+			const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 2), _mm_unpacklo_epi32(v, v));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 2 + 4), _mm_unpackhi_epi32(v, v));
+		}
+	} else if (zoom >= 4) {
+		// Whole vectors of one pixel, the remainder of the factor is written scalar
+		for (; i < count; ++i) {
+			const __m128i v = _mm_set1_epi32(static_cast<int>(src[i]));
+			uint32_t* out = dst + i * zoom;
+			int z = 0;
+			for (; z + 4 <= zoom; z += 4) {
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out + z), v);
+			}
+			for (; z < zoom; ++z) {
+				out[z] = src[i];
+			}
+		}
+	}
+
+	ScaleRowScalarImpl(dst + i * zoom, src + i, count - i, zoom);
+}
+#endif
+
+#ifdef EP_CPU_COMPILE_AVX2
+EP_TARGET_AVX2 inline __m256i blend_u16_avx2(__m256i x, __m256i y, __m256i inv_opacity, __m256i opacity) {
+	__m256i v = _mm256_add_epi16(_mm256_mullo_epi16(x, inv_opacity), _mm256_mullo_epi16(y, opacity));
+	v = _mm256_add_epi16(v, _mm256_set1_epi16(127));
+	return _mm256_srli_epi16(_mm256_add_epi16(_mm256_add_epi16(v, _mm256_set1_epi16(1)), _mm256_srli_epi16(v, 8)), 8);
+}
+
+EP_TARGET_AVX2 void BlendRowAVX2(uint32_t* dst, const uint32_t* src1, const uint32_t* src2, int count, int opacity) {
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i inv_op = _mm256_set1_epi16(255 - opacity);
+	const __m256i op = _mm256_set1_epi16(opacity);
+
+	int i = 0;
+	for (; i + 8 <= count; i += 8) {
+		const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src1 + i));
+		const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src2 + i));
+		// unpack and pack work per 128 bit lane, the pixel order is kept
+		const __m256i lo = blend_u16_avx2(_mm256_unpacklo_epi8(a, zero), _mm256_unpacklo_epi8(b, zero), inv_op, op);
+		const __m256i hi = blend_u16_avx2(_mm256_unpackhi_epi8(a, zero), _mm256_unpackhi_epi8(b, zero), inv_op, op);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_packus_epi16(lo, hi));
+	}
+
+	BlendRowScalarImpl(dst + i, src1 + i, src2 + i, count - i, opacity);
+}
+
+EP_TARGET_AVX2 void SelectRowAVX2(uint32_t* dst, const uint32_t* src1, const uint32_t* src2, const uint8_t* mask, int threshold, int count) {
+	const __m256i thr = _mm256_set1_epi32(threshold);
+
+	int i = 0;
+	for (; i + 8 <= count; i += 8) {
+		const __m256i m = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(mask + i)));
+		const __m256i use_src1 = _mm256_cmpgt_epi32(m, thr);
+
+		const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src1 + i));
+		const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src2 + i));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_blendv_epi8(b, a, use_src1));
+	}
+
+	SelectRowScalarImpl(dst + i, src1 + i, src2 + i, mask + i, threshold, count - i);
+}
+EP_TARGET_AVX2 void AlphaRowAVX2(const uint32_t* pixels, int tiles, int tile_width, uint32_t alpha_mask, uint32_t* and_alpha, uint32_t* or_alpha) {
+	const __m256i mask = _mm256_set1_epi32(static_cast<int>(alpha_mask));
+
+	for (int t = 0; t < tiles; ++t) {
+		__m256i all = mask;
+		__m256i any = _mm256_setzero_si256();
+
+		int i = 0;
+		for (; i + 8 <= tile_width; i += 8) {
+			const __m256i a = _mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(pixels + i)), mask);
+			all = _mm256_and_si256(all, a);
+			any = _mm256_or_si256(any, a);
+		}
+
+		__m128i all4 = _mm_and_si128(_mm256_castsi256_si128(all), _mm256_extracti128_si256(all, 1));
+		__m128i any4 = _mm_or_si128(_mm256_castsi256_si128(any), _mm256_extracti128_si256(any, 1));
+		all4 = _mm_and_si128(all4, _mm_shuffle_epi32(all4, _MM_SHUFFLE(1, 0, 3, 2)));
+		all4 = _mm_and_si128(all4, _mm_shuffle_epi32(all4, _MM_SHUFFLE(2, 3, 0, 1)));
+		any4 = _mm_or_si128(any4, _mm_shuffle_epi32(any4, _MM_SHUFFLE(1, 0, 3, 2)));
+		any4 = _mm_or_si128(any4, _mm_shuffle_epi32(any4, _MM_SHUFFLE(2, 3, 0, 1)));
+		and_alpha[t] &= static_cast<uint32_t>(_mm_cvtsi128_si32(all4));
+		or_alpha[t] |= static_cast<uint32_t>(_mm_cvtsi128_si32(any4));
+
+		AlphaRowScalarImpl(pixels + i, 1, tile_width - i, alpha_mask, and_alpha + t, or_alpha + t);
+		pixels += tile_width;
+	}
+}
+
+EP_TARGET_AVX2 void ScaleRowAVX2(uint32_t* dst, const uint32_t* src, int count, int zoom) {
+	int i = 0;
+	if (zoom == 2) {
+		const __m256i lo = _mm256_setr_epi32(0, 0, 1, 1, 2, 2, 3, 3);
+		const __m256i hi = _mm256_setr_epi32(4, 4, 5, 5, 6, 6, 7, 7);
+		for (; i + 8 <= count; i += 8) {
+			const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * 2), _mm256_permutevar8x32_epi32(v, lo));
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * 2 + 8), _mm256_permutevar8x32_epi32(v, hi));
+		}
+	} else if (zoom >= 8) {
+		for (; i < count; ++i) {
+			const __m256i v = _mm256_set1_epi32(static_cast<int>(src[i]));
+			uint32_t* out = dst + i * zoom;
+			int z = 0;
+			for (; z + 8 <= zoom; z += 8) {
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + z), v);
+			}
+			for (; z < zoom; ++z) {
+				out[z] = src[i];
+			}
+		}
+	}
+
+	ScaleRowScalarImpl(dst + i * zoom, src + i, count - i, zoom);
+}
+#endif
+
+#ifdef EP_CPU_COMPILE_NEON
+inline uint8x8_t blend_u8_neon(uint8x8_t x, uint8x8_t y, uint8x8_t inv_opacity, uint8x8_t opacity) {
+	uint16x8_t v = vmlal_u8(vmull_u8(x, inv_opacity), y, opacity);
+	v = vaddq_u16(v, vdupq_n_u16(127));
+	return vshrn_n_u16(vaddq_u16(vaddq_u16(v, vdupq_n_u16(1)), vshrq_n_u16(v, 8)), 8);
+}
+
+void BlendRowNEON(uint32_t* dst, const uint32_t* src1, const uint32_t* src2, int count, int opacity) {
+	const uint8x8_t inv_op = vdup_n_u8(255 - opacity);
+	const uint8x8_t op = vdup_n_u8(opacity);
+
+	int i = 0;
+	for (; i + 4 <= count; i += 4) {
+		const uint8x16_t a = vld1q_u8(reinterpret_cast<const uint8_t*>(src1 + i));
+		const uint8x16_t b = vld1q_u8(reinterpret_cast<const uint8_t*>(src2 + i));
+		const uint8x8_t lo = blend_u8_neon(vget_low_u8(a), vget_low_u8(b), inv_op, op);
+		const uint8x8_t hi = blend_u8_neon(vget_high_u8(a), vget_high_u8(b), inv_op, op);
+		vst1q_u8(reinterpret_cast<uint8_t*>(dst + i), vcombine_u8(lo, hi));
+	}
+
+	BlendRowScalarImpl(dst + i, src1 + i, src2 + i, count - i, opacity);
+}
+
+void SelectRowNEON(uint32_t* dst, const uint32_t* src1, const uint32_t* src2, const uint8_t* mask, int threshold, int count) {
+	const int32x4_t thr = vdupq_n_s32(threshold);
+
+	int i = 0;
+	for (; i + 8 <= count; i += 8) {
+		const uint16x8_t m = vmovl_u8(vld1_u8(mask + i));
+		const int32x4_t m_lo = vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(m)));
+		const int32x4_t m_hi = vreinterpretq_s32_u32(vmovl_u16(vget_high_u16(m)));
+
+		vst1q_u32(dst + i, vbslq_u32(vcgtq_s32(m_lo, thr), vld1q_u32(src1 + i), vld1q_u32(src2 + i)));
+		vst1q_u32(dst + i + 4, vbslq_u32(vcgtq_s32(m_hi, thr), vld1q_u32(src1 + i + 4), vld1q_u32(src2 + i + 4)));
+	}
+
+	SelectRowScalarImpl(dst + i, src1 + i, src2 + i, mask + i, threshold, count - i);
+}
+void AlphaRowNEON(const uint32_t* pixels, int tiles, int tile_width, uint32_t alpha_mask, uint32_t* and_alpha, uint32_t* or_alpha) {
+	const uint32x4_t mask = vdupq_n_u32(alpha_mask);
+
+	for (int t = 0; t < tiles; ++t) {
+		uint32x4_t all = mask;
+		uint32x4_t any = vdupq_n_u32(0);
+
+		int i = 0;
+		for (; i + 4 <= tile_width; i += 4) {
+			const uint32x4_t a = vandq_u32(vld1q_u32(pixels + i), mask);
+			all = vandq_u32(all, a);
+			any = vorrq_u32(any, a);
+		}
+
+		const uint32x2_t all2 = vand_u32(vget_low_u32(all), vget_high_u32(all));
+		const uint32x2_t any2 = vorr_u32(vget_low_u32(any), vget_high_u32(any));
+		and_alpha[t] &= vget_lane_u32(all2, 0) & vget_lane_u32(all2, 1);
+		or_alpha[t] |= vget_lane_u32(any2, 0) | vget_lane_u32(any2, 1);
+
+		AlphaRowScalarImpl(pixels + i, 1, tile_width - i, alpha_mask, and_alpha + t, or_alpha + t);
+		pixels += tile_width;
+	}
+}
+
+void ScaleRowNEON(uint32_t* dst, const uint32_t* src, int count, int zoom) {
+	int i = 0;
+	if (zoom == 2) {
+		for (; i + 4 <= count; i += 4) {
+			const uint32x4_t v = vld1q_u32(src + i);
+			vst2q_u32(dst + i * 2, uint32x4x2_t{{ v, v }});
+		}
+	} else if (zoom >= 4) {
+		for (; i < count; ++i) {
+			const uint32x4_t v = vdupq_n_u32(src[i]);
+			uint32_t* out = dst + i * zoom;
+			int z = 0;
+			for (; z + 4 <= zoom; z += 4) {
+				vst1q_u32(out + z, v);
+			}
+			for (; z < zoom; ++z) {
+				out[z] = src[i];
+			}
+		}
+	}
+
+	ScaleRowScalarImpl(dst + i * zoom, src + i, count - i, zoom);
+}
+#endif
+
+#ifdef EP_CPU_COMPILE_WASM_SIMD
+inline v128_t blend_u16_wasm(v128_t x, v128_t y, v128_t inv_opacity, v128_t opacity) {
+	v128_t v = wasm_i16x8_add(wasm_i16x8_mul(x, inv_opacity), wasm_i16x8_mul(y, opacity));
+	v = wasm_i16x8_add(v, wasm_i16x8_splat(127));
+	return wasm_u16x8_shr(wasm_i16x8_add(wasm_i16x8_add(v, wasm_i16x8_splat(1)), wasm_u16x8_shr(v, 8)), 8);
+}
+
+void BlendRowWasmSimd(uint32_t* dst, const uint32_t* src1, const uint32_t* src2, int count, int opacity) {
+	const v128_t inv_op = wasm_i16x8_splat(255 - opacity);
+	const v128_t op = wasm_i16x8_splat(opacity);
+
+	int i = 0;
+	for (; i + 4 <= count; i += 4) {
+		const v128_t a = wasm_v128_load(src1 + i);
+		const v128_t b = wasm_v128_load(src2 + i);
+		const v128_t lo = blend_u16_wasm(wasm_u16x8_extend_low_u8x16(a), wasm_u16x8_extend_low_u8x16(b), inv_op, op);
+		const v128_t hi = blend_u16_wasm(wasm_u16x8_extend_high_u8x16(a), wasm_u16x8_extend_high_u8x16(b), inv_op, op);
+		wasm_v128_store(dst + i, wasm_u8x16_narrow_i16x8(lo, hi));
+	}
+
+	BlendRowScalarImpl(dst + i, src1 + i, src2 + i, count - i, opacity);
+}
+
+void SelectRowWasmSimd(uint32_t* dst, const uint32_t* src1, const uint32_t* src2, const uint8_t* mask, int threshold, int count) {
+	const v128_t thr = wasm_i32x4_splat(threshold);
+
+	int i = 0;
+	for (; i + 4 <= count; i += 4) {
+		const v128_t m = wasm_u32x4_extend_low_u16x8(wasm_u16x8_extend_low_u8x16(wasm_v128_load32_zero(mask + i)));
+		const v128_t use_src1 = wasm_i32x4_gt(m, thr);
+		wasm_v128_store(dst + i, wasm_v128_bitselect(wasm_v128_load(src1 + i), wasm_v128_load(src2 + i), use_src1));
+	}
+
+	SelectRowScalarImpl(dst + i, src1 + i, src2 + i, mask + i, threshold, count - i);
+}
+
+void AlphaRowWasmSimd(const uint32_t* pixels, int tiles, int tile_width, uint32_t alpha_mask, uint32_t* and_alpha, uint32_t* or_alpha) {
+	const v128_t mask = wasm_i32x4_splat(static_cast<int32_t>(alpha_mask));
+
+	for (int t = 0; t < tiles; ++t) {
+		v128_t all = mask;
+		v128_t any = wasm_i32x4_splat(0);
+
+		int i = 0;
+		for (; i + 4 <= tile_width; i += 4) {
+			const v128_t a = wasm_v128_and(wasm_v128_load(pixels + i), mask);
+			all = wasm_v128_and(all, a);
+			any = wasm_v128_or(any, a);
+		}
+
+		and_alpha[t] &= static_cast<uint32_t>(wasm_i32x4_extract_lane(all, 0) & wasm_i32x4_extract_lane(all, 1)
+			& wasm_i32x4_extract_lane(all, 2) & wasm_i32x4_extract_lane(all, 3));
+		or_alpha[t] |= static_cast<uint32_t>(wasm_i32x4_extract_lane(any, 0) | wasm_i32x4_extract_lane(any, 1)
+			| wasm_i32x4_extract_lane(any, 2) | wasm_i32x4_extract_lane(any, 3));
+
+		AlphaRowScalarImpl(pixels + i, 1, tile_width - i, alpha_mask, and_alpha + t, or_alpha + t);
+		pixels += tile_width;
+	}
+}
+
+void ScaleRowWasmSimd(uint32_t* dst, const uint32_t* src, int count, int zoom) {
+	int i = 0;
+	if (zoom == 2) {
+		for (; i + 4 <= count; i += 4) {
+			const v128_t v = wasm_v128_load(src + i);
+			wasm_v128_store(dst + i * 2, wasm_i32x4_shuffle(v, v, 0, 0, 1, 1));
+			wasm_v128_store(dst + i * 2 + 4, wasm_i32x4_shuffle(v, v, 2, 2, 3, 3));
+		}
+	} else if (zoom >= 4) {
+		for (; i < count; ++i) {
+			const v128_t v = wasm_i32x4_splat(static_cast<int32_t>(src[i]));
+			uint32_t* out = dst + i * zoom;
+			int z = 0;
+			for (; z + 4 <= zoom; z += 4) {
+				wasm_v128_store(out + z, v);
+			}
+			for (; z < zoom; ++z) {
+				out[z] = src[i];
+			}
+		}
+	}
+
+	ScaleRowScalarImpl(dst + i * zoom, src + i, count - i, zoom);
+}
+#endif
+
+using BlendRowFn = void (*)(uint32_t*, const uint32_t*, const uint32_t*, int, int);
+using SelectRowFn = void (*)(uint32_t*, const uint32_t*, const uint32_t*, const uint8_t*, int, int);
+using AlphaRowFn = void (*)(const uint32_t*, int, int, uint32_t, uint32_t*, uint32_t*);
+using ScaleRowFn = void (*)(uint32_t*, const uint32_t*, int, int);
+
+struct RowKernels {
+	BlendRowFn blend;
+	SelectRowFn select;
+	AlphaRowFn alpha;
+	ScaleRowFn scale;
+};
+
+RowKernels SelectRowKernels() {
+#ifdef EP_CPU_COMPILE_AVX2
+	if (CpuFeatures::HasAVX2()) {
+		return { BlendRowAVX2, SelectRowAVX2, AlphaRowAVX2, ScaleRowAVX2 };
+	}
+#endif
+#ifdef EP_CPU_COMPILE_SSE2
+	if (CpuFeatures::HasSSE2()) {
+		return { BlendRowSSE2, SelectRowSSE2, AlphaRowSSE2, ScaleRowSSE2 };
+	}
+#endif
+#ifdef EP_CPU_COMPILE_NEON
+	if (CpuFeatures::HasNEON()) {
+		return { BlendRowNEON, SelectRowNEON, AlphaRowNEON, ScaleRowNEON };
+	}
+#endif
+#ifdef EP_CPU_COMPILE_WASM_SIMD
+	if (CpuFeatures::HasWasmSimd()) {
+		return { BlendRowWasmSimd, SelectRowWasmSimd, AlphaRowWasmSimd, ScaleRowWasmSimd };
+	}
+#endif
+	return { BlendRowScalarImpl, SelectRowScalarImpl, AlphaRowScalarImpl, ScaleRowScalarImpl };
+}
+
+const RowKernels& GetRowKernels() {
+	static const RowKernels kernels = SelectRowKernels();
+	return kernels;
+}
+
+} // namespace
+
+void BitmapSimd::ToneRow(uint32_t* pixels, int count, const ToneParams& params) {
+	GetToneRowKernel().fn(pixels, count, params);
+}
+
+void BitmapSimd::ToneRowScalar(uint32_t* pixels, int count, const ToneParams& params) {
+	DispatchToneRow<ToneScalar>(pixels, count, params);
+}
+
+const char* BitmapSimd::GetToneRowVariant() {
+	return GetToneRowKernel().name;
+}
+
+void BitmapSimd::BlendRow(uint32_t* dst, const uint32_t* src1, const uint32_t* src2, int count, int opacity) {
+	GetRowKernels().blend(dst, src1, src2, count, opacity);
+}
+
+void BitmapSimd::BlendRowScalar(uint32_t* dst, const uint32_t* src1, const uint32_t* src2, int count, int opacity) {
+	BlendRowScalarImpl(dst, src1, src2, count, opacity);
+}
+
+void BitmapSimd::SelectRow(uint32_t* dst, const uint32_t* src1, const uint32_t* src2, const uint8_t* mask, int threshold, int count) {
+	GetRowKernels().select(dst, src1, src2, mask, threshold, count);
+}
+
+void BitmapSimd::SelectRowScalar(uint32_t* dst, const uint32_t* src1, const uint32_t* src2, const uint8_t* mask, int threshold, int count) {
+	SelectRowScalarImpl(dst, src1, src2, mask, threshold, count);
+}
+
+void BitmapSimd::AlphaRow(const uint32_t* pixels, int tiles, int tile_width, uint32_t alpha_mask, uint32_t* and_alpha, uint32_t* or_alpha) {
+	GetRowKernels().alpha(pixels, tiles, tile_width, alpha_mask, and_alpha, or_alpha);
+}
+
+void BitmapSimd::AlphaRowScalar(const uint32_t* pixels, int tiles, int tile_width, uint32_t alpha_mask, uint32_t* and_alpha, uint32_t* or_alpha) {
+	AlphaRowScalarImpl(pixels, tiles, tile_width, alpha_mask, and_alpha, or_alpha);
+}
+
+void BitmapSimd::ScaleRow(uint32_t* dst, const uint32_t* src, int count, int zoom) {
+	GetRowKernels().scale(dst, src, count, zoom);
+}
+
+void BitmapSimd::ScaleRowScalar(uint32_t* dst, const uint32_t* src, int count, int zoom) {
+	ScaleRowScalarImpl(dst, src, count, zoom);
+}
@@ -0,0 +1,162 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_BITMAP_SIMD_H
+#define EP_BITMAP_SIMD_H
+
+// Headers
+#include <cstdint>
+#include "tone.h"
+
+/**
+ * Per-row pixel kernels used by Bitmap and Transition.
+ * Every kernel has a scalar reference implementation and vectorized
+ * variants which produce identical results. The fastest variant supported
+ * by the CPU is picked on first use.
+ */
+namespace BitmapSimd {
+
+/** Parameters of a tone operation on 32 bit pixels */
+struct ToneParams {
+	/** Shift of the red, green, blue and alpha component */
+	int rs = 0;
+	int gs = 0;
+	int bs = 0;
+	int as = 0;
+	/** Apply the tone gray component */
+	bool saturation = false;
+	/** Apply the tone red, green and blue component */
+	bool color = false;
+	/** Do not touch pixels with an alpha of 0 */
+	bool check_alpha = false;
+	/** The tone to apply */
+	Tone tone;
+
+	/**
+	 * @return saturation factor in 1/1024 steps derived from tone.gray
+	 */
+	int GetSaturationFactor() const;
+};
+
+/**
+ * Applies a tone to a row of pixels in place.
+ *
+ * @param pixels start of the row
+ * @param count number of pixels in the row
+ * @param params tone parameters
+ */
+void ToneRow(uint32_t* pixels, int count, const ToneParams& params);
+
+/**
+ * Scalar reference implementation of ToneRow.
+ *
+ * @see ToneRow
+ */
+void ToneRowScalar(uint32_t* pixels, int count, const ToneParams& params);
+
+/**
+ * @return Name of the kernel variant used by ToneRow
+ */
+const char* GetToneRowVariant();
+
+/**
+ * Crossfades two rows of pixels. All four channels are interpolated,
+ * dst may be the same row as src1 or src2.
+ *
+ * @param dst destination row
+ * @param src1 row shown at opacity 0
+ * @param src2 row shown at opacity 255
+ * @param count number of pixels in the row
+ * @param opacity weight of src2 (0-255)
+ */
+void BlendRow(uint32_t* dst, const uint32_t* src1, const uint32_t* src2, int count, int opacity);
+
+/**
+ * Scalar reference implementation of BlendRow.
+ *
+ * @see BlendRow
+ */
+void BlendRowScalar(uint32_t* dst, const uint32_t* src1, const uint32_t* src2, int count, int opacity);
+
+/**
+ * Picks every pixel from one of two rows depending on a mask:
+ * src2 when the mask value is <= threshold, otherwise src1.
+ * dst may be the same row as src1 or src2.
+ *
+ * @param dst destination row
+ * @param src1 row used above the threshold
+ * @param src2 row used up to the threshold
+ * @param mask one value per pixel
+ * @param threshold highest mask value taken from src2
+ * @param count number of pixels in the row
+ */
+void SelectRow(uint32_t* dst, const uint32_t* src1, const uint32_t* src2, const uint8_t* mask, int threshold, int count);
+
+/**
+ * Scalar reference implementation of SelectRow.
+ *
+ * @see SelectRow
+ */
+void SelectRowScalar(uint32_t* dst, const uint32_t* src1, const uint32_t* src2, const uint8_t* mask, int threshold, int count);
+
+/**
+ * Collects the alpha of consecutive tiles in a row of pixels.
+ * For every tile and_alpha is and-combined and or_alpha is or-combined
+ * with the masked pixels of the tile. A tile is opaque when its and_alpha
+ * equals alpha_mask and transparent when its or_alpha is 0.
+ *
+ * @param pixels start of the row
+ * @param tiles number of tiles in the row
+ * @param tile_width pixels per tile
+ * @param alpha_mask mask of the alpha channel
+ * @param and_alpha and-combined alpha, one value per tile
+ * @param or_alpha or-combined alpha, one value per tile
+ */
+void AlphaRow(const uint32_t* pixels, int tiles, int tile_width, uint32_t alpha_mask, uint32_t* and_alpha, uint32_t* or_alpha);
+
+/**
+ * Scalar reference implementation of AlphaRow.
+ *
+ * @see AlphaRow
+ */
+void AlphaRowScalar(const uint32_t* pixels, int tiles, int tile_width, uint32_t alpha_mask, uint32_t* and_alpha, uint32_t* or_alpha);
+
+/**
+ * Repeats every pixel of a row zoom times, nearest neighbour scaling
+ * by an integer factor.
+ *
+ * @param dst destination row of count * zoom pixels
+ * @param src source row
+ * @param count number of source pixels
+ * @param zoom scale factor, at least 1
+ */
+void ScaleRow(uint32_t* dst, const uint32_t* src, int count, int zoom);
+
+/**
+ * Scalar reference implementation of ScaleRow.
+ *
+ * @see ScaleRow
+ */
+void ScaleRowScalar(uint32_t* dst, const uint32_t* src, int count, int zoom);
+
+} // namespace BitmapSimd
+
+inline int BitmapSimd::ToneParams::GetSaturationFactor() const {
+	return tone.gray > 128 ? 1024 + (tone.gray - 128) * 16 : tone.gray * 8;
+}
+
+#endif
@@ -0,0 +1,79 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include <algorithm>
+#include "bitmap_wrap.h"
+#include "bitmap.h"
+
+void BitmapWrap::TiledBlit(Bitmap& dst, int ox, int oy, const BitmapRef& src_ref, const Rect& dst_rect, const Opacity& opacity) {
+	const Bitmap& src = *src_ref;
+	const int sw = src.GetWidth();
+	const int sh = src.GetHeight();
+	if (sw <= 0 || sh <= 0 || dst_rect.width <= 0 || dst_rect.height <= 0) {
+		return;
+	}
+
+	ox %= sw;
+	oy %= sh;
+	if (ox < 0) ox += sw;
+	if (oy < 0) oy += sh;
+
+	if (ox + dst_rect.width <= sw && oy + dst_rect.height <= sh) {
+		// The window does not wrap
+		dst.Blit(dst_rect.x, dst_rect.y, src, Rect(ox, oy, dst_rect.width, dst_rect.height), opacity);
+		return;
+	}
+
+	// Every window starting inside the first tile fits
+	int ww = sw - 1 + dst_rect.width;
+	int wh = sh - 1 + dst_rect.height;
+
+	const bool same_source = wrapped && source.lock() == src_ref;
+	if (same_source) {
+		// Keep the larger copy, the window size changes while clipped maps scroll
+		ww = std::max(ww, wrapped->GetWidth());
+		wh = std::max(wh, wrapped->GetHeight());
+	}
+
+	if (!same_source || source_revision != src.GetRevision() ||
+			wrapped->GetWidth() != ww || wrapped->GetHeight() != wh) {
+		const int64_t bytes = static_cast<int64_t>(ww) * wh * 4;
+		if (bytes > max_bytes) {
+			Clear();
+			dst.TiledBlit(ox, oy, src.GetRect(), src, dst_rect, opacity);
+			return;
+		}
+
+		if (!wrapped || wrapped->GetWidth() != ww || wrapped->GetHeight() != wh ||
+				wrapped->GetTransparent() != src.GetTransparent()) {
+			wrapped = Bitmap::Create(ww, wh, src.GetTransparent());
+		} else {
+			wrapped->Clear();
+		}
+		wrapped->TiledBlit(src.GetRect(), src, wrapped->GetRect(), Opacity::Opaque());
+		source = src_ref;
+		source_revision = src.GetRevision();
+	}
+
+	dst.Blit(dst_rect.x, dst_rect.y, *wrapped, Rect(ox, oy, dst_rect.width, dst_rect.height), opacity);
+}
+
+void BitmapWrap::Clear() {
+	wrapped.reset();
+	source.reset();
+}
@@ -0,0 +1,60 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_BITMAP_WRAP_H
+#define EP_BITMAP_WRAP_H
+
+// Headers
+#include <cstdint>
+#include <memory>
+#include "system.h"
+#include "rect.h"
+#include "opacity.h"
+
+/**
+ * Wrap padded copy of a tiled bitmap.
+ * The copy repeats the source image until every screen sized window
+ * starting inside the first tile fits into it without wrapping. Tiling then becomes a single blit of that window.
+ * The copy is rebuilt when the source or its contents change.
+ */
+class BitmapWrap {
+public:
+	/**
+	 * Tiles src into dst, like Bitmap::TiledBlit with the whole source.
+	 *
+	 * @param dst bitmap to draw on
+	 * @param ox horizontal offset of the tiling in the source
+	 * @param oy vertical offset of the tiling in the source
+	 * @param src bitmap to tile
+	 * @param dst_rect area of dst covered by the tiles
+	 * @param opacity opacity of the tiles
+	 */
+	void TiledBlit(Bitmap& dst, int ox, int oy, const BitmapRef& src, const Rect& dst_rect, const Opacity& opacity);
+
+	/** Releases the padded copy */
+	void Clear();
+
+	/** Largest padded copy in bytes, larger ones tile the source directly */
+	static constexpr int max_bytes = 8 * 1024 * 1024;
+
+private:
+	BitmapRef wrapped;
+	std::weak_ptr<Bitmap> source;
+	uint32_t source_revision = 0;
+};
+
+#endif
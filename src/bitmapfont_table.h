@@ -0,0 +1,89 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_BITMAPFONT_TABLE_H
+#define EP_BITMAPFONT_TABLE_H
+
+// Headers
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "bitmapfont_glyph.h"
+
+/**
+ * Two-level lookup table of a sorted glyph array.
+ * The high byte of the code selects a page, the low byte the entry in the
+ * page holding the glyph index. Codes without glyphs share an empty page,
+ * a lookup costs two array reads.
+ */
+class BitmapFontTable {
+public:
+	/**
+	 * Builds the table.
+	 *
+	 * @param glyphs glyph array sorted by code, must outlive the table
+	 */
+	template <size_t N>
+	explicit BitmapFontTable(const std::array<BitmapFontGlyph, N>& glyphs);
+
+	/**
+	 * @param code utf32 glyph
+	 * @return glyph or nullptr when the array has no glyph for code
+	 */
+	const BitmapFontGlyph* Find(char32_t code) const;
+
+private:
+	static constexpr int page_size = 256;
+	/** Entries store the index + 1 in 16 bit */
+	static constexpr size_t max_glyphs = 0xFFFF;
+
+	const BitmapFontGlyph* glyphs;
+	/** Offset of the page of every high byte into entries, 0 is the empty page */
+	std::array<uint32_t, page_size> pages = {};
+	/** Glyph index + 1, 0 when there is no glyph */
+	std::vector<uint16_t> entries;
+};
+
+template <size_t N>
+inline BitmapFontTable::BitmapFontTable(const std::array<BitmapFontGlyph, N>& glyphs) :
+	glyphs(glyphs.data()), entries(page_size, 0) {
+	static_assert(N < max_glyphs, "Glyph index does not fit into the table");
+
+	for (size_t i = 0; i < N; ++i) {
+		const uint16_t code = glyphs[i].code;
+		auto& page = pages[code / page_size];
+		if (page == 0) {
+			page = static_cast<uint32_t>(entries.size());
+			entries.resize(entries.size() + page_size, 0);
+		}
+		auto& entry = entries[page + code % page_size];
+		if (entry == 0) {
+			entry = static_cast<uint16_t>(i + 1);
+		}
+	}
+}
+
+inline const BitmapFontGlyph* BitmapFontTable::Find(char32_t code) const {
+	if (code > 0xFFFF) {
+		return nullptr;
+	}
+	const uint16_t index = entries[pages[code / page_size] + code % page_size];
+	return index != 0 ? &glyphs[index - 1] : nullptr;
+}
+
+#endif
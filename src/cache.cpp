@@ -20,12 +20,20 @@
 #  pragma warning(disable: 4003)
 #endif
 
-#include <map>
-#include <tuple>
+#include <algorithm>
+#include <list>
+#include <unordered_map>
 #include <chrono>
 #include <cassert>
+#ifdef HAVE_THREADS
+#  include <deque>
+#  include <functional>
+#  include <mutex>
+#endif
 
+#include "asset_cache.h"
 #include "async_handler.h"
+#include "bitmap_atlas.h"
 #include "cache.h"
 #include "filefinder.h"
 #include "exfont.h"
@@ -35,85 +43,199 @@
 #include "player.h"
 #include <lcf/data.h>
 #include "game_clock.h"
+#include "instrumentation.h"
+#include "job_system.h"
+#include "options.h"
+#include "utils.h"
 
 using namespace std::chrono_literals;
 
 namespace {
-	std::string MakeHashKey(StringView folder_name, StringView filename, bool transparent) {
-		return ToString(folder_name) + ":" + ToString(filename) + ":" + (transparent ? "T" : " ");
-	}
-
-	std::string MakeTileHashKey(StringView chipset_name, int id) {
-		std::string key;
-		key.reserve(chipset_name.size() + sizeof(int) + 2);
-		key.append(reinterpret_cast<char*>(&id), sizeof(id));
-		key.append(1, ':');
-		key.append(chipset_name.begin(), chipset_name.end());
+	// FNV-1a, the keys are hashed from the parts without building a string
+	constexpr uint64_t hash_offset = 14695981039346656037ULL;
+	constexpr uint64_t hash_prime = 1099511628211ULL;
 
-		return key;
+	uint64_t HashBytes(uint64_t hash, const char* data, size_t size) {
+		for (size_t i = 0; i < size; ++i) {
+			hash = (hash ^ static_cast<unsigned char>(data[i])) * hash_prime;
+		}
+		return hash;
 	}
 
-	int IdFromTileHash(StringView key) {
-		int id = 0;
-		if (key.size() > sizeof(id)) {
-			std::memcpy(&id, key.data(), sizeof(id));
-		}
-		return id;
+	uint64_t MakeHashKey(StringView folder_name, StringView filename, bool transparent) {
+		uint64_t hash = HashBytes(hash_offset, folder_name.data(), folder_name.size());
+		hash = HashBytes(hash, ":", 1);
+		hash = HashBytes(hash, filename.data(), filename.size());
+		return HashBytes(hash, transparent ? ":T" : ": ", 2);
 	}
 
-	const char* NameFromTileHash(StringView key) {
-		int offset = sizeof(int) + 1;
-		if (static_cast<int>(key.size()) < offset) {
-			return "";
-		}
-		return key.data() + offset;
+	uint64_t MakeTileHashKey(StringView chipset_name, int id) {
+		uint64_t hash = HashBytes(hash_offset, reinterpret_cast<const char*>(&id), sizeof(id));
+		hash = HashBytes(hash, ":", 1);
+		return HashBytes(hash, chipset_name.data(), chipset_name.size());
 	}
 
+	struct CacheItem;
+
+	using key_type = uint64_t;
+	using cache_entry = std::pair<const key_type, CacheItem>;
+
+	/** Cache entries, least recently used first */
+	std::list<cache_entry*> cache_lru;
+
 	struct CacheItem {
+		/** Compared on lookup, the hash alone can collide */
+		std::string folder_name;
+		std::string filename;
+		bool transparent = false;
 		BitmapRef bitmap;
 		Game_Clock::time_point last_access;
+		/** Position in cache_lru */
+		std::list<cache_entry*>::iterator lru_it;
 	};
 
-	using key_type = std::string;
 	std::unordered_map<key_type, CacheItem> cache;
 
-	using tile_key_type = std::string;
-	std::unordered_map<tile_key_type, std::weak_ptr<Bitmap>> cache_tiles;
+	/** Images being decoded by Cache::DecodeAsync */
+	struct DecodeItem {
+		std::string folder_name;
+		std::string filename;
+		std::string path;
+		bool transparent;
+		Cache::DecodeHandle handle;
+		Game_Clock::time_point started;
+	};
+	std::unordered_map<key_type, DecodeItem> cache_decodes;
+
+	struct TileItem {
+		std::string chipset_name;
+		int id = 0;
+		std::weak_ptr<Bitmap> bitmap;
+	};
+
+	using tile_key_type = uint64_t;
+	std::unordered_map<tile_key_type, TileItem> cache_tiles;
+
+	struct EffectKey {
+		/** Bitmap::GetId of the source */
+		uint32_t source_id;
+		Rect rect;
+		bool flip_x;
+		bool flip_y;
+		Tone tone;
+		Color blend;
+		int hue;
+	};
+
+	bool operator==(const EffectKey& l, const EffectKey& r) {
+		return l.source_id == r.source_id
+			&& l.rect == r.rect
+			&& l.flip_x == r.flip_x
+			&& l.flip_y == r.flip_y
+			&& l.tone == r.tone
+			&& l.blend == r.blend
+			&& l.hue == r.hue;
+	}
+
+	struct EffectKeyHash {
+		size_t operator()(const EffectKey& key) const {
+			const int values[] = {
+				key.rect.x, key.rect.y, key.rect.width, key.rect.height,
+				key.flip_x | (key.flip_y << 1),
+				key.tone.red, key.tone.green, key.tone.blue, key.tone.gray,
+				key.blend.red, key.blend.green, key.blend.blue, key.blend.alpha,
+				key.hue
+			};
+			uint64_t hash = HashBytes(hash_offset, reinterpret_cast<const char*>(&key.source_id), sizeof(key.source_id));
+			return static_cast<size_t>(HashBytes(hash, reinterpret_cast<const char*>(values), sizeof(values)));
+		}
+	};
 
-	// rect, flip_x, flip_y, tone, blend
-	using effect_key_type = std::tuple<BitmapRef, Rect, bool, bool, Tone, Color>;
-	std::map<effect_key_type, std::weak_ptr<Bitmap>> cache_effects;
+	struct EffectItem;
+	using effect_entry = std::pair<const EffectKey, EffectItem>;
+
+	struct EffectItem {
+		/** Detects a source which was freed or modified */
+		std::weak_ptr<Bitmap> source;
+		uint32_t source_revision = 0;
+		BitmapRef bitmap;
+		/** Position in cache_effects_lru */
+		std::list<effect_entry*>::iterator lru_it;
+	};
+
+	std::unordered_map<EffectKey, EffectItem, EffectKeyHash> cache_effects;
+	/** Effect entries, least recently used first */
+	std::list<effect_entry*> cache_effects_lru;
+	size_t cache_effects_size = 0;
+	Cache::EffectStats effect_stats;
+	Cache::Stats bitmap_stats;
+
+	/** Pages shared by the small pictures and facesets */
+	BitmapAtlas atlas;
 
 	std::string system_name;
 
 	std::string system2_name;
 
-	constexpr int cache_limit = 10 * 1024 * 1024;
+	size_t cache_limit = DEFAULT_CACHE_SIZE * 1024 * 1024;
 	size_t cache_size = 0;
 
-	void FreeBitmapMemory() {
+	/** Share of cache_limit used by the sprite effect cache */
+	constexpr size_t effect_limit_divisor = 4;
+	/** Misses between searches for effects of freed bitmaps */
+	constexpr size_t effect_sweep_interval = 64;
+
+	/** Marks the entry as most recently used */
+	void TouchEntry(CacheItem& item) {
+		item.last_access = Game_Clock::GetFrameTime();
+		cache_lru.splice(cache_lru.end(), cache_lru, item.lru_it);
+	}
+
+	/**
+	 * Frees unused bitmaps, least recently used first.
+	 *
+	 * @param limit size to reach
+	 * @param keep_recent stop at bitmaps accessed in the last 3s once below the limit
+	 */
+	void FreeBitmapMemory(size_t limit = cache_limit, bool keep_recent = true) {
 		auto cur_ticks = Game_Clock::GetFrameTime();
 
-		for (auto it = cache.begin(); it != cache.end();) {
-			if (it->second.bitmap.use_count() != 1) {
-				// Bitmap is referenced
-				++it;
-				continue;
+		// Every entry is visited at most once
+		for (size_t n = cache_lru.size(); n > 0 && !cache_lru.empty(); --n) {
+			auto& entry = *cache_lru.front();
+			auto& item = entry.second;
+
+			if (cache_size <= limit && (!keep_recent || cur_ticks - item.last_access < 3s)) {
+				// Below memory limit and all remaining entries were accessed < 3s ago
+				break;
 			}
 
-			if (cache_size <= cache_limit && cur_ticks - it->second.last_access < 3s) {
-				// Below memory limit and last access < 3s
-				++it;
+			if (item.bitmap.use_count() != 1) {
+				// Bitmap is referenced, still in use
+				TouchEntry(item);
 				continue;
 			}
 
 #ifdef CACHE_DEBUG
-			Output::Debug("Freeing memory of {}/{}", std::get<0>(i.first), std::get<1>(i.first));
+			Output::Debug("Freeing memory of {}/{}", item.folder_name, item.filename);
 #endif
 
-			cache_size -= it->second.bitmap->GetSize();
+			cache_size -= item.bitmap->GetSize();
+
+			cache_lru.pop_front();
+			const auto key = entry.first;
+			cache.erase(key);
+		}
 
-			it = cache.erase(it);
+		// Finished decodes nobody took, e.g. of a scene left already or of a speculative request
+		for (auto it = cache_decodes.begin(); it != cache_decodes.end();) {
+			auto& item = it->second;
+			if ((keep_recent && cur_ticks - item.started < 3s) ||
+					item.handle.wait_for(0s) != std::future_status::ready) {
+				++it;
+				continue;
+			}
+			it = cache_decodes.erase(it);
 		}
 
 #ifdef CACHE_DEBUG
@@ -121,7 +243,181 @@ namespace {
 #endif
 	}
 
-	BitmapRef AddToCache(const std::string& key, BitmapRef bmp) {
+	void EraseEffect(effect_entry& entry) {
+		cache_effects_size -= entry.second.bitmap->GetSize();
+		cache_effects_lru.erase(entry.second.lru_it);
+		const auto key = entry.first;
+		cache_effects.erase(key);
+	}
+
+	/**
+	 * Frees unused sprite effects, least recently used first.
+	 *
+	 * @param limit size to reach
+	 * @param sweep also free the effects of all freed bitmaps
+	 */
+	void FreeEffectMemory(size_t limit = cache_limit / effect_limit_divisor, bool sweep = effect_stats.misses % effect_sweep_interval == 0) {
+		if (sweep) {
+			// Effects of freed bitmaps can't be requested anymore
+			for (auto it = cache_effects.begin(); it != cache_effects.end();) {
+				auto& entry = *it++;
+				if (entry.second.source.expired()) {
+					EraseEffect(entry);
+					++effect_stats.evictions;
+				}
+			}
+		}
+
+		// Every entry is visited at most once
+		for (size_t n = cache_effects_lru.size(); n > 0 && cache_effects_size > limit; --n) {
+			auto& entry = *cache_effects_lru.front();
+			auto& item = entry.second;
+
+			if (item.bitmap.use_count() != 1 && !item.source.expired()) {
+				// Bitmap is referenced, still in use
+				cache_effects_lru.splice(cache_effects_lru.end(), cache_effects_lru, item.lru_it);
+				continue;
+			}
+
+			EraseEffect(entry);
+			++effect_stats.evictions;
+		}
+	}
+
+	/**
+	 * Looks up an effect of an unmodified source. A miss makes room for the
+	 * effect which is created next.
+	 *
+	 * @return cached effect bitmap or nullptr
+	 */
+	BitmapRef FindEffect(const EffectKey& key, const BitmapRef& src_bitmap) {
+		auto it = cache_effects.find(key);
+
+		if (it != cache_effects.end()) {
+			auto& item = it->second;
+			if (item.source.lock() == src_bitmap && item.source_revision == src_bitmap->GetRevision()) {
+				++effect_stats.hits;
+				cache_effects_lru.splice(cache_effects_lru.end(), cache_effects_lru, item.lru_it);
+				return item.bitmap;
+			}
+			// The source was modified, the effect is outdated
+			EraseEffect(*it);
+		}
+
+		++effect_stats.misses;
+		FreeEffectMemory();
+		return nullptr;
+	}
+
+	void InsertEffect(const EffectKey& key, const BitmapRef& src_bitmap, BitmapRef bitmap) {
+		auto& entry = *cache_effects.emplace(key, EffectItem()).first;
+		entry.second.source = src_bitmap;
+		entry.second.source_revision = src_bitmap->GetRevision();
+		entry.second.bitmap = std::move(bitmap);
+		entry.second.lru_it = cache_effects_lru.insert(cache_effects_lru.end(), &entry);
+		cache_effects_size += entry.second.bitmap->GetSize();
+	}
+
+#ifdef HAVE_THREADS
+	/** Runs the decodes of Cache::DecodeAsync on the JobSystem, at most limit at once */
+	class DecodeQueue {
+	public:
+		void SetLimit(int count);
+
+		int GetLimit() const;
+
+		/** Queues fn, it runs on a worker once fewer than limit decodes run */
+		void Post(std::function<void()> fn);
+
+	private:
+		void Drain();
+
+		std::mutex mutex;
+		std::deque<std::function<void()>> jobs;
+		int limit = 0;
+		int running = 0;
+	};
+
+	void DecodeQueue::SetLimit(int count) {
+		std::lock_guard<std::mutex> lock(mutex);
+		limit = count;
+	}
+
+	int DecodeQueue::GetLimit() const {
+		return limit;
+	}
+
+	void DecodeQueue::Post(std::function<void()> fn) {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			jobs.push_back(std::move(fn));
+			if (running >= limit) {
+				return;
+			}
+			++running;
+		}
+		JobSystem::Submit([this]() { Drain(); }, JobSystem::Priority::Normal);
+	}
+
+	void DecodeQueue::Drain() {
+		std::unique_lock<std::mutex> lock(mutex);
+		while (!jobs.empty()) {
+			auto fn = std::move(jobs.front());
+			jobs.pop_front();
+			lock.unlock();
+			fn();
+			lock.lock();
+		}
+		--running;
+	}
+
+	DecodeQueue decode_queue;
+#endif
+
+	/** Takes the result of a background decode of the image, if any */
+	bool TakeDecoded(key_type key, StringView folder_name, StringView filename, BitmapRef& bmp) {
+		auto it = cache_decodes.find(key);
+		if (it == cache_decodes.end() ||
+				StringView(it->second.folder_name) != folder_name ||
+				StringView(it->second.filename) != filename) {
+			return false;
+		}
+
+		// Blocks when the decode is still running
+		bmp = it->second.handle.get();
+		if (bmp) {
+			AssetCache::Store(it->second.path, it->second.transparent, *bmp);
+		}
+		cache_decodes.erase(it);
+		return true;
+	}
+
+	using cache_iterator = std::unordered_map<key_type, CacheItem>::iterator;
+
+	cache_iterator FindInCache(key_type key, StringView folder_name, StringView filename, bool transparent) {
+		auto it = cache.find(key);
+		if (it == cache.end()) {
+			++bitmap_stats.misses;
+			return it;
+		}
+
+		auto& item = it->second;
+		if (item.transparent != transparent || StringView(item.folder_name) != folder_name || StringView(item.filename) != filename) {
+			// Hash collision, the new bitmap replaces the entry
+			if (item.bitmap) {
+				cache_size -= item.bitmap->GetSize();
+			}
+			cache_lru.erase(item.lru_it);
+			cache.erase(it);
+			++bitmap_stats.misses;
+			return cache.end();
+		}
+
+		++bitmap_stats.hits;
+		return it;
+	}
+
+	BitmapRef AddToCache(key_type key, StringView folder_name, StringView filename, bool transparent, BitmapRef bmp) {
 		if (bmp) {
 			cache_size += bmp->GetSize();
 #ifdef CACHE_DEBUG
@@ -129,38 +425,67 @@ namespace {
 #endif
 		}
 
-		return (cache[key] = {bmp, Game_Clock::GetFrameTime()}).bitmap;
+		auto& entry = *cache.emplace(key, CacheItem()).first;
+		entry.second.folder_name = ToString(folder_name);
+		entry.second.filename = ToString(filename);
+		entry.second.transparent = transparent;
+		entry.second.bitmap = bmp;
+		entry.second.last_access = Game_Clock::GetFrameTime();
+		entry.second.lru_it = cache_lru.insert(cache_lru.end(), &entry);
+
+		return entry.second.bitmap;
 	}
 
 	BitmapRef LoadBitmap(StringView folder_name, StringView filename,
-						 bool transparent, const uint32_t flags) {
+						 bool transparent, const uint32_t flags, bool pack = false) {
 		const auto key = MakeHashKey(folder_name, filename, transparent);
 
-		auto it = cache.find(key);
+		auto it = FindInCache(key, folder_name, filename, transparent);
 
 		if (it == cache.end()) {
-			// FIXME: STRING_VIEW string copies here
-			const std::string path = FileFinder::FindImage(ToString(folder_name), ToString(filename));
+			INSTRUMENTATION_SCOPE("Cache::LoadBitmap");
 
 			BitmapRef bmp = BitmapRef();
 
 			FreeBitmapMemory();
 
+			if (TakeDecoded(key, folder_name, filename, bmp)) {
+				if (!bmp) {
+					Output::Warning("Invalid image: {}/{}", folder_name, filename);
+				}
+				if (bmp && pack) {
+					bmp = atlas.Pack(bmp);
+				}
+				return bmp ? AddToCache(key, folder_name, filename, transparent, bmp) : nullptr;
+			}
+
+			// FIXME: STRING_VIEW string copies here
+			const std::string path = FileFinder::FindImage(ToString(folder_name), ToString(filename));
+
 			if (path.empty()) {
 				Output::Warning("Image not found: {}/{}", folder_name, filename);
 			} else {
-				bmp = Bitmap::Create(path, transparent, flags);
+				bmp = AssetCache::Load(path, transparent, flags);
+				if (!bmp) {
+					bmp = Bitmap::Create(path, transparent, flags);
+					if (bmp) {
+						AssetCache::Store(path, transparent, *bmp);
+					}
+				}
 				if (!bmp) {
 					Output::Warning("Invalid image: {}/{}", folder_name, filename);
 				}
 			}
 
 			if (bmp) {
-				return AddToCache(key, bmp);
+				if (pack) {
+					bmp = atlas.Pack(bmp);
+				}
+				return AddToCache(key, folder_name, filename, transparent, bmp);
 			}
 			return nullptr;
 		} else {
-			it->second.last_access = Game_Clock::GetFrameTime();
+			TouchEntry(it->second);
 			return it->second.bitmap;
 		}
 	}
@@ -233,7 +558,6 @@ namespace {
 		FreeBitmapMemory();
 
 		BitmapRef bitmap = Bitmap::Create(s.max_width, s.max_height, false);
-		cache_size += bitmap->GetSize();
 
 		// ToDo: Maybe use different renderers depending on material
 		// Will look ugly for some image types
@@ -257,16 +581,16 @@ namespace {
 
 		const auto key = MakeHashKey(folder_name, filename, transparent);
 
-		auto it = cache.find(key);
+		auto it = FindInCache(key, folder_name, filename, transparent);
 
 		if (it == cache.end()) {
 			FreeBitmapMemory();
 
 			BitmapRef bitmap = s.dummy_renderer();
 
-			return AddToCache(key, bitmap);
+			return AddToCache(key, folder_name, filename, transparent, bitmap);
 		} else {
-			it->second.last_access = Game_Clock::GetFrameTime();
+			TouchEntry(it->second);
 			return it->second.bitmap;
 		}
 	}
@@ -289,10 +613,14 @@ namespace {
 		assert(req != nullptr && req->IsReady());
 #endif
 
-		BitmapRef ret = LoadBitmap(s.directory, f, transparent, Bitmap::Flag_ReadOnly | (
-										 T == Material::Chipset? Bitmap::Flag_Chipset:
-										 T == Material::System? Bitmap::Flag_System:
-										 0));
+		const uint32_t flags = Bitmap::Flag_ReadOnly | (
+				T == Material::Chipset? Bitmap::Flag_Chipset | Bitmap::Flag_Paletted:
+				T == Material::System? Bitmap::Flag_System:
+				T == Material::Charset || T == Material::Faceset ? Bitmap::Flag_Paletted:
+				0);
+		// Small pictures and facesets share atlas pages
+		const bool pack = T == Material::Picture || T == Material::Faceset;
+		BitmapRef ret = LoadBitmap(s.directory, f, transparent, flags, pack);
 
 		if (!ret) {
 			return LoadDummyBitmap<T>(s.directory, f, transparent);
@@ -399,7 +727,7 @@ BitmapRef Cache::System(StringView file) {
 BitmapRef Cache::Exfont() {
 	const auto key = MakeHashKey("ExFont", "ExFont", false);
 
-	auto it = cache.find(key);
+	auto it = FindInCache(key, "ExFont", "ExFont", false);
 
 	if (it == cache.end()) {
 		// Allow overwriting of built-in exfont with a custom ExFont image file
@@ -413,9 +741,9 @@ BitmapRef Cache::Exfont() {
 			exfont_img = Bitmap::Create(exfont_h, sizeof(exfont_h), true);
 		}
 
-		return AddToCache(key, exfont_img);
+		return AddToCache(key, "ExFont", "ExFont", false, exfont_img);
 	} else {
-		it->second.last_access = Game_Clock::GetFrameTime();
+		TouchEntry(it->second);
 		return it->second.bitmap;
 	}
 }
@@ -424,7 +752,8 @@ BitmapRef Cache::Tile(StringView filename, int tile_id) {
 	const auto key = MakeTileHashKey(filename, tile_id);
 	auto it = cache_tiles.find(key);
 
-	if (it == cache_tiles.end() || it->second.expired()) {
+	if (it == cache_tiles.end() || it->second.bitmap.expired() ||
+			it->second.id != tile_id || StringView(it->second.chipset_name) != filename) {
 		BitmapRef chipset = Cache::Chipset(filename);
 		Rect rect = Rect(0, 0, 16, 16);
 
@@ -449,76 +778,227 @@ BitmapRef Cache::Tile(StringView filename, int tile_id) {
 		rect.x += sub_tile_id % 6 * 16;
 		rect.y += sub_tile_id / 6 * 16;
 
-		return(cache_tiles[key] = Bitmap::Create(*chipset, rect)).lock();
-	} else { return it->second.lock(); }
+		auto bitmap = Bitmap::Create(*chipset, rect);
+		cache_tiles[key] = { ToString(filename), tile_id, bitmap };
+		return bitmap;
+	} else { return it->second.bitmap.lock(); }
 }
 
 BitmapRef Cache::SpriteEffect(const BitmapRef& src_bitmap, const Rect& rect, bool flip_x, bool flip_y, const Tone& tone, const Color& blend) {
-	const effect_key_type key {
-		src_bitmap,
+	const EffectKey key {
+		src_bitmap->GetId(),
 		rect,
 		flip_x,
 		flip_y,
 		tone,
-		blend
+		blend,
+		0
 	};
 
-	const auto it = cache_effects.find(key);
+	if (auto bitmap = FindEffect(key, src_bitmap)) {
+		return bitmap;
+	}
 
-	if (it == cache_effects.end() || it->second.expired()) {
-		BitmapRef bitmap_effects;
+	BitmapRef bitmap_effects = Bitmap::Create(rect.width, rect.height, true);
+	const bool applied = DrawSpriteEffect(*bitmap_effects, *src_bitmap, rect, flip_x, flip_y, tone, blend);
+	assert(applied && "Effect cache used but no effect applied!");
+	(void)applied;
 
-		auto create = [&rect] () -> BitmapRef {
-			return Bitmap::Create(rect.width, rect.height, true);
-		};
+	InsertEffect(key, src_bitmap, bitmap_effects);
+
+	return bitmap_effects;
+}
+
+bool Cache::DrawSpriteEffect(Bitmap& dst, const Bitmap& src_bitmap, const Rect& rect, bool flip_x, bool flip_y, const Tone& tone, const Color& blend) {
+	bool applied = false;
 
-		if (tone != Tone()) {
-			bitmap_effects = create();
-			bitmap_effects->ToneBlit(0, 0, *src_bitmap, rect, tone, Opacity::Opaque());
+	if (tone != Tone()) {
+		dst.ToneBlit(0, 0, src_bitmap, rect, tone, Opacity::Opaque());
+		applied = true;
+	}
+
+	if (blend != Color()) {
+		if (applied) {
+			// Tone blit was applied
+			dst.BlendBlit(0, 0, dst, dst.GetRect(), blend, Opacity::Opaque());
+		} else {
+			dst.BlendBlit(0, 0, src_bitmap, rect, blend, Opacity::Opaque());
 		}
+		applied = true;
+	}
 
-		if (blend != Color()) {
-			if (bitmap_effects) {
-				// Tone blit was applied
-				bitmap_effects->BlendBlit(0, 0, *bitmap_effects, bitmap_effects->GetRect(), blend, Opacity::Opaque());
-			} else {
-				bitmap_effects = create();
-				bitmap_effects->BlendBlit(0, 0, *src_bitmap, rect, blend, Opacity::Opaque());
-			}
+	if (flip_x || flip_y) {
+		if (applied) {
+			// Tone or blend blit was applied
+			dst.Flip(flip_x, flip_y);
+		} else {
+			dst.FlipBlit(rect.x, rect.y, src_bitmap, rect, flip_x, flip_y, Opacity::Opaque());
 		}
+		applied = true;
+	}
 
-		if (flip_x || flip_y) {
-			if (bitmap_effects) {
-				// Tone or blend blit was applied
-				bitmap_effects->Flip(flip_x, flip_y);
-			} else {
-				bitmap_effects = create();
-				bitmap_effects->FlipBlit(rect.x, rect.y, *src_bitmap, rect, flip_x, flip_y, Opacity::Opaque());
-			}
+	return applied;
+}
+
+BitmapRef Cache::HueChange(const BitmapRef& src_bitmap, int hue) {
+	const EffectKey key {
+		src_bitmap->GetId(),
+		src_bitmap->GetRect(),
+		false,
+		false,
+		Tone(),
+		Color(),
+		hue
+	};
+
+	if (auto bitmap = FindEffect(key, src_bitmap)) {
+		return bitmap;
+	}
+
+	auto bitmap = Bitmap::Create(src_bitmap->GetWidth(), src_bitmap->GetHeight());
+	bitmap->HueChangeBlit(0, 0, *src_bitmap, src_bitmap->GetRect(), hue);
+	InsertEffect(key, src_bitmap, bitmap);
+
+	return bitmap;
+}
+
+Cache::EffectStats Cache::GetEffectStats() {
+	return effect_stats;
+}
+
+Cache::Stats Cache::GetStats() {
+	auto stats = bitmap_stats;
+	stats.bytes = cache_size + cache_effects_size;
+	return stats;
+}
+
+void Cache::SetLimit(size_t bytes) {
+	cache_limit = bytes;
+}
+
+void Cache::Trim(size_t bytes) {
+	FreeEffectMemory(bytes / effect_limit_divisor, true);
+	FreeBitmapMemory(bytes - std::min(bytes, cache_effects_size), false);
+}
+
+void Cache::SetDecodeThreads(int threads) {
+#ifdef HAVE_THREADS
+	decode_queue.SetLimit(threads);
+#else
+	(void)threads;
+#endif
+}
+
+Cache::DecodeHandle Cache::DecodeAsync(StringView folder_name, StringView filename) {
+#ifdef HAVE_THREADS
+	if (decode_queue.GetLimit() == 0 || JobSystem::GetThreadCount() == 0 || filename == CACHE_DEFAULT_BITMAP) {
+		return {};
+	}
+
+	const Spec* s = nullptr;
+	for (auto& candidate: spec) {
+		if (folder_name == candidate.directory) {
+			s = &candidate;
+			break;
 		}
+	}
+	if (!s) {
+		// Not an image folder
+		return {};
+	}
 
-		assert(bitmap_effects && "Effect cache used but no effect applied!");
+	const uint32_t flags = Bitmap::Flag_ReadOnly | (
+			s == &spec[Material::Chipset] ? Bitmap::Flag_Chipset | Bitmap::Flag_Paletted :
+			s == &spec[Material::System] ? Bitmap::Flag_System :
+			s == &spec[Material::Charset] || s == &spec[Material::Faceset] ? Bitmap::Flag_Paletted :
+			0);
+	const auto key = MakeHashKey(folder_name, filename, s->transparent);
 
-		return(cache_effects[key] = bitmap_effects).lock();
-	} else { return it->second.lock(); }
+	if (cache.find(key) != cache.end()) {
+		// Already decoded
+		return {};
+	}
+
+	auto it = cache_decodes.find(key);
+	if (it != cache_decodes.end()) {
+		return it->second.handle;
+	}
+
+	const std::string path = FileFinder::FindImage(ToString(folder_name), ToString(filename));
+	if (path.empty()) {
+		// Reported by the synchronous load
+		return {};
+	}
+
+	const bool transparent = s->transparent;
+	if (auto bmp = AssetCache::Load(path, transparent, flags)) {
+		// Nothing left to decode
+		FreeBitmapMemory();
+		AddToCache(key, folder_name, filename, transparent, bmp);
+		return {};
+	}
+
+	// Archives are only safe to read on the main thread, plain files are read by the worker
+	std::shared_ptr<std::vector<uint8_t>> data;
+	if (FileFinder::IsInArchive(path)) {
+		auto stream = FileFinder::OpenInputStream(path, std::ios::ios_base::binary | std::ios::ios_base::in);
+		if (!stream) {
+			return {};
+		}
+		data = std::make_shared<std::vector<uint8_t>>(Utils::ReadStream(stream));
+	}
+
+	// Reading, decoding and the conversion to the screen format run on the worker
+	auto task = std::make_shared<std::packaged_task<BitmapRef()>>([data, path, transparent, flags]() {
+		if (!data) {
+			auto stream = FileFinder::OpenNativeInputStream(path, std::ios::ios_base::binary | std::ios::ios_base::in);
+			if (!stream) {
+				return BitmapRef();
+			}
+			auto file = Utils::ReadStream(stream);
+			return Bitmap::Create(file.data(), file.size(), transparent, flags);
+		}
+		return Bitmap::Create(data->data(), data->size(), transparent, flags);
+	});
+	DecodeHandle handle = task->get_future().share();
+	decode_queue.Post([task]() { (*task)(); });
+
+	cache_decodes[key] = { ToString(folder_name), ToString(filename), path, transparent, handle, Game_Clock::GetFrameTime() };
+	return handle;
+#else
+	(void)folder_name;
+	(void)filename;
+	return {};
+#endif
 }
 
 void Cache::Clear() {
 	cache_effects.clear();
+	cache_effects_lru.clear();
+	cache_effects_size = 0;
 	cache.clear();
+	cache_lru.clear();
 	cache_size = 0;
 
+	for (auto& kv : cache_decodes) {
+		// The workers must not outlive the data they write to
+		kv.second.handle.wait();
+	}
+	cache_decodes.clear();
+
 	for (auto& kv : cache_tiles) {
-		auto& key = kv.first;
-		if (kv.second.expired()) {
+		auto& item = kv.second;
+		if (item.bitmap.expired()) {
 			continue;
 		}
 		Output::Debug("possible leak in cached tilemap {}/{}",
-				NameFromTileHash(key), IdFromTileHash(key));
+				item.chipset_name, item.id);
 	}
 
 	cache_tiles.clear();
 
+	atlas.Clear();
+
 	system2_name.clear();
 }
 
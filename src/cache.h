@@ -19,6 +19,7 @@
 #define EP_CACHE_H
 
 // Headers
+#include <future>
 #include <string>
 #include <vector>
 
@@ -57,8 +58,94 @@ namespace Cache {
 	BitmapRef Tile(StringView filename, int tile_id);
 	BitmapRef SpriteEffect(const BitmapRef& src_bitmap, const Rect& rect, bool flip_x, bool flip_y, const Tone& tone, const Color& blend);
 
+	/**
+	 * Draws the image SpriteEffect returns without caching it.
+	 *
+	 * @param dst cleared image with the size of rect
+	 * @param src_bitmap source image
+	 * @param rect source rectangle
+	 * @param flip_x horizontal flip
+	 * @param flip_y vertical flip
+	 * @param tone tone effect
+	 * @param blend flash effect
+	 * @return false when no effect was applied and dst is still empty
+	 */
+	bool DrawSpriteEffect(Bitmap& dst, const Bitmap& src_bitmap, const Rect& rect, bool flip_x, bool flip_y, const Tone& tone, const Color& blend);
+
+	/**
+	 * Returns the bitmap with its hue rotated, cached like the sprite effects.
+	 *
+	 * @param src_bitmap source bitmap
+	 * @param hue hue change in degrees
+	 * @return hue changed bitmap
+	 * @see Bitmap::HueChangeBlit
+	 */
+	BitmapRef HueChange(const BitmapRef& src_bitmap, int hue);
+
+	/** Future-like handle of an image decoded in the background */
+	using DecodeHandle = std::shared_future<BitmapRef>;
+
+	/**
+	 * Sets how many images DecodeAsync decodes at once on the JobSystem.
+	 *
+	 * @param threads number of parallel decodes, 0 decodes on the main thread only
+	 */
+	void SetDecodeThreads(int threads);
+
+	/**
+	 * Starts decoding an image from one of the cached folders in the
+	 * background. The next lookup of the image takes the result and waits
+	 * when it is not finished yet. Results not looked up within 3 seconds
+	 * are freed with the unused cache entries.
+	 *
+	 * @param folder_name folder of the image, e.g. "Picture"
+	 * @param filename name of the image
+	 * @return handle of the decode, invalid when the image is decoded on lookup
+	 */
+	DecodeHandle DecodeAsync(StringView folder_name, StringView filename);
+
+	/** Counters of the bitmap cache */
+	struct Stats {
+		size_t hits = 0;
+		size_t misses = 0;
+		/** Size of the cached bitmaps and sprite effects */
+		size_t bytes = 0;
+	};
+
+	/** @return counters of the bitmap cache since startup */
+	Stats GetStats();
+
+	/** Counters of the sprite effect cache */
+	struct EffectStats {
+		size_t hits = 0;
+		size_t misses = 0;
+		size_t evictions = 0;
+	};
+
+	/** @return counters of the sprite effect cache since startup */
+	EffectStats GetEffectStats();
+
 	void Clear();
 
+	/**
+	 * Sets the memory budget of the bitmap cache.
+	 * Unused bitmaps are freed, least recently used first, when the cache
+	 * grows beyond it. Bitmaps which are still referenced are never freed.
+	 * A quarter of the budget is used for cached sprite effects.
+	 *
+	 * @param bytes size limit in bytes
+	 */
+	void SetLimit(size_t bytes);
+
+	/**
+	 * Frees unused bitmaps and sprite effects, least recently used first,
+	 * until the cache uses at most bytes. Unlike the budget of SetLimit this
+	 * frees recently used bitmaps as well. Used on low memory.
+	 *
+	 * @param bytes size to reach, referenced bitmaps can keep it above
+	 */
+	void Trim(size_t bytes);
+
 	/** @return the configured system bitmap, or nullptr if there is no system */
 	BitmapRef System();
 
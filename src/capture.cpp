@@ -0,0 +1,310 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+// Headers
+#include <atomic>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <vector>
+#ifdef HAVE_THREADS
+#  include <condition_variable>
+#  include <mutex>
+#  include <thread>
+#endif
+#include "capture.h"
+#include "bitmap.h"
+#include "filefinder.h"
+#include "game_clock.h"
+#include "output.h"
+#include "thread_affinity.h"
+
+namespace {
+	constexpr char magic[4] = { 'E', 'P', 'C', 'V' };
+	constexpr uint32_t version = 1;
+	/** Frames waiting for the writer, more are dropped */
+	constexpr size_t max_pending_frames = 8;
+	/** Audio bytes waiting for the writer, more are dropped */
+	constexpr size_t max_pending_audio = 1024 * 1024;
+	/** Buffers kept for reuse */
+	constexpr size_t max_free_buffers = 16;
+
+	struct Packet {
+		char type;
+		int64_t time;
+		uint32_t a;
+		uint32_t b;
+		std::vector<uint8_t> data;
+	};
+
+	std::unique_ptr<Filesystem_Stream::OutputStream> out;
+	std::atomic<bool> active{false};
+	bool write_failed = false;
+	Game_Clock::time_point start_time;
+
+	std::deque<Packet> queue;
+	std::vector<std::vector<uint8_t>> free_buffers;
+	size_t pending_frames = 0;
+	size_t pending_audio = 0;
+	int dropped_frames = 0;
+	std::atomic<int> dropped_audio{0};
+
+	const Bitmap* last_surface = nullptr;
+	uint32_t last_revision = 0;
+
+#ifdef HAVE_THREADS
+	std::mutex mutex;
+	std::condition_variable cv;
+	std::thread writer;
+	bool quit = false;
+#endif
+
+	void WriteU32(std::ostream& os, uint32_t value) {
+		const char bytes[4] = {
+			static_cast<char>(value & 0xFF), static_cast<char>((value >> 8) & 0xFF),
+			static_cast<char>((value >> 16) & 0xFF), static_cast<char>((value >> 24) & 0xFF)
+		};
+		os.write(bytes, sizeof(bytes));
+	}
+
+	void WritePacket(const Packet& packet) {
+		if (write_failed) {
+			return;
+		}
+		auto& os = *out;
+		const char type[4] = { packet.type, 0, 0, 0 };
+		os.write(type, sizeof(type));
+		WriteU32(os, packet.type == 'R' ? 0 : static_cast<uint32_t>(packet.data.size() + 8));
+		WriteU32(os, static_cast<uint32_t>(packet.time & 0xFFFFFFFF));
+		WriteU32(os, static_cast<uint32_t>(static_cast<uint64_t>(packet.time) >> 32));
+		if (packet.type != 'R') {
+			WriteU32(os, packet.a);
+			WriteU32(os, packet.b);
+			os.write(reinterpret_cast<const char*>(packet.data.data()), packet.data.size());
+		}
+		if (!os) {
+			// The reader of a pipe went away
+			Output::Warning("Capture: Writing failed, capture stopped");
+			write_failed = true;
+		}
+	}
+
+	/** Must be called with the mutex locked */
+	std::vector<uint8_t> TakeBuffer() {
+		if (free_buffers.empty()) {
+			return {};
+		}
+		auto buffer = std::move(free_buffers.back());
+		free_buffers.pop_back();
+		return buffer;
+	}
+
+	/** Must be called with the mutex locked */
+	void ReturnBuffer(std::vector<uint8_t> buffer) {
+		if (free_buffers.size() < max_free_buffers && buffer.capacity() > 0) {
+			free_buffers.push_back(std::move(buffer));
+		}
+	}
+
+	int64_t Now() {
+		return std::chrono::duration_cast<std::chrono::microseconds>(Game_Clock::now() - start_time).count();
+	}
+
+#ifdef HAVE_THREADS
+	void Work() {
+		ThreadAffinity::Apply(ThreadAffinity::Role::Worker);
+		std::unique_lock<std::mutex> lock(mutex);
+		while (true) {
+			cv.wait(lock, [] { return quit || !queue.empty(); });
+			if (queue.empty()) {
+				break;
+			}
+
+			Packet packet = std::move(queue.front());
+			queue.pop_front();
+			lock.unlock();
+			WritePacket(packet);
+			lock.lock();
+
+			if (packet.type != 'A') {
+				--pending_frames;
+			} else {
+				pending_audio -= packet.data.size();
+			}
+			ReturnBuffer(std::move(packet.data));
+		}
+		out->flush();
+	}
+#endif
+
+	/** Queues the packet, writes it immediately without threads */
+	void Push(Packet packet) {
+#ifdef HAVE_THREADS
+		if (packet.type != 'A') {
+			++pending_frames;
+		} else {
+			pending_audio += packet.data.size();
+		}
+		queue.push_back(std::move(packet));
+		cv.notify_one();
+#else
+		WritePacket(packet);
+		ReturnBuffer(std::move(packet.data));
+#endif
+	}
+}
+
+bool Capture::Start(const std::string& path) {
+	Stop();
+
+	out = std::make_unique<Filesystem_Stream::OutputStream>(FileFinder::OpenOutputStream(path,
+		std::ios_base::binary | std::ios_base::out | std::ios_base::trunc));
+	if (!*out) {
+		Output::Warning("Capture: Could not open {}", path);
+		out.reset();
+		return false;
+	}
+
+	const auto& format = Bitmap::pixel_format;
+	out->write(magic, sizeof(magic));
+	WriteU32(*out, version);
+	WriteU32(*out, format.bytes);
+	WriteU32(*out, format.r.mask);
+	WriteU32(*out, format.g.mask);
+	WriteU32(*out, format.b.mask);
+	WriteU32(*out, format.a.mask);
+
+	write_failed = false;
+	start_time = Game_Clock::now();
+	last_surface = nullptr;
+	pending_frames = 0;
+	pending_audio = 0;
+	dropped_frames = 0;
+	dropped_audio = 0;
+#ifdef HAVE_THREADS
+	quit = false;
+	writer = std::thread(Work);
+#endif
+	active = true;
+
+	Output::Debug("Capture: Writing to {}", path);
+	return true;
+}
+
+void Capture::Stop() {
+	if (!active) {
+		return;
+	}
+	active = false;
+
+#ifdef HAVE_THREADS
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		quit = true;
+	}
+	cv.notify_one();
+	writer.join();
+#endif
+	out.reset();
+	queue.clear();
+	free_buffers.clear();
+
+	if (dropped_frames > 0) {
+		Output::Debug("Capture: {} frames dropped", dropped_frames);
+	}
+	if (dropped_audio > 0) {
+		Output::Debug("Capture: {} audio packets dropped", dropped_audio.load());
+	}
+}
+
+bool Capture::IsActive() {
+	return active;
+}
+
+void Capture::OnFrame(const Bitmap& surface) {
+	if (!active) {
+		return;
+	}
+
+	const int64_t time = Now();
+	// The displays read the surface through const access when presenting, the revision only changes by drawing
+	const bool unchanged = last_surface == &surface && last_revision == surface.GetRevision();
+	last_surface = &surface;
+	last_revision = surface.GetRevision();
+
+#ifdef HAVE_THREADS
+	std::lock_guard<std::mutex> lock(mutex);
+#endif
+	if (pending_frames >= max_pending_frames) {
+		++dropped_frames;
+		// The next frame must carry the pixels again
+		last_surface = nullptr;
+		return;
+	}
+
+	if (unchanged) {
+		Push({ 'R', time, 0, 0, {} });
+		return;
+	}
+
+	const int width = surface.GetWidth();
+	const int height = surface.GetHeight();
+	const size_t row_size = static_cast<size_t>(width) * surface.bpp();
+
+	Packet packet = { 'V', time, static_cast<uint32_t>(width), static_cast<uint32_t>(height), TakeBuffer() };
+	packet.data.resize(row_size * height);
+	auto* src = static_cast<const uint8_t*>(surface.pixels());
+	if (static_cast<size_t>(surface.pitch()) == row_size) {
+		std::memcpy(packet.data.data(), src, row_size * height);
+	} else {
+		for (int y = 0; y < height; ++y) {
+			std::memcpy(packet.data.data() + y * row_size, src + y * surface.pitch(), row_size);
+		}
+	}
+	Push(std::move(packet));
+}
+
+void Capture::OnAudio(const uint8_t* samples, int size, int frequency, int channels) {
+	if (!active || size <= 0) {
+		return;
+	}
+
+	const int64_t time = Now();
+
+#ifdef HAVE_THREADS
+	std::lock_guard<std::mutex> lock(mutex);
+	if (!active) {
+		return;
+	}
+	if (pending_audio + size > max_pending_audio) {
+		++dropped_audio;
+		return;
+	}
+#endif
+	Packet packet = { 'A', time, static_cast<uint32_t>(frequency), static_cast<uint32_t>(channels), TakeBuffer() };
+	packet.data.assign(samples, samples + size);
+	Push(std::move(packet));
+}
+
+int Capture::GetDroppedFrames() {
+	return dropped_frames;
+}
+
+int Capture::GetDroppedAudio() {
+	return dropped_audio;
+}
@@ -0,0 +1,87 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef EP_CAPTURE_H
+#define EP_CAPTURE_H
+
+// Headers
+#include <cstdint>
+#include <string>
+
+class Bitmap;
+
+/**
+ * Writes the composited frames and the mixed audio to a file or pipe, for
+ * encoding a stream or a recording outside of the Player.
+ *
+ * The file starts with the magic "EPCV", the version and the bytes per
+ * pixel, followed by the red, green, blue and alpha masks of the pixels,
+ * all 32 bit little endian. Then packets follow, each starts with:
+ *   - uint8 type, 'V' frame, 'R' the previous frame again, 'A' audio
+ *   - 3 bytes padding
+ *   - uint32 size of the payload
+ *   - int64 microseconds since Start
+ * The payload of a frame is uint32 width and height followed by the rows
+ * without padding, audio has uint32 frequency and channels followed by
+ * signed 16 bit samples. 'R' has no payload.
+ *
+ * The packets are written by a thread. Frames are copied into pooled
+ * buffers, unchanged frames are only a reference to the previous buffer.
+ * When the reader falls behind frames and audio are dropped instead of
+ * stalling the game or queuing without limit.
+ */
+namespace Capture {
+	/**
+	 * Starts capturing, a running capture is stopped.
+	 *
+	 * @param path file or named pipe to write
+	 * @return whether the file was opened
+	 */
+	bool Start(const std::string& path);
+
+	/** Writes the queued packets and closes the file */
+	void Stop();
+
+	/** @return whether a capture is running */
+	bool IsActive();
+
+	/**
+	 * Queues a composited frame, call after every Graphics::Draw.
+	 *
+	 * @param surface display surface
+	 */
+	void OnFrame(const Bitmap& surface);
+
+	/**
+	 * Queues mixed audio, thread safe.
+	 *
+	 * @param samples signed 16 bit samples
+	 * @param size size of samples in bytes
+	 * @param frequency sample rate
+	 * @param channels interleaved channels
+	 */
+	void OnAudio(const uint8_t* samples, int size, int frequency, int channels);
+
+	/** @return frames dropped because the reader was too slow */
+	int GetDroppedFrames();
+
+	/** @return audio packets dropped because the reader was too slow */
+	int GetDroppedAudio();
+}
+
+#endif
@@ -0,0 +1,130 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include "cpu_features.h"
+
+#if defined(EP_CPU_X86) && defined(_MSC_VER)
+#  include <intrin.h>
+#  include <immintrin.h>
+#endif
+
+namespace {
+	struct Features {
+		bool sse2 = false;
+		bool avx2 = false;
+		bool neon = false;
+		bool wasm_simd = false;
+
+		Features();
+	};
+
+	Features::Features() {
+#if defined(EP_CPU_X86) && defined(__GNUC__)
+		__builtin_cpu_init();
+		sse2 = __builtin_cpu_supports("sse2");
+		// Also checks that the OS saves the YMM registers
+		avx2 = __builtin_cpu_supports("avx2");
+#elif defined(EP_CPU_X86) && defined(_MSC_VER)
+		int info[4] = {};
+		__cpuid(info, 0);
+		const int max_leaf = info[0];
+
+		__cpuid(info, 1);
+		sse2 = (info[3] & (1 << 26)) != 0;
+		const bool osxsave = (info[2] & (1 << 27)) != 0;
+		const bool avx = (info[2] & (1 << 28)) != 0;
+
+		if (max_leaf >= 7 && osxsave && avx) {
+			// XMM and YMM state must be enabled by the OS
+			const bool ymm_enabled = (_xgetbv(0) & 0x6) == 0x6;
+			__cpuidex(info, 7, 0);
+			avx2 = ymm_enabled && (info[1] & (1 << 5)) != 0;
+		}
+#endif
+#ifdef EP_CPU_COMPILE_NEON
+		// NEON is part of the target ABI when the compiler enables it
+		neon = true;
+#endif
+#ifdef EP_CPU_COMPILE_WASM_SIMD
+		// A browser without simd128 refuses to compile the whole module
+		wasm_simd = true;
+#endif
+	}
+
+	const Features& GetDetectedFeatures() {
+		static const Features features;
+		return features;
+	}
+
+	/** Detected features limited by SetOverride */
+	Features& GetFeatures() {
+		static Features features = GetDetectedFeatures();
+		return features;
+	}
+}
+
+bool CpuFeatures::SetOverride(const std::string& mode) {
+	const auto& detected = GetDetectedFeatures();
+	Features features = detected;
+	if (mode == "none") {
+		features.sse2 = features.avx2 = features.neon = features.wasm_simd = false;
+	} else if (mode == "sse2") {
+		features.avx2 = features.neon = features.wasm_simd = false;
+	} else if (mode == "avx2") {
+		features.neon = features.wasm_simd = false;
+	} else if (mode == "neon") {
+		features.sse2 = features.avx2 = features.wasm_simd = false;
+	} else if (mode == "wasm") {
+		features.sse2 = features.avx2 = features.neon = false;
+	} else if (mode != "auto") {
+		return false;
+	}
+	GetFeatures() = features;
+	return true;
+}
+
+std::string CpuFeatures::GetDescription() {
+	const auto& features = GetFeatures();
+	std::string desc;
+	auto add = [&](bool has, const char* name) {
+		if (has) {
+			desc += desc.empty() ? name : std::string(" ") + name;
+		}
+	};
+	add(features.sse2, "SSE2");
+	add(features.avx2, "AVX2");
+	add(features.neon, "NEON");
+	add(features.wasm_simd, "WASM SIMD");
+	return desc.empty() ? "none" : desc;
+}
+
+bool CpuFeatures::HasSSE2() {
+	return GetFeatures().sse2;
+}
+
+bool CpuFeatures::HasAVX2() {
+	return GetFeatures().avx2;
+}
+
+bool CpuFeatures::HasNEON() {
+	return GetFeatures().neon;
+}
+
+bool CpuFeatures::HasWasmSimd() {
+	return GetFeatures().wasm_simd;
+}
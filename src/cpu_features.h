@@ -0,0 +1,77 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_CPU_FEATURES_H
+#define EP_CPU_FEATURES_H
+
+#include <string>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#  define EP_CPU_X86
+#  if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define EP_CPU_COMPILE_SSE2
+#  endif
+#  if defined(__GNUC__) || defined(_MSC_VER)
+#    define EP_CPU_COMPILE_AVX2
+#  endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(__aarch64__) || defined(_M_ARM64)
+#  define EP_CPU_COMPILE_NEON
+#elif defined(__wasm_simd128__)
+#  define EP_CPU_COMPILE_WASM_SIMD
+#endif
+
+/** Marks a function to be compiled for AVX2 without enabling AVX2 for the whole file */
+#if defined(EP_CPU_COMPILE_AVX2) && defined(__GNUC__)
+#  define EP_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#  define EP_TARGET_AVX2
+#endif
+
+/**
+ * Detection of CPU instruction set extensions at runtime.
+ * The detection runs once, all further queries are cached.
+ * The kernel tables (BitmapSimd, AudioSimd, ...) bind to the best
+ * extension on their first use.
+ */
+namespace CpuFeatures {
+	/**
+	 * Limits the extensions reported as available, to compare kernels.
+	 * Must be called before the first kernel runs.
+	 *
+	 * @param mode "auto" for all detected extensions, "none" for the scalar
+	 *  kernels, or the highest extension: "sse2", "avx2", "neon" or "wasm"
+	 * @return false when the mode is unknown, nothing is changed then
+	 */
+	bool SetOverride(const std::string& mode);
+
+	/** @return names of the available extensions, "none" when there are none */
+	std::string GetDescription();
+
+	/** @return Whether SSE2 instructions are available */
+	bool HasSSE2();
+
+	/** @return Whether AVX2 instructions are available and enabled by the OS */
+	bool HasAVX2();
+
+	/** @return Whether NEON instructions are available */
+	bool HasNEON();
+
+	/** @return Whether WebAssembly SIMD (simd128) instructions are available */
+	bool HasWasmSimd();
+}
+
+#endif
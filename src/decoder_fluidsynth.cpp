@@ -21,6 +21,10 @@
 #if defined(HAVE_FLUIDSYNTH) || defined(HAVE_FLUIDLITE)
 
 #include <cassert>
+#include <vector>
+#ifdef HAVE_THREADS
+#  include <mutex>
+#endif
 #include "filefinder.h"
 #include "output.h"
 
@@ -85,11 +89,20 @@ struct FluidSynthDeleter {
 
 namespace {
 	std::unique_ptr<fluid_settings_t, FluidSettingsDeleter> global_settings;
-	std::unique_ptr<fluid_synth_t, FluidSynthDeleter> global_synth;
 #if defined(HAVE_FLUIDSYNTH) && FLUIDSYNTH_VERSION_MAJOR > 1
 	fluid_sfloader_t* global_loader; // owned by global_settings
 #endif
-	int instances = 0;
+
+	/**
+	 * Idle synths with the soundfont already loaded.
+	 * A new BGM is opened before the old one is closed, so two synths are
+	 * in use during a switch. Keeping both avoids loading the soundfont again.
+	 */
+	constexpr size_t max_pooled_synths = 2;
+	std::vector<std::unique_ptr<fluid_synth_t, FluidSynthDeleter>> synth_pool;
+#ifdef HAVE_THREADS
+	std::mutex synth_pool_mutex;
+#endif
 }
 
 static fluid_synth_t* create_synth(std::string& error_message) {
@@ -110,29 +123,41 @@ static fluid_synth_t* create_synth(std::string& error_message) {
 }
 
 FluidSynthDecoder::FluidSynthDecoder() {
-	++instances;
-
-	// Optimisation: Only create the soundfont once and share the synth
-	// Sharing is only not possible when a Midi is played as a SE (unlikely)
-	if (instances > 1) {
-		std::string error_message;
-		instance_synth = create_synth(error_message);
-		if (!instance_synth) {
-			// unlikely, the SF was already allocated once
-			Output::Debug("FluidSynth failed: {}", error_message);
+	// Optimisation: Only load the soundfont once and reuse the synths
+	// An additional synth is only created while two Midis play at once
+	{
+#ifdef HAVE_THREADS
+		std::lock_guard<std::mutex> lock(synth_pool_mutex);
+#endif
+		if (!synth_pool.empty()) {
+			instance_synth = synth_pool.back().release();
+			synth_pool.pop_back();
+			fluid_synth_program_reset(instance_synth);
+			return;
 		}
-	} else {
-		instance_synth = global_synth.get();
-		fluid_synth_program_reset(global_synth.get());
+	}
+
+	std::string error_message;
+	instance_synth = create_synth(error_message);
+	if (!instance_synth) {
+		// unlikely, the SF was already allocated once
+		Output::Debug("FluidSynth failed: {}", error_message);
 	}
 }
 
 FluidSynthDecoder::~FluidSynthDecoder() {
-	--instances;
-	assert(instances >= 0);
+	if (!instance_synth) {
+		return;
+	}
 
-	if (instance_synth != global_synth.get()) {
-		delete_fluid_synth(instance_synth);
+	fluid_synth_system_reset(instance_synth);
+
+	std::unique_ptr<fluid_synth_t, FluidSynthDeleter> synth(instance_synth);
+#ifdef HAVE_THREADS
+	std::lock_guard<std::mutex> lock(synth_pool_mutex);
+#endif
+	if (synth_pool.size() < max_pooled_synths) {
+		synth_pool.push_back(std::move(synth));
 	}
 }
 
@@ -175,11 +200,15 @@ bool FluidSynthDecoder::Initialize(std::string& error_message) {
 #endif
 	}
 
-	if (!global_synth) {
-		global_synth.reset(create_synth(error_message));
-		if (!global_synth) {
+#ifdef HAVE_THREADS
+	std::lock_guard<std::mutex> lock(synth_pool_mutex);
+#endif
+	if (synth_pool.empty()) {
+		std::unique_ptr<fluid_synth_t, FluidSynthDeleter> synth(create_synth(error_message));
+		if (!synth) {
 			return false;
 		}
+		synth_pool.push_back(std::move(synth));
 	}
 
 	init = true;
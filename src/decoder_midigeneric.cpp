@@ -20,11 +20,51 @@
 
 #include <algorithm>
 #include <memory>
+#ifdef HAVE_THREADS
+#  include <mutex>
+#endif
 #include "decoder_midigeneric.h"
 #include "output.h"
 
 constexpr int GenericMidiDecoder::midi_default_tempo;
 
+namespace {
+	/** A parsed MIDI file, identified by its content */
+	struct ParsedMidi {
+		std::vector<uint8_t> file;
+		std::shared_ptr<const midisequencer::sequence> seq;
+	};
+
+	/** Games switch between a few songs, keep the most recent ones (latest at the back) */
+	constexpr size_t parsed_cache_size = 4;
+	std::vector<ParsedMidi> parsed_cache;
+#ifdef HAVE_THREADS
+	std::mutex parsed_cache_mutex;
+#endif
+
+	std::shared_ptr<const midisequencer::sequence> FindParsed(const std::vector<uint8_t>& file) {
+#ifdef HAVE_THREADS
+		std::lock_guard<std::mutex> lock(parsed_cache_mutex);
+#endif
+		auto it = std::find_if(parsed_cache.begin(), parsed_cache.end(), [&](auto& p) { return p.file == file; });
+		if (it == parsed_cache.end()) {
+			return nullptr;
+		}
+		std::rotate(it, it + 1, parsed_cache.end());
+		return parsed_cache.back().seq;
+	}
+
+	void AddParsed(const std::vector<uint8_t>& file, std::shared_ptr<const midisequencer::sequence> seq) {
+#ifdef HAVE_THREADS
+		std::lock_guard<std::mutex> lock(parsed_cache_mutex);
+#endif
+		if (parsed_cache.size() >= parsed_cache_size) {
+			parsed_cache.erase(parsed_cache.begin());
+		}
+		parsed_cache.push_back({ file, std::move(seq) });
+	}
+}
+
 GenericMidiDecoder::GenericMidiDecoder(MidiDecoder* mididec)
 	: mididec(mididec) {
 	assert(mididec);
@@ -51,9 +91,17 @@ bool GenericMidiDecoder::Open(Filesystem_Stream::InputStream stream) {
 	seq->clear();
 	file_buffer = Utils::ReadStream(stream);
 
-	if (!seq->load(this, read_func)) {
-		error_message = "Midi: Error reading file";
-		return false;
+	// Parsing the event list is the slow part of opening, reuse it when the
+	// same song is played again
+	auto parsed = FindParsed(file_buffer);
+	if (parsed) {
+		seq->set_sequence(std::move(parsed));
+	} else {
+		if (!seq->load(this, read_func)) {
+			error_message = "Midi: Error reading file";
+			return false;
+		}
+		AddParsed(file_buffer, seq->get_sequence());
 	}
 	seq->rewind();
 
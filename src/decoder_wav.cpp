@@ -32,9 +32,9 @@ WavDecoder::WavDecoder()
 WavDecoder::~WavDecoder() {
 }
 
-bool WavDecoder::Open(Filesystem_Stream::InputStream stream) {
+bool WavDecoder::Open(Filesystem_Stream::InputStream is) {
 	decoded_samples = 0;
-	this->stream = std::move(stream);
+	stream = std::move(is);
 	stream.seekg(16, std::ios::ios_base::beg);
 	stream.read(reinterpret_cast<char*>(&chunk_size), sizeof(chunk_size));
 	Utils::SwapByteOrder(chunk_size);
@@ -176,4 +176,14 @@ int WavDecoder::GetTicks() const {
 	return decoded_samples / (samplerate * nchannels);
 }
 
+int WavDecoder::GetRemainingSize() const {
+	if (finished) {
+		return 0;
+	}
+	if (!stream) {
+		return -1;
+	}
+	return static_cast<int>(audiobuf_offset + chunk_size - cur_pos);
+}
+
 #endif
@@ -44,6 +44,8 @@ public:
 
 	int GetTicks() const override;
 
+	int GetRemainingSize() const override;
+
 private:
 	int FillBuffer(uint8_t* buffer, int length) override;
 	Format output_format;
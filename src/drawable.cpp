@@ -23,9 +23,35 @@ Drawable::~Drawable() {
 	DrawableMgr::Remove(this);
 }
 
+Rect Drawable::GetDamage(const Rect& screen_rect) {
+	return screen_rect;
+}
+
+Rect Drawable::GetScreenBounds(const Rect& screen_rect) const {
+	return screen_rect;
+}
+
+void Drawable::OnComposited() {
+}
+
+bool Drawable::PrepareBands() {
+	return false;
+}
+
+void Drawable::DrawBand(Bitmap& dst) {
+	Draw(dst);
+}
+
+bool Drawable::DrawAccelerated(AcceleratedRenderer&) {
+	return false;
+}
+
 void Drawable::SetZ(int nz) {
-	if (_z != nz) DrawableMgr::OnUpdateZ(this);
-	_z = nz;
+	if (_z != nz) {
+		const int old_z = _z;
+		_z = nz;
+		DrawableMgr::OnUpdateZ(this, old_z);
+	}
 }
 
 int Drawable::GetPriorityForMapLayer(int which) {
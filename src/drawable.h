@@ -20,7 +20,9 @@
 
 #include <cstdint>
 #include <memory>
+#include "rect.h"
 
+class AcceleratedRenderer;
 class Bitmap;
 class Drawable;
 
@@ -77,6 +79,56 @@ public:
 
 	virtual void Draw(Bitmap& dst) = 0;
 
+	/**
+	 * Returns the screen area which changed since this drawable was composited
+	 * the last time. Drawables without change tracking report the whole screen.
+	 *
+	 * @param screen_rect the area of the screen
+	 * @return changed area, an empty rect when nothing changed
+	 */
+	virtual Rect GetDamage(const Rect& screen_rect);
+
+	/**
+	 * Returns a conservative approximation of the screen area touched by Draw.
+	 * DrawableList skips drawables whose bounds are outside of the drawn area.
+	 * Drawables without known bounds report the whole screen.
+	 *
+	 * @param screen_rect the area of the screen
+	 * @return area which may be drawn to
+	 */
+	virtual Rect GetScreenBounds(const Rect& screen_rect) const;
+
+	/**
+	 * Called after the drawable was composited to the screen.
+	 * Drawables with change tracking remember the state they were drawn with.
+	 */
+	virtual void OnComposited();
+
+	/**
+	 * Prepares drawing this drawable into several bands of the screen at once.
+	 * Called on the main thread, any lazy updates of the drawable happen here.
+	 *
+	 * @return true when DrawBand may be called concurrently for disjoint bands,
+	 *         false when the drawable must be drawn with Draw on the main thread
+	 */
+	virtual bool PrepareBands();
+
+	/**
+	 * Draws the part of the drawable inside the clip rect of dst.
+	 * Must only read the state set up by PrepareBands.
+	 *
+	 * @param dst view of the screen clipped to one band
+	 */
+	virtual void DrawBand(Bitmap& dst);
+
+	/**
+	 * Draws the drawable with a GPU renderer.
+	 *
+	 * @param renderer the renderer
+	 * @return false when not supported, Draw is called with the software layer of the renderer then
+	 */
+	virtual bool DrawAccelerated(AcceleratedRenderer& renderer);
+
 	int GetZ() const;
 
 	void SetZ(int z);
@@ -18,8 +18,23 @@
 // Headers
 #include "drawable_list.h"
 #include "drawable_mgr.h"
+#include "accelerated_renderer.h"
+#include "job_system.h"
+#include "bitmap.h"
+#include "instrumentation.h"
 #include <algorithm>
 #include <cassert>
+#ifdef HAVE_THREADS
+#  include <functional>
+#  include <utility>
+#endif
+
+namespace {
+	/** @return whether the drawable may touch the area, checked before any drawing work */
+	bool IsInArea(const Drawable& drawable, const Rect& area) {
+		return !drawable.GetScreenBounds(area).IsOutOfBounds(area);
+	}
+}
 
 static bool DrawCmp(Drawable* l, Drawable* r) {
 	return l->GetZ() < r->GetZ();
@@ -34,6 +49,7 @@ DrawableList::~DrawableList() {
 void DrawableList::Clear() {
 	_list.clear();
 	SetClean();
+	_changed = true;
 }
 
 bool DrawableList::IsSorted() const {
@@ -47,6 +63,34 @@ void DrawableList::Sort() {
 	SetClean();
 }
 
+void DrawableList::OnUpdateZ(Drawable* ptr, int old_z) {
+	if (_dirty || _drawing) {
+		SetDirty();
+		return;
+	}
+
+	// Except for ptr the list is sorted, ptr is found among the drawables with old_z
+	auto z_of = [&](const Drawable* d) { return d == ptr ? old_z : d->GetZ(); };
+	auto first = std::partition_point(_list.begin(), _list.end(), [&](const Drawable* d) { return z_of(d) < old_z; });
+	auto last = std::partition_point(first, _list.end(), [&](const Drawable* d) { return z_of(d) <= old_z; });
+	auto iter = std::find(first, last, ptr);
+	if (iter == last) {
+		SetDirty();
+		return;
+	}
+
+	// Same position as with a stable sort: before equal z when moving up, behind equal z when moving down
+	const int z = ptr->GetZ();
+	if (z > old_z) {
+		auto target = std::partition_point(iter + 1, _list.end(), [&](const Drawable* d) { return d->GetZ() < z; });
+		std::rotate(iter, iter + 1, target);
+	} else {
+		auto target = std::partition_point(_list.begin(), iter, [&](const Drawable* d) { return d->GetZ() <= z; });
+		std::rotate(target, iter, iter + 1);
+	}
+	_changed = true;
+}
+
 void DrawableList::Append(Drawable* ptr) {
 	assert(ptr != nullptr);
 	assert(_list.end() == std::find(_list.begin(), _list.end(), ptr));
@@ -54,6 +98,7 @@ void DrawableList::Append(Drawable* ptr) {
 	const bool ordered = _list.empty() || !DrawCmp(ptr, _list.back());
 
 	_list.push_back(ptr);
+	_changed = true;
 
 	if (!ordered) {
 		SetDirty();
@@ -69,6 +114,8 @@ Drawable* DrawableList::Take(Drawable* ptr) {
 	auto ret = *iter;
 	// FIXME: Can we remove this O(N) operation here?
 	_list.erase(iter);
+	// The area of the removed drawable must be recomposited
+	_changed = true;
 	return ret;
 
 	// Removing doesn't change sorted order, so not dirty flag.
@@ -88,15 +135,20 @@ void DrawableList::TakeFrom(DrawableList& other) noexcept {
 
 	SetDirty();
 	other.SetClean();
+	other._changed = true;
 }
 
 void DrawableList::Draw(Bitmap& dst, int min_z, int max_z) {
+	INSTRUMENTATION_SCOPE("DrawableList::Draw");
+
 	if (IsDirty()) {
 		Sort();
 	} else {
 		assert(IsSorted());
 	}
 
+	const Rect area = dst.GetClipRect();
+	_drawing = true;
 	for (auto* drawable : _list) {
 		auto z = drawable->GetZ();
 		if (z < min_z) {
@@ -105,9 +157,150 @@ void DrawableList::Draw(Bitmap& dst, int min_z, int max_z) {
 		if (z > max_z) {
 			break;
 		}
-		if (drawable->IsVisible()) {
+		if (drawable->IsVisible() && IsInArea(*drawable, area)) {
+			drawable->Draw(dst);
+		}
+	}
+	_drawing = false;
+}
+
+void DrawableList::DrawBanded(Bitmap& dst, int min_z, int max_z, int bands) {
+	INSTRUMENTATION_SCOPE("DrawableList::DrawBanded");
+
+#ifdef HAVE_THREADS
+	const Rect area = dst.GetClipRect();
+	bands = std::min(bands, area.height);
+	if (bands <= 1) {
+		Draw(dst, min_z, max_z);
+		return;
+	}
+
+	if (IsDirty()) {
+		Sort();
+	} else {
+		assert(IsSorted());
+	}
+
+	_drawing = true;
+	std::vector<BitmapRef> views;
+	views.reserve(bands);
+	for (int i = 0; i < bands; ++i) {
+		const int top = area.y + area.height * i / bands;
+		const int bottom = area.y + area.height * (i + 1) / bands;
+		views.push_back(Bitmap::CreateView(dst));
+		views.back()->SetClipRect(Rect(area.x, top, area.width, bottom - top));
+	}
+
+	// Consecutive drawables supporting bands are drawn together, each band keeps the z order
+	// Bounds are queried on the main thread, the bands only test them
+	std::vector<std::pair<Drawable*, Rect>> run;
+	const std::function<void(int)> draw_run = [&](int band) {
+		const Rect band_rect = views[band]->GetClipRect();
+		for (auto& entry : run) {
+			if (!entry.second.IsOutOfBounds(band_rect)) {
+				entry.first->DrawBand(*views[band]);
+			}
+		}
+	};
+	auto flush = [&]() {
+		if (!run.empty()) {
+			JobSystem::ParallelFor(bands, draw_run);
+			run.clear();
+		}
+	};
+
+	for (auto* drawable : _list) {
+		auto z = drawable->GetZ();
+		if (z < min_z) {
+			continue;
+		}
+		if (z > max_z) {
+			break;
+		}
+		if (!drawable->IsVisible()) {
+			continue;
+		}
+		const Rect bounds = drawable->GetScreenBounds(area);
+		if (bounds.IsOutOfBounds(area)) {
+			continue;
+		}
+		if (drawable->PrepareBands()) {
+			run.emplace_back(drawable, bounds);
+		} else {
+			flush();
 			drawable->Draw(dst);
 		}
 	}
+	flush();
+	_drawing = false;
+#else
+	(void)bands;
+	Draw(dst, min_z, max_z);
+#endif
+}
+
+void DrawableList::DrawAccelerated(AcceleratedRenderer& renderer, int min_z, int max_z) {
+	INSTRUMENTATION_SCOPE("DrawableList::DrawAccelerated");
+
+	if (IsDirty()) {
+		Sort();
+	} else {
+		assert(IsSorted());
+	}
+
+	const Rect area = renderer.GetScreenRect();
+	_drawing = true;
+	for (auto* drawable : _list) {
+		auto z = drawable->GetZ();
+		if (z < min_z) {
+			continue;
+		}
+		if (z > max_z) {
+			break;
+		}
+		if (!drawable->IsVisible() || !IsInArea(*drawable, area)) {
+			continue;
+		}
+		if (!drawable->DrawAccelerated(renderer)) {
+			drawable->Draw(renderer.GetLayer());
+		}
+	}
+	_drawing = false;
 }
 
+Rect DrawableList::GetDamage(const Rect& screen_rect, int min_z, int max_z) {
+	if (_changed) {
+		return screen_rect;
+	}
+
+	Rect damage;
+	for (auto* drawable : _list) {
+		auto z = drawable->GetZ();
+		if (z < min_z) {
+			continue;
+		}
+		if (z > max_z) {
+			break;
+		}
+		damage = damage.GetUnion(drawable->GetDamage(screen_rect));
+		if (damage == screen_rect) {
+			break;
+		}
+	}
+	damage.Adjust(screen_rect);
+	return damage;
+}
+
+void DrawableList::OnComposited(int min_z, int max_z) {
+	for (auto* drawable : _list) {
+		auto z = drawable->GetZ();
+		if (z < min_z) {
+			continue;
+		}
+		if (z > max_z) {
+			break;
+		}
+		drawable->OnComposited();
+	}
+	_changed = false;
+}
@@ -89,6 +89,16 @@ class DrawableList {
 		/** @return true if the list is dirty and needs to be sorted */
 		bool IsDirty() const;
 
+		/**
+		 * Moves a drawable whose z changed to its sorted position.
+		 * The result equals a full Sort(), when the drawable is not part
+		 * of the list or the list is dirty it is only marked as dirty.
+		 *
+		 * @param drawable the Drawable which changed, GetZ() returns the new z
+		 * @param old_z z of the drawable before the change
+		 */
+		void OnUpdateZ(Drawable* drawable, int old_z);
+
 		/** Mark the list as dirty. It will be sorted the next time Draw() is called */
 		void SetDirty();
 
@@ -124,6 +134,7 @@ class DrawableList {
 
 		/**
 		 * Sort the list if it's dirty, then call Draw() on every drawable in order.
+		 * Drawables whose screen bounds are outside of the clip rect of dst are skipped.
 		 *
 		 * @param dst The bitmap to draw onto
 		 * @param min_z Skip any drawables with z < min_z
@@ -131,9 +142,55 @@ class DrawableList {
 		 */
 		void Draw(Bitmap& dst, int min_z, int max_z);
 
+		/**
+		 * Like Draw() but splits the clip rect of dst into horizontal bands and
+		 * draws the bands on worker threads. Drawables which do not support
+		 * banded drawing are drawn on the calling thread in between.
+		 * The result is identical to Draw().
+		 *
+		 * @param dst The bitmap to draw onto
+		 * @param min_z Skip any drawables with z < min_z
+		 * @param max_z Skip any drawables with z > max_z
+		 * @param bands Number of bands, 1 or less draws without threads
+		 */
+		void DrawBanded(Bitmap& dst, int min_z, int max_z, int bands);
+
+		/**
+		 * Sort the list if it's dirty, then draw every drawable in order with a GPU renderer.
+		 * Drawables without GPU support are drawn into the software layer of the renderer.
+		 *
+		 * @param renderer The renderer to draw with
+		 * @param min_z Skip any drawables with z < min_z
+		 * @param max_z Skip any drawables with z > max_z
+		 */
+		void DrawAccelerated(AcceleratedRenderer& renderer, int min_z, int max_z);
+
+		/**
+		 * Collects the screen area changed by the drawables since the last call to OnComposited().
+		 * Adding, removing or reordering drawables damages the whole screen.
+		 *
+		 * @param screen_rect The area of the screen
+		 * @param min_z Skip any drawables with z < min_z
+		 * @param max_z Skip any drawables with z > max_z
+		 * @return the union of all changed areas, an empty rect when nothing changed
+		 */
+		Rect GetDamage(const Rect& screen_rect, int min_z, int max_z);
+
+		/**
+		 * Notifies the drawables that they were composited to the screen
+		 * and resets the change tracking of the list.
+		 *
+		 * @param min_z Skip any drawables with z < min_z
+		 * @param max_z Skip any drawables with z > max_z
+		 */
+		void OnComposited(int min_z, int max_z);
+
 	private:
 		std::vector<Drawable*> _list;
 		bool _dirty = false;
+		bool _changed = true;
+		/** Set while drawing, the list must not be reordered then */
+		bool _drawing = false;
 
 		void SetClean();
 };
@@ -170,6 +227,7 @@ void DrawableList::TakeFrom(DrawableList& other, F&& cond) noexcept {
 	olist.resize(olist.size() - shift);
 
 	SetDirty();
+	other._changed = true;
 	if (olist.empty()) {
 		other.SetClean();
 	}
@@ -181,6 +239,7 @@ inline bool DrawableList::IsDirty() const {
 
 inline void DrawableList::SetDirty() {
 	_dirty = true;
+	_changed = true;
 }
 
 inline void DrawableList::SetClean() {
@@ -31,7 +31,7 @@ struct DrawableMgr {
 
 		static void Register(Drawable* drawable);
 		static void Remove(Drawable* drawable);
-		static void OnUpdateZ(Drawable* drawable);
+		static void OnUpdateZ(Drawable* drawable, int old_z);
 	private:
 		static DrawableList* _local;
 };
@@ -47,8 +47,8 @@ inline DrawableList* DrawableMgr::GetLocalListPtr() {
 	return _local;
 }
 
-inline void DrawableMgr::OnUpdateZ(Drawable* /* drawable */) {
-	GetLocalList().SetDirty();
+inline void DrawableMgr::OnUpdateZ(Drawable* drawable, int old_z) {
+	GetLocalList().OnUpdateZ(drawable, old_z);
 }
 
 #endif
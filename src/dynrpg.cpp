@@ -29,6 +29,7 @@
 #include <cstring>
 #include <fstream>
 #include <map>
+#include <unordered_map>
 
 enum DynRpg_ParseMode {
 	ParseMode_Function,
@@ -48,6 +49,31 @@ namespace {
 
 	// DynRpg Function table
 	dyn_rpg_func dyn_rpg_functions;
+
+	/** Argument of a parsed command */
+	struct CommandArg {
+		/** Value of a literal, the token of a reference */
+		std::string text;
+		/** N and V of a reference like NVV3, empty for literals */
+		std::string reference;
+		/** Number of a reference */
+		int number = 0;
+	};
+
+	/** A command comment parsed once, only references are resolved on every call */
+	struct ParsedCommand {
+		/** Lowercase function name, empty when not a valid command */
+		std::string function_name;
+		/** Function of the name, set on the first call */
+		dynfunc function = nullptr;
+		std::vector<CommandArg> args;
+		/** Arguments passed to the function, the capacity is reused between calls */
+		std::vector<std::string> values;
+	};
+
+	/** Commands by comment text, the same comments run every frame in parallel events */
+	std::unordered_map<std::string, ParsedCommand> command_cache;
+	constexpr size_t command_cache_limit = 1024;
 }
 
 void DynRpg::RegisterFunction(const std::string& name, dynfunc func) {
@@ -112,11 +138,10 @@ std::string DynRpg::ParseVarArg(StringView func_name, dyn_arg_list args, int ind
 }
 
 
-static std::string ParseToken(const std::string& token, const std::string& function_name) {
-	std::string::iterator text_index, end;
-	std::string text = token;
-	text_index = text.begin();
-	end = text.end();
+static CommandArg ClassifyToken(const std::string& token) {
+	std::string::const_iterator text_index, end;
+	text_index = token.begin();
+	end = token.end();
 
 	char chr = *text_index;
 
@@ -127,6 +152,8 @@ static std::string ParseToken(const std::string& token, const std::string& funct
 	std::stringstream var_part;
 	std::stringstream number_part;
 
+	CommandArg arg;
+
 	for (;;) {
 		if (text_index != end) {
 			chr = *text_index;
@@ -134,32 +161,13 @@ static std::string ParseToken(const std::string& token, const std::string& funct
 
 		if (text_index == end) {
 			// Variable reference
-			std::string tmp = number_part.str();
-			int number = atoi(tmp.c_str());
-			tmp = var_part.str();
-			if (tmp.empty()) {
-				return token;
-			}
-
-			// Convert backwards
-			for (std::string::reverse_iterator it = tmp.rbegin(); it != tmp.rend(); ++it) {
-				if (*it == 'N') {
-					if (!Main_Data::game_actors->ActorExists(number)) {
-						Output::Warning("{}: Invalid actor id {} in {}", function_name, number, token);
-						return "";
-					}
-
-					// N is last
-					return ToString(Main_Data::game_actors->GetActor(number)->GetName());
-				} else {
-					// Variable
-					number = Main_Data::game_variables->Get(number);
-				}
+			arg.text = token;
+			arg.reference = var_part.str();
+			if (!arg.reference.empty()) {
+				std::string tmp = number_part.str();
+				arg.number = atoi(tmp.c_str());
 			}
-
-			number_part.str("");
-			number_part << number;
-			return number_part.str();
+			return arg;
 		} else if (number_encountered || (chr >= '0' && chr <= '9')) {
 			number_encountered = true;
 			number_part << chr;
@@ -179,7 +187,37 @@ static std::string ParseToken(const std::string& token, const std::string& funct
 	}
 
 	// Normal token
-	return Utils::LowerCase(token);
+	arg.text = Utils::LowerCase(token);
+	return arg;
+}
+
+static void ResolveArg(const CommandArg& arg, const std::string& function_name, std::string& value) {
+	if (arg.reference.empty()) {
+		value = arg.text;
+		return;
+	}
+
+	int number = arg.number;
+
+	// Convert backwards
+	for (auto it = arg.reference.rbegin(); it != arg.reference.rend(); ++it) {
+		if (*it == 'N') {
+			if (!Main_Data::game_actors->ActorExists(number)) {
+				Output::Warning("{}: Invalid actor id {} in {}", function_name, number, arg.text);
+				value.clear();
+				return;
+			}
+
+			// N is last
+			value = ToString(Main_Data::game_actors->GetActor(number)->GetName());
+			return;
+		} else {
+			// Variable
+			number = Main_Data::game_variables->Get(number);
+		}
+	}
+
+	value = std::to_string(number);
 }
 
 void create_all_plugins() {
@@ -192,16 +230,15 @@ void create_all_plugins() {
 	init = true;
 }
 
-std::string DynRpg::ParseCommand(const std::string& command, std::vector<std::string>& args) {
+static std::string ParseCommandArgs(const std::string& command, std::vector<CommandArg>& args) {
 	if (command.empty()) {
 		// Not a DynRPG function (empty comment)
 		return "";
 	}
 
-	std::string::iterator text_index, end;
-	std::string text = command;
-	text_index = text.begin();
-	end = text.end();
+	std::string::const_iterator text_index, end;
+	text_index = command.begin();
+	end = command.end();
 
 	char chr = *text_index;
 
@@ -212,9 +249,14 @@ std::string DynRpg::ParseCommand(const std::string& command, std::vector<std::st
 
 	DynRpg_ParseMode mode = ParseMode_Function;
 	std::string function_name;
-	std::string tmp;
 	std::stringstream token;
 
+	auto add_literal = [&args](std::string value) {
+		CommandArg arg;
+		arg.text = std::move(value);
+		args.push_back(std::move(arg));
+	};
+
 	++text_index;
 
 	// Parameters can be of type Token, Number or String
@@ -225,6 +267,7 @@ std::string DynRpg::ParseCommand(const std::string& command, std::vector<std::st
 
 	// All arguments are passed as string to the DynRpg functions and are
 	// converted to int or float on demand.
+	// References are resolved by ResolveArg when the function is invoked.
 
 	for (;;) {
 		if (text_index != end) {
@@ -248,16 +291,15 @@ std::string DynRpg::ParseCommand(const std::string& command, std::vector<std::st
 				case ParseMode_WaitForArg:
 					if (!args.empty()) {
 						// Found , but no token -> empty arg
-						args.emplace_back("");
+						add_literal("");
 					}
 					break;
 				case ParseMode_String:
 					// Unterminated literal, handled like a terminated literal
-					args.emplace_back(token.str());
+					add_literal(token.str());
 					break;
 				case ParseMode_Token:
-					tmp = ParseToken(token.str(), function_name);
-					args.emplace_back(tmp);
+					args.push_back(ClassifyToken(token.str()));
 					break;
 			}
 
@@ -299,7 +341,7 @@ std::string DynRpg::ParseCommand(const std::string& command, std::vector<std::st
 					}
 					token.str("");
 					// Empty arg
-					args.emplace_back("");
+					add_literal("");
 					mode = ParseMode_WaitForArg;
 					break;
 				case ParseMode_WaitForComma:
@@ -307,14 +349,13 @@ std::string DynRpg::ParseCommand(const std::string& command, std::vector<std::st
 					break;
 				case ParseMode_WaitForArg:
 					// Empty arg
-					args.emplace_back("");
+					add_literal("");
 					break;
 				case ParseMode_String:
 					token << chr;
 					break;
 				case ParseMode_Token:
-					tmp = ParseToken(token.str(), function_name);
-					args.emplace_back(tmp);
+					args.push_back(ClassifyToken(token.str()));
 					// already on a comma
 					mode = ParseMode_WaitForArg;
 					token.str("");
@@ -349,7 +390,7 @@ std::string DynRpg::ParseCommand(const std::string& command, std::vector<std::st
 						}
 						else {
 							// End of string
-							args.emplace_back(token.str());
+							add_literal(token.str());
 
 							mode = ParseMode_WaitForComma;
 							token.str("");
@@ -371,19 +412,57 @@ std::string DynRpg::ParseCommand(const std::string& command, std::vector<std::st
 	return function_name;
 }
 
+std::string DynRpg::ParseCommand(const std::string& command, std::vector<std::string>& args) {
+	std::vector<CommandArg> parsed;
+	std::string function_name = ParseCommandArgs(command, parsed);
+	if (function_name.empty()) {
+		return "";
+	}
+
+	for (const auto& arg : parsed) {
+		args.emplace_back();
+		ResolveArg(arg, function_name, args.back());
+	}
+	return function_name;
+}
+
 bool DynRpg::Invoke(const std::string& command) {
 	if (!init) {
 		create_all_plugins();
 	}
 
-	std::vector<std::string> args;
-	std::string function_name = ParseCommand(command, args);
+	auto it = command_cache.find(command);
+	if (it == command_cache.end()) {
+		if (command_cache.size() >= command_cache_limit) {
+			command_cache.clear();
+		}
+
+		ParsedCommand parsed;
+		parsed.function_name = ParseCommandArgs(command, parsed.args);
+		parsed.values.resize(parsed.args.size());
+		it = command_cache.emplace(command, std::move(parsed)).first;
+	}
 
-	if (function_name.empty()) {
+	auto& parsed = it->second;
+	if (parsed.function_name.empty()) {
 		return true;
 	}
 
-	return Invoke(function_name, args);
+	if (!parsed.function) {
+		auto func = dyn_rpg_functions.find(parsed.function_name);
+		if (func == dyn_rpg_functions.end()) {
+			// Not a supported function
+			Output::Warning("Unsupported DynRPG function: {}", parsed.function_name);
+			return true;
+		}
+		parsed.function = func->second;
+	}
+
+	for (size_t i = 0; i < parsed.args.size(); ++i) {
+		ResolveArg(parsed.args[i], parsed.function_name, parsed.values[i]);
+	}
+
+	return parsed.function(parsed.values);
 }
 
 bool DynRpg::Invoke(const std::string& func, dyn_arg_list args) {
@@ -535,4 +614,5 @@ void DynRpg::Reset() {
 	init = false;
 	dyn_rpg_functions.clear();
 	plugins.clear();
+	command_cache.clear();
 }
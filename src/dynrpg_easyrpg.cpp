@@ -20,6 +20,8 @@
 
 #include "dynrpg_easyrpg.h"
 #include "main_data.h"
+#include "game_character.h"
+#include "game_map.h"
 #include "game_variables.h"
 #include "utils.h"
 #include "version.h"
@@ -87,10 +89,61 @@ static bool EasyAdd(dyn_arg_list args) {
 	return true;
 }
 
+static bool EasyPathDirection(dyn_arg_list args) {
+	auto func = "easyrpg_path_direction";
+	bool okay = false;
+
+	int target_var;
+	int character_id;
+	int x;
+	int y;
+	std::tie(target_var, character_id, x, y) = DynRpg::ParseArgs<int, int, int, int>(func, args, &okay);
+	if (!okay)
+		return true;
+
+	auto* ch = Game_Character::GetCharacter(character_id, 0);
+	if (!ch) {
+		Output::Warning("{}: Invalid character {}", func, character_id);
+		return true;
+	}
+
+	Main_Data::game_variables->Set(target_var, Game_Map::GetPathDirection(ch->GetX(), ch->GetY(), x, y));
+
+	return true;
+}
+
+static bool EasyPathStep(dyn_arg_list args) {
+	auto func = "easyrpg_path_step";
+	bool okay = false;
+
+	int character_id;
+	int x;
+	int y;
+	std::tie(character_id, x, y) = DynRpg::ParseArgs<int, int, int>(func, args, &okay);
+	if (!okay)
+		return true;
+
+	auto* ch = Game_Character::GetCharacter(character_id, 0);
+	if (!ch) {
+		Output::Warning("{}: Invalid character {}", func, character_id);
+		return true;
+	}
+
+	// Like a move route step, a character still moving finishes its step first
+	const int dir = Game_Map::GetPathDirection(ch->GetX(), ch->GetY(), x, y);
+	if (dir >= 0 && ch->IsStopping()) {
+		ch->Move(dir);
+	}
+
+	return true;
+}
+
 void DynRpg::EasyRpgPlugin::RegisterFunctions() {
 	DynRpg::RegisterFunction("call", EasyCall);
 	DynRpg::RegisterFunction("easyrpg_output", EasyOput);
 	DynRpg::RegisterFunction("easyrpg_add", EasyAdd);
+	DynRpg::RegisterFunction("easyrpg_path_direction", EasyPathDirection);
+	DynRpg::RegisterFunction("easyrpg_path_step", EasyPathStep);
 }
 
 void DynRpg::EasyRpgPlugin::Load(const std::vector<uint8_t>& buffer) {
@@ -0,0 +1,98 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include "event_grid.h"
+
+void EventGrid::Reset(int width, int height, int num_events) {
+	this->width = width;
+	this->height = height;
+	head.assign(width * height + 1, -1);
+	next.assign(num_events, -1);
+	tile.assign(num_events, -1);
+	pos_x.assign(num_events, 0);
+	pos_y.assign(num_events, 0);
+}
+
+void EventGrid::Clear() {
+	Reset(0, 0, 0);
+}
+
+int EventGrid::GetTile(int x, int y) const {
+	if (x < 0 || x >= width || y < 0 || y >= height) {
+		return width * height;
+	}
+	return x + y * width;
+}
+
+void EventGrid::Unlink(int idx) {
+	int* link = &head[tile[idx]];
+	while (*link != idx) {
+		link = &next[*link];
+	}
+	*link = next[idx];
+	tile[idx] = -1;
+}
+
+void EventGrid::Move(int idx, int x, int y) {
+	if (idx < 0 || idx >= static_cast<int>(tile.size())) {
+		return;
+	}
+
+	const int new_tile = GetTile(x, y);
+	pos_x[idx] = x;
+	pos_y[idx] = y;
+	if (tile[idx] == new_tile) {
+		return;
+	}
+	if (tile[idx] >= 0) {
+		Unlink(idx);
+	}
+
+	// Lists are unsorted, tiles rarely hold more than a few events
+	next[idx] = head[new_tile];
+	head[new_tile] = idx;
+	tile[idx] = new_tile;
+}
+
+int EventGrid::GetNext(int x, int y, int after) const {
+	if (head.empty()) {
+		return -1;
+	}
+
+	int result = -1;
+	for (int idx = head[GetTile(x, y)]; idx >= 0; idx = next[idx]) {
+		if (idx > after && (result < 0 || idx < result) && pos_x[idx] == x && pos_y[idx] == y) {
+			result = idx;
+		}
+	}
+	return result;
+}
+
+int EventGrid::GetPrev(int x, int y, int before) const {
+	if (head.empty()) {
+		return -1;
+	}
+
+	int result = -1;
+	for (int idx = head[GetTile(x, y)]; idx >= 0; idx = next[idx]) {
+		if ((before < 0 || idx < before) && idx > result && pos_x[idx] == x && pos_y[idx] == y) {
+			result = idx;
+		}
+	}
+	return result;
+}
@@ -0,0 +1,86 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_EVENT_GRID_H
+#define EP_EVENT_GRID_H
+
+// Headers
+#include <vector>
+
+/**
+ * Index from map tiles to the events standing on them.
+ * Every tile has an intrusive list of event indices. Positions outside of
+ * the map, which are not wrapped on looping maps, share one extra list and
+ * are compared exactly, so a query finds the same events as comparing the
+ * position of every event.
+ */
+class EventGrid {
+public:
+	/**
+	 * Removes all events and sizes the grid for a map.
+	 *
+	 * @param width map width
+	 * @param height map height
+	 * @param num_events number of events, indices are 0 to num_events - 1
+	 */
+	void Reset(int width, int height, int num_events);
+
+	/** Removes all events, later moves are ignored until the next Reset */
+	void Clear();
+
+	/**
+	 * Sets the position of an event. Indices outside of the grid are ignored.
+	 *
+	 * @param idx event index
+	 * @param x new x position
+	 * @param y new y position
+	 */
+	void Move(int idx, int x, int y);
+
+	/**
+	 * @param x x position
+	 * @param y y position
+	 * @param after event index to continue after, -1 to start at the lowest index
+	 * @return lowest event index above after at the position or -1
+	 */
+	int GetNext(int x, int y, int after) const;
+
+	/**
+	 * @param x x position
+	 * @param y y position
+	 * @param before event index to continue before, -1 to start at the highest index
+	 * @return highest event index below before at the position or -1
+	 */
+	int GetPrev(int x, int y, int before) const;
+
+private:
+	int GetTile(int x, int y) const;
+	void Unlink(int idx);
+
+	int width = 0;
+	int height = 0;
+	/** First event of every tile, the last entry holds the events outside of the map */
+	std::vector<int> head;
+	/** Next event in the list of the tile */
+	std::vector<int> next;
+	/** Tile and position of every event */
+	std::vector<int> tile;
+	std::vector<int> pos_x;
+	std::vector<int> pos_y;
+};
+
+#endif
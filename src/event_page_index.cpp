@@ -0,0 +1,83 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include "event_page_index.h"
+#include <algorithm>
+
+void EventPageIndex::Build(const std::vector<lcf::rpg::Event>& events) {
+	std::vector<std::pair<int, int>> switch_events;
+	std::vector<std::pair<int, int>> variable_events;
+	other_events.clear();
+
+	for (size_t i = 0; i < events.size(); ++i) {
+		const int idx = static_cast<int>(i);
+		bool other = false;
+		for (const auto& page: events[i].pages) {
+			const auto& cond = page.condition;
+			if (cond.flags.switch_a) {
+				switch_events.emplace_back(cond.switch_a_id, idx);
+			}
+			if (cond.flags.switch_b) {
+				switch_events.emplace_back(cond.switch_b_id, idx);
+			}
+			if (cond.flags.variable) {
+				variable_events.emplace_back(cond.variable_id, idx);
+			}
+			other |= cond.flags.item || cond.flags.actor || cond.flags.timer || cond.flags.timer2;
+		}
+		if (other) {
+			other_events.push_back(idx);
+		}
+	}
+
+	switches.Build(switch_events);
+	variables.Build(variable_events);
+}
+
+void EventPageIndex::Clear() {
+	switches = {};
+	variables = {};
+	other_events.clear();
+}
+
+void EventPageIndex::Table::Build(std::vector<std::pair<int, int>>& id_events) {
+	// Ids below 1 can't be written, they don't need an entry
+	id_events.erase(std::remove_if(id_events.begin(), id_events.end(),
+			[](const std::pair<int, int>& e) { return e.first <= 0; }), id_events.end());
+	std::sort(id_events.begin(), id_events.end());
+	id_events.erase(std::unique(id_events.begin(), id_events.end()), id_events.end());
+
+	const int max_id = id_events.empty() ? 0 : id_events.back().first;
+	offsets.assign(max_id + 2, 0);
+	events.clear();
+	events.reserve(id_events.size());
+	for (const auto& e: id_events) {
+		++offsets[e.first + 1];
+		events.push_back(e.second);
+	}
+	for (size_t i = 1; i < offsets.size(); ++i) {
+		offsets[i] += offsets[i - 1];
+	}
+}
+
+void EventPageIndex::Table::Collect(int id, std::vector<int>& out) const {
+	if (id <= 0 || id + 1 >= static_cast<int>(offsets.size())) {
+		return;
+	}
+	out.insert(out.end(), events.begin() + offsets[id], events.begin() + offsets[id + 1]);
+}
@@ -0,0 +1,86 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_EVENT_PAGE_INDEX_H
+#define EP_EVENT_PAGE_INDEX_H
+
+// Headers
+#include <vector>
+#include <lcf/rpg/event.h>
+
+/**
+ * Reverse index from the state referenced by event page conditions to the
+ * events of a map. After a change only the events using the changed state
+ * need a page refresh.
+ * Switches and variables are indexed by id. Items, actors and timers are
+ * not logged by id, the events using them are kept in plain lists.
+ */
+class EventPageIndex {
+public:
+	/**
+	 * Indexes the page conditions of map events.
+	 *
+	 * @param events events of the map, the indices refer to this list
+	 */
+	void Build(const std::vector<lcf::rpg::Event>& events);
+
+	/** Removes all events from the index */
+	void Clear();
+
+	/**
+	 * @param switch_id switch id
+	 * @param out receives the indices of the events using the switch
+	 */
+	void CollectSwitch(int switch_id, std::vector<int>& out) const;
+
+	/**
+	 * @param var_id variable id
+	 * @param out receives the indices of the events using the variable
+	 */
+	void CollectVariable(int var_id, std::vector<int>& out) const;
+
+	/** @return indices of the events with item, actor or timer conditions */
+	const std::vector<int>& GetOtherEvents() const;
+
+private:
+	/** Events using an id, the events of id are events[offsets[id]] to events[offsets[id + 1]] */
+	struct Table {
+		std::vector<int> offsets;
+		std::vector<int> events;
+
+		void Build(std::vector<std::pair<int, int>>& id_events);
+		void Collect(int id, std::vector<int>& out) const;
+	};
+
+	Table switches;
+	Table variables;
+	std::vector<int> other_events;
+};
+
+inline void EventPageIndex::CollectSwitch(int switch_id, std::vector<int>& out) const {
+	switches.Collect(switch_id, out);
+}
+
+inline void EventPageIndex::CollectVariable(int var_id, std::vector<int>& out) const {
+	variables.Collect(var_id, out);
+}
+
+inline const std::vector<int>& EventPageIndex::GetOtherEvents() const {
+	return other_events;
+}
+
+#endif
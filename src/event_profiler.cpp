@@ -0,0 +1,131 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include "event_profiler.h"
+#include "output.h"
+#include <algorithm>
+#include <map>
+#include <tuple>
+
+namespace {
+	using Key = std::tuple<EventProfiler::Type, int, int>;
+
+	bool enabled = false;
+	/** Entries of the running window */
+	std::map<Key, EventProfiler::Entry> current;
+	Game_Clock::time_point window_start;
+	/** Entries of the last complete window, sorted */
+	std::vector<EventProfiler::Entry> last;
+	Game_Clock::duration last_duration = {};
+
+	/** Ends the running window when it is old enough */
+	void Rollover(Game_Clock::time_point now) {
+		if (now - window_start < EventProfiler::window) {
+			return;
+		}
+
+		last.clear();
+		for (const auto& entry : current) {
+			last.push_back(entry.second);
+		}
+		std::sort(last.begin(), last.end(), [](const EventProfiler::Entry& l, const EventProfiler::Entry& r) {
+			return l.time > r.time;
+		});
+		last_duration = now - window_start;
+
+		current.clear();
+		window_start = now;
+	}
+
+	const char* GetTypeName(EventProfiler::Type type) {
+		switch (type) {
+			case EventProfiler::Type::MapEvent:
+				return "map";
+			case EventProfiler::Type::CommonEvent:
+				return "common";
+			case EventProfiler::Type::BattleEvent:
+				return "battle";
+			default:
+				return "other";
+		}
+	}
+}
+
+bool EventProfiler::IsEnabled() {
+	return enabled;
+}
+
+void EventProfiler::SetEnabled(bool value) {
+	enabled = value;
+	current.clear();
+	last.clear();
+	last_duration = {};
+	window_start = Game_Clock::now();
+}
+
+void EventProfiler::Add(const Source& source, int64_t commands, Game_Clock::duration dt) {
+	if (!enabled) {
+		return;
+	}
+
+	auto& entry = current[Key(source.type, source.id, source.page)];
+	entry.source = source;
+	entry.commands += commands;
+	entry.time += dt;
+
+	Rollover(Game_Clock::now());
+}
+
+const std::vector<EventProfiler::Entry>& EventProfiler::GetEntries() {
+	return last;
+}
+
+Game_Clock::duration EventProfiler::GetWindowDuration() {
+	return last_duration;
+}
+
+std::string EventProfiler::GetName(const Source& source) {
+	switch (source.type) {
+		case Type::MapEvent:
+			return fmt::format("M{}/{}", source.id, source.page);
+		case Type::CommonEvent:
+			return fmt::format("C{}", source.id);
+		case Type::BattleEvent:
+			return fmt::format("B{}/{}", source.id, source.page);
+		default:
+			return fmt::format("?{}", source.id);
+	}
+}
+
+void EventProfiler::WriteCsv(std::ostream& os) {
+	os << "type,id,page,commands,microseconds,window_microseconds\n";
+	const auto window_us = std::chrono::duration_cast<std::chrono::microseconds>(last_duration).count();
+	for (const auto& entry : last) {
+		os << GetTypeName(entry.source.type) << ',' << entry.source.id << ',' << entry.source.page << ','
+			<< entry.commands << ',' << std::chrono::duration_cast<std::chrono::microseconds>(entry.time).count() << ','
+			<< window_us << '\n';
+	}
+}
+
+void EventProfiler::Log() {
+	const double window_s = std::chrono::duration<double>(last_duration).count();
+	for (const auto& entry : last) {
+		Output::Debug("Event {}: {} commands, {:.2f} ms in {:.2f} s", GetName(entry.source), entry.commands,
+			std::chrono::duration<double, std::milli>(entry.time).count(), window_s);
+	}
+}
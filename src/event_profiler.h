@@ -0,0 +1,103 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_EVENT_PROFILER_H
+#define EP_EVENT_PROFILER_H
+
+// Headers
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "game_clock.h"
+
+/**
+ * Commands executed and time spent by the interpreters per event page,
+ * shown in Scene_Debug. The time of a command belongs to the frame executing
+ * it, a called event is accounted to itself and not to its caller.
+ * Nothing is measured while disabled.
+ */
+namespace EventProfiler {
+	enum class Type {
+		/** Event of unknown origin, e.g. from a savegame */
+		Other,
+		MapEvent,
+		CommonEvent,
+		BattleEvent
+	};
+
+	/** Event an interpreter frame executes */
+	struct Source {
+		Type type = Type::Other;
+		/** Map event, common event or troop ID */
+		int id = 0;
+		/** Page ID, 0 for common events */
+		int page = 0;
+	};
+
+	struct Entry {
+		Source source;
+		int64_t commands = 0;
+		Game_Clock::duration time = {};
+	};
+
+	/** Length of a measuring window */
+	constexpr auto window = std::chrono::seconds(1);
+
+	/** @return whether the interpreters are measured */
+	bool IsEnabled();
+
+	/**
+	 * Enables measuring, the collected entries are dropped.
+	 *
+	 * @param enabled whether to measure
+	 */
+	void SetEnabled(bool enabled);
+
+	/**
+	 * Adds executed commands of an event.
+	 *
+	 * @param source executing event
+	 * @param commands number of commands
+	 * @param dt time spent
+	 */
+	void Add(const Source& source, int64_t commands, Game_Clock::duration dt);
+
+	/** @return entries of the last complete window, the most expensive first */
+	const std::vector<Entry>& GetEntries();
+
+	/** @return real length of the last complete window */
+	Game_Clock::duration GetWindowDuration();
+
+	/**
+	 * @param source event
+	 * @return short name, e.g. "M12/3" for page 3 of map event 12
+	 */
+	std::string GetName(const Source& source);
+
+	/**
+	 * Writes the entries of the last window as CSV with a header line.
+	 *
+	 * @param os output stream
+	 */
+	void WriteCsv(std::ostream& os);
+
+	/** Writes the entries of the last window to the log */
+	void Log();
+}
+
+#endif
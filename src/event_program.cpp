@@ -0,0 +1,151 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include "event_program.h"
+#include "memory_stats.h"
+#include <algorithm>
+#include <map>
+#include <unordered_map>
+#include <utility>
+
+namespace {
+	using ListKey = std::pair<const lcf::rpg::EventCommand*, size_t>;
+
+	/** Shared lists by the address and size of the list they were copied from */
+	std::map<ListKey, std::weak_ptr<const EventCommandList>> lists;
+	/** Size of the cache after the last removal of expired lists */
+	size_t lists_pruned_size = 0;
+	constexpr size_t min_prune_size = 64;
+
+	void PruneExpired() {
+		for (auto it = lists.begin(); it != lists.end();) {
+			if (it->second.expired()) {
+				it = lists.erase(it);
+			} else {
+				++it;
+			}
+		}
+		lists_pruned_size = lists.size();
+	}
+}
+
+constexpr int EventProgram::no_target;
+
+EventProgram::EventProgram(const std::vector<lcf::rpg::EventCommand>& commands)
+	: source(commands.data()), source_size(commands.size())
+{
+	const int count = static_cast<int>(commands.size());
+	instructions.resize(commands.size());
+
+	// JumpToLabel continues at the first label with the id
+	std::unordered_map<int, int> labels;
+	// Commands waiting for their next command at the same or a lower indent
+	std::vector<int> open;
+	// Per indent the Loop an EndLoop returns to, a lower indent closes all deeper loops
+	std::vector<int> loops;
+	int break_loop = no_target;
+
+	for (int i = 0; i < count; ++i) {
+		const auto& com = commands[i];
+		auto& ins = instructions[i];
+		ins.code = static_cast<Cmd>(com.code);
+		ins.indent = com.indent;
+		ins.next = count;
+
+		while (!open.empty() && instructions[open.back()].indent >= ins.indent) {
+			instructions[open.back()].next = i;
+			open.pop_back();
+		}
+		open.push_back(i);
+
+		const size_t depth = static_cast<size_t>(std::max(ins.indent, 0));
+		loops.resize(depth + 1, no_target);
+
+		switch (ins.code) {
+			case Cmd::Label:
+				if (!com.parameters.empty()) {
+					labels.emplace(com.parameters[0], i);
+				}
+				break;
+			case Cmd::Loop:
+				loops[depth] = i;
+				break;
+			case Cmd::EndLoop:
+				ins.target = loops[depth];
+				break;
+			default:
+				break;
+		}
+	}
+
+	for (int i = count - 1; i >= 0; --i) {
+		auto& ins = instructions[i];
+		if (ins.code == Cmd::JumpToLabel && !commands[i].parameters.empty()) {
+			auto it = labels.find(commands[i].parameters[0]);
+			if (it != labels.end()) {
+				ins.target = it->second;
+			}
+		} else if (ins.code == Cmd::BreakLoop) {
+			// RPG_RT ignores the scope and leaves at the next EndLoop
+			ins.target = break_loop;
+		}
+
+		if (ins.code == Cmd::EndLoop) {
+			break_loop = i;
+		}
+	}
+}
+
+EventCommandList::EventCommandList(std::vector<lcf::rpg::EventCommand> commands)
+	: commands(std::move(commands)), program(this->commands)
+{
+}
+
+std::shared_ptr<const EventCommandList> EventCommandList::Get(const std::vector<lcf::rpg::EventCommand>& commands) {
+	const ListKey key = { commands.data(), commands.size() };
+
+	// The address alone is no proof, the source could have been replaced or changed
+	auto& entry = lists[key];
+	if (auto list = entry.lock()) {
+		if (list->GetCommands() == commands) {
+			return list;
+		}
+	}
+
+	auto list = std::make_shared<const EventCommandList>(commands);
+	entry = list;
+
+	if (lists.size() >= min_prune_size && lists.size() >= lists_pruned_size * 2) {
+		PruneExpired();
+	}
+
+	return list;
+}
+
+int EventCommandList::GetCacheSize() {
+	return static_cast<int>(lists.size());
+}
+
+void EventCommandList::ClearCache() {
+	lists.clear();
+	lists_pruned_size = 0;
+}
+
+size_t EventCommandList::GetMemorySize() const {
+	return MemoryStats::GetSize(commands) + program.GetMemorySize();
+}
@@ -0,0 +1,160 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_EVENT_PROGRAM_H
+#define EP_EVENT_PROGRAM_H
+
+// Headers
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <lcf/rpg/eventcommand.h>
+
+/**
+ * Compact form of an event command list used by the interpreter.
+ * It is compiled once when the list is pushed on the interpreter stack and
+ * stores what the interpreter looks up per command in a small contiguous
+ * array, jump targets are resolved while compiling. This makes skipping
+ * branches and choices, jumping to labels and leaving loops O(1) instead of
+ * a scan of the list.
+ * The lcf commands stay the source of the interpreter state and savegames.
+ */
+class EventProgram {
+public:
+	using Cmd = lcf::rpg::EventCommand::Code;
+
+	/** Target of instructions which don't jump */
+	static constexpr int no_target = -1;
+
+	struct Instruction {
+		Cmd code = Cmd::END;
+		int indent = 0;
+		/**
+		 * JumpToLabel: index of the first label with the id.
+		 * BreakLoop: index of the next EndLoop.
+		 * EndLoop: index of the matching Loop.
+		 * no_target when there is none.
+		 */
+		int target = no_target;
+		/** Index of the next command at the same or a lower indent, size() at the end */
+		int next = 0;
+	};
+
+	EventProgram() = default;
+
+	/**
+	 * Compiles a command list.
+	 *
+	 * @param commands commands to compile
+	 */
+	explicit EventProgram(const std::vector<lcf::rpg::EventCommand>& commands);
+
+	/**
+	 * @param commands command list
+	 * @return whether the program was compiled from this list
+	 */
+	bool IsCompiledFrom(const std::vector<lcf::rpg::EventCommand>& commands) const;
+
+	/** @return number of instructions */
+	int size() const;
+
+	/**
+	 * @param idx command index
+	 * @return instruction of the command
+	 */
+	const Instruction& operator[](int idx) const;
+
+	/** @return bytes used by the instructions */
+	size_t GetMemorySize() const;
+
+private:
+	std::vector<Instruction> instructions;
+	const lcf::rpg::EventCommand* source = nullptr;
+	size_t source_size = 0;
+};
+
+/**
+ * Immutable copy of a command list together with its program.
+ * The interpreter frames of all events executing the same list share one
+ * instance instead of copying and compiling the commands on every call.
+ */
+class EventCommandList {
+public:
+	/**
+	 * Returns the shared copy of a command list. An existing copy is reused
+	 * when it is still in use and equal to the list.
+	 *
+	 * @param commands command list
+	 * @return shared copy
+	 */
+	static std::shared_ptr<const EventCommandList> Get(const std::vector<lcf::rpg::EventCommand>& commands);
+
+	/** @return number of lists known to Get */
+	static int GetCacheSize();
+
+	/** Forgets all lists, lists still in use stay valid */
+	static void ClearCache();
+
+	/**
+	 * Takes ownership of a list without sharing it, used for savegame frames.
+	 *
+	 * @param commands command list
+	 */
+	explicit EventCommandList(std::vector<lcf::rpg::EventCommand> commands);
+
+	EventCommandList(const EventCommandList&) = delete;
+	EventCommandList& operator=(const EventCommandList&) = delete;
+
+	/** @return the commands */
+	const std::vector<lcf::rpg::EventCommand>& GetCommands() const;
+
+	/** @return the compiled commands */
+	const EventProgram& GetProgram() const;
+
+	/** @return bytes used by the commands and the program */
+	size_t GetMemorySize() const;
+
+private:
+	std::vector<lcf::rpg::EventCommand> commands;
+	EventProgram program;
+};
+
+inline bool EventProgram::IsCompiledFrom(const std::vector<lcf::rpg::EventCommand>& commands) const {
+	return source == commands.data() && source_size == commands.size();
+}
+
+inline int EventProgram::size() const {
+	return static_cast<int>(instructions.size());
+}
+
+inline const EventProgram::Instruction& EventProgram::operator[](int idx) const {
+	return instructions[idx];
+}
+
+inline size_t EventProgram::GetMemorySize() const {
+	return instructions.capacity() * sizeof(Instruction);
+}
+
+inline const std::vector<lcf::rpg::EventCommand>& EventCommandList::GetCommands() const {
+	return commands;
+}
+
+inline const EventProgram& EventCommandList::GetProgram() const {
+	return program;
+}
+
+#endif
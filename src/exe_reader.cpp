@@ -22,10 +22,21 @@
 #include "filefinder.h"
 #include "bitmap.h"
 #include "output.h"
+#include "utils.h"
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 
-EXEReader::EXEReader(Filesystem_Stream::InputStream& core) : corefile(core) {
+EXEReader::EXEReader(Filesystem_Stream::InputStream& core) {
+	// Reading the headers with many small seeks is slow on SD cards,
+	// the file is used in place when mapped or else read in one go.
+	core.seekg(0, std::ios_base::beg);
+	data = core.GetSpan();
+	if (data.size() == 0) {
+		buffer = Utils::ReadStream(core);
+		data = Span<const uint8_t>(buffer.data(), buffer.size());
+	}
+
 	// The Incredibly Dumb Resource Grabber (tm)
 	// The idea is that this code will eventually be moved to happen earlier or broken down as-needed.
 	// Since EXFONT is the only thing that matters right now, it's the only thing handled.
@@ -71,18 +82,13 @@ static uint32_t djb2_hash(char* str, size_t length) {
 	return hash;
 }
 
-static std::vector<uint8_t> exe_reader_perform_exfont_save(Filesystem_Stream::InputStream& corefile, uint32_t position, uint32_t len) {
+std::vector<uint8_t> EXEReader::ExFontSave(uint32_t position, uint32_t len) const {
 	std::vector<uint8_t> exfont;
 	constexpr int header_size = 14;
 	exfont.resize(len + header_size);
 
-	corefile.seekg(position, std::ios_base::beg);
-
 	// Solely for calculating position of actual data
-	uint32_t hdrL = corefile.get();
-	hdrL |= ((uint32_t) corefile.get()) << 8;
-	hdrL |= ((uint32_t) corefile.get()) << 16;
-	hdrL |= ((uint32_t) corefile.get()) << 24;
+	uint32_t hdrL = GetU32(position);
 	// As it turns out, EXFONTs appear to operate on all the same restrictions as an ordinary BMP.
 	// Given this particular resource is loaded by the RPG Maker half of the engine, this makes the usual amount of sense.
 	// This means 256 palette entries. Without fail. Even though only two are used, the first and last.
@@ -112,13 +118,10 @@ static std::vector<uint8_t> exe_reader_perform_exfont_save(Filesystem_Stream::In
 	exfont[pos++] = (hdrL >> 16) & 0xFF;
 	exfont[pos++] = (hdrL >> 24) & 0xFF;
 
-	corefile.seekg(position, std::ios_base::beg);
-	while (len > 0) {
-		int v = corefile.get();
-		if (v == -1)
-			break;
-		exfont[pos++] = v;
-		len--;
+	// Anything beyond the end of the file stays 0
+	if (position < data.size()) {
+		len = std::min<uint32_t>(len, data.size() - position);
+		std::copy(data.data() + position, data.data() + position + len, exfont.begin() + pos);
 	}
 
 	// Check if the ExFont is the original through a fast hash function
@@ -164,7 +167,7 @@ std::vector<uint8_t> EXEReader::GetExFont() {
 						uint32_t filebase = (GetU32(dataent) - resource_rva) + resource_ofs;
 						uint32_t filesize = GetU32(dataent + 0x04);
 						Output::Debug("EXEReader: EXFONT resource found (DE {:#x}; {:#x}; len {:#x})", dataent, filebase, filesize);
-						return exe_reader_perform_exfont_save(corefile, filebase, filesize);
+						return ExFontSave(filebase, filesize);
 					}
 				}
 				resourcesNDEbase += 8;
@@ -180,27 +183,19 @@ std::vector<uint8_t> EXEReader::GetExFont() {
 	return std::vector<uint8_t>();
 }
 
-uint8_t EXEReader::GetU8(uint32_t i) {
-	corefile.seekg(i, std::ios_base::beg);
-	int ch = corefile.get();
-	if (ch == -1)
-		ch = 0;
-	return (uint8_t) ch;
-}
-
-uint16_t EXEReader::GetU16(uint32_t i) {
+uint16_t EXEReader::GetU16(uint32_t i) const {
 	uint16_t v = GetU8(i);
 	v |= ((uint32_t) GetU8(i + 1)) << 8;
 	return v;
 }
 
-uint32_t EXEReader::GetU32(uint32_t i) {
+uint32_t EXEReader::GetU32(uint32_t i) const {
 	uint32_t v = GetU16(i);
 	v |= ((uint32_t) GetU16(i + 2)) << 16;
 	return v;
 }
 
-bool EXEReader::ResNameCheck(uint32_t i, const char* p) {
+bool EXEReader::ResNameCheck(uint32_t i, const char* p) const {
 	if (GetU16(i) != strlen(p))
 		return false;
 	while (*p) {
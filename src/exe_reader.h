@@ -23,11 +23,13 @@
 #include <istream>
 #include <vector>
 #include "bitmap.h"
+#include "span.h"
 
 /**
  * Extracts resources from an EXE.
- * The istream given is still owned by the parent,
- *  but it is in use by the reader.
+ * The istream given is still owned by the parent.
+ * Mapped files are used in place and must stay open while the reader exists,
+ *  other streams are read once into a buffer.
  */
 class EXEReader {
 public:
@@ -38,6 +40,9 @@ public:
 	EXEReader(Filesystem_Stream::InputStream& core);
 	~EXEReader();
 
+	EXEReader(const EXEReader&) = delete;
+	EXEReader& operator=(const EXEReader&) = delete;
+
 	// Extracts an EXFONT resource with BMP header if present
 	// and returns exfont buffer on success.
 	std::vector<uint8_t> GetExFont();
@@ -45,17 +50,25 @@ private:
 	// Bounds-checked unaligned reader primitives.
 	// In case of out-of-bounds, returns 0 - this will usually result in a harmless error at some other level,
 	//  or a partial correct interpretation.
-	uint8_t GetU8(uint32_t point);
-	uint16_t GetU16(uint32_t point);
-	uint32_t GetU32(uint32_t point);
+	uint8_t GetU8(uint32_t point) const;
+	uint16_t GetU16(uint32_t point) const;
+	uint32_t GetU32(uint32_t point) const;
+
+	bool ResNameCheck(uint32_t namepoint, const char* name) const;
 
-	bool ResNameCheck(uint32_t namepoint, const char* name);
+	std::vector<uint8_t> ExFontSave(uint32_t position, uint32_t len) const;
 
 	// 0 if resource section was unfindable.
 	uint32_t resource_ofs;
 	uint32_t resource_rva;
 
-	Filesystem_Stream::InputStream& corefile;
+	// The whole EXE, either the mapped file or buffer.
+	Span<const uint8_t> data;
+	std::vector<uint8_t> buffer;
 };
 
+inline uint8_t EXEReader::GetU8(uint32_t i) const {
+	return i < data.size() ? data[i] : 0;
+}
+
 #endif
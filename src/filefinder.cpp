@@ -26,6 +26,9 @@
 #include <string>
 #include <vector>
 #include <sstream>
+#ifdef HAVE_THREADS
+#include <future>
+#endif
 
 #ifdef _WIN32
 #  include <windows.h>
@@ -40,12 +43,15 @@
 #include "system.h"
 #include "options.h"
 #include "utils.h"
+#include "asset_cache.h"
 #include "filefinder.h"
 #include "fileext_guesser.h"
+#include "filesystem_zip.h"
 #include "output.h"
 #include "player.h"
 #include "registry.h"
 #include "rtp.h"
+#include "startup_stats.h"
 #include "main_data.h"
 #include <lcf/reader_util.h>
 #include "platform.h"
@@ -69,6 +75,102 @@ namespace {
 	std::shared_ptr<FileFinder::DirectoryTree> game_directory_tree;
 	std::string fonts_path;
 
+	/** Files from this size on are memory-mapped when opened for reading */
+	constexpr int64_t min_mapped_size = 64 * 1024;
+	/** Read buffer of files that are not mapped */
+	constexpr size_t read_buffer_size = 32 * 1024;
+
+	/** Memory-mapped file, reads do not copy into a stream buffer first */
+	class MappedStreamBuf : public Filesystem_Stream::SpanStreamBuf {
+	public:
+		explicit MappedStreamBuf(const std::string& name) : mapping(name) {
+			SetData(mapping.GetData(), mapping.GetSize());
+		}
+
+		bool IsOpen() const {
+			return static_cast<bool>(mapping);
+		}
+
+	private:
+		Platform::FileMapping mapping;
+	};
+
+	/** File buffer with a larger buffer than the default */
+	class BufferedFileBuf : public std::filebuf {
+	public:
+		BufferedFileBuf() : buffer(read_buffer_size) {
+			setbuf(buffer.data(), buffer.size());
+		}
+
+	private:
+		std::vector<char> buffer;
+	};
+
+	/** Archives opened by CreateDirectoryTree, they are used like directories */
+	std::vector<std::shared_ptr<ZipFilesystem>> archives;
+
+	/**
+	 * Finds the opened archive containing a path.
+	 *
+	 * @param path path to check
+	 * @param name receives the path inside of the archive, empty for the archive itself
+	 * @return archive or nullptr when path is not in an archive
+	 */
+	const ZipFilesystem* FindArchive(StringView path, std::string& name) {
+		for (const auto& archive : archives) {
+			const StringView archive_path = archive->GetPath();
+			if (path == archive_path) {
+				name.clear();
+				return archive.get();
+			}
+			if (path.size() > archive_path.size() && path.starts_with(archive_path) &&
+					(path[archive_path.size()] == '/' || path[archive_path.size()] == '\\')) {
+				// Archives always use '/'
+				name = ToString(path.substr(archive_path.size() + 1));
+				std::replace(name.begin(), name.end(), '\\', '/');
+				return archive.get();
+			}
+		}
+		return nullptr;
+	}
+
+	/**
+	 * Opens the archive a path points into, when not opened yet.
+	 *
+	 * @param path path of a directory, can be inside of a ZIP archive
+	 * @return path to list, for archives containing only one directory this is the directory
+	 */
+	std::string MountArchive(const std::string& path) {
+		std::string name;
+		if (!FindArchive(path, name)) {
+			const std::string lower = Utils::LowerCase(path);
+			for (size_t pos = lower.find(".zip"); pos != std::string::npos; pos = lower.find(".zip", pos + 1)) {
+				const size_t end = pos + 4;
+				if (end != lower.size() && lower[end] != '/' && lower[end] != '\\') {
+					continue;
+				}
+				const std::string archive_path = path.substr(0, end);
+				if (Platform::File(archive_path).IsFile(true)) {
+					auto archive = ZipFilesystem::Open(archive_path, Player::encoding);
+					if (archive) {
+						archives.push_back(std::move(archive));
+					}
+					break;
+				}
+			}
+		}
+
+		const ZipFilesystem* archive = FindArchive(path, name);
+		if (archive && name.empty()) {
+			// Games are usually packed with their folder
+			auto root = archive->GetDirectoryMembers(name, FileFinder::ALL);
+			if (root.files.empty() && root.directories.size() == 1) {
+				return FileFinder::MakePath(path, root.directories.begin()->second);
+			}
+		}
+		return path;
+	}
+
 	struct {
 		/** all RTP search paths */
 		search_path_list search_paths;
@@ -145,11 +247,12 @@ namespace {
 		string_map::const_iterator dir_it = tree.directories.find(corrected_dir);
 		if(dir_it == tree.directories.end()) { return ""; }
 
-		string_map const& dir_map = tree.sub_members.find(corrected_dir)->second;
+		string_map const* dir_map = tree.FindSubMembers(corrected_dir);
+		if (!dir_map) { return ""; }
 
 		for(char const** c = exts; *c != NULL; ++c) {
-			string_map::const_iterator const name_it = dir_map.find(corrected_name + *c);
-			if(name_it != dir_map.end()) {
+			string_map::const_iterator const name_it = dir_map->find(corrected_name + *c);
+			if(name_it != dir_map->end()) {
 				return MakePath
 					(std::string(tree.directory_path).append("/")
 					 .append(dir_it->second), name_it->second);
@@ -276,6 +379,85 @@ namespace {
 
 		return ret;
 	}
+
+	/** Result of a FindFile call, the key is hashed from all arguments */
+	struct LookupEntry {
+		std::string dir;
+		std::string name;
+		char const** exts;
+		bool translate;
+		std::string path;
+	};
+
+	std::unordered_map<uint64_t, LookupEntry> lookup_cache;
+	/** State the cached results depend on */
+	const FileFinder::DirectoryTree* lookup_tree = nullptr;
+	std::string lookup_translation;
+	size_t lookup_game_rtp = 0;
+
+	uint64_t HashLookup(StringView dir, StringView name, char const* exts[], bool translate) {
+		// FNV-1a
+		uint64_t hash = 14695981039346656037ULL;
+		auto add = [&](const char* data, size_t size) {
+			for (size_t i = 0; i < size; ++i) {
+				hash = (hash ^ static_cast<unsigned char>(data[i])) * 1099511628211ULL;
+			}
+		};
+		add(dir.data(), dir.size());
+		add(":", 1);
+		add(name.data(), name.size());
+		add(reinterpret_cast<const char*>(&exts), sizeof(exts));
+		add(translate ? "T" : " ", 1);
+		return hash;
+	}
+
+	bool IsLookupCacheValid() {
+		return lookup_tree == game_directory_tree.get() &&
+			lookup_game_rtp == rtp_state.game_rtp.size() &&
+			lookup_translation == Tr::GetCurrentTranslationId();
+	}
+
+	void ResetLookupCache() {
+		lookup_cache.clear();
+		lookup_tree = game_directory_tree.get();
+		lookup_game_rtp = rtp_state.game_rtp.size();
+		lookup_translation = Tr::GetCurrentTranslationId();
+	}
+
+	/** FindFile with the result cached, only allocates when not cached yet */
+	std::string LookupFile(StringView dir, StringView name, char const* exts[], bool tryTranslate=false) {
+		if (!IsLookupCacheValid()) {
+			ResetLookupCache();
+		}
+
+		const uint64_t key = HashLookup(dir, name, exts, tryTranslate);
+		auto it = lookup_cache.find(key);
+		if (it != lookup_cache.end()) {
+			const auto& entry = it->second;
+			if (entry.exts == exts && entry.translate == tryTranslate &&
+					StringView(entry.dir) == dir && StringView(entry.name) == name) {
+				return entry.path;
+			}
+		}
+
+		std::string path = FindFile(ToString(dir), ToString(name), exts, tryTranslate);
+
+#ifdef EMSCRIPTEN
+		// The file can still be downloaded later
+		if (path.empty()) {
+			return path;
+		}
+#endif
+
+		if (!IsLookupCacheValid()) {
+			// The RTP of the game was detected by this lookup
+			ResetLookupCache();
+		}
+
+		// Replaces the entry on hash collision
+		lookup_cache[key] = LookupEntry{ ToString(dir), ToString(name), exts, tryTranslate, path };
+		return path;
+	}
 } // anonymous namespace
 
 const std::shared_ptr<FileFinder::DirectoryTree> FileFinder::GetDirectoryTree() {
@@ -304,12 +486,14 @@ const std::shared_ptr<FileFinder::DirectoryTree> FileFinder::CreateSaveDirectory
 
 void FileFinder::SetDirectoryTree(std::shared_ptr<DirectoryTree> directory_tree) {
 	game_directory_tree = directory_tree;
+	ResetLookupCache();
 }
 
 std::shared_ptr<FileFinder::DirectoryTree> FileFinder::CreateDirectoryTree(const std::string& p, Mode mode) {
-	if(! (Exists(p) && IsDirectory(p, true))) { return std::shared_ptr<DirectoryTree>(); }
+	const std::string path = MountArchive(p);
+	if(! (Exists(path) && IsDirectory(path, true))) { return std::shared_ptr<DirectoryTree>(); }
 	std::shared_ptr<DirectoryTree> tree = std::make_shared<DirectoryTree>();
-	tree->directory_path = p;
+	tree->directory_path = path;
 
 	bool recursive = false;
 	if (mode == RECURSIVE) {
@@ -326,13 +510,46 @@ std::shared_ptr<FileFinder::DirectoryTree> FileFinder::CreateDirectoryTree(const
 	}
 
 	if (recursive) {
+		if (!AssetCache::IsEnabled()) {
+			tree->lazy = true;
+			return tree;
+		}
+
+		// The cached tree is only used when no directory changed
+		std::shared_ptr<DirectoryTree> cached = std::make_shared<DirectoryTree>();
+		cached->directory_path = path;
+		if (AssetCache::LoadDirectoryTree(*cached) && cached->files == tree->files && cached->directories == tree->directories) {
+			return cached;
+		}
+
 		for (auto& i : mem.directories) {
 			GetDirectoryMembers(MakePath(tree->directory_path, i.second), RECURSIVE).files.swap(tree->sub_members[i.first]);
 		}
+		AssetCache::StoreDirectoryTree(*tree);
 	}
 	return tree;
 }
 
+const FileFinder::string_map* FileFinder::DirectoryTree::FindSubMembers(const std::string& dir) const {
+	auto it = sub_members.find(dir);
+	if (it != sub_members.end()) {
+		return &it->second;
+	}
+
+	if (!lazy) {
+		return nullptr;
+	}
+
+	auto dir_it = directories.find(dir);
+	if (dir_it == directories.end()) {
+		return nullptr;
+	}
+
+	auto& members = sub_members[dir];
+	GetDirectoryMembers(MakePath(directory_path, dir_it->second), RECURSIVE).files.swap(members);
+	return &members;
+}
+
 std::string FileFinder::MakePath(StringView dir, StringView name) {
 	std::string str = dir.empty()? std::string(name) : std::string(dir) + "/" + std::string(name);
 #ifdef _WIN32
@@ -482,22 +699,87 @@ std::string FileFinder::FindFont(const std::string& name) {
 #endif
 }
 
+namespace {
+	/** Paths queued by add_rtp_path, probed by add_queued_rtp_paths */
+	std::vector<std::string> queued_rtp_paths;
+
+	/** Tree and detected RTP of a RTP path */
+	struct RtpProbe {
+		std::shared_ptr<FileFinder::DirectoryTree> tree;
+		std::vector<RTP::RtpHitInfo> hit_info;
+	};
+
+	RtpProbe probe_rtp_path(const std::string& p, int version) {
+		RtpProbe probe;
+		probe.tree = FileFinder::CreateDirectoryTree(p);
+		if (probe.tree) {
+			StartupStats::Scope scope(StartupStats::Stage::RtpDetect);
+			probe.hit_info = RTP::Detect(probe.tree, version);
+		}
+		return probe;
+	}
+}
+
 static void add_rtp_path(const std::string& p) {
-	using namespace FileFinder;
-	std::shared_ptr<DirectoryTree> tree(CreateDirectoryTree(p));
-	if (tree) {
-		Output::Debug("Adding {} to RTP path", p);
-		rtp_state.search_paths.push_back(tree);
+	queued_rtp_paths.push_back(p);
+}
+
+/**
+ * Lists and detects the queued RTP paths and adds them in queue order.
+ * The paths are independent and probed in parallel when threads are available.
+ */
+static void add_queued_rtp_paths() {
+	std::vector<std::string> paths;
+	paths.swap(queued_rtp_paths);
+
+	const int version = Player::EngineVersion();
+	std::vector<RtpProbe> probes(paths.size());
+	// A path can be queued twice (registry and environment), it is only probed once
+	std::vector<size_t> first_index(paths.size());
+	for (size_t i = 0; i < paths.size(); ++i) {
+		first_index[i] = std::find(paths.begin(), paths.begin() + i, paths[i]) - paths.begin();
+	}
+
+#ifdef HAVE_THREADS
+	std::vector<std::future<RtpProbe>> futures(paths.size());
+	for (size_t i = 0; i < paths.size(); ++i) {
+		if (first_index[i] == i && paths.size() > 1) {
+			futures[i] = std::async(std::launch::async, probe_rtp_path, std::cref(paths[i]), version);
+		}
+	}
+#endif
+	for (size_t i = 0; i < paths.size(); ++i) {
+		if (first_index[i] != i) {
+			probes[i] = probes[first_index[i]];
+			continue;
+		}
+#ifdef HAVE_THREADS
+		if (futures[i].valid()) {
+			probes[i] = futures[i].get();
+			continue;
+		}
+#endif
+		probes[i] = probe_rtp_path(paths[i], version);
+	}
+
+	for (size_t i = 0; i < paths.size(); ++i) {
+		const auto& p = paths[i];
+		const auto& probe = probes[i];
+		if (!probe.tree) {
+			Output::Debug("RTP path {} is invalid, not adding", p);
+			continue;
+		}
 
-		auto hit_info = RTP::Detect(tree, Player::EngineVersion());
+		Output::Debug("Adding {} to RTP path", p);
+		rtp_state.search_paths.push_back(probe.tree);
 
-		if (hit_info.empty()) {
+		if (probe.hit_info.empty()) {
 			Output::Debug("The folder does not contain a known RTP!");
 		}
 
 		// Only consider the best RTP hits (usually 100% if properly installed)
 		float best = 0.0;
-		for (const auto& hit : hit_info) {
+		for (const auto& hit : probe.hit_info) {
 			float rate = (float)hit.hits / hit.max;
 			if (rate >= best) {
 				Output::Debug("RTP is \"{}\" ({}/{})", hit.name, hit.hits, hit.max);
@@ -505,8 +787,6 @@ static void add_rtp_path(const std::string& p) {
 				best = rate;
 			}
 		}
-	} else {
-		Output::Debug("RTP path {} is invalid, not adding", p);
 	}
 }
 
@@ -526,6 +806,7 @@ static void read_rtp_registry(const std::string& company, const std::string& pro
 
 void FileFinder::InitRtpPaths(bool no_rtp, bool no_rtp_warnings) {
 	rtp_state = {};
+	ResetLookupCache();
 
 #ifdef EMSCRIPTEN
 	// No RTP support for emscripten at the moment.
@@ -653,16 +934,44 @@ void FileFinder::InitRtpPaths(bool no_rtp, bool no_rtp_warnings) {
 	for (const std::string& p : env_paths) {
 		add_rtp_path(p);
 	}
+
+	add_queued_rtp_paths();
 }
 
 void FileFinder::Quit() {
 	rtp_state = {};
 	game_directory_tree.reset();
+	archives.clear();
+	ResetLookupCache();
 }
 
 
 Filesystem_Stream::InputStream FileFinder::OpenInputStream(const std::string& name, std::ios_base::openmode m) {
-	auto* buf = new std::filebuf();
+	std::string archive_name;
+	const ZipFilesystem* archive = FindArchive(name, archive_name);
+	if (archive && !archive_name.empty()) {
+		return archive->OpenInputStream(archive_name);
+	}
+
+	return OpenNativeInputStream(name, m);
+}
+
+bool FileFinder::IsInArchive(StringView name) {
+	std::string archive_name;
+	const ZipFilesystem* archive = FindArchive(name, archive_name);
+	return archive && !archive_name.empty();
+}
+
+Filesystem_Stream::InputStream FileFinder::OpenNativeInputStream(const std::string& name, std::ios_base::openmode m) {
+	if ((m & std::ios_base::out) == 0 && (m & std::ios_base::binary) && Platform::File(name).GetSize() >= min_mapped_size) {
+		auto* mapped = new MappedStreamBuf(name);
+		if (mapped->IsOpen()) {
+			return Filesystem_Stream::InputStream(mapped);
+		}
+		delete mapped;
+	}
+
+	auto* buf = (m & std::ios_base::out) ? new std::filebuf() : new BufferedFileBuf();
 	buf->open(
 #ifdef _MSC_VER
 		Utils::ToWideString(name).c_str(),
@@ -699,18 +1008,18 @@ Filesystem_Stream::OutputStream FileFinder::OpenOutputStream(const std::string&
 	return os;
 }
 
-std::string FileFinder::FindImage(const std::string& dir, const std::string& name) {
+std::string FileFinder::FindImage(StringView dir, StringView name) {
 #ifdef EMSCRIPTEN
 	return FindDefault(dir, name);
 #endif
 
 	static const char* IMG_TYPES[] = { ".bmp",  ".png", ".xyz", NULL };
-	return FindFile(dir, name, IMG_TYPES, true);
+	return LookupFile(dir, name, IMG_TYPES, true);
 }
 
-std::string FileFinder::FindDefault(const std::string& dir, const std::string& name) {
+std::string FileFinder::FindDefault(StringView dir, StringView name) {
 	static const char* no_exts[] = {"", NULL};
-	return FindFile(dir, name, no_exts);
+	return LookupFile(dir, name, no_exts);
 }
 
 std::string FileFinder::FindDefault(const std::string& name) {
@@ -795,31 +1104,39 @@ int FileFinder::GetSavegames() {
 	return count;
 }
 
-std::string FileFinder::FindMusic(const std::string& name) {
+std::string FileFinder::FindMusic(StringView name) {
 #ifdef EMSCRIPTEN
 	return FindDefault("Music", name);
 #endif
 
 	static const char* MUSIC_TYPES[] = {
 		".opus", ".oga", ".ogg", ".wav", ".mid", ".midi", ".mp3", ".wma", nullptr };
-	return FindFile("Music", name, MUSIC_TYPES);
+	return LookupFile("Music", name, MUSIC_TYPES);
 }
 
-std::string FileFinder::FindSound(const std::string& name) {
+std::string FileFinder::FindSound(StringView name) {
 #ifdef EMSCRIPTEN
 	return FindDefault("Sound", name);
 #endif
 
 	static const char* SOUND_TYPES[] = {
 		".opus", ".oga", ".ogg", ".wav", ".mp3", ".wma", nullptr };
-	return FindFile("Sound", name, SOUND_TYPES);
+	return LookupFile("Sound", name, SOUND_TYPES);
 }
 
 bool FileFinder::Exists(const std::string& filename) {
+	std::string name;
+	if (const ZipFilesystem* archive = FindArchive(filename, name)) {
+		return archive->IsFile(name) || archive->IsDirectory(name);
+	}
 	return Platform::File(filename).Exists();
 }
 
 bool FileFinder::IsDirectory(const std::string& dir, bool follow_symlinks) {
+	std::string name;
+	if (const ZipFilesystem* archive = FindArchive(dir, name)) {
+		return archive->IsDirectory(name);
+	}
 	return Platform::File(dir).IsDirectory(follow_symlinks);
 }
 
@@ -827,6 +1144,11 @@ FileFinder::Directory FileFinder::GetDirectoryMembers(const std::string& path, F
 	assert(FileFinder::Exists(path));
 	assert(FileFinder::IsDirectory(path, true));
 
+	std::string archive_name;
+	if (const ZipFilesystem* archive = FindArchive(path, archive_name)) {
+		return archive->GetDirectoryMembers(archive_name, m);
+	}
+
 	Directory result;
 
 	result.base = path;
@@ -895,6 +1217,11 @@ FileFinder::Directory FileFinder::GetDirectoryMembers(const std::string& path, F
 }
 
 int64_t FileFinder::GetFileSize(const std::string& file) {
+	std::string name;
+	const ZipFilesystem* archive = FindArchive(file, name);
+	if (archive && !name.empty()) {
+		return archive->GetFileSize(name);
+	}
 	return Platform::File(file).GetSize();
 }
 
@@ -916,9 +1243,9 @@ bool FileFinder::IsMajorUpdatedTree() {
 		const std::shared_ptr<DirectoryTree> tree = GetDirectoryTree();
 		string_map::const_iterator const music_it = tree->directories.find("music");
 		if (music_it != tree->directories.end()) {
-			string_map mem = tree->sub_members["music"];
-			for (auto& i : mem) {
-				std::string file = mem[i.first];
+			const string_map* mem = tree->FindSubMembers("music");
+			for (auto& i : *mem) {
+				const std::string& file = i.second;
 				if (ToStringView(Utils::LowerCase(file)).ends_with(".mp3")) {
 					Output::Debug("MP3 file ({}) found", file);
 					return true;
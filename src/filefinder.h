@@ -61,18 +61,31 @@ namespace FileFinder {
 	struct DirectoryTree {
 		std::string directory_path;
 		string_map files, directories;
-		sub_members_type sub_members;
+		/** Filled on first use when lazy, use FindSubMembers */
+		mutable sub_members_type sub_members;
+		/** Directories are only listed when a file in them is looked up */
+		bool lazy = false;
+
+		/**
+		 * Returns the files of a directory, listing it first when the tree is lazy.
+		 *
+		 * @param dir normalized name of a directory in directories
+		 * @return files in dir and its subdirectories, nullptr when dir is not in the tree
+		 */
+		const string_map* FindSubMembers(const std::string& dir) const;
 	}; // struct DirectoryTree
 
 	/**
 	 * Finds an image file.
 	 * Searches through the current RPG Maker game and the RTP directories.
+	 * Results of FindImage, FindDefault, FindMusic and FindSound are cached
+	 * until the directory tree, the RTP or the translation changes.
 	 *
 	 * @param dir directory to check.
 	 * @param name image file name to check.
 	 * @return path to file.
 	 */
-	std::string FindImage(const std::string& dir, const std::string& name);
+	std::string FindImage(StringView dir, StringView name);
 
 	/**
 	 * Finds a file.
@@ -82,7 +95,7 @@ namespace FileFinder {
 	 * @param name file name to check.
 	 * @return path to file.
 	 */
-	std::string FindDefault(const std::string& dir, const std::string& name);
+	std::string FindDefault(StringView dir, StringView name);
 
 	/**
 	 * Finds a file.
@@ -131,7 +144,7 @@ namespace FileFinder {
 	 * @param name the music path and name.
 	 * @return path to file.
 	 */
-	std::string FindMusic(const std::string& name);
+	std::string FindMusic(StringView name);
 
 	/**
 	 * Finds a sound file.
@@ -141,7 +154,7 @@ namespace FileFinder {
 	 * @param name the sound path and name.
 	 * @return path to file.
 	 */
-	std::string FindSound(const std::string& name);
+	std::string FindSound(StringView name);
 
 	/**
 	 * Finds a font file.
@@ -162,6 +175,23 @@ namespace FileFinder {
 	Filesystem_Stream::InputStream OpenInputStream(const std::string& name,
 			std::ios_base::openmode m = std::ios_base::in | std::ios_base::binary);
 
+	/**
+	* Creates stream from UTF-8 file name of a file which is not in an archive.
+	* Unlike OpenInputStream this is safe to use from any thread.
+	*
+	* @param name UTF-8 string file name.
+	* @param m stream mode.
+	* @return NULL if open failed.
+	*/
+	Filesystem_Stream::InputStream OpenNativeInputStream(const std::string& name,
+			std::ios_base::openmode m = std::ios_base::in | std::ios_base::binary);
+
+	/**
+	 * @param name path of a file
+	 * @return whether the file is in an opened archive and must be read with OpenInputStream
+	 */
+	bool IsInArchive(StringView name);
+
 	/**
 	* Creates stream from UTF-8 file name.
 	*
@@ -279,6 +309,17 @@ namespace FileFinder {
 	 */
 	const std::shared_ptr<DirectoryTree> GetDirectoryTree();
 	const std::shared_ptr<DirectoryTree> CreateSaveDirectoryTree();
+
+	/**
+	 * Lists a directory.
+	 * In RECURSIVE mode the subdirectories are listed on first use. When the
+	 * AssetCache is enabled the whole tree is listed at once instead and
+	 * kept on disk until a directory changes.
+	 *
+	 * @param p path of the directory
+	 * @param mode member listing mode
+	 * @return tree or nullptr when p is not a directory
+	 */
 	std::shared_ptr<DirectoryTree> CreateDirectoryTree(std::string const& p, Mode mode = RECURSIVE);
 
 	bool IsValidProject(DirectoryTree const& dir);
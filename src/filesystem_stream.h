@@ -22,36 +22,74 @@
 #include <cassert>
 #include <istream>
 #include <ostream>
+#include <streambuf>
+#include "span.h"
 #include "utils.h"
 
 namespace Filesystem_Stream {
+	/**
+	 * Stream buffer over data in memory, e.g. a memory-mapped file.
+	 * The whole stream is the get area, InputStream::GetSpan provides it.
+	 */
+	class SpanStreamBuf : public std::streambuf {
+	public:
+		/** @return data from the read position to the end */
+		Span<const uint8_t> GetRemaining() const;
+
+	protected:
+		/**
+		 * Sets the data of the stream, the derived class keeps it alive.
+		 *
+		 * @param data start of the data
+		 * @param size size of the data
+		 */
+		void SetData(const char* data, size_t size);
+
+		pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode mode) override;
+		pos_type seekpos(pos_type pos, std::ios_base::openmode mode) override;
+	};
+
 	class InputStream final : public std::istream {
 	public:
 		explicit InputStream(): std::istream(nullptr) {}
 		explicit InputStream(std::streambuf* sb) : std::istream(sb) {}
+		explicit InputStream(SpanStreamBuf* sb) : std::istream(sb), span_buf(sb) {}
 		~InputStream() override {
 			delete rdbuf();
 		}
 		InputStream(const InputStream&) = delete;
 		InputStream& operator=(const InputStream&) = delete;
-		InputStream(InputStream&& is) : std::istream(std::move(is)) {
+		InputStream(InputStream&& is) : std::istream(std::move(is)), span_buf(is.span_buf) {
 			set_rdbuf(is.rdbuf());
 			is.set_rdbuf(nullptr);
+			is.span_buf = nullptr;
 		}
 		InputStream& operator=(InputStream&& is) {
 			if (this == &is) return is;
 			std::istream::operator=(std::move(is));
 			set_rdbuf(is.rdbuf());
+			span_buf = is.span_buf;
 			is.set_rdbuf(nullptr);
+			is.span_buf = nullptr;
 			return is;
 		}
 
 		template <typename T>
 		bool ReadIntoObj(T& obj);
 
+		/**
+		 * Provides the unread data of streams held in memory, they can be
+		 * parsed in place. The span is valid while the stream is open.
+		 *
+		 * @return data from the read position to the end or an empty span
+		 */
+		Span<const uint8_t> GetSpan() const;
+
 	private:
 		template <typename T>
 		bool Read0(T& obj);
+
+		SpanStreamBuf* span_buf = nullptr;
 	};
 
 	class OutputStream final : public std::ostream {
@@ -81,6 +119,47 @@ namespace Filesystem_Stream {
 	static constexpr int CppSeekdirToCSeekdir(std::ios_base::seekdir origin);
 };
 
+inline Span<const uint8_t> Filesystem_Stream::SpanStreamBuf::GetRemaining() const {
+	return Span<const uint8_t>(reinterpret_cast<const uint8_t*>(gptr()), egptr() - gptr());
+}
+
+inline void Filesystem_Stream::SpanStreamBuf::SetData(const char* data, size_t size) {
+	// The get area is never written to
+	char* begin = const_cast<char*>(data);
+	setg(begin, begin, begin + size);
+}
+
+inline std::streambuf::pos_type Filesystem_Stream::SpanStreamBuf::seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode mode) {
+	if ((mode & std::ios_base::in) == 0) {
+		return pos_type(off_type(-1));
+	}
+
+	off_type base = 0;
+	if (dir == std::ios_base::cur) {
+		base = gptr() - eback();
+	} else if (dir == std::ios_base::end) {
+		base = egptr() - eback();
+	}
+
+	const off_type target = base + off;
+	if (target < 0 || target > egptr() - eback()) {
+		return pos_type(off_type(-1));
+	}
+	setg(eback(), eback() + target, egptr());
+	return pos_type(target);
+}
+
+inline std::streambuf::pos_type Filesystem_Stream::SpanStreamBuf::seekpos(pos_type pos, std::ios_base::openmode mode) {
+	return seekoff(off_type(pos), std::ios_base::beg, mode);
+}
+
+inline Span<const uint8_t> Filesystem_Stream::InputStream::GetSpan() const {
+	if (!span_buf) {
+		return {};
+	}
+	return span_buf->GetRemaining();
+}
+
 template<typename T>
 inline bool Filesystem_Stream::InputStream::Read0(T& obj) {
 	return read(reinterpret_cast<char*>(&obj), sizeof(obj)).gcount() == sizeof(obj);
@@ -0,0 +1,516 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <zlib.h>
+#include <lcf/reader_util.h>
+#include "filesystem_zip.h"
+#include "output.h"
+#include "platform.h"
+#include "utils.h"
+
+namespace {
+	constexpr uint32_t local_header_signature = 0x04034b50;
+	constexpr uint32_t central_header_signature = 0x02014b50;
+	constexpr uint32_t end_signature = 0x06054b50;
+
+	constexpr size_t local_header_size = 30;
+	constexpr size_t central_header_size = 46;
+	constexpr size_t end_size = 22;
+	constexpr size_t max_comment_size = 0xFFFF;
+
+	constexpr uint16_t flag_encrypted = 0x0001;
+	constexpr uint16_t flag_utf8 = 0x0800;
+
+	constexpr uint16_t method_stored = 0;
+	constexpr uint16_t method_deflated = 8;
+
+	constexpr size_t buffer_size = 16 * 1024;
+
+	uint16_t ReadLE16(const char* p) {
+		auto* u = reinterpret_cast<const uint8_t*>(p);
+		return u[0] | (u[1] << 8);
+	}
+
+	uint32_t ReadLE32(const char* p) {
+		auto* u = reinterpret_cast<const uint8_t*>(p);
+		return u[0] | (u[1] << 8) | (u[2] << 16) | (static_cast<uint32_t>(u[3]) << 24);
+	}
+
+	bool IsAscii(StringView s) {
+		return std::all_of(s.begin(), s.end(), [](char c) { return static_cast<unsigned char>(c) < 0x80; });
+	}
+}
+
+/** Stored entry of a mapped archive, read without copying */
+class ZipSpanStreamBuf : public Filesystem_Stream::SpanStreamBuf {
+public:
+	ZipSpanStreamBuf(std::shared_ptr<const ZipFilesystem> archive, const char* data, size_t size) :
+		archive(std::move(archive)) {
+		SetData(data, size);
+	}
+
+private:
+	std::shared_ptr<const ZipFilesystem> archive;
+};
+
+/** Reads an entry through a buffer, inflating it when deflated */
+class ZipStreamBuf : public std::streambuf {
+public:
+	ZipStreamBuf(std::shared_ptr<const ZipFilesystem> archive, Filesystem_Stream::InputStream file,
+			uint64_t data_offset, uint32_t compressed_size, uint32_t size, bool deflated);
+	~ZipStreamBuf() override;
+
+	/** @return false when the entry can not be read */
+	bool IsValid() const;
+
+protected:
+	int_type underflow() override;
+	pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode mode) override;
+	pos_type seekpos(pos_type pos, std::ios_base::openmode mode) override;
+
+private:
+	uint64_t Tell() const;
+	bool SeekTo(uint64_t target);
+	bool Inflate();
+	void ResetInflate();
+
+	std::shared_ptr<const ZipFilesystem> archive;
+	/** Archive file when it is not mapped */
+	Filesystem_Stream::InputStream file;
+	/** Entry data when the archive is mapped */
+	const char* data = nullptr;
+	uint64_t data_offset;
+	uint32_t compressed_size;
+	uint32_t size;
+	bool deflated;
+
+	z_stream zs = {};
+	bool zs_valid = false;
+	/** Compressed bytes read from the file */
+	uint32_t in_pos = 0;
+	std::vector<char> in_buffer;
+	std::vector<char> out_buffer;
+	/** Position in the entry of the start of the get area */
+	uint64_t buffer_pos = 0;
+};
+
+ZipStreamBuf::ZipStreamBuf(std::shared_ptr<const ZipFilesystem> archive, Filesystem_Stream::InputStream file,
+		uint64_t data_offset, uint32_t compressed_size, uint32_t size, bool deflated) :
+	archive(std::move(archive)), file(std::move(file)), data_offset(data_offset),
+	compressed_size(compressed_size), size(size), deflated(deflated) {
+	if (this->archive->mapping) {
+		data = this->archive->mapping + data_offset;
+	}
+
+	out_buffer.resize(buffer_size);
+	setg(out_buffer.data(), out_buffer.data(), out_buffer.data());
+
+	if (deflated) {
+		if (!data) {
+			in_buffer.resize(buffer_size);
+		}
+		// Raw deflate data without zlib header
+		zs_valid = inflateInit2(&zs, -MAX_WBITS) == Z_OK;
+		if (zs_valid) {
+			ResetInflate();
+		}
+	}
+}
+
+ZipStreamBuf::~ZipStreamBuf() {
+	if (zs_valid) {
+		inflateEnd(&zs);
+	}
+}
+
+bool ZipStreamBuf::IsValid() const {
+	return (!deflated || zs_valid) && (data || file);
+}
+
+uint64_t ZipStreamBuf::Tell() const {
+	return buffer_pos + (gptr() - eback());
+}
+
+void ZipStreamBuf::ResetInflate() {
+	inflateReset(&zs);
+	if (data) {
+		zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+		zs.avail_in = compressed_size;
+	} else {
+		zs.next_in = nullptr;
+		zs.avail_in = 0;
+	}
+	in_pos = 0;
+	buffer_pos = 0;
+	setg(out_buffer.data(), out_buffer.data(), out_buffer.data());
+}
+
+bool ZipStreamBuf::Inflate() {
+	zs.next_out = reinterpret_cast<Bytef*>(out_buffer.data());
+	zs.avail_out = static_cast<uInt>(out_buffer.size());
+
+	while (zs.avail_out == out_buffer.size()) {
+		if (zs.avail_in == 0 && !data) {
+			const uint32_t count = std::min<uint32_t>(in_buffer.size(), compressed_size - in_pos);
+			if (count == 0 || !file.seekg(data_offset + in_pos) || !file.read(in_buffer.data(), count)) {
+				return false;
+			}
+			in_pos += count;
+			zs.next_in = reinterpret_cast<Bytef*>(in_buffer.data());
+			zs.avail_in = count;
+		}
+
+		const int status = inflate(&zs, Z_NO_FLUSH);
+		if (status == Z_STREAM_END) {
+			break;
+		}
+		if (status != Z_OK) {
+			return false;
+		}
+	}
+
+	const size_t produced = out_buffer.size() - zs.avail_out;
+	setg(out_buffer.data(), out_buffer.data(), out_buffer.data() + produced);
+	return produced > 0;
+}
+
+ZipStreamBuf::int_type ZipStreamBuf::underflow() {
+	if (gptr() < egptr()) {
+		return traits_type::to_int_type(*gptr());
+	}
+
+	buffer_pos = Tell();
+	if (buffer_pos >= size) {
+		return traits_type::eof();
+	}
+
+	if (deflated) {
+		if (!Inflate()) {
+			return traits_type::eof();
+		}
+	} else {
+		const uint32_t count = std::min<uint64_t>(out_buffer.size(), size - buffer_pos);
+		if (!file.seekg(data_offset + buffer_pos) || !file.read(out_buffer.data(), count)) {
+			return traits_type::eof();
+		}
+		setg(out_buffer.data(), out_buffer.data(), out_buffer.data() + count);
+	}
+	return traits_type::to_int_type(*gptr());
+}
+
+bool ZipStreamBuf::SeekTo(uint64_t target) {
+	// Inside the current buffer
+	if (target >= buffer_pos && target <= buffer_pos + (egptr() - eback())) {
+		setg(eback(), eback() + (target - buffer_pos), egptr());
+		return true;
+	}
+
+	if (!deflated) {
+		// Read on the next underflow
+		buffer_pos = target;
+		setg(out_buffer.data(), out_buffer.data(), out_buffer.data());
+		return true;
+	}
+
+	// Deflate data can only be read forward
+	if (target < buffer_pos) {
+		ResetInflate();
+	}
+	while (buffer_pos + (egptr() - eback()) < target) {
+		buffer_pos += egptr() - eback();
+		if (!Inflate()) {
+			return false;
+		}
+	}
+	setg(eback(), eback() + (target - buffer_pos), egptr());
+	return true;
+}
+
+ZipStreamBuf::pos_type ZipStreamBuf::seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode mode) {
+	if ((mode & std::ios_base::in) == 0) {
+		return pos_type(off_type(-1));
+	}
+
+	int64_t base = 0;
+	if (dir == std::ios_base::cur) {
+		base = Tell();
+	} else if (dir == std::ios_base::end) {
+		base = size;
+	}
+
+	const int64_t target = base + off;
+	if (target < 0 || target > size || !SeekTo(target)) {
+		return pos_type(off_type(-1));
+	}
+	return pos_type(target);
+}
+
+ZipStreamBuf::pos_type ZipStreamBuf::seekpos(pos_type pos, std::ios_base::openmode mode) {
+	return seekoff(off_type(pos), std::ios_base::beg, mode);
+}
+
+std::shared_ptr<ZipFilesystem> ZipFilesystem::Open(std::string path, StringView encoding) {
+	std::shared_ptr<ZipFilesystem> zip(new ZipFilesystem());
+	zip->path = std::move(path);
+	zip->file_size = Platform::File(zip->path).GetSize();
+	if (zip->file_size < static_cast<int64_t>(end_size)) {
+		return nullptr;
+	}
+
+	zip->file_mapping.reset(new Platform::FileMapping(zip->path));
+	if (*zip->file_mapping) {
+		zip->mapping = zip->file_mapping->GetData();
+	} else {
+		Output::Debug("ZipFilesystem: {} is not memory mapped", zip->path);
+	}
+
+	if (!zip->ReadCentralDirectory(encoding)) {
+		return nullptr;
+	}
+
+	Output::Debug("ZipFilesystem: {} with {} files", zip->path, zip->entries.size());
+	return zip;
+}
+
+bool ZipFilesystem::ReadAt(uint64_t offset, void* dst, size_t size) const {
+	if (offset + size > static_cast<uint64_t>(file_size)) {
+		return false;
+	}
+	if (mapping) {
+		memcpy(dst, mapping + offset, size);
+		return true;
+	}
+
+	auto is = FileFinder::OpenInputStream(path);
+	return is && is.seekg(offset) && is.read(static_cast<char*>(dst), size);
+}
+
+bool ZipFilesystem::ReadCentralDirectory(StringView encoding) {
+	// The end record is followed by a comment of up to 64 KiB
+	const size_t tail_size = static_cast<size_t>(std::min<int64_t>(file_size, end_size + max_comment_size));
+	std::vector<char> tail(tail_size);
+	if (!ReadAt(file_size - tail_size, tail.data(), tail_size)) {
+		return false;
+	}
+
+	const char* end = nullptr;
+	for (size_t i = tail_size - end_size + 1; i-- > 0;) {
+		if (ReadLE32(&tail[i]) == end_signature) {
+			end = &tail[i];
+			break;
+		}
+	}
+	if (!end) {
+		return false;
+	}
+
+	const uint16_t disk = ReadLE16(end + 4);
+	const uint16_t cd_disk = ReadLE16(end + 6);
+	const uint16_t count = ReadLE16(end + 10);
+	const uint32_t cd_size = ReadLE32(end + 12);
+	const uint32_t cd_offset = ReadLE32(end + 16);
+	if (disk != 0 || cd_disk != 0) {
+		Output::Warning("ZipFilesystem: {}: Multi-part archives are not supported", path);
+		return false;
+	}
+	if (count == 0xFFFF || cd_size == 0xFFFFFFFF || cd_offset == 0xFFFFFFFF) {
+		Output::Warning("ZipFilesystem: {}: ZIP64 archives are not supported", path);
+		return false;
+	}
+
+	std::vector<char> cd(cd_size);
+	if (!ReadAt(cd_offset, cd.data(), cd.size())) {
+		return false;
+	}
+
+	entries.reserve(count);
+	size_t pos = 0;
+	for (uint16_t i = 0; i < count; ++i) {
+		if (pos + central_header_size > cd.size() || ReadLE32(&cd[pos]) != central_header_signature) {
+			Output::Warning("ZipFilesystem: {}: Corrupted central directory", path);
+			return false;
+		}
+		const char* header = &cd[pos];
+		const uint16_t flags = ReadLE16(header + 8);
+		const uint16_t name_size = ReadLE16(header + 28);
+		const size_t record_size = central_header_size + name_size + ReadLE16(header + 30) + ReadLE16(header + 32);
+		if (pos + record_size > cd.size()) {
+			Output::Warning("ZipFilesystem: {}: Corrupted central directory", path);
+			return false;
+		}
+
+		std::string name(header + central_header_size, name_size);
+		pos += record_size;
+
+		std::replace(name.begin(), name.end(), '\\', '/');
+		if (name.empty() || name.back() == '/') {
+			// Directories are derived from the file names
+			continue;
+		}
+		if (flags & flag_encrypted) {
+			Output::Debug("ZipFilesystem: {}: Skipping encrypted {}", path, name);
+			continue;
+		}
+		if ((flags & flag_utf8) == 0 && !encoding.empty() && !IsAscii(name)) {
+			std::string recoded = lcf::ReaderUtil::Recode(name, ToString(encoding));
+			if (!recoded.empty()) {
+				name = std::move(recoded);
+			}
+		}
+
+		Entry entry;
+		entry.name_offset = static_cast<uint32_t>(names.size());
+		entry.name_size = static_cast<uint32_t>(name.size());
+		entry.method = ReadLE16(header + 10);
+		entry.compressed_size = ReadLE32(header + 20);
+		entry.size = ReadLE32(header + 24);
+		entry.header_offset = ReadLE32(header + 42);
+		names += name;
+		entries.push_back(entry);
+	}
+
+	std::sort(entries.begin(), entries.end(), [this](const Entry& l, const Entry& r) {
+		return GetName(l) < GetName(r);
+	});
+	return true;
+}
+
+StringView ZipFilesystem::GetName(const Entry& entry) const {
+	return StringView(names).substr(entry.name_offset, entry.name_size);
+}
+
+std::vector<ZipFilesystem::Entry>::const_iterator ZipFilesystem::LowerBound(StringView name) const {
+	return std::lower_bound(entries.begin(), entries.end(), name, [this](const Entry& entry, StringView name) {
+		return GetName(entry) < name;
+	});
+}
+
+const ZipFilesystem::Entry* ZipFilesystem::FindEntry(StringView name) const {
+	auto it = LowerBound(name);
+	if (it == entries.end() || GetName(*it) != name) {
+		return nullptr;
+	}
+	return &*it;
+}
+
+bool ZipFilesystem::IsFile(StringView name) const {
+	return FindEntry(name) != nullptr;
+}
+
+bool ZipFilesystem::IsDirectory(StringView name) const {
+	if (name.empty()) {
+		return true;
+	}
+
+	const std::string prefix = ToString(name) + "/";
+	auto it = LowerBound(prefix);
+	return it != entries.end() && GetName(*it).starts_with(prefix);
+}
+
+int64_t ZipFilesystem::GetFileSize(StringView name) const {
+	const Entry* entry = FindEntry(name);
+	return entry ? static_cast<int64_t>(entry->size) : -1;
+}
+
+FileFinder::Directory ZipFilesystem::GetDirectoryMembers(StringView path, FileFinder::Mode mode) const {
+	FileFinder::Directory result;
+	result.base = path.empty() ? this->path : FileFinder::MakePath(this->path, path);
+
+	const std::string prefix = path.empty() ? std::string() : ToString(path) + "/";
+	for (auto it = LowerBound(prefix); it != entries.end(); ++it) {
+		const StringView name = GetName(*it);
+		if (!name.starts_with(prefix)) {
+			break;
+		}
+
+		const StringView member = name.substr(prefix.size());
+		if (mode == FileFinder::RECURSIVE) {
+			result.files[lcf::ReaderUtil::Normalize(ToString(member))] = ToString(member);
+			continue;
+		}
+
+		const size_t slash = member.find('/');
+		if (slash == StringView::npos) {
+			if (mode != FileFinder::DIRECTORIES) {
+				result.files[lcf::ReaderUtil::Normalize(ToString(member))] = ToString(member);
+			}
+		} else if (mode != FileFinder::FILES) {
+			const StringView dir = member.substr(0, slash);
+			result.directories[lcf::ReaderUtil::Normalize(ToString(dir))] = ToString(dir);
+		}
+	}
+
+	return result;
+}
+
+Filesystem_Stream::InputStream ZipFilesystem::OpenInputStream(StringView name) const {
+	const Entry* entry = FindEntry(name);
+	if (!entry) {
+		return Filesystem_Stream::InputStream();
+	}
+
+	if (entry->method != method_stored && entry->method != method_deflated) {
+		Output::Warning("ZipFilesystem: {}: Unsupported compression method {}", name, entry->method);
+		return Filesystem_Stream::InputStream();
+	}
+
+	Filesystem_Stream::InputStream file;
+	if (!mapping) {
+		file = FileFinder::OpenInputStream(path);
+		if (!file) {
+			return Filesystem_Stream::InputStream();
+		}
+	}
+
+	// The local header can have a different extra field than the central one
+	char header[local_header_size];
+	if (mapping) {
+		if (!ReadAt(entry->header_offset, header, sizeof(header))) {
+			return Filesystem_Stream::InputStream();
+		}
+	} else if (!file.seekg(entry->header_offset) || !file.read(header, sizeof(header))) {
+		return Filesystem_Stream::InputStream();
+	}
+	if (ReadLE32(header) != local_header_signature) {
+		Output::Warning("ZipFilesystem: {}: Corrupted entry", name);
+		return Filesystem_Stream::InputStream();
+	}
+
+	const uint64_t data_offset = static_cast<uint64_t>(entry->header_offset) + local_header_size +
+		ReadLE16(header + 26) + ReadLE16(header + 28);
+	if (data_offset + entry->compressed_size > static_cast<uint64_t>(file_size) ||
+			(entry->method == method_stored && entry->compressed_size != entry->size)) {
+		Output::Warning("ZipFilesystem: {}: Corrupted entry", name);
+		return Filesystem_Stream::InputStream();
+	}
+
+	if (mapping && entry->method == method_stored) {
+		return Filesystem_Stream::InputStream(new ZipSpanStreamBuf(shared_from_this(), mapping + data_offset, entry->size));
+	}
+
+	auto* buf = new ZipStreamBuf(shared_from_this(), std::move(file), data_offset,
+		entry->compressed_size, entry->size, entry->method == method_deflated);
+	if (!buf->IsValid()) {
+		delete buf;
+		return Filesystem_Stream::InputStream();
+	}
+	return Filesystem_Stream::InputStream(buf);
+}
@@ -0,0 +1,121 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_FILESYSTEM_ZIP_H
+#define EP_FILESYSTEM_ZIP_H
+
+// Headers
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "filefinder.h"
+#include "filesystem_stream.h"
+#include "platform.h"
+#include "string_view.h"
+
+/**
+ * Read-only access to the files of a ZIP archive.
+ *
+ * The central directory is read once into an index sorted by name. Where the
+ * platform supports it the archive is memory-mapped: stored entries are read
+ * from the mapping without copying, see InputStream::GetSpan, and deflated
+ * entries are inflated from it while reading. Otherwise every opened entry
+ * reads from its own file handle.
+ *
+ * Names are relative to the archive root and use '/' as separator.
+ */
+class ZipFilesystem : public std::enable_shared_from_this<ZipFilesystem> {
+public:
+	/**
+	 * Opens an archive.
+	 *
+	 * @param path path of the archive
+	 * @param encoding encoding of names not flagged as UTF-8, empty to keep them as is
+	 * @return archive or nullptr when path is not a supported ZIP archive
+	 */
+	static std::shared_ptr<ZipFilesystem> Open(std::string path, StringView encoding = {});
+
+	ZipFilesystem(const ZipFilesystem&) = delete;
+	ZipFilesystem& operator=(const ZipFilesystem&) = delete;
+
+	/** @return path of the archive */
+	const std::string& GetPath() const;
+
+	/** @return whether name is a file in the archive */
+	bool IsFile(StringView name) const;
+
+	/** @return whether name is a directory in the archive, the root is one */
+	bool IsDirectory(StringView name) const;
+
+	/** @return uncompressed size of the file or -1 when not found */
+	int64_t GetFileSize(StringView name) const;
+
+	/**
+	 * Lists a directory of the archive, see FileFinder::GetDirectoryMembers.
+	 *
+	 * @param path directory in the archive, empty for the root
+	 * @param mode member listing mode
+	 * @return members of the directory
+	 */
+	FileFinder::Directory GetDirectoryMembers(StringView path, FileFinder::Mode mode) const;
+
+	/**
+	 * Opens a file of the archive for reading.
+	 *
+	 * @param name file in the archive
+	 * @return stream, it keeps the archive open, or an empty stream on failure
+	 */
+	Filesystem_Stream::InputStream OpenInputStream(StringView name) const;
+
+private:
+	struct Entry {
+		uint32_t name_offset;
+		uint32_t name_size;
+		uint32_t compressed_size;
+		uint32_t size;
+		uint32_t header_offset;
+		uint16_t method;
+	};
+
+	ZipFilesystem() = default;
+
+	bool ReadCentralDirectory(StringView encoding);
+	bool ReadAt(uint64_t offset, void* dst, size_t size) const;
+	StringView GetName(const Entry& entry) const;
+	const Entry* FindEntry(StringView name) const;
+	std::vector<Entry>::const_iterator LowerBound(StringView name) const;
+
+	std::string path;
+	int64_t file_size = 0;
+	/** All entry names, entries point into it */
+	std::string names;
+	/** Sorted by name, directory entries are not included */
+	std::vector<Entry> entries;
+
+	std::unique_ptr<Platform::FileMapping> file_mapping;
+	/** Contents of the archive when it is mapped */
+	const char* mapping = nullptr;
+
+	friend class ZipStreamBuf;
+};
+
+inline const std::string& ZipFilesystem::GetPath() const {
+	return path;
+}
+
+#endif
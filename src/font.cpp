@@ -16,8 +16,11 @@
  */
 
 // Headers
+#include <algorithm>
+#include <list>
 #include <map>
 #include <type_traits>
+#include <unordered_map>
 #include <vector>
 #include <iterator>
 
@@ -34,6 +37,7 @@
 
 #include <lcf/reader_util.h>
 #include "bitmapfont.h"
+#include "bitmapfont_table.h"
 
 #include "filefinder.h"
 #include "output.h"
@@ -43,23 +47,33 @@
 #include "cache.h"
 #include "player.h"
 #include "compiler.h"
+#include "memory_stats.h"
 
 // Static variables.
 namespace {
-    template <typename T>
-	BitmapFontGlyph const* find_glyph(const T& glyphset, char32_t code) {
-		auto iter = std::lower_bound(std::begin(glyphset), std::end(glyphset), code);
-		if(iter != std::end(glyphset) && iter->code == code) {
-			return &*iter;
-		} else {
-			return NULL;
+	// Glyph lookup tables of the bitmap fonts
+	const BitmapFontTable gothic_table(SHINONOME_GOTHIC);
+	const BitmapFontTable mincho_table(SHINONOME_MINCHO);
+	const BitmapFontTable rmg2000_table(BITMAPFONT_RMG2000);
+	const BitmapFontTable ttyp0_table(BITMAPFONT_TTYP0);
+	const BitmapFontTable wqy_table(BITMAPFONT_WQY);
+
+	// Number of measured strings kept by every font
+	constexpr size_t size_cache_limit = 512;
+
+	// 32 bit FNV-1a
+	uint32_t hash_text(StringView txt) {
+		uint32_t hash = 2166136261u;
+		for (auto c : txt) {
+			hash = (hash ^ static_cast<uint8_t>(c)) * 16777619u;
 		}
+		return hash;
 	}
 
 	// This is the last-resort function for finding a glyph, all the other fonts should fallback on it.
 	// It tries to display a WenQuanYi glyph, and if it’s not found, returns a replacement glyph.
 	BitmapFontGlyph const* find_fallback_glyph(char32_t code) {
-		auto* wqy = find_glyph(BITMAPFONT_WQY, code);
+		auto* wqy = wqy_table.Find(code);
 		if (wqy != NULL) {
 			return wqy;
 		}
@@ -71,30 +85,113 @@ namespace {
 	}
 
 	BitmapFontGlyph const* find_gothic_glyph(char32_t code) {
-		auto* gothic = find_glyph(SHINONOME_GOTHIC, code);
+		auto* gothic = gothic_table.Find(code);
 		return gothic != NULL ? gothic : find_fallback_glyph(code);
 	}
 
 	BitmapFontGlyph const* find_mincho_glyph(char32_t code) {
-		auto* mincho = find_glyph(SHINONOME_MINCHO, code);
+		auto* mincho = mincho_table.Find(code);
 		return mincho == NULL ? find_gothic_glyph(code) : mincho;
 	}
 
 	BitmapFontGlyph const* find_rmg2000_glyph(char32_t code) {
-		auto* rmg2000 = find_glyph(BITMAPFONT_RMG2000, code);
+		auto* rmg2000 = rmg2000_table.Find(code);
 		if (rmg2000 != NULL) {
 			return rmg2000;
 		}
 
-		auto* ttyp0 = find_glyph(BITMAPFONT_TTYP0, code);
+		auto* ttyp0 = ttyp0_table.Find(code);
 		return ttyp0 != NULL ? ttyp0 : find_mincho_glyph(code);
 	}
 
 	BitmapFontGlyph const* find_ttyp0_glyph(char32_t code) {
-		auto* ttyp0 = find_glyph(BITMAPFONT_TTYP0, code);
+		auto* ttyp0 = ttyp0_table.Find(code);
 		return ttyp0 != NULL ? ttyp0 : find_gothic_glyph(code);
 	}
 
+	/**
+	 * Alpha bitmap caching rendered glyphs in cells of equal size.
+	 * When all cells are in use the least recently used glyph is replaced.
+	 */
+	class GlyphAtlas {
+	public:
+		using Key = uint64_t;
+
+		/**
+		 * @param cell_width initial width of the cells
+		 * @param cell_height initial height of the cells
+		 */
+		GlyphAtlas(int cell_width, int cell_height);
+
+		~GlyphAtlas();
+
+		GlyphAtlas(const GlyphAtlas&) = delete;
+		GlyphAtlas& operator=(const GlyphAtlas&) = delete;
+
+		/**
+		 * @param font font rendering the glyph
+		 * @param code utf32 glyph
+		 * @return key of the glyph, depends on the font size and style
+		 */
+		static Key MakeKey(const Font& font, char32_t code);
+
+		/**
+		 * Looks up a cached glyph.
+		 *
+		 * @param key glyph key
+		 * @param ret filled with the atlas and the glyph rect when found
+		 * @return whether the glyph is cached
+		 */
+		bool Find(Key key, Font::GlyphRet& ret);
+
+		/**
+		 * Reserves space for a glyph. The caller must write all pixels of the
+		 * returned rect, they contain an older glyph.
+		 *
+		 * @param key glyph key
+		 * @param width glyph width
+		 * @param height glyph height
+		 * @return atlas and the rect to render the glyph into
+		 */
+		Font::GlyphRet Insert(Key key, int width, int height);
+
+		/**
+		 * @return the atlas bitmap, created on first use
+		 */
+		const BitmapRef& GetBitmap();
+
+		/** Frees the bitmap and forgets all glyphs, unless the bitmap is in use */
+		void Trim();
+
+	private:
+		static constexpr int cells_per_row = 32;
+		static constexpr int cell_rows = 16;
+
+		void ResetBitmap();
+
+		struct Entry {
+			Rect rect;
+			std::list<Key>::iterator lru_it;
+		};
+
+		BitmapRef bitmap;
+		int cell_width = 0;
+		int cell_height = 0;
+		int used_cells = 0;
+		std::unordered_map<Key, Entry> entries;
+		/** Keys by last use, most recent first */
+		std::list<Key> lru;
+	};
+
+	constexpr int GlyphAtlas::cells_per_row;
+	constexpr int GlyphAtlas::cell_rows;
+
+	/** @return all glyph atlases, for Font::TrimGlyphCaches. Never destroyed, fonts can outlive the statics */
+	std::vector<GlyphAtlas*>& GetAtlases() {
+		static auto* atlases = new std::vector<GlyphAtlas*>();
+		return *atlases;
+	}
+
 	struct BitmapFont : public Font {
 		enum { HEIGHT = 12, FULL_WIDTH = HEIGHT, HALF_WIDTH = FULL_WIDTH / 2 };
 
@@ -102,14 +199,17 @@ namespace {
 
 		BitmapFont(const std::string& name, function_type func);
 
-		Rect GetSize(StringView txt) const override;
+		using Font::GetSize;
 		Rect GetSize(char32_t ch) const override;
 
 		GlyphRet Glyph(char32_t code) override;
 
+	protected:
+		Rect vGetSize(StringView txt) const override;
+
 	private:
 		function_type func;
-		BitmapRef glyph_bm;
+		GlyphAtlas atlas;
 	}; // class BitmapFont
 
 #ifdef HAVE_FREETYPE
@@ -131,17 +231,21 @@ namespace {
 	struct FTFont : public Font  {
 		FTFont(const std::string& name, int size, bool bold, bool italic);
 
-		Rect GetSize(StringView txt) const override;
+		using Font::GetSize;
 		Rect GetSize(char32_t ch) const override;
 
 		GlyphRet Glyph(char32_t code) override;
 
+	protected:
+		Rect vGetSize(StringView txt) const override;
+
 	private:
 		static std::weak_ptr<std::remove_pointer<FT_Library>::type> library_checker_;
 		std::shared_ptr<std::remove_pointer<FT_Library>::type> library_;
 		std::shared_ptr<std::remove_pointer<FT_Face>::type> face_;
 		std::string face_name_;
 		unsigned current_size_;
+		GlyphAtlas atlas_;
 
 		bool check_face();
 	}; // class FTFont
@@ -166,16 +270,100 @@ namespace {
 		public:
 			enum { HEIGHT = 12, WIDTH = 12 };
 			ExFont();
-			Rect GetSize(StringView txt) const override;
+			using Font::GetSize;
 			Rect GetSize(char32_t ch) const override;
 			GlyphRet Glyph(char32_t code) override;
-		private:
-			BitmapRef bm;
+		protected:
+			Rect vGetSize(StringView txt) const override;
 	};
 } // anonymous namespace
 
+GlyphAtlas::GlyphAtlas(int cell_width, int cell_height)
+	: cell_width(cell_width), cell_height(cell_height)
+{
+	GetAtlases().push_back(this);
+}
+
+GlyphAtlas::~GlyphAtlas() {
+	ResetBitmap();
+	auto& atlases = GetAtlases();
+	atlases.erase(std::remove(atlases.begin(), atlases.end(), this), atlases.end());
+}
+
+void GlyphAtlas::ResetBitmap() {
+	if (bitmap) {
+		MemoryStats::Add(MemoryStats::Category::Font, -static_cast<int64_t>(bitmap->pitch()) * bitmap->GetHeight());
+		bitmap.reset();
+	}
+}
+
+GlyphAtlas::Key GlyphAtlas::MakeKey(const Font& font, char32_t code) {
+	return static_cast<Key>(code)
+		| (static_cast<Key>(font.size & 0xFFFF) << 32)
+		| (static_cast<Key>(font.bold) << 48)
+		| (static_cast<Key>(font.italic) << 49);
+}
+
+bool GlyphAtlas::Find(Key key, Font::GlyphRet& ret) {
+	auto it = entries.find(key);
+	if (it == entries.end()) {
+		return false;
+	}
+
+	lru.splice(lru.begin(), lru, it->second.lru_it);
+	ret = { bitmap, it->second.rect };
+	return true;
+}
+
+Font::GlyphRet GlyphAtlas::Insert(Key key, int width, int height) {
+	if (!bitmap || width > cell_width || height > cell_height) {
+		// Larger glyph than all before, start over with bigger cells
+		cell_width = std::max(cell_width, (width + 3) & ~3);
+		cell_height = std::max(cell_height, (height + 3) & ~3);
+		ResetBitmap();
+		entries.clear();
+		lru.clear();
+		used_cells = 0;
+	}
+
+	int cell;
+	if (used_cells < cells_per_row * cell_rows) {
+		cell = used_cells++;
+	} else {
+		auto it = entries.find(lru.back());
+		cell = (it->second.rect.y / cell_height) * cells_per_row + it->second.rect.x / cell_width;
+		lru.pop_back();
+		entries.erase(it);
+	}
+
+	Rect rect((cell % cells_per_row) * cell_width, (cell / cells_per_row) * cell_height, width, height);
+	lru.push_front(key);
+	entries[key] = { rect, lru.begin() };
+
+	return { GetBitmap(), rect };
+}
+
+const BitmapRef& GlyphAtlas::GetBitmap() {
+	if (EP_UNLIKELY(!bitmap)) {
+		bitmap = Bitmap::Create(nullptr, std::max(cell_width, 1) * cells_per_row, std::max(cell_height, 1) * cell_rows,
+			0, DynamicFormat(8,8,0,8,0,8,0,8,0,PF::Alpha));
+		MemoryStats::Add(MemoryStats::Category::Font, static_cast<int64_t>(bitmap->pitch()) * bitmap->GetHeight());
+	}
+	return bitmap;
+}
+
+void GlyphAtlas::Trim() {
+	if (!bitmap || bitmap.use_count() > 1) {
+		return;
+	}
+	ResetBitmap();
+	entries.clear();
+	lru.clear();
+	used_cells = 0;
+}
+
 BitmapFont::BitmapFont(const std::string& name, function_type func)
-	: Font(name, HEIGHT, false, false), func(func)
+	: Font(name, HEIGHT, false, false), func(func), atlas(FULL_WIDTH, HEIGHT)
 {}
 
 Rect BitmapFont::GetSize(char32_t ch) const {
@@ -187,7 +375,7 @@ Rect BitmapFont::GetSize(char32_t ch) const {
 	return Rect(0, 0, units * HALF_WIDTH, HEIGHT);
 }
 
-Rect BitmapFont::GetSize(StringView txt) const {
+Rect BitmapFont::vGetSize(StringView txt) const {
 	size_t units = 0;
 	const auto* iter = txt.data();
 	const auto* end = txt.data() + txt.size();
@@ -204,32 +392,36 @@ Rect BitmapFont::GetSize(StringView txt) const {
 }
 
 Font::GlyphRet BitmapFont::Glyph(char32_t code) {
-	if (EP_UNLIKELY(!glyph_bm)) {
-		glyph_bm = Bitmap::Create(nullptr, FULL_WIDTH, HEIGHT, 0, DynamicFormat(8,8,0,8,0,8,0,8,0,PF::Alpha));
-	}
 	if (EP_UNLIKELY(Utils::IsControlCharacter(code))) {
-		return { glyph_bm, Rect(0, 0, 0, HEIGHT) };
+		return { atlas.GetBitmap(), Rect(0, 0, 0, HEIGHT) };
+	}
+
+	const auto key = GlyphAtlas::MakeKey(*this, code);
+	GlyphRet ret;
+	if (atlas.Find(key, ret)) {
+		return ret;
 	}
+
 	auto glyph = func(code);
 	auto width = glyph->is_full? FULL_WIDTH : HALF_WIDTH;
 
-	glyph_bm->Clear();
-	uint8_t* data = reinterpret_cast<uint8_t*>(glyph_bm->pixels());
-	int pitch = glyph_bm->pitch();
+	ret = atlas.Insert(key, width, HEIGHT);
+	uint8_t* data = reinterpret_cast<uint8_t*>(ret.bitmap->pixels()) + ret.rect.y * ret.bitmap->pitch() + ret.rect.x;
+	int pitch = ret.bitmap->pitch();
 	for(size_t y_ = 0; y_ < HEIGHT; ++y_)
 		for(size_t x_ = 0; x_ < width; ++x_)
 			data[y_*pitch+x_] = (glyph->data[y_] & (0x1 << x_)) ? 255 : 0;
 
-	return { glyph_bm, Rect(0, 0, width, HEIGHT) };
+	return ret;
 }
 
 #ifdef HAVE_FREETYPE
 std::weak_ptr<std::remove_pointer<FT_Library>::type> FTFont::library_checker_;
 
 FTFont::FTFont(const std::string& name, int size, bool bold, bool italic)
-	: Font(name, size, bold, italic), current_size_(0) {}
+	: Font(name, size, bold, italic), current_size_(0), atlas_(0, 0) {}
 
-Rect FTFont::GetSize(StringView txt) const {
+Rect FTFont::vGetSize(StringView txt) const {
 	int const s = Font::Default()->GetSize(txt).width;
 
 	if (s == -1) {
@@ -260,6 +452,12 @@ Font::GlyphRet FTFont::Glyph(char32_t glyph) {
 		return Font::Default()->Glyph(glyph);
 	}
 
+	const auto key = GlyphAtlas::MakeKey(*this, glyph);
+	GlyphRet ret;
+	if (atlas_.Find(key, ret)) {
+		return ret;
+	}
+
 	if (FT_Load_Char(face_.get(), glyph, FT_LOAD_NO_BITMAP) != FT_Err_Ok) {
 		Output::Error("Couldn't load FreeType character {:#x}", uint32_t(glyph));
 	}
@@ -275,9 +473,9 @@ Font::GlyphRet FTFont::Glyph(char32_t glyph) {
 	int const width = ft_bitmap.width;
 	int const height = ft_bitmap.rows;
 
-	BitmapRef bm = Bitmap::Create(nullptr, width, height, 0, DynamicFormat(8,8,0,8,0,8,0,8,0,PF::Alpha));
-	uint8_t* data = reinterpret_cast<uint8_t*>(bm->pixels());
-	int dst_pitch = bm->pitch();
+	ret = atlas_.Insert(key, width, height);
+	int dst_pitch = ret.bitmap->pitch();
+	uint8_t* data = reinterpret_cast<uint8_t*>(ret.bitmap->pixels()) + ret.rect.y * dst_pitch + ret.rect.x;
 
 	for(int row = 0; row < height; ++row) {
 		for(int col = 0; col < width; ++col) {
@@ -287,7 +485,7 @@ Font::GlyphRet FTFont::Glyph(char32_t glyph) {
 		}
 	}
 
-	return { bm, Rect(0, 0, width, height) };
+	return ret;
 }
 
 bool FTFont::check_face() {
@@ -389,6 +587,12 @@ void Font::Dispose() {
 #endif
 }
 
+void Font::TrimGlyphCaches() {
+	for (auto* atlas: GetAtlases()) {
+		atlas->Trim();
+	}
+}
+
 // Constructor.
 Font::Font(const std::string& name, int size, bool bold, bool italic)
 	: name(name)
@@ -398,6 +602,27 @@ Font::Font(const std::string& name, int size, bool bold, bool italic)
 {
 }
 
+Rect Font::GetSize(StringView txt) const {
+	const auto key = hash_text(txt);
+	auto it = size_cache.find(key);
+	if (it != size_cache.end() && StringView(it->second.text) == txt) {
+		return it->second.size;
+	}
+
+	auto size = vGetSize(txt);
+	if (it != size_cache.end()) {
+		// Hash collision, the newer string replaces the older one
+		it->second = { ToString(txt), size };
+		return size;
+	}
+
+	if (size_cache.size() >= size_cache_limit) {
+		size_cache.clear();
+	}
+	size_cache.emplace(key, SizeCacheEntry{ ToString(txt), size });
+	return size;
+}
+
 Rect Font::Render(Bitmap& dest, int const x, int const y, const Bitmap& sys, int color, char32_t code) {
 	auto gret = Glyph(code);
 
@@ -408,15 +633,15 @@ Rect Font::Render(Bitmap& dest, int const x, int const y, const Bitmap& sys, int
 
 	if(color != ColorShadow) {
 		auto shadow_rect = Rect(x + 1, y + 1, rect.width, rect.height);
-		dest.MaskedBlit(shadow_rect, *gret.bitmap, 0, 0, sys, 16, 32);
+		dest.MaskedBlit(shadow_rect, *gret.bitmap, gret.rect.x, gret.rect.y, sys, 16, 32);
 	}
 
 	unsigned const
 		src_x = color == ColorShadow? 16 : color % 10 * 16 + 2,
-		src_y = color == ColorShadow? 32 : color / 10 * 16 + 48 + 16 - gret.bitmap->height();
+		src_y = color == ColorShadow? 32 : color / 10 * 16 + 48 + 16 - gret.rect.height;
 
 
-	dest.MaskedBlit(rect, *gret.bitmap, 0, 0, sys, src_x, src_y);
+	dest.MaskedBlit(rect, *gret.bitmap, gret.rect.x, gret.rect.y, sys, src_x, src_y);
 
 	return rect;
 }
@@ -425,7 +650,7 @@ Rect Font::Render(Bitmap& dest, int x, int y, Color const& color, char32_t code)
 	auto gret = Glyph(code);
 
 	auto rect = Rect(x, y, gret.rect.width, gret.rect.height);
-	dest.MaskedBlit(rect, *gret.bitmap, 0, 0, color);
+	dest.MaskedBlit(rect, *gret.bitmap, gret.rect.x, gret.rect.y, color);
 
 	return rect;
 }
@@ -436,16 +661,12 @@ ExFont::ExFont() : Font("exfont", 12, false, false) {
 FontRef Font::exfont = std::make_shared<ExFont>();
 
 Font::GlyphRet ExFont::Glyph(char32_t code) {
-	if (EP_UNLIKELY(!bm)) { bm = Bitmap::Create(WIDTH, HEIGHT, true); }
-	auto exfont = Cache::Exfont();
-
+	// The glyphs are used directly from the cached exfont image
 	Rect const rect((code % 13) * WIDTH, (code / 13) * HEIGHT, WIDTH, HEIGHT);
-	bm->Clear();
-	bm->Blit(0, 0, *exfont, rect, Opacity::Opaque());
-	return { bm, Rect(0, 0, WIDTH, HEIGHT) };
+	return { Cache::Exfont(), rect };
 }
 
-Rect ExFont::GetSize(StringView) const {
+Rect ExFont::vGetSize(StringView) const {
 	return Rect(0, 0, 12, 12);
 }
 
@@ -23,7 +23,9 @@
 #include "memory_management.h"
 #include "rect.h"
 #include "string_view.h"
+#include <cstdint>
 #include <string>
+#include <unordered_map>
 
 class Color;
 class Rect;
@@ -37,11 +39,12 @@ class Font {
 
 	/**
 	 * Returns the size of the rendered string, not including shadows.
+	 * Sizes of recently measured strings are cached.
 	 *
 	 * @param txt the string to measure
 	 * @return Rect describing the rendered string boundary
 	 */
-	virtual Rect GetSize(StringView txt) const = 0;
+	Rect GetSize(StringView txt) const;
 	/**
 	 * Returns the size of the rendered utf32 character, not including shadows.
 	 *
@@ -93,11 +96,52 @@ class Font {
 	 */
 	Rect Render(Bitmap& dest, int x, int y, Color const& color, char32_t glyph);
 
+	/**
+	 * Measures a text that is assembled piece by piece.
+	 * Glyph widths add up, so appending a piece only measures that piece.
+	 */
+	class TextWidth {
+	public:
+		explicit TextWidth(const Font& font) : font(font) {}
+
+		/** @return width of the text so far with txt appended */
+		int Peek(StringView txt) const {
+			return width + font.GetSize(txt).width;
+		}
+
+		/**
+		 * Appends txt to the measured text.
+		 *
+		 * @return width of the text so far
+		 */
+		int Append(StringView txt) {
+			width = Peek(txt);
+			return width;
+		}
+
+		/** @return width of the text so far */
+		int Get() const {
+			return width;
+		}
+
+		/** Starts measuring a new text */
+		void Reset() {
+			width = 0;
+		}
+
+	private:
+		const Font& font;
+		int width = 0;
+	};
+
 	static FontRef Create(const std::string& name, int size, bool bold, bool italic);
 	static FontRef Default();
 	static FontRef Default(bool mincho);
 	static void Dispose();
 
+	/** Frees the rendered glyphs of all fonts, they are rendered again on use. Used on low memory. */
+	static void TrimGlyphCaches();
+
 	static FontRef exfont;
 
 	static const int default_size = 9;
@@ -121,6 +165,23 @@ class Font {
 	size_t pixel_size() const { return size * 96 / 72; }
  protected:
 	Font(const std::string& name, int size, bool bold, bool italic);
+
+	/**
+	 * Measures the rendered string, called by GetSize when it is not cached.
+	 *
+	 * @param txt the string to measure
+	 * @return Rect describing the rendered string boundary
+	 */
+	virtual Rect vGetSize(StringView txt) const = 0;
+
+ private:
+	struct SizeCacheEntry {
+		std::string text;
+		Rect size;
+	};
+
+	/** Measured strings by hash, cleared when it grows beyond size_cache_limit */
+	mutable std::unordered_map<uint32_t, SizeCacheEntry> size_cache;
 };
 
 #endif
@@ -15,6 +15,7 @@
  * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
 #include <sstream>
 
 #include "fps_overlay.h"
@@ -24,6 +25,8 @@
 #include "input.h"
 #include "font.h"
 #include "drawable_mgr.h"
+#include "cache.h"
+#include <fmt/core.h>
 
 using namespace std::chrono_literals;
 
@@ -41,6 +44,63 @@ void FpsOverlay::UpdateText() {
 	auto fps = Utils::RoundTo<int>(Game_Clock::GetFPS());
 	text = "FPS: " + std::to_string(fps);
 	fps_dirty = true;
+
+	UpdateStatsText();
+}
+
+void FpsOverlay::UpdateStatsText() {
+	if (!draw_stats) {
+		stats_text.clear();
+		return;
+	}
+
+	const int frame = Game_Clock::GetFrame();
+	const int frames = std::max(frame - last_stats_frame, 1);
+	last_stats_frame = frame;
+
+	// Average milliseconds per frame since the last refresh
+	std::array<double, static_cast<size_t>(FrameStats::Phase::END)> ms;
+	for (size_t i = 0; i < ms.size(); ++i) {
+		const auto total = FrameStats::GetTotal(static_cast<FrameStats::Phase>(i));
+		ms[i] = std::chrono::duration<double, std::milli>(total - last_totals[i]).count() / frames;
+		last_totals[i] = total;
+	}
+
+	auto phase_text = [&](FrameStats::Phase phase) {
+		return fmt::format("{} {:.2f}", FrameStats::GetName(phase), ms[static_cast<size_t>(phase)]);
+	};
+
+	// Interpreters which ran out of their frame budget since the last refresh
+	const auto yields = FrameStats::GetInterpreterYields();
+	std::string yield_text;
+	if (yields != last_interpreter_yields) {
+		yield_text = fmt::format(" Yield {}", yields - last_interpreter_yields);
+		last_interpreter_yields = yields;
+	}
+
+	// Mean input to present latency of the changes since the last refresh
+	const auto latency = FrameStats::GetInputLatencyTotal();
+	const auto latency_count = FrameStats::GetInputLatencyCount();
+	std::string latency_text;
+	if (latency_count != last_input_latency_count) {
+		latency_text = fmt::format(" Lat {:.1f}", std::chrono::duration<double, std::milli>(latency - last_input_latency).count() / (latency_count - last_input_latency_count));
+		last_input_latency = latency;
+		last_input_latency_count = latency_count;
+	}
+
+	const auto cache = Cache::GetStats();
+	stats_text = {
+		phase_text(FrameStats::Phase::Input) + " " + phase_text(FrameStats::Phase::Update) + " " + phase_text(FrameStats::Phase::Interpreter) + yield_text,
+		phase_text(FrameStats::Phase::Draw) + " " + phase_text(FrameStats::Phase::Display) + " " + phase_text(FrameStats::Phase::Audio) + latency_text,
+		fmt::format("Cache {}/{} {:.1f} MiB", cache.hits, cache.misses, cache.bytes / 1024.0 / 1024.0)
+	};
+	stats_dirty = true;
+}
+
+int FpsOverlay::GetHeight() const {
+	// Both indicators are drawn in a strip at the top of the screen, the breakdown below
+	const int line_height = Font::Default()->GetSize(text).height;
+	return line_height + 2 + static_cast<int>(stats_text.size()) * line_height;
 }
 
 bool FpsOverlay::Update() {
@@ -62,6 +122,28 @@ bool FpsOverlay::Update() {
 	return true;
 }
 
+Rect FpsOverlay::GetDamage(const Rect& screen_rect) {
+	if (composited && composited_draw_fps == draw_fps && composited_speed_mod == last_speed_mod
+			&& (!draw_fps || composited_text == text) && composited_stats_text == stats_text) {
+		return Rect();
+	}
+
+	// The breakdown may have had more lines when it was composited
+	int height = GetHeight();
+	if (composited_stats_text.size() > stats_text.size()) {
+		height += static_cast<int>(composited_stats_text.size() - stats_text.size()) * Font::Default()->GetSize(text).height;
+	}
+	return Rect(screen_rect.x, screen_rect.y, screen_rect.width, height);
+}
+
+void FpsOverlay::OnComposited() {
+	composited_text = text;
+	composited_stats_text = stats_text;
+	composited_speed_mod = last_speed_mod;
+	composited_draw_fps = draw_fps;
+	composited = true;
+}
+
 void FpsOverlay::Draw(Bitmap& dst) {
 	if (draw_fps) {
 		if (fps_dirty) {
@@ -84,6 +166,31 @@ void FpsOverlay::Draw(Bitmap& dst) {
 		dst.Blit(1, 2, *fps_bitmap, fps_rect, 255);
 	}
 
+	if (!stats_text.empty()) {
+		if (stats_dirty) {
+			const int line_height = Font::Default()->GetSize(text).height;
+			int width = 0;
+			for (auto& line: stats_text) {
+				width = std::max(width, Font::Default()->GetSize(line).width);
+			}
+			const int height = line_height * static_cast<int>(stats_text.size());
+
+			if (!stats_bitmap || stats_bitmap->GetWidth() < width + 1 || stats_bitmap->GetHeight() < height) {
+				stats_bitmap = Bitmap::Create(width + 1, height, true);
+			}
+			stats_bitmap->Clear();
+			stats_rect = Rect(0, 0, width + 1, height);
+			stats_bitmap->FillRect(stats_rect, Color(0, 0, 0, 128));
+			for (size_t i = 0; i < stats_text.size(); ++i) {
+				stats_bitmap->TextDraw(1, static_cast<int>(i) * line_height, Color(255, 255, 255, 255), stats_text[i]);
+			}
+
+			stats_dirty = false;
+		}
+
+		dst.Blit(1, 2 + Font::Default()->GetSize(text).height, *stats_bitmap, stats_rect, 255);
+	}
+
 	// Always drawn when speedup is on independent of FPS
 	if (last_speed_mod > 1) {
 		if (speedup_dirty) {
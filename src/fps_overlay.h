@@ -18,16 +18,20 @@
 #ifndef EP_FPS_OVERLAY_H
 #define EP_FPS_OVERLAY_H
 
+#include <array>
 #include <deque>
 #include <string>
+#include <vector>
 #include "drawable.h"
 #include "memory_management.h"
 #include "rect.h"
 #include "game_clock.h"
+#include "frame_stats.h"
 
 /**
  * FpsOverlay class.
- * Shows current FPS and the speedup indicator.
+ * Shows current FPS, the speedup indicator and optionally the time spent
+ * in each part of a frame.
  */
 class FpsOverlay : public Drawable {
 public:
@@ -35,6 +39,9 @@ public:
 
 	void Draw(Bitmap& dst) override;
 
+	Rect GetDamage(const Rect& screen_rect) override;
+	void OnComposited() override;
+
 	/**
 	 * Update the fps overlay.
 	 *
@@ -56,23 +63,52 @@ public:
 	 */
 	void SetDrawFps(bool value);
 
+	/**
+	 * Set whether we will render the frame time breakdown below the fps.
+	 *
+	 * @param value true if we want to draw to screen
+	 */
+	void SetDrawFrameStats(bool value);
+
 private:
 	void UpdateText();
+	void UpdateStatsText();
+	int GetHeight() const;
 
 	BitmapRef fps_bitmap;
 	BitmapRef speedup_bitmap;
+	BitmapRef stats_bitmap;
 	Game_Clock::time_point last_refresh_time;
 
 	/** Rect to draw on screen */
 	Rect fps_rect;
 	Rect speedup_rect;
+	Rect stats_rect;
 
 	std::string text;
+	/** Lines of the frame time breakdown, empty when not shown */
+	std::vector<std::string> stats_text;
+
+	/** Totals at the last refresh, the breakdown shows the average since then */
+	std::array<Game_Clock::duration, static_cast<size_t>(FrameStats::Phase::END)> last_totals = {};
+	int last_stats_frame = 0;
+	int64_t last_interpreter_yields = 0;
+	Game_Clock::duration last_input_latency = {};
+	int64_t last_input_latency_count = 0;
 
 	int last_speed_mod = 1;
 	bool speedup_dirty = true;
 	bool fps_dirty = true;
+	bool stats_dirty = true;
 	bool draw_fps = true;
+	bool draw_stats = false;
+
+	/** State of the last composited frame, the overlay is redrawn when it differs */
+	std::string composited_text;
+	std::vector<std::string> composited_stats_text;
+	int composited_speed_mod = 1;
+	bool composited_draw_fps = false;
+	bool composited = false;
 };
 
 inline std::string FpsOverlay::GetFpsString() const {
@@ -83,4 +119,8 @@ inline void FpsOverlay::SetDrawFps(bool value) {
 	draw_fps = value;
 }
 
+inline void FpsOverlay::SetDrawFrameStats(bool value) {
+	draw_stats = value;
+}
+
 #endif
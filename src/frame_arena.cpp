@@ -0,0 +1,148 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+// Headers
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#ifdef HAVE_THREADS
+#  include <thread>
+#endif
+#include "frame_arena.h"
+
+namespace {
+	/** Size of the first block, enough for the frames of most games */
+	constexpr size_t min_block_size = 64 * 1024;
+
+	struct Block {
+		std::unique_ptr<char[]> data;
+		size_t size = 0;
+	};
+
+	/** Blocks of this frame, allocations come from the last one */
+	std::vector<Block> blocks;
+	size_t offset = 0;
+	/** Start of the last allocation, for Deallocate of it */
+	size_t last_offset = 0;
+	/** Bytes allocated and not freed, nothing may be alive on Reset */
+	size_t live_bytes = 0;
+	/** Bytes of the full blocks of this frame */
+	size_t retired_bytes = 0;
+	FrameArena::Stats stats;
+
+#ifdef HAVE_THREADS
+	/** Static initialization runs on the main thread */
+	const std::thread::id owner = std::this_thread::get_id();
+
+	bool IsOwner() {
+		return std::this_thread::get_id() == owner;
+	}
+#else
+	constexpr bool IsOwner() {
+		return true;
+	}
+#endif
+
+	void AddBlock(size_t bytes) {
+		Block block;
+		block.size = std::max(bytes, min_block_size);
+		block.data.reset(new char[block.size]);
+		stats.capacity += block.size;
+		blocks.push_back(std::move(block));
+	}
+
+	bool InBlocks(const char* p) {
+		for (auto& block: blocks) {
+			if (p >= block.data.get() && p < block.data.get() + block.size) {
+				return true;
+			}
+		}
+		return false;
+	}
+}
+
+void* FrameArena::Allocate(size_t bytes, size_t align) {
+	if (!IsOwner()) {
+		++stats.heap_allocations;
+		return ::operator new(bytes);
+	}
+
+	// Blocks are aligned for any type, offsets only need the alignment
+	assert(align <= alignof(std::max_align_t));
+	bytes = std::max<size_t>(bytes, 1);
+
+	size_t start = (offset + align - 1) & ~(align - 1);
+	if (blocks.empty() || start + bytes > blocks.back().size) {
+		retired_bytes += offset;
+		AddBlock(blocks.empty() ? bytes : std::max(bytes, blocks.back().size * 2));
+		start = 0;
+	}
+
+	last_offset = start;
+	offset = start + bytes;
+	live_bytes += bytes;
+	++stats.allocations;
+	stats.bytes = retired_bytes + offset;
+	stats.peak_bytes = std::max(stats.peak_bytes, stats.bytes);
+	return blocks.back().data.get() + start;
+}
+
+void FrameArena::Deallocate(void* data, size_t bytes) {
+	auto* p = static_cast<char*>(data);
+	if (!p) {
+		return;
+	}
+
+	if (!IsOwner() || !InBlocks(p)) {
+		::operator delete(data);
+		return;
+	}
+
+	bytes = std::max<size_t>(bytes, 1);
+	assert(live_bytes >= bytes);
+	live_bytes -= bytes;
+	if (p == blocks.back().data.get() + last_offset && last_offset + bytes == offset) {
+		offset = last_offset;
+		stats.bytes = retired_bytes + offset;
+	}
+}
+
+void FrameArena::Reset() {
+	assert(live_bytes == 0 && "Frame arena memory used beyond its frame");
+
+	if (blocks.size() > 1) {
+		// One block for everything the frame needed
+		const size_t size = stats.capacity;
+		blocks.clear();
+		stats.capacity = 0;
+		AddBlock(size);
+	}
+
+	offset = 0;
+	last_offset = 0;
+	live_bytes = 0;
+	retired_bytes = 0;
+	stats.allocations = 0;
+	stats.bytes = 0;
+}
+
+FrameArena::Stats FrameArena::GetStats() {
+	return stats;
+}
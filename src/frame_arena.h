@@ -0,0 +1,113 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef EP_FRAME_ARENA_H
+#define EP_FRAME_ARENA_H
+
+// Headers
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * Bump allocator for memory that lives at most until the end of the frame.
+ * Short lived containers of the per frame logic draw from it instead of
+ * the heap. All memory is released at once by Reset at the end of the frame
+ * and the arena keeps its storage, so steady frames do not allocate at all.
+ *
+ * Only the main thread uses the arena, allocations of other threads go to
+ * the heap. Memory of the arena must be freed on the main thread.
+ */
+namespace FrameArena {
+	/** Counters of the current frame and peaks since startup */
+	struct Stats {
+		/** Allocations served by the arena in this frame */
+		size_t allocations = 0;
+		/** Bytes in use in this frame */
+		size_t bytes = 0;
+		/** Most bytes used by any frame */
+		size_t peak_bytes = 0;
+		/** Size of the arena storage */
+		size_t capacity = 0;
+		/** Allocations of other threads, since startup */
+		size_t heap_allocations = 0;
+	};
+
+	/**
+	 * Allocates memory valid until the next Reset.
+	 *
+	 * @param bytes size
+	 * @param align alignment, a power of two
+	 * @return memory, never nullptr
+	 */
+	void* Allocate(size_t bytes, size_t align);
+
+	/**
+	 * Frees memory of Allocate. The last allocation is reclaimed immediately,
+	 * which lets growing vectors reuse their space.
+	 *
+	 * @param data memory
+	 * @param bytes size which was allocated
+	 */
+	void Deallocate(void* data, size_t bytes);
+
+	/**
+	 * Releases all memory of the frame. Nothing allocated in the frame may
+	 * be alive anymore.
+	 * When the frame needed more than one block, they are merged into one
+	 * for the following frames.
+	 */
+	void Reset();
+
+	/** @return counters of the arena */
+	Stats GetStats();
+
+	/** STL allocator drawing from the arena */
+	template <typename T>
+	class Allocator {
+	public:
+		using value_type = T;
+
+		Allocator() noexcept = default;
+		template <typename U>
+		Allocator(const Allocator<U>&) noexcept {}
+
+		T* allocate(size_t n) {
+			return static_cast<T*>(Allocate(n * sizeof(T), alignof(T)));
+		}
+
+		void deallocate(T* p, size_t n) noexcept {
+			Deallocate(p, n * sizeof(T));
+		}
+	};
+
+	template <typename T, typename U>
+	bool operator==(const Allocator<T>&, const Allocator<U>&) noexcept { return true; }
+
+	template <typename T, typename U>
+	bool operator!=(const Allocator<T>&, const Allocator<U>&) noexcept { return false; }
+
+	/** Vector for the duration of a frame */
+	template <typename T>
+	using Vector = std::vector<T, Allocator<T>>;
+
+	/** String for the duration of a frame */
+	using String = std::basic_string<char, std::char_traits<char>, Allocator<char>>;
+}
+
+#endif
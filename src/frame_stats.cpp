@@ -0,0 +1,110 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include "frame_stats.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace {
+	constexpr auto num_phases = static_cast<size_t>(FrameStats::Phase::END);
+
+	constexpr std::array<const char*, num_phases> phase_names = {{
+		"Input",
+		"Update",
+		"Interp",
+		"Draw",
+		"Display",
+		"Audio"
+	}};
+
+	std::atomic<bool> enabled(false);
+	/** Ticks of Game_Clock::duration per phase */
+	std::array<std::atomic<int64_t>, num_phases> totals = {};
+	std::atomic<int64_t> interpreter_yields(0);
+
+	// Input latency, only touched by the main thread
+	bool input_pending = false;
+	Game_Clock::time_point input_pending_time;
+	bool input_drawn = false;
+	Game_Clock::time_point input_drawn_time;
+	Game_Clock::duration input_latency_total = {};
+	int64_t input_latency_count = 0;
+}
+
+const char* FrameStats::GetName(Phase phase) {
+	return phase_names[static_cast<size_t>(phase)];
+}
+
+bool FrameStats::IsEnabled() {
+	return enabled.load(std::memory_order_relaxed);
+}
+
+void FrameStats::SetEnabled(bool value) {
+	enabled.store(value, std::memory_order_relaxed);
+}
+
+void FrameStats::Add(Phase phase, Game_Clock::duration dt) {
+	totals[static_cast<size_t>(phase)].fetch_add(static_cast<int64_t>(dt.count()), std::memory_order_relaxed);
+}
+
+Game_Clock::duration FrameStats::GetTotal(Phase phase) {
+	return Game_Clock::duration(static_cast<Game_Clock::rep>(totals[static_cast<size_t>(phase)].load(std::memory_order_relaxed)));
+}
+
+void FrameStats::AddInterpreterYield() {
+	interpreter_yields.fetch_add(1, std::memory_order_relaxed);
+}
+
+int64_t FrameStats::GetInterpreterYields() {
+	return interpreter_yields.load(std::memory_order_relaxed);
+}
+
+void FrameStats::MarkInputChange(Game_Clock::time_point sampled) {
+	if (!IsEnabled() || input_pending) {
+		return;
+	}
+	input_pending = true;
+	input_pending_time = sampled;
+}
+
+void FrameStats::OnFrameDrawn() {
+	if (!input_pending || input_drawn) {
+		return;
+	}
+	input_pending = false;
+	input_drawn = true;
+	input_drawn_time = input_pending_time;
+}
+
+void FrameStats::OnFramePresented(Game_Clock::time_point now) {
+	if (!input_drawn) {
+		return;
+	}
+	input_drawn = false;
+	input_latency_total += now - input_drawn_time;
+	++input_latency_count;
+}
+
+Game_Clock::duration FrameStats::GetInputLatencyTotal() {
+	return input_latency_total;
+}
+
+int64_t FrameStats::GetInputLatencyCount() {
+	return input_latency_count;
+}
@@ -0,0 +1,129 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_FRAME_STATS_H
+#define EP_FRAME_STATS_H
+
+// Headers
+#include <cstdint>
+#include "game_clock.h"
+
+/**
+ * Time spent in the phases of the main loop, shown by the FpsOverlay.
+ * The times are only measured while enabled.
+ */
+namespace FrameStats {
+	/** Measured parts of a frame */
+	enum class Phase {
+		/** Event processing and Input::Update */
+		Input,
+		/** Scene updates, includes the interpreter */
+		Update,
+		/** Event interpreters */
+		Interpreter,
+		/** Composition of the drawables */
+		Draw,
+		/** Upload and present of the display surface */
+		Display,
+		/** Audio mixing, runs on the audio thread */
+		Audio,
+		END
+	};
+
+	/** @return short name of the phase */
+	const char* GetName(Phase phase);
+
+	/** @return whether the times are measured */
+	bool IsEnabled();
+
+	/**
+	 * Enables measuring the times.
+	 *
+	 * @param enabled whether to measure
+	 */
+	void SetEnabled(bool enabled);
+
+	/**
+	 * Adds time spent in a phase. May be called from any thread.
+	 *
+	 * @param phase measured phase
+	 * @param dt time spent
+	 */
+	void Add(Phase phase, Game_Clock::duration dt);
+
+	/** @return time spent in the phase since startup */
+	Game_Clock::duration GetTotal(Phase phase);
+
+	/** Counts an interpreter that yielded because the frame budget was used up */
+	void AddInterpreterYield();
+
+	/** @return interpreter yields since startup */
+	int64_t GetInterpreterYields();
+
+	/**
+	 * Call when the pressed keys changed. The latency of the first change
+	 * since the last drawn frame is measured until that frame is presented.
+	 *
+	 * @param sampled time the events with the change were processed
+	 */
+	void MarkInputChange(Game_Clock::time_point sampled);
+
+	/** Call when a frame was drawn, it shows the marked input changes */
+	void OnFrameDrawn();
+
+	/**
+	 * Call when the drawn frame was presented.
+	 *
+	 * @param now the current time
+	 */
+	void OnFramePresented(Game_Clock::time_point now);
+
+	/** @return time from an input change to the present of its frame, summed since startup */
+	Game_Clock::duration GetInputLatencyTotal();
+
+	/** @return number of measured input changes since startup */
+	int64_t GetInputLatencyCount();
+
+	/** Measures the time until the end of the scope */
+	class Scope {
+	public:
+		explicit Scope(Phase phase);
+		~Scope();
+
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+
+	private:
+		Phase phase;
+		Game_Clock::time_point start;
+		bool enabled;
+	};
+}
+
+inline FrameStats::Scope::Scope(Phase phase) : phase(phase), enabled(IsEnabled()) {
+	if (enabled) {
+		start = Game_Clock::now();
+	}
+}
+
+inline FrameStats::Scope::~Scope() {
+	if (enabled) {
+		Add(phase, Game_Clock::now() - start);
+	}
+}
+
+#endif
@@ -78,6 +78,7 @@ Game_Actor::Game_Actor(int actor_id) {
 	SetBattlePosition(GetOriginalPosition());
 
 	data.level = 0;
+	InvalidateBaseStats();
 	if (dbActor->initial_level > 0) {
 		// For games like COLORS: Lost Memories which use level 0, don't change level because it'll clamp to 1.
 		ChangeLevel(dbActor->initial_level, nullptr);
@@ -98,6 +99,8 @@ Game_Actor::Game_Actor(int actor_id) {
 
 void Game_Actor::SetSaveData(lcf::rpg::SaveActor save) {
 	data = std::move(save);
+	InvalidateBaseStats();
+	RebuildLearnedSkills();
 
 	if (Player::IsRPG2k()) {
 		data.two_weapon = dbActor->two_weapon;
@@ -124,6 +127,7 @@ lcf::rpg::SaveActor Game_Actor::GetSaveData() const {
 
 void Game_Actor::Fixup() {
 	RemoveInvalidData();
+	InvalidateBaseStats();
 	ResetEquipmentStates(false);
 }
 
@@ -180,7 +184,20 @@ bool Game_Actor::IsItemUsable(int item_id) const {
 }
 
 bool Game_Actor::IsSkillLearned(int skill_id) const {
-	return std::find(data.skills.begin(), data.skills.end(), skill_id) != data.skills.end();
+	return skill_id >= 0 && static_cast<size_t>(skill_id) < learned_skills.size() && learned_skills[skill_id];
+}
+
+void Game_Actor::RebuildLearnedSkills() {
+	size_t size = lcf::Data::skills.size() + 1;
+	for (int16_t skill_id : data.skills) {
+		size = std::max(size, static_cast<size_t>(std::max<int>(skill_id, 0)) + 1);
+	}
+	learned_skills.assign(size, false);
+	for (int16_t skill_id : data.skills) {
+		if (skill_id >= 0) {
+			learned_skills[skill_id] = true;
+		}
+	}
 }
 
 bool Game_Actor::IsSkillUsable(int skill_id) const {
@@ -229,8 +246,11 @@ bool Game_Actor::LearnSkill(int skill_id, PendingMessage* pm) {
 			return false;
 		}
 
-		data.skills.push_back((int16_t)skill_id);
-		std::sort(data.skills.begin(), data.skills.end());
+		data.skills.insert(std::upper_bound(data.skills.begin(), data.skills.end(), skill_id), (int16_t)skill_id);
+		if (static_cast<size_t>(skill_id) >= learned_skills.size()) {
+			learned_skills.resize(std::max(lcf::Data::skills.size(), static_cast<size_t>(skill_id)) + 1, false);
+		}
+		learned_skills[skill_id] = true;
 
 		if (pm) {
 			pm->PushLine(GetLearningMessage(*skill));
@@ -260,6 +280,11 @@ bool Game_Actor::UnlearnSkill(int skill_id) {
 	std::vector<int16_t>::iterator it = std::find(data.skills.begin(), data.skills.end(), skill_id);
 	if (it != data.skills.end()) {
 		data.skills.erase(it);
+		// Saves can contain a skill twice
+		if (skill_id >= 0 && static_cast<size_t>(skill_id) < learned_skills.size()
+				&& std::find(data.skills.begin(), data.skills.end(), skill_id) == data.skills.end()) {
+			learned_skills[skill_id] = false;
+		}
 		return true;
 	}
 	return false;
@@ -267,6 +292,7 @@ bool Game_Actor::UnlearnSkill(int skill_id) {
 
 void Game_Actor::UnlearnAllSkills() {
 	data.skills.clear();
+	learned_skills.assign(learned_skills.size(), false);
 }
 
 void Game_Actor::SetFace(const std::string& file_name, int index) {
@@ -301,6 +327,7 @@ int Game_Actor::SetEquipment(int equip_type, int new_item_id) {
 	}
 
 	data.equipped[equip_type - 1] = (short)new_item_id;
+	InvalidateBaseStats();
 
 	AdjustEquipmentStates(old_item, false, false);
 	AdjustEquipmentStates(new_item, true, false);
@@ -383,7 +410,7 @@ int Game_Actor::GetBaseMaxHp(bool mod) const {
 }
 
 int Game_Actor::GetBaseMaxHp() const {
-	return GetBaseMaxHp(true);
+	return GetBaseStats().max_hp;
 }
 
 int Game_Actor::GetBaseMaxSp(bool mod) const {
@@ -401,7 +428,7 @@ int Game_Actor::GetBaseMaxSp(bool mod) const {
 }
 
 int Game_Actor::GetBaseMaxSp() const {
-	return GetBaseMaxSp(true);
+	return GetBaseStats().max_sp;
 }
 
 static bool IsArmorType(const lcf::rpg::Item* item) {
@@ -460,6 +487,9 @@ int Game_Actor::GetBaseAtk(Weapon weapon, bool mod, bool equip) const {
 }
 
 int Game_Actor::GetBaseAtk(Weapon weapon) const {
+	if (weapon == WeaponAll) {
+		return GetBaseStats().atk;
+	}
 	return GetBaseAtk(weapon, true, true);
 }
 
@@ -483,6 +513,9 @@ int Game_Actor::GetBaseDef(Weapon weapon, bool mod, bool equip) const {
 }
 
 int Game_Actor::GetBaseDef(Weapon weapon) const {
+	if (weapon == WeaponAll) {
+		return GetBaseStats().def;
+	}
 	return GetBaseDef(weapon, true, true);
 }
 
@@ -506,6 +539,9 @@ int Game_Actor::GetBaseSpi(Weapon weapon, bool mod, bool equip) const {
 }
 
 int Game_Actor::GetBaseSpi(Weapon weapon) const {
+	if (weapon == WeaponAll) {
+		return GetBaseStats().spi;
+	}
 	return GetBaseSpi(weapon, true, true);
 }
 
@@ -529,9 +565,25 @@ int Game_Actor::GetBaseAgi(Weapon weapon, bool mod, bool equip) const {
 }
 
 int Game_Actor::GetBaseAgi(Weapon weapon) const {
+	if (weapon == WeaponAll) {
+		return GetBaseStats().agi;
+	}
 	return GetBaseAgi(weapon, true, true);
 }
 
+const Game_Actor::BaseStats& Game_Actor::GetBaseStats() const {
+	if (!base_stats_valid) {
+		base_stats.max_hp = GetBaseMaxHp(true);
+		base_stats.max_sp = GetBaseMaxSp(true);
+		base_stats.atk = GetBaseAtk(WeaponAll, true, true);
+		base_stats.def = GetBaseDef(WeaponAll, true, true);
+		base_stats.spi = GetBaseSpi(WeaponAll, true, true);
+		base_stats.agi = GetBaseAgi(WeaponAll, true, true);
+		base_stats_valid = true;
+	}
+	return base_stats;
+}
+
 int Game_Actor::CalculateExp(int level) const {
 	const lcf::rpg::Class* klass = lcf::ReaderUtil::GetElement(lcf::Data::classes, data.class_id);
 
@@ -715,6 +767,7 @@ void Game_Actor::ChangeExp(int exp, PendingMessage* pm) {
 
 void Game_Actor::SetLevel(int _level) {
 	data.level = Utils::Clamp(_level, 1, GetMaxLevel());
+	InvalidateBaseStats();
 	// Ensure current HP/SP remain clamped if new Max HP/SP is less.
 	SetHp(GetHp());
 	SetSp(GetSp());
@@ -812,7 +865,9 @@ bool Game_Actor::IsEquipmentFixed() const {
 		return true;
 	}
 
-	for (auto state_id: GetInflictedStates()) {
+	FrameArena::Vector<int16_t> inf_states;
+	GetInflictedStates(inf_states);
+	for (auto state_id: inf_states) {
 		auto* state = lcf::ReaderUtil::GetElement(lcf::Data::states, state_id);
 		if (state && state->cursed) {
 			return true;
@@ -976,6 +1031,7 @@ void Game_Actor::ChangeClass(int new_class_id,
 	data.agility_mod = 0;
 
 	data.class_id = new_class_id;
+	InvalidateBaseStats();
 	data.changed_battle_commands = true; // Any change counts as a battle commands change.
 
 	// The class settings are not applied when the actor has a class on startup
@@ -1080,6 +1136,7 @@ static int ClampStatMod(int value, const Game_Actor* actor) {
 void Game_Actor::SetBaseMaxHp(int maxhp) {
 	int new_hp_mod = data.hp_mod + (maxhp - GetBaseMaxHp());
 	data.hp_mod = ClampMaxHpMod(new_hp_mod, this);
+	InvalidateBaseStats();
 
 	SetHp(data.current_hp);
 }
@@ -1087,6 +1144,7 @@ void Game_Actor::SetBaseMaxHp(int maxhp) {
 void Game_Actor::SetBaseMaxSp(int maxsp) {
 	int new_sp_mod = data.sp_mod + (maxsp - GetBaseMaxSp());
 	data.sp_mod = ClampStatMod(new_sp_mod, this);
+	InvalidateBaseStats();
 
 	SetSp(data.current_sp);
 }
@@ -1104,21 +1162,25 @@ int Game_Actor::SetSp(int sp) {
 void Game_Actor::SetBaseAtk(int atk) {
 	int new_attack_mod = data.attack_mod + (atk - GetBaseAtk());
 	data.attack_mod = ClampStatMod(new_attack_mod, this);
+	InvalidateBaseStats();
 }
 
 void Game_Actor::SetBaseDef(int def) {
 	int new_defense_mod = data.defense_mod + (def - GetBaseDef());
 	data.defense_mod = ClampStatMod(new_defense_mod, this);
+	InvalidateBaseStats();
 }
 
 void Game_Actor::SetBaseSpi(int spi) {
 	int new_spirit_mod = data.spirit_mod + (spi - GetBaseSpi());
 	data.spirit_mod = ClampStatMod(new_spirit_mod, this);
+	InvalidateBaseStats();
 }
 
 void Game_Actor::SetBaseAgi(int agi) {
 	int new_agility_mod = data.agility_mod + (agi - GetBaseAgi());
 	data.agility_mod = ClampStatMod(new_agility_mod, this);
+	InvalidateBaseStats();
 }
 
 Game_Actor::RowType Game_Actor::GetBattleRow() const {
@@ -1233,8 +1295,9 @@ void Game_Actor::RemoveInvalidData() {
 		}
 	}
 
-	// Remove invalid skills
-	for (int16_t skill_id : GetSkills()) {
+	// Remove invalid skills, from a copy as UnlearnSkill erases
+	const auto skills = GetSkills();
+	for (int16_t skill_id : skills) {
 		const lcf::rpg::Skill* skill = lcf::ReaderUtil::GetElement(lcf::Data::skills, skill_id);
 		if (!skill) {
 			Output::Warning("Actor {}: Removing invalid skill {}", GetId(), skill_id);
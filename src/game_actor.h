@@ -893,9 +893,37 @@ private:
 	 */
 	void RemoveInvalidData();
 
+	/** Base parameters with modifier and all equipment bonuses */
+	struct BaseStats {
+		int max_hp = 0;
+		int max_sp = 0;
+		int atk = 0;
+		int def = 0;
+		int spi = 0;
+		int agi = 0;
+	};
+
+	/**
+	 * @return the base parameters, computed on first use after an invalidation
+	 */
+	const BaseStats& GetBaseStats() const;
+
+	/**
+	 * Discards the cached base parameters.
+	 * Must be called whenever level, class, modifiers or equipment change.
+	 */
+	void InvalidateBaseStats();
+
+	/** Rebuilds learned_skills from data.skills, needed when data is replaced */
+	void RebuildLearnedSkills();
+
 	lcf::rpg::SaveActor data;
 	const lcf::rpg::Actor* dbActor = nullptr;
 	std::vector<int> exp_list;
+	mutable BaseStats base_stats;
+	mutable bool base_stats_valid = false;
+	/** Indexed by skill ID, mirrors data.skills for O(1) IsSkillLearned */
+	std::vector<bool> learned_skills;
 };
 
 inline Game_Battler::BattlerType Game_Actor::GetType() const {
@@ -956,6 +984,10 @@ inline int Game_Actor::GetFaceIndex() const {
 		: dbActor->face_index;
 }
 
+inline void Game_Actor::InvalidateBaseStats() {
+	base_stats_valid = false;
+}
+
 inline int Game_Actor::GetLevel() const {
 	return data.level;
 }
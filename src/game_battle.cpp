@@ -63,6 +63,38 @@ namespace {
 	std::vector<bool> page_can_run;
 
 	std::function<bool(const lcf::rpg::TroopPage&)> last_event_filter;
+
+	/** Inputs of the conditions of a troop page, compiled at battle start */
+	struct PageConditionInputs {
+		/** Pages without trigger are never run */
+		bool has_trigger = false;
+		bool switches = false;
+		bool variables = false;
+		bool turn = false;
+		/** Turns, HP, fatigue and commands of battlers, these have no revision */
+		bool battlers = false;
+		/** Result of the last evaluation */
+		bool met = false;
+		bool evaluated = false;
+	};
+	std::vector<PageConditionInputs> page_inputs;
+
+	/** State the conditions were last evaluated with */
+	int conditions_switch_revision = 0;
+	int conditions_variable_revision = 0;
+	int conditions_turn = 0;
+
+	PageConditionInputs CompileConditions(const lcf::rpg::TroopPageCondition& condition) {
+		const auto& flags = condition.flags;
+		PageConditionInputs inputs;
+		inputs.switches = flags.switch_a || flags.switch_b;
+		inputs.variables = flags.variable;
+		inputs.turn = flags.turn;
+		inputs.battlers = flags.turn_enemy || flags.turn_actor || flags.fatigue
+			|| flags.enemy_hp || flags.actor_hp || flags.command_actor;
+		inputs.has_trigger = inputs.switches || inputs.variables || inputs.turn || inputs.battlers;
+		return inputs;
+	}
 }
 
 void Game_Battle::Init(int troop_id) {
@@ -78,11 +110,16 @@ void Game_Battle::Init(int troop_id) {
 	target_enemy_index = 0;
 
 	// troop_id is guaranteed to be valid
+	Player::translation.RewriteBattleEventMessages(troop_id);
 	troop = lcf::ReaderUtil::GetElement(lcf::Data::troops, troop_id);
 	page_executed.resize(troop->pages.size());
 	std::fill(page_executed.begin(), page_executed.end(), false);
 	page_can_run.resize(troop->pages.size());
 	std::fill(page_can_run.begin(), page_can_run.end(), false);
+	page_inputs.clear();
+	for (const auto& page: troop->pages) {
+		page_inputs.push_back(CompileConditions(page.condition));
+	}
 
 	RefreshEvents([](const lcf::rpg::TroopPage&) {
 		return false;
@@ -119,6 +156,7 @@ void Game_Battle::Quit() {
 
 	page_executed.clear();
 	page_can_run.clear();
+	page_inputs.clear();
 
 	Main_Data::game_actors->ResetBattle();
 	Main_Data::game_enemyparty->ResetBattle(0);
@@ -388,7 +426,7 @@ bool Game_Battle::UpdateEvents() {
 	for (const auto& page : troop->pages) {
 		if (page_can_run[page.ID - 1]) {
 			interpreter->Clear();
-			interpreter->Push(page.event_commands, 0);
+			interpreter->Push(page.event_commands, 0, false, { EventProfiler::Type::BattleEvent, troop->ID, page.ID });
 			page_can_run[page.ID - 1] = false;
 			page_executed[page.ID - 1] = true;
 			return false;
@@ -411,9 +449,29 @@ void Game_Battle::RefreshEvents() {
 }
 
 void Game_Battle::RefreshEvents(std::function<bool(const lcf::rpg::TroopPage&)> predicate) {
+	// Pages are only evaluated again when one of their inputs changed
+	const int switch_revision = Main_Data::game_switches->GetRevision();
+	const int variable_revision = Main_Data::game_variables->GetRevision();
+	const int turn = GetTurn();
+	const bool switches_changed = switch_revision != conditions_switch_revision;
+	const bool variables_changed = variable_revision != conditions_variable_revision;
+	const bool turn_changed = turn != conditions_turn;
+	conditions_switch_revision = switch_revision;
+	conditions_variable_revision = variable_revision;
+	conditions_turn = turn;
+
 	for (const auto& it : troop->pages) {
 		const lcf::rpg::TroopPage& page = it;
-		if (!page_executed[page.ID - 1] && AreConditionsMet(page.condition)) {
+		auto& inputs = page_inputs[page.ID - 1];
+		if (inputs.has_trigger && (!inputs.evaluated || inputs.battlers
+				|| (inputs.switches && switches_changed)
+				|| (inputs.variables && variables_changed)
+				|| (inputs.turn && turn_changed))) {
+			inputs.met = AreConditionsMet(page.condition);
+			inputs.evaluated = true;
+		}
+
+		if (!page_executed[page.ID - 1] && inputs.met) {
 			if (predicate(it)) {
 				page_can_run[it.ID - 1] = true;
 			}
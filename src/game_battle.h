@@ -214,6 +214,10 @@ namespace Game_Battle {
 		int terrain_id = 0;
 		lcf::rpg::System::BattleFormation formation = lcf::rpg::System::BattleFormation_terrain;
 		lcf::rpg::System::BattleCondition condition = lcf::rpg::System::BattleCondition_none;
+		/** Battles run by the battle simulator instead of the battle scene, 0 when disabled */
+		int simulations = 0;
+		/** Seed of the first simulated battle */
+		int simulation_seed = 0;
 	};
 
 	extern struct BattleTest battle_test;
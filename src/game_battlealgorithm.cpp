@@ -19,7 +19,8 @@
 #include <cmath>
 #include <cstdlib>
 #include <algorithm>
-#include <sstream>
+#include <initializer_list>
+#include <string>
 #include "game_actor.h"
 #include "game_battle.h"
 #include "game_battlealgorithm.h"
@@ -45,6 +46,20 @@
 #include "algo.h"
 #include "attribute.h"
 
+/** Concatenates the parts of a battle message with a single allocation */
+static std::string JoinMessage(std::initializer_list<StringView> parts) {
+	size_t size = 0;
+	for (const auto& part: parts) {
+		size += part.size();
+	}
+	std::string msg;
+	msg.reserve(size);
+	for (const auto& part: parts) {
+		msg.append(part.data(), part.size());
+	}
+	return msg;
+}
+
 static inline int MaxDamageValue() {
 	return Player::IsRPG2k() ? 999 : 9999;
 }
@@ -381,21 +396,9 @@ std::string Game_BattleAlgorithm::AlgorithmBase::GetHpSpRecoveredMessage(int val
 		);
 	}
 	else {
-		std::stringstream ss;
-		std::string particle, particle2, space = "";
-
-		ss << GetTarget()->GetName();
-		if (Player::IsCP932()) {
-			particle = "の";
-			particle2 = "が ";
-			space += " ";
-		}
-		else {
-			particle = particle2 = " ";
-		}
-		ss << particle << points << particle2;
-		ss << value << space << lcf::Data::terms.hp_recovery;
-		return ss.str();
+		const bool cp932 = Player::IsCP932();
+		return JoinMessage({ GetTarget()->GetName(), cp932 ? "の" : " ", points, cp932 ? "が " : " ",
+				std::to_string(value), cp932 ? " " : "", lcf::Data::terms.hp_recovery });
 	}
 }
 
@@ -452,22 +455,9 @@ std::string Game_BattleAlgorithm::AlgorithmBase::GetHpSpAbsorbedMessage(int valu
 		);
 	}
 	else {
-		std::stringstream ss;
-		std::string particle, particle2, space = "";
-
-		ss << GetTarget()->GetName();
-
-		if (Player::IsCP932()) {
-			particle = (target_is_ally ? "は" : "の");
-			particle2 = "を ";
-			space += " ";
-		} else {
-			particle = particle2 = " ";
-		}
-		ss << particle << points << particle2;
-		ss << value << space << message;
-
-		return ss.str();
+		const bool cp932 = Player::IsCP932();
+		return JoinMessage({ GetTarget()->GetName(), cp932 ? (target_is_ally ? "は" : "の") : " ", points, cp932 ? "を " : " ",
+				std::to_string(value), cp932 ? " " : "", message });
 	}
 }
 
@@ -487,18 +477,9 @@ std::string Game_BattleAlgorithm::AlgorithmBase::GetDamagedMessage() const {
 		);
 	}
 	else {
-		std::stringstream ss;
-		std::string particle, space = "";
-		ss << GetTarget()->GetName();
-
-		if (Player::IsCP932()) {
-			particle = (target_is_ally ? "は " : "に ");
-			space += " ";
-		} else {
-			particle = " ";
-		}
-		ss << particle << value << space << message;
-		return ss.str();
+		const bool cp932 = Player::IsCP932();
+		return JoinMessage({ GetTarget()->GetName(), cp932 ? (target_is_ally ? "は " : "に ") : " ",
+				std::to_string(value), cp932 ? " " : "", message });
 	}
 }
 
@@ -515,22 +496,9 @@ std::string Game_BattleAlgorithm::AlgorithmBase::GetParameterChangeMessage(bool
 		);
 	}
 	else {
-		std::stringstream ss;
-		std::string particle, particle2, space = "";
-		ss << GetTarget()->GetName();
-
-		if (Player::IsCP932()) {
-			particle = "の";
-			particle2 = "が ";
-			space += " ";
-		}
-		else {
-			particle = particle2 = " ";
-		}
-		ss << particle << points << particle2 << value << space;
-		ss << message;
-
-		return ss.str();
+		const bool cp932 = Player::IsCP932();
+		return JoinMessage({ GetTarget()->GetName(), cp932 ? "の" : " ", points, cp932 ? "が " : " ",
+				std::to_string(value), cp932 ? " " : "", message });
 	}
 }
 
@@ -551,7 +519,6 @@ std::string Game_BattleAlgorithm::AlgorithmBase::GetAttributeShiftMessage(String
 	StringView message = IsPositive()
 		? StringView(lcf::Data::terms.resistance_increase)
 		: StringView(lcf::Data::terms.resistance_decrease);
-	std::stringstream ss;
 
 	if (Player::IsRPG2kE()) {
 		return Utils::ReplacePlaceholders(
@@ -561,20 +528,8 @@ std::string Game_BattleAlgorithm::AlgorithmBase::GetAttributeShiftMessage(String
 		);
 	}
 	else {
-		std::string particle, space = "";
-		ss << GetTarget()->GetName();
-
-		if (Player::IsCP932()) {
-			particle = "は";
-			space += " ";
-		}
-		else {
-			particle = " ";
-		}
-		ss << particle << attribute << space;
-		ss << message;
-
-		return ss.str();
+		const bool cp932 = Player::IsCP932();
+		return JoinMessage({ GetTarget()->GetName(), cp932 ? "は" : " ", attribute, cp932 ? " " : "", message });
 	}
 }
 
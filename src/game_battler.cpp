@@ -53,23 +53,34 @@ bool Game_Battler::HasState(int state_id) const {
 	return State::Has(state_id, GetStates());
 }
 
-std::vector<int16_t> Game_Battler::GetInflictedStates() const {
-	auto& states = GetStates();
-	std::vector<int16_t> inf_states;
+template <typename T>
+static void AppendInflictedStates(const std::vector<int16_t>& states, T& inf_states) {
 	for (size_t i = 0; i < states.size(); ++i) {
 		if (states[i] > 0) {
 			inf_states.push_back(i + 1);
 		}
 	}
+}
+
+std::vector<int16_t> Game_Battler::GetInflictedStates() const {
+	std::vector<int16_t> inf_states;
+	AppendInflictedStates(GetStates(), inf_states);
 	return inf_states;
 }
 
+void Game_Battler::GetInflictedStates(FrameArena::Vector<int16_t>& states) const {
+	states.clear();
+	AppendInflictedStates(GetStates(), states);
+}
+
 PermanentStates Game_Battler::GetPermanentStates() const {
 	return PermanentStates();
 }
 
 bool Game_Battler::EvadesAllPhysicalAttacks() const {
-	for (auto state_id: GetInflictedStates()) {
+	FrameArena::Vector<int16_t> inf_states;
+	GetInflictedStates(inf_states);
+	for (auto state_id: inf_states) {
 		auto* state = lcf::ReaderUtil::GetElement(lcf::Data::states, state_id);
 		if (state && state->avoid_attacks) {
 			return true;
@@ -130,7 +141,9 @@ bool Game_Battler::IsSkillUsable(int skill_id) const {
 		return false;
 	}
 
-	for (auto state_id: GetInflictedStates()) {
+	FrameArena::Vector<int16_t> inf_states;
+	GetInflictedStates(inf_states);
+	for (auto state_id: inf_states) {
 		const auto* state = lcf::ReaderUtil::GetElement(lcf::Data::states, state_id);
 		if (state) {
 			if (state->restrict_skill && skill->physical_rate >= state->restrict_skill_level) {
@@ -369,7 +382,9 @@ bool Game_Battler::RemoveState(int state_id, bool always_remove_battle_states) {
 
 int Game_Battler::ApplyConditions() {
 	int damageTaken = 0;
-	for (int16_t inflicted : GetInflictedStates()) {
+	FrameArena::Vector<int16_t> inf_states;
+	GetInflictedStates(inf_states);
+	for (int16_t inflicted: inf_states) {
 		// States are guaranteed to be valid
 		lcf::rpg::State& state = *lcf::ReaderUtil::GetElement(lcf::Data::states, inflicted);
 		int hp = state.hp_change_val + (GetMaxHp() * state.hp_change_max / 100);
@@ -490,19 +505,27 @@ static int AdjustParam(int base, int mod, int maxval, Span<const int16_t> states
 }
 
 int Game_Battler::GetAtk(Weapon weapon) const {
-	return AdjustParam(GetBaseAtk(weapon), atk_modifier, MaxStatBattleValue(), GetInflictedStates(), &lcf::rpg::State::affect_attack);
+	FrameArena::Vector<int16_t> inf_states;
+	GetInflictedStates(inf_states);
+	return AdjustParam(GetBaseAtk(weapon), atk_modifier, MaxStatBattleValue(), inf_states, &lcf::rpg::State::affect_attack);
 }
 
 int Game_Battler::GetDef(Weapon weapon) const {
-	return AdjustParam(GetBaseDef(weapon), def_modifier, MaxStatBattleValue(), GetInflictedStates(), &lcf::rpg::State::affect_defense);
+	FrameArena::Vector<int16_t> inf_states;
+	GetInflictedStates(inf_states);
+	return AdjustParam(GetBaseDef(weapon), def_modifier, MaxStatBattleValue(), inf_states, &lcf::rpg::State::affect_defense);
 }
 
 int Game_Battler::GetSpi(Weapon weapon) const {
-	return AdjustParam(GetBaseSpi(weapon), spi_modifier, MaxStatBattleValue(), GetInflictedStates(), &lcf::rpg::State::affect_spirit);
+	FrameArena::Vector<int16_t> inf_states;
+	GetInflictedStates(inf_states);
+	return AdjustParam(GetBaseSpi(weapon), spi_modifier, MaxStatBattleValue(), inf_states, &lcf::rpg::State::affect_spirit);
 }
 
 int Game_Battler::GetAgi(Weapon weapon) const {
-	return AdjustParam(GetBaseAgi(weapon), agi_modifier, MaxStatBattleValue(), GetInflictedStates(), &lcf::rpg::State::affect_agility);
+	FrameArena::Vector<int16_t> inf_states;
+	GetInflictedStates(inf_states);
+	return AdjustParam(GetBaseAgi(weapon), agi_modifier, MaxStatBattleValue(), inf_states, &lcf::rpg::State::affect_agility);
 }
 
 int Game_Battler::GetDisplayX() const {
@@ -549,7 +572,9 @@ std::vector<int16_t> Game_Battler::BattleStateHeal() {
 }
 
 bool Game_Battler::HasReflectState() const {
-	for (int16_t i : GetInflictedStates()) {
+	FrameArena::Vector<int16_t> inf_states;
+	GetInflictedStates(inf_states);
+	for (int16_t i: inf_states) {
 		// States are guaranteed to be valid
 		if (lcf::ReaderUtil::GetElement(lcf::Data::states, i)->reflect_magic) {
 			return true;
@@ -612,7 +637,9 @@ bool Game_Battler::CanShiftAttributeRate(int attribute_id, int shift) const {
 int Game_Battler::GetHitChanceModifierFromStates() const {
 	int modifier = 100;
 	// Modify hit chance for each state the source has
-	for (const auto id : GetInflictedStates()) {
+	FrameArena::Vector<int16_t> inf_states;
+	GetInflictedStates(inf_states);
+	for (const auto id: inf_states) {
 		auto* state = lcf::ReaderUtil::GetElement(lcf::Data::states, id);
 		if (state) {
 			modifier = std::min<int>(modifier, state->reduce_hit_ratio);
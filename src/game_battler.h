@@ -31,6 +31,7 @@
 #include "utils.h"
 #include "point.h"
 #include "string_view.h"
+#include "frame_arena.h"
 
 class Game_Actor;
 class Game_Party_Base;
@@ -86,6 +87,13 @@ public:
 	 */
 	std::vector<int16_t> GetInflictedStates() const;
 
+	/**
+	 * Gets battler states into a vector of the frame arena.
+	 *
+	 * @param states receives the IDs of all states the battler has.
+	 */
+	void GetInflictedStates(FrameArena::Vector<int16_t>& states) const;
+
 	/** @return permenant states that cannot be removed */
 	virtual PermanentStates GetPermanentStates() const;
 
@@ -24,6 +24,7 @@
 #include "game_system.h"
 #include "input.h"
 #include "main_data.h"
+#include "move_route_program.h"
 #include "game_message.h"
 #include "drawable.h"
 #include "player.h"
@@ -34,9 +35,12 @@
 #include <cmath>
 #include <cassert>
 
+uint32_t Game_Character::next_sprite_revision = 0;
+
 Game_Character::Game_Character(Type type, lcf::rpg::SaveMapEventBase* d) :
 	_type(type), _data(d)
 {
+	OnSpriteChanged();
 }
 
 Game_Character::~Game_Character() {
@@ -216,6 +220,10 @@ void Game_Character::UpdateFlash() {
 	Flash::Update(data()->flash_current_level, data()->flash_time_left);
 }
 
+void Game_Character::OnEventMoved() {
+	Game_Map::OnEventMoved(*this);
+}
+
 void Game_Character::UpdateMoveRoute(int32_t& current_index, const lcf::rpg::MoveRoute& current_route, bool is_overwrite) {
 	if (current_route.move_commands.empty()) {
 		return;
@@ -225,7 +233,10 @@ void Game_Character::UpdateMoveRoute(int32_t& current_index, const lcf::rpg::Mov
 		return;
 	}
 
-	const auto num_commands = static_cast<int>(current_route.move_commands.size());
+	// Keeps the program alive when a page refresh replaces the route
+	const auto program = GetMoveRouteProgram(current_route, is_overwrite);
+	const auto& ops = program->GetOps();
+	const auto num_commands = static_cast<int>(ops.size());
 	// Invalid index could occur from a corrupted save game.
 	// Player, Vehicle, and Event all check for and fix this, but we still assert here in
 	// case any bug causes this to happen still.
@@ -257,11 +268,11 @@ void Game_Character::UpdateMoveRoute(int32_t& current_index, const lcf::rpg::Mov
 		}
 
 		using Code = lcf::rpg::MoveCommand::Code;
-		const auto& move_command = current_route.move_commands[current_index];
+		const auto& op = ops[current_index];
 		const auto prev_direction = GetDirection();
 		const auto prev_facing = GetFacing();
 		const auto saved_index = current_index;
-		const auto cmd = static_cast<Code>(move_command.command_id);
+		const auto cmd = op.code;
 
 		if (cmd >= Code::move_up && cmd <= Code::move_forward) {
 			switch (cmd) {
@@ -353,7 +364,7 @@ void Game_Character::UpdateMoveRoute(int32_t& current_index, const lcf::rpg::Mov
 					SetStopCount(0);
 					break;
 				case Code::begin_jump:
-					if (!BeginMoveRouteJump(current_index, current_route)) {
+					if (!BeginMoveRouteJump(current_index, *program)) {
 						// Jump failed
 						if (current_route.skippable) {
 							SetDirection(prev_direction);
@@ -385,9 +396,9 @@ void Game_Character::UpdateMoveRoute(int32_t& current_index, const lcf::rpg::Mov
 					SetMoveFrequency(max(GetMoveFrequency() - 1, 1));
 					break;
 				case Code::switch_on: // Parameter A: Switch to turn on
-					Main_Data::game_switches->Set(move_command.parameter_a, true);
+					Main_Data::game_switches->Set(op.param, true);
 					++current_index; // In case the current_index is already 0 ...
-					Game_Map::SetNeedRefresh(true);
+					Game_Map::SetNeedRefreshChanged();
 					Game_Map::Refresh();
 					// If page refresh has reset the current move route, abort now.
 					if (current_index == 0) {
@@ -396,9 +407,9 @@ void Game_Character::UpdateMoveRoute(int32_t& current_index, const lcf::rpg::Mov
 					--current_index;
 					break;
 				case Code::switch_off: // Parameter A: Switch to turn off
-					Main_Data::game_switches->Set(move_command.parameter_a, false);
+					Main_Data::game_switches->Set(op.param, false);
 					++current_index; // In case the current_index is already 0 ...
-					Game_Map::SetNeedRefresh(true);
+					Game_Map::SetNeedRefreshChanged();
 					Game_Map::Refresh();
 					// If page refresh has reset the current move route, abort now.
 					if (current_index == 0) {
@@ -407,17 +418,11 @@ void Game_Character::UpdateMoveRoute(int32_t& current_index, const lcf::rpg::Mov
 					--current_index;
 					break;
 				case Code::change_graphic: // String: File, Parameter A: index
-					MoveRouteSetSpriteGraphic(ToString(move_command.parameter_string), move_command.parameter_a);
+					MoveRouteSetSpriteGraphic(*op.name, op.param);
 					break;
 				case Code::play_sound_effect: // String: File, Parameters: Volume, Tempo, Balance
-					if (move_command.parameter_string != "(OFF)" && move_command.parameter_string != "(Brak)") {
-						lcf::rpg::Sound sound;
-						sound.name = ToString(move_command.parameter_string);
-						sound.volume = move_command.parameter_a;
-						sound.tempo = move_command.parameter_b;
-						sound.balance = move_command.parameter_c;
-
-						Main_Data::game_system->SePlay(sound);
+					if (op.param >= 0) {
+						Main_Data::game_system->SePlay(program->GetSound(op));
 					}
 					break;
 				case Code::walk_everywhere_on:
@@ -555,14 +560,18 @@ void Game_Character::Wait() {
 	SetMaxStopCountForWait();
 }
 
-bool Game_Character::BeginMoveRouteJump(int32_t& current_index, const lcf::rpg::MoveRoute& current_route) {
+bool Game_Character::BeginMoveRouteJump(int32_t& current_index, const MoveRouteProgram& program) {
+	const auto& ops = program.GetOps();
+	const auto jump_end = ops[current_index].jump_end;
+	// Without an end jump the direction changes up to the end of the route still apply
+	const auto last_index = jump_end >= 0 ? jump_end : static_cast<int>(ops.size()) - 1;
+
 	int jdx = 0;
 	int jdy = 0;
 
-	for (++current_index; current_index < static_cast<int>(current_route.move_commands.size()); ++current_index) {
+	for (++current_index; current_index <= last_index; ++current_index) {
 		using Code = lcf::rpg::MoveCommand::Code;
-		const auto& move_command = current_route.move_commands[current_index];
-		const auto cmd = static_cast<Code>(move_command.command_id);
+		const auto cmd = ops[current_index].code;
 		if (cmd >= Code::move_up && cmd <= Code::move_forward) {
 			switch (cmd) {
 				case Code::move_up:
@@ -573,7 +582,7 @@ bool Game_Character::BeginMoveRouteJump(int32_t& current_index, const lcf::rpg::
 				case Code::move_downright:
 				case Code::move_downleft:
 				case Code::move_upleft:
-					SetDirection(move_command.command_id);
+					SetDirection(static_cast<Game_Character::Direction>(cmd));
 					break;
 				case Code::move_random:
 					TurnRandom();
@@ -653,6 +662,21 @@ bool Game_Character::BeginMoveRouteJump(int32_t& current_index, const lcf::rpg::
 	return true;
 }
 
+std::shared_ptr<const MoveRouteProgram> Game_Character::GetMoveRouteProgram(const lcf::rpg::MoveRoute& route, bool is_overwrite) {
+	auto& slot = move_route_programs[is_overwrite];
+	if (slot.route != &route || !slot.program || slot.program->GetOps().size() != route.move_commands.size()) {
+		slot.route = &route;
+		slot.program = MoveRouteProgram::Get(route);
+	}
+	return slot.program;
+}
+
+void Game_Character::ResetMoveRoutePrograms() {
+	for (auto& slot : move_route_programs) {
+		slot = {};
+	}
+}
+
 bool Game_Character::Jump(int x, int y) {
 	if (!IsStopping()) {
 		return true;
@@ -19,6 +19,7 @@
 #define EP_GAME_CHARACTER_H
 
 // Headers
+#include <memory>
 #include <string>
 #include "color.h"
 #include "flash.h"
@@ -27,6 +28,8 @@
 #include <lcf/rpg/savemapeventbase.h>
 #include "utils.h"
 
+class MoveRouteProgram;
+
 /**
  * Game_Character class.
  */
@@ -257,6 +260,13 @@ public:
 	 */
 	void SetSpriteGraphic(std::string sprite_name, int index);
 
+	/**
+	 * The sprites only compare the sprite name when this changed.
+	 *
+	 * @return changes when the sprite name or index may have changed, unique across all characters
+	 */
+	uint32_t GetSpriteRevision() const;
+
 	/**
 	 * Sets sprite name from a move route command. Usually the name of the graphic file.
 	 * This can be overridden to change behavior by child classes.
@@ -877,16 +887,41 @@ protected:
 	void IncAnimCount();
 	void IncAnimFrame();
 	void UpdateFlash();
-	bool BeginMoveRouteJump(int32_t& current_index, const lcf::rpg::MoveRoute& current_route);
+	bool BeginMoveRouteJump(int32_t& current_index, const MoveRouteProgram& program);
+	/**
+	 * Returns the compiled program of a move route. The program of each slot is
+	 * kept until another route is passed or ResetMoveRoutePrograms is called.
+	 *
+	 * @param route the move route
+	 * @param is_overwrite slot: forced move route or the route of the event page
+	 * @return program of the route
+	 */
+	std::shared_ptr<const MoveRouteProgram> GetMoveRouteProgram(const lcf::rpg::MoveRoute& route, bool is_overwrite);
+	/** Drops the compiled move routes, must be called when the save data is replaced */
+	void ResetMoveRoutePrograms();
+	/** Updates the tile index of the map after the position of an event changed */
+	void OnEventMoved();
+
+	/** Called when the sprite name or index changed, also when the save data was replaced */
+	void OnSpriteChanged();
 
 	lcf::rpg::SaveMapEventBase* data();
 	const lcf::rpg::SaveMapEventBase* data() const;
 
+	struct MoveRouteSlot {
+		const lcf::rpg::MoveRoute* route = nullptr;
+		std::shared_ptr<const MoveRouteProgram> program;
+	};
+
 	int original_move_frequency = 2;
+	MoveRouteSlot move_route_programs[2];
 	// contains if any movement (<= step_forward) of a forced move route was successful
 
 	Type _type = {};
 	lcf::rpg::SaveMapEventBase* _data = nullptr;
+
+	uint32_t sprite_revision = 0;
+	static uint32_t next_sprite_revision;
 };
 
 template <typename T>
@@ -934,7 +969,12 @@ inline int Game_Character::GetX() const {
 }
 
 inline void Game_Character::SetX(int new_x) {
-	data()->position_x = new_x;
+	if (data()->position_x != new_x) {
+		data()->position_x = new_x;
+		if (GetType() == Event) {
+			OnEventMoved();
+		}
+	}
 }
 
 inline int Game_Character::GetY() const {
@@ -942,7 +982,12 @@ inline int Game_Character::GetY() const {
 }
 
 inline void Game_Character::SetY(int new_y) {
-	data()->position_y = new_y;
+	if (data()->position_y != new_y) {
+		data()->position_y = new_y;
+		if (GetType() == Event) {
+			OnEventMoved();
+		}
+	}
 }
 
 inline int Game_Character::GetMapId() const {
@@ -1011,6 +1056,7 @@ inline const lcf::rpg::MoveRoute& Game_Character::GetMoveRoute() const {
 
 inline void Game_Character::SetMoveRoute(const lcf::rpg::MoveRoute& move_route) {
 	data()->move_route = move_route;
+	move_route_programs[true] = {};
 }
 
 inline int Game_Character::GetMoveRouteIndex() const {
@@ -1042,8 +1088,20 @@ inline const std::string& Game_Character::GetSpriteName() const {
 }
 
 inline void Game_Character::SetSpriteGraphic(std::string sprite_name, int index) {
+	if (data()->sprite_name == sprite_name && data()->sprite_id == index) {
+		return;
+	}
 	data()->sprite_name = std::move(sprite_name);
 	data()->sprite_id = index;
+	OnSpriteChanged();
+}
+
+inline uint32_t Game_Character::GetSpriteRevision() const {
+	return sprite_revision;
+}
+
+inline void Game_Character::OnSpriteChanged() {
+	sprite_revision = ++next_sprite_revision;
 }
 
 inline void Game_Character::MoveRouteSetSpriteGraphic(std::string sprite_name, int index) {
@@ -28,13 +28,22 @@ Game_Clock::Data Game_Clock::data;
 // Damping factor fps computation.
 static constexpr auto _fps_smooth = 2.0f / 121.0f;
 
+// Upper bound of the sleep margin, yielding longer than that wastes too much CPU
+static constexpr auto _max_sleep_margin = std::chrono::milliseconds(4);
+
 Game_Clock::duration Game_Clock::OnNextFrame(time_point now) {
 	const auto mfa = std::chrono::duration_cast<duration>(data.max_frame_accumulator * data.speed);
 
 	const auto dt = now - data.frame_time;
 	data.frame_time = now;
-	data.frame_accumulator += std::chrono::duration_cast<duration>(dt * data.speed);
-	data.frame_accumulator = std::min(data.frame_accumulator, mfa);
+	// Strict pacing advances the game by one step per frame, whatever the real time was
+	const auto frame_dt = data.pacing == Pacing::Strict ? duration(GetTargetGameTimeStep()) : dt;
+	data.frame_accumulator += std::chrono::duration_cast<duration>(frame_dt * data.speed);
+	if (data.frame_accumulator > mfa) {
+		data.dropped_steps += static_cast<int>((data.frame_accumulator - mfa) / GetTargetGameTimeStep());
+		data.frame_accumulator = mfa;
+	}
+	data.frame_steps = 0;
 
 	const auto fps = (1.0f / std::chrono::duration<float>(dt).count());
 	data.fps = (data.fps * _fps_smooth) + (fps * (1.0f - _fps_smooth));
@@ -47,12 +56,43 @@ Game_Clock::duration Game_Clock::OnNextFrame(time_point now) {
 void Game_Clock::ResetFrame(time_point now, bool reset_frame_counter) {
 	data.frame_time = now;
 	data.frame_accumulator = {};
+	data.frame_steps = 0;
 	data.fps = 0.0;
 	if (reset_frame_counter) {
 		data.frame = 0;
 	}
 }
 
+void Game_Clock::SleepUntil(time_point deadline) {
+	auto& stats = data.sleep_stats;
+	auto now = clock::now();
+
+	if (now + stats.margin < deadline) {
+		const auto coarse_end = deadline - stats.margin;
+		clock::SleepFor(coarse_end - now);
+		now = clock::now();
+
+		// Calibrate: Grow at once when the sleep overshot, shrink slowly back to the platform margin
+		const auto base = std::chrono::duration_cast<duration>(clock::SleepMargin());
+		const auto target = now > coarse_end ? base + (now - coarse_end) : base;
+		if (target > stats.margin) {
+			stats.margin = std::min(target, std::chrono::duration_cast<duration>(_max_sleep_margin));
+		} else {
+			stats.margin -= (stats.margin - target) / 16;
+		}
+	}
+
+	while (now < deadline) {
+		clock::YieldThread();
+		now = clock::now();
+	}
+
+	const auto late = now - deadline;
+	++stats.sleeps;
+	stats.total_late += late;
+	stats.max_late = std::max(stats.max_late, late);
+}
+
 void Game_Clock::logClockInfo() {
 	const char* period_name = "custom";
 	if (std::is_same<period,std::nano>::value) {
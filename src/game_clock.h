@@ -23,6 +23,7 @@
 #include "platform_clock.h"
 #include <type_traits>
 #include <algorithm>
+#include <limits>
 
 /**
  * Used for time keeping in Player
@@ -38,6 +39,30 @@ public:
 
 	static constexpr bool is_steady = clock::is_steady;
 
+	/** How logic steps are scheduled between the drawn frames */
+	enum class Pacing {
+		/** Logic runs at the target rate, drawing is skipped to catch up when slow */
+		FixedStep,
+		/** One logic step per drawn frame, for displays synced to the target rate */
+		Strict
+	};
+
+	/** How precisely SleepUntil woke up at the deadlines */
+	struct SleepStats {
+		int sleeps = 0;
+		/** Sum of the time the wake ups were late */
+		duration total_late = {};
+		/** Latest wake up */
+		duration max_late = {};
+		/** Calibrated time before the deadline where the coarse sleep ends */
+		duration margin = {};
+
+		/** @return mean lateness in ms */
+		double GetMeanLate() const {
+			return sleeps > 0 ? std::chrono::duration<double, std::milli>(total_late).count() / sleeps : 0.0;
+		}
+	};
+
 	/** Get current time */
 	static time_point now();
 
@@ -45,6 +70,18 @@ public:
 	template <typename R, typename P>
 	static void SleepFor(std::chrono::duration<R,P> dt);
 
+	/**
+	 * Sleep until the deadline with low jitter.
+	 * Sleeps coarsely until a calibrated margin before the deadline and yields
+	 * for the rest. The margin follows how much the coarse sleeps overshoot.
+	 *
+	 * @param deadline time to wake up at
+	 */
+	static void SleepUntil(time_point deadline);
+
+	/** @return precision of the SleepUntil calls so far */
+	static SleepStats GetSleepStats();
+
 	/** Get the target frames per second for the game simulation */
 	static constexpr int GetTargetGameFps();
 
@@ -70,6 +107,27 @@ public:
 	 */
 	static void SetMaxGameTimePerFrame(duration dt);
 
+	/** Set how logic steps are scheduled, FixedStep by default */
+	static void SetPacing(Pacing pacing);
+
+	/** @return how logic steps are scheduled */
+	static Pacing GetPacing();
+
+	/**
+	 * Set how many logic steps may run in a frame without drawing in between.
+	 * When a frame is later than that, the missing steps are dropped and the
+	 * game runs slower instead of skipping further draws.
+	 *
+	 * @param frames max number of skipped draws per frame
+	 */
+	static void SetMaxFrameSkip(int frames);
+
+	/** @return number of logic steps run without being drawn, each one missed its deadline */
+	static int GetSkippedDraws();
+
+	/** @return number of logic steps dropped because a frame was too late */
+	static int GetDroppedSteps();
+
 	/** Set the speed up or slowdown factor we'll use to run the game. */
 	static void SetGameSpeedFactor(float speed);
 
@@ -117,6 +175,13 @@ private:
 		float speed = 1.0;
 		float fps = 0.0;
 		int frame = 0;
+		Pacing pacing = Pacing::FixedStep;
+		int max_frame_skip = std::numeric_limits<int>::max();
+		/** Logic steps run since the last OnNextFrame */
+		int frame_steps = 0;
+		int skipped_draws = 0;
+		int dropped_steps = 0;
+		SleepStats sleep_stats = { 0, {}, {}, std::chrono::duration_cast<duration>(clock::SleepMargin()) };
 	};
 	static Data data;
 };
@@ -164,7 +229,16 @@ inline bool Game_Clock::NextGameTimeStep() {
 	if (data.frame_accumulator < dt) {
 		return false;
 	}
+	if (data.frame_steps > data.max_frame_skip) {
+		// Too late, run slower instead of skipping more draws
+		data.dropped_steps += static_cast<int>(data.frame_accumulator / dt);
+		data.frame_accumulator %= dt;
+		return false;
+	}
 	data.frame_accumulator -= dt;
+	if (++data.frame_steps > 1) {
+		++data.skipped_draws;
+	}
 	return true;
 }
 
@@ -180,4 +254,28 @@ inline float Game_Clock::GetGameSpeedFactor() {
 	return data.speed;
 }
 
+inline void Game_Clock::SetPacing(Pacing pacing) {
+	data.pacing = pacing;
+}
+
+inline Game_Clock::SleepStats Game_Clock::GetSleepStats() {
+	return data.sleep_stats;
+}
+
+inline Game_Clock::Pacing Game_Clock::GetPacing() {
+	return data.pacing;
+}
+
+inline void Game_Clock::SetMaxFrameSkip(int frames) {
+	data.max_frame_skip = std::max(frames, 0);
+}
+
+inline int Game_Clock::GetSkippedDraws() {
+	return data.skipped_draws;
+}
+
+inline int Game_Clock::GetDroppedSteps() {
+	return data.dropped_steps;
+}
+
 #endif
@@ -21,6 +21,7 @@
 #include "game_switches.h"
 #include "game_interpreter_map.h"
 #include "main_data.h"
+#include "player.h"
 #include <lcf/reader_util.h>
 #include <cassert>
 
@@ -86,6 +87,8 @@ int Game_CommonEvent::GetTrigger() const {
 }
 
 std::vector<lcf::rpg::EventCommand>& Game_CommonEvent::GetList() {
+	// Translated when executed the first time
+	Player::translation.RewriteCommonEventMessages(common_event_id);
 	return lcf::ReaderUtil::GetElement(lcf::Data::commonevents, common_event_id)->event_commands;
 }
 
@@ -94,6 +94,14 @@ void Game_Config::LoadFromArgs(CmdlineParser& cp) {
 			video.show_fps.Set(false);
 			continue;
 		}
+		if (cp.ParseNext(arg, 0, "--show-frame-stats")) {
+			video.show_frame_stats.Set(true);
+			continue;
+		}
+		if (cp.ParseNext(arg, 0, "--no-show-frame-stats")) {
+			video.show_frame_stats.Set(false);
+			continue;
+		}
 		if (cp.ParseNext(arg, 0, "--fps-render-window")) {
 			video.fps_render_window.Set(true);
 			continue;
@@ -116,6 +124,96 @@ void Game_Config::LoadFromArgs(CmdlineParser& cp) {
 			}
 			continue;
 		}
+		if (cp.ParseNext(arg, 0, "--hardware-render")) {
+			video.hardware_render.Set(true);
+			continue;
+		}
+		if (cp.ParseNext(arg, 0, "--no-hardware-render")) {
+			video.hardware_render.Set(false);
+			continue;
+		}
+		if (cp.ParseNext(arg, 1, "--draw-threads")) {
+			if (arg.ParseValue(0, li_value)) {
+				video.draw_threads.Set(li_value);
+			}
+			continue;
+		}
+		if (cp.ParseNext(arg, 1, "--frame-pacing")) {
+			std::string svalue;
+			if (arg.ParseValue(0, svalue)) {
+				video.frame_pacing.Set(std::move(svalue));
+			}
+			continue;
+		}
+		if (cp.ParseNext(arg, 1, "--max-frameskip")) {
+			if (arg.ParseValue(0, li_value)) {
+				video.max_frameskip.Set(li_value);
+			}
+			continue;
+		}
+		if (cp.ParseNext(arg, 0, "--headless")) {
+			video.headless.Set(true);
+			continue;
+		}
+		if (cp.ParseNext(arg, 1, "--headless-output")) {
+			std::string svalue;
+			if (arg.ParseValue(0, svalue)) {
+				video.headless_output.Set(std::move(svalue));
+			}
+			continue;
+		}
+		if (cp.ParseNext(arg, 1, "--screenshot-compression")) {
+			if (arg.ParseValue(0, li_value)) {
+				video.screenshot_compression.Set(li_value);
+			}
+			continue;
+		}
+		if (cp.ParseNext(arg, 0, "--pipelined")) {
+			video.pipelined.Set(true);
+			continue;
+		}
+		if (cp.ParseNext(arg, 0, "--no-pipelined")) {
+			video.pipelined.Set(false);
+			continue;
+		}
+		if (cp.ParseNext(arg, 1, "--cache-size")) {
+			if (arg.ParseValue(0, li_value)) {
+				player.cache_size.Set(li_value);
+			}
+			continue;
+		}
+		if (cp.ParseNext(arg, 1, "--decode-threads")) {
+			if (arg.ParseValue(0, li_value)) {
+				player.decode_threads.Set(li_value);
+			}
+			continue;
+		}
+		if (cp.ParseNext(arg, 1, "--simd")) {
+			std::string svalue;
+			if (arg.ParseValue(0, svalue)) {
+				player.simd.Set(std::move(svalue));
+			}
+			continue;
+		}
+		if (cp.ParseNext(arg, 1, "--interpreter-budget")) {
+			if (arg.ParseValue(0, li_value)) {
+				player.interpreter_budget.Set(li_value);
+			}
+			continue;
+		}
+		if (cp.ParseNext(arg, 1, "--asset-cache")) {
+			std::string svalue;
+			if (arg.ParseValue(0, svalue)) {
+				player.asset_cache_path.Set(std::move(svalue));
+			}
+			continue;
+		}
+		if (cp.ParseNext(arg, 1, "--audio-buffer")) {
+			if (arg.ParseValue(0, li_value)) {
+				audio.buffer_size.Set(li_value);
+			}
+			continue;
+		}
 		if (cp.ParseNext(arg, 1, "--autobattle-algo")) {
 			std::string svalue;
 			if (arg.ParseValue(0, svalue)) {
@@ -154,6 +252,21 @@ void Game_Config::LoadFromConfig(const std::string& path) {
 	if (ini.HasValue("player", "enemyai-algo")) {
 		player.enemyai_algo.Set(ini.GetString("player", "enemyai-algo", "RPG_RT"));
 	}
+	if (ini.HasValue("player", "cache-size")) {
+		player.cache_size.Set(ini.GetInteger("player", "cache-size", DEFAULT_CACHE_SIZE));
+	}
+	if (ini.HasValue("player", "asset-cache")) {
+		player.asset_cache_path.Set(ini.GetString("player", "asset-cache", ""));
+	}
+	if (ini.HasValue("player", "decode-threads")) {
+		player.decode_threads.Set(ini.GetInteger("player", "decode-threads", 0));
+	}
+	if (ini.HasValue("player", "interpreter-budget")) {
+		player.interpreter_budget.Set(ini.GetInteger("player", "interpreter-budget", 0));
+	}
+	if (ini.HasValue("player", "simd")) {
+		player.simd.Set(ini.GetString("player", "simd", "auto"));
+	}
 
 	/** VIDEO SECTION */
 
@@ -166,6 +279,9 @@ void Game_Config::LoadFromConfig(const std::string& path) {
 	if (ini.HasValue("video", "show-fps")) {
 		video.show_fps.Set(ini.GetBoolean("video", "show-fps", false));
 	}
+	if (ini.HasValue("video", "show-frame-stats")) {
+		video.show_frame_stats.Set(ini.GetBoolean("video", "show-frame-stats", false));
+	}
 	if (ini.HasValue("video", "fps-render-window")) {
 		video.fps_render_window.Set(ini.GetBoolean("video", "fps-render-window", false));
 	}
@@ -175,9 +291,31 @@ void Game_Config::LoadFromConfig(const std::string& path) {
 	if (ini.HasValue("video", "window-zoom")) {
 		video.window_zoom.Set(ini.GetInteger("video", "window-zoom", 0));
 	}
+	if (ini.HasValue("video", "hardware-render")) {
+		video.hardware_render.Set(ini.GetBoolean("video", "hardware-render", false));
+	}
+	if (ini.HasValue("video", "draw-threads")) {
+		video.draw_threads.Set(ini.GetInteger("video", "draw-threads", 1));
+	}
+	if (ini.HasValue("video", "frame-pacing")) {
+		video.frame_pacing.Set(ini.GetString("video", "frame-pacing", "fixed"));
+	}
+	if (ini.HasValue("video", "max-frameskip")) {
+		video.max_frameskip.Set(ini.GetInteger("video", "max-frameskip", 12));
+	}
+	if (ini.HasValue("video", "pipelined")) {
+		video.pipelined.Set(ini.GetBoolean("video", "pipelined", false));
+	}
+	if (ini.HasValue("video", "screenshot-compression")) {
+		video.screenshot_compression.Set(ini.GetInteger("video", "screenshot-compression", -1));
+	}
 
 	/** AUDIO SECTION */
 
+	if (ini.HasValue("audio", "buffer-size")) {
+		audio.buffer_size.Set(ini.GetInteger("audio", "buffer-size", 0));
+	}
+
 	/** INPUT SECTION */
 }
 
@@ -193,6 +331,19 @@ void Game_Config::WriteToConfig(const std::string& path) const {
 	of << "[player]\n";
 	of << "autobattle-algo=" << player.autobattle_algo.Get() << "\n";
 	of << "enemyai-algo=" << player.enemyai_algo.Get() << "\n";
+	if (player.cache_size.Enabled()) {
+		of << "cache-size=" << player.cache_size.Get() << "\n";
+	}
+	if (!player.asset_cache_path.Get().empty()) {
+		of << "asset-cache=" << player.asset_cache_path.Get() << "\n";
+	}
+	if (player.decode_threads.Enabled()) {
+		of << "decode-threads=" << player.decode_threads.Get() << "\n";
+	}
+	if (player.interpreter_budget.Enabled()) {
+		of << "interpreter-budget=" << player.interpreter_budget.Get() << "\n";
+	}
+	of << "simd=" << player.simd.Get() << "\n";
 	of << "\n";
 
 	/** VIDEO SECTION */
@@ -207,6 +358,9 @@ void Game_Config::WriteToConfig(const std::string& path) const {
 	if (video.show_fps.Enabled()) {
 		of << "show-fps=" << int(video.show_fps.Get()) << "\n";
 	}
+	if (video.show_frame_stats.Enabled()) {
+		of << "show-frame-stats=" << int(video.show_frame_stats.Get()) << "\n";
+	}
 	if (video.fps_render_window.Enabled()) {
 		of << "fps-render-window=" << int(video.fps_render_window.Get()) << "\n";
 	}
@@ -216,10 +370,32 @@ void Game_Config::WriteToConfig(const std::string& path) const {
 	if (video.window_zoom.Enabled()) {
 		of << "window-zoom=" << video.window_zoom.Get() << "\n";
 	}
+	if (video.hardware_render.Enabled()) {
+		of << "hardware-render=" << int(video.hardware_render.Get()) << "\n";
+	}
+	if (video.draw_threads.Enabled()) {
+		of << "draw-threads=" << video.draw_threads.Get() << "\n";
+	}
+	of << "frame-pacing=" << video.frame_pacing.Get() << "\n";
+	if (video.max_frameskip.Enabled()) {
+		of << "max-frameskip=" << video.max_frameskip.Get() << "\n";
+	}
+	if (video.pipelined.Enabled()) {
+		of << "pipelined=" << int(video.pipelined.Get()) << "\n";
+	}
+	if (video.screenshot_compression.Enabled()) {
+		of << "screenshot-compression=" << video.screenshot_compression.Get() << "\n";
+	}
 	of << "\n";
 
 	/** AUDIO SECTION */
 
+	of << "[audio]\n";
+	if (audio.buffer_size.Enabled()) {
+		of << "buffer-size=" << audio.buffer_size.Get() << "\n";
+	}
+	of << "\n";
+
 	/** INPUT SECTION */
 }
 
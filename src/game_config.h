@@ -26,6 +26,16 @@ class CmdlineParser;
 struct Game_ConfigPlayer {
 	StringConfigParam autobattle_algo{ "RPG_RT" };
 	StringConfigParam enemyai_algo{ "RPG_RT" };
+	/** Size limit of the bitmap cache in MiB */
+	RangeConfigParam<int> cache_size{ DEFAULT_CACHE_SIZE, 1, 4096 };
+	/** Images decoded at once in the background, 0 decodes on the main thread */
+	RangeConfigParam<int> decode_threads{ 0, 0, 16 };
+	/** Directory of the decoded image cache, empty when disabled */
+	StringConfigParam asset_cache_path{ "" };
+	/** Milliseconds all event interpreters may run per frame, 0 for no limit */
+	RangeConfigParam<int> interpreter_budget{ 0, 0, 1000 };
+	/** Highest instruction set extension of the SIMD kernels, see CpuFeatures::SetOverride */
+	StringConfigParam simd{ "auto" };
 };
 
 struct Game_ConfigVideo {
@@ -33,11 +43,28 @@ struct Game_ConfigVideo {
 	BoolConfigParam fullscreen{ true };
 	BoolConfigParam show_fps{ false };
 	BoolConfigParam fps_render_window{ false };
+	/** Show the frame time breakdown below the FPS counter */
+	BoolConfigParam show_frame_stats{ false };
 	RangeConfigParam<int> fps_limit{ DEFAULT_FPS, 0, std::numeric_limits<int>::max() };
 	RangeConfigParam<int> window_zoom{ 2, 1, std::numeric_limits<int>::max() };
+	RangeConfigParam<int> draw_threads{ 1, 1, 64 };
+	/** Composite the next frame while the previous one is presented */
+	BoolConfigParam pipelined{ false };
+	/** "fixed" or "strict", see Game_Clock::Pacing */
+	StringConfigParam frame_pacing{ "fixed" };
+	RangeConfigParam<int> max_frameskip{ 12, 0, 60 };
+	/** Run without a window, audio and frame limit */
+	BoolConfigParam headless{ false };
+	/** PNG of the last frame written in headless mode, empty when disabled */
+	StringConfigParam headless_output{ "" };
+	BoolConfigParam hardware_render{ false };
+	/** zlib level of screenshots, -1 for the default, 0 writes uncompressed PNGs for rapid captures */
+	RangeConfigParam<int> screenshot_compression{ -1, -1, 9 };
 };
 
 struct Game_ConfigAudio {
+	/** Frames of the audio output buffer, 0 uses the default of the platform */
+	RangeConfigParam<int> buffer_size{ 0, 0, 65536 };
 };
 
 struct Game_ConfigInput {
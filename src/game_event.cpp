@@ -59,7 +59,13 @@ void Game_Event::SetSaveData(lcf::rpg::SaveMapEvent save)
 {
 	// 2k Savegames have 0 for the mapid for compatibility with RPG_RT.
 	auto map_id = GetMapId();
+	// Only loaded into the interpreter, GetSaveData takes it from there
+	auto state = std::move(save.parallel_event_execstate);
+	save.parallel_event_execstate = {};
 	*data() = std::move(save);
+	ResetMoveRoutePrograms();
+	Game_Map::OnEventStateChanged();
+	OnSpriteChanged();
 
 	data()->ID = event->ID;
 	SetMapId(map_id);
@@ -75,7 +81,6 @@ void Game_Event::SetSaveData(lcf::rpg::SaveMapEvent save)
 	}
 
 	if (GetTrigger() == lcf::rpg::EventPage::Trigger_parallel) {
-		auto& state = data()->parallel_event_execstate;
 		// RPG_RT Savegames have empty stacks for parallel events.
 		// We are LSD compatible but don't load these into interpreter.
 		bool has_state = (!state.stack.empty() && !state.stack.front().commands.empty());
@@ -157,7 +162,10 @@ void Game_Event::RefreshPage() {
 		ClearWaitingForegroundExecution();
 		SetPaused(false);
 		SetThrough(true);
-		this->page = new_page;
+		if (this->page) {
+			this->page = new_page;
+			Game_Map::OnEventStateChanged();
+		}
 		return;
 	}
 
@@ -169,6 +177,7 @@ void Game_Event::RefreshPage() {
 	SetPaused(false);
 	const auto* old_page = page;
 	page = new_page;
+	Game_Map::OnEventStateChanged();
 
 	SetSpriteGraphic(ToString(page->character_name), page->character_index);
 
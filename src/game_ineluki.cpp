@@ -86,120 +86,132 @@ bool Game_Ineluki::Execute(const lcf::rpg::Sound& se) {
 		return true;
 	}
 
-	std::string ini_file = FileFinder::FindSound(se.name);
-	if (!ini_file.empty()) {
-		return Execute(ini_file);
-	} else {
-		Output::Debug("Ineluki: Script {} not found", se.name);
+	auto name = ToString(se.name);
+	auto path_it = script_paths.find(name);
+	if (path_it == script_paths.end()) {
+		std::string ini_file = FileFinder::FindSound(se.name);
+		if (ini_file.empty()) {
+			Output::Debug("Ineluki: Script {} not found", se.name);
+			return false;
+		}
+		path_it = script_paths.emplace(std::move(name), std::move(ini_file)).first;
 	}
-	return false;
+	return Execute(path_it->second);
 }
 
 bool Game_Ineluki::Execute(StringView ini_file) {
 	auto ini_file_s = ToString(ini_file);
 
-	if (functions.find(ini_file_s) == functions.end()) {
+	auto it = functions.find(ini_file_s);
+	if (it == functions.end()) {
 		if (!Parse(ini_file)) {
 			return false;
 		}
+		it = functions.find(ini_file_s);
 	}
 
-	for (const auto& cmd : functions[ini_file_s]) {
-		//Output::Debug("Ineluki {} {}", cmd.name, cmd.arg);
-
-		if (cmd.name == "writetolog") {
-			Output::InfoStr(cmd.arg);
-		} else if (cmd.name == "execprogram") {
-			// Fake execute some known programs
-			if (StringView(cmd.arg).starts_with("exitgame") ||
-					StringView(cmd.arg).starts_with("taskkill")) {
-				Player::exit_flag = true;
-			} else if (StringView(cmd.arg).starts_with("SaveCount.dat")) {
-				// no-op, detected through saves.script access
-			} else {
-				Output::Warning("Ineluki ExecProgram {}: Not supported", cmd.arg);
-			}
-		} else if (cmd.name == "mcicommand") {
-			Output::Warning("Ineluki MciProgram {}: Not supported", cmd.arg);
-		} else if (cmd.name == "miditickfunction") {
-			std::string arg = Utils::LowerCase(cmd.arg);
-			if (arg == "original") {
-				output_mode = OutputMode::Original;
-			} else if (arg == "output") {
-				output_mode = OutputMode::Output;
-			} else if (arg == "clear") {
-				output_list.clear();
-			}
-		} else if (cmd.name == "addoutput") {
-			output_list.push_back(atoi(cmd.arg.c_str()));
-		} else if (cmd.name == "enablekeysupport") {
-			bool prev_key_support = key_support;
-			key_support = Utils::LowerCase(cmd.arg) == "true";
+	if (!it->second.valid) {
+		return false;
+	}
+
+	using Type = InelukiCommand::Type;
+
+	for (const auto& cmd : it->second.commands) {
+		switch (cmd.type) {
+			case Type::WriteToLog:
+				Output::InfoStr(cmd.arg);
+				break;
+			case Type::ExecProgram:
+				// Fake execute some known programs
+				if (StringView(cmd.arg).starts_with("exitgame") ||
+						StringView(cmd.arg).starts_with("taskkill")) {
+					Player::exit_flag = true;
+				} else if (StringView(cmd.arg).starts_with("SaveCount.dat")) {
+					// no-op, detected through saves.script access
+				} else {
+					Output::Warning("Ineluki ExecProgram {}: Not supported", cmd.arg);
+				}
+				break;
+			case Type::MciCommand:
+				Output::Warning("Ineluki MciProgram {}: Not supported", cmd.arg);
+				break;
+			case Type::MidiTickFunction:
+				if (cmd.arg == "original") {
+					output_mode = OutputMode::Original;
+				} else if (cmd.arg == "output") {
+					output_mode = OutputMode::Output;
+				} else if (cmd.arg == "clear") {
+					output_list.clear();
+				}
+				break;
+			case Type::AddOutput:
+				output_list.push_back(cmd.value);
+				break;
+			case Type::EnableKeySupport: {
+				bool prev_key_support = key_support;
+				key_support = cmd.enable;
 
 #if !defined(SUPPORT_KEYBOARD)
-			if (key_support) {
-				Output::Warning("Ineluki: Keyboard input is not supported on this platform");
-			}
+				(void)prev_key_support;
+				if (key_support) {
+					Output::Warning("Ineluki: Keyboard input is not supported on this platform");
+				}
 #else
-			if (prev_key_support != key_support) {
-				Output::Debug("Ineluki: Key support is now {}", key_support ? "Enabled" : "Disabled");
-			}
+				if (prev_key_support != key_support) {
+					Output::Debug("Ineluki: Key support is now {}", key_support ? "Enabled" : "Disabled");
+				}
 
-			mask_kb(key_support);
+				mask_kb(key_support);
 #endif
-		} else if (cmd.name == "registerkeydownevent") {
-			std::string arg_lower = Utils::LowerCase(cmd.arg);
-			auto it = std::find_if(key_to_ineluki.begin(), key_to_ineluki.end(), [&](const auto& k) {
-				return !strcmp(arg_lower.c_str(), k.name);
-			});
-			if (it != key_to_ineluki.end()) {
-				keylist_down.push_back({it->key, atoi(cmd.arg2.c_str())});
+				break;
 			}
-		} else if (cmd.name == "registerkeyupevent") {
-			std::string arg_lower = Utils::LowerCase(cmd.arg);
-			auto it = std::find_if(key_to_ineluki.begin(), key_to_ineluki.end(), [&](const auto& k) {
-				return !strcmp(arg_lower.c_str(), k.name);
-			});
-			if (it != key_to_ineluki.end()) {
-				keylist_up.push_back({it->key, atoi(cmd.arg2.c_str())});
-			}
-		} else if (cmd.name == "enablemousesupport") {
-			bool prev_mouse_support = mouse_support;
-			mouse_support = Utils::LowerCase(cmd.arg) == "true";
-			mouse_id_prefix = atoi(cmd.arg2.c_str());
-			// TODO: automatic (append mouse pos every 500ms) not implemented
+			case Type::RegisterKeyDownEvent:
+				keylist_down.push_back({cmd.key, cmd.value});
+				break;
+			case Type::RegisterKeyUpEvent:
+				keylist_up.push_back({cmd.key, cmd.value});
+				break;
+			case Type::EnableMouseSupport: {
+				bool prev_mouse_support = mouse_support;
+				mouse_support = cmd.enable;
+				mouse_id_prefix = cmd.value;
+				// TODO: automatic (append mouse pos every 500ms) not implemented
 #if !defined(USE_MOUSE) || !defined(SUPPORT_MOUSE)
-			if (mouse_support) {
-				Output::Debug("Ineluki: Mouse input is not supported on this platform");
-			}
+				(void)prev_mouse_support;
+				if (mouse_support) {
+					Output::Debug("Ineluki: Mouse input is not supported on this platform");
+				}
 #else
-			if (prev_mouse_support != mouse_support) {
-				Output::Debug("Ineluki: Mouse support is now {}", mouse_support ? "Enabled" : "Disabled");
-			}
+				if (prev_mouse_support != mouse_support) {
+					Output::Debug("Ineluki: Mouse support is now {}", mouse_support ? "Enabled" : "Disabled");
+				}
 
-			mask_mouse(mouse_support);
+				mask_mouse(mouse_support);
 #endif
-		} else if (cmd.name == "getmouseposition") {
-#if defined(USE_MOUSE) && defined(SUPPORT_MOUSE)
-			if (!mouse_support) {
-				return true;
+				break;
 			}
+			case Type::GetMousePosition: {
+#if defined(USE_MOUSE) && defined(SUPPORT_MOUSE)
+				if (!mouse_support) {
+					return true;
+				}
 
-			Point mouse_pos = Input::GetMousePosition();
+				Point mouse_pos = Input::GetMousePosition();
 
-			bool left = Input::IsRawKeyPressed(Input::Keys::MOUSE_LEFT);
-			bool right = Input::IsRawKeyPressed(Input::Keys::MOUSE_RIGHT);
-			int key = left && right ? 3 : right ? 2 : left ? 1 : 0;
+				bool left = Input::IsRawKeyPressed(Input::Keys::MOUSE_LEFT);
+				bool right = Input::IsRawKeyPressed(Input::Keys::MOUSE_RIGHT);
+				int key = left && right ? 3 : right ? 2 : left ? 1 : 0;
 
-			output_list.push_back(key);
-			output_list.push_back(mouse_pos.y);
-			output_list.push_back(mouse_pos.x);
-			output_list.push_back(mouse_id_prefix);
+				output_list.push_back(key);
+				output_list.push_back(mouse_pos.y);
+				output_list.push_back(mouse_pos.x);
+				output_list.push_back(mouse_id_prefix);
 #endif
-		} else if (cmd.name == "setdebuglevel") {
-			// no-op
-		} else if (cmd.name == "registercheatevent") {
-			cheatlist.emplace_back(Utils::LowerCase(cmd.arg), atoi(cmd.arg2.c_str()));
+				break;
+			}
+			case Type::RegisterCheatEvent:
+				cheatlist.emplace_back(cmd.arg, cmd.value);
+				break;
 		}
 	}
 
@@ -244,6 +256,8 @@ bool Game_Ineluki::Parse(StringView ini_file) {
 		return false;
 	}
 
+	auto& script = functions[ini_file_s];
+
 	lcf::INIReader ini(is);
 	if (ini.ParseError() == -1) {
 		return false;
@@ -251,59 +265,83 @@ bool Game_Ineluki::Parse(StringView ini_file) {
 
 	Output::Debug("Ineluki: Parsing script {}", FileFinder::GetPathInsideGamePath(ini_file_s));
 
+	using Type = InelukiCommand::Type;
+
+	auto find_key = [](const std::string& name, Input::Keys::InputKey& key) {
+		std::string name_lower = Utils::LowerCase(name);
+		auto it = std::find_if(key_to_ineluki.begin(), key_to_ineluki.end(), [&](const auto& k) {
+			return !strcmp(name_lower.c_str(), k.name);
+		});
+		if (it == key_to_ineluki.end()) {
+			return false;
+		}
+		key = it->key;
+		return true;
+	};
+
 	command_list commands;
 	std::string section = "execute";
 
 	do {
 		InelukiCommand cmd;
-		cmd.name = Utils::LowerCase(ini.Get(section, "action", std::string()));
+		std::string name = Utils::LowerCase(ini.Get(section, "action", std::string()));
 		bool valid = true;
 
-		if (cmd.name == "writetolog") {
+		if (name == "writetolog") {
+			cmd.type = Type::WriteToLog;
 			cmd.arg = ini.Get(section, "text", std::string());
-		} else if (cmd.name == "execprogram") {
+		} else if (name == "execprogram") {
+			cmd.type = Type::ExecProgram;
 			cmd.arg = ini.Get(section, "command", std::string());
-		} else if (cmd.name == "mcicommand") {
+		} else if (name == "mcicommand") {
+			cmd.type = Type::MciCommand;
 			cmd.arg = ini.Get(section, "command", std::string());
-		} else if (cmd.name == "miditickfunction") {
+		} else if (name == "miditickfunction") {
+			cmd.type = Type::MidiTickFunction;
 			cmd.arg = ini.Get(section, "command", std::string());
 			if (cmd.arg.empty()) {
 				cmd.arg = ini.Get(section, "value", std::string());
 			}
-		} else if (cmd.name == "addoutput") {
-			cmd.arg = ini.Get(section, "value", std::string());
-		} else if (cmd.name == "enablekeysupport") {
-			cmd.arg = ini.Get(section, "enable", std::string());
-		} else if (cmd.name == "registerkeydownevent") {
-			cmd.arg = ini.Get(section, "key", std::string());
-			cmd.arg2 = ini.Get(section, "value", std::string());
-		} else if (cmd.name == "registerkeyupevent") {
-			cmd.arg = ini.Get(section, "key", std::string());
-			cmd.arg2 = ini.Get(section, "value", std::string());
-		} else if (cmd.name == "enablemousesupport") {
-			cmd.arg = ini.Get(section, "enable", std::string());
-			cmd.arg2 = ini.Get(section, "id", std::string());
-			cmd.arg3 = ini.Get(section, "automatic", std::string());
-		} else if (cmd.name == "getmouseposition") {
-			// no args
-		} else if (cmd.name == "setdebuglevel") {
-			cmd.arg = ini.Get(section, "level", std::string());
-		} else if (cmd.name == "registercheatevent") {
-			cmd.arg = ini.Get(section, "cheat", std::string());
-			cmd.arg2 = ini.Get(section, "value", std::string());
+			cmd.arg = Utils::LowerCase(cmd.arg);
+		} else if (name == "addoutput") {
+			cmd.type = Type::AddOutput;
+			cmd.value = atoi(ini.Get(section, "value", std::string()).c_str());
+		} else if (name == "enablekeysupport") {
+			cmd.type = Type::EnableKeySupport;
+			cmd.enable = Utils::LowerCase(ini.Get(section, "enable", std::string())) == "true";
+		} else if (name == "registerkeydownevent" || name == "registerkeyupevent") {
+			cmd.type = name == "registerkeydownevent" ? Type::RegisterKeyDownEvent : Type::RegisterKeyUpEvent;
+			cmd.value = atoi(ini.Get(section, "value", std::string()).c_str());
+			// Unknown keys are ignored
+			valid = find_key(ini.Get(section, "key", std::string()), cmd.key);
+		} else if (name == "enablemousesupport") {
+			cmd.type = Type::EnableMouseSupport;
+			cmd.enable = Utils::LowerCase(ini.Get(section, "enable", std::string())) == "true";
+			cmd.value = atoi(ini.Get(section, "id", std::string()).c_str());
+			// "automatic" is not supported
+		} else if (name == "getmouseposition") {
+			cmd.type = Type::GetMousePosition;
+		} else if (name == "setdebuglevel") {
+			// no-op
+			valid = false;
+		} else if (name == "registercheatevent") {
+			cmd.type = Type::RegisterCheatEvent;
+			cmd.arg = Utils::LowerCase(ini.Get(section, "cheat", std::string()));
+			cmd.value = atoi(ini.Get(section, "value", std::string()).c_str());
 		} else {
-			Output::Debug("Ineluki: Unknown command {}", cmd.name);
+			Output::Debug("Ineluki: Unknown command {}", name);
 			valid = false;
 		}
 
 		if (valid) {
-			commands.push_back(cmd);
+			commands.push_back(std::move(cmd));
 		}
 
 		section = ini.Get(section, "next", std::string());
 	} while (!section.empty());
 
-	functions[ini_file_s] = commands;
+	script.valid = true;
+	script.commands = std::move(commands);
 
 	return true;
 }
@@ -338,6 +376,10 @@ void Game_Ineluki::Update() {
 		}
 	}
 
+	// Fetched once per frame when any cheat needs it
+	Input::KeyStatus pressed;
+	bool have_pressed = false;
+
 	for (auto& cheat: cheatlist) {
 		if (cheat.keys.empty()) {
 			continue;
@@ -350,12 +392,18 @@ void Game_Ineluki::Update() {
 				cheat.index = 0;
 			}
 		} else if (cheat.index > 0) {
-			auto pressed = Input::GetAllRawPressed();
+			if (!have_pressed) {
+				pressed = Input::GetAllRawPressed();
+				have_pressed = true;
+			}
 			// Don't reset when the previous cheat key is (still) pressed
-			pressed[cheat.keys[cheat.index - 1]] = false;
+			const auto prev_key = cheat.keys[cheat.index - 1];
+			const bool prev_pressed = pressed[prev_key];
+			pressed[prev_key] = false;
 			if (pressed.any()) {
 				cheat.index = 0;
 			}
+			pressed[prev_key] = prev_pressed;
 		}
 	}
 }
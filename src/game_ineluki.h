@@ -87,15 +87,46 @@ private:
 	 */
 	bool Parse(StringView ini_file);
 
+	/** A script command with its arguments converted when parsing */
 	struct InelukiCommand {
-		std::string name;
+		enum class Type {
+			WriteToLog,
+			ExecProgram,
+			MciCommand,
+			MidiTickFunction,
+			AddOutput,
+			EnableKeySupport,
+			RegisterKeyDownEvent,
+			RegisterKeyUpEvent,
+			EnableMouseSupport,
+			GetMousePosition,
+			RegisterCheatEvent
+		};
+
+		Type type;
+		/** Text argument, lowercase for MidiTickFunction and RegisterCheatEvent */
 		std::string arg;
-		std::string arg2;
-		std::string arg3;
+		/** Numeric argument */
+		int value = 0;
+		/** Whether EnableKeySupport and EnableMouseSupport enable */
+		bool enable = false;
+		/** Key of RegisterKeyDownEvent and RegisterKeyUpEvent */
+		Input::Keys::InputKey key = Input::Keys::NONE;
 	};
 
 	using command_list = std::vector<InelukiCommand>;
-	std::map<std::string, command_list> functions;
+
+	struct Script {
+		/** Whether the file was a valid script, invalid files are not parsed again */
+		bool valid = false;
+		command_list commands;
+	};
+
+	/** Parsed scripts by path */
+	std::map<std::string, Script> functions;
+
+	/** Paths of the script sound effects by name */
+	std::map<std::string, std::string> script_paths;
 
 	enum class OutputMode {
 		/** GetMidiTicks returns the audio ticks */
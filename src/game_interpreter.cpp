@@ -45,6 +45,9 @@
 #include "scene_map.h"
 #include "scene.h"
 #include "game_clock.h"
+#include "frame_stats.h"
+#include "instrumentation.h"
+#include "memory_stats.h"
 #include "input.h"
 #include "main_data.h"
 #include "output.h"
@@ -66,6 +69,25 @@ constexpr int Game_Interpreter::loop_limit;
 constexpr int Game_Interpreter::call_stack_limit;
 constexpr int Game_Interpreter::subcommand_sentinel;
 
+namespace {
+	/** Time all interpreters may run per frame, zero when unlimited */
+	Game_Clock::duration frame_budget = {};
+	/** Time the interpreters ran in the current frame */
+	Game_Clock::duration frame_budget_used = {};
+}
+
+void Game_Interpreter::SetFrameBudget(Game_Clock::duration budget) {
+	frame_budget = budget;
+}
+
+Game_Clock::duration Game_Interpreter::GetFrameBudget() {
+	return frame_budget;
+}
+
+void Game_Interpreter::ResetFrameBudget() {
+	frame_budget_used = {};
+}
+
 Game_Interpreter::Game_Interpreter(bool _main_flag) {
 	main_flag = _main_flag;
 
@@ -73,6 +95,7 @@ Game_Interpreter::Game_Interpreter(bool _main_flag) {
 }
 
 Game_Interpreter::~Game_Interpreter() {
+	MemoryStats::Add(MemoryStats::Category::Interpreter, -static_cast<int64_t>(accounted_bytes));
 }
 
 // Clear.
@@ -80,6 +103,24 @@ void Game_Interpreter::Clear() {
 	_state = {};
 	_keyinput = {};
 	_async_op = {};
+	frame_lists.clear();
+	frame_sources.clear();
+	UpdateMemoryStats();
+}
+
+void Game_Interpreter::UpdateMemoryStats() {
+	size_t bytes = MemoryStats::GetSize(_state.stack);
+	for (const auto& frame: _state.stack) {
+		bytes += MemoryStats::GetSize(frame.commands);
+	}
+	// Shared lists are counted by every frame using them
+	for (const auto& list: frame_lists) {
+		if (list) {
+			bytes += list->GetMemorySize();
+		}
+	}
+	MemoryStats::Add(MemoryStats::Category::Interpreter, static_cast<int64_t>(bytes) - static_cast<int64_t>(accounted_bytes));
+	accounted_bytes = bytes;
 }
 
 // Is interpreter running.
@@ -91,7 +132,8 @@ bool Game_Interpreter::IsRunning() const {
 void Game_Interpreter::Push(
 	const std::vector<lcf::rpg::EventCommand>& _list,
 	int event_id,
-	bool started_by_decision_key
+	bool started_by_decision_key,
+	EventProfiler::Source source
 ) {
 	if (_list.empty()) {
 		return;
@@ -103,7 +145,6 @@ void Game_Interpreter::Push(
 
 	lcf::rpg::SaveEventExecFrame frame;
 	frame.ID = _state.stack.size() + 1;
-	frame.commands = _list;
 	frame.current_command = 0;
 	frame.triggered_by_decision_key = started_by_decision_key;
 	frame.event_id = event_id;
@@ -115,6 +156,48 @@ void Game_Interpreter::Push(
 	}
 
 	_state.stack.push_back(std::move(frame));
+	frame_lists.resize(_state.stack.size() - 1);
+	frame_lists.push_back(EventCommandList::Get(_list));
+	frame_sources.resize(_state.stack.size() - 1);
+	frame_sources.push_back(source);
+	UpdateMemoryStats();
+}
+
+const EventCommandList& Game_Interpreter::GetFrameList() {
+	assert(!_state.stack.empty());
+
+	const size_t idx = _state.stack.size() - 1;
+	if (frame_lists.size() < _state.stack.size()) {
+		frame_lists.resize(_state.stack.size());
+	}
+	auto& list = frame_lists[idx];
+	if (!list) {
+		// Frames restored from a savegame own their commands
+		auto& frame = _state.stack[idx];
+		list = std::make_shared<const EventCommandList>(std::move(frame.commands));
+		frame.commands.clear();
+	}
+	return *list;
+}
+
+EventProfiler::Source Game_Interpreter::GetFrameSource() const {
+	const size_t idx = _state.stack.size() - 1;
+	if (idx < frame_sources.size() && frame_sources[idx].type != EventProfiler::Type::Other) {
+		return frame_sources[idx];
+	}
+	// Savegames only know the event ID
+	EventProfiler::Source source;
+	source.type = _state.stack[idx].event_id != 0 ? EventProfiler::Type::MapEvent : EventProfiler::Type::Other;
+	source.id = _state.stack[idx].event_id;
+	return source;
+}
+
+const std::vector<lcf::rpg::EventCommand>& Game_Interpreter::GetFrameCommands() {
+	return GetFrameList().GetCommands();
+}
+
+const EventProgram& Game_Interpreter::GetProgram() {
+	return GetFrameList().GetProgram();
 }
 
 
@@ -225,6 +308,11 @@ void Game_Interpreter::KeyInputState::toSave(lcf::rpg::SaveEventExecState& save)
 
 lcf::rpg::SaveEventExecState Game_Interpreter::GetState() const {
 	auto save = _state;
+	for (size_t i = 0; i < save.stack.size() && i < frame_lists.size(); ++i) {
+		if (frame_lists[i]) {
+			save.stack[i].commands = frame_lists[i]->GetCommands();
+		}
+	}
 	_keyinput.toSave(save);
 	return save;
 }
@@ -292,6 +380,9 @@ int Game_Interpreter::GetSubcommandIndex(int indent) const {
 
 // Update
 void Game_Interpreter::Update(bool reset_loop_count) {
+	INSTRUMENTATION_SCOPE("Game_Interpreter::Update");
+	FrameStats::Scope stats_scope(FrameStats::Phase::Interpreter);
+
 	if (reset_loop_count) {
 		loop_count = 0;
 	}
@@ -303,6 +394,9 @@ void Game_Interpreter::Update(bool reset_loop_count) {
 		return;
 	}
 
+	const bool budgeted = frame_budget > Game_Clock::duration::zero();
+	const auto budget_start = budgeted ? Game_Clock::now() : Game_Clock::time_point();
+
 	for (; loop_count < loop_limit; ++loop_count) {
 		// If something is calling a menu, we're allowed to execute only 1 command per interpreter. So we pass through if loop_count == 0, and stop at 1 or greater.
 		// RPG_RT compatible behavior.
@@ -363,7 +457,7 @@ void Game_Interpreter::Update(bool reset_loop_count) {
 
 			const int key = _keyinput.CheckInput();
 			Main_Data::game_variables->Set(_keyinput.variable, key);
-			Game_Map::SetNeedRefresh(true);
+			Game_Map::SetNeedRefreshChanged();
 			if (key == 0) {
 				++_keyinput.wait_frames;
 				break;
@@ -393,7 +487,7 @@ void Game_Interpreter::Update(bool reset_loop_count) {
 		}
 
 		// Pop any completed stack frames
-		if (frame->current_command >= (int)frame->commands.size()) {
+		if (frame->current_command >= (int)GetFrameCommands().size()) {
 			if (!OnFinishStackFrame()) {
 				break;
 			}
@@ -404,7 +498,15 @@ void Game_Interpreter::Update(bool reset_loop_count) {
 		int current_frame_idx = _state.stack.size() - 1;
 
 		const int index_before_exec = frame->current_command;
-		if (!ExecuteCommand()) {
+		if (EventProfiler::IsEnabled()) {
+			const auto source = GetFrameSource();
+			const auto start = Game_Clock::now();
+			const bool executed = ExecuteCommand();
+			EventProfiler::Add(source, 1, Game_Clock::now() - start);
+			if (!executed) {
+				break;
+			}
+		} else if (!ExecuteCommand()) {
 			break;
 		}
 
@@ -426,9 +528,19 @@ void Game_Interpreter::Update(bool reset_loop_count) {
 		// change the index.
 		if (index_before_exec == frame->current_command) {
 			frame->current_command++;
+		} else if (budgeted && frame->current_command < index_before_exec
+				&& frame_budget_used + (Game_Clock::now() - budget_start) >= frame_budget) {
+			// Backward jumps are the only yield points, so a loop body is
+			// never split. The loop continues at the jump target next frame.
+			FrameStats::AddInterpreterYield();
+			break;
 		}
 	} // for
 
+	if (budgeted) {
+		frame_budget_used += Game_Clock::now() - budget_start;
+	}
+
 	if (loop_count > loop_limit - 1) {
 		auto* frame = GetFramePtr();
 		int event_id = frame ? frame->event_id : 0;
@@ -443,15 +555,18 @@ void Game_Interpreter::Update(bool reset_loop_count) {
 
 // Setup Starting Event
 void Game_Interpreter::Push(Game_Event* ev) {
-	Push(ev->GetList(), ev->GetId(), ev->WasStartedByDecisionKey());
+	const auto* page = ev->GetActivePage();
+	Push(ev->GetList(), ev->GetId(), ev->WasStartedByDecisionKey(),
+		{ EventProfiler::Type::MapEvent, ev->GetId(), page ? page->ID : 0 });
 }
 
 void Game_Interpreter::Push(Game_Event* ev, const lcf::rpg::EventPage* page, bool triggered_by_decision_key) {
-	Push(page->event_commands, ev->GetId(), triggered_by_decision_key);
+	Push(page->event_commands, ev->GetId(), triggered_by_decision_key,
+		{ EventProfiler::Type::MapEvent, ev->GetId(), page->ID });
 }
 
 void Game_Interpreter::Push(Game_CommonEvent* ev) {
-	Push(ev->GetList(), 0, false);
+	Push(ev->GetList(), 0, false, { EventProfiler::Type::CommonEvent, ev->GetIndex(), 0 });
 }
 
 bool Game_Interpreter::CheckGameOver() {
@@ -467,19 +582,29 @@ bool Game_Interpreter::CheckGameOver() {
 
 void Game_Interpreter::SkipToNextConditional(std::initializer_list<Cmd> codes, int indent) {
 	auto& frame = GetFrame();
-	const auto& list = frame.commands;
+	const auto& list = GetFrameCommands();
+	const auto& program = GetProgram();
 	auto& index = frame.current_command;
 
 	if (index >= static_cast<int>(list.size())) {
 		return;
 	}
 
-	for (++index; index < static_cast<int>(list.size()); ++index) {
-		const auto& com = list[index];
-		if (com.indent > indent) {
-			continue;
+	auto matches = [&](int idx) {
+		return std::find(codes.begin(), codes.end(), program[idx].code) != codes.end();
+	};
+
+	// Deeper commands never match, follow the commands at the same indent
+	while (program[index].indent == indent) {
+		index = program[index].next;
+		if (index >= program.size() || matches(index)) {
+			return;
 		}
-		if (std::find(codes.begin(), codes.end(), static_cast<Cmd>(com.code)) != codes.end()) {
+	}
+
+	// A lower indent was reached, RPG_RT continues at every indent up to the given one
+	for (++index; index < program.size(); ++index) {
+		if (program[index].indent <= indent && matches(index)) {
 			break;
 		}
 	}
@@ -537,10 +662,12 @@ lcf::rpg::MoveCommand Game_Interpreter::DecodeMove(lcf::DBArray<int32_t>::const_
 
 // Execute Command.
 bool Game_Interpreter::ExecuteCommand() {
+	INSTRUMENTATION_SCOPE("Game_Interpreter::ExecuteCommand");
+
 	auto& frame = GetFrame();
-	const auto& com = frame.commands[frame.current_command];
+	const auto& com = GetFrameCommands()[frame.current_command];
 
-	switch (static_cast<Cmd>(com.code)) {
+	switch (GetProgram()[frame.current_command].code) {
 		case Cmd::ShowMessage:
 			return CommandShowMessage(com);
 		case Cmd::MessageOptions:
@@ -743,6 +870,9 @@ bool Game_Interpreter::OnFinishStackFrame() {
 	} else {
 		// If a called frame, or base frame of foreground interpreter, pop the stack.
 		_state.stack.pop_back();
+		frame_lists.resize(_state.stack.size());
+		frame_sources.resize(_state.stack.size());
+		UpdateMemoryStats();
 	}
 
 	return !is_base_frame;
@@ -750,7 +880,7 @@ bool Game_Interpreter::OnFinishStackFrame() {
 
 std::vector<std::string> Game_Interpreter::GetChoices(int max_num_choices) {
 	const auto& frame = GetFrame();
-	const auto& list = frame.commands;
+	const auto& list = GetFrameCommands();
 	auto& index = frame.current_command;
 
 	// Let's find the choices
@@ -787,7 +917,7 @@ bool Game_Interpreter::CommandOptionGeneric(lcf::rpg::EventCommand const& com, i
 
 bool Game_Interpreter::CommandShowMessage(lcf::rpg::EventCommand const& com) { // code 10110
 	auto& frame = GetFrame();
-	const auto& list = frame.commands;
+	const auto& list = GetFrameCommands();
 	auto& index = frame.current_command;
 
 	if (!Game_Message::CanShowMessage(main_flag)) {
@@ -954,7 +1084,7 @@ bool Game_Interpreter::CommandControlSwitches(lcf::rpg::EventCommand const& com)
 			}
 		}
 
-		Game_Map::SetNeedRefresh(true);
+		Game_Map::SetNeedRefreshChanged();
 	}
 
 	return true;
@@ -1326,7 +1456,7 @@ bool Game_Interpreter::CommandControlVariables(lcf::rpg::EventCommand const& com
 			}
 		}
 
-		Game_Map::SetNeedRefresh(true);
+		Game_Map::SetNeedRefreshChanged();
 	}
 
 	return true;
@@ -1801,7 +1931,7 @@ bool Game_Interpreter::CommandSimulatedAttack(lcf::rpg::EventCommand const& com)
 
 		if (com.parameters[6] != 0) {
 			Main_Data::game_variables->Set(com.parameters[7], result);
-			Game_Map::SetNeedRefresh(true);
+			Game_Map::SetNeedRefreshChanged();
 		}
 	}
 
@@ -1871,7 +2001,7 @@ bool Game_Interpreter::CommandComment(const lcf::rpg::EventCommand &com) {
 		}
 
 		auto& frame = GetFrame();
-		const auto& list = frame.commands;
+		const auto& list = GetFrameCommands();
 		auto& index = frame.current_command;
 
 		std::string command = ToString(com.string);
@@ -1893,7 +2023,7 @@ bool Game_Interpreter::CommandComment(const lcf::rpg::EventCommand &com) {
 
 void Game_Interpreter::EndEventProcessing() {
 	auto& frame = GetFrame();
-	const auto& list = frame.commands;
+	const auto& list = GetFrameCommands();
 	auto& index = frame.current_command;
 
 	index = static_cast<int>(list.size());
@@ -2025,7 +2155,7 @@ bool Game_Interpreter::CommandMemorizeLocation(lcf::rpg::EventCommand const& com
 	Main_Data::game_variables->Set(var_map_id, Game_Map::GetMapId());
 	Main_Data::game_variables->Set(var_x, player->GetX());
 	Main_Data::game_variables->Set(var_y, player->GetY());
-	Game_Map::SetNeedRefresh(true);
+	Game_Map::SetNeedRefreshChanged();
 	return true;
 }
 
@@ -2131,7 +2261,7 @@ bool Game_Interpreter::CommandStoreTerrainID(lcf::rpg::EventCommand const& com)
 	int y = ValueOrVariable(com.parameters[0], com.parameters[2]);
 	int var_id = com.parameters[3];
 	Main_Data::game_variables->Set(var_id, Game_Map::GetTerrainTag(x, y));
-	Game_Map::SetNeedRefresh(true);
+	Game_Map::SetNeedRefreshChanged();
 	return true;
 }
 
@@ -2141,7 +2271,7 @@ bool Game_Interpreter::CommandStoreEventID(lcf::rpg::EventCommand const& com) {
 	int var_id = com.parameters[3];
 	auto* ev = Game_Map::GetEventAt(x, y, false);
 	Main_Data::game_variables->Set(var_id, ev ? ev->GetId() : 0);
-	Game_Map::SetNeedRefresh(true);
+	Game_Map::SetNeedRefreshChanged();
 	return true;
 }
 
@@ -2798,7 +2928,7 @@ bool Game_Interpreter::CommandKeyInputProc(lcf::rpg::EventCommand const& com) {
 	if (wait) {
 		// While waiting the variable is reset to 0 each frame.
 		Main_Data::game_variables->Set(var_id, 0);
-		Game_Map::SetNeedRefresh(true);
+		Game_Map::SetNeedRefreshChanged();
 	}
 
 	if (wait && Game_Message::IsMessageActive()) {
@@ -2875,7 +3005,7 @@ bool Game_Interpreter::CommandKeyInputProc(lcf::rpg::EventCommand const& com) {
 
 	int key = _keyinput.CheckInput();
 	Main_Data::game_variables->Set(_keyinput.variable, key);
-	Game_Map::SetNeedRefresh(true);
+	Game_Map::SetNeedRefreshChanged();
 
 	return true;
 }
@@ -3204,20 +3334,13 @@ bool Game_Interpreter::CommandEndBranch(lcf::rpg::EventCommand const& /* com */)
 	return true;
 }
 
-bool Game_Interpreter::CommandJumpToLabel(lcf::rpg::EventCommand const& com) { // code 12120
+bool Game_Interpreter::CommandJumpToLabel(lcf::rpg::EventCommand const& /* com */) { // code 12120
 	auto& frame = GetFrame();
-	const auto& list = frame.commands;
-	auto& index = frame.current_command;
-
-	int label_id = com.parameters[0];
 
-	for (int idx = 0; (size_t)idx < list.size(); idx++) {
-		if (static_cast<Cmd>(list[idx].code) != Cmd::Label)
-			continue;
-		if (list[idx].parameters[0] != label_id)
-			continue;
-		index = idx;
-		break;
+	// Resolved when compiling, the first label with the id
+	const int target = GetProgram()[frame.current_command].target;
+	if (target != EventProgram::no_target) {
+		frame.current_command = target;
 	}
 
 	return true;
@@ -3225,45 +3348,41 @@ bool Game_Interpreter::CommandJumpToLabel(lcf::rpg::EventCommand const& com) { /
 
 bool Game_Interpreter::CommandBreakLoop(lcf::rpg::EventCommand const& /* com */) { // code 12220
 	auto& frame = GetFrame();
-	const auto& list = frame.commands;
+	const auto& program = GetProgram();
 	auto& index = frame.current_command;
 
 	// BreakLoop will jump to the end of the event if there is no loop.
 
 	//FIXME: This emulates an RPG_RT bug where break loop ignores scopes and
 	//unconditionally jumps to the next EndLoop command.
-	auto pcode = static_cast<Cmd>(list[index].code);
-
-	for (++index; index < (int)list.size(); ++index) {
-		if (pcode == Cmd::EndLoop) {
-			break;
-		}
-		pcode = static_cast<Cmd>(list[index].code);
-	}
+	const int end_loop = program[index].target;
+	index = (end_loop != EventProgram::no_target) ? end_loop + 1 : program.size();
 
 	return true;
 }
 
 bool Game_Interpreter::CommandEndLoop(lcf::rpg::EventCommand const& com) { // code 22210
 	auto& frame = GetFrame();
-	const auto& list = frame.commands;
+	const auto& list = GetFrameCommands();
 	auto& index = frame.current_command;
 
-	int indent = com.indent;
+	const int loop = GetProgram()[index].target;
+	if (loop != EventProgram::no_target) {
+		index = loop;
+	} else {
+		// No Loop at this indent, either none at all or a lower indent comes first
+		int indent = com.indent;
 
-	for (int idx = index; idx >= 0; idx--) {
-		if (list[idx].indent > indent)
-			continue;
-		if (list[idx].indent < indent)
-			return false;
-		if (static_cast<Cmd>(list[idx].code) != Cmd::Loop)
-			continue;
-		index = idx;
-		break;
+		for (int idx = index; idx >= 0; idx--) {
+			if (list[idx].indent > indent)
+				continue;
+			if (list[idx].indent < indent)
+				return false;
+		}
 	}
 
 	// Jump past the Cmd::Loop to the first command.
-	if (index < (int)frame.commands.size()) {
+	if (index < (int)list.size()) {
 		++index;
 	}
 
@@ -3284,6 +3403,7 @@ bool Game_Interpreter::CommandEraseEvent(lcf::rpg::EventCommand const& /* com */
 	Game_Event* evnt = Game_Map::GetEvent(event_id);
 	if (evnt) {
 		evnt->SetActive(false);
+		Game_Map::OnEventStateChanged();
 
 		// Parallel map events shall stop immediately
 		if (!main_flag) {
@@ -3339,7 +3459,7 @@ bool Game_Interpreter::CommandCallEvent(lcf::rpg::EventCommand const& com) { //
 		return false;
 	}
 
-	Push(page->event_commands, event->GetId(), false);
+	Push(page->event_commands, event->GetId(), false, { EventProfiler::Type::MapEvent, event->GetId(), page->ID });
 
 	return true;
 }
@@ -31,6 +31,9 @@
 #include <lcf/rpg/saveeventexecstate.h>
 #include <lcf/flag_set.h>
 #include "async_op.h"
+#include "event_profiler.h"
+#include "event_program.h"
+#include "game_clock.h"
 
 class Game_Event;
 class Game_CommonEvent;
@@ -65,7 +68,8 @@ public:
 	void Push(
 			const std::vector<lcf::rpg::EventCommand>& _list,
 			int _event_id,
-			bool started_by_decision_key = false
+			bool started_by_decision_key = false,
+			EventProfiler::Source source = {}
 	);
 	void Push(Game_Event* ev);
 	void Push(Game_Event* ev, const lcf::rpg::EventPage* page, bool triggered_by_decision_key);
@@ -99,6 +103,22 @@ public:
 	/** Return true if the interpreter is waiting for an async operation and needs to be resumed */
 	AsyncOp GetAsyncOp() const;
 
+	/**
+	 * Limits the time all interpreters together run per frame.
+	 * When the budget is used up, an interpreter yields at the next backward
+	 * jump of a loop or label and resumes there in the next frame.
+	 * The default of zero disables the limit like in RPG_RT.
+	 *
+	 * @param budget time per frame, zero for no limit
+	 */
+	static void SetFrameBudget(Game_Clock::duration budget);
+
+	/** @return time all interpreters together may run per frame, zero for no limit */
+	static Game_Clock::duration GetFrameBudget();
+
+	/** Starts the budget of the next frame, called once per logical frame */
+	static void ResetFrameBudget();
+
 protected:
 	static constexpr int loop_limit = 10000;
 	static constexpr int call_stack_limit = 1000;
@@ -109,6 +129,12 @@ protected:
 	const lcf::rpg::SaveEventExecFrame* GetFramePtr() const;
 	lcf::rpg::SaveEventExecFrame* GetFramePtr();
 
+	/** @return commands of the current frame */
+	const std::vector<lcf::rpg::EventCommand>& GetFrameCommands();
+
+	/** @return compiled commands of the current frame */
+	const EventProgram& GetProgram();
+
 	bool main_flag;
 
 	int loop_count = 0;
@@ -295,6 +321,26 @@ protected:
 	lcf::rpg::SaveEventExecState _state;
 	KeyInputState _keyinput;
 	AsyncOp _async_op = {};
+
+	/**
+	 * Shared command lists of the stack frames. The commands of the frames
+	 * stay empty and are only filled in for savegames by GetState.
+	 */
+	std::vector<std::shared_ptr<const EventCommandList>> frame_lists;
+
+	/** @return command list of the current frame, frames restored from a savegame are adopted here */
+	const EventCommandList& GetFrameList();
+
+	/** Events of the stack frames for the EventProfiler */
+	std::vector<EventProfiler::Source> frame_sources;
+
+	/** @return event executed by the current frame */
+	EventProfiler::Source GetFrameSource() const;
+
+	/** Updates the interpreter memory statistic after the stack changed */
+	void UpdateMemoryStats();
+	/** Size of the stack in the memory statistic */
+	size_t accounted_bytes = 0;
 };
 
 inline const lcf::rpg::SaveEventExecFrame* Game_Interpreter::GetFramePtr() const {
@@ -41,9 +41,9 @@ Game_Interpreter_Battle::Game_Interpreter_Battle()
 // Execute Command.
 bool Game_Interpreter_Battle::ExecuteCommand() {
 	auto& frame = GetFrame();
-	const auto& com = frame.commands[frame.current_command];
+	const auto& com = GetFrameCommands()[frame.current_command];
 
-	switch (static_cast<Cmd>(com.code)) {
+	switch (GetProgram()[frame.current_command].code) {
 		case Cmd::CallCommonEvent:
 			return CommandCallCommonEvent(com);
 		case Cmd::ForceFlee:
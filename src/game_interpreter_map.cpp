@@ -74,6 +74,7 @@ void Game_Interpreter_Map::SetState(const lcf::rpg::SaveEventExecState& save) {
 	Clear();
 	_state = save;
 	_keyinput.fromSave(save);
+	UpdateMemoryStats();
 }
 
 void Game_Interpreter_Map::OnMapChange() {
@@ -88,9 +89,9 @@ void Game_Interpreter_Map::OnMapChange() {
  */
 bool Game_Interpreter_Map::ExecuteCommand() {
 	auto& frame = GetFrame();
-	const auto& com = frame.commands[frame.current_command];
+	const auto& com = GetFrameCommands()[frame.current_command];
 
-	switch (static_cast<Cmd>(com.code)) {
+	switch (GetProgram()[frame.current_command].code) {
 		case Cmd::RecallToLocation:
 			return CommandRecallToLocation(com);
 		case Cmd::EnemyEncounter:
@@ -644,7 +645,7 @@ bool Game_Interpreter_Map::CommandOpenMainMenu(lcf::rpg::EventCommand const& /*
 		return false;
 	}
 
-	Scene::instance->SetRequestedScene(std::make_shared<Scene_Menu>());
+	Scene::instance->SetRequestedScene(Scene::CreateWarm<Scene_Menu>(Scene::Menu));
 	++index;
 	return false;
 }
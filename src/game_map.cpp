@@ -23,12 +23,14 @@
 #include <climits>
 
 #include "async_handler.h"
+#include "compiler.h"
 #include "system.h"
 #include "game_battle.h"
 #include "game_battler.h"
 #include "game_map.h"
 #include "game_interpreter_map.h"
 #include "game_switches.h"
+#include "game_variables.h"
 #include "game_player.h"
 #include "game_party.h"
 #include "game_message.h"
@@ -39,12 +41,17 @@
 #include <lcf/reader_lcf.h>
 #include "map_data.h"
 #include "main_data.h"
+#include "event_grid.h"
+#include "event_page_index.h"
+#include "memory_stats.h"
 #include "output.h"
+#include "path_finder.h"
 #include "util_macro.h"
 #include "game_system.h"
 #include "filefinder.h"
 #include "player.h"
 #include "input.h"
+#include "job_system.h"
 #include "utils.h"
 #include "rand.h"
 #include <lcf/scope_guard.h>
@@ -56,15 +63,65 @@ namespace {
 	lcf::rpg::SavePanorama panorama;
 
 	bool need_refresh;
+	/** Only the events affected by the logged changes need a refresh */
+	bool need_refresh_changed = false;
 
 	int animation_type;
 	bool animation_fast;
 	std::vector<unsigned char> passages_down;
 	std::vector<unsigned char> passages_up;
+	/** Passage flags of the upper tile of every map cell after substitution */
+	std::vector<unsigned char> cell_passages_up;
+	/** Directions the lower tile of every map cell is passable in after substitution */
+	std::vector<unsigned char> cell_passages_down;
+	/** The cell passages are rebuilt on next use after map, chipset or substitution changes */
+	bool cell_passages_dirty = true;
+	/** Distance fields built from the cell passages */
+	PathFinder path_finder;
 	std::vector<Game_Event> events;
 	std::vector<Game_CommonEvent> common_events;
-
-	std::unique_ptr<lcf::rpg::Map> map;
+	EventPageIndex page_index;
+	std::vector<int> refresh_events;
+	/** Events by tile, the indices refer to events */
+	EventGrid event_grid;
+
+	/** Positions in common_events of the autostart and parallel common events */
+	std::vector<int> trigger_common_events;
+	/** Trigger common events whose switch condition is met */
+	std::vector<int> active_common_events;
+	/** Switches and revision active_common_events was built from */
+	const Game_Switches* active_switches = nullptr;
+	int active_revision = 0;
+
+	/** Positions in events of the active events with a page */
+	std::vector<int> updatable_events;
+	/** Incremented when an event changes its page or active flag */
+	int event_state_revision = 1;
+	/** Revision updatable_events was built from */
+	int updatable_revision = 0;
+
+	/** Shared with map_cache, the events point into it */
+	std::shared_ptr<const lcf::rpg::Map> map;
+
+	/** Map loaded by PrefetchMap */
+	std::shared_ptr<const lcf::rpg::Map> prefetched_map;
+	int prefetched_map_id = 0;
+	/** Parse of prefetched_map_id on a worker, runs during the erase transition */
+	std::shared_future<std::shared_ptr<lcf::rpg::Map>> prefetch_parse;
+
+	/** Parsed and translated map kept for later teleports */
+	struct CachedMap {
+		int map_id = 0;
+		std::string translation_id;
+		size_t bytes = 0;
+		std::shared_ptr<const lcf::rpg::Map> map;
+	};
+	/** Bytes of all maps in map_cache at most */
+	constexpr size_t map_cache_limit = 8 * 1024 * 1024;
+	/** Recently loaded maps, the most recently used first */
+	std::vector<CachedMap> map_cache;
+	size_t map_cache_bytes = 0;
+	FileRequestBinding prefetch_request;
 
 	std::unique_ptr<Game_Interpreter_Map> interpreter;
 	std::vector<Game_Vehicle> vehicles;
@@ -74,12 +131,218 @@ namespace {
 	//FIXME: Find a better way to do this.
 	bool reset_panorama_x_on_next_init = true;
 	bool reset_panorama_y_on_next_init = true;
+
+	/** Index in lcf::Data::treemap.maps by map ID, -1 for unused IDs */
+	std::vector<int> map_index;
+	/** Tree the index was built from, a replaced tree is detected by these */
+	const lcf::rpg::MapInfo* map_index_data = nullptr;
+	size_t map_index_size = 0;
+
+	/** Save, escape and teleport allowed on a map, TriState_parent resolved */
+	struct MapPermissions {
+		bool save = true;
+		bool escape = true;
+		bool teleport = true;
+	};
+	/** Permissions by index in lcf::Data::treemap.maps */
+	std::vector<MapPermissions> map_permissions;
+	/**
+	 * Encounter sources by index in lcf::Data::treemap.maps: the map itself
+	 * and its area children, in tree order.
+	 */
+	std::vector<std::vector<int>> map_encounter_sources;
+
+	/** IDs from this one on are searched, the table stays small for broken trees */
+	constexpr int max_indexed_id = 0x10000;
+
+	int FindMapIndex(int id) {
+		if (id >= max_indexed_id) {
+			const auto& maps = lcf::Data::treemap.maps;
+			auto it = std::find_if(maps.begin(), maps.end(), [id](const lcf::rpg::MapInfo& info) { return info.ID == id; });
+			return it != maps.end() ? static_cast<int>(it - maps.begin()) : -1;
+		}
+		if (id < 0 || static_cast<size_t>(id) >= map_index.size()) {
+			return -1;
+		}
+		return map_index[id];
+	}
+
+	bool IsMapIndexCurrent() {
+		const auto& maps = lcf::Data::treemap.maps;
+		return map_index_data == maps.data() && map_index_size == maps.size();
+	}
+
+	MapPermissions ResolvePermissions(int index) {
+		const auto& maps = lcf::Data::treemap.maps;
+		int current_index = index;
+		int can_save = maps[current_index].save;
+		int can_escape = maps[current_index].escape;
+		int can_teleport = maps[current_index].teleport;
+		size_t steps = 0;
+
+		while (can_save == lcf::rpg::MapInfo::TriState_parent
+				|| can_escape == lcf::rpg::MapInfo::TriState_parent
+				|| can_teleport == lcf::rpg::MapInfo::TriState_parent)
+		{
+			int parent_index = FindMapIndex(maps[current_index].parent_map);
+			if (parent_index == 0) {
+				// If parent is 0 and flag is parent, it's implicitly enabled.
+				break;
+			}
+			if (parent_index == current_index) {
+				Output::Warning("Map {} has parent pointing to itself!", current_index);
+				break;
+			}
+			if (parent_index < 0) {
+				Output::Warning("Map {} has invalid parent id {}!", maps[current_index].ID, maps[current_index].parent_map);
+				break;
+			}
+			if (++steps > maps.size()) {
+				Output::Warning("Map {} has a parent cycle!", maps[index].ID);
+				break;
+			}
+			current_index = parent_index;
+			if (can_save == lcf::rpg::MapInfo::TriState_parent) {
+				can_save = maps[current_index].save;
+			}
+			if (can_escape == lcf::rpg::MapInfo::TriState_parent) {
+				can_escape = maps[current_index].escape;
+			}
+			if (can_teleport == lcf::rpg::MapInfo::TriState_parent) {
+				can_teleport = maps[current_index].teleport;
+			}
+		}
+
+		MapPermissions permissions;
+		permissions.save = can_save != lcf::rpg::MapInfo::TriState_forbid;
+		permissions.escape = can_escape != lcf::rpg::MapInfo::TriState_forbid;
+		permissions.teleport = can_teleport != lcf::rpg::MapInfo::TriState_forbid;
+		return permissions;
+	}
+}
+
+/** @return directions the lower tile tile_raw_id is passable in */
+static unsigned char GetLowerTilePassage(int tile_raw_id) {
+	constexpr unsigned char all_dirs = Passable::Down | Passable::Left | Passable::Right | Passable::Up;
+	int tile_id = 0;
+
+	if (tile_raw_id >= BLOCK_E) {
+		tile_id = tile_raw_id - BLOCK_E;
+		tile_id = map_info.lower_tiles[tile_id] + BLOCK_E_INDEX;
+
+	} else if (tile_raw_id >= BLOCK_D) {
+		tile_id = (tile_raw_id - BLOCK_D) / BLOCK_D_STRIDE + BLOCK_D_INDEX;
+		int autotile_id = (tile_raw_id - BLOCK_D) % BLOCK_D_STRIDE;
+
+		if (((passages_down[tile_id] & Passable::Wall) != 0) && (
+				(autotile_id >= 20 && autotile_id <= 23) ||
+				(autotile_id >= 33 && autotile_id <= 37) ||
+				autotile_id == 42 || autotile_id == 43 ||
+				autotile_id == 45 || autotile_id == 46))
+			return all_dirs;
+
+	} else if (tile_raw_id >= BLOCK_C) {
+		tile_id = (tile_raw_id - BLOCK_C) / BLOCK_C_STRIDE + BLOCK_C_INDEX;
+
+	} else {
+		tile_id = tile_raw_id / BLOCK_B_STRIDE;
+	}
+
+	return passages_down[tile_id] & all_dirs;
+}
+
+/** Rebuilds the passages of all map cells when they are outdated */
+static void UpdateCellPassages() {
+	if (EP_LIKELY(!cell_passages_dirty)) {
+		return;
+	}
+
+	const size_t num_cells = map->lower_layer.size();
+	cell_passages_up.resize(num_cells);
+	cell_passages_down.resize(num_cells);
+	for (size_t i = 0; i < num_cells; ++i) {
+		// Broken maps may contain lower tiles in the upper layer
+		const int upper_id = std::max(map->upper_layer[i] - BLOCK_F, 0);
+		cell_passages_up[i] = passages_up[map_info.upper_tiles[upper_id]];
+		cell_passages_down[i] = GetLowerTilePassage(map->lower_layer[i]);
+	}
+	cell_passages_dirty = false;
+	path_finder.Invalidate();
+}
+
+/** @return whether a walking character can enter or leave the cell in the bit directions */
+static bool IsPassableCell(int bit, int tile_index) {
+	const int passage_up = cell_passages_up[tile_index];
+
+	if ((passage_up & bit) == 0)
+		return false;
+
+	if ((passage_up & Passable::Above) == 0)
+		return true;
+
+	return (cell_passages_down[tile_index] & bit) != 0;
+}
+
+/** Indexes all map events at their current position */
+static void RebuildEventGrid() {
+	event_grid.Reset(Game_Map::GetWidth(), Game_Map::GetHeight(), static_cast<int>(events.size()));
+	for (size_t i = 0; i < events.size(); ++i) {
+		event_grid.Move(static_cast<int>(i), events[i].GetX(), events[i].GetY());
+	}
 }
 
 namespace Game_Map {
 void SetupCommon();
 }
 
+/**
+ * The common events which can start by themselves: autostart and parallel
+ * common events whose switch is on. The list is rebuilt after switch changes,
+ * call-only common events are never contained.
+ *
+ * @return positions in common_events in ascending order
+ */
+static const std::vector<int>& GetActiveCommonEvents() {
+	const auto* switches = Main_Data::game_switches.get();
+	if (switches != active_switches || switches->GetRevision() != active_revision) {
+		active_common_events.clear();
+		for (int idx : trigger_common_events) {
+			const auto& ce = common_events[idx];
+			if (!ce.GetSwitchFlag() || switches->Get(ce.GetSwitchId())) {
+				active_common_events.push_back(idx);
+			}
+		}
+		active_switches = switches;
+		active_revision = switches->GetRevision();
+	}
+	return active_common_events;
+}
+
+/**
+ * The map events which do something in UpdateMapEvents. Inactive events and
+ * events without a page are left out, this keeps maps with many idle events
+ * from touching every Game_Event each frame.
+ *
+ * @return positions in events in ascending order
+ */
+static const std::vector<int>& GetUpdatableEvents() {
+	if (updatable_revision != event_state_revision) {
+		updatable_events.clear();
+		for (int idx = 0; idx < static_cast<int>(events.size()); ++idx) {
+			const auto& ev = events[idx];
+			if (ev.IsActive() && ev.GetActivePage() != nullptr) {
+				updatable_events.push_back(idx);
+			}
+		}
+		updatable_revision = event_state_revision;
+	}
+	return updatable_events;
+}
+
+void Game_Map::OnEventStateChanged() {
+	++event_state_revision;
+}
+
 void Game_Map::OnContinueFromBattle() {
 	Main_Data::game_system->BgmPlay(Main_Data::game_system->GetBeforeBattleMusic());
 }
@@ -97,9 +360,14 @@ void Game_Map::Init() {
 
 	common_events.clear();
 	common_events.reserve(lcf::Data::commonevents.size());
+	trigger_common_events.clear();
 	for (const lcf::rpg::CommonEvent& ev : lcf::Data::commonevents) {
+		if (ev.trigger == lcf::rpg::EventPage::Trigger_auto_start || ev.trigger == lcf::rpg::EventPage::Trigger_parallel) {
+			trigger_common_events.push_back(static_cast<int>(common_events.size()));
+		}
 		common_events.emplace_back(ev.ID);
 	}
+	active_switches = nullptr;
 
 	vehicles.clear();
 	vehicles.emplace_back(Game_Vehicle::Boat);
@@ -109,6 +377,13 @@ void Game_Map::Init() {
 
 void Game_Map::Dispose() {
 	events.clear();
+	OnEventStateChanged();
+	event_grid.Clear();
+	page_index.Clear();
+	cell_passages_up.clear();
+	cell_passages_down.clear();
+	cell_passages_dirty = true;
+	path_finder.Reset(0, 0, false, false);
 	map.reset();
 	map_info = {};
 	panorama = {};
@@ -116,17 +391,41 @@ void Game_Map::Dispose() {
 
 void Game_Map::Quit() {
 	Dispose();
+	prefetched_map.reset();
+	prefetched_map_id = 0;
+	if (prefetch_parse.valid()) {
+		prefetch_parse.wait();
+		prefetch_parse = {};
+	}
+	prefetch_request.reset();
+	map_cache.clear();
+	map_cache_bytes = 0;
 	common_events.clear();
+	trigger_common_events.clear();
+	active_common_events.clear();
+	active_switches = nullptr;
 	interpreter.reset();
 }
 
+void Game_Map::TrimMapCache(size_t bytes) {
+	// The current map stays alive through Game_Map::map
+	while (!map_cache.empty() && map_cache_bytes > bytes) {
+		map_cache_bytes -= map_cache.back().bytes;
+		map_cache.pop_back();
+	}
+}
+
+size_t Game_Map::GetMapCacheSize() {
+	return map_cache_bytes;
+}
+
 int Game_Map::GetMapSaveCount() {
 	return (Player::IsRPG2k3() && map->save_count_2k3e > 0)
 		? map->save_count_2k3e
 		: map->save_count;
 }
 
-void Game_Map::Setup(std::unique_ptr<lcf::rpg::Map> map_in) {
+void Game_Map::Setup(std::shared_ptr<const lcf::rpg::Map> map_in) {
 	Dispose();
 
 	map = std::move(map_in);
@@ -146,44 +445,13 @@ void Game_Map::Setup(std::unique_ptr<lcf::rpg::Map> map_in) {
 	for (size_t i = 0; i < map_info.upper_tiles.size(); i++) {
 		map_info.upper_tiles[i] = i;
 	}
+	cell_passages_dirty = true;
 
-	// Save allowed
-	int current_index = GetMapIndex(GetMapId());
-	int can_save = lcf::Data::treemap.maps[current_index].save;
-	int can_escape = lcf::Data::treemap.maps[current_index].escape;
-	int can_teleport = lcf::Data::treemap.maps[current_index].teleport;
-
-	while (can_save == lcf::rpg::MapInfo::TriState_parent
-			|| can_escape == lcf::rpg::MapInfo::TriState_parent
-			|| can_teleport == lcf::rpg::MapInfo::TriState_parent)
-	{
-		int parent_index = GetMapIndex(lcf::Data::treemap.maps[current_index].parent_map);
-		if (parent_index == 0) {
-			// If parent is 0 and flag is parent, it's implicitly enabled.
-			break;
-		}
-		if (parent_index == current_index) {
-			Output::Warning("Map {} has parent pointing to itself!", current_index);
-			break;
-		}
-		if (parent_index < 0) {
-			Output::Warning("Map {} has invalid parent id {}!", lcf::Data::treemap.maps[current_index].ID, lcf::Data::treemap.maps[current_index].parent_map);
-			break;
-		}
-		current_index = parent_index;
-		if (can_save == lcf::rpg::MapInfo::TriState_parent) {
-			can_save = lcf::Data::treemap.maps[current_index].save;
-		}
-		if (can_escape == lcf::rpg::MapInfo::TriState_parent) {
-			can_escape = lcf::Data::treemap.maps[current_index].escape;
-		}
-		if (can_teleport == lcf::rpg::MapInfo::TriState_parent) {
-			can_teleport = lcf::Data::treemap.maps[current_index].teleport;
-		}
-	}
-	Main_Data::game_system->SetAllowSave(can_save != lcf::rpg::MapInfo::TriState_forbid);
-	Main_Data::game_system->SetAllowEscape(can_escape != lcf::rpg::MapInfo::TriState_forbid);
-	Main_Data::game_system->SetAllowTeleport(can_teleport != lcf::rpg::MapInfo::TriState_forbid);
+	// Save allowed, resolved by RebuildMapIndex
+	const auto& permissions = map_permissions[GetMapIndex(GetMapId())];
+	Main_Data::game_system->SetAllowSave(permissions.save);
+	Main_Data::game_system->SetAllowEscape(permissions.escape);
+	Main_Data::game_system->SetAllowTeleport(permissions.teleport);
 
 	auto& player = *Main_Data::game_player;
 
@@ -196,7 +464,7 @@ void Game_Map::Setup(std::unique_ptr<lcf::rpg::Map> map_in) {
 }
 
 void Game_Map::SetupFromSave(
-		std::unique_ptr<lcf::rpg::Map> map_in,
+		std::shared_ptr<const lcf::rpg::Map> map_in,
 		lcf::rpg::SaveMapInfo save_map,
 		lcf::rpg::SaveVehicleLocation save_boat,
 		lcf::rpg::SaveVehicleLocation save_ship,
@@ -225,6 +493,8 @@ void Game_Map::SetupFromSave(
 			auto& ev = events[i];
 			ev.SetSaveData(map_info.events[i]);
 		}
+		// SetSaveData replaces the positions without SetX and SetY
+		RebuildEventGrid();
 	}
 	map_info.events.clear();
 
@@ -259,8 +529,110 @@ void Game_Map::SetupFromSave(
 	Game_Map::Parallax::ChangeBG(GetParallaxParams());
 }
 
-std::unique_ptr<lcf::rpg::Map> Game_Map::loadMapFile(int map_id) {
+/** @return memory used by the layers and events of a map */
+static size_t GetMapBytes(const lcf::rpg::Map& map) {
+	size_t map_bytes = MemoryStats::GetSize(map.lower_layer) + MemoryStats::GetSize(map.upper_layer) + MemoryStats::GetSize(map.events);
+	for (const auto& ev: map.events) {
+		map_bytes += MemoryStats::GetSize(ev.pages);
+		for (const auto& page: ev.pages) {
+			map_bytes += MemoryStats::GetSize(page.event_commands);
+		}
+	}
+	return map_bytes;
+}
+
+/** @return the cached map or nullptr when it is not cached */
+static std::shared_ptr<const lcf::rpg::Map> GetCachedMap(int map_id, const std::string& translation_id) {
+	auto it = std::find_if(map_cache.begin(), map_cache.end(), [&](const CachedMap& entry) {
+		return entry.map_id == map_id && entry.translation_id == translation_id;
+	});
+	if (it == map_cache.end()) {
+		return nullptr;
+	}
+
+	std::rotate(map_cache.begin(), it, it + 1);
+	return map_cache.front().map;
+}
+
+/** Keeps a map, the least recently used maps are dropped above the limit */
+static void AddCachedMap(int map_id, std::string translation_id, std::shared_ptr<const lcf::rpg::Map> map) {
+	const size_t bytes = GetMapBytes(*map);
+	if (bytes > map_cache_limit) {
+		return;
+	}
+
+	while (!map_cache.empty() && map_cache_bytes + bytes > map_cache_limit) {
+		map_cache_bytes -= map_cache.back().bytes;
+		map_cache.pop_back();
+	}
+
+	CachedMap entry;
+	entry.map_id = map_id;
+	entry.translation_id = std::move(translation_id);
+	entry.bytes = bytes;
+	entry.map = std::move(map);
+	map_cache.insert(map_cache.begin(), std::move(entry));
+	map_cache_bytes += bytes;
+}
+
+/** Translates a parsed map and keeps it in the map cache */
+static std::shared_ptr<const lcf::rpg::Map> FinishMapLoad(int map_id, std::shared_ptr<lcf::rpg::Map> map, bool use_cache) {
+	auto translation_id = Tr::GetCurrentTranslationId();
+	if (!translation_id.empty()) {
+		//  Build our map translation id.
+		std::stringstream ss;
+		ss << "map" << std::setfill('0') << std::setw(4) << map_id << ".po";
+
+		// Translate all messages for this map
+		Player::translation.RewriteMapMessages(ss.str(), *map);
+	}
+
+	std::shared_ptr<const lcf::rpg::Map> shared_map = std::move(map);
+	if (use_cache) {
+		AddCachedMap(map_id, std::move(translation_id), shared_map);
+	}
+
+	return shared_map;
+}
+
+/** @return the parse of the prefetch, waits when it did not finish yet */
+static std::shared_ptr<const lcf::rpg::Map> TakePrefetchParse() {
+	auto map = prefetch_parse.get();
+	prefetch_parse = {};
+	if (!map) {
+		return nullptr;
+	}
+	Output::Debug("Loaded Map {} in the background", prefetched_map_id);
+	return FinishMapLoad(prefetched_map_id, std::move(map), true);
+}
+
+std::shared_ptr<const lcf::rpg::Map> Game_Map::loadMapFile(int map_id) {
+	if (prefetch_parse.valid() && map_id == prefetched_map_id) {
+		// A failed parse is reported by the load below
+		prefetched_map = TakePrefetchParse();
+	}
+
+	if (prefetched_map && map_id == prefetched_map_id) {
+		prefetched_map_id = 0;
+		return std::move(prefetched_map);
+	}
+
+	// Recordings contain the hash of every loaded map, they always read the file
+	const bool use_cache = !Input::IsRecording();
+	auto translation_id = Tr::GetCurrentTranslationId();
+	if (use_cache) {
+		auto cached = GetCachedMap(map_id, translation_id);
+		if (cached) {
+			Output::Debug("Loaded Map {} from cache", map_id);
+			return cached;
+		}
+	}
+
 	std::unique_ptr<lcf::rpg::Map> map;
+#ifdef HAVE_THREADS
+	// Workers can parse lcf data meanwhile, see Player::GetLcfMutex
+	std::unique_lock<std::mutex> lcf_lock(Player::GetLcfMutex(), std::defer_lock);
+#endif
 
 	// Try loading EasyRPG map files first, then fallback to normal RPG Maker
 	// FIXME: Assert map was cached for async platforms
@@ -276,6 +648,9 @@ std::unique_ptr<lcf::rpg::Map> Game_Map::loadMapFile(int map_id) {
 		}
 
 		auto map_stream = FileFinder::OpenInputStream(map_file);
+#ifdef HAVE_THREADS
+		lcf_lock.lock();
+#endif
 		map = lcf::LMU_Reader::Load(map_stream, Player::encoding);
 
 		if (Input::IsRecording()) {
@@ -286,29 +661,32 @@ std::unique_ptr<lcf::rpg::Map> Game_Map::loadMapFile(int map_id) {
 		}
 	} else {
 		auto map_stream = FileFinder::OpenInputStream(map_file);
+#ifdef HAVE_THREADS
+		lcf_lock.lock();
+#endif
 		map = lcf::LMU_Reader::LoadXml(map_stream);
 	}
 
+	const std::string error = map ? std::string() : lcf::LcfReader::GetError();
+#ifdef HAVE_THREADS
+	lcf_lock.unlock();
+#endif
+
 	Output::Debug("Loaded Map {}", map_name);
 
 	if (map.get() == NULL) {
-		Output::ErrorStr(lcf::LcfReader::GetError());
+		Output::ErrorStr(error);
+		return map;
 	}
 
-	return map;
+	return FinishMapLoad(map_id, std::move(map), use_cache);
 }
 
 void Game_Map::SetupCommon() {
-	if (!Tr::GetCurrentTranslationId().empty()) {
-		//  Build our map translation id.
-		std::stringstream ss;
-		ss << "map" << std::setfill('0') << std::setw(4) << GetMapId() << ".po";
-
-		// Translate all messages for this map
-		Player::translation.RewriteMapMessages(ss.str(), *map);
-	}
 	SetNeedRefresh(true);
 
+	MemoryStats::Set(MemoryStats::Category::Map, GetMapBytes(*map));
+
 	int current_index = GetMapIndex(GetMapId());
 
 	std::ostringstream ss;
@@ -327,6 +705,31 @@ void Game_Map::SetupCommon() {
 	for (const auto& ev : map->events) {
 		events.emplace_back(GetMapId(), &ev);
 	}
+	OnEventStateChanged();
+	RebuildEventGrid();
+	path_finder.Reset(GetWidth(), GetHeight(), LoopHorizontal(), LoopVertical());
+	page_index.Build(map->events);
+
+	// Download the maps reachable by teleports early, they are small
+	constexpr size_t max_teleport_maps = 8;
+	std::vector<int> teleport_maps;
+	for (const auto& ev : map->events) {
+		for (const auto& page : ev.pages) {
+			for (const auto& cmd : page.event_commands) {
+				if (cmd.code != static_cast<int>(lcf::rpg::EventCommand::Code::Teleport) || cmd.parameters.empty()) {
+					continue;
+				}
+				const int map_id = cmd.parameters[0];
+				if (map_id != GetMapId() && teleport_maps.size() < max_teleport_maps &&
+						std::find(teleport_maps.begin(), teleport_maps.end(), map_id) == teleport_maps.end()) {
+					teleport_maps.push_back(map_id);
+				}
+			}
+		}
+	}
+	for (int map_id : teleport_maps) {
+		RequestMap(map_id)->Start();
+	}
 }
 
 void Game_Map::PrepareSave(lcf::rpg::Save& save) {
@@ -389,12 +792,34 @@ const std::vector<uint8_t>& Game_Map::GetTilesLayer(int layer) {
 
 void Game_Map::Refresh() {
 	if (GetMapId() > 0) {
-		for (Game_Event& ev : events) {
-			ev.RefreshPage();
+		if (need_refresh || !need_refresh_changed) {
+			for (Game_Event& ev : events) {
+				ev.RefreshPage();
+			}
+		} else {
+			refresh_events.clear();
+			for (int id : Main_Data::game_switches->GetChanges()) {
+				page_index.CollectSwitch(id, refresh_events);
+			}
+			for (int id : Main_Data::game_variables->GetChanges()) {
+				page_index.CollectVariable(id, refresh_events);
+			}
+			const auto& other = page_index.GetOtherEvents();
+			refresh_events.insert(refresh_events.end(), other.begin(), other.end());
+
+			// Every event once and in the order of a full refresh
+			std::sort(refresh_events.begin(), refresh_events.end());
+			refresh_events.erase(std::unique(refresh_events.begin(), refresh_events.end()), refresh_events.end());
+			for (int idx : refresh_events) {
+				events[idx].RefreshPage();
+			}
 		}
 	}
 
 	need_refresh = false;
+	need_refresh_changed = false;
+	Main_Data::game_switches->ClearChanges();
+	Main_Data::game_variables->ClearChanges();
 }
 
 Game_Interpreter_Map& Game_Map::GetInterpreter() {
@@ -574,8 +999,9 @@ bool Game_Map::MakeWay(const Game_Character& self,
 
 	if (vehicle_type != Game_Vehicle::Airship) {
 		// Check for collision with events on the target tile.
-		for (auto& other: GetEvents()) {
-			if (MakeWayCollideEvent(to_x, to_y, self, other, self_conflict)) {
+		// Updating an event can move others, the next event is looked up after every update.
+		for (auto* other = GetNextEventAt(to_x, to_y, nullptr); other; other = GetNextEventAt(to_x, to_y, other)) {
+			if (MakeWayCollideEvent(to_x, to_y, self, *other, self_conflict)) {
 				return false;
 			}
 		}
@@ -621,10 +1047,8 @@ bool Game_Map::CanLandAirship(int x, int y) {
 		return false;
 	}
 
-	for (auto& ev: events) {
-		if (ev.IsInPosition(x, y)
-				&& ev.IsActive()
-				&& ev.GetActivePage() != nullptr) {
+	for (auto* ev = GetNextEventAt(x, y, nullptr); ev; ev = GetNextEventAt(x, y, ev)) {
+		if (ev->IsActive() && ev->GetActivePage() != nullptr) {
 			return false;
 		}
 	}
@@ -643,10 +1067,7 @@ bool Game_Map::CanLandAirship(int x, int y) {
 		return false;
 	}
 
-	int tile_id = map->upper_layer[tile_index] - BLOCK_F;
-	tile_id = map_info.upper_tiles[tile_id];
-
-	return (passages_up[tile_id] & bit) != 0;
+	return (cell_passages_up[tile_index] & bit) != 0;
 }
 
 bool Game_Map::CanEmbarkShip(Game_Player& player, int x, int y) {
@@ -659,11 +1080,10 @@ bool Game_Map::CanDisembarkShip(Game_Player& player, int x, int y) {
 		return false;
 	}
 
-	for (auto& ev: GetEvents()) {
-		if (ev.IsInPosition(x, y)
-			&& ev.GetLayer() == lcf::rpg::EventPage::Layers_same
-			&& ev.IsActive()
-			&& ev.GetActivePage() != nullptr) {
+	for (auto* ev = GetNextEventAt(x, y, nullptr); ev; ev = GetNextEventAt(x, y, ev)) {
+		if (ev->GetLayer() == lcf::rpg::EventPage::Layers_same
+			&& ev->IsActive()
+			&& ev->GetActivePage() != nullptr) {
 			return false;
 		}
 	}
@@ -674,32 +1094,8 @@ bool Game_Map::CanDisembarkShip(Game_Player& player, int x, int y) {
 }
 
 bool Game_Map::IsPassableLowerTile(int bit, int tile_index) {
-	int tile_raw_id = map->lower_layer[tile_index];
-	int tile_id = 0;
-
-	if (tile_raw_id >= BLOCK_E) {
-		tile_id = tile_raw_id - BLOCK_E;
-		tile_id = map_info.lower_tiles[tile_id] + BLOCK_E_INDEX;
-
-	} else if (tile_raw_id >= BLOCK_D) {
-		tile_id = (tile_raw_id - BLOCK_D) / BLOCK_D_STRIDE + BLOCK_D_INDEX;
-		int autotile_id = (tile_raw_id - BLOCK_D) % BLOCK_D_STRIDE;
-
-		if (((passages_down[tile_id] & Passable::Wall) != 0) && (
-				(autotile_id >= 20 && autotile_id <= 23) ||
-				(autotile_id >= 33 && autotile_id <= 37) ||
-				autotile_id == 42 || autotile_id == 43 ||
-				autotile_id == 45 || autotile_id == 46))
-			return true;
-
-	} else if (tile_raw_id >= BLOCK_C) {
-		tile_id = (tile_raw_id - BLOCK_C) / BLOCK_C_STRIDE + BLOCK_C_INDEX;
-
-	} else if (map->lower_layer[tile_index] < BLOCK_C) {
-		tile_id = tile_raw_id / BLOCK_B_STRIDE;
-	}
-
-	return (passages_down[tile_id] & bit) != 0;
+	UpdateCellPassages();
+	return (cell_passages_down[tile_index] & bit) != 0;
 }
 
 bool Game_Map::IsPassableTile(const Game_Character* self, int bit, int x, int y) {
@@ -726,18 +1122,17 @@ bool Game_Map::IsPassableTile(const Game_Character* self, int bit, int x, int y)
 
 	// Highest ID event with layer=below, not through, and a tile graphic wins.
 	int event_tile_id = 0;
-	for (auto& ev: events) {
+	for (int idx = event_grid.GetPrev(x, y, -1); idx >= 0; idx = event_grid.GetPrev(x, y, idx)) {
+		auto& ev = events[idx];
 		if (self == &ev) {
 			continue;
 		}
 		if (!ev.IsActive() || ev.GetActivePage() == nullptr || ev.GetThrough()) {
 			continue;
 		}
-		if (ev.IsInPosition(x, y) && ev.GetLayer() == lcf::rpg::EventPage::Layers_below) {
-			int tile_id = ev.GetTileId();
-			if (tile_id > 0) {
-				event_tile_id = tile_id;
-			}
+		if (ev.GetLayer() == lcf::rpg::EventPage::Layers_below && ev.GetTileId() > 0) {
+			event_tile_id = ev.GetTileId();
+			break;
 		}
 	}
 
@@ -756,23 +1151,42 @@ bool Game_Map::IsPassableTile(const Game_Character* self, int bit, int x, int y)
 		};
 	}
 
-	int tile_index = x + y * GetWidth();
-	int tile_id = map->upper_layer[tile_index] - BLOCK_F;
-	tile_id = map_info.upper_tiles[tile_id];
+	UpdateCellPassages();
+	const int tile_index = x + y * GetWidth();
+	const int passage_up = cell_passages_up[tile_index];
 
 	if (vehicle_type == Game_Vehicle::Boat || vehicle_type == Game_Vehicle::Ship) {
-		if ((passages_up[tile_id] & Passable::Above) == 0)
+		if ((passage_up & Passable::Above) == 0)
 			return false;
 		return true;
 	}
 
-	if ((passages_up[tile_id] & bit) == 0)
+	return IsPassableCell(bit, tile_index);
+}
+
+/** @return whether the tile passages allow a walking step from (x,y) in direction dir */
+static bool IsPassableStep(int x, int y, int dir) {
+	const int to_x = x + Game_Character::GetDxFromDirection(dir);
+	const int to_y = y + Game_Character::GetDyFromDirection(dir);
+	const int round_x = Game_Map::RoundX(to_x);
+	const int round_y = Game_Map::RoundY(to_y);
+	if (!Game_Map::IsValid(round_x, round_y)) {
 		return false;
+	}
 
-	if ((passages_up[tile_id] & Passable::Above) == 0)
-		return true;
+	const int width = Game_Map::GetWidth();
+	return IsPassableCell(GetPassableMask(x, y, to_x, to_y), x + y * width)
+		&& IsPassableCell(GetPassableMask(to_x, to_y, x, y), round_x + round_y * width);
+}
+
+int Game_Map::GetPathDirection(int x, int y, int target_x, int target_y) {
+	UpdateCellPassages();
+	return path_finder.GetDirection(x, y, target_x, target_y, IsPassableStep);
+}
 
-	return IsPassableLowerTile(bit, tile_index);
+int Game_Map::GetPathDistance(int x, int y, int target_x, int target_y) {
+	UpdateCellPassages();
+	return path_finder.GetDistance(x, y, target_x, target_y, IsPassableStep);
 }
 
 int Game_Map::GetBushDepth(int x, int y) {
@@ -835,25 +1249,46 @@ int Game_Map::GetTerrainTag(int x, int y) {
 	return terrain_data[chip_index];
 }
 
-void Game_Map::GetEventsXY(std::vector<Game_Event*>& events, int x, int y) {
-	for (Game_Event& ev : GetEvents()) {
-		if (ev.IsInPosition(x, y) && ev.IsActive()) {
-			events.push_back(&ev);
+template <typename T>
+static void AppendEventsXY(T& events, int x, int y) {
+	for (auto* ev = Game_Map::GetNextEventAt(x, y, nullptr); ev; ev = Game_Map::GetNextEventAt(x, y, ev)) {
+		if (ev->IsActive()) {
+			events.push_back(ev);
 		}
 	}
 }
 
+void Game_Map::GetEventsXY(std::vector<Game_Event*>& events, int x, int y) {
+	AppendEventsXY(events, x, y);
+}
+
+void Game_Map::GetEventsXY(FrameArena::Vector<Game_Event*>& events, int x, int y) {
+	AppendEventsXY(events, x, y);
+}
+
 Game_Event* Game_Map::GetEventAt(int x, int y, bool require_active) {
-	auto& events = GetEvents();
-	for (auto iter = events.rbegin(); iter != events.rend(); ++iter) {
-		auto& ev = *iter;
-		if (ev.IsInPosition(x, y) && (!require_active || ev.IsActive())) {
+	for (int idx = event_grid.GetPrev(x, y, -1); idx >= 0; idx = event_grid.GetPrev(x, y, idx)) {
+		auto& ev = events[idx];
+		if (!require_active || ev.IsActive()) {
 			return &ev;
 		}
 	}
 	return nullptr;
 }
 
+Game_Event* Game_Map::GetNextEventAt(int x, int y, const Game_Event* after) {
+	const int idx = event_grid.GetNext(x, y, after ? static_cast<int>(after - events.data()) : -1);
+	return idx >= 0 ? &events[idx] : nullptr;
+}
+
+void Game_Map::OnEventMoved(const Game_Character& ev) {
+	// Events are only moved in the grid once they are in the events list
+	const auto* event = static_cast<const Game_Event*>(&ev);
+	if (!events.empty() && event >= events.data() && event < events.data() + events.size()) {
+		event_grid.Move(static_cast<int>(event - events.data()), ev.GetX(), ev.GetY());
+	}
+}
+
 bool Game_Map::LoopHorizontal() {
 	return map->scroll_type == lcf::rpg::Map::ScrollType_horizontal || map->scroll_type == lcf::rpg::Map::ScrollType_both;
 }
@@ -903,13 +1338,8 @@ int Game_Map::YwithDirection(int y, int direction) {
 }
 
 int Game_Map::CheckEvent(int x, int y) {
-	for (const Game_Event& ev : events) {
-		if (ev.IsInPosition(x, y)) {
-			return ev.GetId();
-		}
-	}
-
-	return 0;
+	const auto* ev = GetNextEventAt(x, y, nullptr);
+	return ev ? ev->GetId() : 0;
 }
 
 void Game_Map::Update(MapUpdateAsyncContext& actx, bool is_preupdate) {
@@ -994,19 +1424,37 @@ void Game_Map::UpdateProcessedFlags(bool is_preupdate) {
 bool Game_Map::UpdateCommonEvents(MapUpdateAsyncContext& actx) {
 	int resume_ce = actx.GetParallelCommonEvent();
 
-	for (Game_CommonEvent& ev : common_events) {
-		bool resume_async = false;
-		if (resume_ce != 0) {
-			// If resuming, skip all until the event to resume from ..
-			if (ev.GetIndex() != resume_ce) {
-				continue;
-			} else {
-				resume_ce = 0;
-				resume_async = true;
-			}
+	int next = 0;
+	if (resume_ce != 0) {
+		// If resuming, skip all until the event to resume from ..
+		// It runs even when its switch was turned off meanwhile
+		auto it = std::find_if(common_events.begin(), common_events.end(),
+				[resume_ce](const Game_CommonEvent& ev) { return ev.GetIndex() == resume_ce; });
+		if (it == common_events.end()) {
+			actx = {};
+			return true;
+		}
+
+		auto aop = it->Update(true);
+		if (aop.IsActive()) {
+			// Suspend due to this event ..
+			actx = MapUpdateAsyncContext::FromCommonEvent(it->GetIndex(), aop);
+			return false;
+		}
+		next = static_cast<int>(it - common_events.begin()) + 1;
+	}
+
+	for (;;) {
+		// Fetched again because the events before can change switches
+		const auto& active = GetActiveCommonEvents();
+		auto it = std::lower_bound(active.begin(), active.end(), next);
+		if (it == active.end()) {
+			break;
 		}
+		next = *it + 1;
 
-		auto aop = ev.Update(resume_async);
+		Game_CommonEvent& ev = common_events[*it];
+		auto aop = ev.Update(false);
 		if (aop.IsActive()) {
 			// Suspend due to this event ..
 			actx = MapUpdateAsyncContext::FromCommonEvent(ev.GetIndex(), aop);
@@ -1021,19 +1469,37 @@ bool Game_Map::UpdateCommonEvents(MapUpdateAsyncContext& actx) {
 bool Game_Map::UpdateMapEvents(MapUpdateAsyncContext& actx) {
 	int resume_ev = actx.GetParallelMapEvent();
 
-	for (Game_Event& ev : events) {
-		bool resume_async = false;
-		if (resume_ev != 0) {
-			// If resuming, skip all until the event to resume from ..
-			if (ev.GetId() != resume_ev) {
-				continue;
-			} else {
-				resume_ev = 0;
-				resume_async = true;
-			}
+	int next = 0;
+	if (resume_ev != 0) {
+		// If resuming, skip all until the event to resume from ..
+		// It runs even when it lost its page meanwhile
+		auto it = std::find_if(events.begin(), events.end(),
+				[resume_ev](const Game_Event& ev) { return ev.GetId() == resume_ev; });
+		if (it == events.end()) {
+			actx = {};
+			return true;
 		}
 
-		auto aop = ev.Update(resume_async);
+		auto aop = it->Update(true);
+		if (aop.IsActive()) {
+			// Suspend due to this event ..
+			actx = MapUpdateAsyncContext::FromMapEvent(it->GetId(), aop);
+			return false;
+		}
+		next = static_cast<int>(it - events.begin()) + 1;
+	}
+
+	for (;;) {
+		// Fetched again because the events before can change pages
+		const auto& updatable = GetUpdatableEvents();
+		auto it = std::lower_bound(updatable.begin(), updatable.end(), next);
+		if (it == updatable.end()) {
+			break;
+		}
+		next = *it + 1;
+
+		Game_Event& ev = events[*it];
+		auto aop = ev.Update(false);
 		if (aop.IsActive()) {
 			// Suspend due to this event ..
 			actx = MapUpdateAsyncContext::FromMapEvent(ev.GetId(), aop);
@@ -1086,7 +1552,8 @@ bool Game_Map::UpdateForegroundEvents(MapUpdateAsyncContext& actx) {
 		}
 		Game_CommonEvent* run_ce = nullptr;
 
-		for (auto& ce: common_events) {
+		for (int idx: GetActiveCommonEvents()) {
+			auto& ce = common_events[idx];
 			if (ce.IsWaitingForegroundExecution()) {
 				run_ce = &ce;
 				break;
@@ -1173,7 +1640,7 @@ void Game_Map::SetEncounterRate(int step) {
 std::vector<int> Game_Map::GetEncountersAt(int x, int y) {
 	int terrain_tag = GetTerrainTag(Main_Data::game_player->GetX(), Main_Data::game_player->GetY());
 
-	std::function<bool(int)> is_acceptable = [=](int troop_id) {
+	auto is_acceptable = [=](int troop_id) {
 		const lcf::rpg::Troop* troop = lcf::ReaderUtil::GetElement(lcf::Data::troops, troop_id);
 		if (!troop) {
 			Output::Warning("GetEncountersAt: Invalid troop ID {} in encounter list", troop_id);
@@ -1189,16 +1656,21 @@ std::vector<int> Game_Map::GetEncountersAt(int x, int y) {
 
 	std::vector<int> out;
 
-	for (unsigned int i = 0; i < lcf::Data::treemap.maps.size(); ++i) {
-		lcf::rpg::MapInfo& map = lcf::Data::treemap.maps[i];
+	const int map_index = GetMapIndex(GetMapId());
+	if (map_index < 0) {
+		return out;
+	}
+
+	for (int i : map_encounter_sources[map_index]) {
+		const lcf::rpg::MapInfo& map = lcf::Data::treemap.maps[i];
 
-		if (map.ID == GetMapId()) {
+		if (i == map_index) {
 			for (const auto& enc : map.encounters) {
 				if (is_acceptable(enc.troop_id)) {
 					out.push_back(enc.troop_id);
 				}
 			}
-		} else if (map.parent_map == GetMapId() && map.type == lcf::rpg::TreeMap::MapType_area) {
+		} else {
 			// Area
 			Rect area_rect(map.area_rect.l, map.area_rect.t, map.area_rect.r - map.area_rect.l, map.area_rect.b - map.area_rect.t);
 			Rect player_rect(x, y, 1, 1);
@@ -1279,11 +1751,11 @@ void Game_Map::SetupBattle(BattleArgs& args) {
 	}
 }
 
-std::vector<short>& Game_Map::GetMapDataDown() {
+const std::vector<short>& Game_Map::GetMapDataDown() {
 	return map->lower_layer;
 }
 
-std::vector<short>& Game_Map::GetMapDataUp() {
+const std::vector<short>& Game_Map::GetMapDataUp() {
 	return map->upper_layer;
 }
 
@@ -1344,13 +1816,17 @@ void Game_Map::SetPositionY(int y, bool reset_panorama) {
 }
 
 bool Game_Map::GetNeedRefresh() {
-	return need_refresh;
+	return need_refresh || need_refresh_changed;
 }
 
 void Game_Map::SetNeedRefresh(bool refresh) {
 	need_refresh = refresh;
 }
 
+void Game_Map::SetNeedRefreshChanged() {
+	need_refresh_changed = true;
+}
+
 std::vector<unsigned char>& Game_Map::GetPassagesDown() {
 	return passages_down;
 }
@@ -1389,24 +1865,61 @@ std::vector<Game_CommonEvent>& Game_Map::GetCommonEvents() {
 	return common_events;
 }
 
-int Game_Map::GetMapIndex(int id) {
-	for (unsigned int i = 0; i < lcf::Data::treemap.maps.size(); ++i) {
-		if (lcf::Data::treemap.maps[i].ID == id) {
-			return i;
+void Game_Map::RebuildMapIndex() {
+	const auto& maps = lcf::Data::treemap.maps;
+
+	int max_id = -1;
+	for (const auto& info : maps) {
+		max_id = std::max(max_id, std::min(info.ID, max_indexed_id - 1));
+	}
+
+	map_index.assign(max_id + 1, -1);
+	for (int i = static_cast<int>(maps.size()) - 1; i >= 0; --i) {
+		// The first map wins when an ID is duplicated, like the linear search did
+		if (maps[i].ID >= 0 && maps[i].ID < max_indexed_id) {
+			map_index[maps[i].ID] = i;
+		}
+	}
+	map_index_data = maps.data();
+	map_index_size = maps.size();
+
+	map_permissions.clear();
+	map_permissions.reserve(maps.size());
+	map_encounter_sources.assign(maps.size(), {});
+	for (int i = 0; i < static_cast<int>(maps.size()); ++i) {
+		map_permissions.push_back(ResolvePermissions(i));
+		map_encounter_sources[i].push_back(i);
+	}
+
+	for (int i = 0; i < static_cast<int>(maps.size()); ++i) {
+		if (maps[i].type != lcf::rpg::TreeMap::MapType_area) {
+			continue;
 		}
+		const int parent_index = FindMapIndex(maps[i].parent_map);
+		if (parent_index >= 0 && parent_index != i) {
+			auto& sources = map_encounter_sources[parent_index];
+			sources.insert(std::upper_bound(sources.begin(), sources.end(), i), i);
+		}
+	}
+}
+
+int Game_Map::GetMapIndex(int id) {
+	const auto& maps = lcf::Data::treemap.maps;
+	int index = FindMapIndex(id);
+	if (!IsMapIndexCurrent() || (index >= 0 && maps[index].ID != id)) {
+		RebuildMapIndex();
+		index = FindMapIndex(id);
 	}
-	// nothing found
-	return -1;
+	return index;
 }
 
 StringView Game_Map::GetMapName(int id) {
-	for (unsigned int i = 0; i < lcf::Data::treemap.maps.size(); ++i) {
-		if (lcf::Data::treemap.maps[i].ID == id) {
-			return lcf::Data::treemap.maps[i].name;
-		}
+	const int index = GetMapIndex(id);
+	if (index == -1) {
+		// nothing found
+		return {};
 	}
-	// nothing found
-	return {};
+	return lcf::Data::treemap.maps[index].name;
 }
 
 int Game_Map::GetMapType(int map_id) {
@@ -1448,6 +1961,8 @@ void Game_Map::SetChipset(int id) {
 		passages_down.resize(162, (unsigned char) 0x0F);
 	if (passages_up.size() < 144)
 		passages_up.resize(144, (unsigned char) 0x0F);
+
+	cell_passages_dirty = true;
 }
 
 Game_Vehicle* Game_Map::GetVehicle(Game_Vehicle::Type which) {
@@ -1465,8 +1980,8 @@ bool Game_Map::IsAnyEventStarting() {
 		if (ev.IsWaitingForegroundExecution() && !ev.GetList().empty() && ev.IsActive())
 			return true;
 
-	for (Game_CommonEvent& ev : common_events)
-		if (ev.IsWaitingForegroundExecution())
+	for (int idx : GetActiveCommonEvents())
+		if (common_events[idx].IsWaitingForegroundExecution())
 			return true;
 
 	return false;
@@ -1519,11 +2034,15 @@ static int DoSubstitute(std::vector<uint8_t>& tiles, int old_id, int new_id) {
 }
 
 int Game_Map::SubstituteDown(int old_id, int new_id) {
-	return DoSubstitute(map_info.lower_tiles, old_id, new_id);
+	int num_subst = DoSubstitute(map_info.lower_tiles, old_id, new_id);
+	cell_passages_dirty |= num_subst > 0;
+	return num_subst;
 }
 
 int Game_Map::SubstituteUp(int old_id, int new_id) {
-	return DoSubstitute(map_info.upper_tiles, old_id, new_id);
+	int num_subst = DoSubstitute(map_info.upper_tiles, old_id, new_id);
+	cell_passages_dirty |= num_subst > 0;
+	return num_subst;
 }
 
 std::string Game_Map::ConstructMapName(int map_id, bool is_easyrpg) {
@@ -1540,6 +2059,111 @@ FileRequestAsync* Game_Map::RequestMap(int map_id) {
 	return AsyncHandler::RequestFile(Game_Map::ConstructMapName(map_id, false));
 }
 
+static void PrefetchMapGraphics() {
+	// Graphics start downloading or decoding (see Cache::DecodeAsync) now,
+	// the map setup after the transition finds them ready
+	const auto* chipset = lcf::ReaderUtil::GetElement(lcf::Data::chipsets, prefetched_map->chipset_id);
+	if (chipset) {
+		AsyncHandler::PrefetchGraphic("ChipSet", chipset->chipset_name);
+	}
+	if (prefetched_map->parallax_flag) {
+		AsyncHandler::PrefetchGraphic("Panorama", prefetched_map->parallax_name);
+	}
+	for (const auto& ev : prefetched_map->events) {
+		for (const auto& page : ev.pages) {
+			AsyncHandler::PrefetchGraphic("CharSet", page.character_name);
+		}
+	}
+}
+
+static void OnPrefetchParsed(int map_id) {
+	if (map_id != prefetched_map_id || !prefetch_parse.valid()) {
+		// Another map was requested or the teleport took the map meanwhile
+		return;
+	}
+
+	prefetched_map = TakePrefetchParse();
+	if (!prefetched_map) {
+		prefetched_map_id = 0;
+		return;
+	}
+	PrefetchMapGraphics();
+}
+
+static void OnPrefetchMapReady(int map_id) {
+	if (map_id != prefetched_map_id) {
+		// Another map was requested meanwhile
+		return;
+	}
+
+	std::string map_file = FileFinder::FindDefault(Game_Map::ConstructMapName(map_id, true));
+	const bool xml = !map_file.empty();
+	if (!xml) {
+		map_file = FileFinder::FindDefault(Game_Map::ConstructMapName(map_id, false));
+	}
+
+	if (Input::IsRecording() || map_file.empty()) {
+		// Loaded and reported by the teleport
+		prefetched_map_id = 0;
+		return;
+	}
+
+	if (JobSystem::GetThreadCount() > 0 && !FileFinder::IsInArchive(map_file)
+			&& !GetCachedMap(map_id, Tr::GetCurrentTranslationId())) {
+		// Parsed on a worker while the erase transition runs, the
+		// translation and the map cache are handled by the main thread
+		auto task = std::make_shared<std::packaged_task<std::shared_ptr<lcf::rpg::Map>()>>(
+			[map_file, xml, encoding = Player::encoding]() -> std::shared_ptr<lcf::rpg::Map> {
+				auto map_stream = FileFinder::OpenNativeInputStream(map_file);
+				if (!map_stream) {
+					return nullptr;
+				}
+#ifdef HAVE_THREADS
+				std::lock_guard<std::mutex> lock(Player::GetLcfMutex());
+#endif
+				if (xml) {
+					return lcf::LMU_Reader::LoadXml(map_stream);
+				}
+				return lcf::LMU_Reader::Load(map_stream, encoding);
+			});
+		prefetch_parse = task->get_future().share();
+		JobSystem::Submit([task]() { (*task)(); }, [map_id]() { OnPrefetchParsed(map_id); });
+		return;
+	}
+
+	prefetched_map = Game_Map::loadMapFile(map_id);
+	if (!prefetched_map) {
+		prefetched_map_id = 0;
+		return;
+	}
+	prefetched_map_id = map_id;
+	PrefetchMapGraphics();
+}
+
+void Game_Map::PrefetchMap(int map_id) {
+	if (map_id == GetMapId() || map_id == prefetched_map_id) {
+		return;
+	}
+
+	prefetched_map.reset();
+	if (prefetch_parse.valid()) {
+		// The worker may still use it, the result is dropped
+		prefetch_parse = {};
+	}
+	prefetched_map_id = map_id;
+
+	// The files of the previous prefetch are not needed anymore
+	AsyncHandler::CancelPrefetch();
+
+	FileRequestAsync* request = RequestMap(map_id);
+	prefetch_request = request->Bind([map_id](FileRequestResult* result) {
+		if (result->success) {
+			OnPrefetchMapReady(map_id);
+		}
+	});
+	request->StartPrefetch();
+}
+
 // Parallax
 /////////////
 
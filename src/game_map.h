@@ -19,6 +19,7 @@
 #define EP_GAME_MAP_H
 
 // Headers
+#include <memory>
 #include <vector>
 #include <string>
 #include "system.h"
@@ -36,6 +37,7 @@
 #include <lcf/rpg/savevehiclelocation.h>
 #include <lcf/rpg/savecommonevent.h>
 #include "async_op.h"
+#include "frame_arena.h"
 
 class FileRequestAsync;
 struct BattleArgs;
@@ -95,14 +97,14 @@ namespace Game_Map {
 	 * @param map_id the id of the map to load
 	 * @return the map, or nullptr if it couldn't be loaded
 	 */
-	std::unique_ptr<lcf::rpg::Map> loadMapFile(int map_id);
+	std::shared_ptr<const lcf::rpg::Map> loadMapFile(int map_id);
 
 	/**
 	 * Setups a new map.
 	 *
 	 * @pre Main_Data::game_player->GetMapId() reflects the new map.
 	 */
-	void Setup(std::unique_ptr<lcf::rpg::Map> map);
+	void Setup(std::shared_ptr<const lcf::rpg::Map> map);
 
 	/**
 	 * Setups a map from a savegame.
@@ -117,7 +119,7 @@ namespace Game_Map {
 	 * @param save_ce - The common event state
 	 */
 	void SetupFromSave(
-			std::unique_ptr<lcf::rpg::Map> map,
+			std::shared_ptr<const lcf::rpg::Map> map,
 			lcf::rpg::SaveMapInfo save_map,
 			lcf::rpg::SaveVehicleLocation save_boat,
 			lcf::rpg::SaveVehicleLocation save_ship,
@@ -363,14 +365,14 @@ namespace Game_Map {
 	 *
 	 * @return lower layer map data.
 	 */
-	std::vector<short>& GetMapDataDown();
+	const std::vector<short>& GetMapDataDown();
 
 	/**
 	 * Gets upper layer map data.
 	 *
 	 * @return upper layer map data.
 	 */
-	std::vector<short>& GetMapDataUp();
+	const std::vector<short>& GetMapDataUp();
 
 	/** @return original map chipset ID */
 	int GetOriginalChipset();
@@ -435,11 +437,20 @@ namespace Game_Map {
 
 	/**
 	 * Sets the need refresh flag.
+	 * The refresh re-evaluates the pages of all events.
 	 *
 	 * @param refresh need refresh flag.
 	 */
 	void SetNeedRefresh(bool refresh);
 
+	/**
+	 * Requests a refresh of the events whose pages may change after
+	 * switch, variable or timer changes: the events using the switches and
+	 * variables in their change logs and all events with item, actor or
+	 * timer conditions.
+	 */
+	void SetNeedRefreshChanged();
+
 	/**
 	 * Gets lower passages list.
 	 *
@@ -495,6 +506,15 @@ namespace Game_Map {
 
 	void GetEventsXY(std::vector<Game_Event*>& events, int x, int y);
 
+	/**
+	 * Appends the active events at a position to a vector of the frame arena.
+	 *
+	 * @param events receives the events
+	 * @param x tile x position
+	 * @param y tile y position
+	 */
+	void GetEventsXY(FrameArena::Vector<Game_Event*>& events, int x, int y);
+
 	/**
 	 * @param x x position on the map
 	 * @param y y position on the map
@@ -503,6 +523,31 @@ namespace Game_Map {
 	 */
 	Game_Event* GetEventAt(int x, int y, bool require_active);
 
+	/**
+	 * Iterates the events at a position in ascending id order. Events moved
+	 * while iterating are found at their new position.
+	 *
+	 * @param x x position on the map
+	 * @param y y position on the map
+	 * @param after event to continue after, nullptr to start with the lowest id
+	 * @return the event with the next higher id at (x,y) or nullptr
+	 */
+	Game_Event* GetNextEventAt(int x, int y, const Game_Event* after);
+
+	/**
+	 * Updates the position of an event in the tile index.
+	 * Called by Game_Character when the position of an event changes.
+	 *
+	 * @param ev the moved event
+	 */
+	void OnEventMoved(const Game_Character& ev);
+
+	/**
+	 * Called by Game_Event when its page or its active flag changed,
+	 * the list of events updated per frame is rebuilt.
+	 */
+	void OnEventStateChanged();
+
 	bool LoopHorizontal();
 	bool LoopVertical();
 
@@ -523,6 +568,24 @@ namespace Game_Map {
 	 */
 	int GetMapIndex(int id);
 
+	/**
+	 * Builds the map ID to index table and the save, escape and teleport
+	 * permissions inherited from the parent maps. Called after the map tree
+	 * was loaded, GetMapIndex rebuilds it too when the tree was replaced.
+	 */
+	void RebuildMapIndex();
+
+	/**
+	 * Drops parsed maps kept for later teleports, least recently used
+	 * first, until they use at most bytes. Used on low memory.
+	 *
+	 * @param bytes size to reach
+	 */
+	void TrimMapCache(size_t bytes);
+
+	/** @return bytes of the parsed maps kept for later teleports */
+	size_t GetMapCacheSize();
+
 	/**
 	 * Gets the map name from MapInfo vector using map ID.
 	 *
@@ -585,6 +648,32 @@ namespace Game_Map {
 	 */
 	bool IsPassableLowerTile(int bit, int tile_index);
 
+	/**
+	 * Gets the first step of a shortest walking path between two tiles.
+	 * Only the tile passages are considered, events on the way are not.
+	 * The paths to a target tile are computed once and shared by all callers
+	 * until the passages change.
+	 *
+	 * @param x start tile x.
+	 * @param y start tile y.
+	 * @param target_x target tile x.
+	 * @param target_y target tile y.
+	 * @return direction (Up, Right, Down or Left) or -1 at the target and when it is unreachable.
+	 */
+	int GetPathDirection(int x, int y, int target_x, int target_y);
+
+	/**
+	 * Gets the length of a shortest walking path between two tiles.
+	 *
+	 * @see GetPathDirection
+	 * @param x start tile x.
+	 * @param y start tile y.
+	 * @param target_x target tile x.
+	 * @param target_y target tile y.
+	 * @return number of steps or -1 when the target is unreachable.
+	 */
+	int GetPathDistance(int x, int y, int target_x, int target_y);
+
 	/**
 	 * Gets whether there are any starting non-parallel event or common event.
 	 * Used as a workaround for the Game Player.
@@ -619,6 +708,15 @@ namespace Game_Map {
 
 	FileRequestAsync* RequestMap(int map_id);
 
+	/**
+	 * Starts loading a map and the graphics of its chipset, panorama and
+	 * events ahead of a teleport. The loaded map is used by the next
+	 * loadMapFile call for it.
+	 *
+	 * @param map_id the map to prefetch
+	 */
+	void PrefetchMap(int map_id);
+
 	namespace Parallax {
 		struct Params {
 			std::string name;
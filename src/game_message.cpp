@@ -83,24 +83,28 @@ int Game_Message::WordWrap(StringView line, const int limit, const WordWrapCallb
 	int start = 0;
 	int line_count = 0;
 	FontRef font = Font::Default();
+	// Width of line[start, next), every word is measured once per line
+	Font::TextWidth width(*font);
 
 	do {
 		int next = start;
+		width.Reset();
 		do {
 			auto found = line.find(' ', next);
 			if (found == std::string::npos) {
 				found = line.size();
 			}
 
-			auto wrapped = line.substr(start, found - start);
-			auto width = font->GetSize(wrapped).width;
-			if (width > limit) {
+			auto word = line.substr(next, found - next);
+			if (width.Peek(word) > limit) {
 				if (next == start) {
 					next = found + 1;
 				}
 				break;
 			}
 
+			width.Append(word);
+			width.Append(" ");
 			next = found + 1;
 		} while(next < static_cast<int>(line.size()));
 
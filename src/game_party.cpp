@@ -40,6 +40,7 @@ void Game_Party::SetupNewGame() {
 
 	data.party = lcf::Data::system.party;
 	RemoveInvalidData();
+	RebuildItemCountIndex();
 }
 
 void Game_Party::SetupFromSave(lcf::rpg::SaveInventory save) {
@@ -75,25 +76,27 @@ void Game_Party::SetupFromSave(lcf::rpg::SaveInventory save) {
 			usages.push_back(itd.usage);
 		}
 	}
+
+	RebuildItemCountIndex();
 }
 
 Game_Actor& Game_Party::operator[] (const int index) {
-	std::vector<Game_Actor*> actors = GetActors();
-
-	if (index < 0 || (size_t)index >= actors.size()) {
+	if (index < 0 || (size_t)index >= data.party.size()) {
 		assert(false && "Subscript out of range");
 	}
 
-	return *actors[index];
+	return *GetActor(index);
 }
 
 int Game_Party::GetBattlerCount() const {
-	return (int)GetActors().size();
+	return (int)data.party.size();
 }
 
 int Game_Party::GetVisibleBattlerCount() const {
 	int visible = 0;
-	for (const auto& actor: GetActors()) {
+	FrameArena::Vector<Game_Actor*> actors;
+	GetActors(actors);
+	for (const auto& actor: actors) {
 		visible += !actor->IsHidden();
 	}
 	return visible;
@@ -132,8 +135,10 @@ void Game_Party::GetItems(std::vector<int>& item_list) {
 }
 
 int Game_Party::GetItemCount(int item_id) const {
-	auto ip = GetItemIndex(item_id);
-	return ip.second ? data.item_counts[ip.first] : 0;
+	if (item_id <= 0 || item_id >= static_cast<int>(item_count_index.size())) {
+		return 0;
+	}
+	return item_count_index[item_id];
 }
 
 int Game_Party::GetEquippedItemCount(int item_id) const {
@@ -172,6 +177,7 @@ void Game_Party::AddItem(int item_id, int amount) {
 			data.item_ids.insert(data.item_ids.begin() + idx, (int16_t)item_id);
 			data.item_counts.insert(data.item_counts.begin() + idx, (uint8_t)amount);
 			data.item_usage.insert(data.item_usage.begin() + idx, 0);
+			SetItemCountIndex(item_id, amount);
 		}
 		return;
 	}
@@ -182,10 +188,12 @@ void Game_Party::AddItem(int item_id, int amount) {
 		data.item_ids.erase(data.item_ids.begin() + idx);
 		data.item_counts.erase(data.item_counts.begin() + idx);
 		data.item_usage.erase(data.item_usage.begin() + idx);
+		SetItemCountIndex(item_id, 0);
 		return;
 	}
 
 	data.item_counts[idx] = (uint8_t)std::min(total_items, 99);
+	SetItemCountIndex(item_id, data.item_counts[idx]);
 	// If the item was removed, the number of uses resets.
 	// (Adding an item never changes the number of uses, even when
 	// you already have x99 of them.)
@@ -237,9 +245,11 @@ void Game_Party::ConsumeItemUse(int item_id) {
 			data.item_ids.erase(data.item_ids.begin() + idx);
 			data.item_counts.erase(data.item_counts.begin() + idx);
 			data.item_usage.erase(data.item_usage.begin() + idx);
+			SetItemCountIndex(item_id, 0);
 		} else {
 			data.item_counts[idx]--;
 			data.item_usage[idx] = 0;
+			SetItemCountIndex(item_id, data.item_counts[idx]);
 		}
 	}
 }
@@ -472,6 +482,13 @@ std::vector<Game_Actor*> Game_Party::GetActors() const {
 	return actors;
 }
 
+void Game_Party::GetActors(FrameArena::Vector<Game_Actor*>& actors) const {
+	actors.clear();
+	for (auto actor_id: data.party) {
+		actors.push_back(Main_Data::game_actors->GetActor(actor_id));
+	}
+}
+
 Game_Actor* Game_Party::GetActor(int idx) const {
 	if (idx < static_cast<int>(data.party.size())) {
 		return Main_Data::game_actors->GetActor(data.party[idx]);
@@ -493,11 +510,11 @@ void Game_Party::SetTimer(int which, int seconds) {
 	switch (which) {
 		case Timer1:
 			data.timer1_frames = seconds * DEFAULT_FPS + (DEFAULT_FPS - 1);
-			Game_Map::SetNeedRefresh(true);
+			Game_Map::SetNeedRefreshChanged();
 			break;
 		case Timer2:
 			data.timer2_frames = seconds * DEFAULT_FPS + (DEFAULT_FPS -1);
-			Game_Map::SetNeedRefresh(true);
+			Game_Map::SetNeedRefreshChanged();
 			break;
 	}
 }
@@ -559,7 +576,7 @@ void Game_Party::UpdateTimers() {
 	}
 
 	if (seconds_changed) {
-		Game_Map::SetNeedRefresh(true);
+		Game_Map::SetNeedRefreshChanged();
 	}
 }
 
@@ -662,11 +679,13 @@ void Game_Party::RemoveInvalidData() {
 	}
 }
 
-std::vector<int16_t> Game_Party::GetInflictedStates() const {
-	std::vector<int16_t> states;
-
-	for (auto actor : GetActors()) {
-		std::vector<int16_t> actor_states = actor->GetInflictedStates();
+template <typename T>
+static void CollectInflictedStates(const Game_Party& party, T& states) {
+	FrameArena::Vector<Game_Actor*> actors;
+	party.GetActors(actors);
+	FrameArena::Vector<int16_t> actor_states;
+	for (auto actor : actors) {
+		actor->GetInflictedStates(actor_states);
 		states.insert(states.end(), actor_states.begin(), actor_states.end());
 	}
 
@@ -674,12 +693,25 @@ std::vector<int16_t> Game_Party::GetInflictedStates() const {
 		std::sort(states.begin(), states.end());
 		states.erase(std::unique(states.begin(), states.end()), states.end());
 	}
+}
+
+std::vector<int16_t> Game_Party::GetInflictedStates() const {
+	std::vector<int16_t> states;
+	CollectInflictedStates(*this, states);
 	return states;
 }
 
+void Game_Party::GetInflictedStates(FrameArena::Vector<int16_t>& states) const {
+	states.clear();
+	CollectInflictedStates(*this, states);
+}
+
 bool Game_Party::ApplyStateDamage() {
 	bool damage = false;
-	std::vector<int16_t> states = GetInflictedStates();
+	FrameArena::Vector<int16_t> states;
+	GetInflictedStates(states);
+	FrameArena::Vector<Game_Actor*> actors;
+	GetActors(actors);
 
 	const auto steps = GetSteps();
 
@@ -690,7 +722,7 @@ bool Game_Party::ApplyStateDamage() {
 				&& state->hp_change_map_val > 0
 				&& ((steps % state->hp_change_map_steps) == 0)
 				) {
-			for (auto actor : GetActors()) {
+			for (auto actor : actors) {
 				if (actor->HasState(state_id)) {
 					if (state->hp_change_type == lcf::rpg::State::ChangeType_lose) {
 						actor->ChangeHp(-state->hp_change_map_val, false);
@@ -707,7 +739,7 @@ bool Game_Party::ApplyStateDamage() {
 				&& state->sp_change_map_val > 0
 				&& ((steps % state->sp_change_map_steps) == 0)
 		   ){
-			for (auto actor : GetActors()) {
+			for (auto actor : actors) {
 				if (actor->HasState(state_id)) {
 					if (state->sp_change_type == lcf::rpg::State::ChangeType_lose) {
 						actor->ChangeSp(-state->sp_change_map_val);
@@ -725,7 +757,9 @@ bool Game_Party::ApplyStateDamage() {
 }
 
 bool Game_Party::IsAnyControllable() {
-	for (auto& actor: GetActors()) {
+	FrameArena::Vector<Game_Actor*> actors;
+	GetActors(actors);
+	for (auto& actor: actors) {
 		if (actor->IsControllable()) {
 			return true;
 		}
@@ -736,7 +770,9 @@ bool Game_Party::IsAnyControllable() {
 Game_Actor* Game_Party::GetHighestLeveledActorWhoCanUse(const lcf::rpg::Item* item) const {
 	Game_Actor* best = nullptr;
 
-	for (auto* actor : GetActors()) {
+	FrameArena::Vector<Game_Actor*> actors;
+	GetActors(actors);
+	for (auto* actor : actors) {
 		if (actor->CanAct()
 				&& actor->IsItemUsable(item->ID)
 				&& (best == nullptr || best->GetLevel() < actor->GetLevel())) {
@@ -746,6 +782,25 @@ Game_Actor* Game_Party::GetHighestLeveledActorWhoCanUse(const lcf::rpg::Item* it
 	return best;
 }
 
+void Game_Party::RebuildItemCountIndex() {
+	item_count_index.assign(lcf::Data::items.size() + 1, 0);
+
+	const auto num_items = std::min(data.item_ids.size(), data.item_counts.size());
+	for (size_t i = 0; i < num_items; ++i) {
+		const auto item_id = data.item_ids[i];
+		if (item_id > 0) {
+			SetItemCountIndex(item_id, data.item_counts[i]);
+		}
+	}
+}
+
+void Game_Party::SetItemCountIndex(int item_id, int count) {
+	if (item_id >= static_cast<int>(item_count_index.size())) {
+		item_count_index.resize(item_id + 1, 0);
+	}
+	item_count_index[item_id] = static_cast<uint8_t>(count);
+}
+
 std::pair<int,bool> Game_Party::GetItemIndex(int item_id) const {
 	auto& ids = data.item_ids;
 	auto iter = std::lower_bound(ids.begin(), ids.end(), item_id);
@@ -22,6 +22,7 @@
 #include <vector>
 #include "game_party_base.h"
 #include "game_actor.h"
+#include "frame_arena.h"
 #include <lcf/rpg/saveinventory.h>
 
 /**
@@ -215,6 +216,13 @@ public:
 	 */
 	std::vector<Game_Actor*> GetActors() const;
 
+	/**
+	 * Gets actors in party list into a vector of the frame arena.
+	 *
+	 * @param actors receives the actors in party list.
+	 */
+	void GetActors(FrameArena::Vector<Game_Actor*>& actors) const;
+
 	/**
 	 * Get's the i'th actor in the party.
 	 *
@@ -362,6 +370,13 @@ public:
 
 	std::vector<int16_t> GetInflictedStates() const;
 
+	/**
+	 * Gets the states of all party members, sorted and without duplicates.
+	 *
+	 * @param states receives the state IDs
+	 */
+	void GetInflictedStates(FrameArena::Vector<int16_t>& states) const;
+
 	/**
 	 * Applies damage to the game party based on their stats.
 	 *
@@ -400,7 +415,20 @@ public:
 private:
 	std::pair<int,bool> GetItemIndex(int item_id) const;
 
+	/** Rebuilds item_count_index from the inventory */
+	void RebuildItemCountIndex();
+
+	/**
+	 * Stores the count of an item in item_count_index.
+	 *
+	 * @param item_id database item id
+	 * @param count number of items in the inventory
+	 */
+	void SetItemCountIndex(int item_id, int count);
+
 	lcf::rpg::SaveInventory data;
+	/** Number of items in the inventory indexed by item ID, kept in sync with data */
+	std::vector<uint8_t> item_count_index;
 };
 
 // ------ INLINES --------
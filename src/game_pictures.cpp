@@ -16,6 +16,7 @@
  */
 
 #define _USE_MATH_DEFINES
+#include <algorithm>
 #include <cmath>
 #include "bitmap.h"
 #include "options.h"
@@ -92,6 +93,17 @@ void Game_Pictures::SetSaveData(std::vector<lcf::rpg::SavePicture> save)
 	for (int i = 0; i < num_pictures; ++i) {
 		pictures.emplace_back(std::move(save[i]));
 	}
+
+	active_pictures.clear();
+	fixed_pictures.clear();
+	map_frames = 0;
+	battle_frames = 0;
+	for (auto& pic: pictures) {
+		if (pic.needs_update) {
+			Activate(pic);
+		}
+		UpdateFixedToMap(pic);
+	}
 }
 
 std::vector<lcf::rpg::SavePicture> Game_Pictures::GetSaveData() const {
@@ -102,6 +114,9 @@ std::vector<lcf::rpg::SavePicture> Game_Pictures::GetSaveData() const {
 
 	for (auto& pic: pictures) {
 		save.push_back(pic.data);
+		if (!pic.active) {
+			save.back().frames += GetMissedFrames(pic);
+		}
 	}
 
 	// RPG_RT Save game data always has a constant number of pictures
@@ -144,6 +159,8 @@ Game_Pictures::Picture& Game_Pictures::GetPicture(int id) {
 		pictures.reserve(id);
 		while (static_cast<int>(pictures.size()) < id) {
 			pictures.emplace_back(pictures.size() + 1);
+			pictures.back().map_frames = map_frames;
+			pictures.back().battle_frames = battle_frames;
 		}
 	}
 	return pictures[id - 1];
@@ -230,7 +247,10 @@ bool Game_Pictures::Picture::Show(const ShowParams& params) {
 
 void Game_Pictures::Show(int id, const ShowParams& params) {
 	auto& pic = GetPicture(id);
-	if (pic.Show(params)) {
+	Activate(pic);
+	const bool request = pic.Show(params);
+	UpdateFixedToMap(pic);
+	if (request) {
 		RequestPictureSprite(pic);
 	}
 }
@@ -280,6 +300,7 @@ void Game_Pictures::Picture::Move(const MoveParams& params) {
 
 void Game_Pictures::Move(int id, const MoveParams& params) {
 	auto& pic = GetPicture(id);
+	Activate(pic);
 	pic.Move(params);
 }
 
@@ -353,8 +374,8 @@ void Game_Pictures::Picture::OnMapScrolled(int dx16, int dy16) {
 }
 
 void Game_Pictures::OnMapScrolled(int dx, int dy) {
-	for (auto& pic: pictures) {
-		pic.OnMapScrolled(dx, dy);
+	for (auto id: fixed_pictures) {
+		pictures[id - 1].OnMapScrolled(dx, dy);
 	}
 }
 
@@ -440,10 +461,84 @@ void Game_Pictures::Picture::Update(bool is_battle) {
 	}
 }
 
+bool Game_Pictures::Picture::IsSettled() const {
+	if (!needs_update) {
+		return true;
+	}
+	if (data.time_left > 0 || data.effect_mode != lcf::rpg::SavePicture::Effect_none) {
+		return false;
+	}
+	// Rotation continues until the revolution is done
+	if (data.current_effect_power > 0 && data.current_rotation > 0.0) {
+		return false;
+	}
+	if (Player::IsRPG2k3E() && data.spritesheet_speed > 0) {
+		return false;
+	}
+	return data.current_x == data.finish_x
+		&& data.current_y == data.finish_y
+		&& data.current_red == data.finish_red
+		&& data.current_green == data.finish_green
+		&& data.current_blue == data.finish_blue
+		&& data.current_sat == data.finish_sat
+		&& data.current_magnify == data.finish_magnify
+		&& data.current_top_trans == data.finish_top_trans
+		&& data.current_bot_trans == data.finish_bot_trans;
+}
+
 void Game_Pictures::Update(bool is_battle) {
 	++frame_counter;
-	for (auto& pic: pictures) {
+
+	// Inactive pictures get the frames they missed when they are activated or saved
+	if (Player::IsRPG2k3E()) {
+		++(is_battle ? battle_frames : map_frames);
+	}
+
+	for (size_t i = 0; i < active_pictures.size();) {
+		auto& pic = pictures[active_pictures[i] - 1];
 		pic.Update(is_battle);
+
+		if (pic.IsSettled()) {
+			pic.active = false;
+			pic.map_frames = map_frames;
+			pic.battle_frames = battle_frames;
+			active_pictures[i] = active_pictures.back();
+			active_pictures.pop_back();
+		} else {
+			++i;
+		}
+	}
+}
+
+void Game_Pictures::Activate(Picture& pic) {
+	if (pic.active) {
+		return;
+	}
+	pic.data.frames += GetMissedFrames(pic);
+	pic.active = true;
+	active_pictures.push_back(pic.data.ID);
+}
+
+int Game_Pictures::GetMissedFrames(const Picture& pic) const {
+	int frames = 0;
+	if (pic.IsOnMap()) {
+		frames += map_frames - pic.map_frames;
+	}
+	if (pic.IsOnBattle()) {
+		frames += battle_frames - pic.battle_frames;
+	}
+	return frames;
+}
+
+void Game_Pictures::UpdateFixedToMap(const Picture& pic) {
+	const int id = pic.data.ID;
+	auto it = std::find(fixed_pictures.begin(), fixed_pictures.end(), id);
+	if (pic.data.fixed_to_map) {
+		if (it == fixed_pictures.end()) {
+			fixed_pictures.push_back(id);
+		}
+	} else if (it != fixed_pictures.end()) {
+		fixed_pictures.erase(it);
 	}
 }
 
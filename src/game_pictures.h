@@ -93,9 +93,19 @@ public:
 		lcf::rpg::SavePicture data;
 		FileRequestBinding request_id;
 		bool needs_update = false;
+		/** Picture is in the list of pictures updated every frame */
+		bool active = false;
+		/** Map and battle frame counters when the picture was last updated */
+		int map_frames = 0;
+		int battle_frames = 0;
 
 		void Update(bool is_battle);
 
+		/**
+		 * @return Whether Update would only advance the frame counter
+		 */
+		bool IsSettled() const;
+
 		bool IsOnMap() const;
 		bool IsOnBattle() const;
 		int NumSpriteSheetFrames() const;
@@ -117,9 +127,30 @@ private:
 	void RequestPictureSprite(Picture& pic);
 	void OnPictureSpriteReady(int id);
 
+	/**
+	 * Adds a picture to the list of pictures updated every frame.
+	 * The frames it missed while inactive are added first.
+	 */
+	void Activate(Picture& pic);
+
+	/**
+	 * @return Number of frames an inactive picture missed since it was deactivated
+	 */
+	int GetMissedFrames(const Picture& pic) const;
+
+	/** Keeps fixed_pictures in sync with the fixed_to_map flag of the picture */
+	void UpdateFixedToMap(const Picture& pic);
+
 	std::vector<Picture> pictures;
 	std::deque<Sprite_Picture> sprites;
+	/** IDs of pictures which are animating */
+	std::vector<int> active_pictures;
+	/** IDs of pictures which move with the map */
+	std::vector<int> fixed_pictures;
 	int frame_counter = 0;
+	/** Updates on the map and in battle which advanced the picture frames */
+	int map_frames = 0;
+	int battle_frames = 0;
 };
 
 inline bool Game_Pictures::Picture::IsOnMap() const {
@@ -51,6 +51,8 @@ Game_Player::Game_Player(): Game_PlayerBase(Player)
 void Game_Player::SetSaveData(lcf::rpg::SavePartyLocation save)
 {
 	*data() = std::move(save);
+	ResetMoveRoutePrograms();
+	OnSpriteChanged();
 
 	SanitizeData("Party");
 
@@ -75,6 +77,8 @@ void Game_Player::ReserveTeleport(int map_id, int x, int y, int direction, Telep
 	FileRequestAsync* request = Game_Map::RequestMap(map_id);
 	request->SetImportantFile(true);
 	request->Start();
+
+	Game_Map::PrefetchMap(map_id);
 }
 
 void Game_Player::ReserveTeleport(const lcf::rpg::SaveTarget& target) {
@@ -274,7 +278,7 @@ void Game_Player::UpdateNextMovementAction() {
 
 		ResetAnimation();
 		Main_Data::game_system->SePlay(Main_Data::game_system->GetSystemSE(Main_Data::game_system->SFX_Decision));
-		Scene::instance->SetRequestedScene(std::make_shared<Scene_Menu>());
+		Scene::instance->SetRequestedScene(Scene::CreateWarm<Scene_Menu>(Scene::Menu));
 		return;
 	}
 
@@ -413,16 +417,14 @@ bool Game_Player::CheckEventTriggerHere(TriggerSet triggers, bool triggered_by_d
 
 	bool result = false;
 
-	for (auto& ev: Game_Map::GetEvents()) {
-		const auto trigger = ev.GetTrigger();
-		if (ev.IsActive()
-				&& ev.GetX() == GetX()
-				&& ev.GetY() == GetY()
-				&& ev.GetLayer() != lcf::rpg::EventPage::Layers_same
+	for (auto* ev = Game_Map::GetNextEventAt(GetX(), GetY(), nullptr); ev; ev = Game_Map::GetNextEventAt(GetX(), GetY(), ev)) {
+		const auto trigger = ev->GetTrigger();
+		if (ev->IsActive()
+				&& ev->GetLayer() != lcf::rpg::EventPage::Layers_same
 				&& trigger >= 0
 				&& triggers[trigger]) {
 			SetEncounterCalling(false);
-			result |= ev.ScheduleForegroundExecution(triggered_by_decision_key, true);
+			result |= ev->ScheduleForegroundExecution(triggered_by_decision_key, true);
 		}
 	}
 	return result;
@@ -434,16 +436,14 @@ bool Game_Player::CheckEventTriggerThere(TriggerSet triggers, int x, int y, bool
 	}
 	bool result = false;
 
-	for (auto& ev : Game_Map::GetEvents()) {
-		const auto trigger = ev.GetTrigger();
-		if (ev.IsActive()
-				&& ev.GetX() == x
-				&& ev.GetY() == y
-				&& ev.GetLayer() == lcf::rpg::EventPage::Layers_same
+	for (auto* ev = Game_Map::GetNextEventAt(x, y, nullptr); ev; ev = Game_Map::GetNextEventAt(x, y, ev)) {
+		const auto trigger = ev->GetTrigger();
+		if (ev->IsActive()
+				&& ev->GetLayer() == lcf::rpg::EventPage::Layers_same
 				&& trigger >= 0
 				&& triggers[trigger]) {
 			SetEncounterCalling(false);
-			result |= ev.ScheduleForegroundExecution(triggered_by_decision_key, true);
+			result |= ev->ScheduleForegroundExecution(triggered_by_decision_key, true);
 		}
 	}
 	return result;
@@ -614,7 +614,9 @@ bool Game_Player::Move(int dir) {
 			Main_Data::game_system->SePlay(terrain->footstep);
 		}
 		if (terrain->damage > 0) {
-			for (auto hero : Main_Data::game_party->GetActors()) {
+			FrameArena::Vector<Game_Actor*> actors;
+			Main_Data::game_party->GetActors(actors);
+			for (auto hero : actors) {
 				if (!hero->PreventsTerrainDamage()) {
 					red_flash = true;
 					hero->ChangeHp(-terrain->damage, false);
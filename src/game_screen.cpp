@@ -198,11 +198,23 @@ void Game_Screen::OnWeatherChanged() {
 	}
 }
 
+void Game_Screen::Particles::resize(int n) {
+	t.resize(n);
+	x.resize(n);
+	y.resize(n);
+	alpha.resize(n);
+	vx.resize(n);
+	vy.resize(n);
+	ax.resize(n);
+	ay.resize(n);
+	idle.resize(n);
+}
+
 void Game_Screen::InitParticles(int num_particles) {
 	// RPG_RT initializes all particles on new game / load game.
 	// We do it lazily instead. That way for games which don't use
 	// weather effects, we never consume memory for those effects.
-	auto sz = static_cast<int>(particles.size());
+	auto sz = particles.size();
 
 	if (num_particles <= sz) {
 		return;
@@ -211,47 +223,59 @@ void Game_Screen::InitParticles(int num_particles) {
 	particles.resize(num_particles);
 
 	for (int i = sz; i < num_particles; ++i) {
-		auto& p = particles[i];
 		// RPG_RT always initializes all particles to these values on startup.
 		// This can cause minor visual glitches for the first few frames the
 		// first time you start the sandstorm effect. We're bug compatible with RPG_RT.
-		p.t = Rand::GetRandomNumber(0, 39);
-		p.x = Rand::GetRandomNumber(0, GetPanLimitX() / 16 - 1);
-		p.y = Rand::GetRandomNumber(0, GetPanLimitY() / 16 - 1);
+		particles.t[i] = Rand::GetCosmeticNumber(0, 39);
+		particles.x[i] = Rand::GetCosmeticNumber(0, GetPanLimitX() / 16 - 1);
+		particles.y[i] = Rand::GetCosmeticNumber(0, GetPanLimitY() / 16 - 1);
 	}
 }
 
 void Game_Screen::UpdateRain() {
-	for (auto& p: particles) {
-		if (p.t > 0) {
-			--p.t;
-			p.y += 4;
-			p.x -= 1;
-		} else if (Rand::PercentChance(10)) {
-			p.t = 12;
-			p.x = Rand::GetRandomNumber(0, GetPanLimitX() / 16 - 1);
-			p.y = Rand::GetRandomNumber(0, GetPanLimitY() / 16 - 1);
+	const int n = particles.size();
+	auto* t = particles.t.data();
+	auto* x = particles.x.data();
+	auto* y = particles.y.data();
+	auto* idle = particles.idle.data();
+
+	// Move the active particles, no branches to allow vectorization
+	for (int i = 0; i < n; ++i) {
+		const int16_t active = t[i] > 0;
+		idle[i] = !active;
+		t[i] -= active;
+		y[i] += 4 * active;
+		x[i] -= active;
+	}
+
+	// The random numbers are taken in the same order as RPG_RT
+	for (int i = 0; i < n; ++i) {
+		if (idle[i] && Rand::GetCosmeticNumber(0, 99) < 10) {
+			t[i] = 12;
+			x[i] = Rand::GetCosmeticNumber(0, GetPanLimitX() / 16 - 1);
+			y[i] = Rand::GetCosmeticNumber(0, GetPanLimitY() / 16 - 1);
 		}
 	}
 }
 
 void Game_Screen::UpdateSnow() {
-	for (auto& p: particles) {
-		if (p.t > 0) {
-			--p.t;
-			p.x -= Rand::GetRandomNumber(0, 1);
-			p.y += Rand::GetRandomNumber(2, 3);
-		} else if (Rand::PercentChance(5)) {
-			p.t = 30;
-			p.x = Rand::GetRandomNumber(0, GetPanLimitX() / 16 - 1);
-			p.y = Rand::GetRandomNumber(0, GetPanLimitY() / 16 - 1);
+	// The movement is random, the random numbers must be taken in particle order
+	for (int i = 0; i < particles.size(); ++i) {
+		if (particles.t[i] > 0) {
+			--particles.t[i];
+			particles.x[i] -= Rand::GetCosmeticNumber(0, 1);
+			particles.y[i] += Rand::GetCosmeticNumber(2, 3);
+		} else if (Rand::GetCosmeticNumber(0, 99) < 5) {
+			particles.t[i] = 30;
+			particles.x[i] = Rand::GetCosmeticNumber(0, GetPanLimitX() / 16 - 1);
+			particles.y[i] = Rand::GetCosmeticNumber(0, GetPanLimitY() / 16 - 1);
 		}
 	}
 }
 
 void Game_Screen::UpdateFog() {
-	++particles[0].x;
-	++particles[1].x;
+	++particles.x[0];
+	++particles.x[1];
 }
 
 void Game_Screen::UpdateSandstorm() {
@@ -260,35 +284,52 @@ void Game_Screen::UpdateSandstorm() {
 	// accounts for the range starting at 1 (not 0) and ending at 127 (not 128).
 
 	constexpr auto epsilon = 1.0f / 128.0f;
-	auto& rng = Rand::GetRNG();
+	auto& rng = Rand::GetRNG(Rand::Stream::Cosmetic);
 	auto dist = std::uniform_real_distribution<float>(epsilon, M_PI - epsilon);
 
 	UpdateFog();
 
-	for (size_t i = 2; i < particles.size(); ++i) {
-		auto& p = particles[i];
-		if (p.t > 0) {
-			--p.t;
-			p.alpha += 2;
-			p.x += static_cast<int>(p.vx);
-			p.y += static_cast<int>(p.vy);
-			p.vx += p.ax;
-			p.vy += p.ay;
-		} else if (Rand::PercentChance(10)) {
-			p.t = 80;
+	const int n = particles.size();
+	auto* t = particles.t.data();
+	auto* x = particles.x.data();
+	auto* y = particles.y.data();
+	auto* alpha = particles.alpha.data();
+	auto* vx = particles.vx.data();
+	auto* vy = particles.vy.data();
+	auto* ax = particles.ax.data();
+	auto* ay = particles.ay.data();
+	auto* idle = particles.idle.data();
+
+	// Move the active particles, no branches to allow vectorization
+	for (int i = 2; i < n; ++i) {
+		const int16_t active = t[i] > 0;
+		const float factor = active;
+		idle[i] = !active;
+		t[i] -= active;
+		alpha[i] += 2 * active;
+		x[i] += active * static_cast<int>(vx[i]);
+		y[i] += active * static_cast<int>(vy[i]);
+		vx[i] += factor * ax[i];
+		vy[i] += factor * ay[i];
+	}
+
+	// The random numbers are taken in the same order as RPG_RT
+	for (int i = 2; i < n; ++i) {
+		if (idle[i] && Rand::GetCosmeticNumber(0, 99) < 10) {
+			t[i] = 80;
 
 			auto c = std::cos(dist(rng));
 			auto s = std::sin(dist(rng));
-			auto d = Rand::GetRandomNumber(16, 95);
+			auto d = Rand::GetCosmeticNumber(16, 95);
 
-			p.x = static_cast<int>(d * c * 2.0f) * SCREEN_TARGET_WIDTH / 320 + SCREEN_TARGET_WIDTH / 2;
-			p.y = static_cast<int>(d * s) * SCREEN_TARGET_HEIGHT / 240;
+			x[i] = static_cast<int>(d * c * 2.0f) * SCREEN_TARGET_WIDTH / 320 + SCREEN_TARGET_WIDTH / 2;
+			y[i] = static_cast<int>(d * s) * SCREEN_TARGET_HEIGHT / 240;
 
-			p.alpha = 180;
-			p.vx = 0.0;
-			p.vy = 0.0;
-			p.ax = c * 2.0f * SCREEN_TARGET_WIDTH / 320;
-			p.ay = s * 2.0f * SCREEN_TARGET_HEIGHT / 240;
+			alpha[i] = 180;
+			vx[i] = 0.0;
+			vy[i] = 0.0;
+			ax[i] = c * 2.0f * SCREEN_TARGET_WIDTH / 320;
+			ay[i] = s * 2.0f * SCREEN_TARGET_HEIGHT / 240;
 		}
 	}
 }
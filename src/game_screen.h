@@ -85,20 +85,29 @@ public:
 	 */
 	int GetWeatherStrength();
 
-	struct Particle {
-		int16_t t = 0;
-		int16_t x = 0;
-		int16_t y = 0;
+	/**
+	 * Weather particles as structure of arrays.
+	 * This way the updates of all particles are vectorized by the compiler.
+	 */
+	struct Particles {
+		std::vector<int16_t> t;
+		std::vector<int16_t> x;
+		std::vector<int16_t> y;
 		// These are only used for sandstorm particles.
 		// RPG_RT uses double. We use float to save space.
-		int16_t alpha = 0;
-		float vx = 0.0;
-		float vy = 0.0;
-		float ax = 0.0;
-		float ay = 0.0;
+		std::vector<int16_t> alpha;
+		std::vector<float> vx;
+		std::vector<float> vy;
+		std::vector<float> ax;
+		std::vector<float> ay;
+		/** Scratch space of the updates: particle was inactive */
+		std::vector<uint8_t> idle;
+
+		int size() const;
+		void resize(int n);
 	};
 
-	const std::vector<Particle>& GetParticles();
+	const Particles& GetParticles();
 
 	enum WeatherType {
 		Weather_None,
@@ -185,7 +194,7 @@ private:
 	int movie_res_y;
 
 protected:
-	std::vector<Particle> particles;
+	Particles particles;
 
 	void StopWeather();
 	void UpdateRain();
@@ -248,10 +257,14 @@ inline int Game_Screen::GetWeatherStrength() {
 	return data.weather_strength;
 }
 
-inline const std::vector<Game_Screen::Particle>& Game_Screen::GetParticles() {
+inline const Game_Screen::Particles& Game_Screen::GetParticles() {
 	return particles;
 }
 
+inline int Game_Screen::Particles::size() const {
+	return static_cast<int>(t.size());
+}
+
 inline bool Game_Screen::IsBattleAnimationWaiting() {
 	return (bool)animation;
 }
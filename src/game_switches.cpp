@@ -18,13 +18,46 @@
 // Headers
 #include "game_switches.h"
 #include "output.h"
+#include <algorithm>
 #include <lcf/reader_util.h>
 #include <lcf/data.h>
 
 constexpr int Game_Switches::kMaxWarnings;
+constexpr int Game_Switches::word_bits;
 
 Game_Switches::Game_Switches() {
-	_switches.reserve(lcf::Data::switches.size());
+	const size_t num_words = (lcf::Data::switches.size() + word_bits - 1) / word_bits;
+	_words.reserve(num_words);
+	_logged.reserve(num_words);
+}
+
+void Game_Switches::SetData(const Switches_t& s) {
+	_words.clear();
+	_logged.clear();
+	Resize(static_cast<int>(s.size()));
+	for (size_t i = 0; i < s.size(); ++i) {
+		if (s[i]) {
+			_words[i / word_bits] |= Word(1) << (i % word_bits);
+		}
+	}
+	_changes.clear();
+	++_revision;
+}
+
+Game_Switches::Switches_t Game_Switches::GetData() const {
+	Switches_t s(_size);
+	for (int i = 0; i < _size; ++i) {
+		s[i] = (_words[i / word_bits] >> (i % word_bits)) & 1;
+	}
+	return s;
+}
+
+void Game_Switches::ClearChanges() {
+	for (int id: _changes) {
+		_logged[(id - 1) / word_bits] = 0;
+	}
+	_changes.clear();
+	++_revision;
 }
 
 void Game_Switches::WarnGet(int variable_id) const {
@@ -32,6 +65,57 @@ void Game_Switches::WarnGet(int variable_id) const {
 	--_warnings;
 }
 
+void Game_Switches::Resize(int size) {
+	_size = size;
+	_words.resize((size + word_bits - 1) / word_bits, 0);
+	_logged.resize(_words.size(), 0);
+}
+
+void Game_Switches::LogChanges(int word_idx, Word changed) {
+	Word added = changed & ~_logged[word_idx];
+	if (!added) {
+		return;
+	}
+	_logged[word_idx] |= added;
+	for (int bit = 0; added; ++bit, added >>= 1) {
+		if (added & 1) {
+			_changes.push_back(word_idx * word_bits + bit + 1);
+		}
+	}
+}
+
+template <typename F>
+void Game_Switches::ApplyRange(int first_id, int last_id, F&& op) {
+	if (last_id > _size) {
+		Resize(last_id);
+	}
+	const int first = std::max(0, first_id - 1);
+	const int last = last_id;
+	if (first >= last) {
+		return;
+	}
+
+	// Partial words at both ends are masked, the words between are replaced whole
+	const int first_word = first / word_bits;
+	const int last_word = (last - 1) / word_bits;
+	for (int w = first_word; w <= last_word; ++w) {
+		Word mask = ~Word(0);
+		if (w == first_word) {
+			mask &= ~Word(0) << (first % word_bits);
+		}
+		if (w == last_word && last % word_bits != 0) {
+			mask &= ~(~Word(0) << (last % word_bits));
+		}
+		const Word old = _words[w];
+		const Word value = (old & ~mask) | (op(old) & mask);
+		_words[w] = value;
+		if (old != value) {
+			LogChanges(w, old ^ value);
+			++_revision;
+		}
+	}
+}
+
 bool Game_Switches::Set(int switch_id, bool value) {
 	if (EP_UNLIKELY(ShouldWarn(switch_id, switch_id))) {
 		Output::Debug("Invalid write sw[{}] = {}!", switch_id, value);
@@ -40,11 +124,7 @@ bool Game_Switches::Set(int switch_id, bool value) {
 	if (switch_id <= 0) {
 		return false;
 	}
-	auto& ss = _switches;
-	if (switch_id > static_cast<int>(ss.size())) {
-		ss.resize(switch_id);
-	}
-	ss[switch_id - 1] = value;
+	ApplyRange(switch_id, switch_id, [value](Word) { return value ? ~Word(0) : Word(0); });
 	return value;
 }
 
@@ -53,13 +133,7 @@ void Game_Switches::SetRange(int first_id, int last_id, bool value) {
 		Output::Debug("Invalid write sw[{},{}] = {}!", first_id, last_id, value);
 		--_warnings;
 	}
-	auto& ss = _switches;
-	if (last_id > static_cast<int>(ss.size())) {
-		ss.resize(last_id, false);
-	}
-	for (int i = std::max(0, first_id - 1); i < last_id; ++i) {
-		ss[i] = value;
-	}
+	ApplyRange(first_id, last_id, [value](Word) { return value ? ~Word(0) : Word(0); });
 }
 
 bool Game_Switches::Flip(int switch_id) {
@@ -70,12 +144,9 @@ bool Game_Switches::Flip(int switch_id) {
 	if (switch_id <= 0) {
 		return false;
 	}
-	auto& ss = _switches;
-	if (switch_id > static_cast<int>(ss.size())) {
-		ss.resize(switch_id);
-	}
-	ss[switch_id - 1].flip();
-	return ss[switch_id - 1];
+	ApplyRange(switch_id, switch_id, [](Word w) { return ~w; });
+	const int idx = switch_id - 1;
+	return (_words[idx / word_bits] >> (idx % word_bits)) & 1;
 }
 
 void Game_Switches::FlipRange(int first_id, int last_id) {
@@ -83,13 +154,7 @@ void Game_Switches::FlipRange(int first_id, int last_id) {
 		Output::Debug("Invalid flip sw[{},{}]!", first_id, last_id);
 		--_warnings;
 	}
-	auto& ss = _switches;
-	if (last_id > static_cast<int>(ss.size())) {
-		ss.resize(last_id);
-	}
-	for (int i = std::max(0, first_id - 1); i < last_id; ++i) {
-		ss[i].flip();
-	}
+	ApplyRange(first_id, last_id, [](Word w) { return ~w; });
 }
 
 StringView Game_Switches::GetName(int _id) const {
@@ -19,6 +19,7 @@
 #define EP_GAME_SWITCHES_H
 
 // Headers
+#include <cstdint>
 #include <vector>
 #include <string>
 #include <lcf/data.h>
@@ -27,6 +28,8 @@
 
 /**
  * Game_Switches class
+ * The switches are packed into 64 bit words, range operations work on
+ * whole words.
  */
 class Game_Switches {
 public:
@@ -35,8 +38,8 @@ public:
 
 	Game_Switches();
 
-	void SetData(Switches_t s);
-	const Switches_t& GetData() const;
+	void SetData(const Switches_t& s);
+	Switches_t GetData() const;
 
 	bool Get(int switch_id) const;
 
@@ -54,24 +57,48 @@ public:
 
 	void SetWarning(int w);
 
+	/**
+	 * Switches whose value changed since the last ClearChanges.
+	 * Every id is contained once, in the order of the first change.
+	 * SetData does not log changes.
+	 *
+	 * @return changed switch ids
+	 */
+	const std::vector<int>& GetChanges() const;
+
+	/** Empties the change log */
+	void ClearChanges();
+
+	/**
+	 * Counter incremented whenever a switch value changes or SetData is
+	 * called. Allows caching state derived from the switches.
+	 *
+	 * @return revision of the switch values
+	 */
+	int GetRevision() const;
+
 private:
+	using Word = uint64_t;
+	static constexpr int word_bits = 64;
+
 	bool ShouldWarn(int first_id, int last_id) const;
 	void WarnGet(int variable_id) const;
 
+	void Resize(int size);
+	void LogChanges(int word_idx, Word changed);
+	template <typename F> void ApplyRange(int first_id, int last_id, F&& op);
+
 private:
-	Switches_t _switches;
+	std::vector<Word> _words;
+	/** Switches which are in the change log */
+	std::vector<Word> _logged;
+	std::vector<int> _changes;
+	int _size = 0;
+	int _revision = 0;
 	mutable int _warnings = kMaxWarnings;
 };
 
 
-inline void Game_Switches::SetData(Switches_t s) {
-	_switches = std::move(s);
-}
-
-inline const Game_Switches::Switches_t& Game_Switches::GetData() const {
-	return _switches;
-}
-
 inline int Game_Switches::GetSize() const {
 	return static_cast<int>(lcf::Data::switches.size());
 }
@@ -88,10 +115,19 @@ inline bool Game_Switches::Get(int switch_id) const {
 	if (EP_UNLIKELY(ShouldWarn(switch_id, switch_id))) {
 		WarnGet(switch_id);
 	}
-	if (switch_id <= 0 || switch_id > static_cast<int>(_switches.size())) {
+	if (switch_id <= 0 || switch_id > _size) {
 		return false;
 	}
-	return _switches[switch_id - 1];
+	const int idx = switch_id - 1;
+	return (_words[idx / word_bits] >> (idx % word_bits)) & 1;
+}
+
+inline const std::vector<int>& Game_Switches::GetChanges() const {
+	return _changes;
+}
+
+inline int Game_Switches::GetRevision() const {
+	return _revision;
 }
 
 inline void Game_Switches::SetWarning(int w) {
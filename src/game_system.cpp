@@ -27,6 +27,7 @@
 #include "cache.h"
 #include "output.h"
 #include "game_ineluki.h"
+#include "graphics.h"
 #include "transition.h"
 #include "main_data.h"
 #include "player.h"
@@ -118,6 +119,15 @@ void Game_System::BgmPlay(lcf::rpg::Music const& bgm) {
 	data.music_stopping = false;
 }
 
+void Game_System::BgmPrefetch(lcf::rpg::Music const& bgm) {
+	std::string path;
+	if (IsStopMusicFilename(bgm.name, path) || path.empty() || StringView(bgm.name).ends_with(".link")) {
+		return;
+	}
+
+	Audio().BGM_Prefetch(path);
+}
+
 void Game_System::BgmStop() {
 	music_request_id = FileRequestBinding();
 	data.current_music.name = "(OFF)";
@@ -188,6 +198,8 @@ StringView Game_System::GetSystemName() {
 void Game_System::OnChangeSystemGraphicReady(FileRequestResult* result) {
 	Cache::SetSystemName(result->file);
 	bg_color = Cache::SystemOrBlack()->GetBackgroundColor();
+	// The scene background is not tracked by any drawable
+	Graphics::InvalidateFrame();
 
 	Scene_Map* scene = (Scene_Map*)Scene::Find(Scene::Map).get();
 
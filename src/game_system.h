@@ -117,6 +117,13 @@ public:
 	 */
 	void BgmPlay(lcf::rpg::Music const& bgm);
 
+	/**
+	 * Opens a Music in the background, a later BgmPlay of it starts faster.
+	 *
+	 * @param bgm music data.
+	 */
+	void BgmPrefetch(lcf::rpg::Music const& bgm);
+
 	/**
 	 * Stops playing music.
 	 */
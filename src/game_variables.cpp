@@ -23,8 +23,17 @@
 #include <lcf/data.h>
 #include "utils.h"
 #include "rand.h"
+#include "cpu_features.h"
+#include <algorithm>
 #include <cmath>
 
+#if defined(EP_CPU_COMPILE_SSE2) || defined(EP_CPU_COMPILE_AVX2)
+#  include <immintrin.h>
+#endif
+#ifdef EP_CPU_COMPILE_NEON
+#  include <arm_neon.h>
+#endif
+
 constexpr int Game_Variables::max_warnings;
 constexpr Game_Variables::Var_t Game_Variables::min_2k;
 constexpr Game_Variables::Var_t Game_Variables::max_2k;
@@ -34,6 +43,9 @@ constexpr Game_Variables::Var_t Game_Variables::max_2k3;
 namespace {
 using Var_t = Game_Variables::Var_t;
 
+/** Variables per word of the change log bits */
+constexpr int word_bits = 64;
+
 constexpr Var_t VarSet(Var_t o, Var_t n) {
 	(void)o;
 	return n;
@@ -58,6 +70,209 @@ constexpr Var_t VarDiv(Var_t n, Var_t d) {
 constexpr Var_t VarMod(Var_t n, Var_t d) {
 	return EP_LIKELY(d != 0) ? n % d : 0;
 };
+
+/*
+ * Kernels applying an operation with a constant operand to a range of
+ * variables and clamping the results. Add and mult wrap around like the
+ * 32 bit arithmetic of RPG_RT before clamping, the vectorized variants
+ * produce identical results.
+ */
+using RangeFn = void (*)(Var_t* vars, int count, Var_t value, Var_t minval, Var_t maxval);
+
+inline Var_t WrapAdd(Var_t l, Var_t r) {
+	return static_cast<Var_t>(static_cast<uint32_t>(l) + static_cast<uint32_t>(r));
+}
+
+inline Var_t WrapMult(Var_t l, Var_t r) {
+	return static_cast<Var_t>(static_cast<uint32_t>(l) * static_cast<uint32_t>(r));
+}
+
+void SetRangeKernel(Var_t* vars, int count, Var_t value, Var_t minval, Var_t maxval) {
+	std::fill(vars, vars + count, Utils::Clamp(value, minval, maxval));
+}
+
+void AddRangeScalar(Var_t* vars, int count, Var_t value, Var_t minval, Var_t maxval) {
+	for (int i = 0; i < count; ++i) {
+		vars[i] = Utils::Clamp(WrapAdd(vars[i], value), minval, maxval);
+	}
+}
+
+void MultRangeScalar(Var_t* vars, int count, Var_t value, Var_t minval, Var_t maxval) {
+	for (int i = 0; i < count; ++i) {
+		vars[i] = Utils::Clamp(WrapMult(vars[i], value), minval, maxval);
+	}
+}
+
+// There is no vector integer division, the check for 0 is done once
+void DivRangeKernel(Var_t* vars, int count, Var_t value, Var_t minval, Var_t maxval) {
+	if (value == 0) {
+		for (int i = 0; i < count; ++i) {
+			vars[i] = Utils::Clamp(vars[i], minval, maxval);
+		}
+		return;
+	}
+	for (int i = 0; i < count; ++i) {
+		vars[i] = Utils::Clamp(vars[i] / value, minval, maxval);
+	}
+}
+
+void ModRangeKernel(Var_t* vars, int count, Var_t value, Var_t minval, Var_t maxval) {
+	if (value == 0) {
+		SetRangeKernel(vars, count, 0, minval, maxval);
+		return;
+	}
+	for (int i = 0; i < count; ++i) {
+		vars[i] = Utils::Clamp(vars[i] % value, minval, maxval);
+	}
+}
+
+#ifdef EP_CPU_COMPILE_SSE2
+inline __m128i clamp_epi32_sse2(__m128i v, __m128i lo, __m128i hi) {
+	const __m128i below = _mm_cmplt_epi32(v, lo);
+	v = _mm_or_si128(_mm_and_si128(below, lo), _mm_andnot_si128(below, v));
+	const __m128i above = _mm_cmpgt_epi32(v, hi);
+	return _mm_or_si128(_mm_and_si128(above, hi), _mm_andnot_si128(above, v));
+}
+
+// SSE2 has no 32 bit mullo, the even and odd lanes are multiplied separately
+inline __m128i mullo_epi32_sse2(__m128i a, __m128i b) {
+	const __m128i even = _mm_mul_epu32(a, b);
+	const __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+	return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+void AddRangeSSE2(Var_t* vars, int count, Var_t value, Var_t minval, Var_t maxval) {
+	const __m128i val = _mm_set1_epi32(value);
+	const __m128i lo = _mm_set1_epi32(minval);
+	const __m128i hi = _mm_set1_epi32(maxval);
+
+	int i = 0;
+	for (; i + 4 <= count; i += 4) {
+		auto* p = reinterpret_cast<__m128i*>(vars + i);
+		_mm_storeu_si128(p, clamp_epi32_sse2(_mm_add_epi32(_mm_loadu_si128(p), val), lo, hi));
+	}
+
+	AddRangeScalar(vars + i, count - i, value, minval, maxval);
+}
+
+void MultRangeSSE2(Var_t* vars, int count, Var_t value, Var_t minval, Var_t maxval) {
+	const __m128i val = _mm_set1_epi32(value);
+	const __m128i lo = _mm_set1_epi32(minval);
+	const __m128i hi = _mm_set1_epi32(maxval);
+
+	int i = 0;
+	for (; i + 4 <= count; i += 4) {
+		auto* p = reinterpret_cast<__m128i*>(vars + i);
+		_mm_storeu_si128(p, clamp_epi32_sse2(mullo_epi32_sse2(_mm_loadu_si128(p), val), lo, hi));
+	}
+
+	MultRangeScalar(vars + i, count - i, value, minval, maxval);
+}
+#endif
+
+#ifdef EP_CPU_COMPILE_AVX2
+EP_TARGET_AVX2 void AddRangeAVX2(Var_t* vars, int count, Var_t value, Var_t minval, Var_t maxval) {
+	const __m256i val = _mm256_set1_epi32(value);
+	const __m256i lo = _mm256_set1_epi32(minval);
+	const __m256i hi = _mm256_set1_epi32(maxval);
+
+	int i = 0;
+	for (; i + 8 <= count; i += 8) {
+		auto* p = reinterpret_cast<__m256i*>(vars + i);
+		const __m256i v = _mm256_add_epi32(_mm256_loadu_si256(p), val);
+		_mm256_storeu_si256(p, _mm256_min_epi32(_mm256_max_epi32(v, lo), hi));
+	}
+
+	AddRangeScalar(vars + i, count - i, value, minval, maxval);
+}
+
+EP_TARGET_AVX2 void MultRangeAVX2(Var_t* vars, int count, Var_t value, Var_t minval, Var_t maxval) {
+	const __m256i val = _mm256_set1_epi32(value);
+	const __m256i lo = _mm256_set1_epi32(minval);
+	const __m256i hi = _mm256_set1_epi32(maxval);
+
+	int i = 0;
+	for (; i + 8 <= count; i += 8) {
+		auto* p = reinterpret_cast<__m256i*>(vars + i);
+		const __m256i v = _mm256_mullo_epi32(_mm256_loadu_si256(p), val);
+		_mm256_storeu_si256(p, _mm256_min_epi32(_mm256_max_epi32(v, lo), hi));
+	}
+
+	MultRangeScalar(vars + i, count - i, value, minval, maxval);
+}
+#endif
+
+#ifdef EP_CPU_COMPILE_NEON
+void AddRangeNEON(Var_t* vars, int count, Var_t value, Var_t minval, Var_t maxval) {
+	const int32x4_t val = vdupq_n_s32(value);
+	const int32x4_t lo = vdupq_n_s32(minval);
+	const int32x4_t hi = vdupq_n_s32(maxval);
+
+	int i = 0;
+	for (; i + 4 <= count; i += 4) {
+		const int32x4_t v = vaddq_s32(vld1q_s32(vars + i), val);
+		vst1q_s32(vars + i, vminq_s32(vmaxq_s32(v, lo), hi));
+	}
+
+	AddRangeScalar(vars + i, count - i, value, minval, maxval);
+}
+
+void MultRangeNEON(Var_t* vars, int count, Var_t value, Var_t minval, Var_t maxval) {
+	const int32x4_t val = vdupq_n_s32(value);
+	const int32x4_t lo = vdupq_n_s32(minval);
+	const int32x4_t hi = vdupq_n_s32(maxval);
+
+	int i = 0;
+	for (; i + 4 <= count; i += 4) {
+		const int32x4_t v = vmulq_s32(vld1q_s32(vars + i), val);
+		vst1q_s32(vars + i, vminq_s32(vmaxq_s32(v, lo), hi));
+	}
+
+	MultRangeScalar(vars + i, count - i, value, minval, maxval);
+}
+#endif
+
+struct RangeKernels {
+	RangeFn add;
+	RangeFn mult;
+};
+
+RangeKernels SelectRangeKernels() {
+#ifdef EP_CPU_COMPILE_AVX2
+	if (CpuFeatures::HasAVX2()) {
+		return { AddRangeAVX2, MultRangeAVX2 };
+	}
+#endif
+#ifdef EP_CPU_COMPILE_SSE2
+	if (CpuFeatures::HasSSE2()) {
+		return { AddRangeSSE2, MultRangeSSE2 };
+	}
+#endif
+#ifdef EP_CPU_COMPILE_NEON
+	if (CpuFeatures::HasNEON()) {
+		return { AddRangeNEON, MultRangeNEON };
+	}
+#endif
+	return { AddRangeScalar, MultRangeScalar };
+}
+
+const RangeKernels& GetRangeKernels() {
+	static const RangeKernels kernels = SelectRangeKernels();
+	return kernels;
+}
+
+void AddRangeKernel(Var_t* vars, int count, Var_t value, Var_t minval, Var_t maxval) {
+	GetRangeKernels().add(vars, count, value, minval, maxval);
+}
+
+// Wrapping subtraction is the addition of the wrapped negation
+void SubRangeKernel(Var_t* vars, int count, Var_t value, Var_t minval, Var_t maxval) {
+	GetRangeKernels().add(vars, count, WrapMult(value, -1), minval, maxval);
+}
+
+void MultRangeKernel(Var_t* vars, int count, Var_t value, Var_t minval, Var_t maxval) {
+	GetRangeKernels().mult(vars, count, value, minval, maxval);
+}
 }
 
 Game_Variables::Game_Variables(Var_t minval, Var_t maxval)
@@ -86,6 +301,7 @@ Game_Variables::Var_t Game_Variables::SetOp(int variable_id, Var_t value, F&& op
 	auto& v = _variables[variable_id - 1];
 	value = op(v, value);
 	v = Utils::Clamp(value, _min, _max);
+	LogWrite(variable_id - 1, variable_id);
 	return v;
 }
 
@@ -108,6 +324,68 @@ void Game_Variables::WriteRange(const int first_id, const int last_id, V&& value
 		auto& v = vv[i];
 		v = Utils::Clamp(op(v, value()), _min, _max);
 	}
+	LogWrite(first_id - 1, last_id);
+}
+
+template <typename K>
+void Game_Variables::WriteRangeKernel(const int first_id, const int last_id, Var_t value, K&& kernel) {
+	const int first = std::max(0, first_id - 1);
+	if (first < last_id) {
+		kernel(_variables.data() + first, last_id - first, value, _min, _max);
+		LogWrite(first, last_id);
+	}
+}
+
+void Game_Variables::LogWrite(int first, int last) {
+	first = std::max(first, 0);
+	if (first >= last) {
+		return;
+	}
+	++_revision;
+	const size_t num_words = (last + word_bits - 1) / word_bits;
+	if (_logged.size() < num_words) {
+		_logged.resize(num_words, 0);
+	}
+
+	// Most writes hit logged variables, they only cost a word test
+	for (int w = first / word_bits; w <= (last - 1) / word_bits; ++w) {
+		const int begin = std::max(first, w * word_bits);
+		const int end = std::min(last, (w + 1) * word_bits);
+		uint64_t mask = ~uint64_t(0) << (begin % word_bits);
+		if (end % word_bits != 0) {
+			mask &= ~(~uint64_t(0) << (end % word_bits));
+		}
+		uint64_t added = mask & ~_logged[w];
+		if (!added) {
+			continue;
+		}
+		_logged[w] |= added;
+		for (int bit = 0; added; ++bit, added >>= 1) {
+			if (added & 1) {
+				_changes.push_back(w * word_bits + bit + 1);
+			}
+		}
+	}
+}
+
+void Game_Variables::ClearChanges() {
+	for (int id: _changes) {
+		_logged[(id - 1) / word_bits] = 0;
+	}
+	_changes.clear();
+}
+
+template <typename F>
+void Game_Variables::WriteRangeRandom(const int first_id, const int last_id, Var_t minval, Var_t maxval, F&& op) {
+	const int first = std::max(0, first_id - 1);
+	if (first >= last_id) {
+		return;
+	}
+	// Drawn in the order the variables are written
+	_random.resize(last_id - first);
+	Rand::GetRandomNumbers(MakeSpan(_random), minval, maxval);
+	auto it = _random.cbegin();
+	WriteRange(first_id, last_id, [&it](){ return *it++; }, std::forward<F>(op));
 }
 
 Game_Variables::Var_t Game_Variables::Set(int variable_id, Var_t value) {
@@ -136,74 +414,74 @@ Game_Variables::Var_t Game_Variables::Mod(int variable_id, Var_t value) {
 
 void Game_Variables::SetRange(int first_id, int last_id, Var_t value) {
 	PrepareRange(first_id, last_id, "Invalid write var[{},{}] = {}!", value);
-	WriteRange(first_id, last_id, [value](){ return value; }, VarSet);
+	WriteRangeKernel(first_id, last_id, value, SetRangeKernel);
 }
 
 void Game_Variables::AddRange(int first_id, int last_id, Var_t value) {
 	PrepareRange(first_id, last_id, "Invalid write var[{},{}] += {}!", value);
-	WriteRange(first_id, last_id, [value](){ return value; }, VarAdd);
+	WriteRangeKernel(first_id, last_id, value, AddRangeKernel);
 }
 
 void Game_Variables::SubRange(int first_id, int last_id, Var_t value) {
 	PrepareRange(first_id, last_id, "Invalid write var[{},{}] -= {}!", value);
-	WriteRange(first_id, last_id, [value](){ return value; }, VarSub);
+	WriteRangeKernel(first_id, last_id, value, SubRangeKernel);
 }
 
 void Game_Variables::MultRange(int first_id, int last_id, Var_t value) {
 	PrepareRange(first_id, last_id, "Invalid write var[{},{}] *= {}!", value);
-	WriteRange(first_id, last_id, [value](){ return value; }, VarMult);
+	WriteRangeKernel(first_id, last_id, value, MultRangeKernel);
 }
 
 void Game_Variables::DivRange(int first_id, int last_id, Var_t value) {
 	PrepareRange(first_id, last_id, "Invalid write var[{},{}] /= {}!", value);
-	WriteRange(first_id, last_id, [value](){ return value; }, VarDiv);
+	WriteRangeKernel(first_id, last_id, value, DivRangeKernel);
 }
 
 void Game_Variables::ModRange(int first_id, int last_id, Var_t value) {
 	PrepareRange(first_id, last_id, "Invalid write var[{},{}] %= {}!", value);
-	WriteRange(first_id, last_id, [value](){ return value; }, VarMod);
+	WriteRangeKernel(first_id, last_id, value, ModRangeKernel);
 }
 
-template <typename F>
-void Game_Variables::WriteRangeVariable(int first_id, const int last_id, const int var_id, F&& op) {
+template <typename K>
+void Game_Variables::WriteRangeVariable(int first_id, const int last_id, const int var_id, K&& kernel) {
 	if (var_id >= first_id && var_id <= last_id) {
 		auto value = Get(var_id);
-		WriteRange(first_id, var_id, [value](){ return value; }, std::forward<F>(op));
+		WriteRangeKernel(first_id, var_id, value, kernel);
 		first_id = var_id + 1;
 	}
 	auto value = Get(var_id);
-	WriteRange(first_id, last_id, [value](){ return value; }, std::forward<F>(op));
+	WriteRangeKernel(first_id, last_id, value, kernel);
 }
 
 
 void Game_Variables::SetRangeVariable(int first_id, int last_id, int var_id) {
 	PrepareRange(first_id, last_id, "Invalid write var[{},{}] = Var({})!", var_id);
-	WriteRangeVariable(first_id, last_id, var_id, VarSet);
+	WriteRangeVariable(first_id, last_id, var_id, SetRangeKernel);
 }
 
 void Game_Variables::AddRangeVariable(int first_id, int last_id, int var_id) {
 	PrepareRange(first_id, last_id, "Invalid write var[{},{}] += var[{}]!", var_id);
-	WriteRangeVariable(first_id, last_id, var_id, VarAdd);
+	WriteRangeVariable(first_id, last_id, var_id, AddRangeKernel);
 }
 
 void Game_Variables::SubRangeVariable(int first_id, int last_id, int var_id) {
 	PrepareRange(first_id, last_id, "Invalid write var[{},{}] -= var[{}]!", var_id);
-	WriteRangeVariable(first_id, last_id, var_id, VarSub);
+	WriteRangeVariable(first_id, last_id, var_id, SubRangeKernel);
 }
 
 void Game_Variables::MultRangeVariable(int first_id, int last_id, int var_id) {
 	PrepareRange(first_id, last_id, "Invalid write var[{},{}] *= var[{}]!", var_id);
-	WriteRangeVariable(first_id, last_id, var_id, VarMult);
+	WriteRangeVariable(first_id, last_id, var_id, MultRangeKernel);
 }
 
 void Game_Variables::DivRangeVariable(int first_id, int last_id, int var_id) {
 	PrepareRange(first_id, last_id, "Invalid write var[{},{}] /= var[{}]!", var_id);
-	WriteRangeVariable(first_id, last_id, var_id, VarDiv);
+	WriteRangeVariable(first_id, last_id, var_id, DivRangeKernel);
 }
 
 void Game_Variables::ModRangeVariable(int first_id, int last_id, int var_id) {
 	PrepareRange(first_id, last_id, "Invalid write var[{},{}] /= var[{}]!", var_id);
-	WriteRangeVariable(first_id, last_id, var_id, VarMod);
+	WriteRangeVariable(first_id, last_id, var_id, ModRangeKernel);
 }
 
 void Game_Variables::SetRangeVariableIndirect(int first_id, int last_id, int var_id) {
@@ -238,32 +516,32 @@ void Game_Variables::ModRangeVariableIndirect(int first_id, int last_id, int var
 
 void Game_Variables::SetRangeRandom(int first_id, int last_id, Var_t minval, Var_t maxval) {
 	PrepareRange(first_id, last_id, "Invalid write var[{},{}] = rand({},{})!", minval, maxval);
-	WriteRange(first_id, last_id, [this,minval,maxval](){ return Rand::GetRandomNumber(minval, maxval); }, VarSet);
+	WriteRangeRandom(first_id, last_id, minval, maxval, VarSet);
 }
 
 void Game_Variables::AddRangeRandom(int first_id, int last_id, Var_t minval, Var_t maxval) {
 	PrepareRange(first_id, last_id, "Invalid write var[{},{}] += rand({},{})!", minval, maxval);
-	WriteRange(first_id, last_id, [this,minval,maxval](){ return Rand::GetRandomNumber(minval, maxval); }, VarAdd);
+	WriteRangeRandom(first_id, last_id, minval, maxval, VarAdd);
 }
 
 void Game_Variables::SubRangeRandom(int first_id, int last_id, Var_t minval, Var_t maxval) {
 	PrepareRange(first_id, last_id, "Invalid write var[{},{}] -= rand({},{})!", minval, maxval);
-	WriteRange(first_id, last_id, [this,minval,maxval](){ return Rand::GetRandomNumber(minval, maxval); }, VarSub);
+	WriteRangeRandom(first_id, last_id, minval, maxval, VarSub);
 }
 
 void Game_Variables::MultRangeRandom(int first_id, int last_id, Var_t minval, Var_t maxval) {
 	PrepareRange(first_id, last_id, "Invalid write var[{},{}] *= rand({},{})!", minval, maxval);
-	WriteRange(first_id, last_id, [this,minval,maxval](){ return Rand::GetRandomNumber(minval, maxval); }, VarMult);
+	WriteRangeRandom(first_id, last_id, minval, maxval, VarMult);
 }
 
 void Game_Variables::DivRangeRandom(int first_id, int last_id, Var_t minval, Var_t maxval) {
 	PrepareRange(first_id, last_id, "Invalid write var[{},{}] /= rand({},{})!", minval, maxval);
-	WriteRange(first_id, last_id, [this,minval,maxval](){ return Rand::GetRandomNumber(minval, maxval); }, VarDiv);
+	WriteRangeRandom(first_id, last_id, minval, maxval, VarDiv);
 }
 
 void Game_Variables::ModRangeRandom(int first_id, int last_id, Var_t minval, Var_t maxval) {
 	PrepareRange(first_id, last_id, "Invalid write var[{},{}] %= rand({},{})!", minval, maxval);
-	WriteRange(first_id, last_id, [this,minval,maxval](){ return Rand::GetRandomNumber(minval, maxval); }, VarMod);
+	WriteRangeRandom(first_id, last_id, minval, maxval, VarMod);
 }
 
 StringView Game_Variables::GetName(int _id) const {
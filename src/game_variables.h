@@ -92,6 +92,26 @@ public:
 	Var_t GetMinValue() const;
 
 	int GetMaxDigits() const;
+
+	/**
+	 * Variables written since the last ClearChanges.
+	 * Every id is contained once, in the order of the first write.
+	 * SetData does not log changes.
+	 *
+	 * @return written variable ids
+	 */
+	const std::vector<int>& GetChanges() const;
+
+	/** Empties the change log */
+	void ClearChanges();
+
+	/**
+	 * Counter incremented whenever variables are written or SetData is
+	 * called. Allows caching state derived from the variables.
+	 *
+	 * @return revision of the variable values
+	 */
+	int GetRevision() const;
 private:
 	bool ShouldWarn(int first_id, int last_id) const;
 	void WarnGet(int variable_id) const;
@@ -101,10 +121,21 @@ private:
 		void PrepareRange(const int first_id, const int last_id, const char* warn, Args... args);
 	template <typename V, typename F>
 		void WriteRange(const int first_id, const int last_id, V&& value, F&& op);
+	template <typename K>
+		void WriteRangeKernel(const int first_id, const int last_id, Var_t value, K&& kernel);
+	template <typename K>
+		void WriteRangeVariable(const int first_id, const int last_id, int var_id, K&& kernel);
 	template <typename F>
-		void WriteRangeVariable(const int first_id, const int last_id, int var_id, F&& op);
+		void WriteRangeRandom(const int first_id, const int last_id, Var_t minval, Var_t maxval, F&& op);
+	void LogWrite(int first, int last);
 private:
 	Variables_t _variables;
+	/** Buffer for the random numbers of the RangeRandom operations */
+	Variables_t _random;
+	/** Variables which are in the change log, one bit per variable */
+	std::vector<uint64_t> _logged;
+	std::vector<int> _changes;
+	int _revision = 0;
 	Var_t _min = 0;
 	Var_t _max = 0;
 	mutable int _warnings = max_warnings;
@@ -112,6 +143,9 @@ private:
 
 inline void Game_Variables::SetData(Variables_t v) {
 	_variables = std::move(v);
+	_logged.clear();
+	_changes.clear();
+	++_revision;
 }
 
 inline const Game_Variables::Variables_t& Game_Variables::GetData() const {
@@ -140,6 +174,10 @@ inline Game_Variables::Var_t Game_Variables::Get(int variable_id) const {
 	return _variables[variable_id - 1];
 }
 
+inline const std::vector<int>& Game_Variables::GetChanges() const {
+	return _changes;
+}
+
 inline void Game_Variables::SetWarning(int w) {
 	_warnings = w;
 }
@@ -152,4 +190,8 @@ inline Game_Variables::Var_t Game_Variables::GetMinValue() const {
 	return _min;
 }
 
+inline int Game_Variables::GetRevision() const {
+	return _revision;
+}
+
 #endif
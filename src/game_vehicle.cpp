@@ -71,6 +71,8 @@ Game_Vehicle::Game_Vehicle(Type type)
 void Game_Vehicle::SetSaveData(lcf::rpg::SaveVehicleLocation save) {
 	auto type = data()->vehicle;
 	*data() = std::move(save);
+	ResetMoveRoutePrograms();
+	OnSpriteChanged();
 
 	// Old EasyRPG savegames pre 6.0 didn't write the vehicle chunk.
 	data()->vehicle = type;
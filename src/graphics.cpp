@@ -21,10 +21,12 @@
 #include <array>
 
 #include "graphics.h"
+#include "accelerated_renderer.h"
 #include "cache.h"
 #include "output.h"
 #include "player.h"
 #include "fps_overlay.h"
+#include "frame_stats.h"
 #include "message_overlay.h"
 #include "transition.h"
 #include "scene.h"
@@ -44,6 +46,19 @@ namespace Graphics {
 
 	std::unique_ptr<MessageOverlay> message_overlay;
 	std::unique_ptr<FpsOverlay> fps_overlay;
+
+	/** Surface and size the previous frame was composited to */
+	const Bitmap* last_frame_surface = nullptr;
+	Rect last_frame_rect;
+	/** Revisions of the surface before and after the previous frame */
+	uint32_t last_frame_revision_before = 0;
+	uint32_t last_frame_revision_after = 0;
+	Rect frame_damage;
+	bool frame_invalid = true;
+	/** Whether the previous frame was drawn by the AcceleratedRenderer */
+	bool frame_accelerated = false;
+
+	int draw_threads = 1;
 }
 
 unsigned SecondToFrame(float const second) {
@@ -97,16 +112,106 @@ void Graphics::UpdateTitle() {
 
 void Graphics::Draw(Bitmap& dst) {
 	auto& transition = Transition::instance();
+	auto& drawable_list = DrawableMgr::GetLocalList();
+	const Rect screen_rect = dst.GetRect();
 
 	int min_z = std::numeric_limits<int>::min();
 	int max_z = std::numeric_limits<int>::max();
+	bool full_redraw = frame_invalid || &dst != last_frame_surface || screen_rect != last_frame_rect;
+	frame_invalid = false;
+
 	if (transition.IsActive()) {
 		min_z = transition.GetZ();
+		full_redraw = true;
+		// The frame after the transition must redraw what was covered by the transition
+		frame_invalid = true;
 	} else if (transition.IsErasedNotActive()) {
 		min_z = transition.GetZ() + 1;
 		dst.Clear();
+		full_redraw = true;
+		frame_invalid = true;
+	}
+
+	auto* renderer = DisplayUi ? DisplayUi->GetAcceleratedRenderer() : nullptr;
+	if (renderer && !transition.IsActive() && !transition.IsErasedNotActive()) {
+		renderer->BeginFrame();
+		if (!drawable_list.empty()) {
+			current_scene->DrawBackground(renderer->GetLayer());
+		}
+		drawable_list.DrawAccelerated(*renderer, min_z, max_z);
+		renderer->EndFrame();
+		drawable_list.OnComposited(min_z, max_z);
+
+		// dst was not touched, the next software frame redraws everything
+		frame_damage = Rect();
+		frame_invalid = true;
+		frame_accelerated = true;
+		return;
+	}
+	frame_accelerated = false;
+	last_frame_revision_before = dst.GetRevision();
+
+	frame_damage = full_redraw ? screen_rect : drawable_list.GetDamage(screen_rect, min_z, max_z);
+
+	if (frame_damage == screen_rect) {
+		LocalDraw(dst, min_z, max_z);
+	} else if (!frame_damage.IsEmpty()) {
+		dst.SetClipRect(frame_damage);
+		LocalDraw(dst, min_z, max_z);
+		dst.ClearClipRect();
+	}
+
+	drawable_list.OnComposited(min_z, max_z);
+	last_frame_surface = &dst;
+	last_frame_rect = screen_rect;
+	last_frame_revision_after = dst.GetRevision();
+}
+
+BitmapRef Graphics::CaptureScreen() {
+	if (!frame_accelerated) {
+		return DisplayUi->CaptureScreen();
+	}
+
+	// The display surface is outdated, draw the frame in software
+	auto screen = Bitmap::Create(DisplayUi->GetWidth(), DisplayUi->GetHeight(), Color(0, 0, 0, 255));
+	LocalDraw(*screen, std::numeric_limits<int>::min(), std::numeric_limits<int>::max());
+	return screen;
+}
+
+Rect Graphics::GetFrameDamage() {
+	return frame_damage;
+}
+
+Rect Graphics::GetSurfaceDamage(const Bitmap& surface, uint32_t revision) {
+	if (surface.GetRevision() == revision) {
+		return Rect();
+	}
+
+	if (&surface == last_frame_surface &&
+			revision == last_frame_revision_before &&
+			surface.GetRevision() == last_frame_revision_after) {
+		return frame_damage;
 	}
-	LocalDraw(dst, min_z, max_z);
+
+	// Modified outside of Draw
+	return surface.GetRect();
+}
+
+void Graphics::InvalidateFrame() {
+	frame_invalid = true;
+}
+
+void Graphics::SetDrawThreads(int threads) {
+	draw_threads = threads;
+}
+
+int Graphics::GetDrawThreads() {
+	return draw_threads;
+}
+
+void Graphics::SetShowFrameStats(bool show) {
+	FrameStats::SetEnabled(show);
+	fps_overlay->SetDrawFrameStats(show);
 }
 
 void Graphics::LocalDraw(Bitmap& dst, int min_z, int max_z) {
@@ -116,7 +221,11 @@ void Graphics::LocalDraw(Bitmap& dst, int min_z, int max_z) {
 		current_scene->DrawBackground(dst);
 	}
 
-	drawable_list.Draw(dst, min_z, max_z);
+	if (draw_threads > 1) {
+		drawable_list.DrawBanded(dst, min_z, max_z, draw_threads);
+	} else {
+		drawable_list.Draw(dst, min_z, max_z);
+	}
 }
 
 std::shared_ptr<Scene> Graphics::UpdateSceneCallback() {
@@ -131,6 +240,7 @@ std::shared_ptr<Scene> Graphics::UpdateSceneCallback() {
 	} else {
 		DrawableMgr::SetLocalList(nullptr);
 	}
+	InvalidateFrame();
 
 	return prev_scene;
 }
@@ -48,8 +48,67 @@ namespace Graphics {
 	 */
 	void Update();
 
+	/**
+	 * Composites the current scene onto dst.
+	 * dst is expected to keep the previous frame, only the areas
+	 * changed by the drawables are redrawn.
+	 *
+	 * @param dst the screen surface
+	 */
 	void Draw(Bitmap& dst);
 
+	/**
+	 * Gets a copy of the last frame.
+	 * Unlike BaseUi::CaptureScreen this also works when the frame was
+	 * drawn by the AcceleratedRenderer.
+	 *
+	 * @return bitmap a copy of the screen.
+	 */
+	BitmapRef CaptureScreen();
+
+	/**
+	 * Returns the area of the screen which was redrawn by the last Draw call.
+	 *
+	 * @return redrawn area, an empty rect when the screen did not change
+	 */
+	Rect GetFrameDamage();
+
+	/**
+	 * Returns the area of a surface which changed since it had the passed
+	 * revision. This is exact when the only change was the last Draw call.
+	 *
+	 * @param surface the screen surface
+	 * @param revision revision of the surface contents known by the caller
+	 * @return changed area, the whole surface when the changes are unknown
+	 */
+	Rect GetSurfaceDamage(const Bitmap& surface, uint32_t revision);
+
+	/**
+	 * Forces the next Draw call to redraw the whole screen.
+	 */
+	void InvalidateFrame();
+
+	/**
+	 * Sets the number of threads compositing the screen.
+	 * Each thread draws a horizontal band of the screen.
+	 *
+	 * @param threads number of threads, 1 or less composites on the main thread only
+	 */
+	void SetDrawThreads(int threads);
+
+	/**
+	 * @return number of threads compositing the screen, also used by
+	 *   software scaling frontends for Bitmap::ScaleBlit
+	 */
+	int GetDrawThreads();
+
+	/**
+	 * Shows the time spent in each part of a frame below the FPS counter.
+	 *
+	 * @param show whether to measure and show the times
+	 */
+	void SetShowFrameStats(bool show);
+
 	void LocalDraw(Bitmap& dst, int min_z, int max_z);
 
 	std::shared_ptr<Scene> UpdateSceneCallback();
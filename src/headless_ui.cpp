@@ -0,0 +1,96 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include "headless_ui.h"
+#include "audio.h"
+#include "bitmap.h"
+#include "filefinder.h"
+#include "output.h"
+#include "pixel_format.h"
+#include "player.h"
+#include <zlib.h>
+
+HeadlessUi::HeadlessUi(long width, long height, const Game_ConfigVideo& cfg) : BaseUi(cfg)
+{
+	current_display_mode.width = width;
+	current_display_mode.height = height;
+	current_display_mode.bpp = 32;
+
+	Bitmap::SetFormat(Bitmap::ChooseFormat(format_R8G8B8A8_n().format()));
+	main_surface = Bitmap::Create(width, height, Color(0, 0, 0, 255));
+
+	// Nothing is presented, frames run as fast as possible
+	SetFrameRateSynchronized(true);
+
+#ifdef SUPPORT_AUDIO
+	audio_.reset(new EmptyAudio());
+#endif
+}
+
+HeadlessUi::~HeadlessUi() {
+}
+
+void HeadlessUi::ToggleFullscreen() {
+}
+
+void HeadlessUi::ToggleZoom() {
+}
+
+void HeadlessUi::UpdateDisplay() {
+}
+
+void HeadlessUi::SetTitle(const std::string&) {
+}
+
+bool HeadlessUi::ShowCursor(bool flag) {
+	bool temp_flag = cursor_visible;
+	cursor_visible = flag;
+	return temp_flag;
+}
+
+void HeadlessUi::ProcessEvents() {
+	// All input comes from Input::Source, e.g. a replayed log
+}
+
+#ifdef SUPPORT_AUDIO
+AudioInterface& HeadlessUi::GetAudio() {
+	return *audio_;
+}
+#endif
+
+uint32_t HeadlessUi::GetChecksum() const {
+	const auto& surface = *main_surface;
+	const auto row_bytes = static_cast<uInt>(surface.width() * surface.bpp());
+	uLong crc = crc32(0L, Z_NULL, 0);
+	for (int y = 0; y < surface.height(); ++y) {
+		const auto* row = static_cast<const Bytef*>(surface.pixels()) + y * surface.pitch();
+		crc = crc32(crc, row, row_bytes);
+	}
+	return static_cast<uint32_t>(crc);
+}
+
+bool HeadlessUi::WriteResult(const std::string& path) const {
+	Output::Info("Headless: frame {} checksum {:08X}", Player::GetFrames(), GetChecksum());
+
+	auto os = FileFinder::OpenOutputStream(path, std::ios_base::binary | std::ios_base::out | std::ios_base::trunc);
+	if (!os) {
+		Output::Warning("Headless: Could not write {}", path);
+		return false;
+	}
+	return main_surface->WritePNG(os);
+}
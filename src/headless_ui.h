@@ -0,0 +1,87 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_HEADLESS_UI_H
+#define EP_HEADLESS_UI_H
+
+// Headers
+#include <cstdint>
+#include <memory>
+#include <string>
+#include "baseui.h"
+
+struct AudioInterface;
+
+/**
+ * HeadlessUi class.
+ * Display without a window for automated runs: nothing is shown, audio is
+ * muted and the frame rate is not limited.
+ */
+class HeadlessUi : public BaseUi {
+public:
+	/**
+	 * Constructor.
+	 *
+	 * @param width display width.
+	 * @param height display height.
+	 * @param cfg video config options
+	 */
+	HeadlessUi(long width, long height, const Game_ConfigVideo& cfg);
+
+	/**
+	 * Destructor.
+	 */
+	~HeadlessUi() override;
+
+	/**
+	 * Inherited from BaseUi.
+	 */
+	/** @{ */
+
+	void ToggleFullscreen() override;
+	void ToggleZoom() override;
+	void UpdateDisplay() override;
+	void SetTitle(const std::string &title) override;
+	bool ShowCursor(bool flag) override;
+	void ProcessEvents() override;
+
+#ifdef SUPPORT_AUDIO
+	AudioInterface& GetAudio() override;
+#endif
+
+	/** @} */
+
+	/**
+	 * @return CRC32 of the pixels of the display surface, independent of the pitch
+	 */
+	uint32_t GetChecksum() const;
+
+	/**
+	 * Saves the display surface as PNG and logs its checksum.
+	 *
+	 * @param path file to write
+	 * @return whether the file was written
+	 */
+	bool WriteResult(const std::string& path) const;
+
+private:
+#ifdef SUPPORT_AUDIO
+	std::unique_ptr<AudioInterface> audio_;
+#endif
+};
+
+#endif
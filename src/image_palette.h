@@ -0,0 +1,109 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_IMAGE_PALETTE_H
+#define EP_IMAGE_PALETTE_H
+
+// Headers
+#include <cstdint>
+#include "pixel_format.h"
+
+/**
+ * Expansion of palette indices straight into the pixels of a bitmap.
+ * The palette is converted to the premultiplied 32 bit target format once,
+ * every pixel is then a single table lookup without conversion pass.
+ */
+namespace ImagePalette {
+
+/** Output format requested from the image decoders */
+struct Target {
+	/** Premultiplied 32 bit format, nullptr decodes to RGBA */
+	const DynamicFormat* format = nullptr;
+	/** Set by the decoder when the pixels are in format */
+	bool converted = false;
+	/** Keep the indices of paletted images, takes precedence over format */
+	bool indices = false;
+	/** Set by the decoder when the pixels are indices, see GetIndexPitch */
+	bool has_indices = false;
+	/** Colors of the indices, premultiplied RGBA as decoded without format */
+	uint32_t palette[256];
+
+	/** @return whether paletted images can be expanded into format */
+	bool IsDirect() const;
+};
+
+/**
+ * @param width image width
+ * @return bytes per row of an index image, 32 bit aligned as required by pixman
+ */
+int GetIndexPitch(int width);
+
+/**
+ * Converts a palette to the target format.
+ *
+ * @param format 32 bit target format
+ * @param colors RGB triplets
+ * @param stride distance between the triplets in bytes
+ * @param count number of colors, missing ones are black
+ * @param transparent whether index 0 is transparent
+ * @param out the 256 entry palette
+ */
+void Build(const DynamicFormat& format, const uint8_t* colors, int stride, int count, bool transparent, uint32_t* out);
+
+/**
+ * Expands a row of indices.
+ * The indices may be stored in the last quarter of the output row.
+ *
+ * @param dst output pixels
+ * @param indices palette indices
+ * @param count number of pixels
+ * @param palette palette built by Build
+ */
+void ExpandRow(uint32_t* dst, const uint8_t* indices, int count, const uint32_t* palette);
+
+inline int GetIndexPitch(int width) {
+	return (width + 3) & ~3;
+}
+
+inline bool Target::IsDirect() const {
+	return format != nullptr && format->bits == 32;
+}
+
+inline void Build(const DynamicFormat& format, const uint8_t* colors, int stride, int count, bool transparent, uint32_t* out) {
+	for (int i = 0; i < 256; ++i) {
+		if (i >= count) {
+			out[i] = format.rgba_to_uint32_t(0, 0, 0, 255);
+		} else if (transparent && i == 0) {
+			out[i] = format.rgba_to_uint32_t(0, 0, 0, 0);
+		} else {
+			const uint8_t* color = colors + i * stride;
+			out[i] = format.rgba_to_uint32_t(color[0], color[1], color[2], 255);
+		}
+	}
+}
+
+inline void ExpandRow(uint32_t* dst, const uint8_t* indices, int count, const uint32_t* palette) {
+	// Forwards: pixel x is written after index x was read, also when the
+	// indices are stored in the same row
+	for (int x = 0; x < count; ++x) {
+		dst[x] = palette[indices[x]];
+	}
+}
+
+}
+
+#endif
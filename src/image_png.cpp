@@ -17,6 +17,9 @@
 
 // Headers
 #include <png.h>
+#ifdef HAVE_SPNG
+#  include <spng.h>
+#endif
 #include <cstdlib>
 #include <cstring>
 #include <csetjmp>
@@ -24,6 +27,7 @@
 
 #include "output.h"
 #include "image_png.h"
+#include "utils.h"
 
 static void read_data(png_structp png_ptr, png_bytep data, png_size_t length) {
     png_bytep* bufp = (png_bytep*) png_get_io_ptr(png_ptr);
@@ -31,12 +35,31 @@ static void read_data(png_structp png_ptr, png_bytep data, png_size_t length) {
 	*bufp += length;
 }
 
+namespace {
+	struct MemoryReader {
+		png_const_bytep data;
+		size_t size;
+	};
+}
+
+static void read_data_bounded(png_structp png_ptr, png_bytep data, png_size_t length) {
+	auto* reader = reinterpret_cast<MemoryReader*>(png_get_io_ptr(png_ptr));
+	if (length > reader->size) {
+		png_error(png_ptr, "Unexpected end of data");
+	}
+	memcpy(data, reader->data, length);
+	reader->data += length;
+	reader->size -= length;
+}
+
+#ifndef HAVE_SPNG
 static void read_data_istream(png_structp png_ptr, png_bytep data, png_size_t length) {
 	auto* bufp = reinterpret_cast<Filesystem_Stream::InputStream*>(png_get_io_ptr(png_ptr));
 	if (bufp != nullptr && *bufp) {
 		bufp->read(reinterpret_cast<char*>(data), length);
 	}
 }
+#endif
 
 static void on_png_warning(png_structp, png_const_charp warn_msg) {
 	Output::Debug("libpng: {}", warn_msg);
@@ -46,25 +69,44 @@ static void on_png_error(png_structp, png_const_charp error_msg) {
 	Output::Warning("libpng: {}", error_msg);
 }
 
-static bool ReadPNGWithReadFunction(png_voidp,png_rw_ptr, bool, int&, int&, void*&);
-static void ReadPalettedData(png_struct*, png_info*, png_uint_32, png_uint_32, bool, uint32_t*);
+static bool ReadPNGWithReadFunction(png_voidp,png_rw_ptr, bool, int&, int&, void*&, ImagePalette::Target*);
+static void ReadPalettedData(png_struct*, png_info*, png_uint_32, png_uint_32, bool, uint32_t*, ImagePalette::Target*);
 static void ReadGrayData(png_struct*, png_info*, png_uint_32, png_uint_32, bool, uint32_t*);
 static void ReadGrayAlphaData(png_struct*, png_info*, png_uint_32, png_uint_32, uint32_t*);
 static void ReadRGBData(png_struct*, png_info*, png_uint_32, png_uint_32, uint32_t*);
 static void ReadRGBAData(png_struct*, png_info*, png_uint_32, png_uint_32, uint32_t*);
+#ifdef HAVE_SPNG
+static bool ReadPNGWithSpng(const void*, size_t, bool, int&, int&, void*&, ImagePalette::Target*);
+#endif
 
 bool ImagePNG::ReadPNG(const void* buffer, bool transparent,
-	int& width, int& height, void*& pixels) {
-	return ReadPNGWithReadFunction((png_voidp)&buffer, read_data, transparent, width, height, pixels);
+	int& width, int& height, void*& pixels, ImagePalette::Target* target) {
+	return ReadPNGWithReadFunction((png_voidp)&buffer, read_data, transparent, width, height, pixels, target);
+}
+
+bool ImagePNG::ReadPNG(const void* buffer, size_t size, bool transparent,
+	int& width, int& height, void*& pixels, ImagePalette::Target* target) {
+#ifdef HAVE_SPNG
+	return ReadPNGWithSpng(buffer, size, transparent, width, height, pixels, target);
+#else
+	MemoryReader reader = { static_cast<png_const_bytep>(buffer), size };
+	return ReadPNGWithReadFunction(&reader, read_data_bounded, transparent, width, height, pixels, target);
+#endif
 }
 
 bool ImagePNG::ReadPNG(Filesystem_Stream::InputStream& stream, bool transparent,
-	int& width, int& height, void*& pixels) {
-	return ReadPNGWithReadFunction(&stream, read_data_istream, transparent, width, height, pixels);
+	int& width, int& height, void*& pixels, ImagePalette::Target* target) {
+#ifdef HAVE_SPNG
+	// libspng decodes from memory only, the files are small enough
+	auto data = Utils::ReadStream(stream);
+	return ReadPNGWithSpng(data.data(), data.size(), transparent, width, height, pixels, target);
+#else
+	return ReadPNGWithReadFunction(&stream, read_data_istream, transparent, width, height, pixels, target);
+#endif
 }
 
 static bool ReadPNGWithReadFunction(png_voidp user_data, png_rw_ptr fn, bool transparent,
-					   int& width, int& height, void*& pixels) {
+					   int& width, int& height, void*& pixels, ImagePalette::Target* target) {
 	pixels = nullptr;
 
 	png_struct *png_ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING, NULL, on_png_error, on_png_warning);
@@ -101,7 +143,7 @@ static bool ReadPNGWithReadFunction(png_voidp user_data, png_rw_ptr fn, bool tra
 
 	switch (color_type) {
 		case PNG_COLOR_TYPE_PALETTE:
-			ReadPalettedData(png_ptr, info_ptr, w, h, transparent, (uint32_t*)pixels);
+			ReadPalettedData(png_ptr, info_ptr, w, h, transparent, (uint32_t*)pixels, target);
 			break;
 		case PNG_COLOR_TYPE_GRAY:
 			ReadGrayData(png_ptr, info_ptr, w, h, transparent, (uint32_t*)pixels);
@@ -120,6 +162,13 @@ static bool ReadPNGWithReadFunction(png_voidp user_data, png_rw_ptr fn, bool tra
 	png_read_end(png_ptr, NULL);
 	png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
 
+	if (target && target->has_indices && w > 0 && h > 0) {
+		// Give back the part of the buffer needed for 32 bit pixels
+		if (void* indices = realloc(pixels, ImagePalette::GetIndexPitch(w) * h)) {
+			pixels = indices;
+		}
+	}
+
 	width = w;
 	height = h;
 	return true;
@@ -129,11 +178,12 @@ static void ReadPalettedData(
 	png_struct* png_ptr, png_info* info_ptr,
 	png_uint_32 w, png_uint_32 h,
 	bool transparent,
-	uint32_t* pixels
+	uint32_t* pixels,
+	ImagePalette::Target* target
 ) {
 	// For transparent images, all the colors are opaque, except the
 	// color with index 0. So we'll need to do index->RGB conversion
-	// on our own.
+	// on our own, with the palette converted once to the output format.
 	png_set_packing(png_ptr);
 	png_read_update_info(png_ptr, info_ptr);
 
@@ -142,30 +192,45 @@ static void ReadPalettedData(
 		return;
 	}
 
-	png_colorp palette;
+	png_colorp colors;
 	int num_palette;
-	png_get_PLTE(png_ptr, info_ptr, &palette, &num_palette);
+	png_get_PLTE(png_ptr, info_ptr, &colors, &num_palette);
+
+	if (target && target->indices) {
+		ImagePalette::Build(format_R8G8B8A8_a().format(), &colors[0].red, sizeof(png_color), num_palette, transparent, target->palette);
+
+		// The rows of the pixel buffer are large enough for the pitch
+		const int pitch = ImagePalette::GetIndexPitch(w);
+		for (png_uint_32 y = 0; y < h; y++) {
+			png_read_row(png_ptr, (png_bytep)pixels + y * pitch, NULL);
+		}
+
+		target->has_indices = true;
+		return;
+	}
+
+	uint32_t palette[256];
+	const bool direct = target && target->IsDirect();
+	const auto rgba = format_R8G8B8A8_a().format();
+	ImagePalette::Build(direct ? *target->format : rgba, &colors[0].red, sizeof(png_color), num_palette, transparent, palette);
 
 	for (png_uint_32 y = 0; y < h; y++) {
 		// We read the indices (w bytes) into the end of the pixel
 		// data for this row (4w bytes), then scan over them
-		// converting them into RGBA values. Putting them at the end
+		// converting them into pixels. Putting them at the end
 		// gives us enough room that we don't overwrite an index
-		// we'll need later with an RGBA value.
+		// we'll need later with a pixel.
 
 		uint32_t* beginning_of_row = pixels + y * w;
 
 		uint8_t* indices = (uint8_t*)beginning_of_row + w * 3;
 		png_read_row(png_ptr, (png_bytep)indices, NULL);
 
-		uint32_t* dst = beginning_of_row;
-		for (png_uint_32 x = 0; x < w; x++, dst++) {
-			uint8_t idx = indices[x];
-			png_color& color = palette[idx];
-			uint8_t alpha = (idx == 0 && transparent) ? 0 : 255;
-			uint8_t rgba[4] = { color.red, color.green, color.blue, alpha };
-			*dst = *(uint32_t*)rgba;
-		}
+		ImagePalette::ExpandRow(beginning_of_row, indices, w, palette);
+	}
+
+	if (target) {
+		target->converted = direct;
 	}
 }
 
@@ -243,6 +308,176 @@ static void ReadRGBAData(
 	}
 }
 
+#ifdef HAVE_SPNG
+namespace {
+	struct SpngContext {
+		spng_ctx* ctx = spng_ctx_new(0);
+		~SpngContext() {
+			spng_ctx_free(ctx);
+		}
+	};
+
+	/** Unpacks indices of less than 8 bit from a PNG row */
+	void UnpackIndices(uint8_t* dst, const uint8_t* src, uint32_t count, int bit_depth) {
+		const int per_byte = 8 / bit_depth;
+		const int mask = (1 << bit_depth) - 1;
+		for (uint32_t x = 0; x < count; ++x) {
+			const int shift = 8 - bit_depth * (x % per_byte + 1);
+			dst[x] = (src[x / per_byte] >> shift) & mask;
+		}
+	}
+}
+
+static bool SpngCheck(int ret) {
+	if (ret != 0 && ret != SPNG_EOI) {
+		Output::Warning("libspng: {}", spng_strerror(ret));
+		return false;
+	}
+	return true;
+}
+
+static bool ReadSpngPalettedData(
+	spng_ctx* ctx, const spng_ihdr& ihdr,
+	bool transparent,
+	void* pixels,
+	ImagePalette::Target* target
+) {
+	spng_plte plte;
+	if (spng_get_plte(ctx, &plte) != 0) {
+		Output::Warning("Palette PNG without PLTE block");
+		return false;
+	}
+
+	size_t image_size;
+	if (!SpngCheck(spng_decoded_image_size(ctx, SPNG_FMT_PNG, &image_size)) ||
+		!SpngCheck(spng_decode_image(ctx, nullptr, 0, SPNG_FMT_PNG, SPNG_DECODE_PROGRESSIVE))) {
+		return false;
+	}
+
+	const uint32_t w = ihdr.width;
+	const uint32_t h = ihdr.height;
+	const size_t row_size = image_size / h;
+	std::vector<uint8_t> packed(ihdr.bit_depth < 8 ? row_size : 0);
+
+	// Same layout as ReadPalettedData: indices at their pitch or at
+	// the end of each row, expanded in place to pixels
+	const bool indices = target && target->indices;
+	const bool direct = target && target->IsDirect();
+	uint32_t palette[256];
+	if (indices) {
+		ImagePalette::Build(format_R8G8B8A8_a().format(), &plte.entries[0].red, sizeof(spng_plte_entry), plte.n_entries, transparent, target->palette);
+	} else {
+		ImagePalette::Build(direct ? *target->format : format_R8G8B8A8_a().format(), &plte.entries[0].red, sizeof(spng_plte_entry), plte.n_entries, transparent, palette);
+	}
+	const int pitch = ImagePalette::GetIndexPitch(w);
+
+	for (uint32_t y = 0; y < h; ++y) {
+		uint32_t* beginning_of_row = static_cast<uint32_t*>(pixels) + y * w;
+		uint8_t* row = indices ? static_cast<uint8_t*>(pixels) + y * pitch : reinterpret_cast<uint8_t*>(beginning_of_row) + w * 3;
+
+		if (!SpngCheck(spng_decode_row(ctx, packed.empty() ? row : packed.data(), row_size))) {
+			return false;
+		}
+		if (!packed.empty()) {
+			UnpackIndices(row, packed.data(), w, ihdr.bit_depth);
+		}
+		if (!indices) {
+			ImagePalette::ExpandRow(beginning_of_row, row, w, palette);
+		}
+	}
+
+	if (target) {
+		target->has_indices = indices;
+		target->converted = direct && !indices;
+	}
+	return true;
+}
+
+static bool ReadSpngData(
+	spng_ctx* ctx, const spng_ihdr& ihdr,
+	bool transparent,
+	uint32_t* pixels
+) {
+	// libpng applies tRNS to gray only, RGB images stay opaque
+	const bool gray = ihdr.color_type == SPNG_COLOR_TYPE_GRAYSCALE;
+	const int flags = SPNG_DECODE_PROGRESSIVE | (gray ? SPNG_DECODE_TRNS : 0);
+	if (!SpngCheck(spng_decode_image(ctx, nullptr, 0, SPNG_FMT_RGBA8, flags))) {
+		return false;
+	}
+
+	const uint32_t w = ihdr.width;
+	const uint32_t h = ihdr.height;
+	for (uint32_t y = 0; y < h; ++y) {
+		if (!SpngCheck(spng_decode_row(ctx, pixels + y * w, w * 4))) {
+			return false;
+		}
+	}
+
+	// Black pixels are transparent
+	if (gray && transparent) {
+		uint8_t ck1[4] = {0, 0, 0, 255};
+		uint8_t ck2[4] = {0, 0, 0,   0};
+		uint32_t srckey = *(uint32_t*)ck1;
+		uint32_t dstkey = *(uint32_t*)ck2;
+		uint32_t* p = pixels;
+		for (unsigned i = 0; i < w * h; i++, p++)
+			if (*p == srckey)
+				*p = dstkey;
+	}
+	return true;
+}
+
+static bool ReadPNGWithSpng(const void* buffer, size_t size, bool transparent,
+	int& width, int& height, void*& pixels, ImagePalette::Target* target) {
+	pixels = nullptr;
+
+	SpngContext spng;
+	if (!spng.ctx) {
+		Output::Warning("Couldn't allocate PNG structure");
+		return false;
+	}
+
+	spng_ihdr ihdr;
+	if (!SpngCheck(spng_set_png_buffer(spng.ctx, buffer, size)) ||
+		!SpngCheck(spng_get_ihdr(spng.ctx, &ihdr))) {
+		return false;
+	}
+
+	if (ihdr.interlace_method != SPNG_INTERLACE_NONE) {
+		// Rare in game assets, libpng handles them
+		MemoryReader reader = { static_cast<png_const_bytep>(buffer), size };
+		return ReadPNGWithReadFunction(&reader, read_data_bounded, transparent, width, height, pixels, target);
+	}
+
+	const uint32_t w = ihdr.width;
+	const uint32_t h = ihdr.height;
+
+	pixels = malloc(w * h * 4);
+	if (!pixels) {
+		Output::Warning("Error allocating PNG pixel buffer.");
+		return false;
+	}
+
+	const bool ok = ihdr.color_type == SPNG_COLOR_TYPE_INDEXED ?
+		ReadSpngPalettedData(spng.ctx, ihdr, transparent, pixels, target) :
+		ReadSpngData(spng.ctx, ihdr, transparent, static_cast<uint32_t*>(pixels));
+	if (!ok) {
+		return false;
+	}
+
+	if (target && target->has_indices && w > 0 && h > 0) {
+		// Give back the part of the buffer needed for 32 bit pixels
+		if (void* indices = realloc(pixels, ImagePalette::GetIndexPitch(w) * h)) {
+			pixels = indices;
+		}
+	}
+
+	width = w;
+	height = h;
+	return true;
+}
+#endif
+
 static void write_data(png_structp out_ptr, png_bytep data, png_size_t len) {
 	reinterpret_cast<Filesystem_Stream::OutputStream*>(png_get_io_ptr(out_ptr))->write(reinterpret_cast<char const*>(data), len);
 }
@@ -250,7 +485,7 @@ static void flush_stream(png_structp out_ptr) {
 	reinterpret_cast<Filesystem_Stream::OutputStream*>(png_get_io_ptr(out_ptr))->flush();
 }
 
-bool ImagePNG::WritePNG(Filesystem_Stream::OutputStream& os, uint32_t width, uint32_t height, uint32_t* data) {
+bool ImagePNG::WritePNG(Filesystem_Stream::OutputStream& os, uint32_t width, uint32_t height, uint32_t* data, int compression) {
 	png_structp write = png_create_write_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
 	if (!write) {
 		Output::Warning("Bitmap::WritePNG: error in png_create_write");
@@ -278,6 +513,14 @@ bool ImagePNG::WritePNG(Filesystem_Stream::OutputStream& os, uint32_t width, uin
 
 	png_set_write_fn(write, &os, &write_data, &flush_stream);
 
+	if (compression >= 0) {
+		png_set_compression_level(write, compression);
+		if (compression == 0) {
+			// Stored without compression, filtering would only cost time
+			png_set_filter(write, PNG_FILTER_TYPE_BASE, PNG_FILTER_NONE);
+		}
+	}
+
 	png_set_IHDR(write, info, width, height, 8,
 				 PNG_COLOR_TYPE_RGB, PNG_INTERLACE_NONE,
 				 PNG_COMPRESSION_TYPE_BASE, PNG_FILTER_TYPE_BASE);
@@ -19,11 +19,27 @@
 #define EP_IMAGE_PNG_H
 
 #include "filesystem_stream.h"
+#include "image_palette.h"
 
 namespace ImagePNG {
-	bool ReadPNG(const void* buffer, bool transparent, int& width, int& height, void*& pixels);
-	bool ReadPNG(Filesystem_Stream::InputStream& is, bool transparent, int& width, int& height, void*& pixels);
-	bool WritePNG(Filesystem_Stream::OutputStream& os, uint32_t width, uint32_t height, uint32_t* data);
+	/*
+	 * Paletted PNGs are expanded into the format of a direct target,
+	 * all other pixels are RGBA.
+	 */
+	bool ReadPNG(const void* buffer, bool transparent, int& width, int& height, void*& pixels, ImagePalette::Target* target = nullptr);
+	bool ReadPNG(const void* buffer, size_t size, bool transparent, int& width, int& height, void*& pixels, ImagePalette::Target* target = nullptr);
+	bool ReadPNG(Filesystem_Stream::InputStream& is, bool transparent, int& width, int& height, void*& pixels, ImagePalette::Target* target = nullptr);
+	/**
+	 * Writes an RGB PNG.
+	 *
+	 * @param os stream to write to
+	 * @param width image width
+	 * @param height image height
+	 * @param data width * height pixels, see Bitmap::GetPNGPixels
+	 * @param compression zlib level 0 to 9, -1 for the libpng default. 0 also disables filtering.
+	 * @return whether the PNG was written
+	 */
+	bool WritePNG(Filesystem_Stream::OutputStream& os, uint32_t width, uint32_t height, uint32_t* data, int compression = -1);
 }
 
 #endif
@@ -24,28 +24,65 @@
 #include "output.h"
 #include "image_xyz.h"
 
-bool ImageXYZ::ReadXYZ(const uint8_t* data, unsigned len, bool transparent,
-					   int& width, int& height, void*& pixels) {
-	pixels = nullptr;
+namespace {
+/** Inflates into out until it is full, refilling the input from stream when given */
+bool Inflate(z_stream& zs, uint8_t* out, size_t size, Filesystem_Stream::InputStream* stream, std::vector<uint8_t>& in) {
+	zs.next_out = out;
+	zs.avail_out = static_cast<uInt>(size);
+	while (zs.avail_out > 0) {
+		if (zs.avail_in == 0 && stream) {
+			zs.next_in = in.data();
+			zs.avail_in = static_cast<uInt>(stream->read(reinterpret_cast<char*>(in.data()), in.size()).gcount());
+		}
+		const int status = inflate(&zs, Z_NO_FLUSH);
+		if (status == Z_STREAM_END) {
+			return zs.avail_out == 0;
+		}
+		if (status != Z_OK) {
+			return false;
+		}
+	}
+	return true;
+}
 
-	if (len < 8) {
-		Output::Warning("Not a valid XYZ file.");
+/**
+ * Decodes the XYZ after the 8 byte header. Each row of indices is inflated
+ * into the end of its pixel row and expanded in place.
+ */
+bool ReadXYZData(z_stream& zs, Filesystem_Stream::InputStream* stream, std::vector<uint8_t>& in,
+		int w, int h, bool transparent, ImagePalette::Target* target, void*& pixels) {
+	uint8_t colors[768];
+	if (!Inflate(zs, colors, sizeof(colors), stream, in)) {
+		Output::Warning("Error decompressing XYZ file.");
 		return false;
 	}
 
-	uint16_t w = data[4] + (data[5] << 8);
-	uint16_t h = data[6] + (data[7] << 8);
-	uLongf src_size = len - 8;
-	Bytef* src_buffer = (Bytef*)&data[8];
-	uLongf dst_size = 768 + (w * h);
-	std::vector<Bytef> dst_buffer(dst_size);
+	if (target && target->indices) {
+		ImagePalette::Build(format_R8G8B8A8_a().format(), colors, 3, 256, transparent, target->palette);
 
-	int status = uncompress(&dst_buffer.front(), &dst_size, src_buffer, src_size);
-	if (status != Z_OK) {
-		Output::Warning("Error decompressing XYZ file.");
-		return false;
+		const int pitch = ImagePalette::GetIndexPitch(w);
+		pixels = malloc(pitch * h);
+		if (!pixels) {
+			Output::Warning("Error allocating XYZ pixel buffer.");
+			return false;
+		}
+
+		for (int y = 0; y < h; y++) {
+			if (!Inflate(zs, static_cast<uint8_t*>(pixels) + y * pitch, w, stream, in)) {
+				Output::Warning("Error decompressing XYZ file.");
+				return false;
+			}
+		}
+
+		target->has_indices = true;
+		return true;
 	}
-	const uint8_t (*palette)[3] = (const uint8_t(*)[3]) &dst_buffer.front();
+
+	uint32_t palette[256];
+	const bool direct = target && target->IsDirect();
+	// RGBA byte order when decoding for Bitmap::ConvertImage
+	const auto rgba = format_R8G8B8A8_a().format();
+	ImagePalette::Build(direct ? *target->format : rgba, colors, 3, 256, transparent, palette);
 
 	pixels = malloc(w * h * 4);
 	if (!pixels) {
@@ -53,26 +90,69 @@ bool ImageXYZ::ReadXYZ(const uint8_t* data, unsigned len, bool transparent,
 		return false;
 	}
 
-	uint8_t* dst = (uint8_t*) pixels;
-	const uint8_t* src = (const uint8_t*) &dst_buffer[768];
 	for (int y = 0; y < h; y++) {
-		for (int x = 0; x < w; x++) {
-			uint8_t pix = *src++;
-			const uint8_t* color = palette[pix];
-			*dst++ = color[0];
-			*dst++ = color[1];
-			*dst++ = color[2];
-			*dst++ = (transparent && pix == 0) ? 0 : 255;
+		uint32_t* row = static_cast<uint32_t*>(pixels) + y * w;
+		uint8_t* indices = reinterpret_cast<uint8_t*>(row) + w * 3;
+		if (!Inflate(zs, indices, w, stream, in)) {
+			Output::Warning("Error decompressing XYZ file.");
+			return false;
 		}
+		ImagePalette::ExpandRow(row, indices, w, palette);
+	}
+
+	if (target) {
+		target->converted = direct;
+	}
+	return true;
+}
+
+bool ReadXYZImage(const uint8_t* header, const uint8_t* data, unsigned len, Filesystem_Stream::InputStream* stream,
+		bool transparent, ImagePalette::Target* target, int& width, int& height, void*& pixels) {
+	uint16_t w = header[4] + (header[5] << 8);
+	uint16_t h = header[6] + (header[7] << 8);
+
+	z_stream zs = {};
+	zs.next_in = const_cast<Bytef*>(data);
+	zs.avail_in = len;
+	if (inflateInit(&zs) != Z_OK) {
+		Output::Warning("Error decompressing XYZ file.");
+		return false;
+	}
+
+	std::vector<uint8_t> in(stream ? 16 * 1024 : 0);
+	const bool okay = ReadXYZData(zs, stream, in, w, h, transparent, target, pixels);
+	inflateEnd(&zs);
+	if (!okay) {
+		return false;
 	}
 
 	width = w;
 	height = h;
 	return true;
 }
+}
+
+bool ImageXYZ::ReadXYZ(const uint8_t* data, unsigned len, bool transparent,
+					   int& width, int& height, void*& pixels, ImagePalette::Target* target) {
+	pixels = nullptr;
+
+	if (len < 8) {
+		Output::Warning("Not a valid XYZ file.");
+		return false;
+	}
+
+	return ReadXYZImage(data, data + 8, len - 8, nullptr, transparent, target, width, height, pixels);
+}
 
 bool ImageXYZ::ReadXYZ(Filesystem_Stream::InputStream& stream, bool transparent,
-					   int& width, int& height, void*& pixels) {
-	std::vector<uint8_t> buffer = Utils::ReadStream(stream);
-	return ReadXYZ(&buffer.front(), (unsigned) buffer.size(), transparent, width, height, pixels);
+					   int& width, int& height, void*& pixels, ImagePalette::Target* target) {
+	pixels = nullptr;
+
+	uint8_t header[8];
+	if (stream.read(reinterpret_cast<char*>(header), sizeof(header)).gcount() != sizeof(header)) {
+		Output::Warning("Not a valid XYZ file.");
+		return false;
+	}
+
+	return ReadXYZImage(header, nullptr, 0, &stream, transparent, target, width, height, pixels);
 }
@@ -20,10 +20,15 @@
 
 #include <cstdio>
 #include "filesystem_stream.h"
+#include "image_palette.h"
 
+/**
+ * XYZ images are always paletted. With a direct target the pixels are
+ * expanded into its format, otherwise they are RGBA.
+ */
 namespace ImageXYZ {
-	bool ReadXYZ(const uint8_t* data, unsigned len, bool transparent, int& width, int& height, void*& pixels);
-	bool ReadXYZ(Filesystem_Stream::InputStream& stream, bool transparent, int& width, int& height, void*& pixels);
+	bool ReadXYZ(const uint8_t* data, unsigned len, bool transparent, int& width, int& height, void*& pixels, ImagePalette::Target* target = nullptr);
+	bool ReadXYZ(Filesystem_Stream::InputStream& stream, bool transparent, int& width, int& height, void*& pixels, ImagePalette::Target* target = nullptr);
 }
 
 #endif
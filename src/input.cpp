@@ -61,7 +61,8 @@ void Input::Init(
 	ButtonMappingArray buttons,
 	DirectionMappingArray directions,
 	const std::string& replay_from_path,
-	const std::string& record_to_path
+	const std::string& record_to_path,
+	bool record_binary
 ) {
 	std::fill(press_time.begin(), press_time.end(), 0);
 	triggered.reset();
@@ -72,7 +73,7 @@ void Input::Init(
 	raw_released.reset();
 
 	source = Source::Create(std::move(buttons), std::move(directions), replay_from_path);
-	source->InitRecording(record_to_path);
+	source->InitRecording(record_to_path, record_binary);
 
 	ResetMask();
 }
@@ -341,6 +342,12 @@ bool Input::IsRecording() {
 	return source->IsRecording();
 }
 
+void Input::FinishRecording() {
+	if (source) {
+		source->FinishRecording();
+	}
+}
+
 Input::KeyStatus Input::GetMask() {
 	assert(source);
 	return source->GetMask();
@@ -45,12 +45,14 @@ namespace Input {
 	 *  replay from, or the empty string if not replaying
 	 * @param record_to_path path to a file to record
 	 *  input to, or the empty string if not recording
+	 * @param record_binary record in the binary format instead of text
 	 */
 	void Init(
 		ButtonMappingArray buttons,
 		DirectionMappingArray directions,
 		const std::string& replay_from_path,
-		const std::string& record_to_path
+		const std::string& record_to_path,
+		bool record_binary = false
 	);
 
 	/**
@@ -280,6 +282,9 @@ namespace Input {
 	/** @return If the input is recorded */
 	bool IsRecording();
 
+	/** Writes the buffered recording, called before the job system is shut down */
+	void FinishRecording();
+
 	/** Buttons press time (in frames). */
 	extern std::array<int, BUTTON_COUNT> press_time;
 
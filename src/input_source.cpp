@@ -19,6 +19,7 @@
 #include <cstring>
 #include <cerrno>
 #include <ctime>
+#include <iterator>
 
 #include "baseui.h"
 #include "input_source.h"
@@ -26,8 +27,55 @@
 #include "output.h"
 #include "game_system.h"
 #include "main_data.h"
+#include "job_system.h"
 #include "version.h"
 
+namespace {
+	constexpr int binary_version = 3;
+	/** Size of the button mask of a run */
+	constexpr int button_bytes = (Input::BUTTON_COUNT + 7) / 8;
+	/** The binary recording is written in the background in chunks of this size */
+	constexpr size_t record_flush_size = 64 * 1024;
+
+	void WriteVarint(std::string& out, uint32_t value) {
+		while (value >= 0x80) {
+			out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+			value >>= 7;
+		}
+		out.push_back(static_cast<char>(value));
+	}
+
+	bool ReadVarint(const char*& pos, const char* end, uint32_t& value) {
+		value = 0;
+		for (int shift = 0; pos != end && shift < 32; shift += 7) {
+			const auto byte = static_cast<uint8_t>(*pos++);
+			value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+			if (!(byte & 0x80)) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	/** Metadata record of the binary format: tag, size and data */
+	void WriteRecord(std::string& out, char tag, StringView data) {
+		out.push_back(tag);
+		WriteVarint(out, data.size());
+		out.append(data.data(), data.size());
+	}
+
+	std::string GetRecordingDate() {
+		std::time_t t = std::time(nullptr);
+		// trigraph ?-escapes
+		std::string date = R"(????-??-?? ??:??:??)";
+		char timestr[100];
+		if (std::strftime(timestr, sizeof(timestr), "%Y-%m-%d %H:%M:%S", std::localtime(&t))) {
+			date = std::string(timestr);
+		}
+		return date;
+	}
+}
+
 std::unique_ptr<Input::Source> Input::Source::Create(
 		Input::ButtonMappingArray buttons,
 		Input::DirectionMappingArray directions,
@@ -50,18 +98,61 @@ std::unique_ptr<Input::Source> Input::Source::Create(
 	return std::make_unique<Input::UiSource>(std::move(buttons), std::move(directions));
 }
 
-void Input::UiSource::DoUpdate(bool system_only) {
-	keystates = DisplayUi->GetKeyStates();
+void Input::UiSource::UpdateButton(InputButton button) {
+	bool pressed = false;
+	for (auto it = button_mappings.LowerBound(button); it != button_mappings.end() && it->first == button; ++it) {
+		pressed |= mapped_keys[it->second];
+	}
+	mapped_buttons[button] = pressed;
+}
+
+void Input::UiSource::UpdateMappedButtons() {
+	const auto keys = keystates & ~keymask;
 
-	pressed_buttons = {};
+	if (mappings_changed) {
+		mappings_changed = false;
+		key_buttons = {};
+		for (auto& bm: button_mappings) {
+			key_buttons.Add({ bm.second, bm.first });
+		}
 
-	for (auto& bm: button_mappings) {
-		if (keymask[bm.second]) {
+		mapped_keys = keys;
+		mapped_buttons.reset();
+		for (auto& bm: button_mappings) {
+			mapped_buttons[bm.first] = mapped_buttons[bm.first] | mapped_keys[bm.second];
+		}
+		return;
+	}
+
+	// Only the buttons of keys which changed since the last update are looked at
+	const auto changed = keys ^ mapped_keys;
+	if (changed.none()) {
+		return;
+	}
+	mapped_keys = keys;
+
+	for (unsigned key = 0; key < Keys::KEYS_COUNT; ++key) {
+		if (!changed[key]) {
 			continue;
 		}
+		const auto k = static_cast<Keys::InputKey>(key);
+		for (auto it = key_buttons.LowerBound(k); it != key_buttons.end() && it->first == k; ++it) {
+			UpdateButton(it->second);
+		}
+	}
+}
+
+void Input::UiSource::DoUpdate(bool system_only) {
+	keystates = DisplayUi->GetKeyStates();
+
+	UpdateMappedButtons();
 
-		if (!system_only || Input::IsSystemButton(bm.first)) {
-			pressed_buttons[bm.first] = pressed_buttons[bm.first] | keystates[bm.second];
+	pressed_buttons = mapped_buttons;
+	if (system_only) {
+		for (unsigned i = 0; i < BUTTON_COUNT; ++i) {
+			if (!Input::IsSystemButton(static_cast<InputButton>(i))) {
+				pressed_buttons[i] = false;
+			}
 		}
 	}
 
@@ -80,8 +171,29 @@ void Input::UiSource::UpdateSystem() {
 
 Input::LogSource::LogSource(const char* log_path, ButtonMappingArray buttons, DirectionMappingArray directions)
 	: Source(std::move(buttons), std::move(directions)),
-	log_file(FileFinder::OpenInputStream(log_path, std::ios::in))
+	log_file(FileFinder::OpenInputStream(log_path, std::ios::in | std::ios::binary))
 {
+	char magic[sizeof(kBinaryRecordingMagic)] = {};
+	if (log_file.read(magic, sizeof(magic)) && std::equal(magic, magic + sizeof(magic) - 1, kBinaryRecordingMagic)) {
+		version = magic[sizeof(magic) - 1];
+		if (version != binary_version) {
+			Output::Error("Unsupported logfile version {}", version);
+		}
+
+		// Mapped files are parsed in place
+		auto span = log_file.GetSpan();
+		if (span.empty()) {
+			binary_data.assign(std::istreambuf_iterator<char>(log_file), std::istreambuf_iterator<char>());
+			binary_pos = binary_data.data();
+			binary_end = binary_pos + binary_data.size();
+		} else {
+			binary_pos = reinterpret_cast<const char*>(span.data());
+			binary_end = binary_pos + span.size();
+		}
+		return;
+	}
+
+	log_file = FileFinder::OpenInputStream(log_path, std::ios::in | std::ios::binary);
 	std::string header = Utils::ReadLine(log_file);
 	if (StringView(header).starts_with("H EasyRPG")) {
 		std::string ver = Utils::ReadLine(log_file);
@@ -95,7 +207,58 @@ Input::LogSource::LogSource(const char* log_path, ButtonMappingArray buttons, Di
 	}
 }
 
+bool Input::LogSource::ReadRun() {
+	while (binary_pos < binary_end) {
+		const char tag = *binary_pos++;
+		if (tag == 'F') {
+			uint32_t frame, length;
+			if (!ReadVarint(binary_pos, binary_end, frame) || !ReadVarint(binary_pos, binary_end, length)
+					|| binary_end - binary_pos < button_bytes) {
+				break;
+			}
+			run_frame = static_cast<int>(frame);
+			run_length = static_cast<int>(length);
+			run_buttons.reset();
+			for (int i = 0; i < BUTTON_COUNT; ++i) {
+				run_buttons[i] = (static_cast<uint8_t>(binary_pos[i / 8]) >> (i % 8)) & 1;
+			}
+			binary_pos += button_bytes;
+			return true;
+		}
+
+		// Metadata is not needed for replaying
+		uint32_t size;
+		if (!ReadVarint(binary_pos, binary_end, size) || static_cast<uint32_t>(binary_end - binary_pos) < size) {
+			break;
+		}
+		binary_pos += size;
+	}
+	binary_pos = binary_end;
+	return false;
+}
+
 void Input::LogSource::Update() {
+	if (version == binary_version) {
+		if (!Main_Data::game_system) {
+			return;
+		}
+
+		const int frame = Main_Data::game_system->GetFrameCounter();
+		while (run_frame + run_length <= frame && ReadRun()) {
+			// Runs that ended before this frame are skipped
+		}
+
+		pressed_buttons.reset();
+		if (frame >= run_frame && frame < run_frame + run_length) {
+			pressed_buttons = run_buttons;
+		} else if (binary_pos == binary_end && frame >= run_frame + run_length) {
+			Player::exit_flag = true;
+		}
+
+		Record();
+		return;
+	}
+
 	if (version == 2) {
 		if (!Main_Data::game_system) {
 			return;
@@ -136,31 +299,90 @@ void Input::LogSource::Update() {
 }
 
 
-bool Input::Source::InitRecording(const std::string& record_to_path) {
+Input::Source::~Source() {
+	FinishRecording();
+}
+
+bool Input::Source::InitRecording(const std::string& record_to_path, bool binary) {
 	if (!record_to_path.empty()) {
 		auto path = record_to_path.c_str();
 
-		record_log = std::make_unique<Filesystem_Stream::OutputStream>(FileFinder::OpenOutputStream(path, std::ios::out | std::ios::trunc));
+		auto mode = std::ios::out | std::ios::trunc;
+		if (binary) {
+			mode |= std::ios::binary;
+		}
+		record_log = std::make_unique<Filesystem_Stream::OutputStream>(FileFinder::OpenOutputStream(path, mode));
 
 		if (!record_log) {
 			Output::Warning("Failed to open file {} for input recording : {}", path, strerror(errno));
 			return false;
 		}
 
+		record_binary = binary;
+		if (binary) {
+			record_buffer.append(kBinaryRecordingMagic, sizeof(kBinaryRecordingMagic) - 1);
+			record_buffer.push_back(static_cast<char>(binary_version));
+			WriteRecord(record_buffer, 'V', PLAYER_VERSION);
+			WriteRecord(record_buffer, 'D', GetRecordingDate());
+			return true;
+		}
+
 		*record_log << "H EasyRPG Player Recording\n";
 		*record_log << "V 2 " PLAYER_VERSION "\n";
+		*record_log << "D " << GetRecordingDate() << '\n';
+	}
+	return true;
+}
 
-		std::time_t t = std::time(nullptr);
-		// trigraph ?-escapes
-		std::string date = R"(????-??-?? ??:??:??)";
-		char timestr[100];
-		if (std::strftime(timestr, sizeof(timestr), "%Y-%m-%d %H:%M:%S", std::localtime(&t))) {
-			date = std::string(timestr);
+void Input::Source::FinishRecording() {
+	if (!record_log || !record_binary) {
+		return;
+	}
+
+	WriteRecordingRun();
+	FlushRecording(true);
+	record_log->flush();
+}
+
+void Input::Source::WriteRecordingRun() {
+	if (run_length == 0) {
+		return;
+	}
+
+	record_buffer.push_back('F');
+	WriteVarint(record_buffer, run_frame);
+	WriteVarint(record_buffer, run_length);
+	for (int i = 0; i < button_bytes; ++i) {
+		uint8_t mask = 0;
+		for (int bit = 0; bit < 8 && i * 8 + bit < BUTTON_COUNT; ++bit) {
+			mask |= run_buttons[i * 8 + bit] << bit;
 		}
+		record_buffer.push_back(static_cast<char>(mask));
+	}
+	run_length = 0;
 
-		*record_log << "D " << date << '\n';
+	if (record_buffer.size() >= record_flush_size) {
+		FlushRecording(false);
+	}
+}
+
+void Input::Source::FlushRecording(bool wait) {
+	// One write at a time, they must stay in order
+	if (record_flush.valid()) {
+		record_flush.wait();
+	}
+
+	if (!record_buffer.empty()) {
+		auto* log = record_log.get();
+		record_flush = JobSystem::Async([log, data = std::move(record_buffer)]() {
+			log->write(data.data(), data.size());
+		});
+		record_buffer.clear();
+	}
+
+	if (wait && record_flush.valid()) {
+		record_flush.wait();
 	}
-	return true;
 }
 
 void Input::Source::Record() {
@@ -176,6 +398,19 @@ void Input::Source::Record() {
 			}
 			last_written_frame = cur_frame;
 
+			if (record_binary) {
+				// Consecutive frames with the same buttons are one run
+				if (run_length > 0 && cur_frame == run_frame + run_length && buttons == run_buttons) {
+					++run_length;
+					return;
+				}
+				WriteRecordingRun();
+				run_frame = cur_frame;
+				run_length = 1;
+				run_buttons = buttons;
+				return;
+			}
+
 			*record_log << "F " << cur_frame;
 
 			for (size_t i = 0; i < buttons.size(); ++i) {
@@ -193,6 +428,11 @@ void Input::Source::Record() {
 
 void Input::Source::AddRecordingData(Input::RecordingData type, StringView data) {
 	if (record_log) {
+		if (record_binary) {
+			WriteRecordingRun();
+			WriteRecord(record_buffer, static_cast<char>(type), data);
+			return;
+		}
 		*record_log << static_cast<char>(type) << " " << data << "\n";
 	}
 }
@@ -20,6 +20,7 @@
 
 #include <bitset>
 #include <fstream>
+#include <future>
 #include <memory>
 #include "filesystem_stream.h"
 #include "input_buttons.h"
@@ -36,6 +37,9 @@ namespace Input {
 		GameTitle = 'N'
 	};
 
+	/** Start of binary recordings, followed by the version byte */
+	constexpr char kBinaryRecordingMagic[] = "EPIR";
+
 	/**
 	 * A source for button presses.
 	 */
@@ -50,7 +54,7 @@ namespace Input {
 		Source(ButtonMappingArray buttons, DirectionMappingArray directions)
 			: button_mappings(std::move(buttons)), direction_mappings(std::move(directions)) {}
 
-		virtual ~Source() = default;
+		virtual ~Source();
 
 		/** Called once each logical frame to update pressed_buttons. */
 		virtual void Update() = 0;
@@ -87,13 +91,24 @@ namespace Input {
 			return keystates;
 		}
 
-		ButtonMappingArray& GetButtonMappings() { return button_mappings; }
+		/** Mutable access, the mappings are assumed changed afterwards */
+		ButtonMappingArray& GetButtonMappings() { mappings_changed = true; return button_mappings; }
 		const ButtonMappingArray& GetButtonMappings() const { return button_mappings; }
 
 		DirectionMappingArray& GetDirectionMappings() { return direction_mappings; }
 		const DirectionMappingArray& GetDirectionMappings() const { return direction_mappings; }
 
-		bool InitRecording(const std::string& record_to_path);
+		/**
+		 * Starts recording the input.
+		 *
+		 * @param record_to_path file to record to
+		 * @param binary use the run length encoded binary format instead of text
+		 * @return false when the file could not be opened
+		 */
+		bool InitRecording(const std::string& record_to_path, bool binary = false);
+
+		/** Writes everything buffered by the binary format and waits until it is written */
+		void FinishRecording();
 
 		Point GetMousePosition() const { return mouse_pos; }
 
@@ -103,6 +118,11 @@ namespace Input {
 	protected:
 		void Record();
 
+		/** Appends the pending run of the binary format to the buffer */
+		void WriteRecordingRun();
+		/** Writes the buffer of the binary format in a job, wait also waits for it */
+		void FlushRecording(bool wait);
+
 		std::bitset<BUTTON_COUNT> pressed_buttons;
 		ButtonMappingArray button_mappings;
 		DirectionMappingArray direction_mappings;
@@ -113,6 +133,15 @@ namespace Input {
 		Point mouse_pos;
 
 		int last_written_frame = -1;
+		bool mappings_changed = true;
+
+		bool record_binary = false;
+		std::string record_buffer;
+		std::future<void> record_flush;
+		/** Frames from run_frame on had run_buttons pressed, not written yet */
+		int run_frame = 0;
+		int run_length = 0;
+		std::bitset<BUTTON_COUNT> run_buttons;
 	};
 
 	/**
@@ -128,6 +157,15 @@ namespace Input {
 
 	private:
 		void DoUpdate(bool system_only);
+		void UpdateMappedButtons();
+		void UpdateButton(InputButton button);
+
+		/** Buttons pressed by the unmasked keys, system or not */
+		std::bitset<BUTTON_COUNT> mapped_buttons;
+		/** Unmasked keys mapped_buttons was computed from */
+		KeyStatus mapped_keys;
+		/** Reverse of button_mappings */
+		FlatUniqueMultiMap<Keys::InputKey, InputButton> key_buttons;
 	};
 
 	/**
@@ -142,11 +180,22 @@ namespace Input {
 
 		operator bool() const { return bool(log_file); }
 	private:
+		/** Reads the next run of the binary format, false at the end */
+		bool ReadRun();
+
 		Filesystem_Stream::InputStream log_file;
 		int version = 1;
 		int last_read_frame = -1;
 		// NOTE: First field is the frame number
 		std::vector<std::string> keys;
+
+		/** Binary format: the file when the stream is not mapped, else it is parsed in place */
+		std::string binary_data;
+		const char* binary_pos = nullptr;
+		const char* binary_end = nullptr;
+		int run_frame = 0;
+		int run_length = 0;
+		std::bitset<BUTTON_COUNT> run_buttons;
 	};
 
 	extern std::unique_ptr<Source> source;
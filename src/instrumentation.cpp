@@ -18,19 +18,115 @@
 #include "instrumentation.h"
 #include "utils.h"
 
-#ifdef PLAYER_INSTRUMENTATION_VTUNE
+#ifdef PLAYER_INSTRUMENTATION_CHROME
+#include <cstdint>
+#include <functional>
+#include <vector>
+#ifdef HAVE_THREADS
+#include <mutex>
+#include <thread>
+#endif
+#include "filefinder.h"
+#include "main_data.h"
+#include "output.h"
+#endif
+
+#if defined(PLAYER_INSTRUMENTATION_VTUNE)
 __itt_domain* Instrumentation::domain = nullptr;
+#elif defined(PLAYER_INSTRUMENTATION_CHROME)
+Instrumentation::clock::time_point Instrumentation::frame_begin;
+
+namespace {
+	constexpr const char* const trace_filename = "trace.json";
+
+	/** Complete event of the Chrome trace event format */
+	struct TraceEvent {
+		const char* name;
+		Instrumentation::clock::time_point begin;
+		Instrumentation::clock::time_point end;
+		size_t thread;
+	};
+
+	Instrumentation::clock::time_point trace_begin;
+	std::vector<TraceEvent> trace_events;
+#ifdef HAVE_THREADS
+	std::mutex trace_mutex;
+#endif
+
+	int64_t ToMicroseconds(Instrumentation::clock::duration d) {
+		return std::chrono::duration_cast<std::chrono::microseconds>(d).count();
+	}
+}
 #endif
 
 void Instrumentation::Init(const char* name) {
-#ifdef PLAYER_INSTRUMENTATION_VTUNE
+#if defined(PLAYER_INSTRUMENTATION_VTUNE)
 	assert(!domain);
 #ifdef _WIN32
 	domain = __itt_domain_create(Utils::ToWideString(name).c_str());
 #else
 	domain = __itt_domain_create(name);
 #endif
+#elif defined(PLAYER_INSTRUMENTATION_CHROME)
+	(void)name;
+	trace_begin = clock::now();
+	frame_begin = trace_begin;
 #else
 	(void)name;
 #endif
 }
+
+void Instrumentation::Quit() {
+#ifdef PLAYER_INSTRUMENTATION_CHROME
+	std::vector<TraceEvent> events;
+	{
+#ifdef HAVE_THREADS
+		std::lock_guard<std::mutex> lock(trace_mutex);
+#endif
+		events.swap(trace_events);
+	}
+
+	auto path = FileFinder::MakePath(Main_Data::GetSavePath(), trace_filename);
+	auto os = FileFinder::OpenOutputStream(path, std::ios_base::out | std::ios_base::trunc);
+	if (!os) {
+		Output::Warning("Instrumentation: Cannot write trace file {}", path);
+		return;
+	}
+
+	os << "{\"traceEvents\":[\n";
+	for (size_t i = 0; i < events.size(); ++i) {
+		const auto& ev = events[i];
+		os << "{\"name\":\"" << ev.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << ev.thread
+			<< ",\"ts\":" << ToMicroseconds(ev.begin - trace_begin)
+			<< ",\"dur\":" << ToMicroseconds(ev.end - ev.begin) << "}"
+			<< (i + 1 < events.size() ? ",\n" : "\n");
+	}
+	os << "]}\n";
+
+	Output::Debug("Instrumentation: Wrote {} events to {}", events.size(), path);
+#endif
+}
+
+#if defined(PLAYER_INSTRUMENTATION_VTUNE)
+Instrumentation::ZoneHandle Instrumentation::CreateZone(const char* name) {
+#ifdef _WIN32
+	return __itt_string_handle_create(Utils::ToWideString(name).c_str());
+#else
+	return __itt_string_handle_create(name);
+#endif
+}
+#elif defined(PLAYER_INSTRUMENTATION_CHROME)
+Instrumentation::ZoneHandle Instrumentation::CreateZone(const char* name) {
+	return name;
+}
+
+void Instrumentation::AddZone(ZoneHandle handle, clock::time_point begin, clock::time_point end) {
+#ifdef HAVE_THREADS
+	const size_t thread = std::hash<std::thread::id>()(std::this_thread::get_id()) & 0xFFFF;
+	std::lock_guard<std::mutex> lock(trace_mutex);
+#else
+	const size_t thread = 0;
+#endif
+	trace_events.push_back({ handle, begin, end, thread });
+}
+#endif
@@ -18,15 +18,35 @@
 #ifndef EP_INSTRUMENTATION_H
 #define EP_INSTRUMENTATION_H
 
-#if defined(PLAYER_INSTRUMENTATION) && PLAYER_INSTRUMENTATION == VTune
-#define PLAYER_INSTRUMENTATION_VTUNE
-#endif
-
-#ifdef PLAYER_INSTRUMENTATION_VTUNE
+// The build system defines one of PLAYER_INSTRUMENTATION_VTUNE,
+// PLAYER_INSTRUMENTATION_TRACY or PLAYER_INSTRUMENTATION_CHROME
+#if defined(PLAYER_INSTRUMENTATION_VTUNE)
 #include <ittnotify.h>
+#elif defined(PLAYER_INSTRUMENTATION_TRACY)
+#include <tracy/Tracy.hpp>
+#elif defined(PLAYER_INSTRUMENTATION_CHROME)
+#include <chrono>
 #endif
 #include <cassert>
 
+#define EP_INSTRUMENTATION_CONCAT2(a, b) a##b
+#define EP_INSTRUMENTATION_CONCAT(a, b) EP_INSTRUMENTATION_CONCAT2(a, b)
+
+/**
+ * Marks the rest of the enclosing block as a zone named name.
+ * The name must be a string literal. Expands to nothing when the
+ * instrumentation is disabled.
+ */
+#if defined(PLAYER_INSTRUMENTATION_TRACY)
+#define INSTRUMENTATION_SCOPE(name) ZoneScopedN(name)
+#elif defined(PLAYER_INSTRUMENTATION_VTUNE) || defined(PLAYER_INSTRUMENTATION_CHROME)
+#define INSTRUMENTATION_SCOPE(name) \
+	static const Instrumentation::ZoneHandle EP_INSTRUMENTATION_CONCAT(instrumentation_handle_, __LINE__) = Instrumentation::CreateZone(name); \
+	Instrumentation::ZoneScope EP_INSTRUMENTATION_CONCAT(instrumentation_zone_, __LINE__)(EP_INSTRUMENTATION_CONCAT(instrumentation_handle_, __LINE__))
+#else
+#define INSTRUMENTATION_SCOPE(name) (void)0
+#endif
+
 class Instrumentation {
 public:
 	/**
@@ -42,6 +62,50 @@ public:
 	/** Call at the end of a frame */
 	static void FrameEnd();
 
+	/** Must be called once on shutdown, writes the trace file of the Chrome backend */
+	static void Quit();
+
+#if defined(PLAYER_INSTRUMENTATION_VTUNE)
+	using ZoneHandle = __itt_string_handle*;
+#elif defined(PLAYER_INSTRUMENTATION_CHROME)
+	using ZoneHandle = const char*;
+	using clock = std::chrono::steady_clock;
+
+	/**
+	 * Records a finished zone in the trace.
+	 *
+	 * @param handle the zone
+	 * @param begin start time of the zone
+	 * @param end end time of the zone
+	 */
+	static void AddZone(ZoneHandle handle, clock::time_point begin, clock::time_point end);
+#endif
+
+#if defined(PLAYER_INSTRUMENTATION_VTUNE) || defined(PLAYER_INSTRUMENTATION_CHROME)
+	/**
+	 * Creates the handle of a zone, use INSTRUMENTATION_SCOPE instead.
+	 *
+	 * @param name name of the zone, must outlive the program
+	 * @return zone handle
+	 */
+	static ZoneHandle CreateZone(const char* name);
+
+	/** RAII wrapper marking a zone, use INSTRUMENTATION_SCOPE instead */
+	class ZoneScope {
+	public:
+		explicit ZoneScope(ZoneHandle handle);
+		~ZoneScope();
+
+		ZoneScope(const ZoneScope&) = delete;
+		ZoneScope& operator=(const ZoneScope&) = delete;
+	private:
+		ZoneHandle handle;
+#ifdef PLAYER_INSTRUMENTATION_CHROME
+		clock::time_point begin;
+#endif
+	};
+#endif
+
 	/** RAII wrapper around FrameBegin() / FrameEnd() */
 	class FrameScope {
 	public:
@@ -74,24 +138,49 @@ public:
 	};
 
 private:
-#ifdef PLAYER_INSTRUMENTATION_VTUNE
+#if defined(PLAYER_INSTRUMENTATION_VTUNE)
 	static __itt_domain* domain;
+#elif defined(PLAYER_INSTRUMENTATION_CHROME)
+	static clock::time_point frame_begin;
 #endif
 };
 
 inline void Instrumentation::FrameBegin() {
-#ifdef PLAYER_INSTRUMENTATION_VTUNE
+#if defined(PLAYER_INSTRUMENTATION_VTUNE)
 	assert(domain);
 	__itt_frame_begin_v3(domain, nullptr);
+#elif defined(PLAYER_INSTRUMENTATION_CHROME)
+	frame_begin = clock::now();
 #endif
 }
 inline void Instrumentation::FrameEnd() {
-#ifdef PLAYER_INSTRUMENTATION_VTUNE
+#if defined(PLAYER_INSTRUMENTATION_VTUNE)
 	assert(domain);
 	__itt_frame_end_v3(domain, nullptr);
+#elif defined(PLAYER_INSTRUMENTATION_TRACY)
+	FrameMark;
+#elif defined(PLAYER_INSTRUMENTATION_CHROME)
+	AddZone("Frame", frame_begin, clock::now());
 #endif
 }
 
+#if defined(PLAYER_INSTRUMENTATION_VTUNE)
+inline Instrumentation::ZoneScope::ZoneScope(ZoneHandle handle) : handle(handle) {
+	__itt_task_begin(domain, __itt_null, __itt_null, handle);
+}
+
+inline Instrumentation::ZoneScope::~ZoneScope() {
+	__itt_task_end(domain);
+}
+#elif defined(PLAYER_INSTRUMENTATION_CHROME)
+inline Instrumentation::ZoneScope::ZoneScope(ZoneHandle handle) : handle(handle), begin(clock::now()) {
+}
+
+inline Instrumentation::ZoneScope::~ZoneScope() {
+	AddZone(handle, begin, clock::now());
+}
+#endif
+
 inline Instrumentation::FrameScope::FrameScope(bool frame_begin)
 {
 	if (frame_begin) {
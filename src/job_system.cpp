@@ -0,0 +1,288 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+// Headers
+#include "job_system.h"
+#include "output.h"
+#include <algorithm>
+#include <utility>
+#include <vector>
+#ifdef HAVE_THREADS
+#  include "thread_affinity.h"
+#  include <array>
+#  include <atomic>
+#  include <condition_variable>
+#  include <deque>
+#  include <mutex>
+#  include <thread>
+#endif
+
+namespace {
+#ifdef HAVE_THREADS
+	/** Continuations of finished jobs, called by Update */
+	std::mutex continuation_mutex;
+	std::vector<std::function<void()>> continuations;
+
+	void AddContinuation(std::function<void()> continuation) {
+		std::lock_guard<std::mutex> lock(continuation_mutex);
+		continuations.push_back(std::move(continuation));
+	}
+
+	/** Upper bound of the workers on desktop systems */
+	constexpr int max_threads = 16;
+
+	constexpr int num_priorities = 3;
+
+	/** Jobs of one worker, the owner takes the newest, thieves the oldest */
+	struct Queue {
+		std::mutex mutex;
+		std::array<std::deque<std::function<void()>>, num_priorities> jobs;
+	};
+
+	std::vector<std::unique_ptr<Queue>> queues;
+	std::vector<std::thread> threads;
+	std::atomic<unsigned> next_queue(0);
+
+	/** Guards pending and quit, workers wait on wake_cv until a job is queued */
+	std::mutex wake_mutex;
+	std::condition_variable wake_cv;
+	int pending = 0;
+	bool quit = false;
+
+	/** Index of the queue of the worker, -1 on other threads */
+	thread_local int worker_index = -1;
+
+	bool TakeJob(Queue& queue, bool steal, std::function<void()>& job) {
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		for (auto& jobs: queue.jobs) {
+			if (jobs.empty()) {
+				continue;
+			}
+			if (steal) {
+				job = std::move(jobs.front());
+				jobs.pop_front();
+			} else {
+				job = std::move(jobs.back());
+				jobs.pop_back();
+			}
+			return true;
+		}
+		return false;
+	}
+
+	/** Takes a job of the own queue, or steals one from the others */
+	bool FindJob(int index, std::function<void()>& job) {
+		const int count = static_cast<int>(queues.size());
+		if (TakeJob(*queues[index], false, job)) {
+			return true;
+		}
+		for (int i = 1; i < count; ++i) {
+			if (TakeJob(*queues[(index + i) % count], true, job)) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void Work(int index) {
+		ThreadAffinity::Apply(ThreadAffinity::Role::Worker);
+		worker_index = index;
+
+		std::function<void()> job;
+		while (true) {
+			if (FindJob(index, job)) {
+				{
+					std::lock_guard<std::mutex> lock(wake_mutex);
+					--pending;
+				}
+				job();
+				job = nullptr;
+				continue;
+			}
+
+			std::unique_lock<std::mutex> lock(wake_mutex);
+			wake_cv.wait(lock, []() { return quit || pending > 0; });
+			if (quit && pending == 0) {
+				return;
+			}
+		}
+	}
+#endif
+}
+
+void JobSystem::Init(int count) {
+	Quit();
+	if (count < 0) {
+		count = GetDefaultThreadCount();
+	}
+#ifdef HAVE_THREADS
+	count = std::min(count, max_threads);
+	quit = false;
+	for (int i = 0; i < count; ++i) {
+		queues.push_back(std::make_unique<Queue>());
+	}
+	for (int i = 0; i < count; ++i) {
+		threads.emplace_back([i]() { Work(i); });
+	}
+#endif
+	Output::Debug("Job system: {} worker threads", GetThreadCount());
+}
+
+void JobSystem::Quit() {
+#ifdef HAVE_THREADS
+	{
+		std::lock_guard<std::mutex> lock(wake_mutex);
+		quit = true;
+	}
+	wake_cv.notify_all();
+	for (auto& thread: threads) {
+		thread.join();
+	}
+	threads.clear();
+	queues.clear();
+
+	std::lock_guard<std::mutex> lock(continuation_mutex);
+	continuations.clear();
+#endif
+}
+
+int JobSystem::GetDefaultThreadCount() {
+#if !defined(HAVE_THREADS) || defined(GEKKO) || defined(PSP2)
+	return 0;
+#else
+	// The main thread keeps one core
+	int count = std::max(static_cast<int>(std::thread::hardware_concurrency()) - 1, 1);
+#  if defined(__SWITCH__)
+	// Cores 1 and 2, see ThreadAffinity
+	count = std::min(count, 2);
+#  elif defined(_3DS)
+	count = std::min(count, 1);
+#  endif
+	return std::min(count, max_threads);
+#endif
+}
+
+int JobSystem::GetThreadCount() {
+#ifdef HAVE_THREADS
+	return static_cast<int>(threads.size());
+#else
+	return 0;
+#endif
+}
+
+void JobSystem::Submit(std::function<void()> job, Priority priority) {
+#ifdef HAVE_THREADS
+	if (!threads.empty()) {
+		// Jobs of a worker go to its own queue and stay in its cache
+		const int count = static_cast<int>(queues.size());
+		const int index = worker_index >= 0 ? worker_index : static_cast<int>(next_queue++ % count);
+		{
+			auto& queue = *queues[index];
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			queue.jobs[static_cast<int>(priority)].push_back(std::move(job));
+		}
+		{
+			std::lock_guard<std::mutex> lock(wake_mutex);
+			++pending;
+		}
+		wake_cv.notify_one();
+		return;
+	}
+#endif
+	(void)priority;
+	job();
+}
+
+void JobSystem::Submit(std::function<void()> job, std::function<void()> continuation, Priority priority) {
+#ifdef HAVE_THREADS
+	if (!threads.empty()) {
+		Submit([job = std::move(job), continuation = std::move(continuation)]() mutable {
+			job();
+			AddContinuation(std::move(continuation));
+		}, priority);
+		return;
+	}
+#endif
+	// Without workers both run on the calling thread
+	(void)priority;
+	job();
+	continuation();
+}
+
+void JobSystem::ParallelFor(int count, const std::function<void(int)>& fn) {
+	const int helpers = std::min(count - 1, GetThreadCount());
+	if (helpers <= 0) {
+		for (int i = 0; i < count; ++i) {
+			fn(i);
+		}
+		return;
+	}
+
+#ifdef HAVE_THREADS
+	/** Shared with the helpers, which may start after all calls are done */
+	struct State {
+		std::atomic<int> next{0};
+		std::mutex mutex;
+		std::condition_variable cv;
+		int remaining = 0;
+		const std::function<void(int)>* fn = nullptr;
+		int count = 0;
+	};
+	auto state = std::make_shared<State>();
+	state->remaining = count;
+	state->fn = &fn;
+	state->count = count;
+
+	auto run = [](State& s) {
+		int i;
+		while ((i = s.next++) < s.count) {
+			(*s.fn)(i);
+			std::lock_guard<std::mutex> lock(s.mutex);
+			if (--s.remaining == 0) {
+				s.cv.notify_all();
+			}
+		}
+	};
+
+	for (int i = 0; i < helpers; ++i) {
+		Submit([state, run]() { run(*state); }, Priority::High);
+	}
+	run(*state);
+
+	std::unique_lock<std::mutex> lock(state->mutex);
+	state->cv.wait(lock, [&]() { return state->remaining == 0; });
+#endif
+}
+
+void JobSystem::Update() {
+#ifdef HAVE_THREADS
+	std::vector<std::function<void()>> done;
+	{
+		std::lock_guard<std::mutex> lock(continuation_mutex);
+		if (continuations.empty()) {
+			return;
+		}
+		done.swap(continuations);
+	}
+
+	// Continuations can submit new jobs
+	for (auto& continuation: done) {
+		continuation();
+	}
+#endif
+}
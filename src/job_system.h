@@ -0,0 +1,111 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef EP_JOB_SYSTEM_H
+#define EP_JOB_SYSTEM_H
+
+// Headers
+#include <functional>
+#include <future>
+#include <memory>
+
+/**
+ * Worker threads shared by the engine subsystems.
+ * Every worker has its own queue, idle workers steal from the others.
+ * Player owns the workers, before Init and after Quit and on platforms
+ * without threads all jobs run at once on the calling thread.
+ */
+namespace JobSystem {
+	/** Order of the queued jobs of a worker, High runs first */
+	enum class Priority {
+		/** Blocks the caller, e.g. the bands of ParallelFor */
+		High,
+		/** Results are needed soon, e.g. image decoding */
+		Normal,
+		/** Background work, e.g. scanning directories */
+		Low
+	};
+
+	/**
+	 * Starts the workers.
+	 *
+	 * @param threads number of workers, -1 uses GetDefaultThreadCount
+	 */
+	void Init(int threads = -1);
+
+	/** Runs the queued jobs and stops the workers, pending continuations are dropped */
+	void Quit();
+
+	/** @return workers for the number of cores, limited by the platform */
+	int GetDefaultThreadCount();
+
+	/** @return number of running workers, 0 when jobs run on the calling thread */
+	int GetThreadCount();
+
+	/**
+	 * Queues a job on one of the workers.
+	 *
+	 * @param job function to call
+	 * @param priority order of the job in the queue
+	 */
+	void Submit(std::function<void()> job, Priority priority = Priority::Normal);
+
+	/**
+	 * Queues a job, continuation is called on the main thread by Update
+	 * after the job returned. Like the AsyncHandler callbacks the
+	 * continuation must check that its target still exists.
+	 * Without workers both are called before Submit returns.
+	 *
+	 * @param job function to call on a worker
+	 * @param continuation function to call on the main thread
+	 * @param priority order of the job in the queue
+	 */
+	void Submit(std::function<void()> job, std::function<void()> continuation, Priority priority = Priority::Normal);
+
+	/**
+	 * Queues a job and returns its result as future.
+	 *
+	 * @param fn function to call
+	 * @param priority order of the job in the queue
+	 * @return result of fn
+	 */
+	template <typename F>
+	auto Async(F fn, Priority priority = Priority::Normal) -> std::future<decltype(fn())>;
+
+	/**
+	 * Calls fn(i) for all i in [0, count) and waits until all calls returned.
+	 * The calling thread takes part.
+	 *
+	 * @param count number of calls
+	 * @param fn function to call
+	 */
+	void ParallelFor(int count, const std::function<void(int)>& fn);
+
+	/** Calls the continuations of the finished jobs. Called once per frame. */
+	void Update();
+}
+
+template <typename F>
+auto JobSystem::Async(F fn, Priority priority) -> std::future<decltype(fn())> {
+	auto task = std::make_shared<std::packaged_task<decltype(fn())()>>(std::move(fn));
+	auto future = task->get_future();
+	Submit([task]() { (*task)(); }, priority);
+	return future;
+}
+
+#endif
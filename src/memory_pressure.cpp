@@ -0,0 +1,87 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+// Headers
+#include <algorithm>
+#include <atomic>
+#include <vector>
+#include "memory_pressure.h"
+#include "memory_stats.h"
+#include "output.h"
+
+namespace {
+	struct Entry {
+		int id;
+		int priority;
+		MemoryPressure::TrimFunction fn;
+	};
+
+	/** Sorted by priority */
+	std::vector<Entry> entries;
+	int next_id = 0;
+
+	constexpr int no_signal = -1;
+	/** Highest level signaled since the last Update, the value of a Level */
+	std::atomic<int> pending{no_signal};
+
+	/** @return memory of the bitmaps and sound effects, the glyphs are included in the bitmaps */
+	int64_t GetCachedBytes() {
+		return MemoryStats::Get(MemoryStats::Category::Bitmap) + MemoryStats::Get(MemoryStats::Category::Audio);
+	}
+}
+
+int MemoryPressure::Register(int priority, TrimFunction fn) {
+	const int id = ++next_id;
+	auto it = std::upper_bound(entries.begin(), entries.end(), priority, [](int p, const Entry& entry) {
+		return p < entry.priority;
+	});
+	entries.insert(it, { id, priority, std::move(fn) });
+	return id;
+}
+
+void MemoryPressure::Unregister(int id) {
+	entries.erase(std::remove_if(entries.begin(), entries.end(), [id](const Entry& entry) {
+		return entry.id == id;
+	}), entries.end());
+}
+
+void MemoryPressure::Signal(Level level) {
+	int current = pending.load();
+	while (current < static_cast<int>(level) && !pending.compare_exchange_weak(current, static_cast<int>(level))) {
+	}
+}
+
+void MemoryPressure::Update() {
+	const int signaled = pending.exchange(no_signal);
+	if (signaled == no_signal) {
+		return;
+	}
+
+	const auto level = static_cast<Level>(signaled);
+	const int64_t before = GetCachedBytes();
+	for (auto& entry: entries) {
+		entry.fn(level);
+	}
+
+	Output::Debug("Low memory ({}): {} KiB freed", level == Level::Critical ? "critical" : "moderate",
+			(before - GetCachedBytes()) / 1024);
+}
+
+size_t MemoryPressure::GetFloor(Level level, size_t bytes) {
+	return level == Level::Critical ? 0 : bytes / 2;
+}
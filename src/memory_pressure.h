@@ -0,0 +1,80 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef EP_MEMORY_PRESSURE_H
+#define EP_MEMORY_PRESSURE_H
+
+// Headers
+#include <cstddef>
+#include <functional>
+
+/**
+ * Releases cached memory when the system runs low on memory.
+ *
+ * The platforms forward the low memory warnings of the OS with Signal.
+ * The caches register a trim function, they are trimmed on the main thread
+ * in the next frame instead of the app being killed.
+ */
+namespace MemoryPressure {
+	enum class Level {
+		/** Memory is getting low, caches are halved */
+		Moderate,
+		/** The app is about to be killed, everything unused is freed */
+		Critical
+	};
+
+	/** Frees memory of a cache */
+	using TrimFunction = std::function<void(Level)>;
+
+	/**
+	 * Registers a cache.
+	 *
+	 * @param priority caches with lower priorities are trimmed first,
+	 *   use them for data that is cheap to restore
+	 * @param fn called on the main thread with the level of the warning
+	 * @return id for Unregister
+	 */
+	int Register(int priority, TrimFunction fn);
+
+	/**
+	 * Removes a registered cache.
+	 *
+	 * @param id returned by Register
+	 */
+	void Unregister(int id);
+
+	/**
+	 * Reports a low memory warning of the OS. May be called from any
+	 * thread, the caches are trimmed by the next Update.
+	 *
+	 * @param level severity of the warning
+	 */
+	void Signal(Level level);
+
+	/** Trims all caches when a warning was signaled, called once per frame */
+	void Update();
+
+	/**
+	 * @param level severity of the warning
+	 * @param bytes current size of a cache
+	 * @return size the cache is trimmed to
+	 */
+	size_t GetFloor(Level level, size_t bytes);
+}
+
+#endif
@@ -0,0 +1,69 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include "memory_stats.h"
+#include "output.h"
+#include <array>
+#include <atomic>
+#include <lcf/rpg/eventcommand.h>
+
+namespace {
+	constexpr auto num_categories = static_cast<size_t>(MemoryStats::Category::END);
+
+	constexpr std::array<const char*, num_categories> category_names = {{
+		"Bitmap",
+		"Audio",
+		"Database",
+		"Map",
+		"Font",
+		"Interp"
+	}};
+
+	std::array<std::atomic<int64_t>, num_categories> sizes = {};
+}
+
+const char* MemoryStats::GetName(Category category) {
+	return category_names[static_cast<size_t>(category)];
+}
+
+void MemoryStats::Add(Category category, int64_t bytes) {
+	sizes[static_cast<size_t>(category)].fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void MemoryStats::Set(Category category, int64_t bytes) {
+	sizes[static_cast<size_t>(category)].store(bytes, std::memory_order_relaxed);
+}
+
+int64_t MemoryStats::Get(Category category) {
+	return sizes[static_cast<size_t>(category)].load(std::memory_order_relaxed);
+}
+
+void MemoryStats::Log() {
+	for (size_t i = 0; i < num_categories; ++i) {
+		const auto category = static_cast<Category>(i);
+		Output::Debug("Memory: {}: {:.2f} MiB", GetName(category), Get(category) / 1024.0 / 1024.0);
+	}
+}
+
+size_t MemoryStats::GetSize(const std::vector<lcf::rpg::EventCommand>& commands) {
+	size_t size = GetSize<lcf::rpg::EventCommand>(commands);
+	for (const auto& com: commands) {
+		size += com.string.size() + com.parameters.size() * sizeof(int32_t);
+	}
+	return size;
+}
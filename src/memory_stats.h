@@ -0,0 +1,100 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_MEMORY_STATS_H
+#define EP_MEMORY_STATS_H
+
+// Headers
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace lcf {
+namespace rpg {
+	class EventCommand;
+}
+}
+
+/**
+ * Bytes of memory used per category, shown in Scene_Debug and logged on
+ * demand. The sizes are tracked where the memory is allocated and are
+ * estimates for the lcf data.
+ */
+namespace MemoryStats {
+	/** Accounted categories */
+	enum class Category {
+		/** Pixel storage of all bitmaps */
+		Bitmap,
+		/** Decoded sound effects in the AudioSeCache */
+		Audio,
+		/** lcf database */
+		Database,
+		/** lcf data of the current map */
+		Map,
+		/** Glyph atlases, also included in Bitmap */
+		Font,
+		/** Event command stacks of the interpreters */
+		Interpreter,
+		END
+	};
+
+	/** @return name of the category */
+	const char* GetName(Category category);
+
+	/**
+	 * Adds to the size of a category, negative values for freed memory.
+	 * May be called from any thread.
+	 *
+	 * @param category category of the memory
+	 * @param bytes changed size
+	 */
+	void Add(Category category, int64_t bytes);
+
+	/**
+	 * Replaces the size of a category.
+	 *
+	 * @param category category of the memory
+	 * @param bytes new size
+	 */
+	void Set(Category category, int64_t bytes);
+
+	/** @return bytes used by the category */
+	int64_t Get(Category category);
+
+	/** Writes the size of all categories to the log */
+	void Log();
+
+	/**
+	 * @param commands event commands
+	 * @return estimated heap size of the commands
+	 */
+	size_t GetSize(const std::vector<lcf::rpg::EventCommand>& commands);
+
+	/**
+	 * @param v vector
+	 * @return size of the storage of the vector, excluding heap memory of the elements
+	 */
+	template <typename T>
+	size_t GetSize(const std::vector<T>& v);
+}
+
+template <typename T>
+inline size_t MemoryStats::GetSize(const std::vector<T>& v) {
+	return v.capacity() * sizeof(T);
+}
+
+#endif
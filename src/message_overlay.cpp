@@ -29,40 +29,44 @@ MessageOverlay::MessageOverlay() : Drawable(Priority_Overlay, Drawable::Flags::G
 	// Graphics::RegisterDrawable is in the Update function
 }
 
-void MessageOverlay::Draw(Bitmap& dst) {
-	if (!IsAnyMessageVisible() && !show_all) {
-		// Don't render overlay when no message visible
-		return;
+Rect MessageOverlay::GetDamage(const Rect&) {
+	const bool shown = IsShown();
+	if (shown == composited_shown && (!shown || !dirty)) {
+		return Rect();
 	}
 
-	dst.Blit(ox, oy, *bitmap, bitmap->GetRect(), 255);
+	return Rect(ox, oy, bitmap->GetWidth(), bitmap->GetHeight());
+}
 
-	if (!dirty) return;
+void MessageOverlay::OnComposited() {
+	composited_shown = IsShown();
+}
 
-	bitmap->Clear();
+void MessageOverlay::Draw(Bitmap& dst) {
+	if (!IsShown()) {
+		// Don't render overlay when no message visible
+		return;
+	}
 
-	int i = 0;
+	if (dirty) {
+		bitmap->Clear();
 
-	for (auto& message : messages) {
-		if (!message.hidden || show_all) {
-			bitmap->Blit(0, i * text_height, *black, black->GetRect(), 128);
+		int i = 0;
 
-			std::string text = message.text;
-			if (message.repeat_count > 0) {
-				text += " [" + std::to_string(message.repeat_count + 1) + "x]";
+		for (auto& message : messages) {
+			if (!message.hidden || show_all) {
+				if (!message.line) {
+					RenderLine(message);
+				}
+				bitmap->Blit(0, i * text_height, *message.line, message.line->GetRect(), 255);
+				++i;
 			}
-
-			bitmap->TextDraw(Rect(2,
-						i * text_height,
-						bitmap->GetWidth(),
-						text_height),
-				message.color,
-				text);
-			++i;
 		}
+
+		dirty = false;
 	}
 
-	dirty = false;
+	dst.Blit(ox, oy, *bitmap, bitmap->GetRect(), 255);
 }
 
 void MessageOverlay::AddMessage(const std::string& message, Color color) {
@@ -74,6 +78,7 @@ void MessageOverlay::AddMessage(const std::string& message, Color color) {
 		// The message matches the previous message -> increase counter
 		messages.back().repeat_count++;
 		messages.back().hidden = false;
+		ReleaseLine(messages.back());
 		// Keep the old message (with a new counter) on the screen
 		counter = 0;
 
@@ -92,6 +97,7 @@ void MessageOverlay::AddMessage(const std::string& message, Color color) {
 	);
 
 	while (messages.size() > (unsigned)message_max) {
+		ReleaseLine(messages.front());
 		messages.pop_front();
 	}
 
@@ -125,11 +131,41 @@ void MessageOverlay::Update() {
 	}
 }
 
+void MessageOverlay::RenderLine(MessageOverlayItem& message) {
+	if (!line_pool.empty()) {
+		message.line = std::move(line_pool.back());
+		line_pool.pop_back();
+		message.line->Clear();
+	} else {
+		message.line = Bitmap::Create(bitmap->GetWidth(), text_height, true);
+	}
+
+	message.line->Blit(0, 0, *black, black->GetRect(), 128);
+
+	std::string text = message.text;
+	if (message.repeat_count > 0) {
+		text += " [" + std::to_string(message.repeat_count + 1) + "x]";
+	}
+
+	message.line->TextDraw(Rect(2, 0, bitmap->GetWidth(), text_height), message.color, text);
+}
+
+void MessageOverlay::ReleaseLine(MessageOverlayItem& message) {
+	if (message.line) {
+		line_pool.push_back(std::move(message.line));
+		message.line = nullptr;
+	}
+}
+
 void MessageOverlay::SetShowAll(bool show_all) {
 	this->show_all = show_all;
 	dirty = true;
 }
 
+bool MessageOverlay::IsShown() const {
+	return bitmap && (show_all || IsAnyMessageVisible());
+}
+
 bool MessageOverlay::IsAnyMessageVisible() const {
 	return std::any_of(messages.cbegin(), messages.cend(), [](const MessageOverlayItem& m) { return !m.hidden; });
 }
@@ -20,6 +20,7 @@
 
 #include <deque>
 #include <string>
+#include <vector>
 #include "color.h"
 #include "drawable.h"
 #include "memory_management.h"
@@ -33,6 +34,8 @@ public:
 	Color color;
 	bool hidden = false;
 	int repeat_count = 0;
+	/** Text on its background, rendered on first draw and when the repeat count changes */
+	BitmapRef line;
 };
 
 /**
@@ -45,6 +48,9 @@ public:
 
 	void Draw(Bitmap& dst) override;
 
+	Rect GetDamage(const Rect& screen_rect) override;
+	void OnComposited() override;
+
 	void Update();
 
 	void AddMessage(const std::string& message, Color color);
@@ -53,6 +59,12 @@ public:
 
 private:
 	bool IsAnyMessageVisible() const;
+	bool IsShown() const;
+
+	/** Renders the line of the message into a bitmap of the pool */
+	void RenderLine(MessageOverlayItem& message);
+	/** Returns the line of the message to the pool */
+	void ReleaseLine(MessageOverlayItem& message);
 
 	BitmapRef bitmap;
 	BitmapRef black;
@@ -64,6 +76,8 @@ private:
 	int message_max = 10;
 
 	std::deque<MessageOverlayItem> messages;
+	/** Line bitmaps of removed messages */
+	std::vector<BitmapRef> line_pool;
 	/** Last message added to the console before linebreak processing */
 	std::string last_message;
 
@@ -72,6 +86,9 @@ private:
 	int counter = 0;
 
 	bool show_all = false;
+
+	/** Whether the overlay was visible in the last composited frame */
+	bool composited_shown = false;
 };
 
 #endif
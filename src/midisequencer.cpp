@@ -56,24 +56,25 @@ namespace midisequencer{
     }
 
     sequencer::sequencer():
-        position(messages.begin())
+        data(std::make_shared<sequence>())
     {
-        loop_position = position;
     }
     void sequencer::clear()
     {
-        messages.clear();
-        long_messages.clear();
-        position = messages.begin();
+        data = std::make_shared<sequence>();
+        position = 0;
     }
     void sequencer::rewind()
     {
-        position = messages.begin();
+        position = 0;
     }
     float sequencer::rewind_to_loop()
     {
-        position = loop_position;
-        return loop_position->time;
+        position = data->loop_index;
+        if(position >= data->messages.size()){
+            return get_total_time();
+        }
+        return data->messages[position].time;
     }
     bool sequencer::load(void* fp, int(*fgetc)(void*))
     {
@@ -84,15 +85,14 @@ namespace midisequencer{
         int b2 = fgetc(fp);
         int b3 = fgetc(fp);
         if(b0 == 0x4D && b1 == 0x54 && b2 == 0x68 && b3 == 0x64){
-            load_smf(fp, fgetc);
+            auto seq = std::make_shared<sequence>();
+            load_smf(*seq, fp, fgetc);
+            data = std::move(seq);
             result = true;
         }else{
             Output::Warning("Midi sequencer: unsupported format");
         }
-        if(!result){
-            clear();
-        }
-        position = messages.begin();
+        position = 0;
         return result;
     }
     static int fpfgetc(void* fp)
@@ -103,10 +103,20 @@ namespace midisequencer{
     {
         return load(fp, fpfgetc);
     }
+    std::shared_ptr<const sequence> sequencer::get_sequence()const
+    {
+        return data;
+    }
+    void sequencer::set_sequence(std::shared_ptr<const sequence> seq)
+    {
+        assert(seq);
+        data = std::move(seq);
+        position = 0;
+    }
     int sequencer::get_num_ports()const
     {
         int ret = 0;
-        for(std::vector<midi_message>::const_iterator i = messages.begin(); i != messages.end(); ++i){
+        for(std::vector<midi_message>::const_iterator i = data->messages.begin(); i != data->messages.end(); ++i){
             if(ret < i->port){
                 ret = i->port;
             }
@@ -115,18 +125,18 @@ namespace midisequencer{
     }
     float sequencer::get_total_time()const
     {
-        if(messages.empty()){
+        if(data->messages.empty()){
             return 0;
         }else{
-            return messages.back().time;
+            return data->messages.back().time;
         }
     }
     std::string sequencer::get_title()const
     {
-        for(std::vector<midi_message>::const_iterator i = messages.begin(); i != messages.end(); ++i){
+        for(std::vector<midi_message>::const_iterator i = data->messages.begin(); i != data->messages.end(); ++i){
             if(i->track == 0 && (i->message & 0xFF) == 0xFF){
-                assert((i->message >> 8) < long_messages.size());
-                const std::string& s = long_messages[i->message >> 8];
+                assert((i->message >> 8) < data->long_messages.size());
+                const std::string& s = data->long_messages[i->message >> 8];
                 if(s.size() > 1 && s[0] == 0x03){
                     return s.substr(1);
                 }
@@ -136,10 +146,10 @@ namespace midisequencer{
     }
     std::string sequencer::get_copyright()const
     {
-        for(std::vector<midi_message>::const_iterator i = messages.begin(); i != messages.end(); ++i){
+        for(std::vector<midi_message>::const_iterator i = data->messages.begin(); i != data->messages.end(); ++i){
             if(i->track == 0 && (i->message & 0xFF) == 0xFF){
-                assert((i->message >> 8) < long_messages.size());
-                const std::string& s = long_messages[i->message >> 8];
+                assert((i->message >> 8) < data->long_messages.size());
+                const std::string& s = data->long_messages[i->message >> 8];
                 if(s.size() > 1 && s[0] == 0x02){
                     return s.substr(1);
                 }
@@ -150,10 +160,10 @@ namespace midisequencer{
     std::string sequencer::get_song()const
     {
         std::string ret;
-        for(std::vector<midi_message>::const_iterator i = messages.begin(); i != messages.end(); ++i){
+        for(std::vector<midi_message>::const_iterator i = data->messages.begin(); i != data->messages.end(); ++i){
             if(i->track == 0 && (i->message & 0xFF) == 0xFF){
-                assert((i->message >> 8) < long_messages.size());
-                const std::string& s = long_messages[i->message >> 8];
+                assert((i->message >> 8) < data->long_messages.size());
+                const std::string& s = data->long_messages[i->message >> 8];
                 assert(s.size() >= 1);
                 if(s[0] == 0x05){
                     ret += s.substr(1);
@@ -162,91 +172,71 @@ namespace midisequencer{
         }
         return ret;
     }
+    void sequencer::dispatch(const midi_message& msg, output* out)const
+    {
+        uint_least32_t message = msg.message;
+        switch(message & 0xFF){
+        case 0xF0:
+            {
+                assert((message >> 8) < data->long_messages.size());
+                const std::string& s = data->long_messages[static_cast<int>(message >> 8)];
+                out->sysex_message(msg.port, s.data(), s.size());
+            }
+            break;
+        case 0xFF:
+            {
+                assert((message >> 8) < data->long_messages.size());
+                const std::string& s = data->long_messages[static_cast<int>(message >> 8)];
+                assert(s.size() >= 1);
+                out->meta_event(static_cast<unsigned char>(s[0]), s.data() + 1, s.size() - 1);
+            }
+            break;
+        default:
+            out->midi_message(msg.port, message);
+            break;
+        }
+    }
     void sequencer::play(float time, output* out)
     {
-        if(position != messages.begin() && (position - 1)->time >= time){
-            position = messages.begin();
+        const std::vector<midi_message>& messages = data->messages;
+        if(position != 0 && messages[position - 1].time >= time){
+            position = 0;
         }
-        if(position == messages.begin() && position != messages.end() && position->time < time){
+        if(position == 0 && position != messages.size() && messages[position].time < time){
             out->reset();
         }
 
-        while(position != messages.end() && position->time < time){
-            uint_least32_t message = position->message;
-            int port = position->port;
-            ++position;
-
-            switch(message & 0xFF){
-            case 0xF0:
-                {
-                    assert((message >> 8) < long_messages.size());
-                    const std::string& s = long_messages[static_cast<int>(message >> 8)];
-                    out->sysex_message(port, s.data(), s.size());
-                }
-                break;
-            case 0xFF:
-                {
-                    assert((message >> 8) < long_messages.size());
-                    const std::string& s = long_messages[static_cast<int>(message >> 8)];
-                    assert(s.size() >= 1);
-                    out->meta_event(static_cast<unsigned char>(s[0]), s.data() + 1, s.size() - 1);
-                }
-                break;
-            default:
-                out->midi_message(port, message);
-                break;
-            }
+        while(position != messages.size() && messages[position].time < time){
+            dispatch(messages[position++], out);
         }
     }
 
     void sequencer::set_time(float time, output* out)
     {
-        if(position != messages.begin() && (position - 1)->time >= time){
-            position = messages.begin();
-        }
-        if(position == messages.begin() && position != messages.end() && position->time < time){
+        // Binary search for the target, then replay only the channel state
+        // (programs, controllers, sysex and meta events). Notes before the
+        // target are skipped instead of being synthesized.
+        const std::vector<midi_message>& messages = data->messages;
+        midi_message key;
+        key.time = time;
+        std::size_t target = std::lower_bound(messages.begin(), messages.end(), key) - messages.begin();
+
+        std::size_t start = position;
+        if(target < position || position == 0){
             out->reset();
+            start = 0;
         }
-
-        if(position->time > time)
-            position = messages.begin();
-
-        while(position != messages.end() && position->time < time){
-            uint_least32_t message = position->message;
-            int port = position->port;
-            ++position;
-
-            switch(message & 0xFF){
-                case 0xF0:
-                {
-                    assert((message >> 8) < long_messages.size());
-                    const std::string& s = long_messages[static_cast<int>(message >> 8)];
-                    out->sysex_message(port, s.data(), s.size());
-                }
-                    break;
-                case 0xFF:
-                {
-                    assert((message >> 8) < long_messages.size());
-                    const std::string& s = long_messages[static_cast<int>(message >> 8)];
-                    assert(s.size() >= 1);
-                    out->meta_event(static_cast<unsigned char>(s[0]), s.data() + 1, s.size() - 1);
-                }
-                    break;
-                default:
-
-                    if((message & 0xF0) == 0x80 || (message & 0xF0) == 0x90)
-                    {
-                        out->meta_event(META_EVENT_ALL_NOTE_OFF, NULL, 0);
-                        break;
-                    }
-
-                    out->midi_message(port, message);
-                    break;
+        for(std::size_t i = start; i < target; ++i){
+            uint_least32_t status = messages[i].message & 0xF0;
+            if(status != 0x80 && status != 0x90 && status != 0xA0){
+                dispatch(messages[i], out);
             }
         }
+        out->meta_event(META_EVENT_ALL_NOTE_OFF, NULL, 0);
+        position = target;
     }
 
-    void sequencer::load_smf(void* fp, int(*fgetc)(void*))
+    void sequencer::load_smf(sequence& seq, void* fp, int(*fgetc)(void*))
     {
         if(fgetc(fp) != 0
         || fgetc(fp) != 0
@@ -264,7 +254,7 @@ namespace midisequencer{
         unsigned num_tracks = (t0 << 8) | t1;
         int d0 = fgetc(fp);
         int d1 = fgetc(fp);
-        division = (d0 << 8) | d1;
+        seq.division = (d0 << 8) | d1;
         for(unsigned track = 0; track < num_tracks; ++track){
             if(fgetc(fp) != 0x4D || fgetc(fp) != 0x54 || fgetc(fp) != 0x72 || fgetc(fp) != 0x6B){
                 Output::Warning("Midi sequencer: invalid track header");
@@ -289,9 +279,9 @@ namespace midisequencer{
                 }
                 uint_least32_t delta = read_variable_value(fp, fgetc, &track_length, "unexpected EOF (deltatime)");
                 time += delta;
-                if(division & 0x8000){
-                    int fps = ~(division >> 8) + 1;
-                    int frames = division & 0xFF;
+                if(seq.division & 0x8000){
+                    int fps = ~(seq.division >> 8) + 1;
+                    int frames = seq.division & 0xFF;
                     msg.time = time / (frames * fps) + time_offset;
                 }else{
                     msg.time = time;
@@ -311,9 +301,9 @@ namespace midisequencer{
                             Output::Warning("Midi sequencer: missing sysex terminator");
                         }
                         track_length -= n;
-                        msg.message = 0xF0 | (long_messages.size() << 8);
-                        messages.push_back(msg);
-                        long_messages.push_back(s);
+                        msg.message = 0xF0 | (seq.long_messages.size() << 8);
+                        seq.messages.push_back(msg);
+                        seq.long_messages.push_back(s);
                     }
                     break;
                 case 0xF7:
@@ -326,9 +316,9 @@ namespace midisequencer{
                             s[i] = fgetc(fp);
                         }
                         track_length -= n;
-                        msg.message = 0xF0 | (long_messages.size() << 8);
-                        messages.push_back(msg);
-                        long_messages.push_back(s);
+                        msg.message = 0xF0 | (seq.long_messages.size() << 8);
+                        seq.messages.push_back(msg);
+                        seq.long_messages.push_back(s);
                     }
                     */
                     break;
@@ -343,9 +333,9 @@ namespace midisequencer{
                             s[i] = static_cast<char>(fgetc(fp));
                         }
                         track_length -= n;
-                        msg.message = 0xFF | (long_messages.size() << 8);
-                        messages.push_back(msg);
-                        long_messages.push_back(s);
+                        msg.message = 0xFF | (seq.long_messages.size() << 8);
+                        seq.messages.push_back(msg);
+                        seq.long_messages.push_back(s);
                         switch(type){
                         case 0x21:
                             if(n == 1){
@@ -358,7 +348,7 @@ namespace midisequencer{
                             if(n != 5){
                                 Output::Warning("Midi sequencer: invalid SMTPE offset metaevent length");
                             }
-                            if(msg.time == 0 && (division & 0x8000)){
+                            if(msg.time == 0 && (seq.division & 0x8000)){
                                 int hour = static_cast<unsigned char>(s[1]);
                                 int min = static_cast<unsigned char>(s[2]);
                                 int sec = static_cast<unsigned char>(s[3]);
@@ -409,7 +399,7 @@ namespace midisequencer{
                     default:
                         Output::Warning("Midi sequencer: invalid midi message");
                     }
-                    messages.push_back(msg);
+                    seq.messages.push_back(msg);
                     break;
                 }
             }
@@ -421,18 +411,18 @@ namespace midisequencer{
                 --track_length;
             }
         }
-        std::stable_sort(messages.begin(), messages.end());
-        if(!(division & 0x8000)){
+        std::stable_sort(seq.messages.begin(), seq.messages.end());
+        if(!(seq.division & 0x8000)){
             uint_least32_t tempo = 500000;
             double time_offset = 0;
             double base = 0;
-            loop_position = messages.begin();
-            for(std::vector<midi_message>::iterator i = messages.begin(); i != messages.end(); ++i){
+            seq.loop_index = 0;
+            for(std::vector<midi_message>::iterator i = seq.messages.begin(); i != seq.messages.end(); ++i){
                 float org_time = i->time;
-                i->time = (i->time - base) * tempo / 1000000.0 / division + time_offset;
+                i->time = (i->time - base) * tempo / 1000000.0 / seq.division + time_offset;
                 if((i->message & 0xFF) == 0xFF){
-                    assert((i->message >> 8) < long_messages.size());
-                    const std::string& s = long_messages[i->message >> 8];
+                    assert((i->message >> 8) < seq.long_messages.size());
+                    const std::string& s = seq.long_messages[i->message >> 8];
                     if(s.size() == 4 && s[0] == 0x51){
                         tempo = (static_cast<uint_least32_t>(static_cast<unsigned char>(s[1])) << 16)
                               | (static_cast<unsigned char>(s[2]) << 8)
@@ -446,8 +436,8 @@ namespace midisequencer{
                 if ((i->message & 0xFFFF) == 0x6FB0) {
                     // Loop backwards through the messages to find the first message with the same
                     // timestamp as the loop message
-                    for (std::vector<midi_message>::iterator j = i; j != messages.begin() && j->time >= i->time; j--) {
-                        loop_position = j;
+                    for (std::vector<midi_message>::iterator j = i; j != seq.messages.begin() && j->time >= i->time; j--) {
+                        seq.loop_index = j - seq.messages.begin();
                     }
                 }
             }
@@ -455,6 +445,6 @@ namespace midisequencer{
     }
 
 	uint32_t sequencer::get_division() const {
-		return division;
+		return data->division;
 	}
 }
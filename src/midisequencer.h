@@ -30,6 +30,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <stdint.h>
 #include <cstdio>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -46,6 +47,14 @@ namespace midisequencer{
         int track;
     };
 
+    // Parsed SMF data, sorted by time. Can be shared by several sequencers.
+    struct sequence{
+        std::vector<midi_message> messages;
+        std::vector<std::string> long_messages;
+        std::size_t loop_index = 0;
+        uint32_t division = 0;
+    };
+
     class uncopyable{
     public:
         uncopyable(){}
@@ -80,13 +89,13 @@ namespace midisequencer{
         uint32_t get_division()const;
         void play(float time, output* out);
         void set_time(float time, output* out);
+        std::shared_ptr<const sequence> get_sequence()const;
+        void set_sequence(std::shared_ptr<const sequence> seq);
     private:
-        std::vector<midi_message> messages;
-        std::vector<midi_message>::iterator position;
-        std::vector<midi_message>::iterator loop_position;
-        std::vector<std::string> long_messages;
-        uint32_t division = 0;
-        void load_smf(void* fp, int(*fgetc)(void*));
+        std::shared_ptr<const sequence> data;
+        std::size_t position = 0;
+        void dispatch(const midi_message& msg, output* out)const;
+        static void load_smf(sequence& seq, void* fp, int(*fgetc)(void*));
     };
 }
 
@@ -1263,8 +1263,9 @@ namespace midisynth{
             return true;
         }
     }
-    // Gets the next sample.
-    int fm_sound_generator::get_next()
+    // Gets the next sample of the given algorithm.
+    template<int alg, bool ams_on>
+    inline int fm_sound_generator::next_sample()
     {
         if(vibrato_depth){
             int x = static_cast<int_least32_t>(vibrato_lfo.get_next()) * vibrato_depth >> 15;
@@ -1276,9 +1277,9 @@ namespace midisynth{
         }
         int feedback = (this->feedback << 1) >> FB;
         int ret;
-        if(ams_enable){
+        if(ams_on){
             int ams = ams_lfo.get_next() >> 7;
-            switch(ALG){
+            switch(alg){
             case 0:
                 ret = op4(ams, op3(ams, op2(ams, this->feedback = op1(ams, feedback))));
                 break;
@@ -1309,7 +1310,7 @@ namespace midisynth{
                 return 0;
             }
         }else{
-            switch(ALG){
+            switch(alg){
             case 0:
                 ret = op4(op3(op2(this->feedback = op1(feedback))));
                 break;
@@ -1347,6 +1348,47 @@ namespace midisynth{
         return ret;
     }
 
+    // Gets the next sample.
+    int fm_sound_generator::get_next()
+    {
+        int_least32_t ret;
+        render(&ret, 1);
+        return ret;
+    }
+    // Renders a block of samples. The algorithm is selected once per block.
+    void fm_sound_generator::render(int_least32_t* buf, std::size_t samples)
+    {
+        switch(ALG * 2 + (ams_enable ? 1 : 0)){
+        case 0: render_block<0, false>(buf, samples); break;
+        case 1: render_block<0, true>(buf, samples); break;
+        case 2: render_block<1, false>(buf, samples); break;
+        case 3: render_block<1, true>(buf, samples); break;
+        case 4: render_block<2, false>(buf, samples); break;
+        case 5: render_block<2, true>(buf, samples); break;
+        case 6: render_block<3, false>(buf, samples); break;
+        case 7: render_block<3, true>(buf, samples); break;
+        case 8: render_block<4, false>(buf, samples); break;
+        case 9: render_block<4, true>(buf, samples); break;
+        case 10: render_block<5, false>(buf, samples); break;
+        case 11: render_block<5, true>(buf, samples); break;
+        case 12: render_block<6, false>(buf, samples); break;
+        case 13: render_block<6, true>(buf, samples); break;
+        case 14: render_block<7, false>(buf, samples); break;
+        case 15: render_block<7, true>(buf, samples); break;
+        default:
+            assert(!"fm_sound_generator: invalid algorithm number");
+            std::fill(buf, buf + samples, 0);
+            break;
+        }
+    }
+    template<int alg, bool ams_on>
+    void fm_sound_generator::render_block(int_least32_t* buf, std::size_t samples)
+    {
+        for(std::size_t i = 0; i < samples; ++i){
+            buf[i] = next_sample<alg, ams_on>();
+        }
+    }
+
     // FM notes constructor.
     fm_note::fm_note(const FMPARAMETER& params, int note, int velocity_, int panpot, int assign, float frequency_multiplier):
         midisynth::note(assign, panpot),
@@ -1362,10 +1404,18 @@ namespace midisynth{
         left = (left * velocity) >> 7;
         right = (right * velocity) >> 7;
         fm.set_rate(rate);
-        for(std::size_t i = 0; i < samples; ++i){
-            int_least32_t sample = fm.get_next();
-            buf[i * 2 + 0] += (sample * left) >> 14;
-            buf[i * 2 + 1] += (sample * right) >> 14;
+        // Render the voice in blocks, panning is a separate loop the compiler can vectorize
+        int_least32_t block[256];
+        while(samples > 0){
+            std::size_t n = std::min(samples, sizeof(block) / sizeof(block[0]));
+            fm.render(block, n);
+            for(std::size_t i = 0; i < n; ++i){
+                int_least32_t sample = block[i];
+                buf[i * 2 + 0] += (sample * left) >> 14;
+                buf[i * 2 + 1] += (sample * right) >> 14;
+            }
+            buf += n * 2;
+            samples -= n;
         }
         return !fm.is_finished();
     }
@@ -343,7 +343,10 @@ namespace midisynth{
         void sound_off();
         bool is_finished()const;
         int get_next();
+        void render(int_least32_t* buf, std::size_t samples);
     private:
+        template<int alg, bool ams_on> void render_block(int_least32_t* buf, std::size_t samples);
+        template<int alg, bool ams_on> int next_sample();
         fm_operator op1;
         fm_operator op2;
         fm_operator op3;
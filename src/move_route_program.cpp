@@ -0,0 +1,133 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include "move_route_program.h"
+#include "string_view.h"
+#include <unordered_map>
+#include <unordered_set>
+
+namespace {
+	/** Cached programs by route content, programs live as long as a character uses them */
+	std::unordered_map<std::string, std::weak_ptr<const MoveRouteProgram>> programs;
+	/** Size of the cache after the last removal of expired programs */
+	size_t programs_pruned_size = 0;
+	constexpr size_t min_prune_size = 64;
+
+	/** Sprite names of all programs, never freed as the number of charsets is small */
+	std::unordered_set<std::string> sprite_names;
+
+	void AppendInt(std::string& key, int32_t value) {
+		key.append(reinterpret_cast<const char*>(&value), sizeof(value));
+	}
+
+	std::string MakeKey(const lcf::rpg::MoveRoute& route) {
+		std::string key;
+		for (const auto& cmd : route.move_commands) {
+			AppendInt(key, cmd.command_id);
+			AppendInt(key, cmd.parameter_a);
+			AppendInt(key, cmd.parameter_b);
+			AppendInt(key, cmd.parameter_c);
+			AppendInt(key, static_cast<int32_t>(cmd.parameter_string.size()));
+			key.append(cmd.parameter_string.data(), cmd.parameter_string.size());
+		}
+		return key;
+	}
+
+	void PruneExpired() {
+		for (auto it = programs.begin(); it != programs.end();) {
+			if (it->second.expired()) {
+				it = programs.erase(it);
+			} else {
+				++it;
+			}
+		}
+		programs_pruned_size = programs.size();
+	}
+}
+
+MoveRouteProgram::MoveRouteProgram(const lcf::rpg::MoveRoute& route) {
+	ops.resize(route.move_commands.size());
+
+	int32_t next_end_jump = -1;
+	for (int i = static_cast<int>(route.move_commands.size()) - 1; i >= 0; --i) {
+		const auto& cmd = route.move_commands[i];
+		auto& op = ops[i];
+		op.code = static_cast<Code>(cmd.command_id);
+
+		switch (op.code) {
+			case Code::switch_on:
+			case Code::switch_off:
+				op.param = cmd.parameter_a;
+				break;
+			case Code::begin_jump:
+				op.jump_end = next_end_jump;
+				break;
+			case Code::end_jump:
+				next_end_jump = i;
+				break;
+			case Code::change_graphic:
+				op.param = cmd.parameter_a;
+				op.name = &*sprite_names.insert(ToString(cmd.parameter_string)).first;
+				break;
+			case Code::play_sound_effect:
+				if (cmd.parameter_string != "(OFF)" && cmd.parameter_string != "(Brak)") {
+					lcf::rpg::Sound sound;
+					sound.name = ToString(cmd.parameter_string);
+					sound.volume = cmd.parameter_a;
+					sound.tempo = cmd.parameter_b;
+					sound.balance = cmd.parameter_c;
+					op.param = static_cast<int32_t>(sounds.size());
+					sounds.push_back(std::move(sound));
+				} else {
+					op.param = -1;
+				}
+				break;
+			default:
+				break;
+		}
+	}
+}
+
+std::shared_ptr<const MoveRouteProgram> MoveRouteProgram::Get(const lcf::rpg::MoveRoute& route) {
+	auto key = MakeKey(route);
+
+	auto it = programs.find(key);
+	if (it != programs.end()) {
+		if (auto program = it->second.lock()) {
+			return program;
+		}
+	}
+
+	auto program = std::make_shared<const MoveRouteProgram>(route);
+	programs[std::move(key)] = program;
+
+	if (programs.size() >= min_prune_size && programs.size() >= programs_pruned_size * 2) {
+		PruneExpired();
+	}
+
+	return program;
+}
+
+void MoveRouteProgram::ClearCache() {
+	programs.clear();
+	programs_pruned_size = 0;
+}
+
+int MoveRouteProgram::GetCacheSize() {
+	return static_cast<int>(programs.size());
+}
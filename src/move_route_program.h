@@ -0,0 +1,88 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_MOVE_ROUTE_PROGRAM_H
+#define EP_MOVE_ROUTE_PROGRAM_H
+
+// Headers
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <lcf/rpg/movecommand.h>
+#include <lcf/rpg/moveroute.h>
+#include <lcf/rpg/sound.h>
+
+/**
+ * Move route prepared for execution by Game_Character::UpdateMoveRoute.
+ * Every command of the route becomes one op at the same index, so the
+ * move route index of the save data applies to both.
+ * Programs are immutable and shared by all characters using an identical route.
+ */
+class MoveRouteProgram {
+public:
+	using Code = lcf::rpg::MoveCommand::Code;
+
+	struct Op {
+		Code code = Code::move_up;
+		/** Switch ID, graphic index or index into the sounds, -1 for a disabled sound */
+		int32_t param = 0;
+		/** For begin_jump: Index of the next end_jump, -1 when the route has none */
+		int32_t jump_end = -1;
+		/** For change_graphic: Interned sprite name */
+		const std::string* name = nullptr;
+	};
+
+	/**
+	 * Returns the program of a move route, compiling it on first use.
+	 *
+	 * @param route move route
+	 * @return shared program
+	 */
+	static std::shared_ptr<const MoveRouteProgram> Get(const lcf::rpg::MoveRoute& route);
+
+	/** Removes all cached programs, programs still in use stay valid */
+	static void ClearCache();
+
+	/** @return number of cached programs */
+	static int GetCacheSize();
+
+	/** @return ops, one per move command */
+	const std::vector<Op>& GetOps() const;
+
+	/**
+	 * @param op a play_sound_effect op with param >= 0
+	 * @return the sound to play
+	 */
+	const lcf::rpg::Sound& GetSound(const Op& op) const;
+
+	explicit MoveRouteProgram(const lcf::rpg::MoveRoute& route);
+
+private:
+	std::vector<Op> ops;
+	std::vector<lcf::rpg::Sound> sounds;
+};
+
+inline const std::vector<MoveRouteProgram::Op>& MoveRouteProgram::GetOps() const {
+	return ops;
+}
+
+inline const lcf::rpg::Sound& MoveRouteProgram::GetSound(const Op& op) const {
+	return sounds[op.param];
+}
+
+#endif
@@ -82,6 +82,15 @@
 /** Default fps rate. */
 #define DEFAULT_FPS 60
 
+/** Default size limit of the bitmap cache in MiB. */
+#if defined(_3DS)
+#  define DEFAULT_CACHE_SIZE 4
+#elif defined(PSP2) || defined(__SWITCH__) || defined(EMSCRIPTEN)
+#  define DEFAULT_CACHE_SIZE 10
+#else
+#  define DEFAULT_CACHE_SIZE 64
+#endif
+
 /** Enables or disables font smoothing. */
 #define FONT_SMOOTHING 0
 
@@ -25,6 +25,11 @@
 #include <fstream>
 #include <thread>
 #include <chrono>
+#include <vector>
+#ifdef HAVE_THREADS
+#  include <condition_variable>
+#  include <mutex>
+#endif
 
 #include "graphics.h"
 
@@ -51,6 +56,8 @@
 #include "utils.h"
 #include "font.h"
 #include "baseui.h"
+#include "image_png.h"
+#include "thread_affinity.h"
 
 using namespace std::chrono_literals;
 
@@ -70,7 +77,19 @@ namespace {
 	Filesystem_Stream::OutputStream LOG_FILE;
 	bool init = false;
 
-	std::ostream& output_time() {
+#ifdef HAVE_THREADS
+	/** Messages of other threads, written by WriteThreadMessages */
+	struct ThreadMessage {
+		LogLevel lvl;
+		std::string msg;
+		Color color;
+	};
+	const std::thread::id main_thread_id = std::this_thread::get_id();
+	std::mutex thread_messages_mutex;
+	std::vector<ThreadMessage> thread_messages;
+#endif
+
+	std::string output_time() {
 		if (!init) {
 			LOG_FILE = FileFinder::OpenOutputStream(FileFinder::MakePath(Main_Data::GetSavePath(), OUTPUT_FILENAME), std::ios_base::out | std::ios_base::app);
 			init = true;
@@ -78,11 +97,248 @@ namespace {
 		std::time_t t = std::time(NULL);
 		char timestr[100];
 		strftime(timestr, 100, "[%Y-%m-%d %H:%M:%S] ", std::localtime(&t));
-		return LOG_FILE << timestr;
+		return timestr;
+	}
+
+	/** A line for the log file or a message for the console */
+	struct LogLine {
+		LogLevel lvl;
+		bool file;
+		std::string text;
+	};
+
+	void WriteLine(const LogLine& line) {
+		if (line.file) {
+			LOG_FILE << line.text << '\n';
+			return;
+		}
+#ifdef __ANDROID__
+		__android_log_print(line.lvl == LogLevel::Error ? ANDROID_LOG_ERROR : ANDROID_LOG_INFO, "EasyRPG Player", "%s", line.text.c_str());
+#else
+		std::cerr << GetLogPrefix(line.lvl) << line.text << '\n';
+#endif
+	}
+
+	/** The log file is only touched after a line for it was written, it is opened by the main thread */
+	void FlushLines(bool file) {
+		if (file) {
+			LOG_FILE.flush();
+		}
+		std::cerr.flush();
+	}
+
+#ifdef HAVE_THREADS
+	/**
+	 * Writes the lines of the main thread in a background thread,
+	 * the game does not wait for the file and console.
+	 */
+	class LogWriter {
+	public:
+		~LogWriter();
+
+		void Push(LogLine line);
+
+		/** Writes the pending lines, later lines are written directly */
+		void Stop();
+
+	private:
+		void Run();
+
+		std::thread thread;
+		std::mutex mutex;
+		std::condition_variable cv;
+		std::vector<LogLine> lines;
+		bool stopped = false;
+	};
+
+	LogWriter::~LogWriter() {
+		Stop();
+	}
+
+	void LogWriter::Push(LogLine line) {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			if (!stopped) {
+				if (!thread.joinable()) {
+					thread = std::thread([this]() { Run(); });
+				}
+				lines.push_back(std::move(line));
+				cv.notify_one();
+				return;
+			}
+		}
+		WriteLine(line);
+		FlushLines(line.file);
+	}
+
+	void LogWriter::Stop() {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopped = true;
+		}
+		cv.notify_one();
+		if (thread.joinable()) {
+			thread.join();
+		}
+	}
+
+	void LogWriter::Run() {
+		ThreadAffinity::Apply(ThreadAffinity::Role::Worker);
+		std::vector<LogLine> batch;
+		std::unique_lock<std::mutex> lock(mutex);
+		while (true) {
+			cv.wait(lock, [this]() { return stopped || !lines.empty(); });
+			if (lines.empty()) {
+				return;
+			}
+			batch.swap(lines);
+			lock.unlock();
+
+			// One flush per batch instead of one per line
+			bool file = false;
+			for (const auto& line : batch) {
+				WriteLine(line);
+				file |= line.file;
+			}
+			FlushLines(file);
+			batch.clear();
+
+			lock.lock();
+		}
+	}
+
+	LogWriter log_writer;
+#endif
+
+	void PushLine(LogLevel lvl, bool file, std::string text) {
+#ifdef HAVE_THREADS
+		log_writer.Push({ lvl, file, std::move(text) });
+#else
+		WriteLine({ lvl, file, std::move(text) });
+		FlushLines(file);
+#endif
 	}
 
 	bool ignore_pause = false;
 
+	int screenshot_compression = -1;
+	/** Next screenshot number to try, pending screenshots keep their number */
+	int screenshot_index = 0;
+
+#ifdef HAVE_THREADS
+	/** A copied frame waiting for encoding */
+	struct Screenshot {
+		Filesystem_Stream::OutputStream os;
+		uint32_t width;
+		uint32_t height;
+		int compression;
+		std::vector<uint32_t> pixels;
+	};
+
+	/** Encodes screenshots in a background thread, the pixel buffers are reused */
+	class ScreenshotWriter {
+	public:
+		~ScreenshotWriter();
+
+		/** @return a buffer for the pixels of the next screenshot */
+		std::vector<uint32_t> GetBuffer();
+
+		void Push(Screenshot shot);
+
+		/** Writes the pending screenshots, later ones are written directly */
+		void Stop();
+
+	private:
+		void Run();
+		static void Write(Screenshot& shot);
+
+		/** Buffers kept for reuse, enough for a burst of captures */
+		static constexpr size_t max_buffers = 2;
+
+		std::thread thread;
+		std::mutex mutex;
+		std::condition_variable cv;
+		std::vector<Screenshot> shots;
+		std::vector<std::vector<uint32_t>> buffers;
+		bool stopped = false;
+	};
+
+	constexpr size_t ScreenshotWriter::max_buffers;
+
+	ScreenshotWriter::~ScreenshotWriter() {
+		Stop();
+	}
+
+	std::vector<uint32_t> ScreenshotWriter::GetBuffer() {
+		std::lock_guard<std::mutex> lock(mutex);
+		if (buffers.empty()) {
+			return {};
+		}
+		auto buffer = std::move(buffers.back());
+		buffers.pop_back();
+		return buffer;
+	}
+
+	void ScreenshotWriter::Push(Screenshot shot) {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			if (!stopped) {
+				if (!thread.joinable()) {
+					thread = std::thread([this]() { Run(); });
+				}
+				shots.push_back(std::move(shot));
+				cv.notify_one();
+				return;
+			}
+		}
+		Write(shot);
+	}
+
+	void ScreenshotWriter::Stop() {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopped = true;
+		}
+		cv.notify_one();
+		if (thread.joinable()) {
+			thread.join();
+		}
+	}
+
+	void ScreenshotWriter::Write(Screenshot& shot) {
+		ImagePNG::WritePNG(shot.os, shot.width, shot.height, shot.pixels.data(), shot.compression);
+		shot.os.flush();
+	}
+
+	void ScreenshotWriter::Run() {
+		ThreadAffinity::Apply(ThreadAffinity::Role::Worker);
+		std::vector<Screenshot> batch;
+		std::unique_lock<std::mutex> lock(mutex);
+		while (true) {
+			cv.wait(lock, [this]() { return stopped || !shots.empty(); });
+			if (shots.empty()) {
+				return;
+			}
+			batch.swap(shots);
+			lock.unlock();
+
+			for (auto& shot : batch) {
+				Write(shot);
+			}
+
+			lock.lock();
+			for (auto& shot : batch) {
+				if (buffers.size() < max_buffers) {
+					buffers.push_back(std::move(shot.pixels));
+				}
+			}
+			batch.clear();
+		}
+	}
+
+	ScreenshotWriter screenshot_writer;
+#endif
+
 	std::vector<std::string> log_buffer;
 	// pair of repeat count + message
 	struct {
@@ -91,6 +347,15 @@ namespace {
 		LogLevel lvl = {};
 	} last_message;
 
+	/** Identical messages in a row are written to the console at most once per interval */
+	constexpr auto console_repeat_interval = 1s;
+	struct {
+		int skipped = 0;
+		std::string msg;
+		LogLevel lvl = {};
+		std::chrono::steady_clock::time_point time;
+	} last_console_message;
+
 #ifdef GEKKO
 	/* USBGecko Debugging on Wii */
 	bool usbgecko = false;
@@ -133,6 +398,15 @@ void Output::IgnorePause(bool const val) {
 }
 
 static void WriteLog(LogLevel lvl, std::string const& msg, Color const& c = Color()) {
+#ifdef HAVE_THREADS
+	if (std::this_thread::get_id() != main_thread_id) {
+		// The log file and the overlay are only used by the main thread
+		std::lock_guard<std::mutex> lock(thread_messages_mutex);
+		thread_messages.push_back({ lvl, msg, c });
+		return;
+	}
+#endif
+
 	const char* prefix = GetLogPrefix(lvl);
 	// Skip logging to file in the browser
 #ifndef EMSCRIPTEN
@@ -140,7 +414,7 @@ static void WriteLog(LogLevel lvl, std::string const& msg, Color const& c = Colo
 		// Only write to file when project path is initialized
 		// (happens after parsing the command line)
 		for (std::string& log : log_buffer) {
-			output_time() << log << std::endl;
+			PushLine(lvl, true, output_time() + log);
 		}
 		log_buffer.clear();
 
@@ -151,11 +425,9 @@ static void WriteLog(LogLevel lvl, std::string const& msg, Color const& c = Colo
 			last_message.repeat++;
 		} else {
 			if (last_message.repeat > 0) {
-				output_time() << GetLogPrefix(last_message.lvl) << last_message.msg << " [" << last_message.repeat + 1 << "x]" << std::endl;
-				output_time() << prefix << msg << std::endl;
-			} else {
-				output_time() << prefix << msg << std::endl;
+				PushLine(lvl, true, fmt::format("{}{}{} [{}x]", output_time(), GetLogPrefix(last_message.lvl), last_message.msg, last_message.repeat + 1));
 			}
+			PushLine(lvl, true, output_time() + prefix + msg);
 			last_message.repeat = 0;
 			last_message.msg = msg;
 			last_message.lvl = lvl;
@@ -166,17 +438,44 @@ static void WriteLog(LogLevel lvl, std::string const& msg, Color const& c = Colo
 	}
 #endif
 
-#ifdef __ANDROID__
-	__android_log_print(lvl == LogLevel::Error ? ANDROID_LOG_ERROR : ANDROID_LOG_INFO, "EasyRPG Player", "%s", msg.c_str());
-#else
-	std::cerr << prefix << msg << std::endl;
-#endif
+	const auto now = std::chrono::steady_clock::now();
+	if (lvl != LogLevel::Error && msg == last_console_message.msg && now - last_console_message.time < console_repeat_interval) {
+		last_console_message.skipped++;
+	} else {
+		if (last_console_message.skipped > 0 && msg == last_console_message.msg) {
+			PushLine(lvl, false, fmt::format("{} [{}x]", msg, last_console_message.skipped + 1));
+		} else {
+			// Report the repeats of the previous message before it is replaced
+			if (last_console_message.skipped > 0) {
+				PushLine(last_console_message.lvl, false, fmt::format("{} [{}x]", last_console_message.msg, last_console_message.skipped + 1));
+			}
+			PushLine(lvl, false, msg);
+		}
+		last_console_message.skipped = 0;
+		last_console_message.msg = msg;
+		last_console_message.lvl = lvl;
+		last_console_message.time = now;
+	}
 
 	if (lvl != LogLevel::Debug && lvl != LogLevel::Error) {
 		Graphics::GetMessageOverlay().AddMessage(msg, c);
 	}
 }
 
+void Output::WriteThreadMessages() {
+#ifdef HAVE_THREADS
+	std::vector<ThreadMessage> messages;
+	{
+		std::lock_guard<std::mutex> lock(thread_messages_mutex);
+		messages.swap(thread_messages);
+	}
+
+	for (auto& message: messages) {
+		WriteLog(message.lvl, message.msg, message.color);
+	}
+#endif
+}
+
 static void HandleErrorOutput(const std::string& err) {
 	// Drawing directly on the screen because message_overlay is not visible
 	// when faded out
@@ -208,6 +507,11 @@ static void HandleErrorOutput(const std::string& err) {
 }
 
 void Output::Quit() {
+#ifdef HAVE_THREADS
+	screenshot_writer.Stop();
+	log_writer.Stop();
+#endif
+
 	if (LOG_FILE) {
 		LOG_FILE.clear();
 	}
@@ -234,16 +538,36 @@ void Output::Quit() {
 	delete[] buf;
 }
 
+void Output::SetScreenshotCompression(int level) {
+	screenshot_compression = level;
+}
+
 bool Output::TakeScreenshot() {
-	int index = 0;
 	std::string p;
 	do {
 		p = FileFinder::MakePath(Main_Data::GetSavePath(),
 								 "screenshot_"
-								 + std::to_string(index++)
+								 + std::to_string(screenshot_index++)
 								 + ".png");
 	} while(FileFinder::Exists(p));
+
+#ifdef HAVE_THREADS
+	// Only the copy of the frame happens on the main thread
+	auto os = FileFinder::OpenOutputStream(p, std::ios_base::binary | std::ios_base::out | std::ios_base::trunc);
+	if (!os) {
+		return false;
+	}
+
+	Output::Debug("Saving Screenshot {}", p);
+	BitmapRef surface = DisplayUi->GetDisplaySurface();
+	Screenshot shot{ std::move(os), static_cast<uint32_t>(surface->GetWidth()), static_cast<uint32_t>(surface->GetHeight()),
+		screenshot_compression, screenshot_writer.GetBuffer() };
+	surface->GetPNGPixels(shot.pixels);
+	screenshot_writer.Push(std::move(shot));
+	return true;
+#else
 	return TakeScreenshot(p);
+#endif
 }
 
 bool Output::TakeScreenshot(std::string const& file) {
@@ -257,7 +581,7 @@ bool Output::TakeScreenshot(std::string const& file) {
 }
 
 bool Output::TakeScreenshot(Filesystem_Stream::OutputStream& os) {
-	return DisplayUi->GetDisplaySurface()->WritePNG(os);
+	return DisplayUi->GetDisplaySurface()->WritePNG(os, screenshot_compression);
 }
 
 void Output::ToggleLog() {
@@ -268,6 +592,10 @@ void Output::ToggleLog() {
 
 void Output::ErrorStr(std::string const& err) {
 	WriteLog(LogLevel::Error, err);
+#ifdef HAVE_THREADS
+	// The error is shown before the Player waits for a key
+	log_writer.Stop();
+#endif
 	static bool recursive_call = false;
 	if (!recursive_call && DisplayUi) {
 		recursive_call = true;
@@ -59,8 +59,16 @@ namespace Output {
 	 */
 	void Quit();
 
+	/**
+	 * Sets the zlib level of screenshots.
+	 *
+	 * @param level 0 to 9, -1 for the libpng default, see ImagePNG::WritePNG
+	 */
+	void SetScreenshotCompression(int level);
+
 	/**
 	 * Takes screenshot and save it to Main_Data::GetProjectPath().
+	 * When threads are supported the frame is copied and encoded in the background.
 	 *
 	 * @return true if success, otherwise false.
 	 */
@@ -87,6 +95,12 @@ namespace Output {
 	 */
 	void ToggleLog();
 
+	/**
+	 * Writes the messages logged by other threads since the last call.
+	 * Must be called by the main thread.
+	 */
+	void WriteThreadMessages();
+
 	/**
 	 * Ignores pause in Warning and Error.
 	 *
@@ -171,6 +185,9 @@ namespace Output {
 
 template <typename FmtStr, typename... Args>
 inline void Output::Info(FmtStr&& fmtstr, Args&&... args) {
+	if (GetLogLevel() < LogLevel::Info) {
+		return;
+	}
 	InfoStr(fmt::format(std::forward<FmtStr>(fmtstr), std::forward<Args>(args)...));
 }
 
@@ -181,11 +198,17 @@ inline void Output::Error(FmtStr&& fmtstr, Args&&... args) {
 
 template <typename FmtStr, typename... Args>
 inline void Output::Warning(FmtStr&& fmtstr, Args&&... args) {
+	if (GetLogLevel() < LogLevel::Warning) {
+		return;
+	}
 	WarningStr(fmt::format(std::forward<FmtStr>(fmtstr), std::forward<Args>(args)...));
 }
 
 template <typename FmtStr, typename... Args>
 inline void Output::Debug(FmtStr&& fmtstr, Args&&... args) {
+	if (GetLogLevel() < LogLevel::Debug) {
+		return;
+	}
 	DebugStr(fmt::format(std::forward<FmtStr>(fmtstr), std::forward<Args>(args)...));
 }
 
@@ -0,0 +1,135 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include "path_finder.h"
+
+namespace {
+	constexpr int num_dirs = 4;
+	/** Offsets of Up, Right, Down and Left */
+	constexpr int dir_dx[num_dirs] = { 0, 1, 0, -1 };
+	constexpr int dir_dy[num_dirs] = { -1, 0, 1, 0 };
+
+	constexpr int ReverseDir(int dir) {
+		return (dir + 2) % num_dirs;
+	}
+}
+
+void PathFinder::Reset(int width, int height, bool loop_horizontal, bool loop_vertical) {
+	this->width = width;
+	this->height = height;
+	this->loop_horizontal = loop_horizontal;
+	this->loop_vertical = loop_vertical;
+	Invalidate();
+}
+
+void PathFinder::Invalidate() {
+	fields.clear();
+}
+
+bool PathFinder::IsValid(int x, int y) const {
+	return x >= 0 && x < width && y >= 0 && y < height;
+}
+
+int PathFinder::GetNeighbor(int x, int y, int dir) const {
+	x += dir_dx[dir];
+	y += dir_dy[dir];
+	if (loop_horizontal) {
+		x = (x + width) % width;
+	}
+	if (loop_vertical) {
+		y = (y + height) % height;
+	}
+	return IsValid(x, y) ? x + y * width : -1;
+}
+
+void PathFinder::Compute(Field& field, int target_x, int target_y, const StepFn& can_step) {
+	field.target = target_x + target_y * width;
+	field.steps.assign(width * height, -1);
+	field.steps[field.target] = 0;
+
+	// Breadth first search backwards from the target, a tile is reached
+	// when the step from it into the current tile is possible.
+	queue.clear();
+	queue.push_back(field.target);
+	for (size_t i = 0; i < queue.size(); ++i) {
+		const int cur = queue[i];
+		const int x = cur % width;
+		const int y = cur / width;
+		for (int dir = 0; dir < num_dirs; ++dir) {
+			const int from = GetNeighbor(x, y, dir);
+			if (from < 0 || field.steps[from] >= 0) {
+				continue;
+			}
+			if (can_step(from % width, from / width, ReverseDir(dir))) {
+				field.steps[from] = field.steps[cur] + 1;
+				queue.push_back(from);
+			}
+		}
+	}
+}
+
+const PathFinder::Field& PathFinder::GetField(int target_x, int target_y, const StepFn& can_step) {
+	const int target = target_x + target_y * width;
+	++use_count;
+
+	Field* oldest = nullptr;
+	for (auto& field: fields) {
+		if (field.target == target) {
+			field.last_use = use_count;
+			return field;
+		}
+		if (!oldest || field.last_use < oldest->last_use) {
+			oldest = &field;
+		}
+	}
+
+	if (static_cast<int>(fields.size()) < max_fields) {
+		fields.emplace_back();
+		oldest = &fields.back();
+	}
+	Compute(*oldest, target_x, target_y, can_step);
+	oldest->last_use = use_count;
+	return *oldest;
+}
+
+int PathFinder::GetDistance(int x, int y, int target_x, int target_y, const StepFn& can_step) {
+	if (!IsValid(x, y) || !IsValid(target_x, target_y)) {
+		return -1;
+	}
+	return GetField(target_x, target_y, can_step).steps[x + y * width];
+}
+
+int PathFinder::GetDirection(int x, int y, int target_x, int target_y, const StepFn& can_step) {
+	if (!IsValid(x, y) || !IsValid(target_x, target_y)) {
+		return -1;
+	}
+
+	const auto& steps = GetField(target_x, target_y, can_step).steps;
+	const int cur = steps[x + y * width];
+	if (cur <= 0) {
+		return -1;
+	}
+
+	for (int dir = 0; dir < num_dirs; ++dir) {
+		const int next = GetNeighbor(x, y, dir);
+		if (next >= 0 && steps[next] == cur - 1 && can_step(x, y, dir)) {
+			return dir;
+		}
+	}
+	return -1;
+}
@@ -0,0 +1,106 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_PATH_FINDER_H
+#define EP_PATH_FINDER_H
+
+// Headers
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+/**
+ * Shortest walking paths on a map.
+ * For every target tile a distance field holding the steps from all tiles
+ * to the target is computed once and shared by every character walking to
+ * that tile. The most recently used fields are kept until the passages of
+ * the map change.
+ * Directions are Up, Right, Down and Left as in Game_Character (0-3).
+ */
+class PathFinder {
+public:
+	/**
+	 * Checks a step.
+	 *
+	 * @param x x position
+	 * @param y y position
+	 * @param dir direction of the step
+	 * @return whether a character at (x,y) can step in direction dir
+	 */
+	using StepFn = std::function<bool(int x, int y, int dir)>;
+
+	/** Distance fields kept at most */
+	static constexpr int max_fields = 8;
+
+	/**
+	 * Removes all fields and sets the map size.
+	 *
+	 * @param width map width
+	 * @param height map height
+	 * @param loop_horizontal whether the map loops horizontally
+	 * @param loop_vertical whether the map loops vertically
+	 */
+	void Reset(int width, int height, bool loop_horizontal, bool loop_vertical);
+
+	/** Removes all fields, called when the passages of the map changed */
+	void Invalidate();
+
+	/**
+	 * Gets the first step of a shortest path.
+	 *
+	 * @param x x position
+	 * @param y y position
+	 * @param target_x target x position
+	 * @param target_y target y position
+	 * @param can_step checks the steps when the field has to be computed
+	 * @return direction of the first step, -1 at the target or when the target is unreachable
+	 */
+	int GetDirection(int x, int y, int target_x, int target_y, const StepFn& can_step);
+
+	/**
+	 * @param x x position
+	 * @param y y position
+	 * @param target_x target x position
+	 * @param target_y target y position
+	 * @param can_step checks the steps when the field has to be computed
+	 * @return number of steps to the target, -1 when the target is unreachable
+	 */
+	int GetDistance(int x, int y, int target_x, int target_y, const StepFn& can_step);
+
+private:
+	struct Field {
+		int target = -1;
+		uint32_t last_use = 0;
+		/** Steps to the target per tile, -1 when unreachable */
+		std::vector<int> steps;
+	};
+
+	bool IsValid(int x, int y) const;
+	int GetNeighbor(int x, int y, int dir) const;
+	const Field& GetField(int target_x, int target_y, const StepFn& can_step);
+	void Compute(Field& field, int target_x, int target_y, const StepFn& can_step);
+
+	int width = 0;
+	int height = 0;
+	bool loop_horizontal = false;
+	bool loop_vertical = false;
+	uint32_t use_count = 0;
+	std::vector<Field> fields;
+	std::vector<int> queue;
+};
+
+#endif
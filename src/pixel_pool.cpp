@@ -0,0 +1,168 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#ifdef HAVE_THREADS
+#  include <mutex>
+#endif
+#include "pixel_pool.h"
+
+namespace {
+	/** Smallest size class, a 16x16 tile */
+	constexpr size_t min_class_size = 1024;
+	/** Size classes per doubling of the size, limits the waste to 25% */
+	constexpr int classes_per_octave = 4;
+	/** Doublings covered by size classes, up to a 640x480 screen */
+	constexpr int octaves = 11;
+	constexpr int class_count = classes_per_octave * octaves;
+	/** Marks buffers which are not in a size class */
+	constexpr uint32_t no_class = ~0U;
+
+	/** Precedes every buffer and keeps the 16 byte alignment of malloc */
+	struct alignas(16) Header {
+		uint32_t size_class;
+	};
+
+	size_t ClassSize(int size_class) {
+		const int octave = size_class / classes_per_octave;
+		const int step = size_class % classes_per_octave;
+		return (min_class_size << octave) / classes_per_octave * (classes_per_octave + step);
+	}
+
+	uint32_t FindClass(size_t bytes) {
+		for (int i = 0; i < class_count; ++i) {
+			if (bytes <= ClassSize(i)) {
+				return i;
+			}
+		}
+		return no_class;
+	}
+
+	/** Kept buffers per size class */
+	std::vector<Header*> free_lists[class_count];
+	size_t limit = 8 * 1024 * 1024;
+	PixelPool::Stats stats;
+
+#ifdef HAVE_THREADS
+	/** Bitmaps are decoded on worker threads */
+	std::mutex mutex;
+#else
+	struct {
+		void lock() {}
+		void unlock() {}
+	} mutex;
+#endif
+
+	/** Holds the mutex for its lifetime */
+	struct Lock {
+		Lock() { mutex.lock(); }
+		~Lock() { mutex.unlock(); }
+	};
+
+	void ReleaseKept() {
+		for (auto& list: free_lists) {
+			for (auto* header: list) {
+				std::free(header);
+			}
+			list.clear();
+		}
+		stats.kept = 0;
+		stats.kept_bytes = 0;
+	}
+}
+
+void* PixelPool::Allocate(size_t bytes) {
+	const uint32_t size_class = FindClass(bytes);
+	Header* header = nullptr;
+
+	{
+		Lock lock;
+		++stats.allocations;
+		++stats.used;
+
+		if (size_class == no_class) {
+			++stats.oversized;
+		} else if (!free_lists[size_class].empty()) {
+			header = free_lists[size_class].back();
+			free_lists[size_class].pop_back();
+			++stats.hits;
+			--stats.kept;
+			stats.kept_bytes -= ClassSize(size_class);
+		}
+	}
+
+	if (header) {
+		// Only the requested part, the rest is never read
+		std::memset(header + 1, 0, bytes);
+		return header + 1;
+	}
+
+	const size_t alloc_size = size_class == no_class ? bytes : ClassSize(size_class);
+	header = static_cast<Header*>(std::calloc(1, sizeof(Header) + alloc_size));
+	if (!header) {
+		Lock lock;
+		--stats.used;
+		return nullptr;
+	}
+	header->size_class = size_class;
+	return header + 1;
+}
+
+void PixelPool::Free(void* data) {
+	if (!data) {
+		return;
+	}
+
+	auto* header = static_cast<Header*>(data) - 1;
+	const uint32_t size_class = header->size_class;
+
+	{
+		Lock lock;
+		--stats.used;
+
+		if (size_class != no_class && stats.kept_bytes + ClassSize(size_class) <= limit) {
+			free_lists[size_class].push_back(header);
+			++stats.kept;
+			stats.kept_bytes += ClassSize(size_class);
+			return;
+		}
+	}
+
+	std::free(header);
+}
+
+void PixelPool::SetLimit(size_t bytes) {
+	Lock lock;
+	limit = bytes;
+	if (stats.kept_bytes > limit) {
+		ReleaseKept();
+	}
+}
+
+void PixelPool::Clear() {
+	Lock lock;
+	ReleaseKept();
+}
+
+PixelPool::Stats PixelPool::GetStats() {
+	Lock lock;
+	return stats;
+}
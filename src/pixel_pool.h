@@ -0,0 +1,76 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_PIXEL_POOL_H
+#define EP_PIXEL_POOL_H
+
+// Headers
+#include <cstddef>
+
+/**
+ * Pool of pixel buffers in size classes.
+ * Freed buffers are kept for reuse by bitmaps of a similar size, which
+ * avoids a malloc and free for every short lived bitmap and reduces heap
+ * fragmentation. Buffers larger than the biggest size class bypass the pool.
+ */
+namespace PixelPool {
+	/** Counters of the pool since startup */
+	struct Stats {
+		/** Buffers handed out */
+		size_t allocations = 0;
+		/** Allocations served by a kept buffer */
+		size_t hits = 0;
+		/** Allocations bypassing the pool because of their size */
+		size_t oversized = 0;
+		/** Buffers in use */
+		size_t used = 0;
+		/** Buffers kept for reuse and their total size */
+		size_t kept = 0;
+		size_t kept_bytes = 0;
+	};
+
+	/**
+	 * Allocates a zero-initialized buffer.
+	 *
+	 * @param bytes size of the buffer
+	 * @return buffer, aligned to 16 bytes, or nullptr when out of memory
+	 */
+	void* Allocate(size_t bytes);
+
+	/**
+	 * Returns a buffer of Allocate to the pool.
+	 *
+	 * @param data buffer, may be nullptr
+	 */
+	void Free(void* data);
+
+	/**
+	 * Sets the total size of kept buffers. Buffers freed beyond it are
+	 * released to the system.
+	 *
+	 * @param bytes size limit in bytes
+	 */
+	void SetLimit(size_t bytes);
+
+	/** Releases all kept buffers to the system */
+	void Clear();
+
+	/** @return counters of the pool */
+	Stats GetStats();
+}
+
+#endif
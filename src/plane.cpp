@@ -18,6 +18,7 @@
 // Headers
 #include "plane.h"
 #include "player.h"
+#include "accelerated_renderer.h"
 #include "bitmap.h"
 #include "main_data.h"
 #include "game_map.h"
@@ -29,8 +30,8 @@ Plane::Plane() : Drawable(0)
 	DrawableMgr::Register(this);
 }
 
-void Plane::Draw(Bitmap& dst) {
-	if (!bitmap) return;
+bool Plane::PrepareDraw(const Rect& screen_rect, BitmapRef& source, int& src_x, int& src_y, Rect& dst_rect) {
+	if (!bitmap) return false;
 
 	if (needs_refresh) {
 		needs_refresh = false;
@@ -44,11 +45,11 @@ void Plane::Draw(Bitmap& dst) {
 		tone_bitmap->ToneBlit(0, 0, *bitmap, bitmap->GetRect(), tone_effect, Opacity::Opaque());
 	}
 
-	BitmapRef source = tone_effect == Tone() ? bitmap : tone_bitmap;
+	source = tone_effect == Tone() ? bitmap : tone_bitmap;
 
-	Rect dst_rect = dst.GetRect();
-	int src_x = -ox;
-	int src_y = -oy;
+	dst_rect = screen_rect;
+	src_x = -ox;
+	src_y = -oy;
 
 	// Apply screen shaking
 	const int shake_x = Main_Data::game_screen->GetShakeOffsetX();
@@ -76,7 +77,7 @@ void Plane::Draw(Bitmap& dst) {
 			bg_x + bg_width <= 0;
 		if (off_screen) {
 			// This probably won't happen...
-			return;
+			return false;
 		}
 
 		dst_rect.x = bg_x;
@@ -87,6 +88,35 @@ void Plane::Draw(Bitmap& dst) {
 	}
 	src_y += shake_y;
 
-	dst.TiledBlit(src_x, src_y, source->GetRect(), *source, dst_rect, 255);
+	return true;
+}
+
+void Plane::Draw(Bitmap& dst) {
+	BitmapRef source;
+	int src_x;
+	int src_y;
+	Rect dst_rect;
+	if (!PrepareDraw(dst.GetRect(), source, src_x, src_y, dst_rect)) {
+		return;
+	}
+
+	wrap.TiledBlit(dst, src_x, src_y, source, dst_rect, 255);
+}
+
+bool Plane::DrawAccelerated(AcceleratedRenderer& renderer) {
+	BitmapRef source;
+	int src_x;
+	int src_y;
+	Rect dst_rect;
+	if (!PrepareDraw(renderer.GetScreenRect(), source, src_x, src_y, dst_rect)) {
+		return true;
+	}
+
+	if (renderer.CanDraw(*source)) {
+		renderer.DrawTiled(*source, source->GetRect(), src_x, src_y, dst_rect, 255);
+	} else {
+		renderer.GetLayer().TiledBlit(src_x, src_y, source->GetRect(), *source, dst_rect, 255);
+	}
+	return true;
 }
 
@@ -20,6 +20,7 @@
 
 // Headers
 #include "system.h"
+#include "bitmap_wrap.h"
 #include "color.h"
 #include "drawable.h"
 #include "tone.h"
@@ -32,6 +33,7 @@ public:
 	Plane();
 
 	void Draw(Bitmap& dst) override;
+	bool DrawAccelerated(AcceleratedRenderer& renderer) override;
 
 	BitmapRef const& GetBitmap() const;
 	void SetBitmap(BitmapRef const& bitmap);
@@ -43,8 +45,21 @@ public:
 	void SetTone(Tone tone);
 
 private:
+	/**
+	 * Refreshes the toned bitmap and calculates where the plane is drawn.
+	 *
+	 * @param screen_rect the area of the screen
+	 * @param source bitmap to tile
+	 * @param src_x horizontal offset of the tiling
+	 * @param src_y vertical offset of the tiling
+	 * @param dst_rect screen area covered by the plane
+	 * @return false when nothing is drawn
+	 */
+	bool PrepareDraw(const Rect& screen_rect, BitmapRef& source, int& src_x, int& src_y, Rect& dst_rect);
+
 	BitmapRef bitmap;
 	BitmapRef tone_bitmap;
+	BitmapWrap wrap;
 
 	Tone tone_effect;
 
@@ -19,8 +19,15 @@
 #include "platform.h"
 #include "utils.h"
 #include <cassert>
+#include <cstdint>
 #include <utility>
 
+#if defined(__linux__) || defined(__APPLE__) || defined(__FreeBSD__)
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  define EP_PLATFORM_MMAP
+#endif
+
 #ifndef DT_UNKNOWN
 #define DT_UNKNOWN 0
 #endif
@@ -124,6 +131,36 @@ int64_t Platform::File::GetSize() const {
 #endif
 }
 
+int64_t Platform::File::GetModificationTime() const {
+#if defined(_WIN32)
+	WIN32_FILE_ATTRIBUTE_DATA data;
+	BOOL res = ::GetFileAttributesExW(filename.c_str(),
+			GetFileExInfoStandard,
+			&data);
+	if (!res) {
+		return -1;
+	}
+
+	// 100ns intervals since 1601
+	int64_t time = ((int64_t)data.ftLastWriteTime.dwHighDateTime << 32) | (int64_t)data.ftLastWriteTime.dwLowDateTime;
+	return time / 10000000 - 11644473600LL;
+#elif defined(PSP2)
+	struct SceIoStat sb = {};
+	int result = ::sceIoGetstat(filename.c_str(), &sb);
+	if (result < 0) {
+		return -1;
+	}
+
+	SceDateTime& t = sb.st_mtime;
+	// Not the epoch, only compared for equality
+	return ((((((int64_t)t.year * 12 + t.month) * 31 + t.day) * 24 + t.hour) * 60 + t.minute) * 60) + t.second;
+#else
+	struct stat sb = {};
+	int result = ::stat(filename.c_str(), &sb);
+	return (result == 0) ? (int64_t)sb.st_mtime : (int64_t)-1;
+#endif
+}
+
 Platform::Directory::Directory(const std::string& name) {
 #if defined(_WIN32)
 	dir_handle = ::_wopendir(Utils::ToWideString(name).c_str());
@@ -210,3 +247,56 @@ void Platform::Directory::Close() {
 
 	valid_entry = false;
 }
+
+Platform::FileMapping::FileMapping(const std::string& name, bool copy_on_write) {
+	const int64_t file_size = File(name).GetSize();
+	if (file_size <= 0 || static_cast<uint64_t>(file_size) > SIZE_MAX) {
+		return;
+	}
+
+#if defined(_WIN32)
+	HANDLE file = ::CreateFileW(Utils::ToWideString(name).c_str(), GENERIC_READ, FILE_SHARE_READ,
+		nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		return;
+	}
+	mapping_handle = ::CreateFileMappingW(file, nullptr, copy_on_write ? PAGE_WRITECOPY : PAGE_READONLY, 0, 0, nullptr);
+	::CloseHandle(file);
+	if (!mapping_handle) {
+		return;
+	}
+	data = static_cast<const char*>(::MapViewOfFile(mapping_handle, copy_on_write ? FILE_MAP_COPY : FILE_MAP_READ, 0, 0, 0));
+	if (!data) {
+		::CloseHandle(mapping_handle);
+		mapping_handle = nullptr;
+		return;
+	}
+#elif defined(EP_PLATFORM_MMAP)
+	int fd = ::open(name.c_str(), O_RDONLY);
+	if (fd < 0) {
+		return;
+	}
+	void* addr = ::mmap(nullptr, file_size, copy_on_write ? PROT_READ | PROT_WRITE : PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd);
+	if (addr == MAP_FAILED) {
+		return;
+	}
+	data = static_cast<const char*>(addr);
+#else
+	return;
+#endif
+	size = static_cast<size_t>(file_size);
+	writable = copy_on_write;
+}
+
+Platform::FileMapping::~FileMapping() {
+	if (!data) {
+		return;
+	}
+#if defined(_WIN32)
+	::UnmapViewOfFile(data);
+	::CloseHandle(mapping_handle);
+#elif defined(EP_PLATFORM_MMAP)
+	::munmap(const_cast<char*>(data), size);
+#endif
+}
@@ -94,6 +94,9 @@ namespace Platform {
 		/** @return Filesize or -1 on error */
 		int64_t GetSize() const;
 
+		/** @return Time of the last modification in seconds since the epoch or -1 on error */
+		int64_t GetModificationTime() const;
+
 	private:
 #ifdef _WIN32
 		const std::wstring filename;
@@ -158,6 +161,64 @@ namespace Platform {
 		return dir_handle != nullptr;
 #endif
 	}
+
+	/**
+	 * Memory mapping of a whole file.
+	 * The pages stay shared with other processes mapping the same file
+	 * until they are written to.
+	 */
+	class FileMapping {
+	public:
+		explicit FileMapping() = delete;
+		FileMapping& operator=(const FileMapping&) = delete;
+		FileMapping(const FileMapping&) = delete;
+
+		/**
+		 * Maps a file into memory.
+		 * Fails on platforms without memory mapping and for empty files.
+		 *
+		 * @param name File to map
+		 * @param copy_on_write allow writing, written pages become private copies
+		 */
+		explicit FileMapping(const std::string& name, bool copy_on_write = false);
+		~FileMapping();
+
+		/** @return mapped contents of the file */
+		const char* GetData() const;
+
+		/** @return mapped contents for writing, nullptr when not mapped copy on write */
+		char* GetWritableData() const;
+
+		/** @return size of the mapping */
+		size_t GetSize() const;
+
+		/** @return true if mapping the file was successful */
+		explicit operator bool() const noexcept;
+
+	private:
+		const char* data = nullptr;
+		size_t size = 0;
+		bool writable = false;
+#ifdef _WIN32
+		HANDLE mapping_handle = nullptr;
+#endif
+	};
+
+	inline const char* FileMapping::GetData() const {
+		return data;
+	}
+
+	inline char* FileMapping::GetWritableData() const {
+		return writable ? const_cast<char*>(data) : nullptr;
+	}
+
+	inline size_t FileMapping::GetSize() const {
+		return size;
+	}
+
+	inline FileMapping::operator bool() const noexcept {
+		return data != nullptr;
+	}
 }
 
 #endif
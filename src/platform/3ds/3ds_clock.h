@@ -39,6 +39,10 @@ struct CtrClock {
 	template <typename R, typename P>
 	static void SleepFor(std::chrono::duration<R,P> dt);
 
+	static void YieldThread();
+
+	static constexpr std::chrono::microseconds SleepMargin();
+
 	static constexpr const char* Name();
 };
 
@@ -53,6 +57,14 @@ inline void CtrClock::SleepFor(std::chrono::duration<R,P> dt) {
 	svcSleepThread(ns.count());
 }
 
+inline void CtrClock::YieldThread() {
+	svcSleepThread(0);
+}
+
+constexpr std::chrono::microseconds CtrClock::SleepMargin() {
+	return std::chrono::microseconds(500);
+}
+
 constexpr const char* CtrClock::Name() {
 	return "CtrClock";
 }
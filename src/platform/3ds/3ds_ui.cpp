@@ -59,6 +59,12 @@ namespace {
 	constexpr int width_pow2 = 512;
 	constexpr int height_pow2 = 256;
 	u32* main_buffer;
+	// RGBA copy of main_buffer for the GPU, main_buffer keeps the frame for the next Draw
+	u32* upload_buffer;
+	uint32_t uploaded_revision = 0;
+	bool uploaded = false;
+	// The top screen must be drawn again although the frame did not change
+	bool redraw_top = true;
 }
 
 CtrUi::CtrUi(int width, int height, const Game_ConfigVideo& cfg) : BaseUi(cfg)
@@ -104,6 +110,8 @@ CtrUi::CtrUi(int width, int height, const Game_ConfigVideo& cfg) : BaseUi(cfg)
 
 	main_buffer = (u32*)linearAlloc((width_pow2*height_pow2*4));
 	main_surface = Bitmap::Create(main_buffer, width, height, width_pow2*4, format);
+	upload_buffer = (u32*)linearAlloc((width_pow2*height_pow2*4));
+	memset(upload_buffer, 0, width_pow2*height_pow2*4);
 
 	subt3x.width = width_pow2;
 	subt3x.height = height_pow2;
@@ -134,6 +142,10 @@ CtrUi::~CtrUi() {
 	C3D_TexDelete(top_image.tex);
 	free(top_image.tex);
 
+	main_surface.reset();
+	linearFree(main_buffer);
+	linearFree(upload_buffer);
+
 #ifdef NDEBUG
 	C2D_SpriteSheetFree(assets);
 #endif
@@ -180,6 +192,7 @@ void CtrUi::ProcessEvents() {
 		} else {
 			C3D_TexSetFilter(top_image.tex, GPU_NEAREST, GPU_NEAREST);
 		}
+		redraw_top = true;
 	}
 
 #if defined(USE_JOYSTICK_AXIS) && defined(SUPPORT_JOYSTICK_AXIS)
@@ -232,47 +245,69 @@ static __attribute__((always_inline, optimize(3))) inline u32 NDS3D_Reverse32(u3
 }
 
 void CtrUi::UpdateDisplay() {
-	// rotate ARGB buffer to RGBA buffer
-	// required because pixman has no fast-paths for non AXXX buffers
-	u32* line = main_buffer;
-	for (int i = 0; i <= 240; ++i) {
-		for (int j = 0; j <= 320; ++j) {
-			u32* val = line + j;
-			*val = NDS3D_Reverse32(*val);
-		}
-		line += width_pow2;
+	Rect damage = main_surface->GetRect();
+	if (uploaded) {
+		damage = Graphics::GetSurfaceDamage(*main_surface, uploaded_revision);
+	}
+	uploaded_revision = main_surface->GetRevision();
+	uploaded = true;
+
+#if NDEBUG
+	const bool redraw_bottom = touch_state != 0;
+#else
+	const bool redraw_bottom = false;
+#endif
+	if (damage.IsEmpty() && !redraw_top && !redraw_bottom) {
+		// Nothing changed, the screens keep the last frame
+		return;
 	}
 
-	GSPGPU_FlushDataCache(main_buffer, (width_pow2*height_pow2*4));
-
-	// Using RGB8 as output format is faster and improves framerate ¯\_(ツ)_/¯
-	const u32 flags = (GX_TRANSFER_FLIP_VERT(0) |
-		GX_TRANSFER_OUT_TILED(1) |
-		GX_TRANSFER_RAW_COPY(0) |
-		GX_TRANSFER_IN_FORMAT(GX_TRANSFER_FMT_RGBA8) |
-		GX_TRANSFER_OUT_FORMAT(GX_TRANSFER_FMT_RGB8) |
-		GX_TRANSFER_SCALING(GX_TRANSFER_SCALE_NO));
-
-	// Doing this after FrameBegin corrupts the output, probably because this
-	// is asynchronous and FrameBegin will block until it finishes
-	C3D_SyncDisplayTransfer(
-		(u32*)main_buffer,
-		GX_BUFFER_DIM(width_pow2, height_pow2),
-		(u32*)top_image.tex->data,
-		GX_BUFFER_DIM(width_pow2, height_pow2),
-		flags
-	 );
+	if (!damage.IsEmpty()) {
+		// rotate ARGB buffer to RGBA buffer, only the changed area
+		// required because pixman has no fast-paths for non AXXX buffers
+		for (int y = damage.y; y < damage.y + damage.height; ++y) {
+			const u32* src = main_buffer + y * width_pow2;
+			u32* dst = upload_buffer + y * width_pow2;
+			for (int x = damage.x; x < damage.x + damage.width; ++x) {
+				dst[x] = NDS3D_Reverse32(src[x]);
+			}
+		}
+
+		GSPGPU_FlushDataCache(upload_buffer + damage.y * width_pow2, damage.height * width_pow2 * 4);
+
+		// Using RGB8 as output format is faster and improves framerate ¯\_(ツ)_/¯
+		// The transfer engine does the tiling for the texture
+		const u32 flags = (GX_TRANSFER_FLIP_VERT(0) |
+			GX_TRANSFER_OUT_TILED(1) |
+			GX_TRANSFER_RAW_COPY(0) |
+			GX_TRANSFER_IN_FORMAT(GX_TRANSFER_FMT_RGBA8) |
+			GX_TRANSFER_OUT_FORMAT(GX_TRANSFER_FMT_RGB8) |
+			GX_TRANSFER_SCALING(GX_TRANSFER_SCALE_NO));
+
+		// Doing this after FrameBegin corrupts the output, probably because this
+		// is asynchronous and FrameBegin will block until it finishes
+		C3D_SyncDisplayTransfer(
+			(u32*)upload_buffer,
+			GX_BUFFER_DIM(width_pow2, height_pow2),
+			(u32*)top_image.tex->data,
+			GX_BUFFER_DIM(width_pow2, height_pow2),
+			flags
+		 );
+	}
 
 	C3D_FrameBegin(0);
 
-	// top screen
-	C2D_SceneBegin(top_screen);
-	C2D_TargetClear(top_screen, C2D_Color32f(0, 0, 0, 1));
+	// top screen, a target that is not drawn keeps its last frame
+	if (!damage.IsEmpty() || redraw_top) {
+		C2D_SceneBegin(top_screen);
+		C2D_TargetClear(top_screen, C2D_Color32f(0, 0, 0, 1));
 
-	if (fullscreen) {
-		C2D_DrawImageAt(top_image, 0, 0, 0.5f, NULL, 1.25f, 1.0f);
-	} else {
-		C2D_DrawImageAt(top_image, 40, 0, 0.5f, NULL);
+		if (fullscreen) {
+			C2D_DrawImageAt(top_image, 0, 0, 0.5f, NULL, 1.25f, 1.0f);
+		} else {
+			C2D_DrawImageAt(top_image, 40, 0, 0.5f, NULL);
+		}
+		redraw_top = false;
 	}
 
 #if NDEBUG
@@ -18,8 +18,8 @@
 #if defined(USE_LIBRETRO) && defined(SUPPORT_AUDIO)
 #include "libretro_audio.h"
 #include "output.h"
-#include "game_clock.h"
 
+#include <algorithm>
 #include <vector>
 #include <cstdlib>
 #include <stddef.h>
@@ -29,29 +29,43 @@
 retro_audio_sample_batch_t RenderAudioFrames = nullptr;
 
 constexpr int AUDIO_SAMPLERATE = 48000;
-constexpr int BUFFER_SIZE = 4096;
+/** Longest frame mixed at once (100 ms), longer frames lose the remaining audio */
+constexpr size_t MAX_FRAME_SAMPLES = AUDIO_SAMPLERATE / 10;
 
 namespace {
-	unsigned samples_per_frame = 0;
-	bool enable_audio = false;
 	LibretroAudio* instance = nullptr;
-	std::vector<uint8_t> buffer;
+	/** Stereo S16 samples of a frame, allocated once */
+	std::vector<int16_t> buffer;
+	/** Part of a sample frame carried to the next frame, in 1/1000000 samples */
+	uint64_t sample_remainder = 0;
  	slock_t* mutex = nullptr;
 }
 
-void LibretroAudio::AudioThreadCallback() {
-	if (!enable_audio)
+void LibretroAudio::RenderFrame(retro_usec_t usec) {
+	if (!instance || !RenderAudioFrames) {
 		return;
+	}
+
+	const uint64_t total = static_cast<uint64_t>(usec) * AUDIO_SAMPLERATE + sample_remainder;
+	sample_remainder = total % 1000000;
+	const size_t frames = std::min<uint64_t>(total / 1000000, MAX_FRAME_SAMPLES);
+	if (frames == 0) {
+		return;
+	}
 
 	instance->LockMutex();
-	instance->Decode(buffer.data(), samples_per_frame * 2 * 2);
+	instance->Decode(reinterpret_cast<uint8_t*>(buffer.data()), frames * 2 * sizeof(int16_t));
 	instance->UnlockMutex();
 
-	RenderAudioFrames((const int16_t*)buffer.data(), samples_per_frame);
-}
-
-void LibretroAudio::EnableAudio(bool enabled) {
-	enable_audio = enabled;
+	// The frontend may accept less than passed
+	size_t written = 0;
+	while (written < frames) {
+		const size_t accepted = RenderAudioFrames(buffer.data() + written * 2, frames - written);
+		if (accepted == 0) {
+			break;
+		}
+		written += accepted;
+	}
 }
 
 LibretroAudio::LibretroAudio() :
@@ -60,14 +74,15 @@ LibretroAudio::LibretroAudio() :
 
 	mutex = slock_new();
 
-	buffer.resize(BUFFER_SIZE);
+	buffer.resize(MAX_FRAME_SAMPLES * 2);
+	sample_remainder = 0;
 
 	SetFormat(AUDIO_SAMPLERATE, AudioDecoder::Format::S16, 2);
-
-	samples_per_frame = AUDIO_SAMPLERATE / Game_Clock::GetTargetGameFps();
 }
 
 LibretroAudio::~LibretroAudio() {
+	instance = nullptr;
+
 	slock_free(mutex);
 	mutex = nullptr;
 
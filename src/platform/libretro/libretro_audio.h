@@ -31,8 +31,12 @@ public:
 	void LockMutex() const override;
 	void UnlockMutex() const override;
 
-	static void EnableAudio(bool enabled);
-	static void AudioThreadCallback();
+	/**
+	 * Mixes the audio of a frame and passes it to the frontend in one batch.
+	 *
+	 * @param usec duration of the frame
+	 */
+	static void RenderFrame(retro_usec_t usec);
 	static void SetRetroAudioCallback(retro_audio_sample_batch_t cb);
 };
 
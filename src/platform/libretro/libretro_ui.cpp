@@ -29,8 +29,10 @@
 #include "output.h"
 #include "player.h"
 #include "scene.h"
+#include "snapshot.h"
 #include "version.h"
 
+#include <chrono>
 #include <cstring>
 #include <stdio.h>
 #include <stdint.h>
@@ -51,6 +53,13 @@ retro_environment_t LibretroUi::environ_cb = nullptr;
 retro_input_poll_t LibretroUi::input_poll_cb = nullptr;
 bool LibretroUi::player_exit_called = false;
 
+namespace {
+	/** Consecutive fully redrawn frames before drawing to the frontend buffer */
+	constexpr int full_redraw_threshold = 30;
+	/** Frames drawn to the frontend buffer before the damage is measured again */
+	constexpr int frontend_probe_frames = 300;
+}
+
 #if defined(USE_KEYBOARD) && defined(SUPPORT_KEYBOARD)
 static Input::Keys::InputKey RetroKey2InputKey(int retrokey);
 #endif
@@ -93,6 +102,11 @@ LibretroUi::LibretroUi(int width, int height, const Game_ConfigVideo& cfg) : Bas
 		false,
 		current_display_mode.bpp
 	);
+	own_surface = main_surface;
+
+	if (!environ_cb(RETRO_ENVIRONMENT_GET_CAN_DUPE, &can_dupe)) {
+		can_dupe = false;
+	}
 
 	#ifdef SUPPORT_AUDIO
 	audio_.reset(new LibretroAudio());
@@ -114,7 +128,83 @@ void LibretroUi::UpdateDisplay() {
 		return;
 	}
 
-	UpdateWindow(main_surface->pixels(), current_display_mode.width, current_display_mode.height, main_surface->pitch());
+	const int width = current_display_mode.width;
+	const int height = current_display_mode.height;
+	const bool frontend = main_surface == frontend_surface;
+
+	Rect damage = main_surface->GetRect();
+	if (main_surface.get() == presented_surface) {
+		damage = Graphics::GetSurfaceDamage(*main_surface, presented_revision);
+	}
+	const bool dupe = can_dupe && !frontend && damage.IsEmpty();
+
+	presented_surface = main_surface.get();
+	// Read through const access below, the non-const pixels() changes the revision
+	presented_revision = main_surface->GetRevision();
+	frame_sent = true;
+
+	if (!frontend) {
+		full_redraw_frames = (damage == main_surface->GetRect()) ? full_redraw_frames + 1 : 0;
+		if (full_redraw_frames >= full_redraw_threshold && !frontend_surface_unsupported) {
+			use_frontend_surface = true;
+			frontend_frames = 0;
+		}
+	}
+
+	if (dupe) {
+		// Nothing changed, the frontend shows the previous frame again
+		UpdateWindow(nullptr, width, height, 0);
+		return;
+	}
+
+	const Bitmap& surface = *main_surface;
+	UpdateWindow(surface.pixels(), width, height, surface.pitch());
+}
+
+void LibretroUi::BeginFrame() {
+	frame_sent = false;
+
+	if (use_frontend_surface && frontend_frames >= frontend_probe_frames) {
+		// Check whether the scene still redraws the whole screen
+		use_frontend_surface = false;
+		full_redraw_frames = 0;
+	}
+
+	if (!use_frontend_surface) {
+		main_surface = own_surface;
+		return;
+	}
+
+	retro_framebuffer fb = {};
+	fb.width = current_display_mode.width;
+	fb.height = current_display_mode.height;
+	fb.access_flags = RETRO_MEMORY_ACCESS_WRITE;
+
+	if (!environ_cb(RETRO_ENVIRONMENT_GET_CURRENT_SOFTWARE_FRAMEBUFFER, &fb) ||
+			!fb.data || fb.format != RETRO_PIXEL_FORMAT_XRGB8888 ||
+			static_cast<int>(fb.width) != current_display_mode.width ||
+			static_cast<int>(fb.height) != current_display_mode.height) {
+		use_frontend_surface = false;
+		frontend_surface_unsupported = true;
+		main_surface = own_surface;
+		return;
+	}
+
+	if (fb.data != frontend_pixels || !frontend_surface || frontend_surface->pitch() != static_cast<int>(fb.pitch)) {
+		frontend_pixels = fb.data;
+		frontend_surface = Bitmap::Create(fb.data, fb.width, fb.height, fb.pitch, Bitmap::opaque_pixel_format);
+	}
+
+	// The contents of the frontend buffer are undefined, the frame is drawn completely
+	main_surface = frontend_surface;
+	Graphics::InvalidateFrame();
+	++frontend_frames;
+}
+
+void LibretroUi::EndFrame() {
+	if (!frame_sent && presented_surface && can_dupe && UpdateWindow) {
+		UpdateWindow(nullptr, current_display_mode.width, current_display_mode.height, 0);
+	}
 }
 
 void LibretroUi::SetTitle(const std::string &title){
@@ -419,16 +509,6 @@ RETRO_CALLCONV void retro_time_update(retro_usec_t usec) {
 	LibretroUi::time_in_microseconds += usec;
 }
 
-RETRO_CALLCONV void retro_write_audio() {
-	if (DisplayUi) {
-		LibretroAudio::AudioThreadCallback();
-	}
-}
-
-RETRO_CALLCONV void retro_enable_audio(bool enabled) {
-	LibretroAudio::EnableAudio(enabled);
-}
-
 RETRO_CALLCONV void retro_keyboard_event(bool down, unsigned keycode, uint32_t, uint16_t) {
 	if (DisplayUi) {
 		static_cast<LibretroUi*>(DisplayUi.get())->UpdateKeyboardCallback(down, keycode);
@@ -458,11 +538,6 @@ RETRO_API void retro_set_environment(retro_environment_t cb) {
 		1000000 / Game_Clock::GetTargetGameFps()
 	};
 
-	static retro_audio_callback audio_callback_definition = {
-		retro_write_audio,
-		retro_enable_audio
-	};
-
 	static retro_keyboard_callback keyboard_callback_definition = {
 		retro_keyboard_event
 	};
@@ -472,7 +547,6 @@ RETRO_API void retro_set_environment(retro_environment_t cb) {
 	LibretroUi::environ_cb = cb;
 
 	cb(RETRO_ENVIRONMENT_SET_SUPPORT_NO_GAME, &no_content);
-	cb(RETRO_ENVIRONMENT_SET_AUDIO_CALLBACK, &audio_callback_definition);
 	cb(RETRO_ENVIRONMENT_SET_FRAME_TIME_CALLBACK, &frame_time_definition);
 	cb(RETRO_ENVIRONMENT_SET_KEYBOARD_CALLBACK, &keyboard_callback_definition);
 
@@ -602,7 +676,28 @@ RETRO_API void retro_reset(void) {
  */
 
 RETRO_API void retro_run() {
-	Player::MainLoop();
+	retro_usec_t usec = LibretroUi::time_in_microseconds;
+	LibretroUi::time_in_microseconds = 0;
+	if (usec <= 0) {
+		// The frontend has no frame time callback
+		usec = 1000000 / Game_Clock::GetTargetGameFps();
+	}
+
+	if (DisplayUi) {
+		static_cast<LibretroUi*>(DisplayUi.get())->BeginFrame();
+	}
+
+	// The game and the audio follow the frame time of the frontend, this keeps
+	// them in sync during fast forward and slow motion
+	const auto frame_dt = std::chrono::duration_cast<Game_Clock::duration>(std::chrono::microseconds(usec));
+	Player::MainLoop(Game_Clock::GetFrameTime() + frame_dt);
+
+	if (DisplayUi) {
+		static_cast<LibretroUi*>(DisplayUi.get())->EndFrame();
+#ifdef SUPPORT_AUDIO
+		LibretroAudio::RenderFrame(usec);
+#endif
+	}
 
 	if (!DisplayUi) {
 		// Player::Exit was called, send shutdown request to the frontend
@@ -657,13 +752,6 @@ RETRO_API bool retro_load_game(const struct retro_game_info* game) {
 
 /* Unloads a currently loaded game. */
 RETRO_API void retro_unload_game() {
-	// Workaround a crash on Windows & Android because the callbacks are invoked after the DLL/SO was unloaded
-	static retro_audio_callback no_audio_callback_definition = {
-		nullptr,
-		nullptr
-	};
-	LibretroUi::environ_cb(RETRO_ENVIRONMENT_SET_AUDIO_CALLBACK, &no_audio_callback_definition);
-
 	if (!LibretroUi::player_exit_called) {
 		// Shutdown requested by the frontend and not via Title scene
 		Player::Exit();
@@ -680,21 +768,29 @@ RETRO_API void retro_unload_game() {
  * returned size is never allowed to be larger than a previous returned
  * value, to ensure that the frontend can allocate a save state buffer once.
  */
+/* Room for the state to grow between retro_serialize_size and retro_serialize */
+static constexpr size_t serialize_reserve = 64 * 1024;
+
 RETRO_API size_t retro_serialize_size() {
-	// no-op
-	return 0;
+	const auto snapshot = Snapshot::Create();
+	return snapshot.empty() ? 0 : snapshot.size() + serialize_reserve;
 }
 
 /* Serializes internal state. If failed, or size is lower than
  * retro_serialize_size(), it should return false, true otherwise. */
 RETRO_API bool retro_serialize(void *data, size_t size) {
-	// no-op
-	return false;
+	const auto snapshot = Snapshot::Create();
+	if (snapshot.empty() || snapshot.size() > size) {
+		return false;
+	}
+	memcpy(data, snapshot.data(), snapshot.size());
+	// The header has the size of the snapshot, the rest is padding
+	memset(static_cast<char*>(data) + snapshot.size(), 0, size - snapshot.size());
+	return true;
 }
 
 RETRO_API bool retro_unserialize(const void *data, size_t size) {
-	// no-op
-	return false;
+	return Snapshot::Restore(data, size);
 }
 
 RETRO_API void retro_cheat_reset(void) {
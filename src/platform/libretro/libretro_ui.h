@@ -63,9 +63,22 @@ public:
 
 	void UpdateKeyboardCallback(bool down, unsigned keycode);
 
+	/**
+	 * Called by retro_run before the main loop.
+	 * Selects the surface the next frame is drawn to.
+	 */
+	void BeginFrame();
+
+	/**
+	 * Called by retro_run after the main loop.
+	 * Dupes the last frame when no frame was drawn.
+	 */
+	void EndFrame();
+
 	static void SetRetroVideoCallback(retro_video_refresh_t cb);
 	static void SetRetroInputStateCallback(retro_input_state_t cb);
 
+	/** Frame time reported by the frontend since the last retro_run */
 	static retro_usec_t time_in_microseconds;
 	static retro_environment_t environ_cb;
 	static retro_input_poll_t input_poll_cb;
@@ -75,6 +88,23 @@ private:
 	static retro_input_state_t CheckInputState;
 	uint32_t keyboard_retropad_state = 0;
 
+	/** Surface allocated by the core, used when the frontend has no buffer */
+	BitmapRef own_surface;
+	/** Wraps the software framebuffer of the frontend */
+	BitmapRef frontend_surface;
+	void* frontend_pixels = nullptr;
+	/** The frontend buffer is used while the screen is redrawn every frame */
+	bool use_frontend_surface = false;
+	bool frontend_surface_unsupported = false;
+	int frontend_frames = 0;
+	int full_redraw_frames = 0;
+
+	bool can_dupe = false;
+	/** A frame was passed to the frontend during this retro_run */
+	bool frame_sent = false;
+	const Bitmap* presented_surface = nullptr;
+	uint32_t presented_revision = 0;
+
 	void UpdateVariables();
 };
 
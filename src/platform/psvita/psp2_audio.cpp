@@ -22,18 +22,21 @@
 #include <psp2/audioout.h>
 #include <psp2/kernel/threadmgr.h>
 #include <psp2/kernel/processmgr.h>
+#include <algorithm>
 #include <vector>
 #include <cstdlib>
 
 namespace {
-	const int buf_size = 8192;
 	const int samplerate = 44100;
 	const int bytes_per_sample = 4;
-	const int samples_per_buf = buf_size / bytes_per_sample;
+	const int default_samples_per_buf = 2048;
 	Psp2Audio* instance = nullptr;
 }
 
 static int psp2_audio_thread(unsigned int, void*){
+	// The port only accepts multiples of 64 samples
+	const int samples_per_buf = std::max(64, AudioInterface::GetBufferSize(default_samples_per_buf) / 64 * 64);
+	const int buf_size = samples_per_buf * bytes_per_sample;
 	std::vector<uint8_t> buffer;
 	buffer.resize(buf_size);
 
@@ -38,6 +38,10 @@ struct Psp2Clock {
 	template <typename R, typename P>
 	static void SleepFor(std::chrono::duration<R,P> dt);
 
+	static void YieldThread();
+
+	static constexpr std::chrono::microseconds SleepMargin();
+
 	static constexpr const char* Name();
 };
 
@@ -52,6 +56,14 @@ inline void Psp2Clock::SleepFor(std::chrono::duration<R,P> dt) {
 	sceKernelDelayThread(us.count());
 }
 
+inline void Psp2Clock::YieldThread() {
+	// Delays are rounded up to the scheduler tick, spin instead
+}
+
+constexpr std::chrono::microseconds Psp2Clock::SleepMargin() {
+	return std::chrono::microseconds(500);
+}
+
 constexpr const char* Psp2Clock::Name() {
 	return "Psp2Clock";
 }
@@ -68,26 +68,44 @@ const char* shader_names[] = {
 };
 
 namespace {
-	vita2d_texture* gpu_texture;
-	vita2d_texture* next_texture;
+	constexpr int present_textures_num = 2;
+	// Drawn by the GPU thread, the main thread copies a frame to the one not in use
+	vita2d_texture* present_textures[present_textures_num];
+	// Rows each texture misses since it was filled
+	Rect present_damage[present_textures_num];
+	// Texture with the newest frame not drawn yet and the one the GPU thread draws, -1 for none
+	int ready_index = -1;
+	int drawing_index = -1;
 	vita2d_texture* main_texture;
 	uint8_t zoom_state;
 	int in_use_shader;
 	bool set_shader;
-	SceUID GPU_Mutex, GPU_Cleanup_Mutex;
+	bool gpu_quit;
+	// GPU_Mutex guards the indices, GPU_Frame is signaled for every new frame
+	SceUID GPU_Mutex, GPU_Frame;
+	// Last frame passed to the GPU thread
+	uint32_t presented_revision;
+	bool presented;
+	uint8_t presented_zoom_state;
+	int presented_shader;
 }
 
 static int renderThread(unsigned int args, void* arg){
 	
 	for (;;){
 	
+		sceKernelWaitSema(GPU_Frame, 1, NULL);
+		
+		if (gpu_quit) sceKernelExitDeleteThread(0); // Exit procedure
+		
 		sceKernelWaitSema(GPU_Mutex, 1, NULL);
-		memcpy(vita2d_texture_get_datap(gpu_texture), vita2d_texture_get_datap(next_texture), vita2d_texture_get_stride(gpu_texture)*240);
+		const int index = ready_index;
+		ready_index = -1;
+		drawing_index = index;
 		sceKernelSignalSema(GPU_Mutex, 1);
 		
-		sceKernelWaitSema(GPU_Cleanup_Mutex, 1, NULL);
-		
-		if (main_texture == NULL) sceKernelExitDeleteThread(0); // Exit procedure
+		if (index < 0) continue;
+		vita2d_texture* gpu_texture = present_textures[index];
 		
 		vita2d_start_drawing();
    
@@ -115,7 +133,10 @@ static int renderThread(unsigned int args, void* arg){
 		vita2d_end_drawing();
 		vita2d_wait_rendering_done();
 		vita2d_swap_buffers();
-		sceKernelSignalSema(GPU_Cleanup_Mutex, 1);
+		
+		sceKernelWaitSema(GPU_Mutex, 1, NULL);
+		drawing_index = -1;
+		sceKernelSignalSema(GPU_Mutex, 1);
 	
 	}
 	
@@ -137,9 +158,16 @@ Psp2Ui::Psp2Ui(int width, int height, const Game_ConfigVideo& cfg) : BaseUi(cfg)
 	shaders[1] = vita2d_create_shader((SceGxmProgram*) sharp_bilinear_v, (SceGxmProgram*) sharp_bilinear_f);
 	shaders[2] = vita2d_create_shader((SceGxmProgram*) lcd3x_v, (SceGxmProgram*) lcd3x_f);
 	shaders[3] = vita2d_create_shader((SceGxmProgram*) xbr_2x_fast_v, (SceGxmProgram*) xbr_2x_fast_f);
-	gpu_texture = vita2d_create_empty_texture_format(
+	for (int i = 0; i < present_textures_num; ++i) {
+		present_textures[i] = vita2d_create_empty_texture_format(
 												width, height,
 												SCE_GXM_TEXTURE_FORMAT_A8B8G8R8);
+		present_damage[i] = Rect(0, 0, width, height);
+	}
+	ready_index = -1;
+	drawing_index = -1;
+	gpu_quit = false;
+	presented = false;
 	vita2d_texture_set_alloc_memblock_type(SCE_KERNEL_MEMBLOCK_TYPE_USER_RW);
 	current_display_mode.width = width;
 	current_display_mode.height = height;
@@ -154,9 +182,6 @@ Psp2Ui::Psp2Ui(int width, int height, const Game_ConfigVideo& cfg) : BaseUi(cfg)
 	main_texture = vita2d_create_empty_texture_format(
 												width, height,
 												SCE_GXM_TEXTURE_FORMAT_A8B8G8R8);
-	next_texture = vita2d_create_empty_texture_format(
-												width, height,
-												SCE_GXM_TEXTURE_FORMAT_A8B8G8R8);
 	Bitmap::SetFormat(Bitmap::ChooseFormat(format));
 	main_surface = Bitmap::Create(vita2d_texture_get_datap(main_texture),width, height, vita2d_texture_get_stride(main_texture), format);
 	
@@ -173,25 +198,27 @@ Psp2Ui::Psp2Ui(int width, int height, const Game_ConfigVideo& cfg) : BaseUi(cfg)
 	sceTouchSetSamplingState(SCE_TOUCH_PORT_FRONT, SCE_TOUCH_SAMPLING_STATE_START);
 	
 	GPU_Mutex = sceKernelCreateSema("GPU Mutex", 0, 1, 1, NULL);
-	GPU_Cleanup_Mutex = sceKernelCreateSema("GPU Cleanup Mutex", 0, 1, 1, NULL);
+	GPU_Frame = sceKernelCreateSema("GPU Frame", 0, 0, 1, NULL);
 	GPU_Thread = sceKernelCreateThread("GPU Thread", &renderThread, 0x10000100, 0x10000, 0, 0, NULL);
 	sceKernelStartThread(GPU_Thread, sizeof(GPU_Thread), &GPU_Thread);
 	
 }
 
 Psp2Ui::~Psp2Ui() {
-	sceKernelWaitSema(GPU_Cleanup_Mutex, 1, NULL);
+	gpu_quit = true;
+	sceKernelSignalSema(GPU_Frame, 1);
+	sceKernelWaitThreadEnd(GPU_Thread, NULL, NULL);
 	for (int i = 0; i < SHADERS_NUM; i++){
 		vita2d_free_shader(shaders[i]);
 	}
+	main_surface.reset();
 	vita2d_free_texture(main_texture);
 	main_texture = NULL;
-	sceKernelSignalSema(GPU_Cleanup_Mutex, 1);
-	sceKernelWaitThreadEnd(GPU_Thread, NULL, NULL);
-	vita2d_free_texture(next_texture);
-	vita2d_free_texture(gpu_texture);
+	for (int i = 0; i < present_textures_num; ++i) {
+		vita2d_free_texture(present_textures[i]);
+	}
 	sceKernelDeleteSema(GPU_Mutex);
-	sceKernelDeleteSema(GPU_Cleanup_Mutex);
+	sceKernelDeleteSema(GPU_Frame);
 	vita2d_fini();
 }
 
@@ -259,9 +286,46 @@ void Psp2Ui::ProcessEvents() {
 }
 
 void Psp2Ui::UpdateDisplay() {
+	const uint32_t revision = main_surface->GetRevision();
+	if (presented && revision == presented_revision &&
+			zoom_state == presented_zoom_state && in_use_shader == presented_shader) {
+		// Nothing changed, the screen keeps the last frame
+		return;
+	}
+
+	// Take the texture the GPU thread is not drawing, a frame waiting in it is replaced
 	sceKernelWaitSema(GPU_Mutex, 1, NULL);
-	memcpy(vita2d_texture_get_datap(next_texture), vita2d_texture_get_datap(main_texture), vita2d_texture_get_stride(main_texture)*240);
+	const int index = (drawing_index == 0) ? 1 : 0;
+	if (ready_index == index) {
+		ready_index = -1;
+	}
 	sceKernelSignalSema(GPU_Mutex, 1);
+
+	// Both textures miss the changes of this frame, the taken one also those of the frame before.
+	// Only the rows it misses are copied.
+	const Rect damage = presented ? Graphics::GetSurfaceDamage(*main_surface, presented_revision) : main_surface->GetRect();
+	for (auto& pending: present_damage) {
+		pending = pending.GetUnion(damage);
+	}
+	Rect& pending = present_damage[index];
+	pending.Adjust(main_surface->GetRect());
+	if (!pending.IsEmpty()) {
+		const int stride = vita2d_texture_get_stride(main_texture);
+		const uint8_t* src = static_cast<const uint8_t*>(vita2d_texture_get_datap(main_texture)) + pending.y * stride;
+		uint8_t* dst = static_cast<uint8_t*>(vita2d_texture_get_datap(present_textures[index])) + pending.y * stride;
+		memcpy(dst, src, stride * pending.height);
+	}
+	pending = Rect();
+
+	sceKernelWaitSema(GPU_Mutex, 1, NULL);
+	ready_index = index;
+	sceKernelSignalSema(GPU_Mutex, 1);
+	sceKernelSignalSema(GPU_Frame, 1);
+
+	presented = true;
+	presented_revision = revision;
+	presented_zoom_state = zoom_state;
+	presented_shader = in_use_shader;
 }
 
 void Psp2Ui::SetTitle(const std::string& /* title */) {
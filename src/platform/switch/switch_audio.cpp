@@ -18,6 +18,7 @@
 #if defined(__SWITCH__) && defined(SUPPORT_AUDIO)
 #include "switch_audio.h"
 #include "output.h"
+#include "thread_affinity.h"
 
 #include <switch.h>
 #include <vector>
@@ -29,12 +30,15 @@
 namespace {
 	const int samplerate = 48000;
 	const int bytes_per_sample = 4;
-	const int samples_per_buf = 4096;
-	const int buf_size = samples_per_buf * bytes_per_sample;
+	const int default_samples_per_buf = 4096;
 	NxAudio* instance = nullptr;
 }
 
 void switch_audio_thread(void*) {
+	ThreadAffinity::Apply(ThreadAffinity::Role::Audio);
+
+	const int samples_per_buf = AudioInterface::GetBufferSize(default_samples_per_buf);
+	const int buf_size = samples_per_buf * bytes_per_sample;
 	uint8_t *buffer1 = (uint8_t*)memalign(0x1000, ALIGN_TO(buf_size, 0x1000));
 	uint8_t *buffer2 = (uint8_t*)memalign(0x1000, ALIGN_TO(buf_size, 0x1000));
 	uint32_t released_count;
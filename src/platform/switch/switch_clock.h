@@ -39,6 +39,10 @@ struct NxClock {
 	template <typename R, typename P>
 	static void SleepFor(std::chrono::duration<R,P> dt);
 
+	static void YieldThread();
+
+	static constexpr std::chrono::microseconds SleepMargin();
+
 	static constexpr const char* Name();
 };
 
@@ -53,6 +57,14 @@ inline void NxClock::SleepFor(std::chrono::duration<R,P> dt) {
 	svcSleepThread(ns.count());
 }
 
+inline void NxClock::YieldThread() {
+	svcSleepThread(YieldType_WithoutCoreMigration);
+}
+
+constexpr std::chrono::microseconds NxClock::SleepMargin() {
+	return std::chrono::microseconds(250);
+}
+
 constexpr const char* NxClock::Name() {
 	return "NxClock";
 }
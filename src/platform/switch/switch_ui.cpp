@@ -25,6 +25,7 @@
 #include "output.h"
 #include "player.h"
 #include "bitmap.h"
+#include "thread_affinity.h"
 
 #include <switch.h>
 #include <EGL/egl.h>
@@ -224,6 +225,9 @@ static GLuint createAndCompileShader(GLenum type, const char* source) {
 
 NxUi::NxUi(int width, int height, const Game_ConfigVideo& cfg) : BaseUi(cfg)
 {
+	// The audio thread is moved to its own core, see ThreadAffinity
+	ThreadAffinity::Apply(ThreadAffinity::Role::Main);
+
 #if 1
 	setenv("MESA_NO_ERROR", "1", 1);
 #else
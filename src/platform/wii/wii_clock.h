@@ -20,6 +20,7 @@
 
 #ifdef GEKKO
 
+#include <ogc/lwp.h>
 #include <ogc/lwp_watchdog.h>
 #include <cstdint>
 #include <chrono>
@@ -40,6 +41,10 @@ struct WiiClock {
 	template <typename R, typename P>
 	static void SleepFor(std::chrono::duration<R,P> dt);
 
+	static void YieldThread();
+
+	static constexpr std::chrono::microseconds SleepMargin();
+
 	static constexpr const char* Name();
 };
 
@@ -53,6 +58,14 @@ inline void WiiClock::SleepFor(std::chrono::duration<R,P> dt) {
 	std::this_thread::sleep_for(dt);
 }
 
+inline void WiiClock::YieldThread() {
+	LWP_YieldThread();
+}
+
+constexpr std::chrono::microseconds WiiClock::SleepMargin() {
+	return std::chrono::microseconds(1000);
+}
+
 constexpr const char* WiiClock::Name() {
 	return "WiiClock";
 }
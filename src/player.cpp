@@ -24,6 +24,12 @@
 #include <iomanip>
 #include <fstream>
 #include <thread>
+#ifdef HAVE_THREADS
+#  include <cassert>
+#  include <condition_variable>
+#  include <functional>
+#  include <mutex>
+#endif
 
 #ifdef _WIN32
 #  include "platform/windows/utils.h"
@@ -41,14 +47,21 @@
 #  include <switch.h>
 #endif
 
+#include "asset_cache.h"
 #include "async_handler.h"
 #include "audio.h"
+#include "audio_secache.h"
+#include "battle_simulator.h"
 #include "cache.h"
+#include "capture.h"
 #include "rand.h"
 #include "cmdline_parser.h"
 #include "dynrpg.h"
 #include "filefinder.h"
+#include "font.h"
 #include "fileext_guesser.h"
+#include "frame_arena.h"
+#include "frame_stats.h"
 #include "game_actors.h"
 #include "game_battle.h"
 #include "game_map.h"
@@ -70,6 +83,8 @@
 #include <lcf/lmt/reader.h>
 #include <lcf/lsd/reader.h>
 #include "main_data.h"
+#include "memory_pressure.h"
+#include "memory_stats.h"
 #include "output.h"
 #include "player.h"
 #include <lcf/reader_lcf.h>
@@ -77,15 +92,23 @@
 #include "scene_battle.h"
 #include "scene_logo.h"
 #include "scene_map.h"
+#include "scene_save.h"
 #include "utils.h"
 #include "version.h"
 #include "game_quit.h"
 #include "scene_title.h"
 #include "instrumentation.h"
+#include "job_system.h"
+#include "audio_simd.h"
+#include "bitmap_simd.h"
+#include "cpu_features.h"
 #include "transition.h"
 #include <lcf/scope_guard.h>
 #include "baseui.h"
 #include "game_clock.h"
+#include "game_interpreter.h"
+#include "headless_ui.h"
+#include "startup_stats.h"
 
 #ifndef EMSCRIPTEN
 // This is not used on Emscripten.
@@ -120,6 +143,8 @@ namespace Player {
 	int frames;
 	std::string replay_input_path;
 	std::string record_input_path;
+	bool record_input_binary = false;
+	std::string capture_path;
 	std::string command_line;
 	int speed_modifier = 3;
 	Game_ConfigPlayer player_config;
@@ -135,12 +160,135 @@ namespace {
 	// Overwritten by --encoding
 	std::string forced_encoding;
 
+	/** Composite on a worker thread while presenting, see Player::Draw */
+	bool draw_pipelined = false;
+	/** A frame was uploaded by the pipeline and is not presented yet */
+	bool frame_uploaded = false;
+
+	/** Display surface and its revision at the last UpdateDisplay */
+	const Bitmap* presented_surface = nullptr;
+	uint32_t presented_revision = 0;
+	/** The last Draw did not present, see Player::Draw */
+	bool present_skipped = false;
+
+	/** Time of the last event processing, the input used by the logic was sampled then */
+	Game_Clock::time_point input_sample_time;
+
+	/** Overwritten by --headless-output */
+	std::string headless_output;
+
 	FileRequestBinding system_request_id;
 	FileRequestBinding save_request_id;
 	FileRequestBinding map_request_id;
+
+	/** LoadSavegame parses the savegame on a worker, see Player::IsLoadingSavegame */
+	bool savegame_loading = false;
+
+#ifdef HAVE_THREADS
+	std::mutex lcf_mutex;
+#endif
+}
+
+#ifdef HAVE_THREADS
+namespace {
+	/** Thread compositing the frames of the pipelined mode */
+	class DrawWorker {
+	public:
+		~DrawWorker();
+
+		/** Calls fn on the worker thread, returns immediately */
+		void Start(std::function<void()> fn);
+
+		/** Waits until the function passed to Start returned */
+		void Wait();
+
+	private:
+		void Work();
+
+		std::thread thread;
+		std::mutex mutex;
+		std::condition_variable cv;
+		std::function<void()> job;
+		bool busy = false;
+		bool quit = false;
+	};
+
+	DrawWorker::~DrawWorker() {
+		if (!thread.joinable()) {
+			return;
+		}
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			quit = true;
+		}
+		cv.notify_all();
+		thread.join();
+	}
+
+	void DrawWorker::Start(std::function<void()> fn) {
+		if (!thread.joinable()) {
+			thread = std::thread([this]() { Work(); });
+		}
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			assert(!busy);
+			job = std::move(fn);
+			busy = true;
+		}
+		cv.notify_all();
+	}
+
+	void DrawWorker::Wait() {
+		std::unique_lock<std::mutex> lock(mutex);
+		cv.wait(lock, [this]() { return !busy; });
+	}
+
+	void DrawWorker::Work() {
+		std::unique_lock<std::mutex> lock(mutex);
+		while (true) {
+			cv.wait(lock, [this]() { return quit || busy; });
+			if (quit) {
+				return;
+			}
+			lock.unlock();
+			job();
+			lock.lock();
+			job = nullptr;
+			busy = false;
+			cv.notify_all();
+		}
+	}
+
+	DrawWorker& GetDrawWorker() {
+		static DrawWorker worker;
+		return worker;
+	}
+}
+#endif
+
+/** Registers the caches which release memory when the OS runs low */
+static void RegisterMemoryPressure() {
+	using MemoryPressure::Level;
+
+	// Cheapest to restore first
+	MemoryPressure::Register(0, [](Level level) {
+		Game_Map::TrimMapCache(MemoryPressure::GetFloor(level, Game_Map::GetMapCacheSize()));
+	});
+	MemoryPressure::Register(1, [](Level level) {
+		AudioSeCache::Trim(MemoryPressure::GetFloor(level, AudioSeCache::GetStats().bytes));
+	});
+	MemoryPressure::Register(2, [](Level level) {
+		if (level == Level::Critical) {
+			Font::TrimGlyphCaches();
+		}
+	});
+	MemoryPressure::Register(3, [](Level level) {
+		Cache::Trim(MemoryPressure::GetFloor(level, Cache::GetStats().bytes));
+	});
 }
 
 void Player::Init(int argc, char *argv[]) {
+	StartupStats::Begin();
 	frames = 0;
 
 	// Must be called before the first call to Output
@@ -176,7 +324,18 @@ void Player::Init(int argc, char *argv[]) {
 	Game_Clock::logClockInfo();
 	Rand::SeedRandomNumberGenerator(time(NULL));
 
-	auto cfg = ParseCommandLine(argc, argv);
+	Game_Config cfg;
+	{
+		StartupStats::Scope scope(StartupStats::Stage::CommandLine);
+		cfg = ParseCommandLine(argc, argv);
+	}
+
+	// The kernels bind to the CPU features on their first use
+	if (!CpuFeatures::SetOverride(cfg.player.simd.Get())) {
+		Output::Warning("Unknown SIMD mode {}, using auto", cfg.player.simd.Get());
+	}
+	Output::Debug("CPU: {}, kernels: Bitmap {}, Audio {}", CpuFeatures::GetDescription(),
+			BitmapSimd::GetToneRowVariant(), AudioSimd::GetVariant());
 
 #ifdef EMSCRIPTEN
 	Output::IgnorePause(true);
@@ -199,15 +358,38 @@ void Player::Init(int argc, char *argv[]) {
 	DisplayUi.reset();
 
 	if(! DisplayUi) {
+		AudioInterface::SetBufferSize(cfg.audio.buffer_size.Get());
 		DisplayUi = BaseUi::CreateUi(SCREEN_TARGET_WIDTH, SCREEN_TARGET_HEIGHT, cfg.video);
 	}
 
+	Graphics::SetDrawThreads(cfg.video.draw_threads.Get());
+	draw_pipelined = cfg.video.pipelined.Get();
+	Graphics::SetShowFrameStats(cfg.video.show_frame_stats.Get());
+	Game_Clock::SetPacing(cfg.video.frame_pacing.Get() == "strict" ? Game_Clock::Pacing::Strict : Game_Clock::Pacing::FixedStep);
+	Game_Clock::SetMaxFrameSkip(cfg.video.max_frameskip.Get());
+	if (cfg.video.headless.Get()) {
+		// Every loop runs one logic step as fast as possible
+		Game_Clock::SetPacing(Game_Clock::Pacing::Strict);
+		headless_output = cfg.video.headless_output.Get();
+	}
+	JobSystem::Init();
+	Cache::SetLimit(static_cast<size_t>(cfg.player.cache_size.Get()) * 1024 * 1024);
+	Cache::SetDecodeThreads(cfg.player.decode_threads.Get());
+	AssetCache::SetDirectory(cfg.player.asset_cache_path.Get());
+	RegisterMemoryPressure();
+	Game_Interpreter::SetFrameBudget(std::chrono::milliseconds(cfg.player.interpreter_budget.Get()));
+	Output::SetScreenshotCompression(cfg.video.screenshot_compression.Get());
+
 	auto buttons = Input::GetDefaultButtonMappings();
 	auto directions = Input::GetDefaultDirectionMappings();
 
-	Input::Init(std::move(buttons), std::move(directions), replay_input_path, record_input_path);
+	Input::Init(std::move(buttons), std::move(directions), replay_input_path, record_input_path, record_input_binary);
 	Input::AddRecordingData(Input::RecordingData::CommandLine, command_line);
 
+	if (!capture_path.empty()) {
+		Capture::Start(capture_path);
+	}
+
 	player_config = std::move(cfg.player);
 }
 
@@ -237,21 +419,41 @@ void Player::Run() {
 }
 
 void Player::MainLoop() {
+	MainLoop(Game_Clock::now());
+}
+
+void Player::MainLoop(Game_Clock::time_point frame_time) {
 	Instrumentation::FrameScope iframe;
 
-	const auto frame_time = Game_Clock::now();
 	Game_Clock::OnNextFrame(frame_time);
 
-	Player::UpdateInput();
+	AsyncHandler::Update();
+	JobSystem::Update();
+	MemoryPressure::Update();
+	Output::WriteThreadMessages();
+
+	// Sampled as late as possible before the logic reads it
+	{
+		FrameStats::Scope scope(FrameStats::Phase::Input);
+		Player::UpdateInput();
+	}
 
 	int num_updates = 0;
 	while (Game_Clock::NextGameTimeStep()) {
 		if (num_updates > 0) {
+			FrameStats::Scope scope(FrameStats::Phase::Input);
 			Player::UpdateInput();
 		}
 
-		Scene::old_instances.clear();
-		Scene::instance->MainFunction();
+		{
+			FrameStats::Scope scope(FrameStats::Phase::Update);
+			Scene::old_instances.clear();
+			Game_Interpreter::ResetFrameBudget();
+			Scene::instance->MainFunction();
+		}
+		if (Input::GetAllRawTriggered().any() || Input::GetAllRawReleased().any()) {
+			FrameStats::MarkInputChange(input_sample_time);
+		}
 
 		++num_updates;
 	}
@@ -264,12 +466,21 @@ void Player::MainLoop() {
 
 	Scene::old_instances.clear();
 
+	// Short lived containers of the logic and the draw are gone now
+	FrameArena::Reset();
+
+	StartupStats::OnFrameEnd();
+
 	if (!Transition::instance().IsActive() && Scene::instance->type == Scene::Null) {
 		Exit();
 		return;
 	}
 
 	auto frame_limit = DisplayUi->GetFrameLimit();
+	if (frame_limit == Game_Clock::duration() && present_skipped) {
+		// No present waited for vsync, sleep until the next logic step instead of spinning
+		frame_limit = Game_Clock::GetTargetGameTimeStep();
+	}
 	if (frame_limit == Game_Clock::duration()) {
 #ifdef EMSCRIPTEN
 		emscripten_sleep(0);
@@ -278,11 +489,10 @@ void Player::MainLoop() {
 	}
 
 	// Still time after graphic update? Yield until it's time for next one.
-	auto now = Game_Clock::now();
 	auto next = frame_time + frame_limit;
 	if (Game_Clock::now() < next) {
 		iframe.End();
-		Game_Clock::SleepFor(next - now);
+		Game_Clock::SleepUntil(next);
 	} else {
 #ifdef EMSCRIPTEN
 		// Yield back to browser once per frame
@@ -327,6 +537,7 @@ void Player::UpdateInput() {
 
 	// Update Logic:
 	DisplayUi->ProcessEvents();
+	input_sample_time = Game_Clock::now();
 }
 
 void Player::Update(bool update_scene) {
@@ -376,14 +587,67 @@ void Player::Update(bool update_scene) {
 			Main_Data::game_ineluki->Update();
 		}
 
+		INSTRUMENTATION_SCOPE("Scene::Update");
 		Scene::instance->Update();
 	}
 }
 
 void Player::Draw() {
 	Graphics::Update();
-	Graphics::Draw(*DisplayUi->GetDisplaySurface());
-	DisplayUi->UpdateDisplay();
+	present_skipped = false;
+
+#ifdef HAVE_THREADS
+	if (draw_pipelined && DisplayUi->CanPresentWhileDrawing()) {
+		// This frame is composited on the worker while the previous one is presented.
+		// The main thread does not touch any drawable until the worker is done.
+		BitmapRef surface = DisplayUi->GetDisplaySurface();
+		auto& worker = GetDrawWorker();
+		worker.Start([surface]() {
+			FrameStats::Scope scope(FrameStats::Phase::Draw);
+			Graphics::Draw(*surface);
+		});
+		{
+			FrameStats::Scope scope(FrameStats::Phase::Display);
+			if (frame_uploaded) {
+				DisplayUi->PresentDisplay();
+				FrameStats::OnFramePresented(Game_Clock::now());
+			}
+		}
+		worker.Wait();
+		FrameStats::OnFrameDrawn();
+		Capture::OnFrame(*surface);
+		FrameStats::Scope scope(FrameStats::Phase::Display);
+		DisplayUi->UploadDisplay();
+		frame_uploaded = true;
+		return;
+	}
+#endif
+	frame_uploaded = false;
+
+	const BitmapRef& surface = DisplayUi->GetDisplaySurface();
+	{
+		FrameStats::Scope scope(FrameStats::Phase::Draw);
+		Graphics::Draw(*surface);
+	}
+	FrameStats::OnFrameDrawn();
+	Capture::OnFrame(*surface);
+
+	// Nothing was drawn since the last present and the screen still shows it
+	present_skipped = DisplayUi->CanSkipPresent() && surface.get() == presented_surface
+		&& surface->GetRevision() == presented_revision;
+	if (present_skipped) {
+		return;
+	}
+
+	{
+		FrameStats::Scope scope(FrameStats::Phase::Display);
+		DisplayUi->UpdateDisplay();
+	}
+	// Recorded after the present, a display reading the pixels through
+	// non-const access changes the revision
+	presented_surface = surface.get();
+	presented_revision = surface->GetRevision();
+	FrameStats::OnFramePresented(Game_Clock::now());
 }
 
 void Player::IncFrame() {
@@ -407,6 +671,28 @@ void Player::Exit() {
 	DisplayUi->UpdateDisplay();
 #endif
 
+	Output::Debug("Frame pacing: {} skipped draws, {} dropped steps",
+			Game_Clock::GetSkippedDraws(), Game_Clock::GetDroppedSteps());
+	const auto sleep_stats = Game_Clock::GetSleepStats();
+	Output::Debug("Frame sleeps: {}, {:.3f} ms mean late, {:.3f} ms max late, {:.3f} ms margin",
+			sleep_stats.sleeps, sleep_stats.GetMeanLate(),
+			std::chrono::duration<double, std::milli>(sleep_stats.max_late).count(),
+			std::chrono::duration<double, std::milli>(sleep_stats.margin).count());
+	const auto arena_stats = FrameArena::GetStats();
+	Output::Debug("Frame arena: {} KiB peak, {} KiB reserved",
+			arena_stats.peak_bytes / 1024, arena_stats.capacity / 1024);
+	Instrumentation::Quit();
+
+	// A save in progress is finished before DynRpg is reset
+	Scene_Save::FinishSave();
+	Input::FinishRecording();
+	Capture::Stop();
+	JobSystem::Quit();
+
+	if (!headless_output.empty() && DisplayUi) {
+		static_cast<HeadlessUi&>(*DisplayUi).WriteResult(headless_output);
+	}
+
 	Player::ResetGameObjects();
 	Font::Dispose();
 	DynRpg::Reset();
@@ -517,6 +803,15 @@ Game_Config Player::ParseCommandLine(int argc, char *argv[]) {
 			}
 			continue;
 		}
+		if (cp.ParseNext(arg, 2, "--battle-simulate")) {
+			if (arg.NumValues() > 0 && arg.ParseValue(0, li_value)) {
+				Game_Battle::battle_test.simulations = std::max(0L, li_value);
+			}
+			if (arg.NumValues() > 1 && arg.ParseValue(1, li_value)) {
+				Game_Battle::battle_test.simulation_seed = li_value;
+			}
+			continue;
+		}
 		if (cp.ParseNext(arg, 1, "--project-path") && arg.NumValues() > 0) {
 			if (arg.NumValues() > 0) {
 #ifdef _WIN32
@@ -612,12 +907,37 @@ Game_Config Player::ParseCommandLine(int argc, char *argv[]) {
 			}
 			continue;
 		}
+		if (cp.ParseNext(arg, 1, "--capture")) {
+			if (arg.NumValues() > 0) {
+				capture_path = arg.Value(0);
+			}
+			continue;
+		}
 		if (cp.ParseNext(arg, 1, "--record-input")) {
 			if (arg.NumValues() > 0) {
 				record_input_path = arg.Value(0);
 			}
 			continue;
 		}
+		if (cp.ParseNext(arg, 1, "--record-input-format")) {
+			if (arg.NumValues() > 0) {
+				const auto& v = arg.Value(0);
+				if (v == "binary") {
+					record_input_binary = true;
+				} else if (v == "text") {
+					record_input_binary = false;
+				} else {
+					Output::Warning("Unknown input recording format {}", v);
+				}
+			}
+			continue;
+		}
+		if (cp.ParseNext(arg, 1, "--startup-stats")) {
+			if (arg.NumValues() > 0) {
+				StartupStats::SetOutputPath(arg.Value(0));
+			}
+			continue;
+		}
 		if (cp.ParseNext(arg, 1, "--replay-input")) {
 			if (arg.NumValues() > 0) {
 				replay_input_path = arg.Value(0);
@@ -673,7 +993,10 @@ void Player::CreateGameObjects() {
 	meta.reset(new Meta(meta_file));
 
 	// Guess non-standard extensions (for the DB) before loading the encoding
-	GuessNonStandardExtensions();
+	{
+		StartupStats::Scope scope(StartupStats::Stage::GuessExtensions);
+		GuessNonStandardExtensions();
+	}
 
 	GetEncoding();
 	escape_symbol = lcf::ReaderUtil::Recode("\\", encoding);
@@ -683,7 +1006,10 @@ void Player::CreateGameObjects() {
 	escape_char = Utils::DecodeUTF32(Player::escape_symbol).front();
 
 	// Check for translation-related directories and load language names.
-	translation.InitTranslations();
+	{
+		StartupStats::Scope scope(StartupStats::Stage::Translation);
+		translation.InitTranslations();
+	}
 
 	std::string game_path = Main_Data::GetProjectPath();
 	std::string save_path = Main_Data::GetSavePath();
@@ -694,7 +1020,10 @@ void Player::CreateGameObjects() {
 		Output::Debug("Using {} as Save directory", save_path);
 	}
 
-	LoadDatabase();
+	{
+		StartupStats::Scope scope(StartupStats::Stage::Database);
+		LoadDatabase();
+	}
 
 	bool no_rtp_warning_flag = false;
 	{ // Scope lifetime of variables for ini parsing
@@ -764,7 +1093,10 @@ void Player::CreateGameObjects() {
 	}
 	Output::Debug("Engine configured as: 2k={} 2k3={} MajorUpdated={} Eng={}", Player::IsRPG2k(), Player::IsRPG2k3(), Player::IsMajorUpdatedVersion(), Player::IsEnglish());
 
-	FileFinder::InitRtpPaths(no_rtp_flag, no_rtp_warning_flag);
+	{
+		StartupStats::Scope scope(StartupStats::Stage::RtpPaths);
+		FileFinder::InitRtpPaths(no_rtp_flag, no_rtp_warning_flag);
+	}
 
 	if (!FileFinder::FindDefault("dynloader.dll").empty()) {
 		patch |= PatchDynRpg;
@@ -779,44 +1111,53 @@ void Player::CreateGameObjects() {
 	Output::Debug("Patch configuration: dynrpg={} maniac={}", Player::IsPatchDynRpg(), Player::IsPatchManiac());
 
 	// ExFont parsing
-	Cache::exfont_custom.clear();
-	// Check for bundled ExFont
-	std::string exfont_file = FileFinder::FindImage(".", "ExFont");
+	{
+		StartupStats::Scope scope(StartupStats::Stage::Font);
+		Cache::exfont_custom.clear();
+		// Check for bundled ExFont
+		std::string exfont_file = FileFinder::FindImage(".", "ExFont");
 #ifndef EMSCRIPTEN
-	if (exfont_file.empty()) {
-		// Attempt reading ExFont from RPG_RT.exe (not supported on Emscripten,
-		// a ExFont can be manually bundled there)
-		std::string exep = FileFinder::FindDefault(EXE_NAME);
-		if (!exep.empty()) {
-			auto exesp = FileFinder::OpenInputStream(exep);
-			if (exesp) {
-				Output::Debug("Loading ExFont from {}", exep);
-				EXEReader exe_reader = EXEReader(exesp);
-				Cache::exfont_custom = exe_reader.GetExFont();
+		if (exfont_file.empty()) {
+			// Attempt reading ExFont from RPG_RT.exe (not supported on Emscripten,
+			// a ExFont can be manually bundled there)
+			std::string exep = FileFinder::FindDefault(EXE_NAME);
+			if (!exep.empty()) {
+				auto exesp = FileFinder::OpenInputStream(exep);
+				if (exesp) {
+					Output::Debug("Loading ExFont from {}", exep);
+					StartupStats::Scope scope(StartupStats::Stage::ExeReader);
+					EXEReader exe_reader(exesp);
+					Cache::exfont_custom = exe_reader.GetExFont();
+				} else {
+					Output::Debug("ExFont loading failed: {} not readable", exep);
+				}
 			} else {
-				Output::Debug("ExFont loading failed: {} not readable", exep);
+				Output::Debug("ExFont loading failed: {} not found", EXE_NAME);
 			}
-		} else {
-			Output::Debug("ExFont loading failed: {} not found", EXE_NAME);
 		}
-	}
 #endif
-	if (!exfont_file.empty()) {
-		auto exfont_stream = FileFinder::OpenInputStream(exfont_file);
-		if (exfont_stream) {
-			Output::Debug("Using custom ExFont: {}", exfont_file);
-			Cache::exfont_custom = Utils::ReadStream(exfont_stream);
-		} else {
-			Output::Debug("Reading custom ExFont {} failed", exfont_file);
+		if (!exfont_file.empty()) {
+			auto exfont_stream = FileFinder::OpenInputStream(exfont_file);
+			if (exfont_stream) {
+				Output::Debug("Using custom ExFont: {}", exfont_file);
+				Cache::exfont_custom = Utils::ReadStream(exfont_stream);
+			} else {
+				Output::Debug("Reading custom ExFont {} failed", exfont_file);
+			}
 		}
 	}
 
 	ResetGameObjects();
 
 	Main_Data::game_ineluki->ExecuteScriptList(FileFinder::FindDefault("autorun.script"));
+
+	StartupStats::OnGameReady();
 }
 
 void Player::ResetGameObjects() {
+	// Kept warm scenes show data of the old game
+	Scene::ClearWarm();
+
 	// The init order is important
 	Main_Data::Cleanup();
 
@@ -895,6 +1236,29 @@ void Player::GuessNonStandardExtensions() {
 	}
 }
 
+/** @return estimated size of the tables and event commands of the database */
+static size_t GetDatabaseSize() {
+	size_t size = MemoryStats::GetSize(lcf::Data::actors) + MemoryStats::GetSize(lcf::Data::skills)
+		+ MemoryStats::GetSize(lcf::Data::items) + MemoryStats::GetSize(lcf::Data::enemies)
+		+ MemoryStats::GetSize(lcf::Data::troops) + MemoryStats::GetSize(lcf::Data::terrains)
+		+ MemoryStats::GetSize(lcf::Data::attributes) + MemoryStats::GetSize(lcf::Data::states)
+		+ MemoryStats::GetSize(lcf::Data::animations) + MemoryStats::GetSize(lcf::Data::chipsets)
+		+ MemoryStats::GetSize(lcf::Data::commonevents) + MemoryStats::GetSize(lcf::Data::classes)
+		+ MemoryStats::GetSize(lcf::Data::battleranimations) + MemoryStats::GetSize(lcf::Data::switches)
+		+ MemoryStats::GetSize(lcf::Data::variables) + MemoryStats::GetSize(lcf::Data::treemap.maps);
+
+	for (const auto& ce: lcf::Data::commonevents) {
+		size += MemoryStats::GetSize(ce.event_commands);
+	}
+	for (const auto& troop: lcf::Data::troops) {
+		size += MemoryStats::GetSize(troop.pages);
+		for (const auto& page: troop.pages) {
+			size += MemoryStats::GetSize(page.event_commands);
+		}
+	}
+	return size;
+}
+
 void Player::LoadDatabase() {
 	// Load lcf::Database
 	lcf::Data::Clear();
@@ -923,19 +1287,26 @@ void Player::LoadDatabase() {
 		std::string lmt = FileFinder::FindDefault(fileext_map.MakeFilename(RPG_RT_PREFIX, SUFFIX_LMT));
 
 		auto ldb_stream = FileFinder::OpenInputStream(ldb);
-		auto db = lcf::LDB_Reader::Load(ldb_stream, encoding);
-		if (!db) {
-			Output::ErrorStr(lcf::LcfReader::GetError());
-		} else {
-			lcf::Data::data = std::move(*db);
-		}
-
 		auto lmt_stream = FileFinder::OpenInputStream(lmt);
-		auto treemap = lcf::LMT_Reader::Load(lmt_stream, encoding);
-		if (!treemap) {
-			Output::ErrorStr(lcf::LcfReader::GetError());
-		} else {
-			lcf::Data::treemap = std::move(*treemap);
+
+		if (!AssetCache::LoadDatabase(ldb, lmt, encoding)) {
+			auto db = lcf::LDB_Reader::Load(ldb_stream, encoding);
+			if (!db) {
+				Output::ErrorStr(lcf::LcfReader::GetError());
+			} else {
+				lcf::Data::data = std::move(*db);
+			}
+
+			auto treemap = lcf::LMT_Reader::Load(lmt_stream, encoding);
+			if (!treemap) {
+				Output::ErrorStr(lcf::LcfReader::GetError());
+			} else {
+				lcf::Data::treemap = std::move(*treemap);
+			}
+
+			if (db && treemap) {
+				AssetCache::StoreDatabase(ldb, lmt, encoding);
+			}
 		}
 
 		if (Input::IsRecording()) {
@@ -954,6 +1325,10 @@ void Player::LoadDatabase() {
 			FileExtGuesser::GuessAndAddLmuExtension(*FileFinder::GetDirectoryTree(), *meta, fileext_map);
 		}
 	}
+
+	Game_Map::RebuildMapIndex();
+
+	MemoryStats::Set(MemoryStats::Category::Database, GetDatabaseSize());
 }
 
 static void OnMapSaveFileReady(FileRequestResult*, lcf::rpg::Save save) {
@@ -969,27 +1344,21 @@ static void OnMapSaveFileReady(FileRequestResult*, lcf::rpg::Save save) {
 			std::move(save.common_events));
 }
 
-void Player::LoadSavegame(const std::string& save_name, int save_id) {
-	Output::Debug("Loading Save {}", FileFinder::GetPathInsidePath(Main_Data::GetSavePath(), save_name));
+static void FadeOutForLoad() {
 	Main_Data::game_system->BgmFade(800);
 
 	// We erase the screen now before loading the saved game. This prevents an issue where
 	// if the save game has a different system graphic, the load screen would change before
 	// transitioning out.
 	Transition::instance().InitErase(Transition::TransitionFadeOut, Scene::instance.get(), 6);
+}
 
+static void SetupFromSavegame(std::unique_ptr<lcf::rpg::Save> save, int save_id) {
 	auto title_scene = Scene::Find(Scene::Title);
 	if (title_scene) {
 		static_cast<Scene_Title*>(title_scene.get())->OnGameStart();
 	}
 
-	auto save_stream = FileFinder::OpenInputStream(save_name);
-	std::unique_ptr<lcf::rpg::Save> save = lcf::LSD_Reader::Load(save_stream, encoding);
-
-	if (!save.get()) {
-		Output::Error("{}", lcf::LcfReader::GetError());
-	}
-
 	std::stringstream verstr;
 	int ver = save->easyrpg_data.version;
 	if (ver == 0) {
@@ -1025,7 +1394,7 @@ void Player::LoadSavegame(const std::string& save_name, int save_id) {
 	Scene::PopUntil(Scene::Title);
 	Game_Map::Dispose();
 
-	Main_Data::game_switches->SetData(std::move(save->system.switches));
+	Main_Data::game_switches->SetData(save->system.switches);
 	Main_Data::game_variables->SetData(std::move(save->system.variables));
 	Main_Data::game_system->SetupFromSave(std::move(save->system));
 	Main_Data::game_actors->SetSaveData(std::move(save->actors));
@@ -1047,6 +1416,71 @@ void Player::LoadSavegame(const std::string& save_name, int save_id) {
 	Scene::Push(std::make_shared<Scene_Map>(save_id));
 }
 
+void Player::LoadSavegame(const std::string& save_name, int save_id) {
+	Output::Debug("Loading Save {}", FileFinder::GetPathInsidePath(Main_Data::GetSavePath(), save_name));
+	FadeOutForLoad();
+
+	// Parsed on a worker while the screen fades out, the scenes wait for it
+	if (JobSystem::GetThreadCount() > 0 && !FileFinder::IsInArchive(save_name)) {
+		auto result = std::make_shared<std::unique_ptr<lcf::rpg::Save>>();
+		auto error = std::make_shared<std::string>();
+		savegame_loading = true;
+		JobSystem::Submit([result, error, save_name, encoding = encoding]() {
+				auto save_stream = FileFinder::OpenNativeInputStream(save_name);
+#ifdef HAVE_THREADS
+				std::lock_guard<std::mutex> lock(GetLcfMutex());
+#endif
+				*result = lcf::LSD_Reader::Load(save_stream, encoding);
+				if (!*result) {
+					*error = lcf::LcfReader::GetError();
+				}
+			}, [result, error, save_id]() {
+				savegame_loading = false;
+				if (!*result) {
+					Output::Error("{}", *error);
+				}
+				SetupFromSavegame(std::move(*result), save_id);
+			}, JobSystem::Priority::High);
+		return;
+	}
+
+	auto save_stream = FileFinder::OpenInputStream(save_name);
+	std::unique_ptr<lcf::rpg::Save> save;
+	std::string error;
+	{
+#ifdef HAVE_THREADS
+		std::lock_guard<std::mutex> lock(GetLcfMutex());
+#endif
+		save = lcf::LSD_Reader::Load(save_stream, encoding);
+		if (!save) {
+			error = lcf::LcfReader::GetError();
+		}
+	}
+
+	if (!save.get()) {
+		Output::Error("{}", error);
+	}
+
+	SetupFromSavegame(std::move(save), save_id);
+}
+
+void Player::LoadSavegame(std::unique_ptr<lcf::rpg::Save> save, int save_id, bool fade_out) {
+	if (fade_out) {
+		FadeOutForLoad();
+	}
+	SetupFromSavegame(std::move(save), save_id);
+}
+
+bool Player::IsLoadingSavegame() {
+	return savegame_loading;
+}
+
+#ifdef HAVE_THREADS
+std::mutex& Player::GetLcfMutex() {
+	return lcf_mutex;
+}
+#endif
+
 static void OnMapFileReady(FileRequestResult*) {
 	int map_id = Player::start_map_id == -1 ?
 		lcf::Data::treemap.start.party_map_id : Player::start_map_id;
@@ -1118,6 +1552,22 @@ void Player::SetupBattleTest() {
 		Main_Data::game_party->SetupBattleTest();
 	}
 
+	if (Game_Battle::battle_test.simulations > 0) {
+		BattleSimulator::Config config;
+		config.troop_id = args.troop_id;
+		config.battles = Game_Battle::battle_test.simulations;
+		config.seed = Game_Battle::battle_test.simulation_seed;
+		config.condition = args.condition;
+
+		const auto start = Game_Clock::now();
+		auto result = BattleSimulator::Run(config);
+		const auto seconds = std::chrono::duration<double>(Game_Clock::now() - start).count();
+		BattleSimulator::PrintResult(config, result, seconds);
+
+		exit_flag = true;
+		return;
+	}
+
 	Scene::Push(Scene_Battle::Create(std::move(args)), true);
 }
 
@@ -1199,9 +1649,30 @@ void Player::PrintUsage() {
 	std::cout <<
 R"(EasyRPG Player - An open source interpreter for RPG Maker 2000/2003 games.
 Options:
+      --asset-cache PATH   Store decoded images and the database in the existing
+                           directory PATH.
+                           Speeds up loading on platforms with slow storage.
+      --audio-buffer N     Use audio output buffers of N sample frames. Smaller
+                           buffers lower the latency but may cause crackling.
+                           The default depends on the platform.
+      --battle-simulate N [SEED]
+                           With --battle-test simulate the battle N times
+                           without animations and messages, log the win rate
+                           and damage statistics and exit. Battle i uses the
+                           random seed SEED + i.
       --battle-test N      Start a battle test with monster party N.
+      --cache-size N       Limit the bitmap cache to N MiB. Unused images beyond
+                           the limit are freed, least recently used first.
+      --capture PATH       Write every frame and the mixed audio as raw data with
+                           timestamps to the file or named pipe PATH, for
+                           encoding a stream or a recording.
+      --decode-threads N   Decode up to N images at once on the worker threads.
+                           The default is 0, images are decoded when used.
+                           Only used when the platform supports threads.
       --disable-audio      Disable audio (in case you prefer your own music).
       --disable-rtp        Disable support for the Runtime Package (RTP).
+      --draw-threads N     Composite the screen with N threads. The default is 1.
+                           Only used when the platform supports threads.
       --encoding N         Instead of auto detecting the encoding or using
                            the one in RPG_RT.ini, the encoding N is used.
                            Use "auto" for automatic detection.
@@ -1216,31 +1687,66 @@ Options:
       --fullscreen         Start in fullscreen mode.
       --show-fps           Enable frames per second counter.
       --fps-render-window  Render the frames per second counter in windowed mode.
+      --show-frame-stats   Show the time spent in each part of a frame and the
+                           image cache counters below the FPS counter.
       --fps-limit          Set a custom frames per second limit. The default is 60 FPS.
                            Set to 0 to run with unlimited frames per second.
                            This option is not supported on all platforms.
+      --frame-pacing P     How the game logic is scheduled.
+                           Possible options:
+                            fixed      - The logic runs at 60 FPS, drawing is skipped
+                                         when the frame is late (default)
+                            strict     - One logic step per drawn frame, for
+                                         displays with vsync at 60 Hz
+      --max-frameskip N    Draws skipped at most in a row before the game runs
+                           slower. The default is 12.
       --no-vsync           Disable vertical sync and use fps-limit. Even without
                            this option, vsync may not be supported on all platforms.
       --enable-mouse       Use mouse click for decision and scroll wheel for lists
       --enable-touch       Use one/two finger tap for decision/cancel
+      --hardware-render    Draw sprites, pictures and panoramas with the GPU.
+                           Falls back to software rendering when not supported.
+      --headless           Run without a window and audio as fast as possible.
+                           Useful with --replay-input for automated tests.
+      --headless-output PATH
+                           Save the last frame of a headless run as PNG in PATH
+                           and log its checksum.
       --hide-title         Hide the title background image and center the
                            command menu.
+      --interpreter-budget N
+                           Let event interpreters run at most N milliseconds
+                           per frame. Loops exceeding it continue in the next
+                           frame. The default is 0, no limit like RPG_RT.
       --load-game-id N     Skip the title scene and load SaveN.lsd
                            (N is padded to two digits).
       --new-game           Skip the title scene and start a new game directly.
+      --pipelined          Composite the next frame while the previous frame is
+                           presented. Adds one frame of latency. Only used in
+                           software rendering when the platform supports threads.
       --project-path PATH  Instead of using the working directory the game in
-                           PATH is used.
+                           PATH is used. PATH can be a ZIP archive.
       --record-input PATH  Record all button input to a log file at PATH.
+      --record-input-format FORMAT
+                           Format of --record-input. Options: text (default)
+                           and binary, a smaller run length encoded format.
       --replay-input PATH  Replays button presses from an input log generated by
                            --record-input.
       --save-path PATH     Instead of storing save files in the game directory
                            they are stored in PATH. The directory must exist.
                            When using the game browser all games will share
                            the same save directory!
+      --screenshot-compression N
+                           Compress screenshots with zlib level N (0 to 9).
+                           0 writes them uncompressed for rapid captures.
       --seed N             Seeds the random number generator with N.
+      --simd MODE          Highest CPU extension used by the SIMD kernels, to
+                           compare them. Options: auto (default), none, sse2,
+                           avx2, neon and wasm.
       --start-map-id N     Overwrite the map used for new games and use.
                            MapN.lmu instead (N is padded to four digits).
                            Incompatible with --load-game-id.
+      --startup-stats PATH Write the time spent in the startup stages as JSON to
+                           PATH. A summary is always logged.
       --autobattle-algo A  Which AutoBattle algorithm to use.
                            Possible options:
                             RPG_RT     - The default RPG_RT compatible algo, including RPG_RT bugs
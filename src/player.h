@@ -26,6 +26,15 @@
 #include "game_config.h"
 #include <vector>
 #include <memory>
+#ifdef HAVE_THREADS
+#  include <mutex>
+#endif
+
+namespace lcf {
+namespace rpg {
+	class Save;
+}
+}
 
 /**
  * Player namespace.
@@ -69,6 +78,14 @@ namespace Player {
 	 */
 	void MainLoop();
 
+	/**
+	 * Runs the game loop for a frame that started at frame_time.
+	 * Used by platforms where the frontend paces the frames.
+	 *
+	 * @param frame_time time of the frame
+	 */
+	void MainLoop(Game_Clock::time_point frame_time);
+
 	/**
 	 * Pauses the game engine.
 	 */
@@ -143,12 +160,37 @@ namespace Player {
 
 	/**
 	 * Loads savegame data.
+	 * The file is parsed on a worker when possible, the game objects are set
+	 * up once it is parsed. The scenes wait for it, see IsLoadingSavegame.
 	 *
 	 * @param save_file Savegame file to load
 	 * @param save_id ID of the savegame to load
 	 */
 	void LoadSavegame(const std::string& save_file, int save_id = 0);
 
+	/** @return whether LoadSavegame is still parsing the savegame */
+	bool IsLoadingSavegame();
+
+#ifdef HAVE_THREADS
+	/**
+	 * Held while lcf data is parsed, one parse at a time. The error of
+	 * lcf::LcfReader is shared by all threads and must be read before the
+	 * mutex is released.
+	 *
+	 * @return mutex of the lcf parsing
+	 */
+	std::mutex& GetLcfMutex();
+#endif
+
+	/**
+	 * Loads savegame data that is already in memory.
+	 *
+	 * @param save Savegame to load
+	 * @param save_id ID of the savegame to load
+	 * @param fade_out Fade out the screen and the music first
+	 */
+	void LoadSavegame(std::unique_ptr<lcf::rpg::Save> save, int save_id, bool fade_out);
+
 	/**
 	 * Starts a new game
 	 */
@@ -334,6 +376,12 @@ namespace Player {
 	/** Path to record input log to */
 	extern std::string record_input_path;
 
+	/** Whether the input log is recorded in the binary format */
+	extern bool record_input_binary;
+
+	/** File or pipe the frames and the audio are captured to, see Capture */
+	extern std::string capture_path;
+
 	/** The concatenated command line */
 	extern std::string command_line;
 
@@ -28,40 +28,44 @@
 
 namespace {
 Rand::RNG rng;
-
-/** Gets a random number uniformly distributed in [0, U32_MAX] */
-uint32_t GetRandomU32() { return rng(); }
+Rand::RNG cosmetic_rng(~uint64_t(5489u));
 
 int32_t rng_lock_value = 0;
 bool rng_locked= false;
+
+/**
+ * Maps a random u32 to [0, m) with Lemire's multiply and shift instead of
+ * a division. The low half of the product is below threshold = 2^32 mod m
+ * for the biased numbers, these are rejected.
+ */
+uint32_t GetRandomBounded(Rand::RNG& gen, uint32_t m, uint32_t threshold) {
+	uint64_t l = uint64_t(gen()) * m;
+	while (uint32_t(l) < threshold) {
+		l = uint64_t(gen()) * m;
+	}
+	return uint32_t(l >> 32);
 }
 
 /** Generate a random number in the range [0,max] */
-static uint32_t GetRandomUnsigned(uint32_t max)
-{
-	if (max == 0xffffffffull) return GetRandomU32();
-
-	// Rejection sampling:
-	// 1. Divide the range of uint32 into blocks of max+1
-	//    numbers each, with rem numbers left over.
-	// 2. Generate a random u32. If it belongs to a block,
-	//    mod it into the range [0,max] and accept it.
-	// 3. If it fell into the range of rem leftover numbers,
-	//    reject it and go back to step 2.
-	uint32_t m = max + 1;
-	uint32_t rem = -m % m; // = 2^32 mod m
-	while (true) {
-		uint32_t n = GetRandomU32();
-		if (n >= rem)
-			return n % m;
+uint32_t GetRandomUnsigned(Rand::RNG& gen, uint32_t max) {
+	if (max == 0xffffffffull) return gen();
+
+	const uint32_t m = max + 1;
+	uint64_t l = uint64_t(gen()) * m;
+	// The threshold is below m, the division is only needed for the rare
+	// products with a low half below m. Draws the same numbers as
+	// GetRandomBounded.
+	if (uint32_t(l) < m) {
+		const uint32_t threshold = -m % m;
+		while (uint32_t(l) < threshold) {
+			l = uint64_t(gen()) * m;
+		}
 	}
+	return uint32_t(l >> 32);
 }
 
-int32_t Rand::GetRandomNumber(int32_t from, int32_t to) {
+int32_t GetRandomNumber(Rand::RNG& gen, int32_t from, int32_t to) {
 	assert(from <= to);
-	if (rng_locked) {
-		return Utils::Clamp(rng_lock_value, from, to);
-	}
 	// Don't use uniform_int_distribution--the algorithm used isn't
 	// portable between stdlibs.
 	// We do from + (rand int in [0, to-from]). The miracle of two's
@@ -70,12 +74,61 @@ int32_t Rand::GetRandomNumber(int32_t from, int32_t to) {
 	uint32_t ufrom = uint32_t(from);
 	uint32_t uto = uint32_t(to);
 	uint32_t urange = uto - ufrom;
-	uint32_t ures = ufrom + GetRandomUnsigned(urange);
+	uint32_t ures = ufrom + GetRandomUnsigned(gen, urange);
 	return int32_t(ures);
 }
+}
+
+void Rand::RNG::seed(uint64_t seed) {
+	// splitmix64, an all zero state is impossible
+	for (auto& x: s) {
+		uint64_t z = (seed += 0x9e3779b97f4a7c15ull);
+		z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+		z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+		x = uint32_t(z ^ (z >> 31));
+	}
+}
+
+int32_t Rand::GetRandomNumber(int32_t from, int32_t to) {
+	assert(from <= to);
+	if (rng_locked) {
+		return Utils::Clamp(rng_lock_value, from, to);
+	}
+	return ::GetRandomNumber(rng, from, to);
+}
+
+void Rand::GetRandomNumbers(Span<int32_t> out, int32_t from, int32_t to) {
+	assert(from <= to);
+	if (rng_locked) {
+		std::fill(out.begin(), out.end(), Utils::Clamp(rng_lock_value, from, to));
+		return;
+	}
+
+	// Same sampling as GetRandomUnsigned, on a local copy of the
+	// generator which the compiler can keep in registers
+	auto gen = rng;
+	const uint32_t ufrom = uint32_t(from);
+	const uint32_t urange = uint32_t(to) - ufrom;
+	if (urange == 0xffffffffull) {
+		for (auto& x: out) {
+			x = int32_t(ufrom + gen());
+		}
+	} else {
+		const uint32_t m = urange + 1;
+		const uint32_t threshold = -m % m;
+		for (auto& x: out) {
+			x = int32_t(ufrom + GetRandomBounded(gen, m, threshold));
+		}
+	}
+	rng = gen;
+}
+
+int32_t Rand::GetCosmeticNumber(int32_t from, int32_t to) {
+	return ::GetRandomNumber(cosmetic_rng, from, to);
+}
 
-Rand::RNG& Rand::GetRNG() {
-	return rng;
+Rand::RNG& Rand::GetRNG(Stream stream) {
+	return stream == Stream::Cosmetic ? cosmetic_rng : rng;
 }
 
 bool Rand::ChanceOf(int32_t n, int32_t m) {
@@ -93,7 +146,8 @@ bool Rand::PercentChance(int rate) {
 }
 
 void Rand::SeedRandomNumberGenerator(int32_t seed) {
-	rng.seed(seed);
+	rng.seed(uint32_t(seed));
+	cosmetic_rng.seed(~uint64_t(uint32_t(seed)));
 	Output::Debug("Seeded the RNG with {}.", seed);
 }
 
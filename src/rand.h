@@ -18,6 +18,7 @@
 #ifndef EP_RANDOM_H
 #define EP_RANDOM_H
 
+#include <cstdint>
 #include <functional>
 #include <string>
 #include <sstream>
@@ -29,9 +30,49 @@
 
 namespace Rand {
 /**
- * The random number generator object to use
+ * The random number generator object to use, xoshiro128** by
+ * Blackman and Vigna. Fulfills UniformRandomBitGenerator, so it can be
+ * used with std::shuffle and the std distributions.
  */
-using RNG = std::mt19937;
+class RNG {
+public:
+	using result_type = uint32_t;
+
+	/** Seeds with the default seed */
+	RNG();
+
+	/** Seeds with the given seed */
+	explicit RNG(uint64_t seed);
+
+	/**
+	 * Sets the state from the seed, expanded with splitmix64.
+	 *
+	 * @param seed Seed to use
+	 */
+	void seed(uint64_t seed);
+
+	/** @return the next random number in [0, U32_MAX] */
+	result_type operator()();
+
+	static constexpr result_type min() { return 0; }
+	static constexpr result_type max() { return UINT32_MAX; }
+
+private:
+	static uint32_t rotl(uint32_t x, int k);
+
+	uint32_t s[4];
+};
+
+/**
+ * The streams of random numbers. Every stream has its own generator,
+ * so drawing from one does not change the numbers of the others.
+ */
+enum class Stream {
+	/** Everything which changes the game state: battles, events, encounters */
+	Game,
+	/** Visual effects only: weather and transitions, never locked */
+	Cosmetic
+};
 
 /**
  * Gets a random number in the inclusive range from - to.
@@ -43,11 +84,33 @@ using RNG = std::mt19937;
 int32_t GetRandomNumber(int32_t from, int32_t to);
 
 /**
- * Gets the seeded Random Number Generator (RNG).
+ * Fills a buffer with random numbers in the inclusive range from - to.
+ * Produces the same numbers as calling GetRandomNumber for every element,
+ * the range is only prepared once.
  *
+ * @param out buffer to fill
+ * @param from Interval start
+ * @param to Interval end
+ */
+void GetRandomNumbers(Span<int32_t> out, int32_t from, int32_t to);
+
+/**
+ * Gets a random number of the cosmetic stream in the inclusive range from - to.
+ * Not affected by LockRandom.
+ *
+ * @param from Interval start
+ * @param to Interval end
+ * @return Random number in inclusive interval
+ */
+int32_t GetCosmeticNumber(int32_t from, int32_t to);
+
+/**
+ * Gets the seeded Random Number Generator (RNG) of a stream.
+ *
+ * @param stream the stream
  * @return the random number generator
  */
-RNG& GetRNG();
+RNG& GetRNG(Stream stream = Stream::Game);
 
 /**
  * Has an n/m chance of returning true. If n>m, always returns true.
@@ -77,6 +140,7 @@ bool PercentChance(long rate);
 
 /**
  * Seeds the RNG used by GetRandomNumber and ChanceOf.
+ * The cosmetic stream gets a seed derived from the same seed.
  *
  * @param seed Seed to use
  */
@@ -137,6 +201,31 @@ private:
 	bool _active = false;
 };
 
+inline RNG::RNG() : RNG(5489u) {
+}
+
+inline RNG::RNG(uint64_t seed) {
+	this->seed(seed);
+}
+
+inline uint32_t RNG::rotl(uint32_t x, int k) {
+	return (x << k) | (x >> (32 - k));
+}
+
+inline RNG::result_type RNG::operator()() {
+	const uint32_t result = rotl(s[1] * 5, 7) * 9;
+	const uint32_t t = s[1] << 9;
+
+	s[2] ^= s[0];
+	s[3] ^= s[1];
+	s[1] ^= s[2];
+	s[0] ^= s[3];
+	s[2] ^= t;
+	s[3] = rotl(s[3], 11);
+
+	return result;
+}
+
 inline bool PercentChance(long rate) {
 	return PercentChance(static_cast<int>(rate));
 }
@@ -17,6 +17,7 @@
 
 // Headers
 #include "rect.h"
+#include <algorithm>
 
 void Rect::Adjust(int max_width, int max_height) {
 	if (x < 0) {
@@ -96,6 +97,22 @@ Rect Rect::GetSubRect(const Rect src_rect) const {
 	return rect;
 }
 
+Rect Rect::GetUnion(const Rect& rect) const {
+	if (rect.IsEmpty()) {
+		return *this;
+	}
+	if (IsEmpty()) {
+		return rect;
+	}
+
+	const int left = std::min(x, rect.x);
+	const int top = std::min(y, rect.y);
+	const int right = std::max(x + width, rect.x + rect.width);
+	const int bottom = std::max(y + height, rect.y + rect.height);
+
+	return Rect(left, top, right - left, bottom - top);
+}
+
 bool Rect::AdjustRectangles(Rect& src, Rect& dst, const Rect& ref) {
 	if (src.x < ref.x) {
 		int dx = ref.x - src.x;
@@ -89,6 +89,15 @@ public:
 	 */
 	Rect GetSubRect(Rect rect) const;
 
+	/**
+	 * Gets the smallest rect containing this and the given rect.
+	 * Empty rects are ignored.
+	 *
+	 * @param rect rect.
+	 * @return the bounding rect of both rects.
+	 */
+	Rect GetUnion(const Rect& rect) const;
+
 	/** X coordinate. */
 	int x = 0;
 
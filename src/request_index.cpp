@@ -0,0 +1,167 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include <algorithm>
+#include <cstring>
+#include "request_index.h"
+
+namespace {
+	constexpr char magic[4] = { 'E', 'P', 'R', 'I' };
+	constexpr uint32_t format_version = 1;
+	constexpr size_t header_size = 12;
+	constexpr size_t entry_size = 20;
+
+	/** Field offsets in an entry */
+	constexpr int field_hash = 0;
+	constexpr int field_key = 4;
+	constexpr int field_value = 12;
+
+	void WriteU32(std::vector<uint8_t>& out, uint32_t value) {
+		for (int i = 0; i < 4; ++i) {
+			out.push_back(static_cast<uint8_t>((value >> (8 * i)) & 0xFF));
+		}
+	}
+}
+
+constexpr uint32_t RequestIndex::hash_seed;
+
+uint32_t RequestIndex::Hash(StringView key, uint32_t seed) {
+	uint32_t hash = seed;
+	for (char c : key) {
+		hash = (hash ^ static_cast<uint8_t>(c)) * 16777619u;
+	}
+	return hash;
+}
+
+uint32_t RequestIndex::ReadU32(size_t offset) const {
+	const uint8_t* p = data.data() + offset;
+	return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+StringView RequestIndex::ReadString(size_t entry, int field) const {
+	const size_t pos = header_size + entry * entry_size + field;
+	return StringView(reinterpret_cast<const char*>(data.data()) + ReadU32(pos), ReadU32(pos + 4));
+}
+
+bool RequestIndex::Load(std::vector<uint8_t> contents) {
+	data = std::move(contents);
+	count = 0;
+
+	if (data.size() < header_size || std::memcmp(data.data(), magic, sizeof(magic)) != 0
+			|| ReadU32(4) != format_version) {
+		data.clear();
+		return false;
+	}
+
+	const uint32_t entries = ReadU32(8);
+	if (entries > (data.size() - header_size) / entry_size) {
+		data.clear();
+		return false;
+	}
+
+	// Checked once, so Find can not read out of bounds
+	for (uint32_t i = 0; i < entries; ++i) {
+		const size_t pos = header_size + i * entry_size;
+		for (int field : { field_key, field_value }) {
+			const uint64_t offset = ReadU32(pos + field);
+			const uint64_t length = ReadU32(pos + field + 4);
+			if (offset + length > data.size()) {
+				data.clear();
+				return false;
+			}
+		}
+	}
+
+	count = entries;
+	return true;
+}
+
+StringView RequestIndex::Find(StringView key) const {
+	return Find({ key });
+}
+
+StringView RequestIndex::Find(std::initializer_list<StringView> parts) const {
+	uint32_t hash = hash_seed;
+	size_t size = 0;
+	for (const auto& part : parts) {
+		hash = Hash(part, hash);
+		size += part.size();
+	}
+
+	// Binary search for the first entry with the hash
+	uint32_t first = 0;
+	uint32_t len = count;
+	while (len > 0) {
+		const uint32_t half = len / 2;
+		if (ReadU32(header_size + (first + half) * entry_size + field_hash) < hash) {
+			first += half + 1;
+			len -= half + 1;
+		} else {
+			len = half;
+		}
+	}
+
+	for (uint32_t i = first; i < count && ReadU32(header_size + i * entry_size + field_hash) == hash; ++i) {
+		StringView key = ReadString(i, field_key);
+		if (key.size() != size) {
+			continue;
+		}
+
+		bool match = true;
+		for (const auto& part : parts) {
+			if (key.substr(0, part.size()) != part) {
+				match = false;
+				break;
+			}
+			key.remove_prefix(part.size());
+		}
+		if (match) {
+			return ReadString(i, field_value);
+		}
+	}
+	return {};
+}
+
+std::vector<uint8_t> RequestIndex::Build(std::vector<std::pair<std::string, std::string>> entries) {
+	std::sort(entries.begin(), entries.end(), [](const auto& l, const auto& r) {
+		const uint32_t lh = Hash(l.first);
+		const uint32_t rh = Hash(r.first);
+		return lh != rh ? lh < rh : l.first < r.first;
+	});
+
+	std::vector<uint8_t> out(magic, magic + sizeof(magic));
+	WriteU32(out, format_version);
+	WriteU32(out, static_cast<uint32_t>(entries.size()));
+
+	uint32_t offset = static_cast<uint32_t>(header_size + entries.size() * entry_size);
+	for (const auto& entry : entries) {
+		WriteU32(out, Hash(entry.first));
+		WriteU32(out, offset);
+		WriteU32(out, static_cast<uint32_t>(entry.first.size()));
+		offset += static_cast<uint32_t>(entry.first.size());
+		WriteU32(out, offset);
+		WriteU32(out, static_cast<uint32_t>(entry.second.size()));
+		offset += static_cast<uint32_t>(entry.second.size());
+	}
+
+	for (const auto& entry : entries) {
+		out.insert(out.end(), entry.first.begin(), entry.first.end());
+		out.insert(out.end(), entry.second.begin(), entry.second.end());
+	}
+	return out;
+}
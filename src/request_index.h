@@ -0,0 +1,117 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_REQUEST_INDEX_H
+#define EP_REQUEST_INDEX_H
+
+// Headers
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <utility>
+#include <vector>
+#include "string_view.h"
+
+/**
+ * Binary replacement of index.json, maps the normalized path of a game file
+ * (see lcf::ReaderUtil::Normalize) to its path on the web server.
+ * The file is used as loaded, lookups do not allocate.
+ *
+ * Layout, all integers are 32 bit little endian:
+ *   magic "EPRI", version, entry count
+ *   entries: hash, key offset, key length, value offset, value length
+ *   string data, offsets are relative to the start of the file
+ * Entries are sorted by hash and then by key. The hash is 32 bit FNV-1a of the key.
+ *
+ * The format is generic, compiled translation catalogs use it as well.
+ */
+class RequestIndex {
+public:
+	/**
+	 * Takes the contents of an index file.
+	 *
+	 * @param data file contents
+	 * @return false when data is not a valid index, the index is empty then
+	 */
+	bool Load(std::vector<uint8_t> data);
+
+	/** @return whether an index was loaded */
+	bool IsLoaded() const;
+
+	/** @return number of entries */
+	uint32_t GetSize() const;
+
+	/**
+	 * Looks up a normalized path.
+	 *
+	 * @param key normalized path
+	 * @return mapped path pointing into the index data or an empty view when not found
+	 */
+	StringView Find(StringView key) const;
+
+	/**
+	 * Looks up the concatenation of several parts without building it.
+	 *
+	 * @param parts parts of the key
+	 * @return value pointing into the index data or an empty view when not found
+	 */
+	StringView Find(std::initializer_list<StringView> parts) const;
+
+	/**
+	 * Creates the contents of an index file, the reference for packaging tools.
+	 *
+	 * @param entries pairs of normalized path and mapped path
+	 * @return file contents
+	 */
+	static std::vector<uint8_t> Build(std::vector<std::pair<std::string, std::string>> entries);
+
+	/** @return contents of the loaded index */
+	const std::vector<uint8_t>& GetData() const;
+
+	/** Initial value of Hash */
+	static constexpr uint32_t hash_seed = 2166136261u;
+
+	/**
+	 * Hashes a key as stored in the index.
+	 *
+	 * @param key key or part of a key
+	 * @param seed hash_seed or the hash of the preceding parts
+	 * @return hash
+	 */
+	static uint32_t Hash(StringView key, uint32_t seed = hash_seed);
+
+private:
+	uint32_t ReadU32(size_t offset) const;
+	StringView ReadString(size_t entry, int field) const;
+
+	std::vector<uint8_t> data;
+	uint32_t count = 0;
+};
+
+inline bool RequestIndex::IsLoaded() const {
+	return !data.empty();
+}
+
+inline uint32_t RequestIndex::GetSize() const {
+	return count;
+}
+
+inline const std::vector<uint8_t>& RequestIndex::GetData() const {
+	return data;
+}
+
+#endif
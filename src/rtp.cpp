@@ -19,6 +19,9 @@
 #include <array>
 #include <cassert>
 #include <cstring>
+#include <unordered_map>
+#include <unordered_set>
+#include <lcf/reader_util.h>
 #include "rtp.h"
 
 namespace RTP {
@@ -37,34 +40,143 @@ namespace RTP {
 	};
 }
 
-static std::pair<int, int> get_table_idx(const char* const lookup_table[16], const int lookup_table_idx[16], const std::string& category) {
-	int i;
+namespace {
+	/** Position of a name in an RTP table */
+	struct TableEntry {
+		int row;
+		/** Index of the RTP in the table (column - 1) */
+		int rtp;
+	};
+
+	using NameIndex = std::unordered_map<std::string, std::vector<TableEntry>>;
+
+	/** Names of one category of an RTP table, in table order */
+	struct CategoryIndex {
+		const char* category;
+		/** Maps the name to the entries */
+		NameIndex names;
+		/** Maps the normalized name to the entries, used by Detect */
+		NameIndex normalized;
+	};
+
+	using TableIndex = std::vector<CategoryIndex>;
+
+	template <typename T>
+	TableIndex build_index(T rtp_table, const char* const categories[], const int categories_idx[], int num_rtps) {
+		TableIndex index;
+		for (int i = 0; categories[i] != nullptr; ++i) {
+			CategoryIndex cat;
+			cat.category = categories[i];
+			for (int row = categories_idx[i]; row < categories_idx[i + 1]; ++row) {
+				for (int j = 1; j <= num_rtps; ++j) {
+					const char* name = rtp_table[row][j];
+					if (name != nullptr) {
+						cat.names[name].push_back({row, j - 1});
+						cat.normalized[lcf::ReaderUtil::Normalize(name)].push_back({row, j - 1});
+					}
+				}
+			}
+			index.push_back(std::move(cat));
+		}
+		return index;
+	}
+
+	/**
+	 * Indexes of the RTP tables, built on first use.
+	 * Thread-safe because RTP paths are probed in parallel.
+	 */
+	const TableIndex& get_index(int version) {
+		static const TableIndex index_2k = build_index(RTP::rtp_table_2k, RTP::rtp_table_2k_categories,
+			RTP::rtp_table_2k_categories_idx, RTP::num_2k_rtps);
+		static const TableIndex index_2k3 = build_index(RTP::rtp_table_2k3, RTP::rtp_table_2k3_categories,
+			RTP::rtp_table_2k3_categories_idx, RTP::num_2k3_rtps);
+		return version == 2000 ? index_2k : index_2k3;
+	}
+
+	const CategoryIndex* find_category(const TableIndex& index, const std::string& category) {
+		for (const auto& cat : index) {
+			if (category == cat.category) {
+				return &cat;
+			}
+		}
+		return nullptr;
+	}
 
-	for (i = 0; lookup_table[i] != nullptr; ++i) {
-		if (!strcmp(lookup_table[i], category.c_str())) {
-			return {lookup_table_idx[i], lookup_table_idx[i+1]};
+	/** @return entries of the name in the category, nullptr when not found */
+	const std::vector<TableEntry>* find_entries(int version, const std::string& category, const std::string& name) {
+		const auto* cat = find_category(get_index(version), category);
+		if (!cat) {
+			return nullptr;
 		}
+		auto it = cat->names.find(name);
+		return it != cat->names.end() ? &it->second : nullptr;
 	}
 
-	// Points at nullptr (final row) in the rtp table
-	return {lookup_table_idx[i], lookup_table_idx[i]};
+	const char* SOUND_TYPES[] = { ".wav", ".mp3", nullptr };
+	const char* MUSIC_TYPES[] = { ".wav", ".mid", nullptr };
+	const char* MOVIE_TYPES[] = { ".avi", nullptr };
+	const char* IMAGE_TYPES[] = { ".png", nullptr };
+
+	const char** ext_for_cat(const char* category) {
+		if (!strcmp("sound", category)) {
+			return SOUND_TYPES;
+		} else if (!strcmp("music", category)) {
+			return MUSIC_TYPES;
+		} else if (!strcmp("movie", category)) {
+			return MOVIE_TYPES;
+		} else {
+			return IMAGE_TYPES;
+		}
+	}
 }
 
-template <typename T>
+/**
+ * Lists every category directory of the tree once and counts the files that
+ * are in the table. A name found with several extensions is counted once.
+ */
 static void detect_helper(const FileFinder::DirectoryTree& tree, std::vector<struct RTP::RtpHitInfo>& hit_list,
-		T rtp_table, int num_rtps, int offset, const std::pair<int, int>& range, const char** ext_list) {
-	for (int i = range.first; i < range.second; ++i) {
-		const char* category = rtp_table[i][0];
-		for (int j = 1; j <= num_rtps; ++j) {
-			const char* name = rtp_table[i][j];
-			if (name != nullptr) {
-				std::string ret;
-				// TODO: Filefinder refactor should provide FindImage etc. for non-project trees
-				ret = FileFinder::FindDefault(tree, category, name, ext_list);
-				if (!ret.empty()) {
-					hit_list[offset + j - 1].hits++;
+		const TableIndex& index, int offset) {
+	std::unordered_set<std::string> seen;
+	std::string base;
+
+	for (const auto& cat : index) {
+		if (tree.directories.find(cat.category) == tree.directories.end()) {
+			continue;
+		}
+		const FileFinder::string_map* members = tree.FindSubMembers(cat.category);
+		if (!members) {
+			continue;
+		}
+
+		const char** ext_list = ext_for_cat(cat.category);
+		seen.clear();
+
+		for (const auto& member : *members) {
+			const std::string& file = member.first;
+			size_t dot = file.rfind('.');
+			if (dot == std::string::npos) {
+				continue;
+			}
+
+			bool ext_match = false;
+			for (const char** c = ext_list; *c != nullptr; ++c) {
+				if (file.compare(dot, std::string::npos, *c) == 0) {
+					ext_match = true;
+					break;
 				}
 			}
+			if (!ext_match) {
+				continue;
+			}
+
+			base.assign(file, 0, dot);
+			auto it = cat.normalized.find(base);
+			if (it == cat.normalized.end() || !seen.insert(base).second) {
+				continue;
+			}
+			for (const auto& entry : it->second) {
+				hit_list[offset + entry.rtp].hits++;
+			}
 		}
 	}
 }
@@ -84,38 +196,11 @@ std::vector<RTP::RtpHitInfo> RTP::Detect(std::shared_ptr<FileFinder::DirectoryTr
 		{RTP::Type::RPG2003_OfficialTraditionalChinese, Names[10], 2003, 0, 676, tree}
 	}};
 
-	static const char* SOUND_TYPES[] = { ".wav", ".mp3", nullptr };
-	static const char* MUSIC_TYPES[] = { ".wav", ".mid", nullptr };
-	static const char* MOVIE_TYPES[] = { ".avi", nullptr };
-	static const char* IMAGE_TYPES[] = { ".png", nullptr };
-
-	auto ext_for_cat = [](const char* category) {
-		if (!strcmp("sound", category)) {
-			return SOUND_TYPES;
-		} else if (!strcmp("music", category)) {
-			return MUSIC_TYPES;
-		} else if (!strcmp("movie", category)) {
-			return MOVIE_TYPES;
-		} else {
-			return IMAGE_TYPES;
-		}
-	};
-
 	if (version == 2000 || version == 0) {
-		for (int i = 0; rtp_table_2k_categories[i] != nullptr; ++i) {
-			const char* category = rtp_table_2k_categories[i];
-			std::pair<int, int> range = {rtp_table_2k_categories_idx[i], rtp_table_2k_categories_idx[i+1]};
-			const char** ext_list = ext_for_cat(category);
-			detect_helper(*tree, hit_list, rtp_table_2k, num_2k_rtps, 0, range, ext_list);
-		}
+		detect_helper(*tree, hit_list, get_index(2000), 0);
 	}
 	if (version == 2003 || version == 0) {
-		for (int i = 0; rtp_table_2k3_categories[i] != nullptr; ++i) {
-			const char* category = rtp_table_2k3_categories[i];
-			std::pair<int, int> range = {rtp_table_2k3_categories_idx[i], rtp_table_2k3_categories_idx[i+1]};
-			const char** ext_list = ext_for_cat(category);
-			detect_helper(*tree, hit_list, rtp_table_2k3, num_2k3_rtps, num_2k_rtps, range, ext_list);
-		}
+		detect_helper(*tree, hit_list, get_index(2003), num_2k_rtps);
 	}
 
 	// remove RTPs with zero hits
@@ -135,47 +220,35 @@ std::vector<RTP::RtpHitInfo> RTP::Detect(std::shared_ptr<FileFinder::DirectoryTr
 	return hit_list;
 }
 
-template <typename T>
-static std::vector<RTP::Type> lookup_any_to_rtp_helper(T rtp_table, const std::pair<int, int>& range,
-		const std::string& src_name, int num_rtps, int offset) {
+std::vector<RTP::Type> RTP::LookupAnyToRtp(const std::string& src_category, const std::string &src_name, int version) {
 	std::vector<RTP::Type> type_hits;
 
-	for (int i = range.first; i < range.second; ++i) {
-		for (int j = 1; j <= num_rtps; ++j) {
-			const char* name = rtp_table[i][j];
-			if (name != nullptr && !strcmp(src_name.c_str(), name)) {
-				type_hits.push_back((RTP::Type)(j - 1 + offset));
-			}
+	const int offset = version == 2000 ? 0 : num_2k_rtps;
+	const auto* entries = find_entries(version, src_category, src_name);
+	if (entries) {
+		for (const auto& entry : *entries) {
+			type_hits.push_back((RTP::Type)(entry.rtp + offset));
 		}
 	}
 
 	return type_hits;
 }
 
-std::vector<RTP::Type> RTP::LookupAnyToRtp(const std::string& src_category, const std::string &src_name, int version) {
-	if (version == 2000) {
-		auto tbl_idx = get_table_idx(rtp_table_2k_categories, rtp_table_2k_categories_idx, src_category);
-		return lookup_any_to_rtp_helper(rtp_table_2k, tbl_idx, src_name, num_2k_rtps, 0);
-	} else {
-		auto tbl_idx = get_table_idx(rtp_table_2k3_categories, rtp_table_2k3_categories_idx, src_category);
-		return lookup_any_to_rtp_helper(rtp_table_2k3, tbl_idx, src_name, num_2k3_rtps, num_2k_rtps);
-	}
-}
-
 template <typename T>
-static std::string lookup_rtp_to_rtp_helper(T rtp_table, const std::pair<int, int>& range,
+static std::string lookup_rtp_to_rtp_helper(T rtp_table, int version, const std::string& src_category,
 		const std::string& src_name, int src_index, int dst_index, bool* is_rtp_asset) {
+	const auto* entries = find_entries(version, src_category, src_name);
+	if (entries) {
+		for (const auto& entry : *entries) {
+			if (entry.rtp == src_index) {
+				const char* dst_name = rtp_table[entry.row][dst_index + 1];
 
-	for (int i = range.first; i < range.second; ++i) {
-		const char* name = rtp_table[i][src_index + 1];
-		if (name != nullptr && !strcmp(src_name.c_str(), name)) {
-			const char* dst_name = rtp_table[i][dst_index + 1];
+				if (is_rtp_asset) {
+					*is_rtp_asset = true;
+				}
 
-			if (is_rtp_asset) {
-				*is_rtp_asset = true;
+				return dst_name == nullptr ? "" : dst_name;
 			}
-
-			return dst_name == nullptr ? "" : dst_name;
 		}
 	}
 
@@ -201,10 +274,8 @@ std::string RTP::LookupRtpToRtp(const std::string& src_category, const std::stri
 	}
 
 	if ((int)src_rtp < num_2k_rtps) {
-		auto tbl_idx = get_table_idx(rtp_table_2k_categories, rtp_table_2k_categories_idx, src_category);
-		return lookup_rtp_to_rtp_helper(rtp_table_2k, tbl_idx, src_name, (int)src_rtp, (int)target_rtp, is_rtp_asset);
+		return lookup_rtp_to_rtp_helper(rtp_table_2k, 2000, src_category, src_name, (int)src_rtp, (int)target_rtp, is_rtp_asset);
 	} else {
-		auto tbl_idx = get_table_idx(rtp_table_2k3_categories, rtp_table_2k3_categories_idx, src_category);
-		return lookup_rtp_to_rtp_helper(rtp_table_2k3, tbl_idx, src_name, (int)src_rtp - num_2k_rtps, (int)target_rtp - num_2k_rtps, is_rtp_asset);
+		return lookup_rtp_to_rtp_helper(rtp_table_2k3, 2003, src_category, src_name, (int)src_rtp - num_2k_rtps, (int)target_rtp - num_2k_rtps, is_rtp_asset);
 	}
 }
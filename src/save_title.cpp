@@ -0,0 +1,172 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include <cstring>
+#include "save_title.h"
+#include <lcf/reader_util.h>
+
+namespace {
+	constexpr char save_header[] = "LcfSaveData";
+
+	/** Chunk ids, as in LSD_Reader */
+	constexpr uint32_t chunk_save_title = 0x64;
+
+	enum TitleChunk : uint32_t {
+		timestamp = 0x01,
+		hero_name = 0x0B,
+		hero_level = 0x0C,
+		hero_hp = 0x0D,
+		face1_name = 0x15,
+		face1_id = 0x16,
+		face2_name = 0x17,
+		face2_id = 0x18,
+		face3_name = 0x19,
+		face3_id = 0x1A,
+		face4_name = 0x1B,
+		face4_id = 0x1C
+	};
+
+	/** Reads a BER compressed integer */
+	bool ReadInt(std::istream& is, uint32_t& value) {
+		value = 0;
+		for (int i = 0; i < 5; ++i) {
+			const int c = is.get();
+			if (c == std::char_traits<char>::eof()) {
+				return false;
+			}
+			value = (value << 7) | (c & 0x7F);
+			if ((c & 0x80) == 0) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	int ParseInt(const std::string& data) {
+		uint32_t value = 0;
+		for (size_t i = 0; i < data.size() && i < 5; ++i) {
+			const auto c = static_cast<unsigned char>(data[i]);
+			value = (value << 7) | (c & 0x7F);
+			if ((c & 0x80) == 0) {
+				break;
+			}
+		}
+		return static_cast<int32_t>(value);
+	}
+
+	double ParseDouble(const std::string& data) {
+		if (data.size() != 8) {
+			return 0.0;
+		}
+		// Little endian in the file
+		uint64_t bits = 0;
+		for (int i = 7; i >= 0; --i) {
+			bits = (bits << 8) | static_cast<unsigned char>(data[i]);
+		}
+		double value;
+		std::memcpy(&value, &bits, sizeof(value));
+		return value;
+	}
+
+	bool ReadData(std::istream& is, uint32_t size, std::string& data) {
+		data.resize(size);
+		return size == 0 || static_cast<bool>(is.read(&data[0], size));
+	}
+
+	bool ReadTitle(std::istream& is, uint32_t size, lcf::rpg::SaveTitle& title, const std::string& encoding) {
+		const auto end = is.tellg() + static_cast<std::streamoff>(size);
+		std::string data;
+		while (is.tellg() < end) {
+			uint32_t id;
+			if (!ReadInt(is, id)) {
+				return false;
+			}
+			if (id == 0) {
+				break;
+			}
+			uint32_t chunk_size;
+			if (!ReadInt(is, chunk_size) || !ReadData(is, chunk_size, data)) {
+				return false;
+			}
+
+			switch (id) {
+				case timestamp: title.timestamp = ParseDouble(data); break;
+				case hero_name: title.hero_name = lcf::ReaderUtil::Recode(data, encoding); break;
+				case hero_level: title.hero_level = ParseInt(data); break;
+				case hero_hp: title.hero_hp = ParseInt(data); break;
+				case face1_name: title.face1_name = lcf::ReaderUtil::Recode(data, encoding); break;
+				case face1_id: title.face1_id = ParseInt(data); break;
+				case face2_name: title.face2_name = lcf::ReaderUtil::Recode(data, encoding); break;
+				case face2_id: title.face2_id = ParseInt(data); break;
+				case face3_name: title.face3_name = lcf::ReaderUtil::Recode(data, encoding); break;
+				case face3_id: title.face3_id = ParseInt(data); break;
+				case face4_name: title.face4_name = lcf::ReaderUtil::Recode(data, encoding); break;
+				case face4_id: title.face4_id = ParseInt(data); break;
+				default: break;
+			}
+		}
+		return static_cast<bool>(is.seekg(end));
+	}
+}
+
+std::unique_ptr<lcf::rpg::SaveTitle> SaveTitle::Load(std::istream& is, const std::string& encoding) {
+	if (!is.seekg(0, std::ios_base::end)) {
+		return nullptr;
+	}
+	const auto file_size = is.tellg();
+	is.seekg(0, std::ios_base::beg);
+
+	uint32_t header_size;
+	std::string header;
+	if (!ReadInt(is, header_size) || header_size != sizeof(save_header) - 1
+			|| !ReadData(is, header_size, header) || header != save_header) {
+		return nullptr;
+	}
+
+	std::unique_ptr<lcf::rpg::SaveTitle> title(new lcf::rpg::SaveTitle());
+	bool has_title = false;
+	while (is.tellg() < file_size) {
+		uint32_t id;
+		if (!ReadInt(is, id)) {
+			return nullptr;
+		}
+		if (id == 0) {
+			// End of the savegame
+			break;
+		}
+		uint32_t size;
+		if (!ReadInt(is, size)) {
+			return nullptr;
+		}
+		if (is.tellg() + static_cast<std::streamoff>(size) > file_size) {
+			// Truncated savegame
+			return nullptr;
+		}
+
+		if (id == chunk_save_title && !has_title) {
+			has_title = true;
+			if (!ReadTitle(is, size, *title, encoding)) {
+				return nullptr;
+			}
+		} else {
+			is.seekg(size, std::ios_base::cur);
+		}
+	}
+
+	return title;
+}
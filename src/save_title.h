@@ -0,0 +1,47 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_SAVE_TITLE_H
+#define EP_SAVE_TITLE_H
+
+// Headers
+#include <istream>
+#include <memory>
+#include <string>
+#include <lcf/rpg/savetitle.h>
+
+/**
+ * Reads the title of a savegame without parsing the whole file.
+ * The title is the first chunk of a savegame and holds everything the
+ * save and load menus display.
+ */
+namespace SaveTitle {
+
+/**
+ * Reads the SaveTitle chunk of a savegame. The other chunks are only
+ * skipped, a savegame whose chunks do not line up with the file size is
+ * reported as broken.
+ *
+ * @param is savegame stream
+ * @param encoding encoding of the strings in the savegame
+ * @return title or nullptr when the stream is not a valid savegame
+ */
+std::unique_ptr<lcf::rpg::SaveTitle> Load(std::istream& is, const std::string& encoding);
+
+} // namespace SaveTitle
+
+#endif
@@ -41,6 +41,7 @@ constexpr int Scene::kReturnTitleDelayFrames;
 std::shared_ptr<Scene> Scene::instance;
 std::vector<std::shared_ptr<Scene> > Scene::old_instances;
 std::vector<std::shared_ptr<Scene> > Scene::instances;
+std::shared_ptr<Scene> Scene::warm_instances[SceneMax];
 const char Scene::scene_names[SceneMax][12] =
 {
 	"Null",
@@ -161,8 +162,12 @@ void Scene::MainFunction() {
 			// Initialization after scene switch
 			switch (push_pop_operation) {
 				case ScenePushed:
-					Start();
-					initialized = true;
+					if (!initialized) {
+						Start();
+						initialized = true;
+					} else {
+						Restart(prev_scene_type);
+					}
 					break;
 				case ScenePopped:
 					if (!initialized) {
@@ -210,6 +215,10 @@ void Scene::Start() {
 void Scene::Continue(SceneType /* prev_scene */) {
 }
 
+void Scene::Restart(SceneType /* prev_scene */) {
+	Start();
+}
+
 void Scene::Suspend(SceneType /* next_scene */) {
 }
 
@@ -234,7 +243,7 @@ void Scene::OnFinishAsync() {
 
 bool Scene::IsAsyncPending() {
 	return Transition::instance().IsActive() || AsyncHandler::IsImportantFilePending()
-		|| (instance != nullptr && instance->HasDelayFrames());
+		|| Player::IsLoadingSavegame() || (instance != nullptr && instance->HasDelayFrames());
 }
 
 void Scene::Update() {
@@ -242,8 +251,7 @@ void Scene::Update() {
 
 void Scene::Push(std::shared_ptr<Scene> const& new_scene, bool pop_stack_top) {
 	if (pop_stack_top) {
-		old_instances.push_back(instances.back());
-		instances.pop_back();
+		PopInstance();
 	}
 
 	instances.push_back(new_scene);
@@ -255,8 +263,7 @@ void Scene::Push(std::shared_ptr<Scene> const& new_scene, bool pop_stack_top) {
 }
 
 void Scene::Pop() {
-	old_instances.push_back(instances.back());
-	instances.pop_back();
+	PopInstance();
 
 	if (instances.size() == 0) {
 		Push(std::make_shared<Scene>()); // Null-scene
@@ -275,8 +282,7 @@ void Scene::PopUntil(SceneType type) {
 	for (int i = (int)instances.size() - 1 ; i >= 0; --i) {
 		if (instances[i]->type == type) {
 			for (i = 0; i < count; ++i) {
-				old_instances.push_back(instances.back());
-				instances.pop_back();
+				PopInstance();
 			}
 			instance = instances.back();
 			push_pop_operation = ScenePopped;
@@ -301,6 +307,25 @@ std::shared_ptr<Scene> Scene::Find(SceneType type) {
 	return std::shared_ptr<Scene>();
 }
 
+void Scene::PopInstance() {
+	auto& scene = instances.back();
+	if (scene->keep_warm) {
+		warm_instances[scene->type] = scene;
+	}
+	old_instances.push_back(std::move(scene));
+	instances.pop_back();
+}
+
+std::shared_ptr<Scene> Scene::TakeWarm(SceneType type) {
+	return std::move(warm_instances[type]);
+}
+
+void Scene::ClearWarm() {
+	for (auto& scene: warm_instances) {
+		scene.reset();
+	}
+}
+
 void Scene::DrawBackground(Bitmap& dst) {
 	dst.Fill(Main_Data::game_system->GetBackgroundColor());
 }
@@ -98,6 +98,17 @@ public:
 	 */
 	virtual void Continue(SceneType prev_scene);
 
+	/**
+	 * Restart processing.
+	 * This function is executed instead of Start when a
+	 * scene that was kept warm is pushed again. It should
+	 * only redraw the data that changed since the scene
+	 * was removed. The default calls Start.
+	 *
+	 * @param prev_scene The previous scene
+	 */
+	virtual void Restart(SceneType prev_scene);
+
 	/**
 	 * Suspend processing.
 	 * This function is executed before the fade out for
@@ -173,6 +184,27 @@ public:
 	 */
 	static std::shared_ptr<Scene> Find(SceneType type);
 
+	/**
+	 * Takes the kept warm scene of a type out of the cache.
+	 * When the scene is pushed Restart is called instead of Start.
+	 *
+	 * @param type type of the scene
+	 * @return the scene, or NULL if none is kept warm
+	 */
+	static std::shared_ptr<Scene> TakeWarm(SceneType type);
+
+	/**
+	 * Reuses the kept warm scene of a type or creates a new one.
+	 *
+	 * @tparam T class of the scene
+	 * @param type type of T
+	 * @return the scene
+	 */
+	template <typename T> static std::shared_ptr<Scene> CreateWarm(SceneType type);
+
+	/** Destroys all scenes kept warm */
+	static void ClearWarm();
+
 	// Don't write to the following values directly when you want to change
 	// the scene! Use Push and Pop instead!
 
@@ -270,6 +302,16 @@ protected:
 	 */
 	void SetUseSharedDrawables(bool value);
 
+	/**
+	 * Set whether or not this scene is kept warm.
+	 * Such a scene is not destroyed when removed from the stack,
+	 * the next CreateWarm of its type reuses it with all windows.
+	 * Only the last removed scene of a type is kept.
+	 *
+	 * @param value whether to keep the scene
+	 */
+	void SetKeepWarm(bool value);
+
 	/**
 	 * If no async operation is pending, call f() now. Otherwise
 	 * defer f until async operations are done.
@@ -292,9 +334,16 @@ private:
 	 */
 	bool initialized = false;
 	bool uses_shared_drawables = false;
+	bool keep_warm = false;
 
 	static void DebugValidate(const char* caller);
 
+	/** Removes the top scene of the stack */
+	static void PopInstance();
+
+	/** Removed scenes which are kept warm, indexed by type */
+	static std::shared_ptr<Scene> warm_instances[SceneMax];
+
 	std::shared_ptr<Scene> request_scene;
 	int delay_frames = 0;
 };
@@ -343,6 +392,19 @@ inline void Scene::SetUseSharedDrawables(bool value) {
 	uses_shared_drawables = value;
 }
 
+inline void Scene::SetKeepWarm(bool value) {
+	keep_warm = value;
+}
+
+template <typename T>
+inline std::shared_ptr<Scene> Scene::CreateWarm(SceneType type) {
+	auto scene = TakeWarm(type);
+	if (!scene) {
+		scene = std::make_shared<T>();
+	}
+	return scene;
+}
+
 template <typename F>
 inline void Scene::AsyncNext(F&& f) {
 	if (IsAsyncPending()) {
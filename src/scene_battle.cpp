@@ -17,8 +17,10 @@
 
 // Headers
 #include <algorithm>
+#include <initializer_list>
 #include <sstream>
 
+#include "async_handler.h"
 #include "bitmap.h"
 #include "input.h"
 #include "output.h"
@@ -45,6 +47,74 @@
 #include "autobattle.h"
 #include "enemyai.h"
 
+namespace {
+
+void PrefetchAnimation(int animation_id) {
+	const auto* animation = lcf::ReaderUtil::GetElement(lcf::Data::animations, animation_id);
+	if (animation) {
+		AsyncHandler::PrefetchGraphic(animation->large ? "Battle2" : "Battle", animation->animation_name);
+	}
+}
+
+void PrefetchBattlerAnimation(int battler_animation_id) {
+	const auto* anim = lcf::ReaderUtil::GetElement(lcf::Data::battleranimations, battler_animation_id);
+	if (!anim) {
+		return;
+	}
+	for (const auto& pose: anim->poses) {
+		if (pose.animation_type == lcf::rpg::BattlerAnimationPose::AnimType_battle) {
+			PrefetchAnimation(pose.battle_animation_id);
+		} else {
+			AsyncHandler::PrefetchGraphic("BattleCharSet", pose.battler_name);
+		}
+	}
+}
+
+/**
+ * Starts loading the graphics of the battle, they are decoded in parallel
+ * while the map is erased. The sprites created in Start find them ready.
+ */
+void PrefetchBattleGraphics(const BattleArgs& args) {
+	if (!args.background.empty()) {
+		AsyncHandler::PrefetchGraphic("Backdrop", args.background);
+	} else if (const auto* terrain = lcf::ReaderUtil::GetElement(lcf::Data::terrains, args.terrain_id)) {
+		if (terrain->background_type == lcf::rpg::Terrain::BGAssociation_background) {
+			AsyncHandler::PrefetchGraphic("Backdrop", terrain->background_name);
+		} else {
+			AsyncHandler::PrefetchGraphic("Frame", terrain->background_a_name);
+			if (terrain->background_b) {
+				AsyncHandler::PrefetchGraphic("Frame", terrain->background_b_name);
+			}
+		}
+	}
+
+	if (const auto* troop = lcf::ReaderUtil::GetElement(lcf::Data::troops, args.troop_id)) {
+		for (const auto& mem: troop->members) {
+			const auto* enemy = lcf::ReaderUtil::GetElement(lcf::Data::enemies, mem.enemy_id);
+			if (enemy) {
+				AsyncHandler::PrefetchGraphic("Monster", enemy->battler_name);
+			}
+		}
+	}
+
+	for (const auto* actor: Main_Data::game_party->GetActors()) {
+		for (const auto* weapon: { actor->GetWeapon(), actor->Get2ndWeapon() }) {
+			if (weapon) {
+				PrefetchAnimation(weapon->animation_id);
+			}
+		}
+		if (Player::IsRPG2k3()) {
+			PrefetchBattlerAnimation(actor->GetBattleAnimationId());
+		}
+	}
+
+	if (Player::IsRPG2k3()) {
+		AsyncHandler::PrefetchGraphic("System2", Main_Data::game_system->GetSystem2Name());
+	}
+}
+
+}
+
 Scene_Battle::Scene_Battle(const BattleArgs& args)
 	: troop_id(args.troop_id),
 	allow_escape(args.allow_escape),
@@ -61,11 +131,15 @@ Scene_Battle::Scene_Battle(const BattleArgs& args)
 	Main_Data::game_system->SetBeforeBattleMusic(Main_Data::game_system->GetCurrentBGM());
 	Main_Data::game_system->SePlay(Main_Data::game_system->GetSystemSE(Main_Data::game_system->SFX_BeginBattle));
 	Main_Data::game_system->BgmPlay(Main_Data::game_system->GetSystemBGM(Main_Data::game_system->BGM_Battle));
+	// The fanfare starts without delay when the battle is won
+	Main_Data::game_system->BgmPrefetch(Main_Data::game_system->GetSystemBGM(Main_Data::game_system->BGM_Victory));
 
 	Game_Battle::SetTerrainId(args.terrain_id);
 	Game_Battle::ChangeBackground(args.background);
 	Game_Battle::SetBattleCondition(args.condition);
 	Game_Battle::SetBattleFormation(args.formation);
+
+	PrefetchBattleGraphics(args);
 }
 
 Scene_Battle::~Scene_Battle() {
@@ -157,7 +231,7 @@ void Scene_Battle::TransitionOut(SceneType next_scene) {
 }
 
 void Scene_Battle::DrawBackground(Bitmap& dst) {
-	dst.Clear();
+	dst.ClearRect(dst.GetRect());
 }
 
 void Scene_Battle::CreateUi() {
@@ -121,6 +121,14 @@ public:
 
 	static void SelectionFlash(Game_Battler* battler);
 
+	/**
+	 * Replaces the action of the battler when its states or resources
+	 * no longer allow it, called right before the action is executed.
+	 *
+	 * @param battler Battler whose action is checked
+	 */
+	static void PrepareBattleAction(Game_Battler* battler);
+
 protected:
 	explicit Scene_Battle(const BattleArgs& args);
 
@@ -165,8 +173,6 @@ protected:
 	 */
 	virtual void SetAnimationState(Game_Battler* target, int new_state);
 
-	void PrepareBattleAction(Game_Battler* battler);
-
 	void RemoveActionsForNonExistantBattlers();
 	void RemoveCurrentAction();
 
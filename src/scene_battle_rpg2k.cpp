@@ -565,8 +565,10 @@ bool Scene_Battle_Rpg2k::ProcessActionUsage1(Game_BattleAlgorithm::AlgorithmBase
 
 	battle_message_window->Clear();
 
-	if (action->HasStartMessage()) {
-		battle_message_window->Push(action->GetStartMessage());
+	// Built once, HasStartMessage would format it a second time
+	auto start_message = action->GetStartMessage();
+	if (!start_message.empty()) {
+		battle_message_window->Push(start_message);
 		battle_message_window->ScrollToEnd();
 
 		if (action->HasSecondStartMessage()) {
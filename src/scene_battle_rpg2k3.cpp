@@ -15,6 +15,7 @@
  * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
 #include "scene_battle_rpg2k3.h"
 #include <lcf/rpg/battlecommand.h>
 #include "input.h"
@@ -325,6 +326,8 @@ void Scene_Battle_Rpg2k3::Update() {
 
 		--time;
 		if (time <= 0) {
+			(*it).sprite->SetVisible(false);
+			float_text_pool.push_back(std::move((*it).sprite));
 			it = floating_texts.erase(it);
 		}
 		else {
@@ -476,15 +479,82 @@ void Scene_Battle_Rpg2k3::UpdateCursors() {
 	}
 }
 
+const Scene_Battle_Rpg2k3::DigitStrip& Scene_Battle_Rpg2k3::GetDigitStrip(int color) {
+	auto system = Cache::SystemOrBlack();
+	auto font = Font::Default();
+	if (system != digit_strips_system || font != digit_strips_font) {
+		digit_strips.clear();
+		digit_strips_system = system;
+		digit_strips_font = font;
+	}
+
+	auto& strip = digit_strips[color];
+	if (strip.bitmap) {
+		return strip;
+	}
+
+	int strip_width = 0;
+	for (int i = 0; i < 10; ++i) {
+		const Rect size = font->GetSize(static_cast<char32_t>('0' + i));
+		strip.x[i] = strip_width;
+		strip.width[i] = size.width;
+		strip.height = std::max(strip.height, size.height);
+		// One more column for the shadow, it overlaps the next digit
+		strip_width += size.width + 1;
+	}
+
+	strip.bitmap = Bitmap::Create(strip_width, strip.height);
+	strip.bitmap->Clear();
+	for (int i = 0; i < 10; ++i) {
+		const char digit[] = { static_cast<char>('0' + i), '\0' };
+		strip.bitmap->TextDraw(strip.x[i], 0, color, digit);
+	}
+	return strip;
+}
+
 void Scene_Battle_Rpg2k3::DrawFloatText(int x, int y, int color, StringView text) {
-	Rect rect = Font::Default()->GetSize(text);
+	const bool digits = !text.empty() && std::all_of(text.begin(), text.end(), [](char c) { return c >= '0' && c <= '9'; });
+	const DigitStrip* strip = digits ? &GetDigitStrip(color) : nullptr;
 
-	BitmapRef graphic = Bitmap::Create(rect.width, rect.height);
+	Rect rect;
+	if (strip) {
+		for (char c : text) {
+			rect.width += strip->width[c - '0'];
+		}
+		rect.height = strip->height;
+	} else {
+		rect = Font::Default()->GetSize(text);
+	}
+
+	std::shared_ptr<Sprite> floating_text;
+	if (!float_text_pool.empty()) {
+		floating_text = std::move(float_text_pool.back());
+		float_text_pool.pop_back();
+		floating_text->SetVisible(true);
+	} else {
+		floating_text = std::make_shared<Sprite>();
+	}
+
+	// The bitmap of a reused sprite is drawn into again when it is large enough
+	BitmapRef graphic = floating_text->GetBitmap();
+	if (!graphic || graphic->GetWidth() < rect.width || graphic->GetHeight() < rect.height) {
+		graphic = Bitmap::Create(std::max(rect.width, 1), std::max(rect.height, 1));
+	}
 	graphic->Clear();
-	graphic->TextDraw(-rect.x, -rect.y, color, text);
 
-	std::shared_ptr<Sprite> floating_text = std::make_shared<Sprite>();
+	if (strip) {
+		int dx = 0;
+		for (char c : text) {
+			const int i = c - '0';
+			graphic->Blit(dx, 0, *strip->bitmap, Rect(strip->x[i], 0, strip->width[i] + 1, strip->height), Opacity::Opaque());
+			dx += strip->width[i];
+		}
+	} else {
+		graphic->TextDraw(-rect.x, -rect.y, color, text);
+	}
+
 	floating_text->SetBitmap(graphic);
+	floating_text->SetSrcRect(Rect(0, 0, rect.width, rect.height));
 	floating_text->SetOx(rect.width / 2);
 	floating_text->SetOy(rect.height + 5);
 	floating_text->SetX(x);
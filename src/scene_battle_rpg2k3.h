@@ -19,6 +19,8 @@
 #define EP_SCENE_BATTLE_RPG2K3_H
 
 // Headers
+#include <array>
+#include <unordered_map>
 #include "scene_battle.h"
 #include "async_handler.h"
 #include "window_actorsp.h"
@@ -140,6 +142,26 @@ protected:
 	};
 
 	std::vector<FloatText> floating_texts;
+	/** Sprites of finished float texts, reused together with their bitmap */
+	std::vector<std::shared_ptr<Sprite>> float_text_pool;
+
+	/** Digits 0 to 9 rendered in one color, numbers are composed from these */
+	struct DigitStrip {
+		BitmapRef bitmap;
+		std::array<int, 10> x = {};
+		std::array<int, 10> width = {};
+		int height = 0;
+	};
+
+	/**
+	 * Returns the digit strip of the color, rendered on first use and again
+	 * when the system graphic or the font changed.
+	 */
+	const DigitStrip& GetDigitStrip(int color);
+
+	std::unordered_map<int, DigitStrip> digit_strips;
+	BitmapRef digit_strips_system;
+	FontRef digit_strips_font;
 	int battle_action_wait = 0;
 	int battle_action_min_wait = 0;
 	int battle_action_state = BattleActionState_Execute;
@@ -43,6 +43,12 @@
 #include "game_player.h"
 #include <lcf/data.h>
 #include "output.h"
+#include "memory_stats.h"
+#include "event_profiler.h"
+#include "filefinder.h"
+#include "main_data.h"
+#include "audio.h"
+#include "audio_secache.h"
 #include "transition.h"
 
 namespace {
@@ -268,8 +274,9 @@ void Scene_Debug::Update() {
 	if (range_index != range_window->GetIndex()){
 		range_index = range_window->GetIndex();
 		var_window->UpdateList(range_page * 100 + range_index * 10 + 1);
-		var_window->Refresh();
 	}
+	// Only redraws the rows that changed
+	var_window->Refresh();
 	var_window->Update();
 
 	if (numberinput_window->GetActive())
@@ -427,6 +434,28 @@ void Scene_Debug::Update() {
 					}
 				}
 				break;
+			case eMemory:
+				if (sz > 1) {
+					UpdateRangeListWindow();
+				} else {
+					PushUiRangeList();
+				}
+				MemoryStats::Log();
+				{
+					const auto se_stats = AudioSeCache::GetStats();
+					Output::Debug("SE cache: {} hits, {} misses, {} evictions", se_stats.hits, se_stats.misses, se_stats.evictions);
+					const auto audio_stats = Audio().GetStats();
+					Output::Debug("Audio: {} frames at {} Hz, {:.1f} ms latency, {} underruns",
+						audio_stats.buffer_frames, audio_stats.frequency, audio_stats.GetLatency(), audio_stats.underruns);
+				}
+				break;
+			case eEventProfile:
+				if (sz > 1) {
+					DoEventProfile();
+				} else {
+					PushUiRangeList();
+				}
+				break;
 		}
 		Game_Map::SetNeedRefresh(true);
 	} else if (range_window->GetActive() && Input::IsRepeated(Input::RIGHT)) {
@@ -498,6 +527,8 @@ void Scene_Debug::UpdateRangeListWindow() {
 			} else {
 				addItem("Call MapEvent", !is_battle);
 				addItem("Call BtlEvent", is_battle);
+				addItem("Memory");
+				addItem("Event Times");
 			}
 			break;
 		case eSwitch:
@@ -555,6 +586,34 @@ void Scene_Debug::UpdateRangeListWindow() {
 		case eFullHeal:
 			addItem("Full Heal");
 			break;
+		case eMemory:
+			for (int i = 0; i < static_cast<int>(MemoryStats::Category::END); ++i) {
+				const auto category = static_cast<MemoryStats::Category>(i);
+				addItem(fmt::format("{} {:.1f}M", MemoryStats::GetName(category), MemoryStats::Get(category) / 1024.0 / 1024.0));
+			}
+			{
+				const auto se_stats = AudioSeCache::GetStats();
+				const int se_total = se_stats.hits + se_stats.misses;
+				addItem(fmt::format("SE Hit {}%", se_total > 0 ? se_stats.hits * 100 / se_total : 0));
+				const auto audio_stats = Audio().GetStats();
+				addItem(fmt::format("Audio {:.0f}ms", audio_stats.GetLatency()));
+				addItem(fmt::format("Underrun {}", audio_stats.underruns));
+			}
+			break;
+		case eEventProfile:
+			addItem(EventProfiler::IsEnabled() ? "Profile: On" : "Profile: Off");
+			{
+				// Milliseconds per second of game time
+				const double window_s = std::chrono::duration<double>(EventProfiler::GetWindowDuration()).count();
+				for (const auto& entry : EventProfiler::GetEntries()) {
+					if (idx >= 10) {
+						break;
+					}
+					const double ms = std::chrono::duration<double, std::milli>(entry.time).count();
+					addItem(fmt::format("{} {:.1f}ms", EventProfiler::GetName(entry.source), window_s > 0 ? ms / window_s : 0.0));
+				}
+			}
+			break;
 		case eCallBattleEvent:
 			if (is_battle) {
 				auto* troop = Game_Battle::GetActiveTroop();
@@ -798,11 +857,27 @@ void Scene_Debug::DoCallBattleEvent() {
 
 	auto& page = troop->pages[page_idx];
 
-	Game_Battle::GetInterpreter().Push(page.event_commands, 0, false);
+	Game_Battle::GetInterpreter().Push(page.event_commands, 0, false, { EventProfiler::Type::BattleEvent, troop->ID, page.ID });
 	Scene::PopUntil(Scene::Battle);
 	Output::Debug("Debug Scene Forced execution of battle troop {} event page {} on the map foreground interpreter.", troop->ID, page.ID);
 }
 
+void Scene_Debug::DoEventProfile() {
+	if (range_window->GetIndex() == 0) {
+		EventProfiler::SetEnabled(!EventProfiler::IsEnabled());
+		Output::Debug("Event profiler {}", EventProfiler::IsEnabled() ? "enabled" : "disabled");
+	} else {
+		EventProfiler::Log();
+		const auto path = FileFinder::MakePath(Main_Data::GetSavePath(), "events.csv");
+		auto os = FileFinder::OpenOutputStream(path, std::ios_base::out | std::ios_base::trunc);
+		if (os) {
+			EventProfiler::WriteCsv(os);
+			Output::Debug("Event times written to {}", path);
+		}
+	}
+	UpdateRangeListWindow();
+}
+
 void Scene_Debug::TransitionIn(SceneType /* prev_scene */) {
 	Transition::instance().InitShow(Transition::TransitionCutIn, this);
 }
@@ -66,6 +66,8 @@ public:
 		eCallCommonEvent,
 		eCallMapEvent,
 		eCallBattleEvent,
+		eMemory,
+		eEventProfile,
 		eLastMainMenuOption,
 	};
 
@@ -107,6 +109,7 @@ private:
 	void DoCallCommonEvent();
 	void DoCallMapEvent();
 	void DoCallBattleEvent();
+	void DoEventProfile();
 
 	/** Displays a range selection for mode. */
 	std::unique_ptr<Window_Command> range_window;
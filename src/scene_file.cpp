@@ -25,8 +25,8 @@
 #include "game_system.h"
 #include "game_party.h"
 #include "input.h"
-#include <lcf/lsd/reader.h>
 #include "player.h"
+#include "save_title.h"
 #include "scene_file.h"
 #include "bitmap.h"
 #include <lcf/reader_util.h>
@@ -52,14 +52,14 @@ void Scene_File::CreateHelpWindow() {
 	help_window->SetZ(Priority_Window + 1);
 }
 
-void Scene_File::PopulatePartyFaces(Window_SaveFile& win, int /* id */, lcf::rpg::Save& savegame) {
-	win.SetParty(savegame.title);
+void Scene_File::PopulatePartyFaces(Window_SaveFile& win, int /* id */, const lcf::rpg::SaveTitle& title) {
+	win.SetParty(title);
 	win.SetHasSave(true);
 }
 
-void Scene_File::UpdateLatestTimestamp(int id, lcf::rpg::Save& savegame) {
-	if (savegame.title.timestamp > latest_time) {
-		latest_time = savegame.title.timestamp;
+void Scene_File::UpdateLatestTimestamp(int id, const lcf::rpg::SaveTitle& title) {
+	if (title.timestamp > latest_time) {
+		latest_time = title.timestamp;
 		latest_slot = id;
 	}
 }
@@ -72,13 +72,16 @@ void Scene_File::PopulateSaveWindow(Window_SaveFile& win, int id) {
 	std::string file = FileFinder::FindDefault(*tree, ss.str());
 
 	if (!file.empty()) {
-		// File found
+		// File found, the menu only needs the title
 		auto save_stream = FileFinder::OpenInputStream(file);
-		std::unique_ptr<lcf::rpg::Save> savegame = lcf::LSD_Reader::Load(save_stream, Player::encoding);
+		std::unique_ptr<lcf::rpg::SaveTitle> title;
+		if (save_stream) {
+			title = SaveTitle::Load(save_stream, Player::encoding);
+		}
 
-		if (savegame) {
-			PopulatePartyFaces(win, id, *savegame);
-			UpdateLatestTimestamp(id, *savegame);
+		if (title) {
+			PopulatePartyFaces(win, id, *title);
+			UpdateLatestTimestamp(id, *title);
 		} else {
 			win.SetCorrupted(true);
 		}
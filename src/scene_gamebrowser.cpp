@@ -23,6 +23,7 @@
 #include "input.h"
 #include "player.h"
 #include "scene_title.h"
+#include "startup_stats.h"
 #include "bitmap.h"
 #include "audio.h"
 
@@ -67,6 +68,12 @@ void Scene_GameBrowser::Continue(SceneType /* prev_scene */) {
 	Main_Data::game_system->SetSystemGraphic(CACHE_DEFAULT_BITMAP, lcf::rpg::System::Stretch_stretch, lcf::rpg::System::Font_gothic);
 
 	Player::debug_flag = initial_debug_flag;
+
+	if (rescan_games) {
+		// The scan was stopped by BootGame
+		gamelist_window->Refresh();
+		rescan_games = false;
+	}
 }
 
 void Scene_GameBrowser::Update() {
@@ -78,6 +85,12 @@ void Scene_GameBrowser::Update() {
 	command_window->Update();
 	gamelist_window->Update();
 
+	if (!game_list_enabled && gamelist_window->HasValidGames()) {
+		// Games are added while the directories are scanned
+		command_window->EnableItem(GameList);
+		game_list_enabled = true;
+	}
+
 	if (command_window->GetActive()) {
 		UpdateCommand();
 	}
@@ -101,8 +114,9 @@ void Scene_GameBrowser::CreateWindows() {
 	gamelist_window.reset(new Window_GameList(60, 32, SCREEN_TARGET_WIDTH - 60, SCREEN_TARGET_HEIGHT - 32));
 	gamelist_window->Refresh();
 
-	if (!gamelist_window->HasValidGames()) {
-		command_window->DisableItem(0);
+	game_list_enabled = gamelist_window->HasValidGames();
+	if (!game_list_enabled) {
+		command_window->DisableItem(GameList);
 	}
 
 	help_window.reset(new Window_Help(0, 0, SCREEN_TARGET_WIDTH, 32));
@@ -181,12 +195,17 @@ void Scene_GameBrowser::BootGame() {
 	const std::string& path = gamelist_window->GetGamePath();
 #endif
 
+	// The scanner must not run while the game modifies the FileFinder state
+	rescan_games = gamelist_window->StopScan();
+
 	if (browser_dir.empty())
 		browser_dir = Main_Data::GetProjectPath();
 	Main_Data::SetProjectPath(path);
 
-	std::shared_ptr<FileFinder::DirectoryTree> tree = FileFinder::CreateDirectoryTree(path);
-	FileFinder::SetDirectoryTree(tree);
+	{
+		StartupStats::Scope scope(StartupStats::Stage::DirectoryTree);
+		FileFinder::SetDirectoryTree(FileFinder::CreateDirectoryTree(path));
+	}
 
 	Player::CreateGameObjects();
 
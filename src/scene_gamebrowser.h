@@ -84,6 +84,12 @@ private:
 
 	bool game_loading = false;
 
+	/** Whether the "Games" command is enabled */
+	bool game_list_enabled = false;
+
+	/** Whether the game list must be refreshed when returning from a game */
+	bool rescan_games = false;
+
 	int old_gamelist_index = 0;
 
 	/** What the state of the Player::debug_flag was at launch time */
@@ -34,6 +34,7 @@
 Scene_Item::Scene_Item(int item_index) :
 	item_index(item_index) {
 	Scene::type = Scene::Item;
+	SetKeepWarm(true);
 }
 
 void Scene_Item::Start() {
@@ -49,6 +50,12 @@ void Scene_Item::Continue(SceneType /* prev_scene */) {
 	item_window->Refresh();
 }
 
+void Scene_Item::Restart(SceneType /* prev_scene */) {
+	item_index = 0;
+	item_window->Refresh();
+	item_window->SetIndex(item_index);
+}
+
 void Scene_Item::Update() {
 	help_window->Update();
 	item_window->Update();
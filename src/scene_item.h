@@ -38,6 +38,7 @@ public:
 
 	void Start() override;
 	void Continue(SceneType prev_scene) override;
+	void Restart(SceneType prev_scene) override;
 	void Update() override;
 	void TransitionOut(Scene::SceneType next_scene) override;
 
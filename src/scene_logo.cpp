@@ -25,6 +25,7 @@
 #include "player.h"
 #include "scene_title.h"
 #include "scene_gamebrowser.h"
+#include "startup_stats.h"
 #include "output.h"
 #include "logo.h"
 
@@ -48,7 +49,8 @@ void Scene_Logo::Update() {
 #ifdef EMSCRIPTEN
 		static bool once = true;
 		if (once) {
-			FileRequestAsync* index = AsyncHandler::RequestFile("index.json");
+			// Binary index, index.json is requested when it does not exist
+			FileRequestAsync* index = AsyncHandler::RequestFile("index.bin");
 			index->SetImportantFile(true);
 			request_id = index->Bind(&Scene_Logo::OnIndexReady, this);
 			once = false;
@@ -61,14 +63,21 @@ void Scene_Logo::Update() {
 		}
 #endif
 
-		std::shared_ptr<FileFinder::DirectoryTree> tree = FileFinder::CreateDirectoryTree(Main_Data::GetProjectPath(), FileFinder::FILES);
+		std::shared_ptr<FileFinder::DirectoryTree> tree;
+		{
+			StartupStats::Scope scope(StartupStats::Stage::DirectoryTree);
+			tree = FileFinder::CreateDirectoryTree(Main_Data::GetProjectPath(), FileFinder::FILES);
+		}
 
 		if (!tree) {
 			Output::Error("{} is not a valid path", Main_Data::GetProjectPath());
 		}
 
 		if (FileFinder::IsValidProject(*tree)) {
-			FileFinder::SetDirectoryTree(FileFinder::CreateDirectoryTree(Main_Data::GetProjectPath()));
+			{
+				StartupStats::Scope scope(StartupStats::Stage::DirectoryTree);
+				FileFinder::SetDirectoryTree(FileFinder::CreateDirectoryTree(Main_Data::GetProjectPath()));
+			}
 			Player::CreateGameObjects();
 			is_valid = true;
 		}
@@ -103,10 +112,23 @@ void Scene_Logo::Update() {
 }
 
 void Scene_Logo::DrawBackground(Bitmap& dst) {
-	dst.Clear();
+	dst.ClearRect(dst.GetRect());
 }
 
-void Scene_Logo::OnIndexReady(FileRequestResult*) {
+void Scene_Logo::OnIndexReady(FileRequestResult* result) {
+	if (result->file == "index.bin") {
+		if (!result->success || !FileFinder::Exists("index.bin") || !AsyncHandler::CreateRequestMapping("index.bin")) {
+			FileRequestAsync* index = AsyncHandler::RequestFile("index.json");
+			index->SetImportantFile(true);
+			request_id = index->Bind(&Scene_Logo::OnIndexReady, this);
+			index->Start();
+			return;
+		}
+		async_ready = true;
+		RequestGameFiles();
+		return;
+	}
+
 	async_ready = true;
 
 	if (!FileFinder::Exists("index.json")) {
@@ -115,7 +137,10 @@ void Scene_Logo::OnIndexReady(FileRequestResult*) {
 	}
 
 	AsyncHandler::CreateRequestMapping("index.json");
+	RequestGameFiles();
+}
 
+void Scene_Logo::RequestGameFiles() {
 	FileRequestAsync* db = AsyncHandler::RequestFile(DATABASE_NAME);
 	db->SetImportantFile(true);
 	FileRequestAsync* tree = AsyncHandler::RequestFile(TREEMAP_NAME);
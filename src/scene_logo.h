@@ -48,6 +48,7 @@ private:
 	int frame_counter;
 
 	void OnIndexReady(FileRequestResult* result);
+	void RequestGameFiles();
 	FileRequestBinding request_id;
 	bool async_ready = false;
 };
@@ -211,7 +211,7 @@ void Scene_Map::TransitionOut(SceneType next_scene) {
 
 void Scene_Map::DrawBackground(Bitmap& dst) {
 	if (spriteset->RequireClear(GetDrawableList())) {
-		dst.Clear();
+		dst.ClearRect(dst.GetRect());
 	}
 }
 
@@ -277,7 +277,7 @@ void Scene_Map::UpdateSceneCalling() {
 			if (Input::IsTriggered(Input::CANCEL)) {
 				debug_menuoverwrite_counter++;
 				if (debug_menuoverwrite_counter >= 5) {
-					call = std::make_shared<Scene_Menu>();
+					call = Scene::CreateWarm<Scene_Menu>(Scene::Menu);
 					debug_menuoverwrite_counter = 0;
 				}
 			}
@@ -315,7 +315,7 @@ void Scene_Map::FinishPendingTeleport(TeleportParams tp) {
 	Main_Data::game_player->PerformTeleport();
 
 	if (Game_Map::GetMapId() != old_map_id) {
-		spriteset.reset(new Spriteset_Map());
+		spriteset.reset(new Spriteset_Map(spriteset.get()));
 	}
 	FinishPendingTeleport2(MapUpdateAsyncContext(), tp);
 }
@@ -380,7 +380,7 @@ void Scene_Map::PerformAsyncTeleport(TeleportTarget original_tt) {
 	Main_Data::game_player->PerformTeleport();
 	Main_Data::game_player->ResetTeleportTarget(original_tt);
 
-	spriteset.reset(new Spriteset_Map());
+	spriteset.reset(new Spriteset_Map(spriteset.get()));
 
 	AsyncNext(std::move(map_async_continuation));
 }
@@ -37,6 +37,7 @@
 Scene_Menu::Scene_Menu(int menu_index) :
 	menu_index(menu_index) {
 	type = Scene::Menu;
+	SetKeepWarm(true);
 }
 
 void Scene_Menu::Start() {
@@ -54,6 +55,18 @@ void Scene_Menu::Continue(SceneType /* prev_scene */) {
 	menustatus_window->Refresh();
 }
 
+void Scene_Menu::Restart(SceneType /* prev_scene */) {
+	menu_index = 0;
+	CreateCommandWindow();
+	command_window->SetActive(true);
+
+	gold_window->Refresh();
+
+	menustatus_window->SetActive(false);
+	menustatus_window->SetIndex(-1);
+	menustatus_window->Refresh();
+}
+
 void Scene_Menu::Update() {
 	command_window->Update();
 	gold_window->Update();
@@ -70,6 +83,8 @@ void Scene_Menu::Update() {
 void Scene_Menu::CreateCommandWindow() {
 	// Create Options Window
 	std::vector<std::string> options;
+	const auto num_options = command_options.size();
+	command_options.clear();
 
 	if (Player::IsRPG2k()) {
 		command_options.push_back(Item);
@@ -128,7 +143,14 @@ void Scene_Menu::CreateCommandWindow() {
 		}
 	}
 
-	command_window.reset(new Window_Command(options, 88));
+	if (command_window && options.size() == num_options) {
+		// Same window size, only the texts are redrawn
+		for (size_t i = 0; i < options.size(); ++i) {
+			command_window->SetItemText(i, options[i]);
+		}
+	} else {
+		command_window.reset(new Window_Command(options, 88));
+	}
 	command_window->SetIndex(menu_index);
 
 	// Disable items
@@ -170,7 +192,7 @@ void Scene_Menu::UpdateCommand() {
 				Main_Data::game_system->SePlay(Main_Data::game_system->GetSystemSE(Main_Data::game_system->SFX_Buzzer));
 			} else {
 				Main_Data::game_system->SePlay(Main_Data::game_system->GetSystemSE(Main_Data::game_system->SFX_Decision));
-				Scene::Push(std::make_shared<Scene_Item>());
+				Scene::Push(Scene::CreateWarm<Scene_Item>(Scene::Item));
 			}
 			break;
 		case Skill:
@@ -38,10 +38,12 @@ public:
 
 	void Start() override;
 	void Continue(SceneType prev_scene) override;
+	void Restart(SceneType prev_scene) override;
 	void Update() override;
 
 	/**
 	 * Creates the window displaying the options.
+	 * An existing window with the same number of options is redrawn.
 	 */
 	void CreateCommandWindow();
 
@@ -16,12 +16,24 @@
  */
 
 // Headers
+#include <cerrno>
+#include <cstdio>
+#include <memory>
+#include <string>
 #include <sstream>
+#ifdef HAVE_THREADS
+#  include <chrono>
+#  include <future>
+#endif
 
 #ifdef EMSCRIPTEN
 #  include <emscripten.h>
 #endif
 
+#ifdef _WIN32
+#  include <windows.h>
+#endif
+
 #include <lcf/data.h>
 #include "dynrpg.h"
 #include "filefinder.h"
@@ -36,12 +48,116 @@
 #include "game_targets.h"
 #include "game_screen.h"
 #include "game_pictures.h"
+#include "job_system.h"
 #include <lcf/lsd/reader.h>
 #include "output.h"
 #include "player.h"
 #include "scene_save.h"
+#include "utils.h"
 #include "version.h"
 
+namespace {
+	/** Savegame started by Scene_Save::SaveAsync and not written yet */
+	struct PendingSave {
+		std::string filename;
+		int slot_id = 0;
+#ifdef HAVE_THREADS
+		std::future<std::string> data;
+#else
+		std::string data;
+#endif
+	};
+
+	std::unique_ptr<PendingSave> pending_save;
+
+	std::string SerializeSave(const lcf::rpg::Save& save, lcf::EngineVersion engine, const std::string& encoding) {
+		std::ostringstream os(std::ios_base::out | std::ios_base::binary);
+		lcf::LSD_Reader::Save(os, save, engine, encoding);
+		return os.str();
+	}
+
+	lcf::EngineVersion GetSaveEngine() {
+		return Player::IsRPG2k3() ? lcf::EngineVersion::e2k3 : lcf::EngineVersion::e2k;
+	}
+
+	bool ReplaceSaveFile(const std::string& from, const std::string& to) {
+#ifdef _WIN32
+		// _wrename does not replace existing files
+		const auto wide_from = Utils::ToWideString(from);
+		if (MoveFileExW(wide_from.c_str(), Utils::ToWideString(to).c_str(), MOVEFILE_REPLACE_EXISTING) != 0) {
+			return true;
+		}
+		// The old savegame is kept
+		DeleteFileW(wide_from.c_str());
+		return false;
+#else
+		if (std::rename(from.c_str(), to.c_str()) == 0) {
+			return true;
+		}
+
+		// Platforms without replacing rename: the old savegame is moved aside
+		// and only deleted after the new one is in place
+		if (errno == EEXIST || (errno == EACCES && FileFinder::Exists(to))) {
+			const auto old_filename = to + ".old";
+			std::remove(old_filename.c_str());
+			if (std::rename(to.c_str(), old_filename.c_str()) == 0) {
+				if (std::rename(from.c_str(), to.c_str()) == 0) {
+					std::remove(old_filename.c_str());
+					return true;
+				}
+				std::rename(old_filename.c_str(), to.c_str());
+			}
+		}
+
+		// The old savegame is kept
+		std::remove(from.c_str());
+		return false;
+#endif
+	}
+
+	/**
+	 * Writes the data to a temporary file and replaces the savegame with it,
+	 * closing the Player during the write leaves the old savegame intact.
+	 */
+	bool WriteSaveFile(const std::string& filename, const std::string& data) {
+		const auto tmp_filename = filename + ".tmp";
+		{
+			auto os = FileFinder::OpenOutputStream(tmp_filename);
+			if (!os) {
+				return false;
+			}
+			os.write(data.data(), data.size());
+			os.flush();
+			if (!os) {
+				return false;
+			}
+		}
+		return ReplaceSaveFile(tmp_filename, filename);
+	}
+
+	void WritePendingSave() {
+#ifdef HAVE_THREADS
+		const auto data = pending_save->data.get();
+#else
+		const auto& data = pending_save->data;
+#endif
+		if (!WriteSaveFile(pending_save->filename, data)) {
+			Output::Warning("Saving to {} failed", FileFinder::GetPathInsideGamePath(pending_save->filename));
+		}
+
+		DynRpg::Save(pending_save->slot_id);
+		pending_save.reset();
+
+#ifdef EMSCRIPTEN
+		// Save changed file system
+		EM_ASM({
+			FS.syncfs(function(err) {
+			});
+		});
+#endif
+	}
+}
+
 Scene_Save::Scene_Save() :
 	Scene_File(ToString(lcf::Data::terms.save_game_message)) {
 	Scene::type = Scene::Save;
@@ -56,10 +172,22 @@ void Scene_Save::Start() {
 	}
 }
 
-void Scene_Save::Action(int index) {
-	Save(*tree, index + 1);
+void Scene_Save::Update() {
+	if (saving) {
+		// The scene is closed once the savegame is on disk
+		if (!UpdateSave()) {
+			saving = false;
+			Scene::Pop();
+		}
+		return;
+	}
+
+	Scene_File::Update();
+}
 
-	Scene::Pop();
+void Scene_Save::Action(int index) {
+	SaveAsync(*tree, index + 1);
+	saving = true;
 }
 
 std::string Scene_Save::GetSaveFilename(const FileFinder::DirectoryTree& tree, int slot_id) {
@@ -76,13 +204,68 @@ std::string Scene_Save::GetSaveFilename(const FileFinder::DirectoryTree& tree, i
 }
 
 void Scene_Save::Save(const FileFinder::DirectoryTree& tree, int slot_id, bool prepare_save) {
-	const auto filename = GetSaveFilename(tree, slot_id);
-	auto save_stream = FileFinder::OpenOutputStream(filename);
-	Save(save_stream, slot_id, prepare_save);
+	SaveAsync(tree, slot_id, prepare_save);
+	FinishSave();
+}
+
+void Scene_Save::SaveAsync(const FileFinder::DirectoryTree& tree, int slot_id, bool prepare_save) {
+	FinishSave();
+
+	pending_save.reset(new PendingSave());
+	pending_save->filename = GetSaveFilename(tree, slot_id);
+	pending_save->slot_id = slot_id;
+
+	// The snapshot is taken now, the game state may change while it is serialized
+	auto save = MakeSave(slot_id, prepare_save);
+	const auto engine = GetSaveEngine();
+#ifdef HAVE_THREADS
+	pending_save->data = JobSystem::Async([save = std::move(save), engine, encoding = Player::encoding]() {
+		return SerializeSave(save, engine, encoding);
+	}, JobSystem::Priority::High);
+#else
+	pending_save->data = SerializeSave(save, engine, Player::encoding);
+#endif
+}
+
+bool Scene_Save::UpdateSave() {
+	if (!pending_save) {
+		return false;
+	}
+#ifdef HAVE_THREADS
+	if (pending_save->data.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+		return true;
+	}
+#endif
+	// Only the filesystem of the main thread is safe to use
+	WritePendingSave();
+	return false;
+}
+
+void Scene_Save::FinishSave() {
+	if (pending_save) {
+		WritePendingSave();
+	}
+}
+
+bool Scene_Save::IsSaving() {
+	return pending_save != nullptr;
 }
 
 void Scene_Save::Save(std::ostream& os, int slot_id, bool prepare_save) {
+	lcf::LSD_Reader::Save(os, MakeSave(slot_id, prepare_save), GetSaveEngine(), Player::encoding);
+
+	DynRpg::Save(slot_id);
+
+#ifdef EMSCRIPTEN
+	// Save changed file system
+	EM_ASM({
+		FS.syncfs(function(err) {
+		});
+	});
+#endif
+}
 
+lcf::rpg::Save Scene_Save::MakeSave(int slot_id, bool prepare_save) {
 	lcf::rpg::Save save;
 	auto& title = save.title;
 	// TODO: Maybe find a better place to setup the save file?
@@ -140,19 +323,8 @@ void Scene_Save::Save(std::ostream& os, int slot_id, bool prepare_save) {
 			sme.map_id = 0;
 		}
 	}
-	auto lcf_engine = Player::IsRPG2k3() ? lcf::EngineVersion::e2k3 : lcf::EngineVersion::e2k;
-	lcf::LSD_Reader::Save(os, save, lcf_engine, Player::encoding);
-
-	DynRpg::Save(slot_id);
-
-#ifdef EMSCRIPTEN
-	// Save changed file system
-	EM_ASM({
-		FS.syncfs(function(err) {
-		});
-	});
-#endif
 
+	return save;
 }
 
 bool Scene_Save::IsSlotValid(int) {
@@ -22,6 +22,7 @@
 #include <vector>
 #include "scene.h"
 #include "scene_file.h"
+#include <lcf/rpg/save.h>
 
 /**
  * Scene_Item class.
@@ -35,6 +36,7 @@ public:
 	Scene_Save();
 
 	void Start() override;
+	void Update() override;
 
 	void Action(int index) override;
 	bool IsSlotValid(int index) override;
@@ -42,6 +44,43 @@ public:
 	static std::string GetSaveFilename(const FileFinder::DirectoryTree& tree, int slot_id);
 	static void Save(const FileFinder::DirectoryTree& tree, int slot_id, bool prepare_save = true);
 	static void Save(std::ostream& os, int slot_id, bool prepare_save = true);
+
+	/**
+	 * Snapshots the game state and serializes it on a worker thread.
+	 * The savegame is written by UpdateSave or FinishSave, a save still in
+	 * progress is finished first.
+	 *
+	 * @param tree directory tree of the save directory
+	 * @param slot_id save slot
+	 * @param prepare_save whether to apply LSD_Reader::PrepareSave
+	 */
+	static void SaveAsync(const FileFinder::DirectoryTree& tree, int slot_id, bool prepare_save = true);
+
+	/**
+	 * Writes the savegame of SaveAsync once it is serialized.
+	 *
+	 * @return true while the save is still in progress
+	 */
+	static bool UpdateSave();
+
+	/** Waits for the save in progress and writes it */
+	static void FinishSave();
+
+	/** @return whether a save is in progress */
+	static bool IsSaving();
+
+	/**
+	 * Collects the savegame of the current game state.
+	 *
+	 * @param slot_id save slot
+	 * @param prepare_save whether to apply LSD_Reader::PrepareSave
+	 * @return savegame
+	 */
+	static lcf::rpg::Save MakeSave(int slot_id, bool prepare_save);
+
+private:
+
+	bool saving = false;
 };
 
 #endif
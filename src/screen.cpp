@@ -32,11 +32,7 @@ Screen::Screen() : Drawable(Priority_Screen)
 void Screen::Draw(Bitmap& dst) {
 	auto flash_color = Main_Data::game_screen->GetFlashColor();
 	if (flash_color.alpha > 0) {
-		if (!flash) {
-			flash = Bitmap::Create(SCREEN_TARGET_WIDTH, SCREEN_TARGET_HEIGHT, flash_color);
-		} else {
-			flash->Fill(flash_color);
-		}
-		dst.Blit(0, 0, *flash, flash->GetRect(), 255);
+		// Blends the color in a single pass, without filling a screen sized bitmap first
+		dst.FillRect(Rect(0, 0, SCREEN_TARGET_WIDTH, SCREEN_TARGET_HEIGHT), flash_color);
 	}
 }
@@ -37,9 +37,6 @@ public:
 	Screen();
 
 	void Draw(Bitmap& dst) override;
-
-private:
-	BitmapRef flash;
 };
 
 #endif
@@ -0,0 +1,296 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "system.h"
+
+#if USE_SDL==2
+
+// Headers
+#define _USE_MATH_DEFINES
+#include <algorithm>
+#include <cmath>
+#include "sdl2_renderer.h"
+#include "bitmap.h"
+#include "options.h"
+#include "output.h"
+
+namespace {
+	/** Textures unused for this many frames are destroyed */
+	constexpr unsigned texture_lifetime = 120;
+	/** Frames between checks for unused textures */
+	constexpr unsigned evict_interval = 60;
+}
+
+std::unique_ptr<Sdl2Renderer> Sdl2Renderer::Create(SDL_Renderer* renderer, uint32_t texture_format) {
+#if SDL_VERSION_ATLEAST(2, 0, 6)
+	SDL_RendererInfo rinfo = {};
+	if (SDL_GetRendererInfo(renderer, &rinfo) != 0 || !(rinfo.flags & SDL_RENDERER_ACCELERATED)) {
+		Output::Debug("SDL2: Hardware rendering needs an accelerated renderer");
+		return nullptr;
+	}
+
+	auto blend_mode = SDL_ComposeCustomBlendMode(
+			SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD,
+			SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD);
+
+	std::unique_ptr<Sdl2Renderer> result(new Sdl2Renderer(renderer, texture_format, blend_mode));
+	if (!result->layer_texture || SDL_SetTextureBlendMode(result->layer_texture, blend_mode) != 0) {
+		Output::Debug("SDL2: Hardware rendering not supported by renderer {}: {}", rinfo.name, SDL_GetError());
+		return nullptr;
+	}
+
+	Output::Debug("SDL2: Hardware rendering with renderer {}", rinfo.name);
+	return result;
+#else
+	(void)renderer;
+	(void)texture_format;
+	Output::Debug("SDL2: Hardware rendering needs SDL 2.0.6");
+	return nullptr;
+#endif
+}
+
+Sdl2Renderer::Sdl2Renderer(SDL_Renderer* renderer, uint32_t texture_format, SDL_BlendMode blend_mode) :
+	renderer(renderer), texture_format(texture_format), blend_mode(blend_mode)
+{
+	layer = Bitmap::Create(SCREEN_TARGET_WIDTH, SCREEN_TARGET_HEIGHT, true);
+	layer->Clear();
+	layer_texture = SDL_CreateTexture(renderer, texture_format, SDL_TEXTUREACCESS_STREAMING,
+			SCREEN_TARGET_WIDTH, SCREEN_TARGET_HEIGHT);
+}
+
+Sdl2Renderer::~Sdl2Renderer() {
+	for (auto& entry: textures) {
+		SDL_DestroyTexture(entry.second.texture);
+	}
+	if (layer_texture) {
+		SDL_DestroyTexture(layer_texture);
+	}
+}
+
+void Sdl2Renderer::BeginFrame() {
+	SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+	SDL_RenderClear(renderer);
+}
+
+void Sdl2Renderer::EndFrame() {
+	FlushLayer();
+
+	++frame;
+	if (frame % evict_interval == 0) {
+		EvictTextures();
+	}
+	frame_ready = true;
+}
+
+bool Sdl2Renderer::TakeFrame() {
+	bool ready = frame_ready;
+	frame_ready = false;
+	return ready;
+}
+
+Rect Sdl2Renderer::GetScreenRect() const {
+	return layer->GetRect();
+}
+
+Bitmap& Sdl2Renderer::GetLayer() {
+	layer_dirty = true;
+	return *layer;
+}
+
+bool Sdl2Renderer::CanDraw(const Bitmap& bitmap) const {
+	return bitmap.bpp() == 4 && bitmap.GetWidth() > 0 && bitmap.GetHeight() > 0;
+}
+
+const Bitmap& Sdl2Renderer::ResolveView(const Bitmap& bitmap, Rect& src_rect) {
+	// Read-only views of atlas pages share the texture of the page,
+	// consecutive draws from one page are batched by SDL
+	const auto* source = bitmap.GetViewSource();
+	if (!source || !bitmap.IsReadOnly() || src_rect.x < 0 || src_rect.y < 0
+			|| src_rect.x + src_rect.width > bitmap.GetWidth()
+			|| src_rect.y + src_rect.height > bitmap.GetHeight()) {
+		return bitmap;
+	}
+
+	src_rect.x += bitmap.GetViewRect().x;
+	src_rect.y += bitmap.GetViewRect().y;
+	return *source;
+}
+
+void Sdl2Renderer::DrawBitmap(const Bitmap& view, const Rect& view_rect, const Quad& quad) {
+	FlushLayer();
+
+	Rect src_rect = view_rect;
+	const Bitmap& bitmap = ResolveView(view, src_rect);
+
+	const Opacity& opacity = quad.opacity;
+	if (opacity.IsTransparent() || src_rect.IsEmpty()) {
+		return;
+	}
+
+	// Without split the bottom part is empty
+	const int split = opacity.IsSplit() ? std::min(opacity.split, src_rect.height) : 0;
+	const double angle = quad.angle * 180.0 / M_PI;
+
+	auto draw = [&](int top, int height, int alpha) {
+		if (height <= 0 || alpha <= 0) {
+			return;
+		}
+		auto* texture = GetTexture(bitmap, alpha);
+		if (!texture) {
+			return;
+		}
+
+		SDL_Rect src = { src_rect.x, src_rect.y + top, src_rect.width, height };
+		SDL_Rect dst = {
+			static_cast<int>(std::floor(quad.x + (-quad.ox) * quad.zoom_x)),
+			static_cast<int>(std::floor(quad.y + (top - quad.oy) * quad.zoom_y)),
+			static_cast<int>(std::ceil(src_rect.width * quad.zoom_x)),
+			static_cast<int>(std::ceil(height * quad.zoom_y))
+		};
+
+		if (angle == 0.0) {
+			SDL_RenderCopy(renderer, texture, &src, &dst);
+		} else {
+			SDL_Point center = {
+				quad.x - dst.x,
+				quad.y - dst.y
+			};
+			SDL_RenderCopyEx(renderer, texture, &src, &dst, angle, &center, SDL_FLIP_NONE);
+		}
+	};
+
+	draw(0, src_rect.height - split, opacity.top);
+	draw(src_rect.height - split, split, opacity.bottom);
+}
+
+void Sdl2Renderer::DrawTiled(const Bitmap& view, const Rect& view_rect, int ox, int oy, const Rect& dst_rect, int opacity) {
+	FlushLayer();
+
+	Rect src_rect = view_rect;
+	const Bitmap& bitmap = ResolveView(view, src_rect);
+
+	if (opacity <= 0 || src_rect.IsEmpty() || dst_rect.IsEmpty()) {
+		return;
+	}
+
+	auto* texture = GetTexture(bitmap, opacity);
+	if (!texture) {
+		return;
+	}
+
+	// Same wrapping as Bitmap::TiledBlit
+	ox %= src_rect.width;
+	oy %= src_rect.height;
+	if (ox < 0) ox += src_rect.width;
+	if (oy < 0) oy += src_rect.height;
+
+	SDL_Rect clip = { dst_rect.x, dst_rect.y, dst_rect.width, dst_rect.height };
+	SDL_RenderSetClipRect(renderer, &clip);
+
+	SDL_Rect src = { src_rect.x, src_rect.y, src_rect.width, src_rect.height };
+	for (int y = dst_rect.y - oy; y < dst_rect.y + dst_rect.height; y += src_rect.height) {
+		for (int x = dst_rect.x - ox; x < dst_rect.x + dst_rect.width; x += src_rect.width) {
+			SDL_Rect dst = { x, y, src_rect.width, src_rect.height };
+			SDL_RenderCopy(renderer, texture, &src, &dst);
+		}
+	}
+
+	SDL_RenderSetClipRect(renderer, nullptr);
+}
+
+SDL_Texture* Sdl2Renderer::GetTexture(const Bitmap& bitmap, int opacity) {
+	auto& entry = textures[bitmap.GetId()];
+
+	if (entry.texture) {
+		int w = 0;
+		int h = 0;
+		SDL_QueryTexture(entry.texture, nullptr, nullptr, &w, &h);
+		if (w != bitmap.GetWidth() || h != bitmap.GetHeight()) {
+			SDL_DestroyTexture(entry.texture);
+			entry.texture = nullptr;
+		}
+	}
+
+	if (!entry.texture) {
+		entry.texture = SDL_CreateTexture(renderer, texture_format, SDL_TEXTUREACCESS_STATIC,
+				bitmap.GetWidth(), bitmap.GetHeight());
+		if (!entry.texture) {
+			Output::Debug("SDL_CreateTexture failed : {}", SDL_GetError());
+			textures.erase(bitmap.GetId());
+			return nullptr;
+		}
+		SDL_SetTextureBlendMode(entry.texture, blend_mode);
+		Upload(entry.texture, bitmap);
+	} else if (entry.revision != bitmap.GetRevision()) {
+		Upload(entry.texture, bitmap);
+	}
+
+	entry.revision = bitmap.GetRevision();
+	entry.last_frame = frame;
+
+	// The colors are premultiplied, the opacity applies to them as well
+	const auto mod = static_cast<uint8_t>(std::min(opacity, 255));
+	SDL_SetTextureColorMod(entry.texture, mod, mod, mod);
+	SDL_SetTextureAlphaMod(entry.texture, mod);
+
+	return entry.texture;
+}
+
+void Sdl2Renderer::Upload(SDL_Texture* texture, const Bitmap& bitmap) {
+	if (bitmap.GetTransparent()) {
+		SDL_UpdateTexture(texture, nullptr, bitmap.pixels(), bitmap.pitch());
+		return;
+	}
+
+	// The alpha channel of opaque bitmaps is undefined
+	const int width = bitmap.GetWidth();
+	const int height = bitmap.GetHeight();
+	const uint32_t alpha = Bitmap::pixel_format.a.mask;
+	upload_buffer.resize(width * height);
+	for (int y = 0; y < height; ++y) {
+		auto* src = reinterpret_cast<const uint32_t*>(static_cast<const uint8_t*>(bitmap.pixels()) + y * bitmap.pitch());
+		auto* dst = &upload_buffer[y * width];
+		for (int x = 0; x < width; ++x) {
+			dst[x] = src[x] | alpha;
+		}
+	}
+	SDL_UpdateTexture(texture, nullptr, upload_buffer.data(), width * 4);
+}
+
+void Sdl2Renderer::FlushLayer() {
+	if (!layer_dirty) {
+		return;
+	}
+
+	SDL_UpdateTexture(layer_texture, nullptr, layer->pixels(), layer->pitch());
+	SDL_RenderCopy(renderer, layer_texture, nullptr, nullptr);
+	layer->Clear();
+	layer_dirty = false;
+}
+
+void Sdl2Renderer::EvictTextures() {
+	for (auto it = textures.begin(); it != textures.end();) {
+		if (frame - it->second.last_frame > texture_lifetime) {
+			SDL_DestroyTexture(it->second.texture);
+			it = textures.erase(it);
+		} else {
+			++it;
+		}
+	}
+}
+
+#endif
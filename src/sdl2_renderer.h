@@ -0,0 +1,99 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_SDL2_RENDERER_H
+#define EP_SDL2_RENDERER_H
+
+// Headers
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include "accelerated_renderer.h"
+#include "memory_management.h"
+
+#include <SDL.h>
+
+/**
+ * AcceleratedRenderer drawing with a SDL_Renderer.
+ * Bitmaps are uploaded to textures on first use and when their contents change.
+ */
+class Sdl2Renderer : public AcceleratedRenderer {
+public:
+	/**
+	 * Creates a renderer when the SDL_Renderer supports everything needed.
+	 *
+	 * @param renderer the SDL renderer, must outlive the created renderer
+	 * @param texture_format pixel format of the Bitmaps
+	 * @return renderer or nullptr when not supported
+	 */
+	static std::unique_ptr<Sdl2Renderer> Create(SDL_Renderer* renderer, uint32_t texture_format);
+
+	~Sdl2Renderer() override;
+
+	void BeginFrame() override;
+	void EndFrame() override;
+	Rect GetScreenRect() const override;
+	Bitmap& GetLayer() override;
+	bool CanDraw(const Bitmap& bitmap) const override;
+	void DrawBitmap(const Bitmap& bitmap, const Rect& src_rect, const Quad& quad) override;
+	void DrawTiled(const Bitmap& bitmap, const Rect& src_rect, int ox, int oy, const Rect& dst_rect, int opacity) override;
+
+	/**
+	 * @return whether a frame was rendered since the last call, resets the state
+	 */
+	bool TakeFrame();
+
+private:
+	Sdl2Renderer(SDL_Renderer* renderer, uint32_t texture_format, SDL_BlendMode blend_mode);
+
+	struct Texture {
+		SDL_Texture* texture = nullptr;
+		uint32_t revision = 0;
+		unsigned last_frame = 0;
+	};
+
+	/**
+	 * @param bitmap bitmap to draw
+	 * @param src_rect part to draw, moved into the source of an atlas view
+	 * @return bitmap providing the texture
+	 */
+	static const Bitmap& ResolveView(const Bitmap& bitmap, Rect& src_rect);
+	SDL_Texture* GetTexture(const Bitmap& bitmap, int opacity);
+	void Upload(SDL_Texture* texture, const Bitmap& bitmap);
+	void FlushLayer();
+	void EvictTextures();
+
+	SDL_Renderer* renderer = nullptr;
+	uint32_t texture_format = 0;
+	/** Blending of premultiplied alpha as used by pixman */
+	SDL_BlendMode blend_mode;
+
+	BitmapRef layer;
+	SDL_Texture* layer_texture = nullptr;
+	bool layer_dirty = false;
+
+	/** Textures by Bitmap id */
+	std::unordered_map<uint32_t, Texture> textures;
+	/** Conversion buffer for bitmaps without alpha channel */
+	std::vector<uint32_t> upload_buffer;
+
+	unsigned frame = 0;
+	bool frame_ready = false;
+};
+
+#endif
@@ -23,6 +23,7 @@
 #if USE_SDL==2
 
 #include "sdl2_ui.h"
+#include "sdl2_renderer.h"
 
 #ifdef _WIN32
 #  include <windows.h>
@@ -38,6 +39,7 @@
 #include "color.h"
 #include "graphics.h"
 #include "keys.h"
+#include "memory_pressure.h"
 #include "output.h"
 #include "player.h"
 #include "bitmap.h"
@@ -154,6 +156,8 @@ Sdl2Ui::Sdl2Ui(long width, long height, const Game_ConfigVideo& cfg) : BaseUi(cf
 		Output::Error("Couldn't initialize SDL.\n{}\n", SDL_GetError());
 	}
 
+	hardware_render = cfg.hardware_render.Get();
+
 	RequestVideoMode(width, height,
 			cfg.window_zoom.Get(),
 			cfg.fullscreen.Get(),
@@ -199,8 +203,11 @@ Sdl2Ui::Sdl2Ui(long width, long height, const Game_ConfigVideo& cfg) : BaseUi(cf
 }
 
 Sdl2Ui::~Sdl2Ui() {
-	if (sdl_texture) {
-		SDL_DestroyTexture(sdl_texture);
+	accelerated_renderer.reset();
+	for (auto* texture: sdl_textures) {
+		if (texture) {
+			SDL_DestroyTexture(texture);
+		}
 	}
 	if (sdl_renderer) {
 		SDL_DestroyRenderer(sdl_renderer);
@@ -365,15 +372,18 @@ bool Sdl2Ui::RefreshDisplayMode() {
 		SDL_RenderSetLogicalSize(sdl_renderer, SCREEN_TARGET_WIDTH, SCREEN_TARGET_HEIGHT);
 
 
-		sdl_texture = SDL_CreateTexture(sdl_renderer,
-			texture_format,
-			SDL_TEXTUREACCESS_STREAMING,
-			SCREEN_TARGET_WIDTH, SCREEN_TARGET_HEIGHT);
+		for (auto& texture: sdl_textures) {
+			texture = SDL_CreateTexture(sdl_renderer,
+				texture_format,
+				SDL_TEXTUREACCESS_STREAMING,
+				SCREEN_TARGET_WIDTH, SCREEN_TARGET_HEIGHT);
 
-		if (!sdl_texture) {
-			Output::Debug("SDL_CreateTexture failed : {}", SDL_GetError());
-			return false;
+			if (!texture) {
+				Output::Debug("SDL_CreateTexture failed : {}", SDL_GetError());
+				return false;
+			}
 		}
+		InvalidateTextures();
 
 		renderer_sg.Dismiss();
 		window_sg.Dismiss();
@@ -402,7 +412,7 @@ bool Sdl2Ui::RefreshDisplayMode() {
 	uint32_t sdl_pixel_fmt = GetDefaultFormat();
 	int a, w, h;
 
-	if (SDL_QueryTexture(sdl_texture, &sdl_pixel_fmt, &a, &w, &h) != 0) {
+	if (SDL_QueryTexture(sdl_textures[0], &sdl_pixel_fmt, &a, &w, &h) != 0) {
 		Output::Debug("SDL_QueryTexture failed : {}", SDL_GetError());
 		return false;
 	}
@@ -416,6 +426,12 @@ bool Sdl2Ui::RefreshDisplayMode() {
 			SCREEN_TARGET_WIDTH, SCREEN_TARGET_HEIGHT, Color(0, 0, 0, 255));
 	}
 
+	if (hardware_render && !accelerated_renderer) {
+		// Falls back to software rendering when not supported
+		accelerated_renderer = Sdl2Renderer::Create(sdl_renderer, sdl_pixel_fmt);
+		hardware_render = accelerated_renderer != nullptr;
+	}
+
 	return true;
 }
 
@@ -480,11 +496,77 @@ void Sdl2Ui::ProcessEvents() {
 }
 
 void Sdl2Ui::UpdateDisplay() {
-	// SDL_UpdateTexture was found to be faster than SDL_LockTexture / SDL_UnlockTexture.
-	SDL_UpdateTexture(sdl_texture, NULL, main_surface->pixels(), main_surface->pitch());
-	SDL_RenderClear(sdl_renderer);
-	SDL_RenderCopy(sdl_renderer, sdl_texture, NULL, NULL);
+	UploadDisplay();
+	PresentDisplay();
+}
+
+void Sdl2Ui::UploadDisplay() {
+	frame_accelerated = accelerated_renderer && accelerated_renderer->TakeFrame();
+	if (frame_accelerated) {
+		// Graphics::Draw already rendered the frame
+		return;
+	}
+
+	// Read through const access, the non-const pixels() changes the revision
+	const Bitmap& surface = *main_surface;
+	const uint32_t revision = surface.GetRevision();
+	if (textures_invalid || revision != uploaded_revision) {
+		// The texture not shown last frame is updated, the driver can still be
+		// reading from the other one. It misses the changes of both frames.
+		const Rect damage = Graphics::GetSurfaceDamage(surface, uploaded_revision);
+		for (auto& pending: texture_damage) {
+			pending = pending.GetUnion(damage);
+		}
+
+		current_texture = (current_texture + 1) % sdl_textures.size();
+		Rect& pending = texture_damage[current_texture];
+		pending.Adjust(surface.GetRect());
+
+		if (!pending.IsEmpty()) {
+			// SDL_UpdateTexture was found to be faster than SDL_LockTexture / SDL_UnlockTexture.
+			// Only whole rows are contiguous in memory.
+			const SDL_Rect rect = { 0, pending.y, surface.width(), pending.height };
+			auto* pixels = static_cast<const uint8_t*>(surface.pixels()) + pending.y * surface.pitch();
+			SDL_UpdateTexture(sdl_textures[current_texture], &rect, pixels, surface.pitch());
+		}
+		pending = Rect();
+		uploaded_revision = revision;
+		textures_invalid = false;
+	}
+}
+
+void Sdl2Ui::PresentDisplay() {
+	if (!frame_accelerated) {
+		if (textures_invalid) {
+			// The textures were recreated after the upload, the frame is lost
+			return;
+		}
+		SDL_RenderClear(sdl_renderer);
+		SDL_RenderCopy(sdl_renderer, sdl_textures[current_texture], NULL, NULL);
+	}
 	SDL_RenderPresent(sdl_renderer);
+	present_requested = false;
+}
+
+bool Sdl2Ui::CanPresentWhileDrawing() const {
+	// The accelerated renderer issues SDL calls from Graphics::Draw
+	return !accelerated_renderer;
+}
+
+bool Sdl2Ui::CanSkipPresent() const {
+	// The accelerated renderer has no retained frame to present again
+	return !accelerated_renderer && !textures_invalid && !present_requested;
+}
+
+void Sdl2Ui::InvalidateTextures() {
+	for (auto& pending: texture_damage) {
+		pending = Rect(0, 0, SCREEN_TARGET_WIDTH, SCREEN_TARGET_HEIGHT);
+	}
+	textures_invalid = true;
+}
+
+AcceleratedRenderer* Sdl2Ui::GetAcceleratedRenderer() {
+	return accelerated_renderer.get();
 }
 
 void Sdl2Ui::SetTitle(const std::string &title) {
@@ -513,6 +595,11 @@ void Sdl2Ui::ProcessEvent(SDL_Event &evnt) {
 			Player::exit_flag = true;
 			return;
 
+		case SDL_APP_LOWMEMORY:
+			// Android and iOS, the app is killed next
+			MemoryPressure::Signal(MemoryPressure::Level::Critical);
+			return;
+
 		case SDL_KEYDOWN:
 			ProcessKeyDownEvent(evnt);
 			return;
@@ -557,6 +644,10 @@ void Sdl2Ui::ProcessEvent(SDL_Event &evnt) {
 
 void Sdl2Ui::ProcessActiveEvent(SDL_Event &evnt) {
 	int state = evnt.window.event;
+	if (state == SDL_WINDOWEVENT_EXPOSED || state == SDL_WINDOWEVENT_SIZE_CHANGED
+			|| state == SDL_WINDOWEVENT_RESTORED || state == SDL_WINDOWEVENT_SHOWN) {
+		present_requested = true;
+	}
 #if PAUSE_GAME_WHEN_FOCUS_LOST
 	if (state == SDL_WINDOWEVENT_FOCUS_LOST) {
 
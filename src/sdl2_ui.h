@@ -19,6 +19,7 @@
 #define EP_SDL2_UI_H
 
 // Headers
+#include <array>
 #include "baseui.h"
 #include "color.h"
 #include "rect.h"
@@ -34,6 +35,7 @@ extern "C" {
 }
 
 struct AudioInterface;
+class Sdl2Renderer;
 
 /**
  * Sdl2Ui class.
@@ -62,9 +64,14 @@ public:
 	void ToggleFullscreen() override;
 	void ToggleZoom() override;
 	void UpdateDisplay() override;
+	void UploadDisplay() override;
+	void PresentDisplay() override;
+	bool CanPresentWhileDrawing() const override;
+	bool CanSkipPresent() const override;
 	void SetTitle(const std::string &title) override;
 	bool ShowCursor(bool flag) override;
 	void ProcessEvents() override;
+	AcceleratedRenderer* GetAcceleratedRenderer() override;
 
 #ifdef SUPPORT_AUDIO
 	AudioInterface& GetAudio() override;
@@ -115,14 +122,35 @@ private:
 
 	void RequestVideoMode(int width, int height, int zoom, bool fullscreen, bool vsync);
 
+	/**
+	 * Marks the contents of all streaming textures as outdated.
+	 */
+	void InvalidateTextures();
+
 	/** Last display mode. */
 	DisplayMode last_display_mode;
 
 	/** Main SDL window. */
-	SDL_Texture* sdl_texture = nullptr;
+	std::array<SDL_Texture*, 2> sdl_textures = {};
 	SDL_Window* sdl_window = nullptr;
 	SDL_Renderer* sdl_renderer = nullptr;
 
+	/** Draws frames with the GPU when hardware rendering is enabled */
+	std::unique_ptr<Sdl2Renderer> accelerated_renderer;
+	bool hardware_render = false;
+
+	/** Streaming texture of the last frame */
+	size_t current_texture = 0;
+	/** Areas of each texture which are outdated */
+	std::array<Rect, 2> texture_damage;
+	/** Revision of main_surface at the last upload */
+	uint32_t uploaded_revision = 0;
+	bool textures_invalid = true;
+	/** The uploaded frame was rendered by the accelerated renderer */
+	bool frame_accelerated = false;
+	/** The window contents were lost and must be presented again */
+	bool present_requested = true;
+
 	std::unique_ptr<AudioInterface> audio_;
 };
 
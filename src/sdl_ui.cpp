@@ -505,7 +505,7 @@ void SdlUi::Blit2X(Bitmap const& src, SDL_Surface* dst_surf) {
 			dst_surf->format->Amask,
 			PF::NoAlpha));
 
-	dst->Blit2x(dst->GetRect(), src, src.GetRect());
+	dst->ScaleBlit(0, 0, src, src.GetRect(), 2, Graphics::GetDrawThreads());
 #endif
 
 	if (SDL_MUSTLOCK(dst_surf)) SDL_UnlockSurface(dst_surf);
@@ -0,0 +1,122 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include "snapshot.h"
+#include "game_battle.h"
+#include "game_system.h"
+#include "main_data.h"
+#include "output.h"
+#include "player.h"
+#include "scene.h"
+#include "scene_save.h"
+#include <lcf/lsd/reader.h>
+#include <lcf/reader_lcf.h>
+
+namespace {
+	constexpr char magic[4] = { 'E', 'P', 'S', 'N' };
+	constexpr uint32_t version = 1;
+	/** Magic, version, engine, game title size and savegame size */
+	constexpr size_t header_size = sizeof(magic) + 4 * sizeof(uint32_t);
+
+	void WriteU32(std::string& out, uint32_t value) {
+		for (int i = 0; i < 4; ++i) {
+			out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+		}
+	}
+
+	uint32_t ReadU32(const char* data) {
+		uint32_t value = 0;
+		for (int i = 0; i < 4; ++i) {
+			value |= static_cast<uint32_t>(static_cast<uint8_t>(data[i])) << (8 * i);
+		}
+		return value;
+	}
+
+	lcf::EngineVersion GetSaveEngine() {
+		return Player::IsRPG2k3() ? lcf::EngineVersion::e2k3 : lcf::EngineVersion::e2k;
+	}
+}
+
+bool Snapshot::IsAvailable() {
+	return Main_Data::game_system && Scene::Find(Scene::Map) && !Game_Battle::IsBattleRunning();
+}
+
+std::string Snapshot::Create() {
+	if (!IsAvailable()) {
+		return {};
+	}
+
+	// The save slot and the save counter stay as they are
+	auto save = Scene_Save::MakeSave(Main_Data::game_system->GetSaveSlot(), false);
+	std::ostringstream os(std::ios_base::out | std::ios_base::binary);
+	lcf::LSD_Reader::Save(os, save, GetSaveEngine(), Player::encoding);
+	const auto save_data = os.str();
+
+	std::string out;
+	out.reserve(header_size + Player::game_title.size() + save_data.size());
+	out.append(magic, sizeof(magic));
+	WriteU32(out, version);
+	WriteU32(out, static_cast<uint32_t>(Player::engine));
+	WriteU32(out, static_cast<uint32_t>(Player::game_title.size()));
+	WriteU32(out, static_cast<uint32_t>(save_data.size()));
+	out += Player::game_title;
+	out += save_data;
+	return out;
+}
+
+bool Snapshot::Restore(const void* data, size_t size) {
+	const auto* bytes = static_cast<const char*>(data);
+	if (size < header_size || std::memcmp(bytes, magic, sizeof(magic)) != 0) {
+		Output::Warning("Snapshot: Invalid data");
+		return false;
+	}
+
+	const char* pos = bytes + sizeof(magic);
+	const uint32_t snapshot_version = ReadU32(pos);
+	const uint32_t engine = ReadU32(pos + 4);
+	const uint32_t title_size = ReadU32(pos + 8);
+	const uint32_t save_size = ReadU32(pos + 12);
+	pos += 16;
+
+	if (snapshot_version != version) {
+		Output::Warning("Snapshot: Unsupported version {}", snapshot_version);
+		return false;
+	}
+	if (size - header_size < static_cast<size_t>(title_size) + save_size) {
+		Output::Warning("Snapshot: Truncated data");
+		return false;
+	}
+	if (engine != static_cast<uint32_t>(Player::engine) || Player::game_title != std::string(pos, title_size)) {
+		Output::Warning("Snapshot: Taken with another game");
+		return false;
+	}
+	pos += title_size;
+
+	std::istringstream is(std::string(pos, save_size), std::ios_base::in | std::ios_base::binary);
+	auto save = lcf::LSD_Reader::Load(is, Player::encoding);
+	if (!save) {
+		Output::Warning("Snapshot: {}", lcf::LcfReader::GetError());
+		return false;
+	}
+
+	Player::LoadSavegame(std::move(save), Main_Data::game_system->GetSaveSlot(), false);
+	return true;
+}
@@ -0,0 +1,56 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_SNAPSHOT_H
+#define EP_SNAPSHOT_H
+
+// Headers
+#include <cstddef>
+#include <string>
+
+/**
+ * Snapshots of the running game held in memory, for suspending and resuming
+ * without going through a save slot. A snapshot is the savegame of the
+ * current state in a versioned header, it is taken even when the game
+ * forbids saving. The savegame contains the map and its events, the
+ * interpreters, switches, variables, pictures, screen and the music.
+ *
+ * Snapshots are only valid for the game and engine they were taken with.
+ */
+namespace Snapshot {
+	/** @return whether a snapshot can be taken now, on the map and not in a battle */
+	bool IsAvailable();
+
+	/**
+	 * Takes a snapshot of the game state.
+	 *
+	 * @return snapshot, empty when IsAvailable is false
+	 */
+	std::string Create();
+
+	/**
+	 * Restores a snapshot. The map is loaded asynchronously afterwards like
+	 * for a loaded savegame, but without fading out first.
+	 *
+	 * @param data snapshot data, may be followed by padding
+	 * @param size size of data
+	 * @return false when the data is not a snapshot of this game
+	 */
+	bool Restore(const void* data, size_t size);
+}
+
+#endif
@@ -16,8 +16,12 @@
  */
 
 // Headers
+#include <algorithm>
+#include <cmath>
 #include <string>
+#include <tuple>
 #include "sprite.h"
+#include "accelerated_renderer.h"
 #include "player.h"
 #include "util_macro.h"
 #include "bitmap.h"
@@ -37,18 +41,214 @@ void Sprite::Draw(Bitmap& dst) {
 	BlitScreen(dst);
 }
 
+bool Sprite::DrawState::operator==(const DrawState& o) const {
+	return std::tie(visible, bitmap, bitmap_revision, src_rect, src_rect_effect, x, y, ox, oy,
+			opacity_top, opacity_bottom, bush_depth, tone, flash, blend_type, blend_color,
+			zoom_x, zoom_y, angle, waver_depth, waver_phase, flip_x, flip_y) ==
+		std::tie(o.visible, o.bitmap, o.bitmap_revision, o.src_rect, o.src_rect_effect, o.x, o.y, o.ox, o.oy,
+			o.opacity_top, o.opacity_bottom, o.bush_depth, o.tone, o.flash, o.blend_type, o.blend_color,
+			o.zoom_x, o.zoom_y, o.angle, o.waver_depth, o.waver_phase, o.flip_x, o.flip_y);
+}
+
+Sprite::DrawState Sprite::GetDrawState() const {
+	DrawState state;
+	state.visible = IsVisible() && bitmap && GetWidth() > 0 && GetHeight() > 0
+		&& (opacity_top_effect > 0 || opacity_bottom_effect > 0);
+	if (!state.visible) {
+		return state;
+	}
+
+	state.bitmap = bitmap.get();
+	state.bitmap_revision = bitmap->GetRevision();
+	state.src_rect = src_rect;
+	state.src_rect_effect = src_rect_effect;
+	state.x = x;
+	state.y = y;
+	state.ox = ox;
+	state.oy = oy;
+	state.opacity_top = opacity_top_effect;
+	state.opacity_bottom = opacity_bottom_effect;
+	state.bush_depth = bush_effect;
+	state.tone = tone_effect;
+	state.flash = flash_effect;
+	state.blend_type = blend_type_effect;
+	state.blend_color = blend_color_effect;
+	state.zoom_x = zoom_x_effect;
+	state.zoom_y = zoom_y_effect;
+	state.angle = angle_effect;
+	state.waver_depth = waver_effect_depth;
+	state.waver_phase = waver_effect_phase;
+	state.flip_x = flipx_effect;
+	state.flip_y = flipy_effect;
+	state.bounds = GetScreenBounds();
+	return state;
+}
+
+Rect Sprite::GetScreenBounds() const {
+	// Conservative approximation of the areas touched by Bitmap::EffectsBlit
+	const int w = GetWidth();
+	const int h = GetHeight();
+
+	if (angle_effect != 0.0) {
+		const double dx = std::max(ox, w - ox) * std::abs(zoom_x_effect);
+		const double dy = std::max(oy, h - oy) * std::abs(zoom_y_effect);
+		const int r = static_cast<int>(std::ceil(std::sqrt(dx * dx + dy * dy))) + 1;
+		return Rect(x - r, y - r, 2 * r, 2 * r);
+	}
+
+	const int left = static_cast<int>(std::floor(x - ox * zoom_x_effect));
+	const int top = static_cast<int>(std::floor(y - oy * zoom_y_effect));
+	const int width = static_cast<int>(std::ceil(w * zoom_x_effect)) + 1;
+	const int height = static_cast<int>(std::ceil(h * zoom_y_effect)) + 1;
+
+	if (waver_effect_depth != 0) {
+		const int offset = static_cast<int>(std::ceil(2 * zoom_x_effect * std::abs(waver_effect_depth))) + 1;
+		return Rect(left - offset, top, width + 2 * offset, height);
+	}
+
+	return Rect(left, top, width, height);
+}
+
+Rect Sprite::GetScreenBounds(const Rect&) const {
+	return GetScreenBounds();
+}
+
+Rect Sprite::GetDamage(const Rect&) {
+	const auto state = GetDrawState();
+	if (state == composited_state) {
+		return Rect();
+	}
+
+	Rect damage = state.visible ? state.bounds : Rect();
+	if (composited_state.visible) {
+		damage = damage.GetUnion(composited_state.bounds);
+	}
+	return damage;
+}
+
+void Sprite::OnComposited() {
+	composited_state = GetDrawState();
+}
+
+bool Sprite::PrepareBands() {
+	band_bitmap.reset();
+
+	// Zoom, rotation and waver change the transform of the source image while blitting
+	if (zoom_x_effect != 1.0 || zoom_y_effect != 1.0 || angle_effect != 0.0 || waver_effect_depth != 0) {
+		return false;
+	}
+
+	if (GetWidth() > 0 && GetHeight() > 0) {
+		band_bitmap = PrepareBlit(band_rect);
+	}
+	return true;
+}
+
+void Sprite::DrawBand(Bitmap& dst) {
+	if (band_bitmap) {
+		BlitScreenIntern(dst, *band_bitmap, band_rect);
+	}
+}
+
+bool Sprite::DrawAccelerated(AcceleratedRenderer& renderer) {
+	if (waver_effect_depth != 0) {
+		return false;
+	}
+
+	if (GetWidth() <= 0 || GetHeight() <= 0) {
+		return true;
+	}
+
+	Rect rect;
+	BitmapRef draw_bitmap = PrepareBlit(rect);
+	if (!draw_bitmap) {
+		return true;
+	}
+
+	if (!renderer.CanDraw(*draw_bitmap)) {
+		BlitScreenIntern(renderer.GetLayer(), *draw_bitmap, rect);
+		return true;
+	}
+
+	AcceleratedRenderer::Quad quad;
+	quad.x = x;
+	quad.y = y;
+	quad.ox = ox;
+	quad.oy = oy;
+	quad.zoom_x = zoom_x_effect;
+	quad.zoom_y = zoom_y_effect;
+	quad.angle = angle_effect;
+	quad.opacity = Opacity(opacity_top_effect, opacity_bottom_effect, bush_effect);
+	renderer.DrawBitmap(*draw_bitmap, rect, quad);
+	return true;
+}
+
 void Sprite::BlitScreen(Bitmap& dst) {
-	if (!bitmap || (opacity_top_effect <= 0 && opacity_bottom_effect <= 0))
+	Rect rect;
+	BitmapRef draw_bitmap = PrepareBlit(rect);
+	if (!draw_bitmap) {
+		return;
+	}
+
+	if (transform_cache_enabled && BlitTransformCache(dst, *draw_bitmap, rect)) {
 		return;
+	}
+
+	BlitScreenIntern(dst, *draw_bitmap, rect);
+}
+
+bool Sprite::BlitTransformCache(Bitmap& dst, Bitmap const& draw_bitmap, Rect const& src_rect) {
+	const Opacity opacity(opacity_top_effect, opacity_bottom_effect, bush_effect);
+	const bool transformed = zoom_x_effect != 1.0 || zoom_y_effect != 1.0 || angle_effect != 0.0;
+
+	// Waver changes every frame and the bush opacity applies to source rows
+	if (!transformed || waver_effect_depth != 0 || opacity.IsSplit()) {
+		transform_cache.reset();
+		return false;
+	}
+
+	auto state = GetDrawState();
+	// The opacity is applied when the cached image is drawn
+	state.opacity_top = 0;
+	state.opacity_bottom = 0;
+	state.bounds.Adjust(dst.GetRect());
+
+	if (!(state == transform_state) || state.bounds != transform_state.bounds || &draw_bitmap != transform_source) {
+		// Changed since the last frame, probably animating
+		transform_cache.reset();
+		transform_state = state;
+		transform_source = &draw_bitmap;
+		return false;
+	}
+
+	const auto& bounds = transform_state.bounds;
+	if (bounds.IsEmpty()) {
+		return true;
+	}
+
+	if (!transform_cache) {
+		transform_cache = Bitmap::Create(bounds.width, bounds.height, true);
+		transform_cache->Clear();
+		transform_cache->EffectsBlit(x - bounds.x, y - bounds.y, ox, oy, draw_bitmap, src_rect,
+				Opacity(), zoom_x_effect, zoom_y_effect, angle_effect, 0, 0.0);
+	}
+
+	dst.Blit(bounds.x, bounds.y, *transform_cache, transform_cache->GetRect(), opacity);
+	return true;
+}
+
+BitmapRef Sprite::PrepareBlit(Rect& rect) {
+	if (!bitmap || (opacity_top_effect <= 0 && opacity_bottom_effect <= 0))
+		return BitmapRef();
 
 	BitmapRef draw_bitmap = Refresh(src_rect_effect);
 	if (!draw_bitmap) {
-		return;
+		return BitmapRef();
 	}
 
 	bitmap_changed = false;
 
-	Rect rect = src_rect_effect.GetSubRect(src_rect);
+	rect = src_rect_effect.GetSubRect(src_rect);
 	if (draw_bitmap == bitmap_effects) {
 		// When a "sprite rect" (src_rect_effect) is used bitmap_effects
 		// only has the size of this subrect instead of the whole bitmap
@@ -56,7 +256,7 @@ void Sprite::BlitScreen(Bitmap& dst) {
 		rect.y %= bitmap_effects->GetHeight();
 	}
 
-	BlitScreenIntern(dst, *draw_bitmap, rect);
+	return draw_bitmap;
 }
 
 void Sprite::BlitScreenIntern(Bitmap& dst, Bitmap const& draw_bitmap, Rect const& src_rect) const
@@ -106,7 +306,18 @@ BitmapRef Sprite::Refresh(Rect& rect) {
 		current_flip_x = flipx_effect;
 		current_flip_y = flipy_effect;
 
-		bitmap_effects = Cache::SpriteEffect(bitmap, rect, flipx_effect, flipy_effect, current_tone, current_flash);
+		if (flash_buffer_enabled && !no_flash) {
+			// The flash fades every frame, reuse the same image instead of caching each step
+			if (!flash_buffer || flash_buffer->GetWidth() != rect.width || flash_buffer->GetHeight() != rect.height) {
+				flash_buffer = Bitmap::Create(rect.width, rect.height, true);
+			} else {
+				flash_buffer->Clear();
+			}
+			Cache::DrawSpriteEffect(*flash_buffer, *bitmap, rect, flipx_effect, flipy_effect, current_tone, current_flash);
+			bitmap_effects = flash_buffer;
+		} else {
+			bitmap_effects = Cache::SpriteEffect(bitmap, rect, flipx_effect, flipy_effect, current_tone, current_flash);
+		}
 		bitmap_effects_src_rect = rect;
 
 		return bitmap_effects;
@@ -19,6 +19,7 @@
 #define EP_SPRITE_H
 
 // Headers
+#include <cstdint>
 #include "color.h"
 #include "drawable.h"
 #include "memory_management.h"
@@ -34,6 +35,15 @@ public:
 
 	void Draw(Bitmap& dst) override;
 
+	Rect GetDamage(const Rect& screen_rect) override;
+	Rect GetScreenBounds(const Rect& screen_rect) const override;
+	void OnComposited() override;
+
+	bool PrepareBands() override;
+	void DrawBand(Bitmap& dst) override;
+
+	bool DrawAccelerated(AcceleratedRenderer& renderer) override;
+
 	virtual int GetWidth() const;
 	virtual int GetHeight() const;
 
@@ -102,6 +112,25 @@ public:
 	 */
 	void SetFlashEffect(const Color &color);
 
+protected:
+	/**
+	 * Keeps the zoomed and rotated image of the sprite while it does not change.
+	 * Meant for mostly static sprites, the image is only kept when the state
+	 * of the sprite stayed the same for two frames.
+	 *
+	 * @param enabled Whether to keep transformed images
+	 */
+	void SetTransformCache(bool enabled);
+
+	/**
+	 * Applies a flash effect to a buffer of the sprite instead of an image
+	 * of Cache::SpriteEffect. Meant for sprites that flash often, every
+	 * frame of a flash would add an image to the effect cache otherwise.
+	 *
+	 * @param enabled Whether to use the buffer for flash effects
+	 */
+	void SetFlashBuffer(bool enabled);
+
 private:
 	BitmapRef bitmap;
 
@@ -137,12 +166,75 @@ private:
 	bool current_flip_y = false;
 	bool bitmap_changed = true;
 
+	/** Bitmap and source rect used by DrawBand, set by PrepareBands */
+	BitmapRef band_bitmap;
+	Rect band_rect;
+
+	/** Everything which affects the output of Draw(), used for change tracking */
+	struct DrawState {
+		bool visible = false;
+		const Bitmap* bitmap = nullptr;
+		uint32_t bitmap_revision = 0;
+		Rect src_rect;
+		Rect src_rect_effect;
+		int x = 0;
+		int y = 0;
+		int ox = 0;
+		int oy = 0;
+		int opacity_top = 0;
+		int opacity_bottom = 0;
+		int bush_depth = 0;
+		Tone tone;
+		Color flash;
+		int blend_type = 0;
+		Color blend_color;
+		double zoom_x = 1.0;
+		double zoom_y = 1.0;
+		double angle = 0.0;
+		int waver_depth = 0;
+		double waver_phase = 0.0;
+		bool flip_x = false;
+		bool flip_y = false;
+		/** Screen area covered by the sprite */
+		Rect bounds;
+
+		bool operator==(const DrawState& o) const;
+	};
+
+	DrawState composited_state;
+
+	/** Zoomed and rotated image drawn at transform_state.bounds, see SetTransformCache */
+	bool transform_cache_enabled = false;
+	BitmapRef transform_cache;
+	const Bitmap* transform_source = nullptr;
+	DrawState transform_state;
+
+	/** Image with the flash effect applied, see SetFlashBuffer */
+	bool flash_buffer_enabled = false;
+	BitmapRef flash_buffer;
+
+	DrawState GetDrawState() const;
+	Rect GetScreenBounds() const;
+
 	void BlitScreen(Bitmap& dst);
+	/** @return whether the sprite was drawn from the transform cache */
+	bool BlitTransformCache(Bitmap& dst, Bitmap const& draw_bitmap, Rect const& src_rect);
+	BitmapRef PrepareBlit(Rect& rect);
 	void BlitScreenIntern(Bitmap& dst, Bitmap const& draw_bitmap,
 							Rect const& src_rect) const;
 	BitmapRef Refresh(Rect& rect);
 };
 
+inline void Sprite::SetTransformCache(bool enabled) {
+	transform_cache_enabled = enabled;
+	transform_cache.reset();
+}
+
+inline void Sprite::SetFlashBuffer(bool enabled) {
+	flash_buffer_enabled = enabled;
+	flash_buffer.reset();
+}
+
 inline int Sprite::GetWidth() const {
 	return src_rect.width;
 }
@@ -28,6 +28,8 @@
 
 Sprite_Battler::Sprite_Battler(Game_Battler* battler, int index) :
 	battler(battler), battle_index(index) {
+	// Damage flashes would fill the effect cache
+	SetFlashBuffer(true);
 }
 
 Sprite_Battler::~Sprite_Battler() {
@@ -148,7 +150,7 @@ void Sprite_Battler::Update() {
 				return;
 			}
 
-			SetSrcRect(Rect(frame * 48, ext->battler_index * 48, 48, 48));
+			SetCharsetFrame(ext->battler_index, frame);
 
 			if (cycle == 40) {
 				switch (loop_state) {
@@ -373,11 +375,8 @@ void Sprite_Battler::OnMonsterSpriteReady(FileRequestResult* result) {
 
 	ResetZ();
 
-	bool hue_change = hue != 0;
-	if (hue_change) {
-		BitmapRef new_graphic = Bitmap::Create(graphic->GetWidth(), graphic->GetHeight());
-		new_graphic->HueChangeBlit(0, 0, *graphic, graphic->GetRect(), hue);
-		graphic = new_graphic;
+	if (hue != 0) {
+		graphic = Cache::HueChange(graphic, hue);
 	}
 
 	SetBitmap(graphic);
@@ -385,7 +384,16 @@ void Sprite_Battler::OnMonsterSpriteReady(FileRequestResult* result) {
 
 void Sprite_Battler::OnBattlercharsetReady(FileRequestResult* result, int32_t battler_index) {
 	SetBitmap(Cache::Battlecharset(result->file));
-	SetSrcRect(Rect(0, battler_index * 48, 48, 48));
+	SetCharsetFrame(battler_index, 0);
+}
+
+void Sprite_Battler::SetCharsetFrame(int battler_index, int frame) {
+	if (!GetBitmap()) {
+		return;
+	}
+	// Effects are applied to the strip of the pose, not to the whole charset
+	SetSpriteRect(Rect(0, battler_index * 48, GetBitmap()->GetWidth(), 48));
+	SetSrcRect(Rect(frame * 48, 0, 48, 48));
 }
 
 int Sprite_Battler::GetMaxOpacity() const {
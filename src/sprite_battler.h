@@ -110,6 +110,13 @@ protected:
 	void DoIdleAnimation();
 	void OnMonsterSpriteReady(FileRequestResult* result);
 	void OnBattlercharsetReady(FileRequestResult* result, int32_t battler_index);
+	/**
+	 * Shows a frame of a battle charset pose.
+	 *
+	 * @param battler_index row of the pose in the charset
+	 * @param frame frame in the row
+	 */
+	void SetCharsetFrame(int battler_index, int frame);
 	int GetMaxOpacity() const;
 
 	std::string sprite_name;
@@ -16,6 +16,7 @@
  */
 
 // Headers
+#include <tuple>
 #include "sprite_character.h"
 #include "cache.h"
 #include "game_map.h"
@@ -35,15 +36,23 @@ Sprite_Character::Sprite_Character(Game_Character* character, CloneType type) :
 }
 
 void Sprite_Character::Update() {
+	// The name is only compared when the character touched its sprite
+	bool sprite_changed = false;
+	if (sprite_revision != character->GetSpriteRevision()) {
+		sprite_revision = character->GetSpriteRevision();
+		sprite_changed = character_name != character->GetSpriteName() ||
+			character_index != character->GetSpriteIndex();
+	}
+
 	if (tile_id != character->GetTileId() ||
-		character_name != character->GetSpriteName() ||
-		character_index != character->GetSpriteIndex() ||
+		sprite_changed ||
 		refresh_bitmap
 	) {
 		tile_id = character->GetTileId();
 		character_name = character->GetSpriteName();
 		character_index = character->GetSpriteIndex();
 		refresh_bitmap = false;
+		update_state = UpdateState();
 
 		if (UsesCharset()) {
 			FileRequestAsync* char_request = AsyncHandler::RequestFile("CharSet", character_name);
@@ -58,32 +67,70 @@ void Sprite_Character::Update() {
 		}
 	}
 
+	UpdateState state;
+	state.valid = true;
+	state.facing = character->GetFacing();
+	state.frame = character->GetAnimFrame();
+	state.flash = character->GetFlashColor();
+	state.opacity = character->GetOpacity();
+	state.visible = character->IsVisible();
+	state.x = character->GetScreenX(x_shift);
+	state.y = character->GetScreenY(y_shift);
+	// y_shift because Z is calculated via the screen Y position
+	state.z = character->GetScreenZ(y_shift);
+	state.bush_depth = character->GetBushDepth();
+
+	if (state == update_state) {
+		// Nothing changed, the sprite and its effect bitmap are still valid
+		return;
+	}
+	update_state = state;
+
 	if (UsesCharset()) {
-		int row = character->GetFacing();
-		auto frame = character->GetAnimFrame();
+		int row = state.facing;
+		auto frame = state.frame;
 		if (frame >= lcf::rpg::EventPage::Frame_middle2) frame = lcf::rpg::EventPage::Frame_middle;
 		SetSrcRect({frame * chara_width, row * chara_height, chara_width, chara_height});
 	}
 
-	SetFlashEffect(character->GetFlashColor());
+	SetFlashEffect(state.flash);
 
-	SetOpacity(character->GetOpacity());
-	SetVisible(character->IsVisible());
+	SetOpacity(state.opacity);
+	SetVisible(state.visible);
 
-	SetX(character->GetScreenX(x_shift));
-	SetY(character->GetScreenY(y_shift));
-	// y_shift because Z is calculated via the screen Y position
-	SetZ(character->GetScreenZ(y_shift));
+	SetX(state.x);
+	SetY(state.y);
+	SetZ(state.z);
 
-	int bush_split = 4 - character->GetBushDepth();
+	int bush_split = 4 - state.bush_depth;
 	SetBushDepth(bush_split > 3 ? 0 : GetHeight() / bush_split);
 }
 
+bool Sprite_Character::UpdateState::operator==(const UpdateState& o) const {
+	return std::tie(valid, facing, frame, flash, opacity, visible, x, y, z, bush_depth) ==
+		std::tie(o.valid, o.facing, o.frame, o.flash, o.opacity, o.visible, o.x, o.y, o.z, o.bush_depth);
+}
+
 Game_Character* Sprite_Character::GetCharacter() {
 	return character;
 }
 void Sprite_Character::SetCharacter(Game_Character* new_character) {
 	character = new_character;
+	update_state = UpdateState();
+}
+
+void Sprite_Character::Reset(Game_Character* new_character, CloneType type) {
+	character = new_character;
+	x_shift = ((type & XClone) == XClone);
+	y_shift = ((type & YClone) == YClone);
+
+	// Tiles come from the chipset of the new map
+	if (!UsesCharset()) {
+		refresh_bitmap = true;
+	}
+	update_state = UpdateState();
+
+	Update();
 }
 
 bool Sprite_Character::UsesCharset() const {
@@ -107,6 +154,7 @@ void Sprite_Character::OnTileSpriteReady(FileRequestResult*) {
 	SetOx(8);
 	SetOy(16);
 
+	update_state = UpdateState();
 	Update();
 }
 
@@ -144,5 +192,6 @@ void Sprite_Character::OnCharSpriteReady(FileRequestResult*) {
 	SetOy(chara_height);
 	SetSpriteRect(rect);
 
+	update_state = UpdateState();
 	Update();
 }
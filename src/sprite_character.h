@@ -65,6 +65,15 @@ public:
 	  */
 	void SetCharacter(Game_Character* character);
 
+	/**
+	 * Reuses the sprite for another character, e.g. after a teleport.
+	 * The charset bitmap is kept when the character uses the same charset.
+	 *
+	 * @param character game character to display
+	 * @param type Type of the sprite for multiple renderings on looping maps
+	 */
+	void Reset(Game_Character* character, CloneType type = CloneType::Original);
+
 	/**
 	 * Returns a Rect describing the boundaries for a single character
 	 *
@@ -87,6 +96,8 @@ private:
 	int tile_id;
 	std::string character_name;
 	int character_index;
+	/** Game_Character::GetSpriteRevision when the name was compared */
+	uint32_t sprite_revision = 0;
 
 	int chara_width;
 	int chara_height;
@@ -98,6 +109,25 @@ private:
 	bool y_shift = false;
 	bool refresh_bitmap = false;
 
+	/** Character state applied to the sprite by the last Update */
+	struct UpdateState {
+		/** false until the first Update and after the sprite bitmap changed */
+		bool valid = false;
+		int facing = 0;
+		int frame = 0;
+		Color flash;
+		int opacity = 0;
+		bool visible = false;
+		int x = 0;
+		int y = 0;
+		int z = 0;
+		int bush_depth = 0;
+
+		bool operator==(const UpdateState& o) const;
+	};
+
+	UpdateState update_state;
+
 	void OnTileSpriteReady(FileRequestResult*);
 	void OnCharSpriteReady(FileRequestResult*);
 
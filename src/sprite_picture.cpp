@@ -40,10 +40,16 @@ Sprite_Picture::Sprite_Picture(int pic_id, Drawable::Flags flags)
 	// priority layers feature is enabled.
 	// Battle Animations are below pictures
 	SetZ(Priority_PictureOld + pic_id);
+
+	// Zoomed and rotated pictures are often static, e.g. in custom menus
+	SetTransformCache(true);
 }
 
 void Sprite_Picture::OnPictureShow() {
 	last_spritesheet_frame = -1;
+	// Called after every SetBitmap of the picture
+	sheet = GetBitmap();
+	sheet_frames.clear();
 
 	const bool is_battle = Game_Battle::IsBattleRunning();
 	const auto& pic = Main_Data::game_pictures->GetPicture(pic_id);
@@ -63,20 +69,56 @@ void Sprite_Picture::OnPictureShow() {
 }
 
 
+Rect Sprite_Picture::GetDamage(const Rect& screen_rect) {
+	return Drawable::GetDamage(screen_rect);
+}
+
+Rect Sprite_Picture::GetScreenBounds(const Rect& screen_rect) const {
+	return Drawable::GetScreenBounds(screen_rect);
+}
+
 void Sprite_Picture::Draw(Bitmap& dst) {
+	if (UpdateState()) {
+		Sprite::Draw(dst);
+	}
+}
+
+bool Sprite_Picture::PrepareBands() {
+	band_visible = UpdateState();
+	if (!band_visible) {
+		// Nothing to draw in any band
+		return true;
+	}
+	return Sprite::PrepareBands();
+}
+
+void Sprite_Picture::DrawBand(Bitmap& dst) {
+	if (band_visible) {
+		Sprite::DrawBand(dst);
+	}
+}
+
+bool Sprite_Picture::DrawAccelerated(AcceleratedRenderer& renderer) {
+	if (!UpdateState()) {
+		return true;
+	}
+	return Sprite::DrawAccelerated(renderer);
+}
+
+bool Sprite_Picture::UpdateState() {
 	const auto& pic = Main_Data::game_pictures->GetPicture(pic_id);
 	const auto& data = pic.data;
 
 	auto& bitmap = GetBitmap();
 
-	if (!bitmap || data.name.empty()) {
-		return;
+	if (!bitmap || !sheet || data.name.empty()) {
+		return false;
 	}
 
 	const bool is_battle = Game_Battle::IsBattleRunning();
 
 	if (is_battle ? !pic.IsOnBattle() : !pic.IsOnMap()) {
-		return;
+		return false;
 	}
 
 	// RPG Maker 2k3 1.12: Spritesheets
@@ -86,12 +128,20 @@ void Sprite_Picture::Draw(Bitmap& dst) {
 	{
 		last_spritesheet_frame = data.spritesheet_frame;
 
-		const int sw = bitmap->GetWidth() / data.spritesheet_cols;
-		const int sh = bitmap->GetHeight() / data.spritesheet_rows;
-		const int sx = sw * ((data.spritesheet_frame) % data.spritesheet_cols);
-		const int sy = sh * ((data.spritesheet_frame) / data.spritesheet_cols % data.spritesheet_rows);
+		const int col = data.spritesheet_frame % data.spritesheet_cols;
+		const int row = data.spritesheet_frame / data.spritesheet_cols % data.spritesheet_rows;
+		auto frame = GetSheetFrame(col, row, data.spritesheet_cols, data.spritesheet_rows);
+		if (frame) {
+			SetBitmap(frame);
+		} else {
+			const int sw = sheet->GetWidth() / data.spritesheet_cols;
+			const int sh = sheet->GetHeight() / data.spritesheet_rows;
 
-		SetSrcRect(Rect{ sx, sy, sw, sh });
+			if (bitmap != sheet) {
+				SetBitmap(sheet);
+			}
+			SetSrcRect(Rect{ sw * col, sh * row, sw, sh });
+		}
 	}
 
 	int x = data.current_x;
@@ -142,7 +192,33 @@ void Sprite_Picture::Draw(Bitmap& dst) {
 		SetFlashEffect(Main_Data::game_screen->GetFlashColor());
 	}
 
-	Sprite::Draw(dst);
+	return true;
 }
 
+BitmapRef Sprite_Picture::GetSheetFrame(int col, int row, int cols, int rows) {
+	if (sheet->IsPaletted() || col < 0 || row < 0) {
+		return nullptr;
+	}
+
+	const int sw = sheet->GetWidth() / cols;
+	const int sh = sheet->GetHeight() / rows;
+	if (sw <= 0 || sh <= 0) {
+		return nullptr;
+	}
 
+	if (cols != sheet_cols || rows != sheet_rows) {
+		sheet_frames.clear();
+		sheet_cols = cols;
+		sheet_rows = rows;
+	}
+	sheet_frames.resize(cols * rows);
+
+	// The views share the pixels of the sheet. Effects and opacity are per
+	// frame, opaque frames are blitted without blending.
+	auto& frame = sheet_frames[row * cols + col];
+	if (!frame) {
+		frame = Bitmap::CreateView(sheet, Rect{ sw * col, sh * row, sw, sh });
+		frame->CheckPixels(Bitmap::Flag_ReadOnly);
+	}
+	return frame;
+}
@@ -18,6 +18,7 @@
 #ifndef EP_PICTURE_SPRITE_H
 #define EP_PICTURE_SPRITE_H
 
+#include <vector>
 #include "sprite.h"
 
 class Bitmap;
@@ -36,10 +37,43 @@ public:
 
 	void Draw(Bitmap& dst) override;
 
+	/** Pictures update their sprite state while drawing and are neither tracked nor culled */
+	Rect GetDamage(const Rect& screen_rect) override;
+	Rect GetScreenBounds(const Rect& screen_rect) const override;
+
+	bool PrepareBands() override;
+	void DrawBand(Bitmap& dst) override;
+	bool DrawAccelerated(AcceleratedRenderer& renderer) override;
+
 	void OnPictureShow();
 
 private:
+	/**
+	 * Applies the state of the picture to the sprite.
+	 *
+	 * @return whether the picture is drawn
+	 */
+	bool UpdateState();
+
+	/**
+	 * Gets a frame of the sprite sheet, sliced into a view of the sheet
+	 * on first use.
+	 *
+	 * @param col column of the frame
+	 * @param row row of the frame
+	 * @param cols number of columns of the sheet
+	 * @param rows number of rows of the sheet
+	 * @return view of the frame, null when the sheet can't be sliced
+	 */
+	BitmapRef GetSheetFrame(int col, int row, int cols, int rows);
+
+	/** The picture with all frames, the sprite draws the frame views */
+	BitmapRef sheet;
+	std::vector<BitmapRef> sheet_frames;
+	int sheet_cols = 0;
+	int sheet_rows = 0;
 	int last_spritesheet_frame = -1;
+	bool band_visible = false;
 	const int pic_id = 0;
 	const bool feature_spritesheet = false;
 	const bool feature_priority_layers = false;
@@ -59,6 +59,22 @@ Sprite_Timer::Sprite_Timer(int which) :
 Sprite_Timer::~Sprite_Timer() {
 }
 
+Rect Sprite_Timer::GetDamage(const Rect& screen_rect) {
+	return Drawable::GetDamage(screen_rect);
+}
+
+Rect Sprite_Timer::GetScreenBounds(const Rect& screen_rect) const {
+	return Drawable::GetScreenBounds(screen_rect);
+}
+
+bool Sprite_Timer::PrepareBands() {
+	return false;
+}
+
+bool Sprite_Timer::DrawAccelerated(AcceleratedRenderer&) {
+	return false;
+}
+
 void Sprite_Timer::Draw(Bitmap& dst) {
 	if (!Main_Data::game_party->GetTimerVisible(which, Game_Battle::IsBattleRunning())) {
 		return;
@@ -38,6 +38,12 @@ public:
 protected:
 	void Draw(Bitmap& dst) override;
 
+	/** The timer renders its digits while drawing and is neither tracked nor culled */
+	Rect GetDamage(const Rect& screen_rect) override;
+	Rect GetScreenBounds(const Rect& screen_rect) const override;
+	bool PrepareBands() override;
+	bool DrawAccelerated(AcceleratedRenderer& renderer) override;
+
 	int which = 0;
 
 	Rect digits[5];
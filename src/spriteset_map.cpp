@@ -30,9 +30,13 @@
 #include "bitmap.h"
 #include "player.h"
 #include "drawable_list.h"
+#include "drawable_mgr.h"
 
 // Constructor
-Spriteset_Map::Spriteset_Map() {
+Spriteset_Map::Spriteset_Map() : Spriteset_Map(nullptr) {
+}
+
+Spriteset_Map::Spriteset_Map(Spriteset_Map* previous) {
 	tilemap.reset(new Tilemap());
 	tilemap->SetWidth(Game_Map::GetWidth());
 	tilemap->SetHeight(Game_Map::GetHeight());
@@ -45,21 +49,51 @@ Spriteset_Map::Spriteset_Map() {
 	need_x_clone = Game_Map::LoopHorizontal();
 	need_y_clone = Game_Map::LoopVertical();
 
+	if (previous) {
+		// Event dense maps would otherwise free and allocate hundreds of sprites
+		sprite_pool = std::move(previous->character_sprites);
+		previous->character_sprites.clear();
+		character_sprites.reserve(sprite_pool.size());
+		if (previous->need_x_clone == need_x_clone && previous->need_y_clone == need_y_clone) {
+			airship_shadows = std::move(previous->airship_shadows);
+			previous->airship_shadows.clear();
+		}
+
+		// Not depending on the map
+		timer1 = std::move(previous->timer1);
+		timer2 = std::move(previous->timer2);
+		screen = std::move(previous->screen);
+		frame = std::move(previous->frame);
+	}
+
 	for (Game_Event& ev : Game_Map::GetEvents()) {
 		CreateSprite(&ev, need_x_clone, need_y_clone);
 	}
 
-	CreateAirshipShadowSprite(need_x_clone, need_y_clone);
+	if (airship_shadows.empty()) {
+		CreateAirshipShadowSprite(need_x_clone, need_y_clone);
+	}
 
 	CreateSprite(Main_Data::game_player.get(), need_x_clone, need_y_clone);
 
-	timer1.reset(new Sprite_Timer(0));
-	timer2.reset(new Sprite_Timer(1));
+	if (!timer1) {
+		timer1.reset(new Sprite_Timer(0));
+		timer2.reset(new Sprite_Timer(1));
+	}
 
-	screen.reset(new Screen());
-	frame.reset(new Frame());
+	if (!screen) {
+		screen.reset(new Screen());
+		frame.reset(new Frame());
+	}
 
+	// Vehicles on the map are created by the first update
 	Update();
+
+	// Sprites not needed by this map are freed with the previous spriteset
+	if (previous) {
+		previous->character_sprites.assign(sprite_pool.begin() + sprite_pool_used, sprite_pool.end());
+	}
+	sprite_pool.clear();
 }
 
 // Update
@@ -187,18 +221,31 @@ bool Spriteset_Map::RequireClear(DrawableList& drawable_list) {
 	return true;
 }
 
+std::shared_ptr<Sprite_Character> Spriteset_Map::TakeSprite(Game_Character* character, Sprite_Character::CloneType type) {
+	if (sprite_pool_used >= sprite_pool.size()) {
+		return std::make_shared<Sprite_Character>(character, type);
+	}
+
+	auto sprite = std::move(sprite_pool[sprite_pool_used++]);
+	// Registered again, this keeps the draw order of equal z like new sprites
+	DrawableMgr::Remove(sprite.get());
+	DrawableMgr::Register(sprite.get());
+	sprite->Reset(character, type);
+	return sprite;
+}
+
 void Spriteset_Map::CreateSprite(Game_Character* character, bool create_x_clone, bool create_y_clone) {
 	using CloneType = Sprite_Character::CloneType;
 
-	character_sprites.push_back(std::make_shared<Sprite_Character>(character));
+	character_sprites.push_back(TakeSprite(character, CloneType::Original));
 	if (create_x_clone) {
-		character_sprites.push_back(std::make_shared<Sprite_Character>(character, CloneType::XClone));
+		character_sprites.push_back(TakeSprite(character, CloneType::XClone));
 	}
 	if (create_y_clone) {
-		character_sprites.push_back(std::make_shared<Sprite_Character>(character, CloneType::YClone));
+		character_sprites.push_back(TakeSprite(character, CloneType::YClone));
 	}
 	if (create_x_clone && create_y_clone) {
-		character_sprites.push_back(std::make_shared<Sprite_Character>(character,
+		character_sprites.push_back(TakeSprite(character,
 			(CloneType)(CloneType::XClone | CloneType::YClone)));
 	}
 }
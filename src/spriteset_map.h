@@ -27,9 +27,9 @@
 #include "sprite_airshipshadow.h"
 #include "sprite_timer.h"
 #include "system.h"
+#include "sprite_character.h"
 #include "tilemap.h"
 
-class Sprite_Character;
 class Game_Character;
 class FileRequestAsync;
 class DrawableList;
@@ -42,6 +42,14 @@ class Spriteset_Map {
 public:
 	Spriteset_Map();
 
+	/**
+	 * Creates the spriteset of the current map and reuses the character
+	 * and airship shadow sprites of the spriteset of the previous map.
+	 *
+	 * @param previous spriteset of the same scene, the sprites are taken from it
+	 */
+	explicit Spriteset_Map(Spriteset_Map* previous);
+
 	void Update();
 
 	/**
@@ -85,7 +93,12 @@ protected:
 	std::unique_ptr<Screen> screen;
 	std::unique_ptr<Frame> frame;
 
+	/** Sprites of the previous spriteset, reused by CreateSprite in the constructor */
+	std::vector<std::shared_ptr<Sprite_Character>> sprite_pool;
+	size_t sprite_pool_used = 0;
+
 	void CreateSprite(Game_Character* character, bool create_x_clone, bool create_y_clone);
+	std::shared_ptr<Sprite_Character> TakeSprite(Game_Character* character, Sprite_Character::CloneType type);
 	void CreateAirshipShadowSprite(bool create_x_clone, bool create_y_clone);
 
 	void OnTilemapSpriteReady(FileRequestResult*);
@@ -0,0 +1,167 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include "startup_stats.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <sstream>
+#include "filefinder.h"
+#include "output.h"
+
+namespace {
+	constexpr auto num_stages = static_cast<size_t>(StartupStats::Stage::END);
+
+	constexpr std::array<const char*, num_stages> stage_names = {{
+		"CommandLine",
+		"DirectoryTree",
+		"GuessExtensions",
+		"Translation",
+		"Database",
+		"RtpPaths",
+		"RtpDetect",
+		"Font",
+		"ExeReader",
+		"FirstFrame"
+	}};
+
+	std::atomic<bool> enabled(false);
+	bool game_ready = false;
+	Game_Clock::time_point begin;
+	Game_Clock::time_point ready;
+	/** Ticks of Game_Clock::duration per stage, RTP paths are probed on several threads */
+	std::array<std::atomic<int64_t>, num_stages> totals = {};
+	std::array<std::atomic<int>, num_stages> counts = {};
+	Game_Clock::duration total = {};
+	std::string output_path;
+
+	double ToMilliseconds(Game_Clock::duration dt) {
+		return std::chrono::duration<double, std::milli>(dt).count();
+	}
+}
+
+const char* StartupStats::GetName(Stage stage) {
+	return stage_names[static_cast<size_t>(stage)];
+}
+
+void StartupStats::Begin() {
+	for (size_t i = 0; i < num_stages; ++i) {
+		totals[i].store(0, std::memory_order_relaxed);
+		counts[i].store(0, std::memory_order_relaxed);
+	}
+	total = {};
+	game_ready = false;
+	enabled.store(true, std::memory_order_relaxed);
+	begin = Game_Clock::now();
+}
+
+bool StartupStats::IsEnabled() {
+	return enabled.load(std::memory_order_relaxed);
+}
+
+void StartupStats::SetOutputPath(std::string path) {
+	output_path = std::move(path);
+}
+
+void StartupStats::Add(Stage stage, Game_Clock::duration dt) {
+	totals[static_cast<size_t>(stage)].fetch_add(static_cast<int64_t>(dt.count()), std::memory_order_relaxed);
+	counts[static_cast<size_t>(stage)].fetch_add(1, std::memory_order_relaxed);
+}
+
+Game_Clock::duration StartupStats::GetTotal(Stage stage) {
+	return Game_Clock::duration(static_cast<Game_Clock::rep>(totals[static_cast<size_t>(stage)].load(std::memory_order_relaxed)));
+}
+
+int StartupStats::GetCount(Stage stage) {
+	return counts[static_cast<size_t>(stage)].load(std::memory_order_relaxed);
+}
+
+void StartupStats::OnGameReady() {
+	if (enabled) {
+		game_ready = true;
+		ready = Game_Clock::now();
+	}
+}
+
+void StartupStats::OnFrameEnd() {
+	if (!enabled || !game_ready) {
+		return;
+	}
+
+	const auto now = Game_Clock::now();
+	Add(Stage::FirstFrame, now - ready);
+	total = now - begin;
+	enabled.store(false, std::memory_order_relaxed);
+
+	Output::Debug("{}", GetSummary());
+
+	if (output_path.empty()) {
+		return;
+	}
+
+	auto os = FileFinder::OpenOutputStream(output_path, std::ios_base::out | std::ios_base::trunc);
+	if (!os) {
+		Output::Warning("StartupStats: Cannot write {}", output_path);
+		return;
+	}
+	WriteJson(os);
+	Output::Debug("StartupStats: Wrote {}", output_path);
+}
+
+std::string StartupStats::GetSummary() {
+	std::ostringstream ss;
+	ss.setf(std::ios_base::fixed);
+	ss.precision(1);
+	ss << "Startup: " << ToMilliseconds(total) << " ms (";
+	bool first = true;
+	for (size_t i = 0; i < num_stages; ++i) {
+		const auto stage = static_cast<Stage>(i);
+		if (GetCount(stage) == 0) {
+			continue;
+		}
+		if (!first) {
+			ss << ", ";
+		}
+		first = false;
+		ss << stage_names[i] << " " << ToMilliseconds(GetTotal(stage)) << " ms";
+		if (GetCount(stage) > 1) {
+			ss << " x" << GetCount(stage);
+		}
+	}
+	ss << ")";
+	return ss.str();
+}
+
+void StartupStats::WriteJson(std::ostream& os) {
+	const auto flags = os.flags();
+	const auto precision = os.precision();
+	os.setf(std::ios_base::fixed);
+	os.precision(3);
+
+	os << "{\"total_ms\":" << ToMilliseconds(total) << ",\"stages\":[\n";
+	for (size_t i = 0; i < num_stages; ++i) {
+		const auto stage = static_cast<Stage>(i);
+		os << "{\"name\":\"" << stage_names[i] << "\",\"ms\":" << ToMilliseconds(GetTotal(stage))
+			<< ",\"count\":" << GetCount(stage) << "}"
+			<< (i + 1 < num_stages ? ",\n" : "\n");
+	}
+	os << "]}\n";
+
+	os.flags(flags);
+	os.precision(precision);
+}
@@ -0,0 +1,136 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_STARTUP_STATS_H
+#define EP_STARTUP_STATS_H
+
+// Headers
+#include <ostream>
+#include <string>
+#include "game_clock.h"
+
+/**
+ * Time spent in the stages of the startup, from Player::Init until the
+ * first frame after the game objects were created. Logged once as a
+ * summary line and optionally written as JSON.
+ * Stages may nest (RTP detection happens while adding the RTP paths),
+ * they are listed separately and do not add up to the total.
+ */
+namespace StartupStats {
+	/** Measured stages of the startup */
+	enum class Stage {
+		/** Player::ParseCommandLine */
+		CommandLine,
+		/** FileFinder::CreateDirectoryTree of the game directory */
+		DirectoryTree,
+		/** Player::GuessNonStandardExtensions */
+		GuessExtensions,
+		/** Translation::InitTranslations */
+		Translation,
+		/** Player::LoadDatabase */
+		Database,
+		/** FileFinder::InitRtpPaths */
+		RtpPaths,
+		/** RTP::Detect of every RTP path */
+		RtpDetect,
+		/** Loading of the ExFont */
+		Font,
+		/** EXEReader reading the ExFont from RPG_RT.exe */
+		ExeReader,
+		/** Rest of the frame after the game objects were created */
+		FirstFrame,
+		END
+	};
+
+	/** @return short name of the stage */
+	const char* GetName(Stage stage);
+
+	/** Starts measuring, called at the beginning of Player::Init */
+	void Begin();
+
+	/** @return whether the startup is measured */
+	bool IsEnabled();
+
+	/**
+	 * Sets the file the stages are written to as JSON when the startup is done.
+	 *
+	 * @param path output file, empty to disable
+	 */
+	void SetOutputPath(std::string path);
+
+	/**
+	 * Adds time spent in a stage. May be called from any thread.
+	 *
+	 * @param stage measured stage
+	 * @param dt time spent
+	 */
+	void Add(Stage stage, Game_Clock::duration dt);
+
+	/** @return time spent in the stage */
+	Game_Clock::duration GetTotal(Stage stage);
+
+	/** @return how often the stage was entered */
+	int GetCount(Stage stage);
+
+	/** Called when Player::CreateGameObjects is done */
+	void OnGameReady();
+
+	/**
+	 * Called at the end of every frame. After the first frame following
+	 * OnGameReady the summary is logged, the JSON written and measuring stops.
+	 */
+	void OnFrameEnd();
+
+	/** @return "Startup: total ms (Stage ms, ...)" */
+	std::string GetSummary();
+
+	/**
+	 * Writes the stages as JSON object.
+	 *
+	 * @param os output stream
+	 */
+	void WriteJson(std::ostream& os);
+
+	/** Measures the time until the end of the scope */
+	class Scope {
+	public:
+		explicit Scope(Stage stage);
+		~Scope();
+
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+
+	private:
+		Stage stage;
+		Game_Clock::time_point start;
+		bool enabled;
+	};
+}
+
+inline StartupStats::Scope::Scope(Stage stage) : stage(stage), enabled(IsEnabled()) {
+	if (enabled) {
+		start = Game_Clock::now();
+	}
+}
+
+inline StartupStats::Scope::~Scope() {
+	if (enabled) {
+		Add(stage, Game_Clock::now() - start);
+	}
+}
+
+#endif
@@ -39,6 +39,12 @@ struct StdClock {
 	template <typename R, typename P>
 	static void SleepFor(std::chrono::duration<R,P> dt);
 
+	/** Give the remaining time slice to other threads */
+	static void YieldThread();
+
+	/** @return how early a coarse sleep ends before a deadline, the rest is spent yielding */
+	static constexpr std::chrono::microseconds SleepMargin();
+
 	static constexpr const char* Name();
 };
 
@@ -51,6 +57,19 @@ inline void StdClock::SleepFor(std::chrono::duration<R,P> dt) {
 	std::this_thread::sleep_for(dt);
 }
 
+inline void StdClock::YieldThread() {
+	std::this_thread::yield();
+}
+
+constexpr std::chrono::microseconds StdClock::SleepMargin() {
+#ifdef _WIN32
+	// Default timer resolution is coarse
+	return std::chrono::microseconds(2000);
+#else
+	return std::chrono::microseconds(1000);
+#endif
+}
+
 constexpr const char* StdClock::Name() {
 	if (std::is_same<clock,std::chrono::steady_clock>::value) {
 		return "StdSteady";
@@ -25,8 +25,127 @@
 #include "text.h"
 #include "compiler.h"
 
+#include <algorithm>
 #include <cctype>
 #include <iterator>
+#include <list>
+#include <unordered_map>
+
+namespace {
+	/** Rendered text including the shadow, as drawn onto a transparent bitmap */
+	struct TextRun {
+		BitmapRef bitmap;
+		/** Width of the text without shadow */
+		int width = 0;
+		/** Revision of the system graphic the run was drawn with */
+		uint32_t system_revision = 0;
+		std::list<std::string>::iterator lru_it;
+	};
+
+	/** Upper limit of the pixels of all cached runs */
+	constexpr int run_cache_max_pixels = 512 * 1024;
+	/** Longer texts are drawn directly */
+	constexpr int run_max_pixels = run_cache_max_pixels / 16;
+
+	std::unordered_map<std::string, TextRun> run_cache;
+	/** Keys by last use, most recent first */
+	std::list<std::string> run_cache_lru;
+	int run_cache_pixels = 0;
+
+	std::string MakeRunKey(const Font& font, const Bitmap& system, int color, StringView text) {
+		std::string key;
+		key.reserve(font.name.size() + text.size() + 6 * sizeof(uint32_t));
+
+		auto append = [&](uint32_t value) {
+			key.append(reinterpret_cast<const char*>(&value), sizeof(value));
+		};
+
+		append(system.GetId());
+		append(static_cast<uint32_t>(color));
+		append(font.size);
+		append(static_cast<uint32_t>(font.bold) | (static_cast<uint32_t>(font.italic) << 1));
+		// Exfont glyphs start with $, they depend on the current exfont image
+		append(text.find('$') != StringView::npos ? Cache::Exfont()->GetId() : 0);
+
+		key.append(font.name);
+		key.push_back('\0');
+		key.append(text.data(), text.size());
+		return key;
+	}
+
+	int DrawGlyphs(Bitmap& dest, int x, int y, Font& font, const Bitmap& system, int color, StringView text) {
+		// Where to draw the next glyph (x pos)
+		int next_glyph_pos = 0;
+
+		// This loops always renders a single char, color blends it and then puts
+		// it onto the text_surface (including the drop shadow)
+		auto iter = text.data();
+		const auto end = iter + text.size();
+		while (iter != end) {
+			auto ret = Utils::TextNext(iter, end, 0);
+
+			iter = ret.next;
+			if (EP_UNLIKELY(!ret)) {
+				continue;
+			}
+			next_glyph_pos += Text::Draw(dest, x + next_glyph_pos, y, font, system, color, ret.ch, ret.is_exfont).width;
+		}
+		return next_glyph_pos;
+	}
+
+	const TextRun& GetTextRun(Font& font, const Bitmap& system, int color, StringView text) {
+		auto key = MakeRunKey(font, system, color, text);
+
+		auto it = run_cache.find(key);
+		if (it != run_cache.end()) {
+			if (it->second.system_revision == system.GetRevision()) {
+				run_cache_lru.splice(run_cache_lru.begin(), run_cache_lru, it->second.lru_it);
+				return it->second;
+			}
+			run_cache_pixels -= it->second.bitmap->GetWidth() * it->second.bitmap->GetHeight();
+			run_cache_lru.erase(it->second.lru_it);
+			run_cache.erase(it);
+		}
+
+		// The glyphs can be larger than the size reported by the font
+		int width = 0;
+		int height = 0;
+		auto iter = text.data();
+		const auto end = iter + text.size();
+		while (iter != end) {
+			auto ret = Utils::TextNext(iter, end, 0);
+
+			iter = ret.next;
+			if (EP_UNLIKELY(!ret)) {
+				continue;
+			}
+			auto glyph = ret.is_exfont ? Font::exfont->Glyph(ret.ch) : font.Glyph(ret.ch);
+			width += glyph.rect.width;
+			height = std::max(height, glyph.rect.height);
+		}
+
+		TextRun run;
+		// Need place for shadow
+		run.bitmap = Bitmap::Create(width + 1, height + 1, true);
+		run.width = DrawGlyphs(*run.bitmap, 0, 0, font, system, color, text);
+		run.system_revision = system.GetRevision();
+
+		run_cache_lru.push_front(key);
+		run.lru_it = run_cache_lru.begin();
+		run_cache_pixels += run.bitmap->GetWidth() * run.bitmap->GetHeight();
+		auto& result = run_cache[std::move(key)];
+		result = std::move(run);
+
+		while (run_cache_pixels > run_cache_max_pixels && run_cache_lru.size() > 1) {
+			auto old = run_cache.find(run_cache_lru.back());
+			run_cache_pixels -= old->second.bitmap->GetWidth() * old->second.bitmap->GetHeight();
+			run_cache_lru.pop_back();
+			run_cache.erase(old);
+		}
+
+		return result;
+	}
+}
 
 Rect Text::Draw(Bitmap& dest, int x, int y, Font& font, const Bitmap& system, int color, char32_t ch, bool is_exfont) {
 	if (is_exfont) {
@@ -68,23 +187,15 @@ Rect Text::Draw(Bitmap& dest, const int x, const int y, Font& font, const Bitmap
 	const int iy = dst_rect.y;
 	const int ix = dst_rect.x;
 
-	// Where to draw the next glyph (x pos)
-	int next_glyph_pos = 0;
-
-	// This loops always renders a single char, color blends it and then puts
-	// it onto the text_surface (including the drop shadow)
-	auto iter = text.data();
-	const auto end = iter + text.size();
-	while (iter != end) {
-		auto ret = Utils::TextNext(iter, end, 0);
-
-		iter = ret.next;
-		if (EP_UNLIKELY(!ret)) {
-			continue;
-		}
-		next_glyph_pos += Text::Draw(dest, ix + next_glyph_pos, iy, font, system, color, ret.ch, ret.is_exfont).width;
+	if (dst_rect.width * dst_rect.height > run_max_pixels) {
+		return { x, y, DrawGlyphs(dest, ix, iy, font, system, color, text), ih };
 	}
-	return { x, y, next_glyph_pos, ih };
+
+	// Windows redraw the same texts on every refresh, the runs are cached
+	// and drawn with a single blit
+	const auto& run = GetTextRun(font, system, color, text);
+	dest.Blit(ix, iy, *run.bitmap, run.bitmap->GetRect(), Opacity::Opaque());
+	return { x, y, run.width, ih };
 }
 
 Rect Text::Draw(Bitmap& dest, const int x, const int y, Font& font, const Color color, StringView text) {
@@ -0,0 +1,62 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "thread_affinity.h"
+#include "output.h"
+
+#ifdef __SWITCH__
+#include <switch.h>
+#endif
+
+namespace {
+#ifdef __SWITCH__
+	struct Placement {
+		/** Preferred core */
+		int core;
+		/** Cores the thread may run on */
+		u32 mask;
+		/** Lower values are scheduled first, the main thread has 0x2C */
+		int priority;
+	};
+
+	Placement GetPlacement(ThreadAffinity::Role role) {
+		switch (role) {
+			case ThreadAffinity::Role::Main:
+				return { 0, 1u << 0, 0x2C };
+			case ThreadAffinity::Role::Audio:
+				return { 2, 1u << 2, 0x2B };
+			case ThreadAffinity::Role::Worker:
+				return { 1, (1u << 1) | (1u << 2), 0x2D };
+		}
+		return { 0, 1u << 0, 0x2C };
+	}
+#endif
+}
+
+void ThreadAffinity::Apply(Role role) {
+#ifdef __SWITCH__
+	const auto placement = GetPlacement(role);
+	if (R_FAILED(svcSetThreadCoreMask(CUR_THREAD_HANDLE, placement.core, placement.mask))) {
+		Output::Debug("Thread affinity: Cannot move thread to core {}", placement.core);
+	}
+	if (R_FAILED(svcSetThreadPriority(CUR_THREAD_HANDLE, placement.priority))) {
+		Output::Debug("Thread affinity: Cannot set priority {:#x}", placement.priority);
+	}
+#else
+	(void)role;
+#endif
+}
@@ -0,0 +1,45 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_THREAD_AFFINITY_H
+#define EP_THREAD_AFFINITY_H
+
+/**
+ * Places the threads of the Player on the CPU cores.
+ * On most platforms the scheduler decides and this does nothing.
+ *
+ * On Switch the application has cores 0 to 2:
+ *  - Main: game loop on core 0
+ *  - Audio: audio output and BGM decoding on core 2, above the main priority
+ *  - Worker: image decoding and compositing on cores 1 and 2, below the audio
+ */
+namespace ThreadAffinity {
+	enum class Role {
+		Main,
+		Audio,
+		Worker
+	};
+
+	/**
+	 * Applies the core and priority of the role to the calling thread.
+	 *
+	 * @param role what the thread does
+	 */
+	void Apply(Role role);
+}
+
+#endif
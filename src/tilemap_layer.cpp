@@ -16,6 +16,7 @@
  */
 
 // Headers
+#include <algorithm>
 #include <cstring>
 #include <cmath>
 #include "tilemap_layer.h"
@@ -29,6 +30,7 @@
 #include "game_system.h"
 #include "drawable_mgr.h"
 #include "baseui.h"
+#include "instrumentation.h"
 
 // Blocks subtiles IDs
 // Mess with this code and you will die in 3 days...
@@ -140,6 +142,20 @@ static constexpr uint8_t BlockD_Subtiles_IDS[50][2][2][2] = {
     {{{0, 0}, {0, 0}}, {{0, 0}, {0, 0}}}
 };
 
+namespace {
+	/**
+	 * Chunks kept per layer. A 320x240 screen shows up to 12 of them.
+	 * Chunks which were not drawn in the last frame are freed above this.
+	 */
+	constexpr int max_chunks = 36;
+
+	/** Tone changed animated tiles kept per layer */
+	constexpr size_t max_toned_tiles = 256;
+	constexpr int TONED_TILES_PER_ROW = 16;
+}
+
+constexpr int TilemapLayer::CHUNK_SIZE;
+
 TilemapLayer::TilemapLayer(int ilayer) :
 	substitutions(Game_Map::GetTilesLayer(ilayer)),
 	layer(ilayer),
@@ -156,25 +172,24 @@ TilemapLayer::TilemapLayer(int ilayer) :
 // was created intentionally. Inlining the transparency check was measured and shown
 // to provide a performance improvement
 EP_ALWAYS_INLINE
-void TilemapLayer::DrawTile(Bitmap& dst, Bitmap& tileset, Bitmap& tone_tileset, int x, int y, int row, int col, uint32_t tone_hash, bool allow_fast_blit) {
+ImageOpacity TilemapLayer::DrawTile(Bitmap& dst, Bitmap& tileset, int x, int y, int row, int col, uint32_t tone_hash, bool allow_fast_blit, bool apply_tone) {
 	auto op = tileset.GetTileOpacity(col, row);
 	if (op != ImageOpacity::Transparent) {
-		DrawTileImpl(dst, tileset, tone_tileset, x, y, row, col, tone_hash, op, allow_fast_blit);
+		DrawTileImpl(dst, tileset, x, y, row, col, tone_hash, op, allow_fast_blit, apply_tone);
 	}
+	return op;
 }
 
-void TilemapLayer::DrawTileImpl(Bitmap& dst, Bitmap& tileset, Bitmap& tone_tileset, int x, int y, int row, int col, uint32_t tone_hash, ImageOpacity op, bool allow_fast_blit) {
+void TilemapLayer::DrawTileImpl(Bitmap& dst, Bitmap& tileset, int x, int y, int row, int col, uint32_t tone_hash, ImageOpacity op, bool allow_fast_blit, bool apply_tone) {
 
 	auto rect = Rect{ col * TILE_SIZE, row * TILE_SIZE, TILE_SIZE, TILE_SIZE };
 
 	auto* src = &tileset;
 
-	// Create tone changed tile
-	if (tone != Tone()) {
-		if (chipset_tone_tiles.insert(tone_hash).second) {
-			tone_tileset.ToneBlit(col * TILE_SIZE, row * TILE_SIZE, tileset, rect, tone, Opacity::Opaque());
-		}
-		src = &tone_tileset;
+	// Use tone changed tile
+	if (apply_tone && tone != Tone()) {
+		rect = GetTonedTile(tileset, rect, tone_hash);
+		src = toned_tiles.get();
 	}
 
 	bool use_fast_blit = fast_blit && allow_fast_blit;
@@ -185,6 +200,64 @@ void TilemapLayer::DrawTileImpl(Bitmap& dst, Bitmap& tileset, Bitmap& tone_tiles
 	}
 }
 
+Rect TilemapLayer::GetTonedTile(Bitmap& tileset, const Rect& rect, uint32_t tone_hash) {
+	const uint32_t tone_key = static_cast<uint32_t>((tone.red << 24) | (tone.green << 16) | (tone.blue << 8) | tone.gray);
+	const uint64_t key = (static_cast<uint64_t>(tone_hash) << 32) | tone_key;
+
+	int slot;
+	auto it = toned_tiles_map.find(key);
+	if (it != toned_tiles_map.end()) {
+		toned_tiles_lru.splice(toned_tiles_lru.end(), toned_tiles_lru, it->second.lru_it);
+		slot = it->second.slot;
+	} else {
+		if (!toned_tiles) {
+			toned_tiles = Bitmap::Create(TONED_TILES_PER_ROW * TILE_SIZE, (max_toned_tiles / TONED_TILES_PER_ROW) * TILE_SIZE);
+		}
+
+		if (toned_tiles_map.size() < max_toned_tiles) {
+			slot = static_cast<int>(toned_tiles_map.size());
+		} else {
+			// Reuse the least recently used slot
+			auto old = toned_tiles_map.find(toned_tiles_lru.front());
+			slot = old->second.slot;
+			toned_tiles_lru.pop_front();
+			toned_tiles_map.erase(old);
+		}
+
+		toned_tiles_lru.push_back(key);
+		toned_tiles_map[key] = { slot, std::prev(toned_tiles_lru.end()) };
+
+		const int x = (slot % TONED_TILES_PER_ROW) * TILE_SIZE;
+		const int y = (slot / TONED_TILES_PER_ROW) * TILE_SIZE;
+		toned_tiles->BlitFast(x, y, tileset, rect, 255);
+		toned_tiles->ToneBlit(x, y, *toned_tiles, Rect(x, y, TILE_SIZE, TILE_SIZE), tone, Opacity::Opaque(), true);
+	}
+
+	return Rect((slot % TONED_TILES_PER_ROW) * TILE_SIZE, (slot / TONED_TILES_PER_ROW) * TILE_SIZE, TILE_SIZE, TILE_SIZE);
+}
+
+Bitmap& TilemapLayer::GetTonedChunk(Chunk& chunk, const Rect& rect) {
+	if (!chunk.toned) {
+		chunk.toned = Bitmap::Create(chunk.bitmap->width(), chunk.bitmap->height(), true);
+		chunk.toned_rect = Rect();
+	}
+
+	if (chunk.toned_tone != tone) {
+		chunk.toned_tone = tone;
+		chunk.toned_rect = Rect();
+	}
+
+	if (chunk.toned_rect.GetUnion(rect) != chunk.toned_rect) {
+		// Tone the composited tiles at once, only the parts which are drawn
+		Rect toned_rect = chunk.toned_rect.GetUnion(rect);
+		chunk.toned->BlitFast(toned_rect.x, toned_rect.y, *chunk.bitmap, toned_rect, 255);
+		chunk.toned->ToneBlit(toned_rect.x, toned_rect.y, *chunk.toned, toned_rect, tone, Opacity::Opaque(), true);
+		chunk.toned_rect = toned_rect;
+	}
+
+	return *chunk.toned;
+}
+
 static uint32_t MakeFTileHash(int id) {
 	return static_cast<uint32_t>(id);
 }
@@ -206,6 +279,12 @@ static uint32_t MakeAbTileHash(int id, int anim_step) {
 }
 
 void TilemapLayer::Draw(Bitmap& dst, int z_order) {
+	INSTRUMENTATION_SCOPE("TilemapLayer::Draw");
+
+	if (width <= 0 || height <= 0) {
+		return;
+	}
+
 	// Get the number of tiles that can be displayed on window
 	int tiles_x = (int)ceil(DisplayUi->GetWidth() / (float)TILE_SIZE);
 	int tiles_y = (int)ceil(DisplayUi->GetHeight() / (float)TILE_SIZE);
@@ -250,129 +329,293 @@ void TilemapLayer::Draw(Bitmap& dst, int z_order) {
 	const int mod_ox = mod(ox, TILE_SIZE);
 	const int mod_oy = mod(oy, TILE_SIZE);
 
-	for (int y = 0; y < tiles_y; y++) {
-		for (int x = 0; x < tiles_x; x++) {
+	++draw_count;
+
+	// Splits the visible tiles of one axis at the chunk and map borders
+	// and calls fn(map position, tile count, screen position in tiles)
+	auto for_each_segment = [&](int first, int count, int size, bool loop, auto&& fn) {
+		int screen = 0;
+		while (screen < count) {
+			int map = first + screen;
+			if (loop) {
+				map = mod(map, size);
+			} else if (map < 0) {
+				screen = -first;
+				continue;
+			} else if (map >= size) {
+				break;
+			}
+
+			int n = std::min(CHUNK_SIZE - map % CHUNK_SIZE, size - map);
+			n = std::min(n, count - screen);
+			fn(map, n, screen);
+			screen += n;
+		}
+	};
 
-			// Get the real maps tile coordinates
-			int map_x = div_ox + x;
-			int map_y = div_oy + y;
-			if (loop_h) map_x = mod(map_x, width);
-			if (loop_v) map_y = mod(map_y, height);
+	for_each_segment(div_oy, tiles_y, height, loop_v, [&](int map_y, int rows, int screen_y) {
+		for_each_segment(div_ox, tiles_x, width, loop_h, [&](int map_x, int cols, int screen_x) {
+			Chunk& chunk = GetChunk(map_x / CHUNK_SIZE, map_y / CHUNK_SIZE, z_order);
 
-			int map_draw_x = x * TILE_SIZE - mod_ox;
-			int map_draw_y = y * TILE_SIZE - mod_oy;
+			const int chunk_x = map_x % CHUNK_SIZE;
+			const int chunk_y = map_y % CHUNK_SIZE;
+			const int draw_x = screen_x * TILE_SIZE - mod_ox;
+			const int draw_y = screen_y * TILE_SIZE - mod_oy;
 
-			bool out_of_bounds =
-				map_x < 0 || map_x >= width ||
-				map_y < 0 || map_y >= height;
+			if (chunk.bitmap) {
+				Rect rect(chunk_x * TILE_SIZE, chunk_y * TILE_SIZE, cols * TILE_SIZE, rows * TILE_SIZE);
+				Bitmap* src = chunk.bitmap.get();
+				if (tone != Tone()) {
+					src = &GetTonedChunk(chunk, rect);
+				}
 
-			if (out_of_bounds) {
-				continue;
+				if (chunk.opaque) {
+					dst.BlitFast(draw_x, draw_y, *src, rect, 255);
+				} else {
+					dst.Blit(draw_x, draw_y, *src, rect, 255);
+				}
 			}
 
-			// Get the tile data
-			TileData &tile = GetDataCache(map_x, map_y);
-
-			// Draw the sublayer if its z is being draw now
-			if (z_order == tile.z) {
-				if (layer == 0) {
-					// If lower layer
-					bool allow_fast_blit = (tile.z == Priority_TilesetBelow);
-
-					if (tile.ID >= BLOCK_E && tile.ID < BLOCK_E + BLOCK_E_TILES) {
-						int id = substitutions[tile.ID - BLOCK_E];
-						// If Block E
-
-						int row, col;
-
-						// Get the tile coordinates from chipset
-						if (id < 96) {
-							// If from first column of the block
-							col = 12 + id % 6;
-							row = id / 6;
-						} else {
-							// If from second column of the block
-							col = 18 + (id - 96) % 6;
-							row = (id - 96) / 6;
-						}
-
-						auto tone_hash = MakeETileHash(id);
-						DrawTile(dst, *chipset, *chipset_effect, map_draw_x, map_draw_y, row, col, tone_hash, allow_fast_blit);
-					} else if (tile.ID >= BLOCK_C && tile.ID < BLOCK_D) {
-						// If Block C
-
-						// Get the tile coordinates from chipset
-						int col = 3 + (tile.ID - BLOCK_C) / 50;
-						int row = 4 + animation_step_c;
-
-						auto tone_hash = MakeCTileHash(tile.ID, animation_step_c);
-						DrawTile(dst, *chipset, *chipset_effect, map_draw_x, map_draw_y, row, col, tone_hash, allow_fast_blit);
-					} else if (tile.ID < BLOCK_C) {
-						// If Blocks A1, A2, B
-
-						// Draw the tile from autotile cache
-						TileXY pos = GetCachedAutotileAB(tile.ID, animation_step_ab);
-
-						int col = pos.x;
-						int row = pos.y;
-
-						// Create tone changed tile
-						auto tone_hash = MakeAbTileHash(tile.ID,  animation_step_ab);
-						DrawTile(dst, *autotiles_ab_screen, *autotiles_ab_screen_effect, map_draw_x, map_draw_y, row, col, tone_hash, allow_fast_blit);
-					} else {
-						// If blocks D1-D12
-
-						// Draw the tile from autotile cache
-						TileXY pos = GetCachedAutotileD(tile.ID);
-
-						int col = pos.x;
-						int row = pos.y;
-
-						auto tone_hash = MakeDTileHash(tile.ID);
-						DrawTile(dst, *autotiles_d_screen, *autotiles_d_screen_effect, map_draw_x, map_draw_y, row, col, tone_hash, allow_fast_blit);
-					}
-				} else {
-					// If upper layer
-
-					// Check that block F is being drawn
-					if (tile.ID >= BLOCK_F && tile.ID < BLOCK_F + BLOCK_F_TILES) {
-						int id = substitutions[tile.ID - BLOCK_F];
-						int row, col;
-
-						// Get the tile coordinates from chipset
-						if (id < 48) {
-							// If from first column of the block
-							col = 18 + id % 6;
-							row = 8 + id / 6;
-						} else {
-							// If from second column of the block
-							col = 24 + (id - 48) % 6;
-							row = (id - 48) / 6;
-						}
-
-						auto tone_hash = MakeFTileHash(id);
-						DrawTile(dst, *chipset, *chipset_effect, map_draw_x, map_draw_y, row, col, tone_hash);
-					}
+			for (int index: chunk.animated) {
+				const int x = index % CHUNK_SIZE - chunk_x;
+				const int y = index / CHUNK_SIZE - chunk_y;
+				if (x < 0 || x >= cols || y < 0 || y >= rows) {
+					continue;
 				}
+
+				const TileData& tile = GetDataCache(map_x + x, map_y + y);
+				DrawTileData(dst, tile, draw_x + x * TILE_SIZE, draw_y + y * TILE_SIZE, animation_step_c, animation_step_ab, true);
+			}
+		});
+	});
+
+	EvictChunks();
+}
+
+ImageOpacity TilemapLayer::DrawTileData(Bitmap& dst, const TileData& tile, int x, int y, int animation_step_c, int animation_step_ab, bool apply_tone) {
+	if (layer == 0) {
+		// If lower layer
+		bool allow_fast_blit = (tile.z == Priority_TilesetBelow);
+
+		if (tile.ID >= BLOCK_E && tile.ID < BLOCK_E + BLOCK_E_TILES) {
+			int id = substitutions[tile.ID - BLOCK_E];
+			// If Block E
+
+			int row, col;
+
+			// Get the tile coordinates from chipset
+			if (id < 96) {
+				// If from first column of the block
+				col = 12 + id % 6;
+				row = id / 6;
+			} else {
+				// If from second column of the block
+				col = 18 + (id - 96) % 6;
+				row = (id - 96) / 6;
+			}
+
+			auto tone_hash = MakeETileHash(id);
+			return DrawTile(dst, *chipset, x, y, row, col, tone_hash, allow_fast_blit, apply_tone);
+		} else if (tile.ID >= BLOCK_C && tile.ID < BLOCK_D) {
+			// If Block C
+
+			// Get the tile coordinates from chipset
+			int col = 3 + (tile.ID - BLOCK_C) / 50;
+			int row = 4 + animation_step_c;
+
+			auto tone_hash = MakeCTileHash(tile.ID, animation_step_c);
+			return DrawTile(dst, *chipset, x, y, row, col, tone_hash, allow_fast_blit, apply_tone);
+		} else if (tile.ID < BLOCK_C) {
+			// If Blocks A1, A2, B
+
+			// Draw the tile from autotile cache
+			TileXY pos = GetCachedAutotileAB(tile.ID, animation_step_ab);
+			if (!pos.valid) {
+				return ImageOpacity::Transparent;
+			}
+
+			int col = pos.x;
+			int row = pos.y;
+
+			// Create tone changed tile
+			auto tone_hash = MakeAbTileHash(tile.ID,  animation_step_ab);
+			return DrawTile(dst, *autotiles->ab_screen, x, y, row, col, tone_hash, allow_fast_blit, apply_tone);
+		} else {
+			// If blocks D1-D12
+
+			// Draw the tile from autotile cache
+			TileXY pos = GetCachedAutotileD(tile.ID);
+			if (!pos.valid) {
+				return ImageOpacity::Transparent;
+			}
+
+			int col = pos.x;
+			int row = pos.y;
+
+			auto tone_hash = MakeDTileHash(tile.ID);
+			return DrawTile(dst, *autotiles->d_screen, x, y, row, col, tone_hash, allow_fast_blit, apply_tone);
+		}
+	} else {
+		// If upper layer
+
+		// Check that block F is being drawn
+		if (tile.ID >= BLOCK_F && tile.ID < BLOCK_F + BLOCK_F_TILES) {
+			int id = substitutions[tile.ID - BLOCK_F];
+			int row, col;
+
+			// Get the tile coordinates from chipset
+			if (id < 48) {
+				// If from first column of the block
+				col = 18 + id % 6;
+				row = 8 + id / 6;
+			} else {
+				// If from second column of the block
+				col = 24 + (id - 48) % 6;
+				row = (id - 48) / 6;
+			}
+
+			auto tone_hash = MakeFTileHash(id);
+			return DrawTile(dst, *chipset, x, y, row, col, tone_hash, true, apply_tone);
+		}
+	}
+
+	return ImageOpacity::Transparent;
+}
+
+bool TilemapLayer::IsAnimatedTile(short ID) const {
+	// Blocks A1, A2, B and C
+	return layer == 0 && ID < BLOCK_D;
+}
+
+TilemapLayer::Chunk& TilemapLayer::GetChunk(int chunk_x, int chunk_y, int z_order) {
+	const int chunks_x = (width + CHUNK_SIZE - 1) / CHUNK_SIZE;
+	const int chunks_y = (height + CHUNK_SIZE - 1) / CHUNK_SIZE;
+	const size_t count = static_cast<size_t>(chunks_x * chunks_y * 2);
+	if (chunks.size() != count) {
+		InvalidateChunks();
+		chunks.resize(count);
+	}
+
+	const int sublayer = (z_order == lower_layer.GetZ()) ? 0 : 1;
+	Chunk& chunk = chunks[(chunk_x + chunk_y * chunks_x) * 2 + sublayer];
+	if (!chunk.valid) {
+		BuildChunk(chunk, chunk_x, chunk_y, z_order);
+	}
+	chunk.last_used = draw_count;
+	return chunk;
+}
+
+void TilemapLayer::BuildChunk(Chunk& chunk, int chunk_x, int chunk_y, int z_order) {
+	const int first_x = chunk_x * CHUNK_SIZE;
+	const int first_y = chunk_y * CHUNK_SIZE;
+	const int cols = std::min(CHUNK_SIZE, width - first_x);
+	const int rows = std::min(CHUNK_SIZE, height - first_y);
+
+	chunk.bitmap.reset();
+	chunk.toned.reset();
+	chunk.animated.clear();
+	chunk.valid = true;
+	++built_chunks;
+
+	int opaque_tiles = 0;
+	int drawn_tiles = 0;
+	for (int y = 0; y < rows; ++y) {
+		for (int x = 0; x < cols; ++x) {
+			const TileData& tile = GetDataCache(first_x + x, first_y + y);
+			if (tile.z != z_order) {
+				continue;
+			}
+
+			if (IsAnimatedTile(tile.ID)) {
+				chunk.animated.push_back(static_cast<uint16_t>(x + y * CHUNK_SIZE));
+				continue;
+			}
+
+			if (!chunk.bitmap) {
+				chunk.bitmap = Bitmap::Create(cols * TILE_SIZE, rows * TILE_SIZE, true);
+				chunk.bitmap->Clear();
+			}
+
+			// Tone is applied to the whole chunk when it is drawn
+			auto op = DrawTileData(*chunk.bitmap, tile, x * TILE_SIZE, y * TILE_SIZE, 0, 0, false);
+			if (op == ImageOpacity::Opaque) {
+				++opaque_tiles;
 			}
+			if (op != ImageOpacity::Transparent) {
+				++drawn_tiles;
+			}
+		}
+	}
+
+	if (drawn_tiles == 0) {
+		// e.g. the empty tiles of the upper layer
+		chunk.bitmap.reset();
+	}
+	chunk.opaque = (opaque_tiles == cols * rows);
+}
+
+void TilemapLayer::EvictChunks() {
+	if (built_chunks <= max_chunks) {
+		return;
+	}
+
+	// Both sublayers draw once per frame
+	for (auto& chunk: chunks) {
+		if (chunk.valid && draw_count - chunk.last_used > 1) {
+			chunk.bitmap.reset();
+			chunk.toned.reset();
+			chunk.animated.clear();
+			chunk.valid = false;
+			--built_chunks;
 		}
 	}
 }
 
+void TilemapLayer::InvalidateChunks() {
+	chunks.clear();
+	built_chunks = 0;
+}
+
 TilemapLayer::TileXY TilemapLayer::GetCachedAutotileAB(short ID, short animID) {
 	short block = ID / 1000;
 	short b_subtile = (ID - block * 1000) / 50;
 	short a_subtile = ID - block * 1000 - b_subtile * 50;
-	return autotiles_ab[animID][block][b_subtile][a_subtile];
+
+	if (b_subtile >= TILE_SIZE || a_subtile >= 47) {
+		if (autotiles->invalid_ids.insert(ID).second) {
+			Output::Warning("Invalid AB autotile ID: {} (b_subtile = {}, a_subtile = {})",
+							ID, b_subtile, a_subtile);
+		}
+		return TileXY();
+	}
+
+	TileXY& tile_xy = autotiles->ab[animID][block][b_subtile][a_subtile];
+	if (!tile_xy.valid) {
+		tile_xy = GenerateAutotileAB(ID, animID);
+	}
+	return tile_xy;
 }
 
 TilemapLayer::TileXY TilemapLayer::GetCachedAutotileD(short ID) {
 	short block = (ID - 4000) / 50;
 	short subtile = ID - 4000 - block * 50;
-	return autotiles_d[block][subtile];
+
+	if (block >= 12 || subtile >= 50 || block < 0 || subtile < 0) {
+		if (autotiles->invalid_ids.insert(ID).second) {
+			Output::Warning("Tilemap index out of range: {} {}", block, subtile);
+		}
+		return TileXY();
+	}
+
+	TileXY& tile_xy = autotiles->d[block][subtile];
+	if (!tile_xy.valid) {
+		tile_xy = GenerateAutotileD(ID);
+	}
+	return tile_xy;
 }
 
 void TilemapLayer::CreateTileCache(const std::vector<short>& nmap_data) {
+	InvalidateChunks();
 	data_cache_vec.resize(width * height);
 	for (int x = 0; x < width; x++) {
 		for (int y = 0; y < height; y++) {
@@ -409,7 +652,7 @@ void TilemapLayer::CreateTileCache(const std::vector<short>& nmap_data) {
 	}
 }
 
-void TilemapLayer::GenerateAutotileAB(short ID, short animID) {
+TilemapLayer::TileXY TilemapLayer::GenerateAutotileAB(short ID, short animID) {
 	// Calculate the block to use
 	//	1: A1 + Upper B (Grass + Coast)
 	//	2: A2 + Upper B (Snow + Coast)
@@ -418,22 +661,9 @@ void TilemapLayer::GenerateAutotileAB(short ID, short animID) {
 
 	// Calculate the B block combination
 	short b_subtile = (ID - block * 1000) / 50;
-	if (b_subtile >= TILE_SIZE) {
-		Output::Warning("Invalid AB autotile ID: {} (b_subtile = {})",
-						ID, b_subtile);
-		return;
-	}
 
 	// Calculate the A block combination
 	short a_subtile = ID - block * 1000 - b_subtile * 50;
-	if (a_subtile >= 47) {
-		Output::Warning("Invalid AB autotile ID: {} (a_subtile = {})",
-						ID, a_subtile);
-		return;
-	}
-
-	if (autotiles_ab[animID][block][b_subtile][a_subtile].valid)
-		return;
 
 	uint8_t quarters[2][2][2];
 
@@ -491,37 +721,16 @@ void TilemapLayer::GenerateAutotileAB(short ID, short animID) {
 				quarters_hash |= quarters[j][i][k];
 			}
 
-	// check whether we have already generated this tile
-	auto it = autotiles_ab_map.find(quarters_hash);
-	if (it != autotiles_ab_map.end()) {
-		autotiles_ab[animID][block][b_subtile][a_subtile] = it->second;
-		return;
-	}
-
-	int id = autotiles_ab_next++;
-	int dst_x = id % TILES_PER_ROW;
-	int dst_y = id / TILES_PER_ROW;
-
-	TileXY tile_xy(dst_x, dst_y);
-	autotiles_ab_map[quarters_hash] = tile_xy;
-	autotiles_ab[animID][block][b_subtile][a_subtile] = tile_xy;
+	return AddAutotile(autotiles->ab_screen, autotiles->ab_map, quarters_hash);
 }
 
-void TilemapLayer::GenerateAutotileD(short ID) {
+TilemapLayer::TileXY TilemapLayer::GenerateAutotileD(short ID) {
 	// Calculate the D block id
 	short block = (ID - 4000) / 50;
 
 	// Calculate the D block combination
 	short subtile = ID - 4000 - block * 50;
 
-	if (block >= 12 || subtile >= 50 || block < 0 || subtile < 0) {
-		Output::Warning("Tilemap index out of range: {} {}", block, subtile);
-		return;
-	}
-
-	if (autotiles_d[block][subtile].valid)
-		return;
-
 	uint8_t quarters[2][2][2];
 
 	// Get Block chipset coords
@@ -554,105 +763,89 @@ void TilemapLayer::GenerateAutotileD(short ID) {
 				quarters_hash |= quarters[j][i][k];
 			}
 
+	return AddAutotile(autotiles->d_screen, autotiles->d_map, quarters_hash);
+}
+
+TilemapLayer::TileXY TilemapLayer::AddAutotile(BitmapRef& tiles, std::unordered_map<uint32_t, TileXY>& map, uint32_t quarters_hash) {
 	// check whether we have already generated this tile
-	auto it = autotiles_d_map.find(quarters_hash);
-	if (it != autotiles_d_map.end()) {
-		autotiles_d[block][subtile] = it->second;
-		return;
+	auto it = map.find(quarters_hash);
+	if (it != map.end()) {
+		return it->second;
 	}
 
-	int id = autotiles_d_next++;
-	int dst_x = id % TILES_PER_ROW;
-	int dst_y = id / TILES_PER_ROW;
-
-	TileXY tile_xy(dst_x, dst_y);
-	autotiles_d_map[quarters_hash] = tile_xy;
-	autotiles_d[block][subtile] = tile_xy;
-}
+	int id = static_cast<int>(map.size());
+	TileXY dst(id % TILES_PER_ROW, id / TILES_PER_ROW);
+	map[quarters_hash] = dst;
+
+	if (!tiles || tiles->height() <= dst.y * TILE_SIZE) {
+		// Grow the atlas, existing tiles keep their position
+		int rows = tiles ? tiles->height() / TILE_SIZE * 2 : 1;
+		BitmapRef grown = Bitmap::Create(TILES_PER_ROW * TILE_SIZE, rows * TILE_SIZE);
+		grown->Clear();
+		if (tiles) {
+			grown->BlitFast(0, 0, *tiles, tiles->GetRect(), 255);
+		}
+		grown->CheckPixels(Bitmap::Flag_Chipset);
+		tiles = grown;
+	}
 
-BitmapRef TilemapLayer::GenerateAutotiles(int count, const std::unordered_map<uint32_t, TileXY>& map) {
-	int rows = (count + TILES_PER_ROW - 1) / TILES_PER_ROW;
-	BitmapRef tiles = Bitmap::Create(TILES_PER_ROW * TILE_SIZE, rows * TILE_SIZE);
-	tiles->Clear();
 	Rect rect(0, 0, TILE_SIZE/2, TILE_SIZE/2);
 
-	for (auto& p: map) {
-		uint32_t quarters_hash = p.first;
-		TileXY dst = p.second;
-
-		// unpack the quarters data
-		for (int j = 0; j < 2; j++) {
-			for (int i = 0; i < 2; i++) {
-				int x = quarters_hash >> 28;
-				quarters_hash <<= 4;
+	// unpack the quarters data
+	for (int j = 0; j < 2; j++) {
+		for (int i = 0; i < 2; i++) {
+			int x = quarters_hash >> 28;
+			quarters_hash <<= 4;
 
-				int y = quarters_hash >> 28;
-				quarters_hash <<= 4;
+			int y = quarters_hash >> 28;
+			quarters_hash <<= 4;
 
-				rect.x = (x * 2 + i) * (TILE_SIZE/2);
-				rect.y = (y * 2 + j) * (TILE_SIZE/2);
+			rect.x = (x * 2 + i) * (TILE_SIZE/2);
+			rect.y = (y * 2 + j) * (TILE_SIZE/2);
 
-				tiles->BlitFast((dst.x * 2 + i) * (TILE_SIZE / 2), (dst.y * 2 + j) * (TILE_SIZE / 2), *chipset, rect, 255);
-			}
+			tiles->BlitFast((dst.x * 2 + i) * (TILE_SIZE / 2), (dst.y * 2 + j) * (TILE_SIZE / 2), *chipset, rect, 255);
 		}
 	}
 
-	if (rows > 0) {
-		tiles->CheckPixels(Bitmap::Flag_Chipset | Bitmap::Flag_ReadOnly);
+	tiles->CheckTilePixels(dst.x, dst.y);
+
+	return dst;
+}
+
+std::shared_ptr<TilemapLayer::AutotileAtlas> TilemapLayer::GetAutotileAtlas(const BitmapRef& chipset) {
+	static std::vector<std::shared_ptr<AutotileAtlas>> atlases;
+
+	// Chipsets are shared by the Cache, an atlas lives as long as its chipset
+	atlases.erase(std::remove_if(atlases.begin(), atlases.end(), [](const std::shared_ptr<AutotileAtlas>& atlas) {
+		return atlas->chipset.expired();
+	}), atlases.end());
+
+	for (auto& atlas: atlases) {
+		if (atlas->chipset.lock() == chipset) {
+			return atlas;
+		}
 	}
 
-	return tiles;
+	auto atlas = std::make_shared<AutotileAtlas>();
+	atlas->chipset = chipset;
+	atlases.push_back(atlas);
+	return atlas;
 }
 
 void TilemapLayer::SetChipset(BitmapRef const& nchipset) {
 	chipset = nchipset;
-	chipset_effect = Bitmap::Create(chipset->width(), chipset->height());
-	chipset_tone_tiles.clear();
-
-	if (autotiles_ab_next != 0 && autotiles_d_screen != nullptr && layer == 0) {
-		autotiles_ab_screen = GenerateAutotiles(autotiles_ab_next, autotiles_ab_map);
-		autotiles_d_screen = GenerateAutotiles(autotiles_d_next, autotiles_d_map);
+	ClearTonedTiles();
+	InvalidateChunks();
 
-		autotiles_ab_screen_effect = Bitmap::Create(autotiles_ab_screen->width(), autotiles_ab_screen->height());
-		autotiles_d_screen_effect = Bitmap::Create(autotiles_d_screen->width(), autotiles_d_screen->height());
+	if (layer == 0) {
+		// Autotiles are generated on first use
+		autotiles = GetAutotileAtlas(chipset);
 	}
 }
 
 void TilemapLayer::SetMapData(std::vector<short> nmap_data) {
 	// Create the tiles data cache
 	CreateTileCache(nmap_data);
-	memset(autotiles_ab, 0, sizeof(autotiles_ab));
-	memset(autotiles_d, 0, sizeof(autotiles_d));
-
-	if (layer == 0) {
-		autotiles_ab_map.clear();
-		autotiles_d_map.clear();
-		autotiles_ab_next = 0;
-		autotiles_d_next = 0;
-		for (int y = 0; y < height; y++) {
-			for (int x = 0; x < width; x++) {
-
-				if (GetDataCache(x, y).ID < BLOCK_C) {
-					// If blocks A and B
-
-					GenerateAutotileAB(GetDataCache(x, y).ID, 0);
-					GenerateAutotileAB(GetDataCache(x, y).ID, 1);
-					GenerateAutotileAB(GetDataCache(x, y).ID, 2);
-				} else if (GetDataCache(x, y).ID >= BLOCK_D && GetDataCache(x, y).ID < BLOCK_E) {
-					// If block D
-
-					GenerateAutotileD(GetDataCache(x, y).ID);
-				}
-			}
-		}
-		autotiles_ab_screen = GenerateAutotiles(autotiles_ab_next, autotiles_ab_map);
-		autotiles_d_screen = GenerateAutotiles(autotiles_d_next, autotiles_d_map);
-
-		autotiles_ab_screen_effect = Bitmap::Create(autotiles_ab_screen->width(), autotiles_ab_screen->height());
-		autotiles_d_screen_effect = Bitmap::Create(autotiles_d_screen->width(), autotiles_d_screen->height());
-
-		chipset_tone_tiles.clear();
-	}
 
 	map_data = std::move(nmap_data);
 }
@@ -691,14 +884,18 @@ void TilemapLayer::SetTone(Tone tone) {
 
 	this->tone = tone;
 
-	if (autotiles_d_screen_effect) {
-		autotiles_d_screen_effect->Clear();
-	}
-	if (autotiles_ab_screen_effect) {
-		autotiles_ab_screen_effect->Clear();
-	}
-	if (chipset_effect) {
-		chipset_effect->Clear();
+	// Chunks are toned again when drawn, toned animated tiles of other
+	// tones stay cached for tweens going back and forth
+	if (tone == Tone()) {
+		ClearTonedTiles();
+		for (auto& chunk: chunks) {
+			chunk.toned.reset();
+		}
 	}
-	chipset_tone_tiles.clear();
+}
+
+void TilemapLayer::ClearTonedTiles() {
+	toned_tiles.reset();
+	toned_tiles_map.clear();
+	toned_tiles_lru.clear();
 }
@@ -19,6 +19,8 @@
 #define EP_TILEMAP_LAYER_H
 
 // Headers
+#include <list>
+#include <memory>
 #include <vector>
 #include <map>
 #include <unordered_set>
@@ -27,6 +29,7 @@
 #include "drawable.h"
 #include "tone.h"
 #include "opacity.h"
+#include "rect.h"
 #include "span.h"
 
 class TilemapLayer;
@@ -87,8 +90,6 @@ public:
 
 private:
 	BitmapRef chipset;
-	BitmapRef chipset_effect;
-	std::unordered_set<uint32_t> chipset_tone_tiles;
 	std::vector<short> map_data;
 	std::vector<uint8_t> passable;
 	Span<const uint8_t> substitutions;
@@ -102,10 +103,8 @@ private:
 	bool fast_blit = false;
 
 	void CreateTileCache(const std::vector<short>& nmap_data);
-	void GenerateAutotileAB(short ID, short animID);
-	void GenerateAutotileD(short ID);
-	void DrawTile(Bitmap& dst, Bitmap& tile, Bitmap& tone_tile, int x, int y, int row, int col, uint32_t tone_hash, bool allow_fast_blit = true);
-	void DrawTileImpl(Bitmap& dst, Bitmap& tile, Bitmap& tone_tile, int x, int y, int row, int col, uint32_t tone_hash, ImageOpacity op, bool allow_fast_blit);
+	ImageOpacity DrawTile(Bitmap& dst, Bitmap& tile, int x, int y, int row, int col, uint32_t tone_hash, bool allow_fast_blit, bool apply_tone);
+	void DrawTileImpl(Bitmap& dst, Bitmap& tile, int x, int y, int row, int col, uint32_t tone_hash, ImageOpacity op, bool allow_fast_blit, bool apply_tone);
 
 	static const int TILES_PER_ROW = 64;
 
@@ -117,23 +116,33 @@ private:
 		TileXY(uint8_t x, uint8_t y) : x(x), y(y), valid(true) {}
 	};
 
-	BitmapRef GenerateAutotiles(int count, const std::unordered_map<uint32_t, TileXY>& map);
+	/** Autotiles generated from one chipset, shared by all layers using it */
+	struct AutotileAtlas {
+		std::weak_ptr<Bitmap> chipset;
 
-	TileXY GetCachedAutotileAB(short ID, short animID);
-	TileXY GetCachedAutotileD(short ID);
-	BitmapRef autotiles_ab_screen;
-	BitmapRef autotiles_ab_screen_effect;
-	BitmapRef autotiles_d_screen;
-	BitmapRef autotiles_d_screen_effect;
+		TileXY ab[3][3][16][47] = {};
+		TileXY d[12][50] = {};
+
+		/** Position in the atlas by packed quarters */
+		std::unordered_map<uint32_t, TileXY> ab_map;
+		std::unordered_map<uint32_t, TileXY> d_map;
+
+		BitmapRef ab_screen;
+		BitmapRef d_screen;
+
+		/** Invalid IDs which were already reported */
+		std::unordered_set<short> invalid_ids;
+	};
 
-	int autotiles_ab_next = -1;
-	int autotiles_d_next = -1;
+	static std::shared_ptr<AutotileAtlas> GetAutotileAtlas(const BitmapRef& chipset);
 
-	TileXY autotiles_ab[3][3][16][47] = {};
-	TileXY autotiles_d[12][50] = {};
+	TileXY GenerateAutotileAB(short ID, short animID);
+	TileXY GenerateAutotileD(short ID);
+	TileXY AddAutotile(BitmapRef& tiles, std::unordered_map<uint32_t, TileXY>& map, uint32_t quarters_hash);
 
-	std::unordered_map<uint32_t, TileXY> autotiles_ab_map;
-	std::unordered_map<uint32_t, TileXY> autotiles_d_map;
+	TileXY GetCachedAutotileAB(short ID, short animID);
+	TileXY GetCachedAutotileD(short ID);
+	std::shared_ptr<AutotileAtlas> autotiles;
 
 	struct TileData {
 		short ID;
@@ -144,6 +153,55 @@ private:
 
 	std::vector<TileData> data_cache_vec;
 
+	ImageOpacity DrawTileData(Bitmap& dst, const TileData& tile, int x, int y, int animation_step_c, int animation_step_ab, bool apply_tone);
+	bool IsAnimatedTile(short ID) const;
+
+	/** Width and height of a chunk in tiles */
+	static constexpr int CHUNK_SIZE = 16;
+
+	/**
+	 * Pre-rendered static tiles of one sublayer in a CHUNK_SIZE area of the map.
+	 * Animated tiles are drawn every frame on top of it.
+	 */
+	struct Chunk {
+		/** Static tiles, null when the chunk has none */
+		BitmapRef bitmap;
+		/** Animated tiles as x + y * CHUNK_SIZE */
+		std::vector<uint16_t> animated;
+		/** Tone changed copy of bitmap, valid inside toned_rect */
+		BitmapRef toned;
+		Tone toned_tone;
+		Rect toned_rect;
+		unsigned last_used = 0;
+		bool valid = false;
+		/** All tiles of the chunk are static and opaque */
+		bool opaque = false;
+	};
+
+	Chunk& GetChunk(int chunk_x, int chunk_y, int z_order);
+	void BuildChunk(Chunk& chunk, int chunk_x, int chunk_y, int z_order);
+	void EvictChunks();
+	void InvalidateChunks();
+
+	Rect GetTonedTile(Bitmap& tileset, const Rect& rect, uint32_t tone_hash);
+	Bitmap& GetTonedChunk(Chunk& chunk, const Rect& rect);
+	void ClearTonedTiles();
+
+	struct TonedTile {
+		int slot;
+		std::list<uint64_t>::iterator lru_it;
+	};
+
+	/** Tone changed animated tiles by tile hash and tone, least recently used first */
+	BitmapRef toned_tiles;
+	std::unordered_map<uint64_t, TonedTile> toned_tiles_map;
+	std::list<uint64_t> toned_tiles_lru;
+
+	/** Chunks of both sublayers, interleaved */
+	std::vector<Chunk> chunks;
+	int built_chunks = 0;
+	unsigned draw_count = 0;
+
 	TilemapSubLayer lower_layer;
 	TilemapSubLayer upper_layer;
 
@@ -194,6 +252,7 @@ inline int TilemapLayer::GetWidth() const {
 
 inline void TilemapLayer::SetWidth(int nwidth) {
 	width = nwidth;
+	InvalidateChunks();
 }
 
 inline int TilemapLayer::GetHeight() const {
@@ -202,6 +261,7 @@ inline int TilemapLayer::GetHeight() const {
 
 inline void TilemapLayer::SetHeight(int nheight) {
 	height = nheight;
+	InvalidateChunks();
 }
 
 inline int TilemapLayer::GetAnimationSpeed() const {
@@ -25,6 +25,7 @@
 #include "transition.h"
 #include "async_handler.h"
 #include "bitmap.h"
+#include "bitmap_simd.h"
 #include "game_player.h"
 #include "graphics.h"
 #include "main_data.h"
@@ -35,6 +36,28 @@
 #include "output.h"
 #include "rand.h"
 
+namespace {
+	inline uint32_t* GetRow(void* pixels, int pitch, int y) {
+		return reinterpret_cast<uint32_t*>(static_cast<uint8_t*>(pixels) + y * pitch);
+	}
+
+	inline const uint32_t* GetRow(const void* pixels, int pitch, int y) {
+		return reinterpret_cast<const uint32_t*>(static_cast<const uint8_t*>(pixels) + y * pitch);
+	}
+
+	/** The alpha channel of opaque bitmaps is undefined, the row kernels copy it */
+	void SetAlphaOpaque(Bitmap& bitmap) {
+		const uint32_t alpha = Bitmap::pixel_format.a.mask;
+		auto* pixels = bitmap.pixels();
+		for (int y = 0; y < bitmap.GetHeight(); ++y) {
+			uint32_t* row = GetRow(pixels, bitmap.pitch(), y);
+			for (int x = 0; x < bitmap.GetWidth(); ++x) {
+				row[x] |= alpha;
+			}
+		}
+	}
+}
+
 int Transition::GetDefaultFrames(Transition::Type type)
 {
 	switch (type) {
@@ -97,9 +120,10 @@ void Transition::Init(Type type, Scene *linked_scene, int duration, bool next_er
 	screen1.reset();
 	screen2.reset();
 
-	// Show Screen, the current frame is captured immediately
+	// Show Screen, the current frame is captured immediately.
+	// An erased screen is black, no capture needed.
 	if (!next_erase) {
-		screen1 = DisplayUi->CaptureScreen();
+		screen1 = from_erase ? GetBlackScreen() : Graphics::CaptureScreen();
 	}
 
 	// Total frames and erased have to be set *after* the above drawing code.
@@ -127,16 +151,15 @@ void Transition::SetAttributesTransitions() {
 		random_blocks[i] = i;
 	}
 
+	mask.clear();
+
 	switch (transition_type) {
 	case TransitionRandomBlocks:
-		random_block_transition = Bitmap::Create(DisplayUi->GetWidth(), DisplayUi->GetHeight(), true);
-		current_blocks_print = 0;
-		std::shuffle(random_blocks.begin(), random_blocks.end(), Rand::GetRNG());
+		std::shuffle(random_blocks.begin(), random_blocks.end(), Rand::GetRNG(Rand::Stream::Cosmetic));
+		CreateBlockMask(DisplayUi->GetWidth(), DisplayUi->GetHeight());
 		break;
 	case TransitionRandomBlocksDown:
 	case TransitionRandomBlocksUp:
-		random_block_transition = Bitmap::Create(DisplayUi->GetWidth(), DisplayUi->GetHeight(), true);
-		current_blocks_print = 0;
 		if (transition_type == TransitionRandomBlocksUp) { std::reverse(random_blocks.begin(), random_blocks.end()); }
 
 		w = DisplayUi->GetWidth() / 4;
@@ -144,7 +167,7 @@ void Transition::SetAttributesTransitions() {
 		length = 10;
 		for (int i = 0; i < h - 1; i++) {
 			end_i = (i < length ? 2 * i + 1 : i <= h - length ? i + length : (i + h) / 2) * w;
-			std::shuffle(random_blocks.begin() + i * w, random_blocks.begin() + end_i, Rand::GetRNG());
+			std::shuffle(random_blocks.begin() + i * w, random_blocks.begin() + end_i, Rand::GetRNG(Rand::Stream::Cosmetic));
 
 			beg_i = i * w + (i % 2 == 0 ? 0 : 2);
 			mid_i = i * w + (i % 2 == 0 ? 1 : 3) + (i > h * 2 / 3 ? 3 : 0);
@@ -153,6 +176,15 @@ void Transition::SetAttributesTransitions() {
 			}
 			else { std::partial_sort(random_blocks.begin() + beg_i, random_blocks.begin() + mid_i, random_blocks.begin() + end_i, std::greater<uint32_t>()); }
 		}
+		CreateBlockMask(DisplayUi->GetWidth(), DisplayUi->GetHeight());
+		break;
+	case TransitionBlindOpen:
+	case TransitionBlindClose:
+	case TransitionVerticalStripesIn:
+	case TransitionVerticalStripesOut:
+	case TransitionHorizontalStripesIn:
+	case TransitionHorizontalStripesOut:
+		CreateLineMask(DisplayUi->GetWidth(), DisplayUi->GetHeight());
 		break;
 	case TransitionZoomIn:
 	case TransitionZoomOut:
@@ -171,14 +203,104 @@ void Transition::SetAttributesTransitions() {
 	}
 }
 
+void Transition::CreateBlockMask(int w, int h) {
+	mask.assign(w * h, 255);
+
+	const int blocks_per_row = w / size_random_blocks;
+	if (blocks_per_row == 0) {
+		return;
+	}
+
+	// The first random_blocks.size() * percentage / 100 blocks are shown
+	const int num_blocks = static_cast<int>(random_blocks.size());
+	int begin = 0;
+	for (int p = 0; p <= 100; ++p) {
+		const int end = num_blocks * p / 100;
+		for (int i = begin; i < end; ++i) {
+			Rect block(random_blocks[i] % blocks_per_row * size_random_blocks,
+				random_blocks[i] / blocks_per_row * size_random_blocks,
+				size_random_blocks, size_random_blocks);
+			block.Adjust(w, h);
+			for (int y = block.y; y < block.y + block.height; ++y) {
+				std::fill_n(mask.begin() + y * w + block.x, block.width, static_cast<uint8_t>(p));
+			}
+		}
+		begin = end;
+	}
+}
+
+void Transition::CreateLineMask(int w, int h) {
+	const bool columns = transition_type == TransitionHorizontalStripesIn || transition_type == TransitionHorizontalStripesOut;
+	const int length = columns ? w : h;
+
+	// Percentage from which a line shows screen2. The lines only switch from
+	// screen1 to screen2, the first percentage covering them is enough.
+	std::vector<uint8_t> thresholds(length, 255);
+	int p = 0;
+	auto show = [&](int begin, int count) {
+		const int end = std::min(begin + count, length);
+		for (int i = std::max(begin, 0); i < end; ++i) {
+			if (thresholds[i] == 255) {
+				thresholds[i] = static_cast<uint8_t>(p);
+			}
+		}
+	};
+
+	for (; p <= 100; ++p) {
+		switch (transition_type) {
+		case TransitionBlindOpen:
+			for (int i = 0; i < h / 8; i++) {
+				show(i * 8 + 8 - 8 * p / 100, 8 * p / 100);
+			}
+			break;
+		case TransitionBlindClose:
+			for (int i = 0; i < h / 8; i++) {
+				show(i * 8, 8 * p / 100);
+			}
+			break;
+		case TransitionVerticalStripesIn:
+		case TransitionVerticalStripesOut:
+			for (int i = 0; i < h / 6 * p / 100; i++) {
+				show(i * 6, 3);
+				show(h - 3 - i * 6, 3);
+			}
+			break;
+		case TransitionHorizontalStripesIn:
+		case TransitionHorizontalStripesOut:
+			for (int i = 0; i < w / 8 * p / 100; i++) {
+				show(i * 8, 4);
+				show(w - 4 - i * 8, 4);
+			}
+			break;
+		default:
+			break;
+		}
+	}
+
+	mask.resize(w * h);
+	for (int y = 0; y < h; ++y) {
+		if (columns) {
+			std::copy(thresholds.begin(), thresholds.end(), mask.begin() + y * w);
+		} else {
+			std::fill_n(mask.begin() + y * w, w, thresholds[y]);
+		}
+	}
+}
+
+Rect Transition::GetDamage(const Rect& screen_rect) {
+	// Graphics::Draw always redraws the whole frame while the transition is visible
+	if (IsActive() || IsErasedNotActive()) {
+		return screen_rect;
+	}
+	return Rect();
+}
+
 void Transition::Draw(Bitmap& dst) {
 	if (!IsActive())
 		return;
 
 	std::vector<int> z_pos(2), z_size(2), z_length(2);
 	int z_min, z_max, z_percent, z_fixed_pos, z_fixed_size;
-	uint8_t m_r, m_g, m_b, m_a;
-	uint32_t *m_pointer, blocks_to_print;
 	int m_size;
 
 	BitmapRef screen_pointer1, screen_pointer2;
@@ -196,57 +318,18 @@ void Transition::Draw(Bitmap& dst) {
 	switch (transition_type) {
 	case TransitionFadeIn:
 	case TransitionFadeOut:
-		dst.Blit(0, 0, *screen1, screen1->GetRect(), 255);
-		dst.Blit(0, 0, *screen2, screen2->GetRect(), 255 * percentage / 100);
+		DrawFade(dst, percentage);
 		break;
 	case TransitionRandomBlocks:
 	case TransitionRandomBlocksDown:
 	case TransitionRandomBlocksUp:
-		blocks_to_print = random_blocks.size() * percentage / 100;
-
-		for (uint32_t i = current_blocks_print; i < blocks_to_print; i++) {
-			random_block_transition->Blit(random_blocks[i] % (w / size_random_blocks) * size_random_blocks,
-				random_blocks[i] / (w / size_random_blocks) * size_random_blocks, *screen2,
-				Rect(random_blocks[i] % (w / size_random_blocks) * size_random_blocks, random_blocks[i] / (w / size_random_blocks) * size_random_blocks,
-					size_random_blocks, size_random_blocks), Opacity::Opaque());
-		}
-		dst.Blit(0, 0, *screen1, screen1->GetRect(), Opacity::Opaque());
-		dst.Blit(0, 0, *random_block_transition, random_block_transition->GetRect(), Opacity::Opaque());
-		current_blocks_print = blocks_to_print;
-		break;
 	case TransitionBlindOpen:
-		for (int i = 0; i < h / 8; i++) {
-			dst.Blit(0, i * 8, *screen1, Rect(0, i * 8, w, 8 - 8 * percentage / 100), 255);
-			dst.Blit(0, i * 8 + 8 - 8 * percentage / 100, *screen2, Rect(0, i * 8 + 8 - 8 * percentage / 100, w, 8 * percentage / 100), 255);
-		}
-		break;
 	case TransitionBlindClose:
-		for (int i = 0; i < h / 8; i++) {
-			dst.Blit(0, i * 8 + 8 * percentage / 100, *screen1, Rect(0, i * 8 + 8 * percentage / 100, w, 8 - 8 * percentage / 100), 255);
-			dst.Blit(0, i * 8, *screen2, Rect(0, i * 8, w, 8 * percentage / 100), 255);
-		}
-		break;
 	case TransitionVerticalStripesIn:
 	case TransitionVerticalStripesOut:
-		for (int i = 0; i < h / 6 + 1 - h / 6 * percentage / 100; i++) {
-			dst.Blit(0, i * 6 + 3, *screen1, Rect(0, i * 6 + 3, w, 3), 255);
-			dst.Blit(0, h - i * 6, *screen1, Rect(0, h - i * 6, w, 3), 255);
-		}
-		for (int i = 0; i < h / 6 * percentage / 100; i++) {
-			dst.Blit(0, i * 6, *screen2, Rect(0, i * 6, w, 3), 255);
-			dst.Blit(0, h - 3 - i * 6, *screen2, Rect(0, h - 3 - i * 6, w, 3), 255);
-		}
-		break;
 	case TransitionHorizontalStripesIn:
 	case TransitionHorizontalStripesOut:
-		for (int i = 0; i < w / 8 + 1 - w / 8 * percentage / 100; i++) {
-			dst.Blit(i * 8 + 4, 0, *screen1, Rect(i * 8 + 4, 0, 4, h), 255);
-			dst.Blit(w - i * 8, 0, *screen1, Rect(w - i * 8, 0, 4, h), 255);
-		}
-		for (int i = 0; i < w / 8 * percentage / 100; i++) {
-			dst.Blit(i * 8, 0, *screen2, Rect(i * 8, 0, 4, h), 255);
-			dst.Blit(w - 4 - i * 8, 0, *screen2, Rect(w - 4 - i * 8, 0, 4, h), 255);
-		}
+		DrawMasked(dst, percentage);
 		break;
 	case TransitionBorderToCenterIn:
 	case TransitionBorderToCenterOut:
@@ -352,14 +435,8 @@ void Transition::Draw(Bitmap& dst) {
 		screen_pointer1 = transition_type == TransitionMosaicIn ? screen2 : screen1;
 
 		m_size = (percentage + 1) * 4 / 10;
-		if (m_size > 1)
-			for (int i = 0; i < w; i += m_size)
-				for (int j = 0; j < h; j += m_size) {
-					m_pointer = static_cast<uint32_t *>(screen_pointer1->pixels()) + j * w + i;
-					m_pointer += ((i == 0 ? 1 : 0) + (j == 0 ? w : 0)) * (m_size - 1);
-					dst.pixel_format.uint32_to_rgba(*m_pointer, m_r, m_g, m_b, m_a);
-					dst.FillRect(Rect(i - ((m_size - w % m_size) % m_size) / 2, j - ((m_size - h % m_size) % m_size) / 2, m_size, m_size), Color(m_r, m_g, m_b, m_a));
-				}
+		if (m_size > 1 && screen_pointer1->GetRect() == dst.GetRect())
+			DrawMosaic(dst, *screen_pointer1, m_size);
 		else
 			dst.Blit(0, 0, *screen_pointer1, screen_pointer1->GetRect(), 255);
 		break;
@@ -385,6 +462,94 @@ void Transition::Draw(Bitmap& dst) {
 	}
 }
 
+void Transition::DrawFade(Bitmap& dst, int percentage) {
+	if (screen1->GetRect() != dst.GetRect() || screen2->GetRect() != dst.GetRect()) {
+		dst.Blit(0, 0, *screen1, screen1->GetRect(), 255);
+		dst.Blit(0, 0, *screen2, screen2->GetRect(), 255 * percentage / 100);
+		return;
+	}
+
+	const Bitmap& src1 = *screen1;
+	const Bitmap& src2 = *screen2;
+	const int pitch1 = GetReadPitch(src1);
+	const int pitch2 = GetReadPitch(src2);
+	auto* pixels = dst.pixels();
+	for (int y = 0; y < dst.GetHeight(); ++y) {
+		BitmapSimd::BlendRow(GetRow(pixels, dst.pitch(), y), GetRow(src1.pixels(), pitch1, y),
+			GetRow(src2.pixels(), pitch2, y), dst.GetWidth(), 255 * percentage / 100);
+	}
+}
+
+void Transition::DrawMasked(Bitmap& dst, int percentage) {
+	const int w = dst.GetWidth();
+	const int h = dst.GetHeight();
+	if (mask.size() != static_cast<size_t>(w * h) || screen1->GetRect() != dst.GetRect() || screen2->GetRect() != dst.GetRect()) {
+		// The screen size changed after Init
+		dst.Blit(0, 0, *screen1, screen1->GetRect(), Opacity::Opaque());
+		return;
+	}
+
+	const Bitmap& src1 = *screen1;
+	const Bitmap& src2 = *screen2;
+	const int pitch1 = GetReadPitch(src1);
+	const int pitch2 = GetReadPitch(src2);
+	auto* pixels = dst.pixels();
+	for (int y = 0; y < h; ++y) {
+		BitmapSimd::SelectRow(GetRow(pixels, dst.pitch(), y), GetRow(src1.pixels(), pitch1, y),
+			GetRow(src2.pixels(), pitch2, y), &mask[y * w], percentage, w);
+	}
+}
+
+void Transition::DrawMosaic(Bitmap& dst, const Bitmap& screen, int size) {
+	const int w = dst.GetWidth();
+	const int h = dst.GetHeight();
+	// The blocks are shifted to center the grid, the color is taken from a pixel
+	// inside the visible part of the block.
+	const int offset_x = ((size - w % size) % size) / 2;
+	const int offset_y = ((size - h % size) % size) / 2;
+
+	auto* pixels = dst.pixels();
+	for (int j = 0; j < h; j += size) {
+		const uint32_t* src_row = GetRow(screen.pixels(), screen.pitch(), j + (j == 0 ? size - 1 : 0));
+		const int y_end = std::min(j - offset_y + size, h);
+
+		for (int y = std::max(j - offset_y, 0); y < y_end; ++y) {
+			uint32_t* dst_row = GetRow(pixels, dst.pitch(), y);
+			for (int i = 0; i < w; i += size) {
+				const int x_begin = std::max(i - offset_x, 0);
+				const int x_end = std::min(i - offset_x + size, w);
+				std::fill(dst_row + x_begin, dst_row + x_end, src_row[i + (i == 0 ? size - 1 : 0)]);
+			}
+		}
+	}
+}
+
+BitmapRef Transition::GetBlackScreen() {
+	const int w = DisplayUi->GetWidth();
+	const int h = DisplayUi->GetHeight();
+	if (!black_screen || black_screen->GetWidth() != w || black_screen->GetHeight() != h) {
+		black_screen = Bitmap::Create(w, h, Color(0, 0, 0, 255));
+	}
+	return black_screen;
+}
+
+BitmapRef Transition::DrawSnapshot() {
+	const int w = DisplayUi->GetWidth();
+	const int h = DisplayUi->GetHeight();
+	// Reused by the next transition unless somebody else still holds it
+	if (!snapshot || snapshot.use_count() > 1 || snapshot->GetWidth() != w || snapshot->GetHeight() != h) {
+		snapshot = Bitmap::Create(w, h, false);
+	}
+	Graphics::LocalDraw(*snapshot, std::numeric_limits<int>::min(), GetZ() - 1);
+	SetAlphaOpaque(*snapshot);
+	return snapshot;
+}
+
+int Transition::GetReadPitch(const Bitmap& screen) const {
+	// All rows of the black screen are equal, reading the first one keeps it in cache
+	return &screen == black_screen.get() ? 0 : screen.pitch();
+}
+
 void Transition::Update() {
 	if (!IsActive()) {
 		return;
@@ -405,15 +570,11 @@ void Transition::Update() {
 			// erase -> erase is ingored
 			// any -> erase - screen1 was drawn in init.
 			assert(ToErase() && !FromErase());
-			screen1 =  Bitmap::Create(DisplayUi->GetWidth(), DisplayUi->GetHeight(), false);
-			Graphics::LocalDraw(*screen1, std::numeric_limits<int>::min(), GetZ() - 1);
-		}
-		if (ToErase()) {
-			screen2 = Bitmap::Create(DisplayUi->GetWidth(), DisplayUi->GetHeight(), Color(0, 0, 0, 255));
-		} else {
-			screen2 =  Bitmap::Create(DisplayUi->GetWidth(), DisplayUi->GetHeight(), false);
-			Graphics::LocalDraw(*screen2, std::numeric_limits<int>::min(), GetZ() - 1);
+			screen1 = DrawSnapshot();
+		} else if (screen1 != black_screen) {
+			SetAlphaOpaque(*screen1);
 		}
+		screen2 = ToErase() ? GetBlackScreen() : DrawSnapshot();
 	}
 
 	SetVisible(true);
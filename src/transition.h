@@ -107,6 +107,7 @@ public:
 	void PrependFlashes(int r, int g, int b, int power, int duration, int iterations);
 
 	void Draw(Bitmap& dst) override;
+	Rect GetDamage(const Rect& screen_rect) override;
 	void Update();
 
 	bool IsActive() const;
@@ -123,7 +124,10 @@ private:
 
 	BitmapRef screen1;
 	BitmapRef screen2;
-	BitmapRef random_block_transition;
+	/** Snapshot of the scene of the last transition, reused by the next one */
+	BitmapRef snapshot;
+	/** Black screen of erase transitions, never modified */
+	BitmapRef black_screen;
 
 	Type transition_type = TransitionNone;
 	Scene *scene = nullptr;
@@ -147,9 +151,22 @@ private:
 
 	std::vector<int> zoom_position;
 	std::vector<uint32_t> random_blocks;
-	uint32_t current_blocks_print;
+	/** Per pixel percentage from which screen2 is shown, for the block, blind and stripe types */
+	std::vector<uint8_t> mask;
 
 	void SetAttributesTransitions();
+	void CreateBlockMask(int w, int h);
+	void CreateLineMask(int w, int h);
+	void DrawMasked(Bitmap& dst, int percentage);
+	void DrawFade(Bitmap& dst, int percentage);
+	void DrawMosaic(Bitmap& dst, const Bitmap& screen, int size);
+
+	/** @return the black screen in the current screen size */
+	BitmapRef GetBlackScreen();
+	/** @return the retained snapshot with the drawables below the transition drawn on it */
+	BitmapRef DrawSnapshot();
+	/** @return pitch for reading the rows of screen, 0 for the black screen */
+	int GetReadPitch(const Bitmap& screen) const;
 };
 
 inline Transition& Transition::instance() {
@@ -20,11 +20,14 @@
 // Headers
 #include <fstream>
 #include <iomanip>
+#include <iterator>
 #include <lcf/data.h>
 #include <lcf/rpg/terms.h>
 #include <lcf/rpg/map.h>
 #include "lcf/rpg/mapinfo.h"
+#include <lcf/reader_util.h>
 
+#include "asset_cache.h"
 #include "cache.h"
 #include "main_data.h"
 #include "game_actors.h"
@@ -138,13 +141,11 @@ void Translation::SelectLanguage(const std::string& lang_id)
 	// We reload the entire database as a precaution.
 	Player::LoadDatabase();
 
-	// Rewrite our database+messages (unless we are on the Default language).
-	// Note that map Message boxes are changed on map load, to avoid slowdown here.	
+	// Rewrite our database (unless we are on the Default language).
+	// Note that Message boxes of maps, common events and troops are changed on first use, to avoid slowdown here.
 	if (!current_language.empty()) {
 		RewriteDatabase();
 		RewriteTreemapNames();
-		RewriteBattleEventMessages();
-		RewriteCommonEventMessages();
 	}
 
 	// Reset the cache, so that all images load fresh.
@@ -243,27 +244,40 @@ void Translation::RewriteTreemapNames()
 	}
 }
 
-void Translation::RewriteBattleEventMessages()
+void Translation::RewriteBattleEventMessages(int troop_id)
 {
+	auto* troop = lcf::ReaderUtil::GetElement(lcf::Data::troops, troop_id);
+	if (!battle || !troop) {
+		return;
+	}
+
+	troops_rewritten.resize(lcf::Data::troops.size());
+	if (troops_rewritten[troop_id - 1]) {
+		return;
+	}
+	troops_rewritten[troop_id - 1] = true;
+
 	// Rewrite all event commands on all pages.
-	if (battle) {
-		for (lcf::rpg::Troop& troop : lcf::Data::troops) {
-			for (lcf::rpg::TroopPage& page : troop.pages) {
-				RewriteEventCommandMessage(*battle, page.event_commands);
-			}
-		}
+	for (lcf::rpg::TroopPage& page : troop->pages) {
+		RewriteEventCommandMessage(*battle, page.event_commands);
 	}
 }
 
 
-void Translation::RewriteCommonEventMessages()
+void Translation::RewriteCommonEventMessages(int common_event_id)
 {
-	// Rewrite all event commands on all pages.
-	if (common) {
-		for (lcf::rpg::CommonEvent& ev : lcf::Data::commonevents) {
-			RewriteEventCommandMessage(*common, ev.event_commands);
-		}
+	auto* ce = lcf::ReaderUtil::GetElement(lcf::Data::commonevents, common_event_id);
+	if (!common || !ce) {
+		return;
+	}
+
+	common_events_rewritten.resize(lcf::Data::commonevents.size());
+	if (common_events_rewritten[common_event_id - 1]) {
+		return;
 	}
+	common_events_rewritten[common_event_id - 1] = true;
+
+	RewriteEventCommandMessage(*common, ce->event_commands);
 }
 
 
@@ -621,11 +635,18 @@ void Translation::RewriteMapMessages(const std::string& map_name, lcf::rpg::Map&
 
 void Translation::ParsePoFile(const std::string& path, Dictionary& out)
 {
+	std::vector<uint8_t> catalog;
+	if (AssetCache::LoadTranslation(path, catalog) && Dictionary::FromCatalog(out, std::move(catalog))) {
+		return;
+	}
+
 	std::ifstream in(path.c_str());
 	if (in.good()) {
 		if (!Dictionary::FromPo(out, in)) {
 			Output::Warning("Failure parsing PO file, resetting: '{}'", path);
 			out = Dictionary(); 
+		} else {
+			AssetCache::StoreTranslation(path, out.GetCatalog());
 		}
 	}
 }
@@ -638,6 +659,8 @@ void Translation::ClearTranslationLookups()
 	battle.reset();
 	mapnames.reset();
 	maps.clear();
+	common_events_rewritten.clear();
+	troops_rewritten.clear();
 }
 
 
@@ -651,10 +674,15 @@ void Dictionary::addEntry(const Entry& entry)
 {
 	// Space-saving measure: If the translation string is empty, there's no need to save it (since we will just show the original).
 	if (!entry.translation.empty()) {
-		entries[entry.context][entry.original] = entry.translation;
+		parsed[entry.context + '\x04' + entry.original] = entry.translation;
 	}
 }
 
+bool Dictionary::FromCatalog(Dictionary& res, std::vector<uint8_t> data)
+{
+	return res.catalog.Load(std::move(data));
+}
+
 // Returns success
 bool Dictionary::FromPo(Dictionary& res, std::istream& in)
 {
@@ -765,6 +793,12 @@ bool Dictionary::FromPo(Dictionary& res, std::istream& in)
 			}
 		}
 	}
+
+	std::vector<std::pair<std::string, std::string>> entries(
+		std::make_move_iterator(res.parsed.begin()), std::make_move_iterator(res.parsed.end()));
+	res.parsed.clear();
+	res.catalog.Load(RequestIndex::Build(std::move(entries)));
+
 	return !error;
 }
 
@@ -23,8 +23,10 @@
 #include <sstream>
 #include <memory>
 #include <unordered_map>
+#include <vector>
 
 #include "filefinder.h"
+#include "request_index.h"
 
 namespace lcf {
 	namespace rpg {
@@ -71,6 +73,9 @@ public:
 
 /**
  * A .po file loaded into memory. Contains a dictionary of entries.
+ *
+ * The entries are compiled into a catalog in the RequestIndex format, the key
+ * of an entry is msgctxt, the EOT character (like gettext) and msgid.
  */
 class Dictionary {
 public:
@@ -85,6 +90,18 @@ public:
 	 */
 	static bool FromPo(Dictionary& res, std::istream& in);
 
+	/**
+	 * Loads a compiled catalog.
+	 *
+	 * @param res The dictionary to store the catalog in.
+	 * @param data The catalog as returned by GetCatalog.
+	 * @return True if the catalog is valid; false otherwise.
+	 */
+	static bool FromCatalog(Dictionary& res, std::vector<uint8_t> data);
+
+	/** @return The compiled catalog, empty if nothing was loaded. */
+	const std::vector<uint8_t>& GetCatalog() const;
+
 	/**
 	 * Replace an original string with the translated string.
 	 * Template can be "std::string" or "lcf::DBString"
@@ -105,26 +122,28 @@ private:
 	 */
 	void addEntry(const Entry& entry);
 
+	// Entries added by FromPo by catalog key, moved into the catalog when parsing finished.
+	std::unordered_map<std::string, std::string> parsed;
+
 	// Lookup by context, where context can be empty ("") for no context.
-	std::unordered_map<std::string, std::unordered_map<std::string, std::string>> entries;
+	RequestIndex catalog;
 };
 
+inline const std::vector<uint8_t>& Dictionary::GetCatalog() const {
+	return catalog.GetData();
+}
+
 
 // Template implementation
 template <class StringType>
 bool Dictionary::TranslateString(const std::string& context, StringType& original) const
 {
-	std::stringstream key;
-	key <<original;
-	auto it = entries.find(context);
-	if (it != entries.end()) {
-		auto it2 = it->second.find(key.str());
-		if (it2 != it->second.end()) {
-			original = StringType(it2->second);
-			return true;
-		}
+	StringView translation = catalog.Find({ context, "\x04", StringView(original) });
+	if (translation.empty()) {
+		return false;
 	}
-	return false;
+	original = StringType(ToString(translation));
+	return true;
 }
 
 
@@ -185,6 +204,22 @@ public:
 	 */
 	void RewriteMapMessages(const std::string& map_name, lcf::rpg::Map& map);
 
+	/**
+	 * Rewrite all Messages and Choices of a Common Event.
+	 * Done once per language, when the Common Event is executed the first time.
+	 *
+	 * @param common_event_id ID of the Common Event
+	 */
+	void RewriteCommonEventMessages(int common_event_id);
+
+	/**
+	 * Rewrite all Battle Messages and Choices of a Troop.
+	 * Done once per language, when a battle against the Troop starts.
+	 *
+	 * @param troop_id ID of the Troop
+	 */
+	void RewriteBattleEventMessages(int troop_id);
+
 	/**
 	 * Retrieve the ID of the current (active) language.
 	 *
@@ -230,16 +265,6 @@ private:
 	 */
 	void RewriteTreemapNames();
 
-	/**
-	 * Rewrite all Battle Messages with the current translation entries
-	 */
-	void RewriteBattleEventMessages();
-
-	/**
-	 * Rewrite all Common Event Messages with the current translation entries
-	 */
-	void RewriteCommonEventMessages();
-
 	/**
 	 * Convert a stream of msgbox or choices to a list of output message boxes
 	 * 
@@ -270,6 +295,10 @@ private:
 	std::unique_ptr<Dictionary> mapnames;  // RPG_RT.lmt.po (map names, used only in the "Teleport" event command)
 	std::unordered_map<std::string, std::unique_ptr<Dictionary>> maps;  // map<id>.po, indexed by map name
 
+	// Common Events and Troops rewritten since the database was loaded, indexed by ID - 1
+	std::vector<bool> common_events_rewritten;
+	std::vector<bool> troops_rewritten;
+
 	// Our list of available Languages (translations, localizations), determined by scanning the files on disk.
 	std::vector<Language> languages;
 
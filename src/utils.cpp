@@ -26,7 +26,20 @@
 #include <algorithm>
 #include <random>
 #include <cctype>
+#include <cstring>
 #include <zlib.h>
+#include "cpu_features.h"
+#include "filesystem_stream.h"
+
+#ifdef EP_CPU_COMPILE_SSE2
+#  include <emmintrin.h>
+#endif
+#ifdef EP_CPU_COMPILE_NEON
+#  include <arm_neon.h>
+#endif
+#ifdef __ARM_FEATURE_CRC32
+#  include <arm_acle.h>
+#endif
 
 namespace {
 	char Lower(char c) {
@@ -95,10 +108,26 @@ int Utils::StrICmp(StringView l, StringView r) {
 
 std::u16string Utils::DecodeUTF16(StringView str) {
 	std::u16string result;
-	for (auto it = str.begin(), str_end = str.end(); it < str_end; ++it) {
+	DecodeUTF16(str, result);
+	return result;
+}
+
+void Utils::DecodeUTF16(StringView str, std::u16string& result) {
+	result.clear();
+	// Never more characters than bytes
+	result.reserve(str.size());
+	for (const char* it = str.data(), *str_end = str.data() + str.size(); it < str_end; ++it) {
 		uint8_t c1 = *it;
 		if (c1 < 0x80) {
-			result.push_back(static_cast<uint16_t>(c1));
+			// Copy the whole ASCII run
+			const char* run_end = UTF8SkipAscii(it, str_end);
+			const size_t pos = result.size();
+			result.resize(pos + (run_end - it));
+			for (size_t i = pos; it != run_end; ++it, ++i) {
+				result[i] = static_cast<uint8_t>(*it);
+			}
+			// Points to the last ASCII character for the loop increment
+			--it;
 		}
 		else if (c1 < 0xC2) {
 			continue;
@@ -165,15 +194,30 @@ std::u16string Utils::DecodeUTF16(StringView str) {
 				  |  (c4 & 0x3F)));
 		}
 	}
-	return result;
 }
 
 std::u32string Utils::DecodeUTF32(StringView str) {
 	std::u32string result;
-	for (auto it = str.begin(), str_end = str.end(); it < str_end; ++it) {
+	DecodeUTF32(str, result);
+	return result;
+}
+
+void Utils::DecodeUTF32(StringView str, std::u32string& result) {
+	result.clear();
+	// Never more characters than bytes
+	result.reserve(str.size());
+	for (const char* it = str.data(), *str_end = str.data() + str.size(); it < str_end; ++it) {
 		uint8_t c1 = *it;
 		if (c1 < 0x80) {
-			result.push_back(static_cast<uint32_t>(c1));
+			// Copy the whole ASCII run
+			const char* run_end = UTF8SkipAscii(it, str_end);
+			const size_t pos = result.size();
+			result.resize(pos + (run_end - it));
+			for (size_t i = pos; it != run_end; ++it, ++i) {
+				result[i] = static_cast<uint8_t>(*it);
+			}
+			// Points to the last ASCII character for the loop increment
+			--it;
 		}
 		else if (c1 < 0xC2) {
 			continue;
@@ -232,7 +276,6 @@ std::u32string Utils::DecodeUTF32(StringView str) {
 												 |  (c4 & 0x3F)));
 		}
 	}
-	return result;
 }
 
 std::string Utils::EncodeUTF(const std::u16string& str) {
@@ -305,7 +348,7 @@ std::string Utils::EncodeUTF(const std::u32string& str) {
 	return result;
 }
 
-Utils::UtfNextResult Utils::UTF8Next(const char* iter, const char* const end) {
+Utils::UtfNextResult Utils::UTF8NextMultibyte(const char* iter, const char* const end) {
 	while (iter != end) {
 		uint8_t c1 = *iter;
 		++iter;
@@ -377,6 +420,40 @@ Utils::UtfNextResult Utils::UTF8Next(const char* iter, const char* const end) {
 	return { iter, 0 };
 }
 
+const char* Utils::UTF8SkipAscii(const char* iter, const char* const end) {
+#ifdef EP_CPU_COMPILE_SSE2
+	if (CpuFeatures::HasSSE2()) {
+		for (; end - iter >= 16; iter += 16) {
+			const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(iter));
+			if (_mm_movemask_epi8(v) != 0) {
+				break;
+			}
+		}
+	}
+#endif
+#if defined(EP_CPU_COMPILE_NEON) && defined(__aarch64__)
+	if (CpuFeatures::HasNEON()) {
+		for (; end - iter >= 16; iter += 16) {
+			if (vmaxvq_u8(vld1q_u8(reinterpret_cast<const uint8_t*>(iter))) >= 0x80) {
+				break;
+			}
+		}
+	}
+#endif
+	// The wide loops stop at the block with the first non-ASCII byte
+	for (; end - iter >= 8; iter += 8) {
+		uint64_t word;
+		std::memcpy(&word, iter, sizeof(word));
+		if ((word & UINT64_C(0x8080808080808080)) != 0) {
+			break;
+		}
+	}
+	while (iter != end && static_cast<uint8_t>(*iter) < 0x80) {
+		++iter;
+	}
+	return iter;
+}
+
 Utils::ExFontRet Utils::ExFontNext(const char* iter, const char* end) {
 	ExFontRet ret;
 	if (end - iter >= 2 && *iter == '$') {
@@ -574,15 +651,56 @@ std::vector<uint8_t> Utils::ReadStream(std::istream& stream) {
 }
 
 uint32_t Utils::CRC32(std::istream& stream) {
-	uLong crc = crc32(0L, Z_NULL, 0);
+	uint32_t crc = 0;
 	std::array<uint8_t, 8192> buffer = {};
 	do {
 		stream.read(reinterpret_cast<char*>(buffer.data()), buffer.size());
-		crc = crc32(crc, buffer.data(), stream.gcount());
+		crc = CRC32(Span<const uint8_t>(buffer.data(), stream.gcount()), crc);
 	} while (stream.gcount() == static_cast<std::streamsize>(buffer.size()));
 	return crc;
 }
 
+uint32_t Utils::CRC32(Filesystem_Stream::InputStream& stream) {
+	auto data = stream.GetSpan();
+	if (data.size() == 0) {
+		return CRC32(static_cast<std::istream&>(stream));
+	}
+
+	auto crc = CRC32(data);
+	stream.seekg(0, std::ios_base::end);
+	return crc;
+}
+
+uint32_t Utils::CRC32(Span<const uint8_t> data, uint32_t crc) {
+	const uint8_t* iter = data.data();
+	size_t size = data.size();
+
+#ifdef __ARM_FEATURE_CRC32
+	// ARMv8 has instructions for the zlib polynomial
+	// x86 only has SSE4.2 instructions for CRC32C and zlib handles it
+	crc = ~crc;
+	for (; size >= 8; iter += 8, size -= 8) {
+		uint64_t word;
+		std::memcpy(&word, iter, sizeof(word));
+		crc = __crc32d(crc, word);
+	}
+	for (; size > 0; ++iter, --size) {
+		crc = __crc32b(crc, *iter);
+	}
+	return ~crc;
+#else
+	// zlib takes 32 bit sizes
+	constexpr size_t max_chunk = 1u << 30;
+	while (size > 0) {
+		const auto chunk = std::min<size_t>(size, max_chunk);
+		crc = crc32(crc, iter, static_cast<uInt>(chunk));
+		iter += chunk;
+		size -= chunk;
+	}
+	return crc;
+#endif
+}
+
 std::string Utils::ReplacePlaceholders(StringView text_template, Span<const char> types, Span<const StringView> values) {
 	auto str = std::string(text_template);
 	size_t index = str.find("%");
@@ -27,6 +27,10 @@
 #include "string_view.h"
 #include "span.h"
 
+namespace Filesystem_Stream {
+	class InputStream;
+}
+
 namespace Utils {
 	/**
 	 * Converts a string to lower case (ASCII only)
@@ -88,6 +92,14 @@ namespace Utils {
 	 */
 	std::u16string DecodeUTF16(StringView str);
 
+	/**
+	 * Converts UTF-8 to UTF-16 into a buffer that is reused between calls.
+	 *
+	 * @param str string to convert.
+	 * @param out receives the converted string, replacing the previous content.
+	 */
+	void DecodeUTF16(StringView str, std::u16string& out);
+
 	/**
 	 * Converts UTF-8 to UTF-32.
 	 *
@@ -96,6 +108,14 @@ namespace Utils {
 	 */
 	std::u32string DecodeUTF32(StringView str);
 
+	/**
+	 * Converts UTF-8 to UTF-32 into a buffer that is reused between calls.
+	 *
+	 * @param str string to convert.
+	 * @param out receives the converted string, replacing the previous content.
+	 */
+	void DecodeUTF32(StringView str, std::u32string& out);
+
 	/**
 	 * Converts UTF-16 to UTF-8.
 	 *
@@ -127,6 +147,24 @@ namespace Utils {
 	 */
 	UtfNextResult UTF8Next(const char* iter, const char* end);
 
+	/**
+	 * Called by UTF8Next when the next character is not ASCII.
+	 *
+	 * @param iter begginning of the range to convert from
+	 * @param end end of the range to convert from
+	 * @return the converted string.
+	 */
+	UtfNextResult UTF8NextMultibyte(const char* iter, const char* end);
+
+	/**
+	 * Skips ASCII characters, checks 16 bytes at a time when SIMD is available.
+	 *
+	 * @param iter begginning of the range
+	 * @param end end of the range
+	 * @return pointer to the first byte that is not ASCII, or end
+	 */
+	const char* UTF8SkipAscii(const char* iter, const char* end);
+
 #if !defined(__amigaos4__) && !defined(__AROS__)
 	/**
 	 * Converts UTF-8 string to std::wstring.
@@ -282,6 +320,25 @@ namespace Utils {
 	 */
 	uint32_t CRC32(std::istream& stream);
 
+	/**
+	 * Calculates the CRC32 of the stream content.
+	 * Streams held in memory, like mapped files, are not copied.
+	 * The stream is read to the end.
+	 *
+	 * @param stream Stream to calculate crc32 from
+	 * @return crc32
+	 */
+	uint32_t CRC32(Filesystem_Stream::InputStream& stream);
+
+	/**
+	 * Calculates the CRC32 of data, or continues the calculation of earlier data.
+	 *
+	 * @param data data to calculate crc32 from
+	 * @param crc crc32 of the earlier data
+	 * @return crc32
+	 */
+	uint32_t CRC32(Span<const uint8_t> data, uint32_t crc = 0);
+
 	/**
 	 * Replaces placeholders (like %S, %O, %V, %U) in strings.
 	 *
@@ -383,6 +440,14 @@ inline void Utils::ForEachLine(StringView line, F&& f) {
 	} while(next < line.size());
 }
 
+inline Utils::UtfNextResult Utils::UTF8Next(const char* iter, const char* end) {
+	// Most game text is ASCII
+	if (iter != end && static_cast<uint8_t>(*iter) < 0x80) {
+		return { iter + 1, static_cast<uint8_t>(*iter) };
+	}
+	return UTF8NextMultibyte(iter, end);
+}
+
 template <typename T>
 inline bool Utils::IsControlCharacter(T ch) {
 	return (ch >= 0x0 && ch <= 0x1F) || ch == 0x7F;
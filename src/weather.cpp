@@ -207,17 +207,24 @@ void Weather::DrawParticles(Bitmap& dst, const Bitmap& particle, const Rect rect
 	auto surface_rect = weather_surface->GetRect();
 	weather_surface->Clear();
 
-	assert(num_particles <= static_cast<int>(particles.size()));
+	assert(num_particles <= particles.size());
+
+	particle_pixels.clear();
+	CollectParticlePixels(*bitmap, rect);
+
+	// FIXME: This only works for 32bit pixel formats
+	auto* pixels = static_cast<uint32_t*>(weather_surface->pixels());
+	const int pitch = weather_surface->pitch() / sizeof(uint32_t);
 
 	for (int i = 0; i < num_particles; ++i) {
-		auto& p = particles[i];
-		if (p.t > tmax) {
+		const auto t = particles.t[i];
+		if (t > tmax) {
 			continue;
 		}
 
-		auto alpha = std::min(ainc * p.t, 255);
+		auto alpha = std::min(ainc * t, 255);
 
-		weather_surface->EdgeMirrorBlit(p.x, p.y, *bitmap, rect, true, true, alpha);
+		BlendParticle(pixels, pitch, surface_rect, particles.x[i], particles.y[i], alpha, 0, particle_pixels.size(), rect, true);
 	}
 
 	const auto shake_x = Main_Data::game_screen->GetShakeOffsetX();
@@ -226,6 +233,72 @@ void Weather::DrawParticles(Bitmap& dst, const Bitmap& particle, const Rect rect
 	dst.TiledBlit(-pan_rect.x + shake_x, -pan_rect.y + shake_y, surface_rect, *weather_surface, dst.GetRect(), Opacity::Opaque());
 }
 
+void Weather::CollectParticlePixels(const Bitmap& bitmap, Rect rect) {
+	const auto alpha_mask = Bitmap::pixel_format.a.mask;
+	const auto* pixels = static_cast<const uint8_t*>(bitmap.pixels());
+
+	for (int y = 0; y < rect.height; ++y) {
+		const auto* row = reinterpret_cast<const uint32_t*>(pixels + (rect.y + y) * bitmap.pitch()) + rect.x;
+		for (int x = 0; x < rect.width; ++x) {
+			if ((row[x] & alpha_mask) != 0) {
+				particle_pixels.push_back({ x, y, row[x] });
+			}
+		}
+	}
+}
+
+// Scales all channels of a pixel by factor / 256, two channels per multiplication
+static inline uint32_t ScalePixel(uint32_t pixel, uint32_t factor) {
+	const uint32_t rb = (((pixel & 0x00FF00FF) * factor) >> 8) & 0x00FF00FF;
+	const uint32_t ag = (((pixel >> 8) & 0x00FF00FF) * factor) & 0xFF00FF00;
+	return rb | ag;
+}
+
+void Weather::BlendParticle(uint32_t* pixels, int pitch, Rect dst_rect, int x, int y, int opacity, size_t first, size_t last, Rect src_rect, bool mirror) const {
+	if (opacity <= 0) {
+		return;
+	}
+	opacity = std::min(opacity, 255);
+
+	// Premultiplied alpha: dst = src * opacity + dst * (1 - src_alpha * opacity)
+	const uint32_t factor = opacity + (opacity >> 7);
+	const int alpha_shift = Bitmap::pixel_format.a.shift;
+
+	auto draw = [&](int x, int y) {
+		for (size_t i = first; i < last; ++i) {
+			const auto& p = particle_pixels[i];
+			const int px = x + p.x;
+			const int py = y + p.y;
+			if (px < 0 || py < 0 || px >= dst_rect.width || py >= dst_rect.height) {
+				continue;
+			}
+
+			const uint32_t src = ScalePixel(p.color, factor);
+			const uint32_t src_alpha = (src >> alpha_shift) & 0xFF;
+			uint32_t& dst = pixels[py * pitch + px];
+			dst = src + ScalePixel(dst, 256 - (src_alpha + (src_alpha >> 7)));
+		}
+	};
+
+	draw(x, y);
+
+	// Same as Bitmap::EdgeMirrorBlit
+	const bool clone_x = (mirror && x + src_rect.width > dst_rect.width);
+	const bool clone_y = (mirror && y + src_rect.height > dst_rect.height);
+
+	if (clone_x) {
+		draw(x - dst_rect.width, y);
+	}
+
+	if (clone_y) {
+		draw(x, y - dst_rect.height);
+	}
+
+	if (clone_x && clone_y) {
+		draw(x - dst_rect.width, y - dst_rect.height);
+	}
+}
+
 void Weather::DrawFog(Bitmap& dst) {
 	if (!fog_bitmap) {
 		CreateFogOverlay();
@@ -274,20 +347,33 @@ void Weather::DrawSandParticles(Bitmap& dst, const Bitmap& particle_bitmap) {
 
 	const int num_particles = num_sand_particles[Utils::Clamp(strength, 0, num_strength - 1)];
 
-	assert(num_particles <= static_cast<int>(particles.size()));
-
-	for (int i = 0; i < num_particles; ++i) {
-		auto& p = particles[i];
-		const int color = (i % num_sand_colors);
+	assert(num_particles <= particles.size());
 
+	// Pixels of each color are collected one after another
+	std::array<size_t, num_sand_colors + 1> color_pixels;
+	particle_pixels.clear();
+	for (int color = 0; color < num_sand_colors; ++color) {
+		color_pixels[color] = particle_pixels.size();
 		auto rect = Rect{
 			0,
 			color * sand_particle_rect.height,
 			sand_particle_rect.width,
 			sand_particle_rect.height
 		};
+		CollectParticlePixels(*bitmap, rect);
+	}
+	color_pixels[num_sand_colors] = particle_pixels.size();
+
+	// FIXME: This only works for 32bit pixel formats
+	auto* pixels = static_cast<uint32_t*>(dst.pixels());
+	const int pitch = dst.pitch() / sizeof(uint32_t);
+	const auto dst_rect = dst.GetRect();
+
+	for (int i = 0; i < num_particles; ++i) {
+		const int color = (i % num_sand_colors);
 
-		dst.Blit(p.x, p.y, *bitmap, rect, p.alpha);
+		BlendParticle(pixels, pitch, dst_rect, particles.x[i], particles.y[i], particles.alpha[i],
+			color_pixels[color], color_pixels[color + 1], sand_particle_rect, false);
 	}
 }
 
@@ -312,7 +398,7 @@ void Weather::CreateFogOverlay() {
 	auto* sand_img = reinterpret_cast<uint32_t*>(sand_bitmap->pixels());
 
 	for (int i = 0; i < w * h; ++i) {
-		int px = Rand::GetRandomNumber(0, num_overlay_colors - 1);
+		int px = Rand::GetCosmeticNumber(0, num_overlay_colors - 1);
 		// FIXME: This only works for 32bit pixel formats
 		fog_img[i] = fog_pixels[px];
 		sand_img[i] = sand_pixels[px];
@@ -335,8 +421,8 @@ void Weather::DrawFogOverlay(Bitmap& dst, const Bitmap& overlay) {
 	// RPG_RT uses the first 2 particles for fog layer graphics
 	const auto& particles = Main_Data::game_screen->GetParticles();
 	assert(particles.size() >= num_fog_particles);
-	const auto fog_bg_frames = particles[0].x;
-	const auto fog_fg_frames = particles[1].x;
+	const auto fog_bg_frames = particles.x[0];
+	const auto fog_fg_frames = particles.x[1];
 
 	// Front layer moves left one pixel every 8 frames.
 	const int fx = shake_x + (fog_fg_frames / 8) % sr.width;
@@ -19,7 +19,9 @@
 #define EP_WEATHER_H
 
 // Headers
+#include <cstdint>
 #include <string>
+#include <vector>
 #include "drawable.h"
 #include "system.h"
 #include "tone.h"
@@ -57,6 +59,19 @@ private:
 	void DrawSandParticles(Bitmap& dst, const Bitmap& particle);
 	const Bitmap* ApplyToneEffect(const Bitmap& bitmap, Rect rect);
 
+	/** Visible pixel of a particle graphic, relative to its rect */
+	struct ParticlePixel {
+		int x;
+		int y;
+		uint32_t color;
+	};
+
+	void CollectParticlePixels(const Bitmap& bitmap, Rect rect);
+	void BlendParticle(uint32_t* pixels, int pitch, Rect dst_rect, int x, int y, int opacity, size_t first, size_t last, Rect src_rect, bool mirror) const;
+
+	/** Pixels of the particle graphics being drawn, rebuilt every frame */
+	std::vector<ParticlePixel> particle_pixels;
+
 	BitmapRef snow_bitmap;
 	BitmapRef rain_bitmap;
 	BitmapRef fog_bitmap;
@@ -18,6 +18,7 @@
 // Headers
 #define _USE_MATH_DEFINES
 #include <cmath>
+#include <tuple>
 #include "system.h"
 #include "player.h"
 #include "rect.h"
@@ -64,44 +65,21 @@ void Window::Draw(Bitmap& dst) {
 	if (x < -width || x > dst.GetWidth() || y < -height || y > dst.GetHeight()) return;
 
 	if (windowskin) {
-		if (width > 4 && height > 4 && (back_opacity * opacity / 255 > 0)) {
-			if (background_needs_refresh) RefreshBackground();
-
-			if (animation_frames > 0) {
-				int ianimation_count = (int)animation_count;
-
-				Rect src_rect(0, height / 2 - ianimation_count, width, ianimation_count * 2);
-
-				dst.Blit(x, y + src_rect.y, *background, src_rect, back_opacity * opacity / 255);
-			} else {
-				dst.Blit(x, y, *background, background->GetRect(), back_opacity * opacity / 255);
-			}
+		if (windowskin->GetRevision() != windowskin_revision) {
+			windowskin_revision = windowskin->GetRevision();
+			background_needs_refresh = true;
+			frame_needs_refresh = true;
+			cursor_needs_refresh = true;
 		}
 
-		if (width > 0 && height > 0 && opacity > 0) {
-			if (frame_needs_refresh) RefreshFrame();
-
-			if (animation_frames > 0) {
-				int ianimation_count = (int)animation_count;
-
-				if (ianimation_count > 8) {
-					Rect src_rect(0, height / 2 - ianimation_count, 8, ianimation_count * 2 - 16);
-
-					dst.Blit(x, y + 8 + src_rect.y, *frame_left, src_rect, opacity);
-					dst.Blit(x + width - 8, y + 8 + src_rect.y, *frame_right, src_rect, opacity);
-
-					dst.Blit(x, y + height / 2 - ianimation_count, *frame_up, frame_up->GetRect(), opacity);
-					dst.Blit(x, y + height / 2 + ianimation_count - 8, *frame_down, frame_down->GetRect(), opacity);
-				} else {
-					dst.Blit(x, y + height / 2 - ianimation_count, *frame_up, Rect(0, 0, width, ianimation_count), opacity);
-					dst.Blit(x, y + height / 2 , *frame_down, Rect(0, 8 - ianimation_count, width, ianimation_count), opacity);
-				}
-			} else {
-				dst.Blit(x, y, *frame_up, frame_up->GetRect(), opacity);
-				dst.Blit(x, y + height - 8, *frame_down, frame_down->GetRect(), opacity);
-				dst.Blit(x, y + 8, *frame_left, frame_left->GetRect(), opacity);
-				dst.Blit(x + width - 8, y + 8, *frame_right, frame_right->GetRect(), opacity);
+		if (animation_frames > 0) {
+			DrawAnimatedFrame(dst);
+		} else if (opacity > 0) {
+			// Background and frame are composed once and drawn with a single blit
+			if (background_needs_refresh || frame_needs_refresh || surface_needs_refresh || surface_back_opacity != back_opacity) {
+				RefreshSurface();
 			}
+			dst.Blit(x, y, *surface, surface->GetRect(), opacity);
 		}
 
 		if (width >= 16 && height > 16 && cursor_rect.width > 4 && cursor_rect.height > 4 && animation_frames == 0) {
@@ -156,8 +134,124 @@ void Window::Draw(Bitmap& dst) {
 	}
 }
 
+bool Window::DrawState::operator==(const DrawState& o) const {
+	return std::tie(visible, windowskin, windowskin_revision, contents, contents_revision, stretch,
+			cursor_rect, bounds, ox, oy, border_x, border_y, opacity, back_opacity, contents_opacity,
+			arrows, pause_shown, cursor1_shown, animation_frames, animation_count) ==
+		std::tie(o.visible, o.windowskin, o.windowskin_revision, o.contents, o.contents_revision, o.stretch,
+			o.cursor_rect, o.bounds, o.ox, o.oy, o.border_x, o.border_y, o.opacity, o.back_opacity, o.contents_opacity,
+			o.arrows, o.pause_shown, o.cursor1_shown, o.animation_frames, o.animation_count);
+}
+
+Window::DrawState Window::GetDrawState() const {
+	DrawState state;
+	state.visible = IsVisible() && width > 0 && height > 0;
+	if (!state.visible) {
+		return state;
+	}
+
+	state.windowskin = windowskin.get();
+	state.windowskin_revision = windowskin ? windowskin->GetRevision() : 0;
+	state.contents = contents.get();
+	state.contents_revision = contents ? contents->GetRevision() : 0;
+	state.stretch = stretch;
+	state.cursor_rect = cursor_rect;
+	state.bounds = GetScreenBounds(Rect());
+	state.ox = ox;
+	state.oy = oy;
+	state.border_x = border_x;
+	state.border_y = border_y;
+	state.opacity = opacity;
+	state.back_opacity = back_opacity;
+	state.contents_opacity = contents_opacity;
+	state.arrows = up_arrow | (down_arrow << 1) | (left_arrow << 2) | (right_arrow << 3);
+	state.pause_shown = pause && pause_frame < pause_animation_frames;
+	state.cursor1_shown = cursor_frame <= 10;
+	state.animation_frames = animation_frames;
+	state.animation_count = static_cast<int>(animation_count);
+	return state;
+}
+
+Rect Window::GetScreenBounds(const Rect&) const {
+	// The arrows are drawn partially outside of the window
+	return Rect(x - 16, y - 16, width + 32, height + 32);
+}
+
+Rect Window::GetDamage(const Rect&) {
+	const auto state = GetDrawState();
+	if (state == composited_state) {
+		return Rect();
+	}
+
+	Rect damage = state.visible ? state.bounds : Rect();
+	if (composited_state.visible) {
+		damage = damage.GetUnion(composited_state.bounds);
+	}
+	return damage;
+}
+
+void Window::OnComposited() {
+	composited_state = GetDrawState();
+}
+
+void Window::DrawAnimatedFrame(Bitmap& dst) {
+	const int ianimation_count = (int)animation_count;
+
+	if (width > 4 && height > 4 && (back_opacity * opacity / 255 > 0)) {
+		if (background_needs_refresh) RefreshBackground();
+
+		Rect src_rect(0, height / 2 - ianimation_count, width, ianimation_count * 2);
+
+		dst.Blit(x, y + src_rect.y, *background, src_rect, back_opacity * opacity / 255);
+	}
+
+	if (opacity > 0) {
+		if (frame_needs_refresh) RefreshFrame();
+
+		if (ianimation_count > 8) {
+			Rect src_rect(0, height / 2 - ianimation_count, 8, ianimation_count * 2 - 16);
+
+			dst.Blit(x, y + 8 + src_rect.y, *frame_left, src_rect, opacity);
+			dst.Blit(x + width - 8, y + 8 + src_rect.y, *frame_right, src_rect, opacity);
+
+			dst.Blit(x, y + height / 2 - ianimation_count, *frame_up, frame_up->GetRect(), opacity);
+			dst.Blit(x, y + height / 2 + ianimation_count - 8, *frame_down, frame_down->GetRect(), opacity);
+		} else {
+			dst.Blit(x, y + height / 2 - ianimation_count, *frame_up, Rect(0, 0, width, ianimation_count), opacity);
+			dst.Blit(x, y + height / 2 , *frame_down, Rect(0, 8 - ianimation_count, width, ianimation_count), opacity);
+		}
+	}
+}
+
+void Window::RefreshSurface() {
+	if (background_needs_refresh) RefreshBackground();
+	if (frame_needs_refresh) RefreshFrame();
+	surface_needs_refresh = false;
+	surface_back_opacity = back_opacity;
+
+	if (!surface || surface->GetWidth() != width || surface->GetHeight() != height) {
+		surface = Bitmap::Create(width, height, true);
+	} else {
+		surface->Clear();
+	}
+
+	// Drawing the result with the window opacity gives the same image as
+	// drawing the background with back_opacity * opacity and the frame with opacity
+	if (width > 4 && height > 4 && back_opacity > 0) {
+		surface->Blit(0, 0, *background, background->GetRect(), back_opacity);
+	}
+
+	surface->Blit(0, 0, *frame_up, frame_up->GetRect(), Opacity::Opaque());
+	surface->Blit(0, height - 8, *frame_down, frame_down->GetRect(), Opacity::Opaque());
+	if (frame_left) {
+		surface->Blit(0, 8, *frame_left, frame_left->GetRect(), Opacity::Opaque());
+		surface->Blit(width - 8, 8, *frame_right, frame_right->GetRect(), Opacity::Opaque());
+	}
+}
+
 void Window::RefreshBackground() {
 	background_needs_refresh = false;
+	surface_needs_refresh = true;
 
 	BitmapRef bitmap = Bitmap::Create(width, height, false);
 
@@ -172,6 +266,7 @@ void Window::RefreshBackground() {
 
 void Window::RefreshFrame() {
 	frame_needs_refresh = false;
+	surface_needs_refresh = true;
 
 	BitmapRef up_bitmap = Bitmap::Create(width, 8);
 	BitmapRef down_bitmap = Bitmap::Create(width, 8);
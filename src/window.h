@@ -19,6 +19,7 @@
 #define EP_WINDOW_H
 
 // Headers
+#include <cstdint>
 #include "system.h"
 #include "drawable.h"
 #include "rect.h"
@@ -32,6 +33,10 @@ public:
 
 	void Draw(Bitmap& dst) override;
 
+	Rect GetDamage(const Rect& screen_rect) override;
+	Rect GetScreenBounds(const Rect& screen_rect) const override;
+	void OnComposited() override;
+
 	void Update();
 	BitmapRef const& GetWindowskin() const;
 	void SetWindowskin(BitmapRef const& nwindowskin);
@@ -110,6 +115,15 @@ private:
 		background, frame_down,
 		frame_up, frame_left, frame_right, cursor1, cursor2;
 
+	/** Background and frame composed for drawing when the window is not animated */
+	BitmapRef surface;
+	/** back_opacity the surface was composed with */
+	int surface_back_opacity = -1;
+	/** Revision of the windowskin the bitmaps were created from */
+	uint32_t windowskin_revision = 0;
+
+	void DrawAnimatedFrame(Bitmap& dst);
+	void RefreshSurface();
 	void RefreshBackground();
 	void RefreshFrame();
 	void RefreshCursor();
@@ -117,6 +131,7 @@ private:
 	bool background_needs_refresh;
 	bool frame_needs_refresh;
 	bool cursor_needs_refresh;
+	bool surface_needs_refresh = true;
 	bool pause = false;
 
 	int cursor_frame = 0;
@@ -124,6 +139,36 @@ private:
 	int animation_frames = 0;
 	double animation_count = 0.0;
 	double animation_increment = 0.0;
+
+	/** Everything which affects the output of Draw(), used for change tracking */
+	struct DrawState {
+		bool visible = false;
+		const Bitmap* windowskin = nullptr;
+		uint32_t windowskin_revision = 0;
+		const Bitmap* contents = nullptr;
+		uint32_t contents_revision = 0;
+		bool stretch = true;
+		Rect cursor_rect;
+		Rect bounds;
+		int ox = 0;
+		int oy = 0;
+		int border_x = 0;
+		int border_y = 0;
+		int opacity = 0;
+		int back_opacity = 0;
+		int contents_opacity = 0;
+		int arrows = 0;
+		bool pause_shown = false;
+		bool cursor1_shown = false;
+		int animation_frames = 0;
+		int animation_count = 0;
+
+		bool operator==(const DrawState& o) const;
+	};
+
+	DrawState composited_state;
+
+	DrawState GetDrawState() const;
 };
 
 inline bool Window::IsOpening() const {
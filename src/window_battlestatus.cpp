@@ -17,6 +17,7 @@
 
 // Headers
 #include <algorithm>
+#include "async_handler.h"
 #include "bitmap.h"
 #include "cache.h"
 #include "input.h"
@@ -29,6 +30,29 @@
 #include "font.h"
 #include "window_battlestatus.h"
 
+namespace {
+int GetGaugeSystem2Width(int cur_value, int max_value) {
+	if (max_value > 0) {
+		return 25 * cur_value / max_value;
+	}
+	return 25;
+}
+}
+
+bool Window_BattleStatus::GaugeCell::operator==(const GaugeCell& o) const {
+	return valid == o.valid
+		&& hp == o.hp
+		&& sp == o.sp
+		&& hp_width == o.hp_width
+		&& sp_width == o.sp_width
+		&& atb_width == o.atb_width
+		&& hp_full == o.hp_full
+		&& sp_full == o.sp_full
+		&& atb_full == o.atb_full
+		&& face_index == o.face_index
+		&& face_name == o.face_name;
+}
+
 Window_BattleStatus::Window_BattleStatus(int ix, int iy, int iwidth, int iheight, bool enemy) :
 	Window_Selectable(ix, iy, iwidth, iheight), mode(ChoiceMode_All), enemy(enemy) {
 
@@ -53,6 +77,7 @@ Window_BattleStatus::Window_BattleStatus(int ix, int iy, int iwidth, int iheight
 
 void Window_BattleStatus::Refresh() {
 	contents->Clear();
+	gauge_cells.clear();
 
 	if (enemy) {
 		item_max = Main_Data::game_enemyparty->GetBattlerCount();
@@ -94,11 +119,33 @@ void Window_BattleStatus::Refresh() {
 	RefreshGauge();
 }
 
+Window_BattleStatus::GaugeCell Window_BattleStatus::GetGaugeCell(const Game_Battler& battler) const {
+	GaugeCell cell;
+	cell.valid = true;
+	cell.atb_width = 25 * battler.GetAtbGauge() / battler.GetMaxAtbGauge();
+	cell.atb_full = battler.IsAtbGaugeFull();
+
+	if (!enemy && lcf::Data::battlecommands.battle_type == lcf::rpg::BattleCommands::BattleType_gauge) {
+		const auto& actor = static_cast<const Game_Actor&>(battler);
+		cell.hp = actor.GetHp();
+		cell.sp = actor.GetSp();
+		cell.hp_width = GetGaugeSystem2Width(actor.GetHp(), actor.GetMaxHp());
+		cell.sp_width = GetGaugeSystem2Width(actor.GetSp(), actor.GetMaxSp());
+		cell.atb_width = GetGaugeSystem2Width(actor.GetAtbGauge(), actor.GetMaxAtbGauge());
+		cell.hp_full = actor.GetHp() == actor.GetMaxHp();
+		cell.sp_full = actor.GetSp() == actor.GetMaxSp();
+		cell.atb_full = actor.GetAtbGauge() == actor.GetMaxAtbGauge();
+		cell.face_name = ToString(actor.GetFaceName());
+		cell.face_index = actor.GetFaceIndex();
+	} else if (lcf::Data::battlecommands.battle_type == lcf::rpg::BattleCommands::BattleType_alternative) {
+		cell.sp = battler.GetSp();
+	}
+	return cell;
+}
+
 void Window_BattleStatus::RefreshGauge() {
 	if (Player::IsRPG2k3()) {
-		if (lcf::Data::battlecommands.battle_type != lcf::rpg::BattleCommands::BattleType_gauge) {
-			contents->ClearRect(Rect(198, 0, 25 + 16, 15 * item_max));
-		}
+		gauge_cells.resize(item_max);
 
 		for (int i = 0; i < item_max; ++i) {
 			// The party always contains valid battlers
@@ -110,6 +157,11 @@ void Window_BattleStatus::RefreshGauge() {
 				actor = &(*Main_Data::game_party)[i];
 			}
 
+			auto cell = GetGaugeCell(*actor);
+			if (cell == gauge_cells[i]) {
+				continue;
+			}
+
 			if (!enemy && lcf::Data::battlecommands.battle_type == lcf::rpg::BattleCommands::BattleType_gauge) {
 				BitmapRef system2 = Cache::System2();
 				if (system2) {
@@ -147,15 +199,30 @@ void Window_BattleStatus::RefreshGauge() {
 					x = 40 + 80 * i;
 					DrawNumberSystem2(x, y, actor->GetHp());
 					DrawNumberSystem2(x, y + 12 + 4, actor->GetSp());
+
+					// A face which is still loading is drawn later over the numbers
+					const bool face_ready = cell.face_name.empty()
+						|| AsyncHandler::RequestFile("FaceSet", cell.face_name)->IsReady();
+					cell.valid = face_ready;
+					gauge_cells[i] = std::move(cell);
 				}
 			}
 			else {
 				int y = 2 + i * 16;
 
+				// Same area as the former clear of all rows
+				const int clear_h = std::min(16, 15 * item_max - 16 * i);
+				if (lcf::Data::battlecommands.battle_type != lcf::rpg::BattleCommands::BattleType_gauge && clear_h > 0) {
+					contents->ClearRect(Rect(198, 16 * i, 25 + 16, clear_h));
+				}
+
 				DrawGauge(*actor, 198 - 10, y - 2);
 				if (lcf::Data::battlecommands.battle_type == lcf::rpg::BattleCommands::BattleType_alternative) {
 					DrawActorSp(*actor, 198, y, 3, false);
 				}
+				// Not drawn without System2
+				cell.valid = Cache::System2() != nullptr;
+				gauge_cells[i] = std::move(cell);
 			}
 		}
 	}
@@ -173,11 +240,7 @@ void Window_BattleStatus::DrawGaugeSystem2(int x, int y, int cur_value, int max_
 		gauge_x = 0;
 	}
 
-	int gauge_width = 25;
-
-	if (max_value > 0) {
-		gauge_width = 25 * cur_value / max_value;
-	}
+	const int gauge_width = GetGaugeSystem2Width(cur_value, max_value);
 
 	contents->StretchBlit(Rect(x, y, gauge_width, 16), *system2, Rect(48 + gauge_x, 32 + 16 * which, 16, 16), Opacity::Opaque());
 }
@@ -19,6 +19,8 @@
 #define EP_WINDOW_BATTLESTATUS_H
 
 // Headers
+#include <string>
+#include <vector>
 #include "window_selectable.h"
 #include "bitmap.h"
 
@@ -76,9 +78,33 @@ protected:
 
 	/**
 	 * Redraws the characters time gauge.
+	 * Only battlers whose displayed values changed are redrawn.
 	 */
 	void RefreshGauge();
 
+	/** Values drawn by RefreshGauge for a battler */
+	struct GaugeCell {
+		bool valid = false;
+		int hp = 0;
+		int sp = 0;
+		int hp_width = 0;
+		int sp_width = 0;
+		int atb_width = 0;
+		bool hp_full = false;
+		bool sp_full = false;
+		bool atb_full = false;
+		std::string face_name;
+		int face_index = 0;
+
+		bool operator==(const GaugeCell& o) const;
+	};
+
+	/**
+	 * @param battler battler of the cell
+	 * @return the values RefreshGauge draws for the battler
+	 */
+	GaugeCell GetGaugeCell(const Game_Battler& battler) const;
+
 	void DrawGaugeSystem2(int x, int y, int cur_value, int max_value, int which);
 	void DrawNumberSystem2(int x, int y, int value);
 
@@ -95,6 +121,9 @@ protected:
 	bool enemy;
 
 	FileRequestBinding request_id;
+
+	/** Cells drawn by the last RefreshGauge, invalid ones are redrawn */
+	std::vector<GaugeCell> gauge_cells;
 };
 
 #endif
@@ -16,36 +16,267 @@
  */
 
 // Headers
+#include <algorithm>
+#include <cstring>
 #include <iomanip>
 #include <sstream>
+#include <unordered_map>
+#ifdef HAVE_THREADS
+#include <atomic>
+#include <future>
+#include <mutex>
+#endif
 #include "window_gamelist.h"
 #include "game_party.h"
 #include "bitmap.h"
 #include "font.h"
+#include "job_system.h"
+#include "platform.h"
+
+namespace {
+	/** Directories scanned per Update when there are no workers */
+	constexpr int scans_per_update = 8;
+	/** Scanning is mostly waiting for the file system */
+	constexpr int max_scan_jobs = 4;
+
+	bool LessByName(const std::string& l, const std::string& r) {
+		return strcmp(Utils::LowerCase(l).c_str(), Utils::LowerCase(r).c_str()) < 0;
+	}
+}
+
+/** Result of scanning a subdirectory */
+struct Window_GameList::ScanResult {
+	/** index into scan_entries */
+	size_t index;
+	/** modification time before the scan */
+	int64_t time;
+	bool valid;
+};
+
+/**
+ * Checks subdirectories for games on worker threads, or a few on
+ * every Poll when threads are not available.
+ */
+class Window_GameList::Scanner {
+public:
+	/**
+	 * @param base_path directory containing the subdirectories
+	 * @param jobs pairs of index into scan_entries and subdirectory name
+	 */
+	Scanner(std::string base_path, std::vector<std::pair<size_t, std::string>> jobs);
+
+	/** Stops the scan, running jobs are finished first */
+	~Scanner();
+
+	Scanner(const Scanner&) = delete;
+	Scanner& operator=(const Scanner&) = delete;
+
+	/**
+	 * Moves the results finished since the last call to out.
+	 *
+	 * @param out receives the results
+	 * @return true when all jobs are done
+	 */
+	bool Poll(std::vector<ScanResult>& out);
+
+private:
+	/** @return false when no job was left */
+	bool ScanNext();
+
+	std::string base_path;
+	std::vector<std::pair<size_t, std::string>> jobs;
+	std::vector<ScanResult> results;
+	size_t num_polled = 0;
+#ifdef HAVE_THREADS
+	std::atomic<size_t> next_job;
+	std::atomic<bool> quit;
+	std::mutex mutex;
+	std::vector<std::future<void>> scans;
+#else
+	size_t next_job = 0;
+#endif
+};
+
+Window_GameList::Scanner::Scanner(std::string base_path, std::vector<std::pair<size_t, std::string>> jobs) :
+	base_path(std::move(base_path)), jobs(std::move(jobs)) {
+#ifdef HAVE_THREADS
+	next_job = 0;
+	quit = false;
+
+	// Without workers Poll scans on the main thread
+	const int num_scans = std::min(JobSystem::GetThreadCount(), max_scan_jobs);
+	for (int i = 0; i < num_scans && i < static_cast<int>(this->jobs.size()); ++i) {
+		scans.push_back(JobSystem::Async([this]() {
+			while (!quit && ScanNext()) {
+			}
+		}, JobSystem::Priority::Low));
+	}
+#endif
+}
+
+Window_GameList::Scanner::~Scanner() {
+#ifdef HAVE_THREADS
+	quit = true;
+	for (auto& scan : scans) {
+		scan.wait();
+	}
+#endif
+}
+
+bool Window_GameList::Scanner::ScanNext() {
+	const size_t job = next_job++;
+	if (job >= jobs.size()) {
+		return false;
+	}
+
+	const std::string path = FileFinder::MakePath(base_path, jobs[job].second);
+	const int64_t time = Platform::File(path).GetModificationTime();
+	auto subtree = FileFinder::CreateDirectoryTree(path, FileFinder::FILES);
+	const ScanResult result = { jobs[job].first, time, subtree && FileFinder::IsValidProject(*subtree) };
+
+#ifdef HAVE_THREADS
+	std::lock_guard<std::mutex> lock(mutex);
+#endif
+	results.push_back(result);
+	return true;
+}
+
+bool Window_GameList::Scanner::Poll(std::vector<ScanResult>& out) {
+#ifdef HAVE_THREADS
+	if (scans.empty()) {
+		for (int i = 0; i < scans_per_update && ScanNext(); ++i) {
+		}
+	}
+	std::lock_guard<std::mutex> lock(mutex);
+#else
+	for (int i = 0; i < scans_per_update && ScanNext(); ++i) {
+	}
+#endif
+	num_polled += results.size();
+	out.insert(out.end(), results.begin(), results.end());
+	results.clear();
+	return num_polled == jobs.size();
+}
 
 Window_GameList::Window_GameList(int ix, int iy, int iwidth, int iheight) :
 	Window_Selectable(ix, iy, iwidth, iheight) {
 	column_max = 1;
 }
 
+Window_GameList::~Window_GameList() = default;
+
 void Window_GameList::Refresh() {
-	tree = FileFinder::CreateDirectoryTree(Main_Data::GetProjectPath(), FileFinder::DIRECTORIES);
+	StopScan();
+
+	scan_path = Main_Data::GetProjectPath();
+	tree = FileFinder::CreateDirectoryTree(scan_path, FileFinder::DIRECTORIES);
 	game_directories.clear();
+	scan_entries.clear();
+
+	std::vector<AssetCache::GameScanEntry> cached;
+	AssetCache::LoadGameScan(scan_path, cached);
+	std::unordered_map<std::string, const AssetCache::GameScanEntry*> cached_entries;
+	for (const auto& entry : cached) {
+		cached_entries[entry.directory] = &entry;
+	}
 
-	// Find valid game diectories
-	for (auto dir : tree.get()->directories) {
-		std::shared_ptr<FileFinder::DirectoryTree> subtree = FileFinder::CreateDirectoryTree(FileFinder::MakePath(Main_Data::GetProjectPath(), dir.second), FileFinder::FILES);
-		if (FileFinder::IsValidProject(*subtree)) {
-			game_directories.push_back(dir.second);
+	// Find valid game diectories, unchanged ones are taken from the cache
+	std::vector<std::pair<size_t, std::string>> jobs;
+	if (tree) {
+		for (const auto& dir : tree->directories) {
+			AssetCache::GameScanEntry entry = { dir.second,
+				Platform::File(FileFinder::MakePath(scan_path, dir.second)).GetModificationTime(), false };
+
+			auto it = cached_entries.find(entry.directory);
+			if (entry.time >= 0 && it != cached_entries.end() && it->second->time == entry.time) {
+				entry.valid = it->second->valid;
+				if (entry.valid) {
+					game_directories.push_back(entry.directory);
+				}
+			} else {
+				// Not stored with this time until the scan result arrives
+				entry.time = -1;
+				jobs.emplace_back(scan_entries.size(), entry.directory);
+			}
+			scan_entries.push_back(std::move(entry));
 		}
 	}
 
 	// Sort game list in place
-	std::sort(game_directories.begin(), game_directories.end(),
-			  [](const std::string& s, const std::string& s2) {
-				  return strcmp(Utils::LowerCase(s).c_str(), Utils::LowerCase(s2).c_str()) <= 0;
-			  });
+	std::sort(game_directories.begin(), game_directories.end(), LessByName);
+
+	if (!jobs.empty()) {
+		scanner = std::make_unique<Scanner>(scan_path, std::move(jobs));
+	} else if (cached.size() != scan_entries.size()) {
+		AssetCache::StoreGameScan(scan_path, scan_entries);
+	}
+
+	DrawList();
+}
+
+void Window_GameList::Update() {
+	if (scanner) {
+		std::vector<ScanResult> results;
+		const bool done = scanner->Poll(results);
+
+		ApplyResults(results);
+
+		if (done) {
+			scanner.reset();
+			AssetCache::StoreGameScan(scan_path, scan_entries);
+		}
+
+		if (!results.empty() || done) {
+			DrawList();
+		}
+	}
+
+	Window_Selectable::Update();
+}
+
+bool Window_GameList::IsScanning() const {
+	return scanner != nullptr;
+}
+
+bool Window_GameList::StopScan() {
+	if (!scanner) {
+		return false;
+	}
+
+	std::vector<ScanResult> results;
+	scanner->Poll(results);
+	scanner.reset();
+	ApplyResults(results);
+
+	// Unfinished directories have no time and are scanned again
+	AssetCache::StoreGameScan(scan_path, scan_entries);
+	return true;
+}
+
+void Window_GameList::ApplyResults(const std::vector<ScanResult>& results) {
+	for (const auto& result : results) {
+		auto& entry = scan_entries[result.index];
+		entry.time = result.time;
+		entry.valid = result.valid;
+		if (entry.valid) {
+			AddGame(entry.directory);
+		}
+	}
+}
 
+void Window_GameList::AddGame(const std::string& dir) {
+	auto it = std::lower_bound(game_directories.begin(), game_directories.end(), dir, LessByName);
+	const int pos = static_cast<int>(it - game_directories.begin());
+	game_directories.insert(it, dir);
+	item_max = game_directories.size();
+
+	const int index = GetIndex();
+	if (index >= 0 && pos <= index) {
+		SetIndex(index + 1);
+	}
+}
+
+void Window_GameList::DrawList() {
 	if (HasValidGames()) {
 		item_max = game_directories.size();
 
@@ -53,14 +284,16 @@ void Window_GameList::Refresh() {
 
 		contents->Clear();
 
-		for (int i = 0; i < item_max; ++i) {
-			DrawItem(i);
-		}
+		InvalidateItems();
 	}
 	else {
 		SetContents(Bitmap::Create(width - 16, height - 16));
 
-		DrawErrorText();
+		if (IsScanning()) {
+			contents->TextDraw(0, 0, Font::ColorDefault, "Searching for games...");
+		} else {
+			DrawErrorText();
+		}
 	}
 }
 
@@ -19,7 +19,9 @@
 #define EP_WINDOW_GAMELIST_H
 
 // Headers
+#include <memory>
 #include <vector>
+#include "asset_cache.h"
 #include "window_help.h"
 #include "window_selectable.h"
 #include "filefinder.h"
@@ -35,17 +37,38 @@ public:
 	 */
 	Window_GameList(int ix, int iy, int iwidth, int iheight);
 
+	~Window_GameList() override;
+
 	/**
 	 * Refreshes the item list.
+	 * Subdirectories whose result is in the asset cache are listed at once,
+	 * the others are scanned in the background and added by Update.
 	 */
 	void Refresh();
 
+	/**
+	 * Adds the games found since the last call and updates the selection.
+	 */
+	void Update() override;
+
+	/**
+	 * @return true while subdirectories are scanned
+	 */
+	bool IsScanning() const;
+
+	/**
+	 * Stops the background scan, the finished results are stored.
+	 *
+	 * @return true when a scan was running, Refresh to continue it
+	 */
+	bool StopScan();
+
 	/**
 	 * Draws an item together with the quantity.
 	 *
 	 * @param index index of item to draw.
 	 */
-	void DrawItem(int index);
+	void DrawItem(int index) override;
 
 	void DrawErrorText();
 
@@ -60,8 +83,25 @@ public:
 	std::string GetGamePath();
 
 private:
+	class Scanner;
+	struct ScanResult;
+
+	/** Takes over finished results of the Scanner */
+	void ApplyResults(const std::vector<ScanResult>& results);
+
+	/** Inserts a game sorted by name, keeps the selected game selected */
+	void AddGame(const std::string& dir);
+
+	/** Recreates the contents after the list changed */
+	void DrawList();
+
 	std::shared_ptr<FileFinder::DirectoryTree> tree;
 	std::vector<std::string> game_directories;
+	/** Results of all subdirectories, stored in the asset cache when the scan is done */
+	std::vector<AssetCache::GameScanEntry> scan_entries;
+	/** Directory the games are listed from */
+	std::string scan_path;
+	std::unique_ptr<Scanner> scanner;
 };
 
 #endif
@@ -98,9 +98,7 @@ void Window_Item::Refresh() {
 
 	contents->Clear();
 
-	for (int i = 0; i < item_max; ++i) {
-		DrawItem(i);
-	}
+	InvalidateItems();
 }
 
 void Window_Item::DrawItem(int index) {
@@ -65,7 +65,7 @@ public:
 	 *
 	 * @param index index of item to draw.
 	 */
-	void DrawItem(int index);
+	void DrawItem(int index) override;
 
 	/**
 	 * Updates the help window.
@@ -126,6 +126,8 @@ Window_Message::~Window_Message() {
 
 void Window_Message::StartMessageProcessing(PendingMessage pm) {
 	text.clear();
+	page_ops.clear();
+	page_op_index = 0;
 	pending_message = std::move(pm);
 
 	if (!IsVisible()) {
@@ -244,6 +246,8 @@ void Window_Message::InsertNewPage() {
 	// Otherwise they render on the wrong page
 	face_request_ids.clear();
 
+	LayoutPage();
+
 	contents->Clear();
 	SetIndex(-1);
 	SetPause(false);
@@ -296,8 +300,7 @@ void Window_Message::InsertNewPage() {
 		ShowGoldWindow();
 	} else {
 		// If first character is gold, the gold window appears immediately and animates open with the main window.
-		auto tret = Utils::TextNext(text_index, (text.data() + text.size()), Player::escape_char);
-		if (tret && tret.is_escape && tret.ch == '$') {
+		if (IsNextRawOp(PageOp::Gold)) {
 			ShowGoldWindow();
 		}
 	}
@@ -337,6 +340,8 @@ void Window_Message::FinishMessageProcessing() {
 	DebugLog("{}: FINISH MSG");
 	text.clear();
 	text_index = text.data();
+	page_ops.clear();
+	page_op_index = 0;
 
 	SetPause(false);
 	kill_page = false;
@@ -367,6 +372,107 @@ void Window_Message::FinishMessageProcessing() {
 	}
 }
 
+void Window_Message::LayoutPage() {
+	page_ops.clear();
+	page_op_index = 0;
+
+	auto font = Font::Default();
+	const auto* end = text.data() + text.size();
+
+	while (text_index != end) {
+		auto tret = Utils::TextNext(text_index, end, Player::escape_char);
+		text_index = tret.next;
+
+		PageOp op;
+		const auto ch = tret.ch;
+
+		if (EP_UNLIKELY(!tret)) {
+			op.type = PageOp::Skip;
+		} else if (tret.is_exfont) {
+			op.type = PageOp::Glyph;
+			op.is_exfont = true;
+		} else if (ch == '\f' || ch == '\n') {
+			op.type = (ch == '\f') ? PageOp::NewPage : PageOp::NewLine;
+			op.raw = !tret.is_escape;
+		} else if (Utils::IsControlCharacter(ch)) {
+			// control characters not handled
+			op.type = PageOp::Skip;
+		} else if (tret.is_escape && ch != Player::escape_char) {
+			// Special message codes
+			switch (ch) {
+			case 'c':
+			case 'C':
+				{
+					auto pres = Game_Message::ParseColor(text_index, end, Player::escape_char, true);
+					text_index = pres.next;
+					op.type = PageOp::Color;
+					op.value = pres.value;
+				}
+				break;
+			case 's':
+			case 'S':
+				{
+					auto pres = Game_Message::ParseSpeed(text_index, end, Player::escape_char, true);
+					text_index = pres.next;
+					op.type = PageOp::Speed;
+					op.value = pres.value;
+				}
+				break;
+			case '_':
+				op.type = PageOp::HalfSpace;
+				op.value = font->GetSize(" ").width / 2;
+				break;
+			case '$':
+				op.type = PageOp::Gold;
+				break;
+			case '!':
+				op.type = PageOp::Pause;
+				break;
+			case '^':
+				op.type = PageOp::KillPage;
+				break;
+			case '>':
+				op.type = PageOp::InstantStart;
+				break;
+			case '<':
+				op.type = PageOp::InstantStop;
+				break;
+			case '.':
+				op.type = PageOp::QuickSleep;
+				break;
+			case '|':
+				op.type = PageOp::Sleep;
+				break;
+			default:
+				op.type = PageOp::Unknown;
+				break;
+			}
+		} else {
+			op.type = PageOp::Glyph;
+		}
+
+		if (op.type == PageOp::Glyph) {
+			// RPG_RT compatible for half-width (6) and full-width (12)
+			// generalizes the algo for even bigger glyphs
+			auto& glyph_font = op.is_exfont ? *Font::exfont : *font;
+			const int width = glyph_font.GetSize(ch).width;
+			op.ch = ch;
+			op.value = glyph_font.Glyph(ch).rect.width;
+			op.units = (width > 0) ? (width - 1) / 6 + 1 : 0;
+		}
+
+		page_ops.push_back(op);
+		if (op.type == PageOp::NewPage) {
+			break;
+		}
+	}
+}
+
+bool Window_Message::IsNextRawOp(PageOp::Type type, size_t offset) const {
+	const auto i = page_op_index + offset;
+	return i < page_ops.size() && page_ops[i].type == type && page_ops[i].raw;
+}
+
 void Window_Message::ResetWindow() {
 
 }
@@ -445,8 +551,6 @@ void Window_Message::UpdateMessage() {
 	auto font = Font::Default();
 
 	while (true) {
-		const auto* end = text.data() + text.size();
-
 		if (wait_count > 0) {
 			DebugLog("{}: MSG WAIT LOOP {}", wait_count);
 			--wait_count;
@@ -457,163 +561,132 @@ void Window_Message::UpdateMessage() {
 			break;
 		}
 
-		if (text_index == end) {
+		if (page_op_index >= page_ops.size()) {
 			FinishMessageProcessing();
 			break;
 		}
 
-		auto tret = Utils::TextNext(text_index, end, Player::escape_char);
-		auto text_prev = text_index;
-		text_index = tret.next;
-
-		if (EP_UNLIKELY(!tret)) {
-			continue;
-		}
+		// Copied, a new page replaces page_ops
+		const auto op = page_ops[page_op_index];
+		++page_op_index;
 
-		const auto ch = tret.ch;
-		if (tret.is_exfont) {
-			if (!DrawGlyph(*font, *system, ch, true)) {
-				text_index = text_prev;
+		switch (op.type) {
+		case PageOp::Skip:
+			break;
+		case PageOp::Glyph:
+			if (!DrawGlyph(*font, *system, op)) {
+				--page_op_index;
 			}
-			continue;
-		}
-
-		if (ch == '\f') {
-			if (text_index != end) {
+			break;
+		case PageOp::NewPage:
+			if (text_index != text.data() + text.size()) {
 				InsertNewPage();
 				SetWait(1);
 			}
-			continue;
-		}
-
-		if (ch == '\n') {
-			int wait_frames = 0;
-			bool end_page = (*text_index == '\f');
-
-			if (!instant_speed) {
-				if (!prev_char_printable) {
-					wait_frames += 1 + end_page;
+			break;
+		case PageOp::NewLine:
+			{
+				int wait_frames = 0;
+				bool end_page = IsNextRawOp(PageOp::NewPage);
+
+				if (!instant_speed) {
+					if (!prev_char_printable) {
+						wait_frames += 1 + end_page;
+					}
+				} else if (end_page) {
+					// When the page ends and speed is instant, RPG_RT always waits 2 frames.
+					wait_frames += 2;
 				}
-			} else if (end_page) {
-				// When the page ends and speed is instant, RPG_RT always waits 2 frames.
-				wait_frames += 2;
-			}
 
-			InsertNewLine();
+				InsertNewLine();
 
-			if (end_page) {
-				OnFinishPage();
-			}
-			SetWait(wait_frames);
-
-			if (instant_speed && !instant_speed_forced) {
-				// instant_speed stops at the end of the line
-				// unless it was triggered by the shift key.
-				instant_speed = false;
-			}
-			continue;
-		}
-
-		if (Utils::IsControlCharacter(ch)) {
-			// control characters not handled
-			continue;
-		}
-
-		if (tret.is_escape && ch != Player::escape_char) {
-			// Special message codes
-			switch (ch) {
-			case 'c':
-			case 'C':
-				{
-					// Color
-					auto pres = Game_Message::ParseColor(text_index, end, Player::escape_char, true);
-					auto value = pres.value;
-					text_index = pres.next;
-					DebugLogText("{}: MSG Color \\c[{}]", value);
-					SetWaitForNonPrintable(0);
-					text_color = value > 19 ? 0 : value;
+				if (end_page) {
+					OnFinishPage();
 				}
-				break;
-			case 's':
-			case 'S':
-				{
-					// Speed modifier
-					auto pres = Game_Message::ParseSpeed(text_index, end, Player::escape_char, true);
-					text_index = pres.next;
-					DebugLogText("{}: MSG Speed \\s[{}]", pres.value);
-					SetWaitForNonPrintable(0);
-					speed = Utils::Clamp(pres.value, 1, 20);
+				SetWait(wait_frames);
+
+				if (instant_speed && !instant_speed_forced) {
+					// instant_speed stops at the end of the line
+					// unless it was triggered by the shift key.
+					instant_speed = false;
 				}
-				break;
-			case '_':
-				// Insert half size space
-				contents_x += Font::Default()->GetSize(" ").width / 2;
-				DebugLogText("{}: MSG HalfWait \\_");
-				SetWaitForCharacter(1);
-				break;
-			case '$':
-				// Show Gold Window
-				ShowGoldWindow();
-				DebugLogText("{}: MSG Gold \\$");
-				SetWaitForNonPrintable(speed);
-				break;
-			case '!':
-				// Text pause
-				DebugLogText("{}: MSG Pause \\!");
-				SetWaitForNonPrintable(0);
-				SetPause(true);
-				break;
-			case '^':
-				// Force message close
-				// The close happens at the end of the message, not where
-				// the ^ is encountered
-				DebugLogText("{}: MSG Kill Page \\^");
-				kill_page = true;
-				SetWaitForNonPrintable(speed);
-				break;
-			case '>':
-				// Instant speed start
-				DebugLogText("{}: MSG Instant Speed Start \\>");
-				SetWaitForNonPrintable(0);
-				instant_speed = true;
-				break;
-			case '<':
-				// Instant speed stop - also cancels shift key and forces a delay.
-				instant_speed = false;
-				instant_speed_forced = false;
-				DebugLogText("{}: MSG Instant Speed Stop \\<");
-				SetWaitForNonPrintable(speed);
-				break;
-			case '.':
-				// 1/4 second sleep
-				// Despite documentation saying 1/4 second, RPG_RT waits for 16 frames.
-				// RPG_RT also has a bug(??) where speeds >= 17 slow this down by 1 more frame per speed.
-				SetWaitForNonPrintable(16 + Utils::Clamp(speed - 16, 0, 4));
-				DebugLogText("{}: MSG Quick Sleep \\.");
-				break;
-			case '|':
-				// Second sleep
-				// Despite documentation saying 1 second, RPG_RT waits for 61 frames.
-				SetWaitForNonPrintable(61);
-				DebugLogText("{}: MSG Sleep \\|");
-				break;
-			default:
-				// Unknown characters will not display anything but do wait.
-				SetWaitForNonPrintable(speed);
-				break;
 			}
-			continue;
-		}
-
-		if (!DrawGlyph(*font, *system, ch, false)) {
-			text_index = text_prev;
-			continue;
+			break;
+		case PageOp::Color:
+			// Color
+			DebugLogText("{}: MSG Color \\c[{}]", op.value);
+			SetWaitForNonPrintable(0);
+			text_color = op.value > 19 ? 0 : op.value;
+			break;
+		case PageOp::Speed:
+			// Speed modifier
+			DebugLogText("{}: MSG Speed \\s[{}]", op.value);
+			SetWaitForNonPrintable(0);
+			speed = Utils::Clamp(op.value, 1, 20);
+			break;
+		case PageOp::HalfSpace:
+			// Insert half size space
+			contents_x += op.value;
+			DebugLogText("{}: MSG HalfWait \\_");
+			SetWaitForCharacter(1);
+			break;
+		case PageOp::Gold:
+			// Show Gold Window
+			ShowGoldWindow();
+			DebugLogText("{}: MSG Gold \\$");
+			SetWaitForNonPrintable(speed);
+			break;
+		case PageOp::Pause:
+			// Text pause
+			DebugLogText("{}: MSG Pause \\!");
+			SetWaitForNonPrintable(0);
+			SetPause(true);
+			break;
+		case PageOp::KillPage:
+			// Force message close
+			// The close happens at the end of the message, not where
+			// the ^ is encountered
+			DebugLogText("{}: MSG Kill Page \\^");
+			kill_page = true;
+			SetWaitForNonPrintable(speed);
+			break;
+		case PageOp::InstantStart:
+			// Instant speed start
+			DebugLogText("{}: MSG Instant Speed Start \\>");
+			SetWaitForNonPrintable(0);
+			instant_speed = true;
+			break;
+		case PageOp::InstantStop:
+			// Instant speed stop - also cancels shift key and forces a delay.
+			instant_speed = false;
+			instant_speed_forced = false;
+			DebugLogText("{}: MSG Instant Speed Stop \\<");
+			SetWaitForNonPrintable(speed);
+			break;
+		case PageOp::QuickSleep:
+			// 1/4 second sleep
+			// Despite documentation saying 1/4 second, RPG_RT waits for 16 frames.
+			// RPG_RT also has a bug(??) where speeds >= 17 slow this down by 1 more frame per speed.
+			SetWaitForNonPrintable(16 + Utils::Clamp(speed - 16, 0, 4));
+			DebugLogText("{}: MSG Quick Sleep \\.");
+			break;
+		case PageOp::Sleep:
+			// Second sleep
+			// Despite documentation saying 1 second, RPG_RT waits for 61 frames.
+			SetWaitForNonPrintable(61);
+			DebugLogText("{}: MSG Sleep \\|");
+			break;
+		case PageOp::Unknown:
+			// Unknown characters will not display anything but do wait.
+			SetWaitForNonPrintable(speed);
+			break;
 		}
 	}
 }
 
-bool Window_Message::DrawGlyph(Font& font, const Bitmap& system, char32_t glyph, bool is_exfont) {
-	if (is_exfont) {
+bool Window_Message::DrawGlyph(Font& font, const Bitmap& system, const PageOp& op) {
+	const auto glyph = op.ch;
+	if (op.is_exfont) {
 		DebugLogText("{}: MSG DrawGlyph Exfont {}", static_cast<uint32_t>(glyph));
 	} else {
 		if (glyph < 128) {
@@ -623,18 +696,9 @@ bool Window_Message::DrawGlyph(Font& font, const Bitmap& system, char32_t glyph,
 		}
 	}
 
-	// RPG_RT compatible for half-width (6) and full-width (12)
-	// generalizes the algo for even bigger glyphs
-	auto get_width = [](int w) {
-		return (w > 0) ? (w - 1) / 6 + 1 : 0;
-	};
-
 	// Wide characters cause an extra wait if the last printed character did not wait.
 	if (prev_char_printable && !prev_char_waited) {
-		auto& wide_font = is_exfont ? *Font::exfont : font;
-		auto rect = wide_font.GetSize(glyph);
-		auto width = get_width(rect.width);
-		if (width >= 2) {
+		if (op.units >= 2) {
 			prev_char_waited = true;
 			++line_char_counter;
 			SetWait(1);
@@ -642,11 +706,12 @@ bool Window_Message::DrawGlyph(Font& font, const Bitmap& system, char32_t glyph,
 		}
 	}
 
-	auto rect = Text::Draw(*contents, contents_x, contents_y, font, system, text_color, glyph, is_exfont);
+	Text::Draw(*contents, contents_x, contents_y, font, system, text_color, glyph, op.is_exfont);
 
-	int glyph_width = rect.width;
+	// Same as op.units, but for the width that was laid out
+	int glyph_width = op.value;
 	contents_x += glyph_width;
-	int width = get_width(glyph_width);
+	int width = (glyph_width > 0) ? (glyph_width - 1) / 6 + 1 : 0;
 	SetWaitForCharacter(width);
 
 	return true;
@@ -748,7 +813,8 @@ void Window_Message::SetWaitForNonPrintable(int frames) {
 void Window_Message::SetWaitForCharacter(int width) {
 	int frames = 0;
 	if (!instant_speed && width > 0) {
-		bool is_last_for_page = (text.data() + text.size() - text_index) < 2 || (*text_index == '\n' && *(text_index + 1) == '\f');
+		bool is_last_for_text = (text_index == text.data() + text.size()) && (page_ops.size() - page_op_index) < 2;
+		bool is_last_for_page = is_last_for_text || (IsNextRawOp(PageOp::NewLine) && IsNextRawOp(PageOp::NewPage, 1));
 
 		if (is_last_for_page) {
 			// RPG_RT always waits 2 frames for last character on the page.
@@ -760,7 +826,7 @@ void Window_Message::SetWaitForCharacter(int width) {
 			} else {
 				frames = width / 2;
 				if (width & 1) {
-					bool is_last_for_line = (*text_index == '\n');
+					bool is_last_for_line = IsNextRawOp(PageOp::NewLine);
 
 					// RPG_RT waits for every even character. Also always waits
 					// for the last character.
@@ -20,6 +20,7 @@
 
 // Headers
 #include <string>
+#include <vector>
 #include "window_gold.h"
 #include "window_numberinput.h"
 #include "window_selectable.h"
@@ -137,7 +138,7 @@ protected:
 	int contents_y = 0;
 	/** Current number of lines on this page. */
 	int line_count = 0;
-	/** Index of the next char in text that will be output. */
+	/** Start of the next page in text, the current page was laid out into page_ops. */
 	const char* text_index = nullptr;
 	/** text message that will be displayed. */
 	std::string text;
@@ -174,7 +175,66 @@ protected:
 
 	PendingMessage pending_message;
 
-	bool DrawGlyph(Font& font, const Bitmap& system, char32_t glyph, bool is_exfont);
+	/** A step of the current page, the control codes are parsed once when the page starts. */
+	struct PageOp {
+		enum Type : uint8_t {
+			/** Control characters and invalid text, nothing happens */
+			Skip,
+			Glyph,
+			NewLine,
+			NewPage,
+			/** \\c[], value is the color */
+			Color,
+			/** \\s[], value is the speed */
+			Speed,
+			/** \\_, value is the width */
+			HalfSpace,
+			/** \\$ */
+			Gold,
+			/** \\! */
+			Pause,
+			/** \\^ */
+			KillPage,
+			/** \\> */
+			InstantStart,
+			/** \\< */
+			InstantStop,
+			/** \\. */
+			QuickSleep,
+			/** \\| */
+			Sleep,
+			/** Unknown codes display nothing but wait */
+			Unknown
+		};
+
+		Type type = Skip;
+		/** Glyph of the exfont */
+		bool is_exfont = false;
+		/** false for escaped line and page breaks, the typing speed only looks at unescaped ones */
+		bool raw = true;
+		/** Glyph to draw */
+		char32_t ch = 0;
+		/** Drawn width of the glyph, or the parameter of the code */
+		int value = 0;
+		/** Width the font reports for the glyph, in half width characters */
+		int units = 0;
+	};
+
+	/** Steps of the current page */
+	std::vector<PageOp> page_ops;
+	/** Index of the next step in page_ops that will be output. */
+	size_t page_op_index = 0;
+
+	/** Parses the page starting at text_index into page_ops and moves text_index to the next page. */
+	void LayoutPage();
+
+	/**
+	 * @param offset how far to look ahead of the next step
+	 * @return true if the step is an unescaped character of the given type
+	 */
+	bool IsNextRawOp(PageOp::Type type, size_t offset = 0) const;
+
+	bool DrawGlyph(Font& font, const Bitmap& system, const PageOp& op);
 	void IncrementLineCharCounter(int width);
 
 	void SetWaitForCharacter(int width);
@@ -54,6 +54,7 @@ void Window_Selectable::SetTopRow(int row) {
 	if (row < 0) row = 0;
 	if (row > GetRowMax() - 1) row = GetRowMax() - 1;
 	SetOy(row * 16);
+	DrawVisibleItems();
 }
 int Window_Selectable::GetPageRowMax() const {
 	return (height - 16) / 16;
@@ -71,6 +72,38 @@ Rect Window_Selectable::GetItemRect(int index) {
 	return rect;
 }
 
+void Window_Selectable::DrawItem(int) {
+}
+
+void Window_Selectable::InvalidateItems() {
+	items_dirty.assign(max(item_max, 0), true);
+	DrawVisibleItems();
+}
+
+void Window_Selectable::InvalidateItem(int index) {
+	if (index >= 0 && index < static_cast<int>(items_dirty.size())) {
+		items_dirty[index] = true;
+		DrawVisibleItems();
+	}
+}
+
+void Window_Selectable::DrawVisibleItems() {
+	if (!contents) {
+		return;
+	}
+
+	// A partially visible row below the page is drawn as well
+	const int first = max(GetTopRow(), 0) * column_max;
+	const int count = min(item_max, static_cast<int>(items_dirty.size()));
+	const int last = min((GetTopRow() + GetPageRowMax() + 1) * column_max, count);
+	for (int i = first; i < last; ++i) {
+		if (items_dirty[i]) {
+			items_dirty[i] = false;
+			DrawItem(i);
+		}
+	}
+}
+
 Window_Help* Window_Selectable::GetHelpWindow() {
 	return help_window;
 }
@@ -169,4 +202,5 @@ void Window_Selectable::Update() {
 	}
 	UpdateCursorRect();
 	UpdateArrows();
+	DrawVisibleItems();
 }
@@ -20,6 +20,7 @@
 
 // Headers
 #include <functional>
+#include <vector>
 #include "window_base.h"
 #include "window_help.h"
 
@@ -76,6 +77,33 @@ public:
 protected:
 	void UpdateArrows();
 
+	/**
+	 * Draws one item. Called for items marked by InvalidateItems or
+	 * InvalidateItem once their row is visible.
+	 *
+	 * @param index index of item
+	 */
+	virtual void DrawItem(int index);
+
+	/**
+	 * Marks all items for redrawing. Visible items are drawn immediately,
+	 * the others when they are scrolled into view.
+	 */
+	void InvalidateItems();
+
+	/**
+	 * Marks one item for redrawing, it is drawn when visible.
+	 *
+	 * @param index index of item
+	 */
+	void InvalidateItem(int index);
+
+	/** Draws the marked items of the visible rows */
+	void DrawVisibleItems();
+
+	/** Items waiting for DrawItem */
+	std::vector<bool> items_dirty;
+
 	Window_Help* help_window = nullptr;
 	int item_max = 1;
 	int column_max = 1;
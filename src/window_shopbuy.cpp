@@ -47,13 +47,9 @@ int Window_ShopBuy::GetItemId() {
 void Window_ShopBuy::Refresh() {
 	CreateContents();
 
-	contents->Clear();
-	Rect rect(0, 0, contents->GetWidth(), contents->GetHeight());
 	contents->Clear();
 
-	for (size_t i = 0; i < data.size(); ++i) {
-		DrawItem(i);
-	}
+	InvalidateItems();
 }
 
 void Window_ShopBuy::DrawItem(int index) {
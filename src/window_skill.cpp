@@ -66,9 +66,7 @@ void Window_Skill::Refresh() {
 
 	contents->Clear();
 
-	for (int i = 0; i < item_max; ++i) {
-		DrawItem(i);
-	}
+	InvalidateItems();
 }
 
 void Window_Skill::DrawItem(int index) {
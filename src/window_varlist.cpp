@@ -29,7 +29,7 @@
 #include "game_map.h"
 
 Window_VarList::Window_VarList(std::vector<std::string> commands) :
-Window_Command(commands, 224, 10) {
+Window_Command(commands, 224, 10), rows(10) {
 	SetX(0);
 	SetY(32);
 	SetHeight(176);
@@ -41,59 +41,85 @@ Window_VarList::~Window_VarList() {
 }
 
 void Window_VarList::Refresh() {
-	contents->Clear();
+	const int revision = GetValueRevision();
+	if (revision >= 0 && revision == drawn_revision) {
+		return;
+	}
 	for (int i = 0; i < 10; i++) {
 		DrawItemValue(i);
 	}
+	drawn_revision = revision;
 }
 
-void Window_VarList::DrawItemValue(int index){
-	if (!DataIsValid(first_var+index)) {
-		return;
-	}
+int Window_VarList::GetValueRevision() const {
 	switch (mode) {
 		case eSwitch:
-			{
-				auto value = Main_Data::game_switches->Get(first_var + index);
-				auto font = (!value) ? Font::ColorCritical : Font::ColorDefault;
-				DrawItem(index, Font::ColorDefault);
-				contents->TextDraw(GetWidth() - 16, 16 * index + 2, font, value ? "[ON]" : "[OFF]", Text::AlignRight);
-			}
-			break;
+			return Main_Data::game_switches->GetRevision();
 		case eVariable:
-			{
-				auto value = Main_Data::game_variables->Get(first_var + index);
-				auto font = (value < 0) ? Font::ColorCritical : Font::ColorDefault;
-				DrawItem(index, Font::ColorDefault);
-				contents->TextDraw(GetWidth() - 16, 16 * index + 2, font, std::to_string(value), Text::AlignRight);
-			}
-			break;
-		case eItem:
-			{
-				auto value = Main_Data::game_party->GetItemCount(first_var + index);
-				auto font = (value == 0) ? Font::ColorCritical : Font::ColorDefault;
-				DrawItem(index, Font::ColorDefault);
-				contents->TextDraw(GetWidth() - 16, 16 * index + 2, font, std::to_string(value), Text::AlignRight);
-			}
-			break;
-		case eTroop:
-		case eMap:
-		case eHeal:
-		case eCommonEvent:
-		case eMapEvent:
-			{
-				DrawItem(index, Font::ColorDefault);
-				contents->TextDraw(GetWidth() - 16, 16 * index + 2, Font::ColorDefault, "", Text::AlignRight);
-			}
-			break;
-		case eNone:
+			return Main_Data::game_variables->GetRevision();
+		default:
 			break;
 	}
+	return -1;
+}
+
+void Window_VarList::DrawItemValue(int index){
+	Row row;
+	row.valid = DataIsValid(first_var + index);
+	if (row.valid) {
+		row.name = commands[index];
+		switch (mode) {
+			case eSwitch:
+				{
+					auto value = Main_Data::game_switches->Get(first_var + index);
+					row.color = (!value) ? Font::ColorCritical : Font::ColorDefault;
+					row.value = value ? "[ON]" : "[OFF]";
+				}
+				break;
+			case eVariable:
+				{
+					auto value = Main_Data::game_variables->Get(first_var + index);
+					row.color = (value < 0) ? Font::ColorCritical : Font::ColorDefault;
+					row.value = std::to_string(value);
+				}
+				break;
+			case eItem:
+				{
+					auto value = Main_Data::game_party->GetItemCount(first_var + index);
+					row.color = (value == 0) ? Font::ColorCritical : Font::ColorDefault;
+					row.value = std::to_string(value);
+				}
+				break;
+			case eTroop:
+			case eMap:
+			case eHeal:
+			case eCommonEvent:
+			case eMapEvent:
+			case eNone:
+				break;
+		}
+	}
+
+	auto& drawn = rows[index];
+	if (row.valid == drawn.valid && row.name == drawn.name && row.value == drawn.value && row.color == drawn.color) {
+		return;
+	}
+	drawn = std::move(row);
+
+	if (!drawn.valid) {
+		contents->ClearRect(Rect(0, 16 * index, contents->GetWidth(), 16));
+		return;
+	}
+	DrawItem(index, Font::ColorDefault);
+	if (!drawn.value.empty()) {
+		contents->TextDraw(GetWidth() - 16, 16 * index + 2, drawn.color, drawn.value, Text::AlignRight);
+	}
 }
 
 void Window_VarList::UpdateList(int first_value){
 	static std::stringstream ss;
 	first_var = first_value;
+	drawn_revision = -1;
 	int map_idx = 0;
 	if (mode == eMap) {
 		auto iter = std::lower_bound(lcf::Data::treemap.maps.begin(), lcf::Data::treemap.maps.end(), first_value,
@@ -145,12 +171,13 @@ void Window_VarList::UpdateList(int first_value){
 			default:
 				break;
 		}
-		this->SetItemText(i, ss.str());
+		commands[i] = ss.str();
 	}
 }
 
 void Window_VarList::SetMode(Mode mode) {
 	this->mode = mode;
+	drawn_revision = -1;
 	SetVisible((mode != eNone));
 	Refresh();
 }
@@ -19,6 +19,7 @@
 #define EP_WINDOW_VARLIST_H
 
 // Headers
+#include <string>
 #include "window_command.h"
 
 class Window_VarList : public Window_Command
@@ -46,15 +47,18 @@ public:
 
 	/**
 	 * UpdateList.
-	 * 
+	 * Only formats the names of the visible rows, call Refresh to draw them.
+	 *
 	 * @param first_value starting value.
 	 */
 	void UpdateList(int first_value);
 
 	/**
 	 * Refreshes the window contents.
+	 * Only rows whose name or value changed since the last call are redrawn.
+	 * Switch and variable values are only read when their revision changed.
 	 */
-	void  Refresh();
+	void Refresh();
 
 	/**
 	 * Indicate what to display.
@@ -69,17 +73,32 @@ public:
 	Mode GetMode() const;
 
 private:
+	/** Text drawn on a row */
+	struct Row {
+		bool valid = false;
+		std::string name;
+		std::string value;
+		Font::SystemColor color = Font::ColorDefault;
+	};
 
 	/**
 	 * Draws the value of a variable standing on a row.
+	 * Does nothing when the row looks like the last time it was drawn.
 	 *
 	 * @param index row with the var
 	 */
 	void DrawItemValue(int index);
 
+	/** @return revision of the displayed values, -1 when not tracked */
+	int GetValueRevision() const;
+
 	Mode mode = eNone;
 	int first_var = 0;
 
+	std::vector<Row> rows;
+	/** Value revision of the last Refresh, -1 when rows must be compared */
+	int drawn_revision = -1;
+
 	bool DataIsValid(int range_index);
 
 };
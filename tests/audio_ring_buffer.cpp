@@ -0,0 +1,56 @@
+#include <vector>
+#include "audio_ring_buffer.h"
+#include "doctest.h"
+
+TEST_SUITE_BEGIN("AudioRingBuffer");
+
+TEST_CASE("Empty") {
+	AudioRingBuffer buffer;
+	float sample = 1.0f;
+
+	REQUIRE_EQ(buffer.Write(&sample, 1), 0);
+	REQUIRE_EQ(buffer.Read(&sample, 1), 0);
+	REQUIRE_EQ(buffer.GetReadAvailable(), 0);
+}
+
+TEST_CASE("WrapAround") {
+	AudioRingBuffer buffer;
+	buffer.Resize(8);
+
+	std::vector<float> in = { 1, 2, 3, 4, 5, 6 };
+	std::vector<float> out(8);
+
+	REQUIRE_EQ(buffer.Write(in.data(), 6), 6);
+	REQUIRE_EQ(buffer.Read(out.data(), 4), 4);
+	REQUIRE_EQ(out[0], 1);
+	REQUIRE_EQ(out[3], 4);
+
+	// Only 6 of 8 fit, the write continues at the front
+	in = { 7, 8, 9, 10, 11, 12, 13, 14 };
+	REQUIRE_EQ(buffer.GetWriteAvailable(), 6);
+	REQUIRE_EQ(buffer.Write(in.data(), 8), 6);
+	REQUIRE_EQ(buffer.GetWriteAvailable(), 0);
+
+	REQUIRE_EQ(buffer.Read(out.data(), 8), 8);
+	REQUIRE_EQ(out, std::vector<float>{ 5, 6, 7, 8, 9, 10, 11, 12 });
+	REQUIRE_EQ(buffer.GetReadAvailable(), 0);
+}
+
+TEST_CASE("Clear") {
+	AudioRingBuffer buffer;
+	buffer.Resize(4);
+
+	std::vector<float> in = { 1, 2, 3 };
+	buffer.Write(in.data(), 3);
+	buffer.Clear();
+	REQUIRE_EQ(buffer.GetReadAvailable(), 0);
+	REQUIRE_EQ(buffer.GetWriteAvailable(), 4);
+
+	float sample = 0.0f;
+	in = { 4 };
+	buffer.Write(in.data(), 1);
+	REQUIRE_EQ(buffer.Read(&sample, 1), 1);
+	REQUIRE_EQ(sample, 4);
+}
+
+TEST_SUITE_END();
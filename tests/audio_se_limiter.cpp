@@ -0,0 +1,55 @@
+#include "audio_se_limiter.h"
+#include "doctest.h"
+
+TEST_SUITE_BEGIN("AudioSeLimiter");
+
+TEST_CASE("SameFrame") {
+	AudioSeLimiter limiter;
+
+	REQUIRE(limiter.Request("a", 1).action == AudioSeLimiter::Action::Play);
+	limiter.Start(0, "a", 1);
+
+	REQUIRE(limiter.Request("a", 1).action == AudioSeLimiter::Action::Drop);
+	REQUIRE(limiter.Request("b", 1).action == AudioSeLimiter::Action::Play);
+	REQUIRE(limiter.Request("a", 2).action == AudioSeLimiter::Action::Play);
+}
+
+TEST_CASE("Retrigger") {
+	AudioSeLimiter limiter;
+
+	for (int i = 0; i < AudioSeLimiter::max_instances; ++i) {
+		limiter.Start(10 + i, "a", i);
+	}
+
+	auto decision = limiter.Request("a", 100);
+	REQUIRE(decision.action == AudioSeLimiter::Action::Retrigger);
+	REQUIRE_EQ(decision.voice, 10);
+
+	// Restarted on the same voice, the next oldest is replaced next
+	limiter.Start(10, "a", 100);
+	decision = limiter.Request("a", 101);
+	REQUIRE(decision.action == AudioSeLimiter::Action::Retrigger);
+	REQUIRE_EQ(decision.voice, 11);
+}
+
+TEST_CASE("RemoveFinished") {
+	AudioSeLimiter limiter;
+
+	for (int i = 0; i < AudioSeLimiter::max_instances; ++i) {
+		limiter.Start(i, "a", i);
+	}
+	limiter.Start(5, "b", 0);
+	REQUIRE_EQ(limiter.GetOldest(), 0);
+
+	limiter.RemoveFinished([](int voice) { return voice != 1; });
+	REQUIRE(limiter.Request("a", 100).action == AudioSeLimiter::Action::Play);
+	REQUIRE_EQ(limiter.GetOldest(), 0);
+
+	limiter.Stop(0);
+	REQUIRE_EQ(limiter.GetOldest(), 2);
+
+	limiter.Clear();
+	REQUIRE_EQ(limiter.GetOldest(), -1);
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,99 @@
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include "audio_simd.h"
+#include "cpu_features.h"
+#include "doctest.h"
+
+TEST_SUITE_BEGIN("AudioSimd");
+
+namespace {
+
+std::vector<int16_t> MakeSamples(int count) {
+	std::vector<int16_t> samples(count);
+	uint32_t state = 0x12345678;
+	for (auto& s: samples) {
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		s = static_cast<int16_t>(state);
+	}
+	samples[0] = -32768;
+	samples[1] = 32767;
+	return samples;
+}
+
+std::vector<float> MakeMixer(int count) {
+	std::vector<float> mixer(count);
+	for (int i = 0; i < count; ++i) {
+		mixer[i] = (i % 19) / 9.0f - 1.0f;
+	}
+	return mixer;
+}
+
+}
+
+// Odd lengths cover the scalar tail of the vector kernels
+TEST_CASE("MixS16") {
+	const auto samples = MakeSamples(333);
+	for (bool overwrite: { false, true }) {
+		auto expected = MakeMixer(333);
+		auto actual = expected;
+		AudioSimd::MixS16Scalar(expected.data(), samples.data(), 333, 0.7f / 32768.0f, overwrite);
+		AudioSimd::MixS16(actual.data(), samples.data(), 333, 0.7f / 32768.0f, overwrite);
+		for (size_t i = 0; i < expected.size(); ++i) {
+			REQUIRE_EQ(expected[i], doctest::Approx(actual[i]));
+		}
+	}
+}
+
+TEST_CASE("MixF32") {
+	const auto src = MakeMixer(331);
+	for (bool overwrite: { false, true }) {
+		auto expected = MakeMixer(331);
+		std::reverse(expected.begin(), expected.end());
+		auto actual = expected;
+		AudioSimd::MixF32Scalar(expected.data(), src.data(), 331, 0.3f, overwrite);
+		AudioSimd::MixF32(actual.data(), src.data(), 331, 0.3f, overwrite);
+		for (size_t i = 0; i < expected.size(); ++i) {
+			REQUIRE_EQ(expected[i], doctest::Approx(actual[i]));
+		}
+	}
+}
+
+TEST_CASE("ToS16") {
+	// Out of range samples saturate
+	auto mixer = MakeMixer(335);
+	for (size_t i = 0; i < mixer.size(); i += 5) {
+		mixer[i] *= 3.0f;
+	}
+	mixer[3] = 1.0f;
+	mixer[4] = -1.0f;
+	mixer[5] = 1e10f;
+
+	std::vector<int16_t> expected(mixer.size());
+	std::vector<int16_t> actual(mixer.size());
+	AudioSimd::ToS16Scalar(expected.data(), mixer.data(), static_cast<int>(mixer.size()));
+	AudioSimd::ToS16(actual.data(), mixer.data(), static_cast<int>(mixer.size()));
+	REQUIRE(expected == actual);
+	REQUIRE_EQ(actual[3], 32767);
+	REQUIRE_EQ(actual[4], -32768);
+	REQUIRE_EQ(actual[5], 32767);
+}
+
+TEST_CASE("CpuOverride") {
+	REQUIRE_FALSE(CpuFeatures::SetOverride("mmx"));
+	REQUIRE(CpuFeatures::SetOverride("none"));
+	REQUIRE_FALSE(CpuFeatures::HasSSE2());
+	REQUIRE_FALSE(CpuFeatures::HasAVX2());
+	REQUIRE_FALSE(CpuFeatures::HasNEON());
+	REQUIRE_EQ(CpuFeatures::GetDescription(), "none");
+
+	REQUIRE(CpuFeatures::SetOverride("sse2"));
+	REQUIRE_FALSE(CpuFeatures::HasAVX2());
+	REQUIRE_FALSE(CpuFeatures::HasNEON());
+
+	REQUIRE(CpuFeatures::SetOverride("auto"));
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,92 @@
+#include "test_mock_actor.h"
+#include "battle_simulator.h"
+#include "game_battle.h"
+#include "doctest.h"
+
+namespace {
+
+void MakeTroop(int hp, int atk) {
+	auto* enemy = MakeDBEnemy(1, hp, 0, atk, 10, 10, 10);
+	lcf::rpg::EnemyAction action;
+	action.kind = lcf::rpg::EnemyAction::Kind_basic;
+	action.basic = lcf::rpg::EnemyAction::Basic_attack;
+	action.condition_type = lcf::rpg::EnemyAction::ConditionType_always;
+	action.rating = 5;
+	enemy->actions.push_back(action);
+
+	auto& tp = lcf::Data::troops[0];
+	tp.members.resize(1);
+	tp.members[0].enemy_id = 1;
+}
+
+Game_Actor* MakeParty(int hp, int atk) {
+	Main_Data::game_party->AddActor(1);
+	auto* actor = Main_Data::game_actors->GetActor(1);
+	actor->SetBaseMaxHp(hp);
+	actor->SetHp(actor->GetMaxHp());
+	actor->SetBaseAtk(atk);
+	actor->SetBaseDef(10);
+	actor->SetBaseSpi(10);
+	actor->SetBaseAgi(10);
+	return actor;
+}
+
+BattleSimulator::Config MakeConfig(int battles) {
+	BattleSimulator::Config config;
+	config.troop_id = 1;
+	config.battles = battles;
+	config.seed = 1234;
+	return config;
+}
+
+}
+
+TEST_SUITE_BEGIN("BattleSimulator");
+
+TEST_CASE("Victory") {
+	const MockActor m;
+	MakeTroop(50, 1);
+	auto* actor = MakeParty(500, 200);
+
+	auto result = BattleSimulator::Run(MakeConfig(20));
+
+	CHECK_EQ(result.battles, 20);
+	CHECK_EQ(result.victories, 20);
+	CHECK_EQ(result.defeats, 0);
+	CHECK_EQ(result.GetWinRate(), 1.0);
+	CHECK_GE(result.damage_dealt, 20 * 50);
+	CHECK_GT(result.turns, 0);
+
+	// The party is restored after the simulation
+	CHECK_EQ(actor->GetHp(), 500);
+	CHECK_FALSE(Game_Battle::IsBattleRunning());
+	CHECK(Main_Data::game_enemyparty->GetEnemies().empty());
+}
+
+TEST_CASE("Defeat") {
+	const MockActor m;
+	MakeTroop(5000, 500);
+	MakeParty(10, 1);
+
+	auto result = BattleSimulator::Run(MakeConfig(10));
+
+	CHECK_EQ(result.defeats + result.timeouts, 10);
+	CHECK_EQ(result.victories, 0);
+	CHECK_GT(result.damage_taken, 0);
+}
+
+TEST_CASE("Deterministic") {
+	const MockActor m;
+	MakeTroop(300, 30);
+	MakeParty(300, 30);
+
+	auto first = BattleSimulator::Run(MakeConfig(50));
+	auto second = BattleSimulator::Run(MakeConfig(50));
+
+	CHECK_EQ(first.victories, second.victories);
+	CHECK_EQ(first.turns, second.turns);
+	CHECK_EQ(first.damage_dealt, second.damage_dealt);
+	CHECK_EQ(first.damage_taken, second.damage_taken);
+}
+
+TEST_SUITE_END();
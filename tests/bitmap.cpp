@@ -0,0 +1,314 @@
+#include <cmath>
+#include <cstdint>
+#include <sstream>
+#include <vector>
+#include "bitmap.h"
+#include "bitmap_atlas.h"
+#include "bitmap_wrap.h"
+#include "bitmap_kernels.h"
+#include "bitmap_hslrgb.h"
+#include "graphics.h"
+#include "pixel_format.h"
+#include "doctest.h"
+
+TEST_SUITE_BEGIN("Bitmap");
+
+namespace {
+
+BitmapRef MakeBitmap(int width, int height) {
+	auto bitmap = Bitmap::Create(width, height, true);
+	uint32_t state = 0x2468ACE;
+	for (int y = 0; y < height; ++y) {
+		auto* row = reinterpret_cast<uint32_t*>(static_cast<uint8_t*>(bitmap->pixels()) + y * bitmap->pitch());
+		for (int x = 0; x < width; ++x) {
+			state ^= state << 13;
+			state ^= state >> 17;
+			state ^= state << 5;
+			// Premultiplied, the color channels do not exceed alpha
+			const uint8_t a = (x % 3 == 0) ? 255 : state >> 24;
+			row[x] = Bitmap::pixel_format.rgba_to_uint32_t((state & 0xFF) * a / 255,
+					((state >> 8) & 0xFF) * a / 255, ((state >> 16) & 0xFF) * a / 255, a);
+		}
+	}
+	return bitmap;
+}
+
+uint32_t GetPixel(const Bitmap& bitmap, int x, int y) {
+	return reinterpret_cast<const uint32_t*>(static_cast<const uint8_t*>(bitmap.pixels()) + y * bitmap.pitch())[x];
+}
+
+}
+
+TEST_CASE("ZoomOpacityBlitInteger") {
+	Bitmap::SetFormat(format_R8G8B8A8_a().format());
+	auto src = MakeBitmap(13, 9);
+	const Rect src_rect(2, 1, 10, 7);
+
+	for (int zoom: { 1, 2, 3 }) {
+		// An empty destination receives the source pixels unchanged
+		auto dst = Bitmap::Create(24, 20, true);
+		dst->ZoomOpacityBlit(4, 5, 2, 3, *src, src_rect, zoom, zoom, Opacity::Opaque());
+
+		for (int y = 0; y < dst->GetHeight(); ++y) {
+			for (int x = 0; x < dst->GetWidth(); ++x) {
+				const int sx = x - (4 - 2 * zoom);
+				const int sy = y - (5 - 3 * zoom);
+				uint32_t expected = 0;
+				if (sx >= 0 && sy >= 0 && sx < src_rect.width * zoom && sy < src_rect.height * zoom) {
+					expected = GetPixel(*src, src_rect.x + sx / zoom, src_rect.y + sy / zoom);
+				}
+				REQUIRE_EQ(GetPixel(*dst, x, y), expected);
+			}
+		}
+	}
+}
+
+TEST_CASE("FlipBlit") {
+	Bitmap::SetFormat(format_R8G8B8A8_a().format());
+	auto src = MakeBitmap(13, 9);
+	const Rect src_rect(3, 2, 8, 6);
+
+	for (bool horizontal: { false, true }) {
+		for (bool vertical: { false, true }) {
+			auto dst = Bitmap::Create(src_rect.width, src_rect.height, true);
+			dst->FlipBlit(0, 0, *src, src_rect, horizontal, vertical, Opacity::Opaque());
+
+			for (int y = 0; y < src_rect.height; ++y) {
+				for (int x = 0; x < src_rect.width; ++x) {
+					const int sx = src_rect.x + (horizontal ? src_rect.width - 1 - x : x);
+					const int sy = src_rect.y + (vertical ? src_rect.height - 1 - y : y);
+					REQUIRE_EQ(GetPixel(*dst, x, y), GetPixel(*src, sx, sy));
+				}
+			}
+		}
+	}
+}
+
+TEST_CASE("WaverBlit") {
+	Bitmap::SetFormat(format_R8G8B8A8_a().format());
+	auto src = MakeBitmap(20, 40);
+	const Rect src_rect(1, 2, 18, 36);
+	const int depth = 3;
+	const double phase = 0.7;
+
+	for (int y: { 4, -5 }) {
+		// An empty destination receives the shifted source rows
+		auto dst = Bitmap::Create(24, 30, true);
+		dst->WaverBlit(3, y, 1.0, 1.0, *src, src_rect, depth, phase, Opacity::Opaque());
+
+		const int yclip = y < 0 ? -y : 0;
+		for (int dy = 0; dy < dst->GetHeight(); ++dy) {
+			const int i = dy - y;
+			const int offset = (i >= 0 && i < src_rect.height)
+				? static_cast<int>(2 * depth * std::sin(phase + (i - yclip) * (2 * M_PI) / 32.0)) : 0;
+			for (int x = 0; x < dst->GetWidth(); ++x) {
+				const int sx = x - 3 - offset;
+				uint32_t expected = 0;
+				if (i >= 0 && i < src_rect.height && sx >= 0 && sx < src_rect.width) {
+					expected = GetPixel(*src, src_rect.x + sx, src_rect.y + i);
+				}
+				REQUIRE_EQ(GetPixel(*dst, x, dy), expected);
+			}
+		}
+	}
+}
+
+TEST_CASE("Flip") {
+	Bitmap::SetFormat(format_R8G8B8A8_a().format());
+	auto src = MakeBitmap(13, 9);
+
+	for (bool horizontal: { false, true }) {
+		for (bool vertical: { false, true }) {
+			auto bitmap = Bitmap::Create(*src, src->GetRect(), true);
+			bitmap->Flip(horizontal, vertical);
+
+			for (int y = 0; y < src->GetHeight(); ++y) {
+				for (int x = 0; x < src->GetWidth(); ++x) {
+					const int sx = horizontal ? src->GetWidth() - 1 - x : x;
+					const int sy = vertical ? src->GetHeight() - 1 - y : y;
+					REQUIRE_EQ(GetPixel(*bitmap, x, y), GetPixel(*src, sx, sy));
+				}
+			}
+		}
+	}
+}
+
+TEST_CASE("HueChangeBlit") {
+	Bitmap::SetFormat(format_R8G8B8A8_a().format());
+	auto src = MakeBitmap(40, 9);
+
+	for (int hue: { 0, 120, -75 }) {
+		auto dst = Bitmap::Create(src->GetWidth(), src->GetHeight(), true);
+		dst->HueChangeBlit(0, 0, *src, src->GetRect(), hue);
+
+		const int hsl_hue = (hue / 60.0 * 0x100) + (hue < 0 ? 0x600 : 0);
+		for (int y = 0; y < src->GetHeight(); ++y) {
+			for (int x = 0; x < src->GetWidth(); ++x) {
+				uint8_t r, g, b, a;
+				Bitmap::pixel_format.uint32_to_rgba(GetPixel(*src, x, y), r, g, b, a);
+				if (a > 0) {
+					RGB_adjust_HSL(r, g, b, hsl_hue);
+				}
+				REQUIRE_EQ(GetPixel(*dst, x, y), Bitmap::pixel_format.rgba_to_uint32_t(r, g, b, a));
+			}
+		}
+	}
+}
+
+TEST_CASE("BlitKernels") {
+	for (auto format: { format_R8G8B8A8_a().format(), format_A8R8G8B8_a().format() }) {
+		Bitmap::SetFormat(format);
+		auto* kernels = BitmapKernels::Select(format);
+		REQUIRE(kernels != nullptr);
+		REQUIRE(kernels != &BitmapKernels::Dynamic());
+
+		auto src = MakeBitmap(64, 2);
+		const auto* src_row = static_cast<const uint32_t*>(src->pixels());
+		const auto* dst_row = src_row + src->pitch() / sizeof(uint32_t);
+		const uint32_t color = Bitmap::pixel_format.rgba_to_uint32_t(64, 32, 16, 128);
+
+		for (int opacity: { 0, 77, 255 }) {
+			std::vector<uint32_t> expected(dst_row, dst_row + 64);
+			std::vector<uint32_t> actual(expected);
+			BitmapKernels::Dynamic().over(expected.data(), src_row + 63, 64, -1, opacity, 0);
+			kernels->over(actual.data(), src_row + 63, 64, -1, opacity, 0);
+			REQUIRE(expected == actual);
+		}
+
+		std::vector<uint32_t> expected(dst_row, dst_row + 64);
+		std::vector<uint32_t> actual(expected);
+		BitmapKernels::Dynamic().blend(expected.data(), src_row, 64, color, 0);
+		kernels->blend(actual.data(), src_row, 64, color, 0);
+		REQUIRE(expected == actual);
+	}
+
+	REQUIRE(BitmapKernels::Select(format_R8G8B8A8_n().format()) == nullptr);
+}
+
+TEST_CASE("WrapTiledBlit") {
+	Bitmap::SetFormat(format_R8G8B8A8_a().format());
+	auto src = MakeBitmap(13, 9);
+	const Rect dst_rect(2, 1, 30, 20);
+
+	BitmapWrap wrap;
+	for (int offset: { 0, 5, -7, 12, 40, -100 }) {
+		auto expected = Bitmap::Create(34, 22, Color(20, 40, 60, 255));
+		auto result = Bitmap::Create(34, 22, Color(20, 40, 60, 255));
+		expected->TiledBlit(offset, offset / 2, src->GetRect(), *src, dst_rect, 200);
+		wrap.TiledBlit(*result, offset, offset / 2, src, dst_rect, 200);
+
+		for (int y = 0; y < result->GetHeight(); ++y) {
+			for (int x = 0; x < result->GetWidth(); ++x) {
+				REQUIRE_EQ(GetPixel(*result, x, y), GetPixel(*expected, x, y));
+			}
+		}
+	}
+}
+
+TEST_CASE("ScaleBlit") {
+	Bitmap::SetFormat(format_R8G8B8A8_a().format());
+	auto src = MakeBitmap(13, 9);
+	const Rect src_rect(2, 1, 10, 7);
+
+	for (int zoom: { 1, 2, 3 }) {
+		for (int bands: { 1, 3 }) {
+			auto dst = Bitmap::Create(40, 30, true);
+			dst->ScaleBlit(4, 5, *src, src_rect, zoom, bands);
+
+			for (int y = 0; y < dst->GetHeight(); ++y) {
+				for (int x = 0; x < dst->GetWidth(); ++x) {
+					const int sx = x - 4;
+					const int sy = y - 5;
+					uint32_t expected = 0;
+					if (sx >= 0 && sy >= 0 && sx < src_rect.width * zoom && sy < src_rect.height * zoom) {
+						expected = GetPixel(*src, src_rect.x + sx / zoom, src_rect.y + sy / zoom);
+					}
+					REQUIRE_EQ(GetPixel(*dst, x, y), expected);
+				}
+			}
+		}
+	}
+}
+
+TEST_CASE("AtlasPack") {
+	Bitmap::SetFormat(format_R8G8B8A8_a().format());
+	BitmapAtlas atlas;
+
+	auto src = MakeBitmap(40, 30);
+	src->CheckPixels(Bitmap::Flag_ReadOnly);
+	auto view = atlas.Pack(src);
+	REQUIRE_NE(view, src);
+	REQUIRE_EQ(view->GetWidth(), 40);
+	REQUIRE_EQ(view->GetHeight(), 30);
+	REQUIRE_EQ(view->GetImageOpacity(), src->GetImageOpacity());
+	REQUIRE(view->GetViewSource() != nullptr);
+	for (int y = 0; y < src->GetHeight(); ++y) {
+		for (int x = 0; x < src->GetWidth(); ++x) {
+			REQUIRE_EQ(GetPixel(*view, x, y), GetPixel(*src, x, y));
+		}
+	}
+
+	// Images share a page without overlapping
+	auto other = atlas.Pack(src);
+	REQUIRE_EQ(other->GetViewSource(), view->GetViewSource());
+	REQUIRE(other->GetViewRect().IsOutOfBounds(view->GetViewRect()));
+
+	// The space of a freed view is reused
+	const auto rect = other->GetViewRect();
+	other.reset();
+	REQUIRE_EQ(atlas.Pack(src)->GetViewRect(), rect);
+	REQUIRE_EQ(atlas.GetPageCount(), 1);
+
+	// Large and writable images are not packed
+	auto large = MakeBitmap(BitmapAtlas::max_image_size + 1, 8);
+	large->CheckPixels(Bitmap::Flag_ReadOnly);
+	REQUIRE_EQ(atlas.Pack(large), large);
+	auto writable = MakeBitmap(8, 8);
+	REQUIRE_EQ(atlas.Pack(writable), writable);
+}
+
+TEST_CASE("WritePNGCompression") {
+	Bitmap::SetFormat(format_R8G8B8A8_a().format());
+	auto bitmap = Bitmap::Create(64, 32, Color(40, 80, 120, 255));
+
+	auto write = [&](int compression) {
+		auto* buf = new std::stringbuf();
+		Filesystem_Stream::OutputStream os(buf);
+		REQUIRE(bitmap->WritePNG(os, compression));
+		return buf->str();
+	};
+
+	const auto stored = write(0);
+	const auto compressed = write(9);
+	REQUIRE_EQ(stored.compare(0, 4, "\x89PNG"), 0);
+	REQUIRE_EQ(compressed.compare(0, 4, "\x89PNG"), 0);
+	// Uncompressed deflate blocks hold at least the RGB rows
+	REQUIRE_GE(stored.size(), 64u * 32u * 3u);
+	REQUIRE_LT(compressed.size(), stored.size());
+
+	std::vector<uint32_t> pixels;
+	bitmap->GetPNGPixels(pixels);
+	REQUIRE_EQ(pixels.size(), 64u * 32u);
+}
+
+TEST_CASE("UploadKeepsRevision") {
+	Bitmap::SetFormat(format_R8G8B8A8_a().format());
+	auto surface = Bitmap::Create(16, 8, Color(0, 0, 0, 255));
+
+	// A display uploads the frame and remembers its revision
+	const Bitmap& uploaded = *surface;
+	REQUIRE(uploaded.pixels() != nullptr);
+	const uint32_t revision = surface->GetRevision();
+
+	// Presenting again without a draw uploads nothing
+	REQUIRE(uploaded.pixels() != nullptr);
+	CHECK_EQ(surface->GetRevision(), revision);
+	CHECK(Graphics::GetSurfaceDamage(*surface, revision).IsEmpty());
+
+	// Write access is a change of the whole surface
+	surface->pixels();
+	CHECK_NE(surface->GetRevision(), revision);
+	CHECK(Graphics::GetSurfaceDamage(*surface, revision) == surface->GetRect());
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,162 @@
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include "bitmap_simd.h"
+#include "doctest.h"
+
+TEST_SUITE_BEGIN("BitmapSimd");
+
+namespace {
+
+std::vector<uint32_t> MakePixels(int count) {
+	std::vector<uint32_t> pixels(count);
+	uint32_t state = 0x12345678;
+	for (auto& px: pixels) {
+		// xorshift, deterministic and covers all channel values
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		px = state;
+	}
+	// Some pixels with alpha 0 for the check_alpha paths
+	for (int i = 0; i < count; i += 7) {
+		pixels[i] &= 0x00FFFFFF;
+		pixels[i + 1 < count ? i + 1 : i] &= 0xFFFFFF00;
+	}
+	return pixels;
+}
+
+void TestTone(Tone tone, bool check_alpha) {
+	BitmapSimd::ToneParams params;
+	params.tone = tone;
+	params.saturation = tone.gray != 128;
+	params.color = tone.red != 128 || tone.green != 128 || tone.blue != 128;
+	params.check_alpha = check_alpha;
+
+	const int shifts[][4] = { { 0, 8, 16, 24 }, { 16, 8, 0, 24 }, { 24, 16, 8, 0 } };
+	for (auto& s: shifts) {
+		params.rs = s[0];
+		params.gs = s[1];
+		params.bs = s[2];
+		params.as = s[3];
+
+		// Odd length to cover the scalar tail of the vector kernels
+		auto expected = MakePixels(331);
+		auto actual = expected;
+
+		BitmapSimd::ToneRowScalar(expected.data(), static_cast<int>(expected.size()), params);
+		BitmapSimd::ToneRow(actual.data(), static_cast<int>(actual.size()), params);
+
+		REQUIRE(expected == actual);
+	}
+}
+
+}
+
+TEST_CASE("ToneRowColor") {
+	for (bool check_alpha: { false, true }) {
+		TestTone(Tone(0, 0, 0, 128), check_alpha);
+		TestTone(Tone(255, 255, 255, 128), check_alpha);
+		TestTone(Tone(64, 129, 200, 128), check_alpha);
+		TestTone(Tone(128, 128, 0, 128), check_alpha);
+	}
+}
+
+TEST_CASE("ToneRowSaturation") {
+	for (bool check_alpha: { false, true }) {
+		TestTone(Tone(128, 128, 128, 0), check_alpha);
+		TestTone(Tone(128, 128, 128, 77), check_alpha);
+		TestTone(Tone(128, 128, 128, 255), check_alpha);
+	}
+}
+
+TEST_CASE("ToneRowSaturationColor") {
+	for (bool check_alpha: { false, true }) {
+		TestTone(Tone(0, 100, 255, 0), check_alpha);
+		TestTone(Tone(255, 0, 130, 200), check_alpha);
+		TestTone(Tone(127, 129, 128, 129), check_alpha);
+	}
+}
+
+TEST_CASE("BlendRow") {
+	auto src1 = MakePixels(331);
+	auto src2 = src1;
+	std::reverse(src2.begin(), src2.end());
+
+	for (int opacity: { 0, 1, 77, 128, 254, 255 }) {
+		std::vector<uint32_t> expected(src1.size());
+		std::vector<uint32_t> actual(src1.size());
+
+		BitmapSimd::BlendRowScalar(expected.data(), src1.data(), src2.data(), static_cast<int>(expected.size()), opacity);
+		BitmapSimd::BlendRow(actual.data(), src1.data(), src2.data(), static_cast<int>(actual.size()), opacity);
+
+		REQUIRE(expected == actual);
+	}
+
+	std::vector<uint32_t> row(src1.size());
+	BitmapSimd::BlendRow(row.data(), src1.data(), src2.data(), static_cast<int>(row.size()), 0);
+	REQUIRE(row == src1);
+	BitmapSimd::BlendRow(row.data(), src1.data(), src2.data(), static_cast<int>(row.size()), 255);
+	REQUIRE(row == src2);
+}
+
+TEST_CASE("SelectRow") {
+	auto src1 = MakePixels(331);
+	auto src2 = src1;
+	std::reverse(src2.begin(), src2.end());
+
+	std::vector<uint8_t> mask(src1.size());
+	for (size_t i = 0; i < mask.size(); ++i) {
+		mask[i] = static_cast<uint8_t>(src1[i] >> 8);
+	}
+
+	for (int threshold: { -1, 0, 100, 254, 255 }) {
+		std::vector<uint32_t> expected(src1.size());
+		std::vector<uint32_t> actual(src1.size());
+
+		BitmapSimd::SelectRowScalar(expected.data(), src1.data(), src2.data(), mask.data(), threshold, static_cast<int>(expected.size()));
+		BitmapSimd::SelectRow(actual.data(), src1.data(), src2.data(), mask.data(), threshold, static_cast<int>(actual.size()));
+
+		REQUIRE(expected == actual);
+	}
+}
+
+TEST_CASE("AlphaRow") {
+	auto pixels = MakePixels(331);
+	// Runs of opaque and transparent pixels so that all tile kinds occur
+	for (int i = 0; i < 96; ++i) {
+		pixels[i] |= 0xFF000000;
+		pixels[i + 128] &= 0x00FFFFFF;
+	}
+
+	for (uint32_t alpha_mask: { 0xFF000000u, 0x000000FFu }) {
+		for (int tile_width: { 3, 16, 331 }) {
+			const int tiles = static_cast<int>(pixels.size()) / tile_width;
+			std::vector<uint32_t> expected_and(tiles, alpha_mask), expected_or(tiles, 0);
+			std::vector<uint32_t> actual_and(tiles, alpha_mask), actual_or(tiles, 0);
+
+			BitmapSimd::AlphaRowScalar(pixels.data(), tiles, tile_width, alpha_mask, expected_and.data(), expected_or.data());
+			BitmapSimd::AlphaRow(pixels.data(), tiles, tile_width, alpha_mask, actual_and.data(), actual_or.data());
+
+			REQUIRE(expected_and == actual_and);
+			REQUIRE(expected_or == actual_or);
+		}
+	}
+}
+
+TEST_CASE("ScaleRow") {
+	const auto pixels = MakePixels(331);
+
+	for (int zoom: { 1, 2, 3, 4, 5, 8, 9 }) {
+		std::vector<uint32_t> expected(pixels.size() * zoom);
+		std::vector<uint32_t> actual(pixels.size() * zoom);
+
+		BitmapSimd::ScaleRowScalar(expected.data(), pixels.data(), static_cast<int>(pixels.size()), zoom);
+		BitmapSimd::ScaleRow(actual.data(), pixels.data(), static_cast<int>(pixels.size()), zoom);
+
+		REQUIRE(expected == actual);
+		REQUIRE_EQ(actual[zoom * 5 + zoom - 1], pixels[5]);
+	}
+}
+
+TEST_SUITE_END();
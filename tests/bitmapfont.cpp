@@ -1,4 +1,5 @@
 #include "bitmapfont.h"
+#include "bitmapfont_table.h"
 #include <algorithm>
 #include <iterator>
 #include "doctest.h"
@@ -30,4 +31,37 @@ TEST_CASE("SortedTTYP0") {
 	REQUIRE(IsSorted(BITMAPFONT_TTYP0));
 }
 
+template <typename T>
+bool TableMatches(const T& glyphs) {
+	const BitmapFontTable table(glyphs);
+	for (char32_t code = 0; code <= 0x10000; ++code) {
+		auto it = std::lower_bound(std::begin(glyphs), std::end(glyphs), code);
+		const BitmapFontGlyph* expected = it != std::end(glyphs) && it->code == code ? &*it : nullptr;
+		if (table.Find(code) != expected) {
+			return false;
+		}
+	}
+	return true;
+}
+
+TEST_CASE("TableGothic") {
+	REQUIRE(TableMatches(SHINONOME_GOTHIC));
+}
+
+TEST_CASE("TableMincho") {
+	REQUIRE(TableMatches(SHINONOME_MINCHO));
+}
+
+TEST_CASE("TableWQY") {
+	REQUIRE(TableMatches(BITMAPFONT_WQY));
+}
+
+TEST_CASE("TableRMG2000") {
+	REQUIRE(TableMatches(BITMAPFONT_RMG2000));
+}
+
+TEST_CASE("TableTTYP0") {
+	REQUIRE(TableMatches(BITMAPFONT_TTYP0));
+}
+
 TEST_SUITE_END();
@@ -0,0 +1,135 @@
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#if defined(HAVE_THREADS) && !defined(_WIN32)
+#  include <csignal>
+#  include <fcntl.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+#include "capture.h"
+#include "bitmap.h"
+#include "pixel_format.h"
+#include "doctest.h"
+
+TEST_SUITE_BEGIN("Capture");
+
+namespace {
+
+uint32_t ReadU32(const std::string& data, size_t pos) {
+	uint32_t value = 0;
+	for (int i = 3; i >= 0; --i) {
+		value = (value << 8) | static_cast<uint8_t>(data[pos + i]);
+	}
+	return value;
+}
+
+}
+
+TEST_CASE("FramesAndAudio") {
+	Bitmap::SetFormat(format_R8G8B8A8_a().format());
+	const std::string path = "capture_test.bin";
+
+	auto surface = Bitmap::Create(8, 4, Color(10, 20, 30, 255));
+	const int16_t samples[4] = { 1, -1, 2, -2 };
+
+	REQUIRE(Capture::Start(path));
+	Capture::OnFrame(*surface);
+	// Nothing was drawn, only a repeat is written
+	Capture::OnFrame(*surface);
+	Capture::OnAudio(reinterpret_cast<const uint8_t*>(samples), sizeof(samples), 44100, 2);
+	Capture::Stop();
+	REQUIRE(!Capture::IsActive());
+
+	std::ifstream in(path, std::ios_base::binary);
+	const std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+	in.close();
+	std::remove(path.c_str());
+
+	REQUIRE_GE(data.size(), 28u);
+	CHECK_EQ(data.substr(0, 4), "EPCV");
+	CHECK_EQ(ReadU32(data, 8), 4u);
+
+	size_t pos = 28;
+	REQUIRE_EQ(data[pos], 'V');
+	REQUIRE_EQ(ReadU32(data, pos + 4), 8u + 8 * 4 * 4);
+	CHECK_EQ(ReadU32(data, pos + 16), 8u);
+	CHECK_EQ(ReadU32(data, pos + 20), 4u);
+	CHECK_EQ(std::memcmp(data.data() + pos + 24, surface->pixels(), 8 * 4), 0);
+	pos += 16 + ReadU32(data, pos + 4);
+
+	REQUIRE_EQ(data[pos], 'R');
+	REQUIRE_EQ(ReadU32(data, pos + 4), 0u);
+	pos += 16;
+
+	REQUIRE_EQ(data[pos], 'A');
+	REQUIRE_EQ(ReadU32(data, pos + 4), 8u + sizeof(samples));
+	CHECK_EQ(ReadU32(data, pos + 16), 44100u);
+	CHECK_EQ(ReadU32(data, pos + 20), 2u);
+	CHECK_EQ(std::memcmp(data.data() + pos + 24, samples, sizeof(samples)), 0);
+	pos += 16 + ReadU32(data, pos + 4);
+
+	CHECK_EQ(pos, data.size());
+}
+
+TEST_CASE("RepeatAfterPresent") {
+	Bitmap::SetFormat(format_R8G8B8A8_a().format());
+	const std::string path = "capture_test.bin";
+
+	auto surface = Bitmap::Create(8, 4, Color(10, 20, 30, 255));
+	const Bitmap& presented = *surface;
+
+	REQUIRE(Capture::Start(path));
+	Capture::OnFrame(*surface);
+	// The display reads the frame, nothing is drawn
+	REQUIRE(presented.pixels() != nullptr);
+	Capture::OnFrame(*surface);
+	// A drawn frame carries the pixels again
+	surface->Fill(Color(40, 50, 60, 255));
+	Capture::OnFrame(*surface);
+	Capture::Stop();
+
+	std::ifstream in(path, std::ios_base::binary);
+	const std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+	in.close();
+	std::remove(path.c_str());
+
+	const size_t frame_size = 16 + 8 + 8 * 4 * 4;
+	REQUIRE_EQ(data.size(), 28 + frame_size + 16 + frame_size);
+	CHECK_EQ(data[28], 'V');
+	CHECK_EQ(data[28 + frame_size], 'R');
+	CHECK_EQ(data[28 + frame_size + 16], 'V');
+	CHECK_EQ(std::memcmp(data.data() + 28 + frame_size + 16 + 24, presented.pixels(), 8 * 4), 0);
+}
+
+#if defined(HAVE_THREADS) && !defined(_WIN32)
+TEST_CASE("DropAudioWhenStalled") {
+	Bitmap::SetFormat(format_R8G8B8A8_a().format());
+	const std::string path = "capture_test.fifo";
+
+	std::remove(path.c_str());
+	REQUIRE_EQ(mkfifo(path.c_str(), 0600), 0);
+	// A reader that never reads, the writer blocks once the pipe is full
+	const int reader = open(path.c_str(), O_RDONLY | O_NONBLOCK);
+	REQUIRE_GE(reader, 0);
+	auto old_handler = std::signal(SIGPIPE, SIG_IGN);
+
+	const std::vector<uint8_t> samples(4096);
+	REQUIRE(Capture::Start(path));
+	for (int i = 0; i < 1024; ++i) {
+		Capture::OnAudio(samples.data(), static_cast<int>(samples.size()), 44100, 2);
+	}
+	CHECK_GT(Capture::GetDroppedAudio(), 0);
+
+	// Closing the reader fails the blocked write and lets Stop finish
+	close(reader);
+	Capture::Stop();
+	std::signal(SIGPIPE, old_handler);
+	std::remove(path.c_str());
+}
+#endif
+
+TEST_SUITE_END();
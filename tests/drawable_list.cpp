@@ -1,5 +1,10 @@
+#include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <memory>
 #include "utils.h"
 #include "drawable_list.h"
 #include "drawable_mgr.h"
@@ -16,6 +21,40 @@ class TestSprite : public Drawable {
 		void Draw(Bitmap&) override {}
 };
 
+class TestDamage : public Drawable {
+	public:
+		TestDamage(int z = 0) : Drawable(z, Drawable::Flags::Global) {}
+		void Draw(Bitmap&) override {}
+		Rect GetDamage(const Rect&) override { return damage; }
+
+		Rect damage;
+};
+
+class TestFill : public Drawable {
+	public:
+		TestFill(int z, Rect rect, Color color, bool bands)
+			: Drawable(z, Drawable::Flags::Global), rect(rect), color(color), bands(bands) {}
+		void Draw(Bitmap& dst) override { dst.FillRect(rect, color); }
+		bool PrepareBands() override { return bands; }
+
+		Rect rect;
+		Color color;
+		bool bands;
+};
+
+class TestBounds : public Drawable {
+	public:
+		TestBounds(Rect bounds) : Drawable(0, Drawable::Flags::Global), bounds(bounds) {}
+		void Draw(Bitmap&) override { ++draws; }
+		bool PrepareBands() override { return true; }
+		void DrawBand(Bitmap&) override { ++band_draws; }
+		Rect GetScreenBounds(const Rect&) const override { return bounds; }
+
+		Rect bounds;
+		int draws = 0;
+		std::atomic<int> band_draws = { 0 };
+};
+
 class TestFrame : public Drawable {
 	public:
 		TestFrame(int z = 0) : Drawable(z, Drawable::Flags::Global | Drawable::Flags::Shared) {}
@@ -350,4 +389,128 @@ TEST_CASE("TakeFromPred") {
 	REQUIRE(list2.IsDirty());
 }
 
+TEST_CASE("Damage") {
+	const Rect screen(0, 0, 320, 240);
+
+	DrawableList list;
+	TestDamage d1(1);
+	TestDamage d2(2);
+	list.Append(&d1);
+	list.Append(&d2);
+
+	// Changed lists damage everything
+	REQUIRE_EQ(list.GetDamage(screen, 0, 10), screen);
+	list.OnComposited(0, 10);
+	REQUIRE(list.GetDamage(screen, 0, 10).IsEmpty());
+
+	d1.damage = Rect(10, 10, 20, 20);
+	d2.damage = Rect(300, 200, 100, 100);
+	REQUIRE_EQ(list.GetDamage(screen, 0, 10), Rect(10, 10, 310, 230));
+	REQUIRE_EQ(list.GetDamage(screen, 0, 1), Rect(10, 10, 20, 20));
+
+	list.Take(&d2);
+	REQUIRE_EQ(list.GetDamage(screen, 0, 10), screen);
+}
+
+TEST_CASE("DrawBanded") {
+	Bitmap::SetFormat(format_R8G8B8A8_a().format());
+	Bitmap expected(64, 48, false);
+	Bitmap actual(64, 48, false);
+	expected.Clear();
+	actual.Clear();
+
+	DrawableList list;
+	TestFill f1(1, Rect(0, 0, 64, 48), Color(10, 20, 30, 255), true);
+	TestFill f2(2, Rect(5, 3, 40, 30), Color(200, 0, 0, 128), true);
+	TestFill f3(3, Rect(20, 10, 40, 35), Color(0, 200, 0, 100), false);
+	TestFill f4(4, Rect(-10, 20, 50, 50), Color(0, 0, 200, 180), true);
+	for (auto* d: std::initializer_list<Drawable*>{ &f4, &f2, &f3, &f1 }) {
+		list.Append(d);
+	}
+
+	const int min_z = std::numeric_limits<int>::min();
+	const int max_z = std::numeric_limits<int>::max();
+	list.Draw(expected, min_z, max_z);
+
+	for (int bands: { 1, 2, 3, 7, 48, 100 }) {
+		actual.Clear();
+		list.DrawBanded(actual, min_z, max_z, bands);
+		REQUIRE_EQ(memcmp(expected.pixels(), actual.pixels(), expected.pitch() * expected.height()), 0);
+	}
+
+	// Partial redraw of a clipped area
+	expected.SetClipRect(Rect(7, 9, 30, 20));
+	actual.SetClipRect(Rect(7, 9, 30, 20));
+	expected.Clear();
+	actual.Clear();
+	list.Draw(expected, min_z, max_z);
+	list.DrawBanded(actual, min_z, max_z, 4);
+	REQUIRE_EQ(memcmp(expected.pixels(), actual.pixels(), expected.pitch() * expected.height()), 0);
+}
+
+TEST_CASE("UpdateZ") {
+	DrawableList list;
+	DrawableMgr::SetLocalList(&list);
+
+	std::vector<std::unique_ptr<TestSprite>> sprites;
+	for (int i = 0; i < 20; ++i) {
+		sprites.emplace_back(new TestSprite(i % 5));
+		list.Append(sprites.back().get());
+	}
+	list.Sort();
+
+	std::vector<Drawable*> expected(list.begin(), list.end());
+	for (int i = 0; i < 200; ++i) {
+		auto* sprite = sprites[(i * 7) % sprites.size()].get();
+		sprite->SetZ((i * 13) % 6);
+		REQUIRE_FALSE(list.IsDirty());
+
+		// Must match a full stable sort of the previous order
+		std::stable_sort(expected.begin(), expected.end(), [](Drawable* l, Drawable* r) { return l->GetZ() < r->GetZ(); });
+		REQUIRE(std::equal(expected.begin(), expected.end(), list.begin()));
+	}
+
+	// Drawables not in the list mark it as dirty
+	TestSprite other(3);
+	other.SetZ(4);
+	REQUIRE(list.IsDirty());
+
+	DrawableMgr::SetLocalList(nullptr);
+}
+
+TEST_CASE("Culling") {
+	Bitmap::SetFormat(format_R8G8B8A8_a().format());
+	Bitmap dst(64, 48, false);
+
+	DrawableList list;
+	TestBounds inside(Rect(10, 10, 20, 20));
+	TestBounds partial(Rect(-10, 40, 20, 20));
+	TestBounds outside(Rect(64, 0, 20, 20));
+	TestBounds empty(Rect());
+	for (auto* d: std::initializer_list<Drawable*>{ &inside, &partial, &outside, &empty }) {
+		list.Append(d);
+	}
+
+	list.Draw(dst);
+	REQUIRE_EQ(inside.draws, 1);
+	REQUIRE_EQ(partial.draws, 1);
+	REQUIRE_EQ(outside.draws, 0);
+	REQUIRE_EQ(empty.draws, 0);
+
+	dst.SetClipRect(Rect(0, 0, 32, 8));
+	list.Draw(dst);
+	REQUIRE_EQ(inside.draws, 1);
+	REQUIRE_EQ(partial.draws, 1);
+
+	// Bands only draw the drawables they overlap with
+	dst.SetClipRect(Rect());
+	list.DrawBanded(dst, std::numeric_limits<int>::min(), std::numeric_limits<int>::max(), 4);
+#ifdef HAVE_THREADS
+	REQUIRE_EQ(inside.band_draws, 3);
+	REQUIRE_EQ(partial.band_draws, 1);
+#endif
+	REQUIRE_EQ(outside.band_draws + outside.draws, 0);
+	REQUIRE_EQ(empty.band_draws + empty.draws, 0);
+}
+
 TEST_SUITE_END();
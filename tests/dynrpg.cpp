@@ -185,6 +185,22 @@ TEST_CASE("easyrpg dynrpg invoke") {
 	DynRpg::Invoke("@unknownfunc 1, 2, 3");
 }
 
+TEST_CASE("easyrpg dynrpg invoke cached") {
+	const MockActor m;
+
+	std::vector<int32_t> vars = {3, 0};
+	Main_Data::game_variables->SetData(vars);
+	Main_Data::game_variables->SetWarning(0);
+
+	// The command is parsed once, the reference is resolved on every call
+	DynRpg::Invoke("@easyrpg_add 2, V1, 1");
+	CHECK(Main_Data::game_variables->Get(2) == 4);
+
+	Main_Data::game_variables->Set(1, 10);
+	DynRpg::Invoke("@easyrpg_add 2, V1, 1");
+	CHECK(Main_Data::game_variables->Get(2) == 11);
+}
+
 TEST_CASE("Incompatible changes") {
 	const MockActor m; // disable log
 
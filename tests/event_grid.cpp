@@ -0,0 +1,88 @@
+#include "event_grid.h"
+#include "doctest.h"
+
+TEST_SUITE_BEGIN("EventGrid");
+
+namespace {
+
+std::vector<int> CollectNext(const EventGrid& grid, int x, int y) {
+	std::vector<int> out;
+	for (int idx = grid.GetNext(x, y, -1); idx >= 0; idx = grid.GetNext(x, y, idx)) {
+		out.push_back(idx);
+	}
+	return out;
+}
+
+std::vector<int> CollectPrev(const EventGrid& grid, int x, int y) {
+	std::vector<int> out;
+	for (int idx = grid.GetPrev(x, y, -1); idx >= 0; idx = grid.GetPrev(x, y, idx)) {
+		out.push_back(idx);
+	}
+	return out;
+}
+
+}
+
+TEST_CASE("Empty") {
+	EventGrid grid;
+	REQUIRE_EQ(grid.GetNext(0, 0, -1), -1);
+	REQUIRE_EQ(grid.GetPrev(0, 0, -1), -1);
+
+	grid.Clear();
+	grid.Move(0, 1, 1);
+	REQUIRE_EQ(grid.GetNext(1, 1, -1), -1);
+}
+
+TEST_CASE("Order") {
+	EventGrid grid;
+	grid.Reset(4, 3, 5);
+	grid.Move(3, 2, 1);
+	grid.Move(0, 2, 1);
+	grid.Move(4, 2, 1);
+	grid.Move(1, 0, 0);
+
+	REQUIRE_EQ(CollectNext(grid, 2, 1), std::vector<int>{ 0, 3, 4 });
+	REQUIRE_EQ(CollectPrev(grid, 2, 1), std::vector<int>{ 4, 3, 0 });
+	REQUIRE_EQ(CollectNext(grid, 0, 0), std::vector<int>{ 1 });
+	REQUIRE(CollectNext(grid, 3, 2).empty());
+}
+
+TEST_CASE("Move") {
+	EventGrid grid;
+	grid.Reset(4, 3, 3);
+	grid.Move(0, 1, 1);
+	grid.Move(1, 1, 1);
+	grid.Move(2, 1, 1);
+
+	grid.Move(1, 2, 1);
+	REQUIRE_EQ(CollectNext(grid, 1, 1), std::vector<int>{ 0, 2 });
+	REQUIRE_EQ(CollectNext(grid, 2, 1), std::vector<int>{ 1 });
+
+	grid.Move(1, 1, 1);
+	REQUIRE_EQ(CollectNext(grid, 1, 1), std::vector<int>{ 0, 1, 2 });
+	REQUIRE(CollectNext(grid, 2, 1).empty());
+
+	// Indices outside of the grid are ignored
+	grid.Move(3, 1, 1);
+	REQUIRE_EQ(CollectNext(grid, 1, 1), std::vector<int>{ 0, 1, 2 });
+}
+
+TEST_CASE("Outside") {
+	EventGrid grid;
+	grid.Reset(4, 3, 3);
+	grid.Move(0, -1, 0);
+	grid.Move(1, 4, 0);
+	grid.Move(2, 0, 0);
+
+	// Positions outside of the map are not wrapped
+	REQUIRE_EQ(CollectNext(grid, -1, 0), std::vector<int>{ 0 });
+	REQUIRE_EQ(CollectNext(grid, 4, 0), std::vector<int>{ 1 });
+	REQUIRE_EQ(CollectNext(grid, 0, 0), std::vector<int>{ 2 });
+	REQUIRE(CollectNext(grid, 3, 0).empty());
+
+	grid.Move(0, 4, 0);
+	REQUIRE_EQ(CollectNext(grid, 4, 0), std::vector<int>{ 0, 1 });
+	REQUIRE(CollectNext(grid, -1, 0).empty());
+}
+
+TEST_SUITE_END();
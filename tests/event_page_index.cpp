@@ -0,0 +1,62 @@
+#include "event_page_index.h"
+#include "doctest.h"
+
+TEST_SUITE_BEGIN("EventPageIndex");
+
+namespace {
+
+lcf::rpg::EventPage MakeSwitchPage(int switch_id) {
+	lcf::rpg::EventPage page;
+	page.condition.flags.switch_a = true;
+	page.condition.switch_a_id = switch_id;
+	return page;
+}
+
+lcf::rpg::EventPage MakeVariablePage(int var_id) {
+	lcf::rpg::EventPage page;
+	page.condition.flags.variable = true;
+	page.condition.variable_id = var_id;
+	return page;
+}
+
+}
+
+TEST_CASE("Collect") {
+	std::vector<lcf::rpg::Event> events(4);
+	events[0].pages = { MakeSwitchPage(3), MakeSwitchPage(3), MakeVariablePage(2) };
+	events[1].pages = { MakeSwitchPage(1) };
+	events[1].pages[0].condition.flags.switch_b = true;
+	events[1].pages[0].condition.switch_b_id = 3;
+	events[2].pages = { lcf::rpg::EventPage() };
+	events[2].pages[0].condition.flags.timer = true;
+	events[3].pages = { MakeVariablePage(0) };
+
+	EventPageIndex index;
+	index.Build(events);
+
+	std::vector<int> out;
+	index.CollectSwitch(3, out);
+	REQUIRE_EQ(out, std::vector<int>{ 0, 1 });
+
+	out.clear();
+	index.CollectSwitch(1, out);
+	index.CollectSwitch(2, out);
+	index.CollectSwitch(100, out);
+	index.CollectSwitch(-1, out);
+	REQUIRE_EQ(out, std::vector<int>{ 1 });
+
+	out.clear();
+	index.CollectVariable(2, out);
+	index.CollectVariable(0, out);
+	REQUIRE_EQ(out, std::vector<int>{ 0 });
+
+	REQUIRE_EQ(index.GetOtherEvents(), std::vector<int>{ 2 });
+
+	index.Clear();
+	out.clear();
+	index.CollectSwitch(3, out);
+	REQUIRE(out.empty());
+	REQUIRE(index.GetOtherEvents().empty());
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,119 @@
+#include "event_program.h"
+#include "doctest.h"
+#include <initializer_list>
+
+TEST_SUITE_BEGIN("EventProgram");
+
+namespace {
+
+using Cmd = lcf::rpg::EventCommand::Code;
+
+lcf::rpg::EventCommand MakeCommand(Cmd code, std::initializer_list<int32_t> params = {}, int indent = 0) {
+	lcf::rpg::EventCommand com;
+	com.code = static_cast<int>(code);
+	com.indent = indent;
+	com.parameters = lcf::DBArray<int32_t>(params.begin(), params.end());
+	return com;
+}
+
+}
+
+TEST_CASE("Labels") {
+	std::vector<lcf::rpg::EventCommand> list = {
+		MakeCommand(Cmd::JumpToLabel, { 2 }),
+		MakeCommand(Cmd::Label, { 1 }),
+		MakeCommand(Cmd::Label, { 2 }),
+		MakeCommand(Cmd::JumpToLabel, { 1 }),
+		MakeCommand(Cmd::Label, { 2 }),
+		MakeCommand(Cmd::JumpToLabel, { 3 }),
+	};
+
+	EventProgram program(list);
+	REQUIRE_EQ(program.size(), 6);
+	CHECK(program.IsCompiledFrom(list));
+
+	CHECK_EQ(program[0].code, Cmd::JumpToLabel);
+	// The first label with the id
+	CHECK_EQ(program[0].target, 2);
+	CHECK_EQ(program[3].target, 1);
+	CHECK_EQ(program[5].target, EventProgram::no_target);
+	CHECK_EQ(program[1].target, EventProgram::no_target);
+}
+
+TEST_CASE("Next") {
+	std::vector<lcf::rpg::EventCommand> list = {
+		MakeCommand(Cmd::ConditionalBranch, {}, 0),
+		MakeCommand(Cmd::ConditionalBranch, {}, 1),
+		MakeCommand(Cmd::END, {}, 2),
+		MakeCommand(Cmd::EndBranch, {}, 1),
+		MakeCommand(Cmd::END, {}, 1),
+		MakeCommand(Cmd::ElseBranch, {}, 0),
+		MakeCommand(Cmd::END, {}, 1),
+		MakeCommand(Cmd::EndBranch, {}, 0),
+	};
+
+	EventProgram program(list);
+	CHECK_EQ(program[0].next, 5);
+	CHECK_EQ(program[1].next, 3);
+	CHECK_EQ(program[2].next, 3);
+	CHECK_EQ(program[3].next, 4);
+	CHECK_EQ(program[4].next, 5);
+	CHECK_EQ(program[5].next, 7);
+	CHECK_EQ(program[7].next, program.size());
+}
+
+TEST_CASE("Loops") {
+	std::vector<lcf::rpg::EventCommand> list = {
+		MakeCommand(Cmd::Loop, {}, 0),
+		MakeCommand(Cmd::Loop, {}, 1),
+		MakeCommand(Cmd::BreakLoop, {}, 2),
+		MakeCommand(Cmd::END, {}, 2),
+		MakeCommand(Cmd::EndLoop, {}, 1),
+		MakeCommand(Cmd::BreakLoop, {}, 1),
+		MakeCommand(Cmd::END, {}, 1),
+		MakeCommand(Cmd::EndLoop, {}, 0),
+		MakeCommand(Cmd::BreakLoop, {}, 0),
+		MakeCommand(Cmd::EndLoop, {}, 1),
+	};
+
+	EventProgram program(list);
+	CHECK_EQ(program[4].target, 1);
+	CHECK_EQ(program[7].target, 0);
+	// A lower indent comes before the loop
+	CHECK_EQ(program[9].target, EventProgram::no_target);
+
+	CHECK_EQ(program[2].target, 4);
+	CHECK_EQ(program[5].target, 7);
+	CHECK_EQ(program[8].target, 9);
+}
+
+TEST_CASE("IsCompiledFrom") {
+	std::vector<lcf::rpg::EventCommand> list = { MakeCommand(Cmd::Label, { 1 }) };
+	EventProgram program(list);
+
+	auto copy = list;
+	CHECK(!program.IsCompiledFrom(copy));
+	CHECK(!EventProgram().IsCompiledFrom(list));
+}
+
+TEST_CASE("SharedList") {
+	std::vector<lcf::rpg::EventCommand> list = {
+		MakeCommand(Cmd::Label, { 1 }),
+		MakeCommand(Cmd::JumpToLabel, { 1 }),
+	};
+
+	auto shared = EventCommandList::Get(list);
+	REQUIRE(shared == EventCommandList::Get(list));
+	CHECK_EQ(shared->GetCommands(), list);
+	CHECK(shared->GetProgram().IsCompiledFrom(shared->GetCommands()));
+	CHECK_EQ(shared->GetProgram()[1].target, 0);
+
+	// Changed in place, frames still running the old list keep it
+	list[0].parameters[0] = 2;
+	auto changed = EventCommandList::Get(list);
+	CHECK(shared != changed);
+	CHECK_EQ(shared->GetCommands()[0].parameters[0], 1);
+	CHECK_EQ(changed->GetProgram()[1].target, EventProgram::no_target);
+}
+
+TEST_SUITE_END();
@@ -3,6 +3,7 @@
 #include "filefinder.h"
 #include "player.h"
 #include "main_data.h"
+#include "utils.h"
 #include "doctest.h"
 
 static bool skip_tests() {
@@ -36,6 +37,37 @@ TEST_CASE("IsRPG2kProject") {
 	CHECK(!FileFinder::FindImage("CharSet", "Chara1").empty());
 }
 
+TEST_CASE("FindImageCached") {
+	Main_Data::Init();
+
+	Player::escape_symbol = "\\";
+	FileFinder::SetDirectoryTree(FileFinder::CreateDirectoryTree(EP_TEST_PATH "/game"));
+	const std::string path = FileFinder::FindImage("CharSet", "Chara1");
+	CHECK(!path.empty());
+	CHECK_EQ(FileFinder::FindImage("CharSet", "Chara1"), path);
+	CHECK(FileFinder::FindImage("CharSet", "NotAFile").empty());
+	CHECK(FileFinder::FindImage("CharSet", "NotAFile").empty());
+
+	// A new tree drops the cached results
+	FileFinder::SetDirectoryTree(FileFinder::CreateDirectoryTree(EP_TEST_PATH "/notagame"));
+	CHECK(FileFinder::FindImage("CharSet", "Chara1").empty());
+}
+
+TEST_CASE("OpenNativeInputStream") {
+	Main_Data::Init();
+
+	const std::string path = EP_TEST_PATH "/game/RPG_RT.ldb";
+	CHECK(!FileFinder::IsInArchive(path));
+
+	auto native = FileFinder::OpenNativeInputStream(path);
+	auto stream = FileFinder::OpenInputStream(path);
+	REQUIRE(native);
+	REQUIRE(stream);
+	CHECK_EQ(Utils::ReadStream(native), Utils::ReadStream(stream));
+
+	CHECK(!FileFinder::OpenNativeInputStream(EP_TEST_PATH "/game/NotAFile"));
+}
+
 TEST_CASE("IsNotRPG2kProject") {
 	Main_Data::Init();
 
@@ -0,0 +1,165 @@
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <zlib.h>
+#include "filesystem_zip.h"
+#include "doctest.h"
+
+TEST_SUITE_BEGIN("ZipFilesystem");
+
+namespace {
+
+void WriteLE(std::string& out, uint32_t value, int bytes) {
+	for (int i = 0; i < bytes; ++i) {
+		out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+	}
+}
+
+std::string Deflate(const std::string& data) {
+	z_stream zs = {};
+	deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+	std::string out(deflateBound(&zs, data.size()), '\0');
+	zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+	zs.avail_in = data.size();
+	zs.next_out = reinterpret_cast<Bytef*>(&out[0]);
+	zs.avail_out = out.size();
+	deflate(&zs, Z_FINISH);
+	out.resize(zs.total_out);
+	deflateEnd(&zs);
+	return out;
+}
+
+/** Archive of name and content pairs, the entries are deflated when compress is set */
+std::string MakeZip(const std::vector<std::pair<std::string, std::string>>& files, bool compress) {
+	std::string zip, cd;
+	for (const auto& file : files) {
+		const std::string data = compress ? Deflate(file.second) : file.second;
+		const uint32_t crc = crc32(0, reinterpret_cast<const Bytef*>(file.second.data()), file.second.size());
+		const uint32_t offset = zip.size();
+
+		std::string common;
+		WriteLE(common, 20, 2);
+		WriteLE(common, 0, 2);
+		WriteLE(common, compress ? 8 : 0, 2);
+		WriteLE(common, 0, 4);
+		WriteLE(common, crc, 4);
+		WriteLE(common, data.size(), 4);
+		WriteLE(common, file.second.size(), 4);
+		WriteLE(common, file.first.size(), 2);
+		WriteLE(common, 0, 2);
+
+		WriteLE(zip, 0x04034b50, 4);
+		zip += common + file.first + data;
+
+		WriteLE(cd, 0x02014b50, 4);
+		WriteLE(cd, 20, 2);
+		cd += common;
+		WriteLE(cd, 0, 2);
+		WriteLE(cd, 0, 2);
+		WriteLE(cd, 0, 2);
+		WriteLE(cd, 0, 4);
+		WriteLE(cd, offset, 4);
+		cd += file.first;
+	}
+
+	const uint32_t cd_offset = zip.size();
+	zip += cd;
+	WriteLE(zip, 0x06054b50, 4);
+	WriteLE(zip, 0, 4);
+	WriteLE(zip, files.size(), 2);
+	WriteLE(zip, files.size(), 2);
+	WriteLE(zip, cd.size(), 4);
+	WriteLE(zip, cd_offset, 4);
+	WriteLE(zip, 0, 2);
+	return zip;
+}
+
+std::string MakeContent(int size) {
+	std::string data;
+	for (int i = 0; i < size; ++i) {
+		data.push_back(static_cast<char>((i * 7) % 13 + 'a'));
+	}
+	return data;
+}
+
+std::shared_ptr<ZipFilesystem> OpenZip(const std::string& zip) {
+	const std::string name = "test_filesystem_zip.zip";
+	{
+		std::ofstream out(name, std::ios_base::binary);
+		out << zip;
+	}
+	auto fs = ZipFilesystem::Open(name);
+	std::remove(name.c_str());
+	return fs;
+}
+
+std::string ReadAll(std::istream& is) {
+	return std::string(std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>());
+}
+
+}
+
+TEST_CASE("Directories") {
+	auto fs = OpenZip(MakeZip({
+		{ "Game/RPG_RT.ldb", "ldb" },
+		{ "Game/CharSet/Chara1.png", "png" },
+		{ "Game/Music/Sub/Song.wav", "wav" },
+	}, false));
+	REQUIRE(fs);
+
+	CHECK(fs->IsFile("Game/RPG_RT.ldb"));
+	CHECK(!fs->IsFile("Game/rpg_rt.ldb"));
+	CHECK(fs->IsDirectory(""));
+	CHECK(fs->IsDirectory("Game/Music/Sub"));
+	CHECK(!fs->IsDirectory("Gam"));
+	CHECK_EQ(fs->GetFileSize("Game/CharSet/Chara1.png"), 3);
+
+	auto game = fs->GetDirectoryMembers("Game", FileFinder::ALL);
+	CHECK_EQ(game.files.size(), 1);
+	CHECK_EQ(game.files["rpg_rt.ldb"], "RPG_RT.ldb");
+	CHECK_EQ(game.directories.size(), 2);
+	CHECK_EQ(game.directories["charset"], "CharSet");
+
+	auto music = fs->GetDirectoryMembers("Game/Music", FileFinder::RECURSIVE);
+	CHECK_EQ(music.files["sub/song.wav"], "Sub/Song.wav");
+}
+
+TEST_CASE("Read") {
+	const std::string content = MakeContent(100000);
+
+	for (bool compress : { false, true }) {
+		auto fs = OpenZip(MakeZip({ { "a.bin", content }, { "b.bin", "b" } }, compress));
+		REQUIRE(fs);
+
+		auto is = fs->OpenInputStream("a.bin");
+		REQUIRE(is);
+		CHECK_EQ(ReadAll(is), content);
+
+		// Backward and forward seeks
+		for (int pos : { 70000, 10, 99996, 0, 40000 }) {
+			is.clear();
+			is.seekg(pos);
+			char buf[4] = {};
+			is.read(buf, sizeof(buf));
+			CHECK_EQ(std::string(buf, sizeof(buf)), content.substr(pos, 4));
+		}
+
+		is.seekg(-1, std::ios_base::end);
+		CHECK_EQ(is.tellg(), 99999);
+
+		// Streams keep the archive open
+		auto b = fs->OpenInputStream("b.bin");
+		fs.reset();
+		CHECK_EQ(ReadAll(b), "b");
+	}
+}
+
+TEST_CASE("Invalid") {
+	CHECK(!OpenZip("PK not a zip archive"));
+
+	auto fs = OpenZip(MakeZip({ { "a.bin", "a" } }, false));
+	REQUIRE(fs);
+	CHECK(!fs->OpenInputStream("b.bin"));
+}
+
+TEST_SUITE_END();
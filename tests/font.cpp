@@ -26,6 +26,33 @@ TEST_CASE("FontSizeStr") {
 	REQUIRE_EQ(font->GetSize("下"), Rect(0, 0, cwf, ch));
 }
 
+TEST_CASE("FontSizeStrCached") {
+	auto font = Font::Default();
+
+	for (int i = 0; i < 2; ++i) {
+		REQUIRE_EQ(font->GetSize("$A"), Rect(0, 0, cwh * 2, ch));
+		REQUIRE_EQ(font->GetSize("下$A"), Rect(0, 0, cwf + cwh * 2, ch));
+		REQUIRE_EQ(font->GetSize(std::string("$A ").substr(0, 2)), Rect(0, 0, cwh * 2, ch));
+	}
+}
+
+TEST_CASE("FontTextWidth") {
+	auto font = Font::Default();
+	Font::TextWidth width(*font);
+
+	REQUIRE_EQ(width.Get(), 0);
+	REQUIRE_EQ(width.Peek("下"), cwf);
+	REQUIRE_EQ(width.Get(), 0);
+
+	REQUIRE_EQ(width.Append("Skeleton"), cwh * 8);
+	REQUIRE_EQ(width.Append(" "), cwh * 9);
+	REQUIRE_EQ(width.Append("下"), cwh * 9 + cwf);
+	REQUIRE_EQ(width.Get(), font->GetSize("Skeleton 下").width);
+
+	width.Reset();
+	REQUIRE_EQ(width.Get(), 0);
+}
+
 TEST_CASE("FontSizeChar") {
 	auto font = Font::Default();
 
@@ -59,7 +86,8 @@ TEST_CASE("FontGlyphChar") {
 	auto check = [&](char32_t ch, Rect r) {
 		auto ret = font->Glyph(ch);
 		REQUIRE(ret.bitmap != nullptr);
-		REQUIRE_EQ(ret.rect, r);
+		REQUIRE_EQ(ret.rect.width, r.width);
+		REQUIRE_EQ(ret.rect.height, r.height);
 	};
 
 	check(0, Rect(0, 0, 0, ch));
@@ -77,10 +105,24 @@ TEST_CASE("FontGlyphCharEx") {
 	for (char32_t i = 0; i < 52; ++i) {
 		auto ret = font->Glyph(i);
 		REQUIRE(ret.bitmap != nullptr);
-		REQUIRE_EQ(ret.rect, Rect(0, 0, cwf, ch));
+		REQUIRE_EQ(ret.rect, Rect(i % 13 * cwf, i / 13 * ch, cwf, ch));
 	}
 }
 
+TEST_CASE("FontGlyphCached") {
+	Bitmap::SetFormat(format_R8G8B8A8_a().format());
+	auto font = Font::Default();
+
+	auto first = font->Glyph(U'X');
+	auto other = font->Glyph(U'下');
+	auto second = font->Glyph(U'X');
+
+	REQUIRE_EQ(first.bitmap, second.bitmap);
+	REQUIRE_EQ(first.rect, second.rect);
+	REQUIRE_EQ(first.bitmap, other.bitmap);
+	REQUIRE_NE(first.rect, other.rect);
+}
+
 TEST_CASE("FontGlyphChar") {
 	Bitmap::SetFormat(format_R8G8B8A8_a().format());
 	auto font = Font::Default();
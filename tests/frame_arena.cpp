@@ -0,0 +1,59 @@
+#include <cstdint>
+#include "frame_arena.h"
+#include "doctest.h"
+
+TEST_SUITE_BEGIN("FrameArena");
+
+TEST_CASE("Reuse") {
+	FrameArena::Reset();
+
+	const void* first;
+	{
+		FrameArena::Vector<int> values(10);
+		first = values.data();
+		REQUIRE_EQ(reinterpret_cast<uintptr_t>(first) % alignof(int), 0);
+
+		FrameArena::Vector<int> growing;
+		for (int i = 0; i < 1000; ++i) {
+			growing.push_back(i);
+		}
+		REQUIRE_EQ(growing[999], 999);
+	}
+	FrameArena::Reset();
+
+	// The next frame starts at the same memory
+	FrameArena::Vector<int> values(10);
+	REQUIRE_EQ(values.data(), first);
+
+	// Freeing the last allocation hands its space back
+	const auto bytes = FrameArena::GetStats().bytes;
+	{
+		FrameArena::Vector<double> temp(4);
+		REQUIRE_GT(FrameArena::GetStats().bytes, bytes);
+	}
+	REQUIRE_EQ(FrameArena::GetStats().bytes, bytes);
+}
+
+TEST_CASE("Merge") {
+	FrameArena::Reset();
+	const auto capacity = FrameArena::GetStats().capacity;
+
+	{
+		FrameArena::Vector<char> large(capacity * 3);
+		FrameArena::String text(capacity, 'x');
+		REQUIRE_EQ(text.back(), 'x');
+		REQUIRE_GT(FrameArena::GetStats().capacity, capacity);
+	}
+	const auto stats = FrameArena::GetStats();
+	REQUIRE_GE(stats.peak_bytes, capacity * 4);
+	FrameArena::Reset();
+
+	// A single block keeps everything of the frame
+	REQUIRE_EQ(FrameArena::GetStats().capacity, stats.capacity);
+	REQUIRE_EQ(FrameArena::GetStats().bytes, 0);
+	FrameArena::Vector<char> large(capacity * 3);
+	FrameArena::String text(capacity, 'x');
+	REQUIRE_EQ(FrameArena::GetStats().capacity, stats.capacity);
+}
+
+TEST_SUITE_END();
@@ -860,4 +860,42 @@ TEST_CASE("ChangeParam") {
 	}
 }
 
+TEST_CASE("LearnSkill") {
+	const MockActor m;
+	auto actor = MakeActor(1);
+
+	REQUIRE(actor.LearnSkill(5, nullptr));
+	REQUIRE(actor.LearnSkill(2, nullptr));
+	REQUIRE_FALSE(actor.LearnSkill(5, nullptr));
+	REQUIRE_FALSE(actor.LearnSkill(0, nullptr));
+	REQUIRE_FALSE(actor.LearnSkill(201, nullptr));
+	REQUIRE_EQ(actor.GetSkills(), std::vector<int16_t>{ 2, 5 });
+
+	REQUIRE(actor.IsSkillLearned(2));
+	REQUIRE(actor.IsSkillLearned(5));
+	REQUIRE_FALSE(actor.IsSkillLearned(3));
+	REQUIRE_FALSE(actor.IsSkillLearned(-1));
+	REQUIRE_FALSE(actor.IsSkillLearned(1000));
+
+	REQUIRE(actor.UnlearnSkill(5));
+	REQUIRE_FALSE(actor.UnlearnSkill(5));
+	REQUIRE_FALSE(actor.IsSkillLearned(5));
+
+	auto save = actor.GetSaveData();
+	save.skills = { 7, 3, 3 };
+	actor.SetSaveData(std::move(save));
+	REQUIRE_FALSE(actor.IsSkillLearned(2));
+	REQUIRE(actor.IsSkillLearned(7));
+
+	// Duplicates from a save are unlearned one by one
+	REQUIRE(actor.UnlearnSkill(3));
+	REQUIRE(actor.IsSkillLearned(3));
+	REQUIRE(actor.UnlearnSkill(3));
+	REQUIRE_FALSE(actor.IsSkillLearned(3));
+
+	actor.UnlearnAllSkills();
+	REQUIRE_FALSE(actor.IsSkillLearned(7));
+	REQUIRE(actor.GetSkills().empty());
+}
+
 TEST_SUITE_END();
@@ -622,4 +622,21 @@ TEST_CASE("LockFacingVsAnimType") {
 	}
 }
 
+TEST_CASE("SpriteRevision") {
+	Game_Player ch;
+	Game_Player other;
+	REQUIRE_NE(ch.GetSpriteRevision(), other.GetSpriteRevision());
+
+	auto rev = ch.GetSpriteRevision();
+	ch.SetSpriteGraphic("Hero", 2);
+	REQUIRE_NE(ch.GetSpriteRevision(), rev);
+
+	rev = ch.GetSpriteRevision();
+	ch.SetSpriteGraphic("Hero", 2);
+	REQUIRE_EQ(ch.GetSpriteRevision(), rev);
+
+	ch.SetSpriteGraphic("Hero", 3);
+	REQUIRE_NE(ch.GetSpriteRevision(), rev);
+}
+
 TEST_SUITE_END();
@@ -301,4 +301,18 @@ TEST_CASE("StopCountMoveFail") { testStop(false, false, 16, 16); }
 TEST_CASE("StopCountJump") { testStop(true, true, 4, 4); }
 TEST_CASE("StopCountJumpFail") { testStop(false, true, 16, 16); }
 
+TEST_CASE("PassableSubstitute") {
+	const MockGame mg(MockMap::ePass40x30);
+	const int tile_index = 4 + 4 * Game_Map::GetWidth();
+
+	REQUIRE(Game_Map::IsPassableLowerTile(Passable::Down, tile_index));
+
+	// Lower tile 1 of the mock chipset is blocked
+	Game_Map::SubstituteDown(0, 1);
+	REQUIRE_FALSE(Game_Map::IsPassableLowerTile(Passable::Down, tile_index));
+
+	Game_Map::SubstituteDown(1, 0);
+	REQUIRE(Game_Map::IsPassableLowerTile(Passable::Down, tile_index));
+}
+
 TEST_SUITE_END();
@@ -0,0 +1,83 @@
+#include "game_clock.h"
+#include "doctest.h"
+
+TEST_SUITE_BEGIN("Game_Clock");
+
+namespace {
+
+constexpr auto step = Game_Clock::GetTargetGameTimeStep();
+
+/** Runs a frame which took the given time, returns the number of logic steps */
+int RunFrame(Game_Clock::time_point& now, Game_Clock::duration dt) {
+	now += dt;
+	Game_Clock::OnNextFrame(now);
+	int steps = 0;
+	while (Game_Clock::NextGameTimeStep()) {
+		++steps;
+	}
+	return steps;
+}
+
+}
+
+TEST_CASE("FixedStep") {
+	Game_Clock::time_point now{};
+	Game_Clock::ResetFrame(now);
+	const int skipped = Game_Clock::GetSkippedDraws();
+
+	REQUIRE_EQ(RunFrame(now, step / 2), 0);
+	REQUIRE_EQ(RunFrame(now, step / 2 + step / 4), 1);
+	REQUIRE_EQ(Game_Clock::GetSkippedDraws(), skipped);
+
+	// A late frame catches up with the logic
+	REQUIRE_EQ(RunFrame(now, 3 * step), 3);
+	REQUIRE_EQ(Game_Clock::GetSkippedDraws(), skipped + 2);
+}
+
+TEST_CASE("MaxFrameSkip") {
+	Game_Clock::time_point now{};
+	Game_Clock::ResetFrame(now);
+	Game_Clock::SetMaxFrameSkip(1);
+	const int dropped = Game_Clock::GetDroppedSteps();
+
+	REQUIRE_EQ(RunFrame(now, 5 * step + step / 2), 2);
+	REQUIRE_EQ(Game_Clock::GetDroppedSteps(), dropped + 3);
+
+	// The dropped time is not caught up later
+	REQUIRE_EQ(RunFrame(now, step / 4), 0);
+	REQUIRE_EQ(RunFrame(now, step / 2), 1);
+
+	Game_Clock::SetMaxFrameSkip(std::numeric_limits<int>::max());
+}
+
+TEST_CASE("Strict") {
+	Game_Clock::time_point now{};
+	Game_Clock::ResetFrame(now);
+	Game_Clock::SetPacing(Game_Clock::Pacing::Strict);
+
+	// One step per frame whatever the frame time was
+	REQUIRE_EQ(RunFrame(now, 4 * step), 1);
+	REQUIRE_EQ(RunFrame(now, step / 4), 1);
+	REQUIRE_EQ(RunFrame(now, step), 1);
+
+	Game_Clock::SetPacing(Game_Clock::Pacing::FixedStep);
+}
+
+TEST_CASE("SleepUntil") {
+	const auto before = Game_Clock::GetSleepStats();
+
+	const auto deadline = Game_Clock::now() + std::chrono::milliseconds(3);
+	Game_Clock::SleepUntil(deadline);
+	REQUIRE_GE(Game_Clock::now(), deadline);
+
+	const auto stats = Game_Clock::GetSleepStats();
+	REQUIRE_EQ(stats.sleeps, before.sleeps + 1);
+	REQUIRE_GE(stats.max_late, before.max_late);
+	REQUIRE_GE(stats.margin, std::chrono::duration_cast<Game_Clock::duration>(Game_Clock::clock::SleepMargin()));
+
+	// Deadlines in the past return at once
+	Game_Clock::SleepUntil(deadline);
+	REQUIRE_EQ(Game_Clock::GetSleepStats().sleeps, before.sleeps + 2);
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,68 @@
+#include "game_interpreter_map.h"
+#include "doctest.h"
+#include "scene.h"
+#include <initializer_list>
+
+#include "mock_game.h"
+
+TEST_SUITE_BEGIN("Game_Interpreter");
+
+namespace {
+
+using Cmd = lcf::rpg::EventCommand::Code;
+
+lcf::rpg::EventCommand MakeCommand(Cmd code, std::initializer_list<int32_t> params = {}, int indent = 0) {
+	lcf::rpg::EventCommand com;
+	com.code = static_cast<int>(code);
+	com.indent = indent;
+	com.parameters = lcf::DBArray<int32_t>(params.begin(), params.end());
+	return com;
+}
+
+/** Endless loop incrementing variable 1 */
+std::vector<lcf::rpg::EventCommand> MakeEndlessLoop() {
+	return {
+		MakeCommand(Cmd::Label, { 1 }),
+		MakeCommand(Cmd::ControlVars, { 0, 1, 1, 1, 0, 1 }),
+		MakeCommand(Cmd::JumpToLabel, { 1 }),
+	};
+}
+
+}
+
+TEST_CASE("FrameBudgetUnlimited") {
+	const MockGame mg(MockMap::ePass40x30);
+	Scene::Push(std::make_shared<Scene>());
+
+	Game_Interpreter_Map interp(true);
+	interp.Push(MakeEndlessLoop(), 0);
+	interp.Update();
+
+	REQUIRE(interp.ReachedLoopLimit());
+	REQUIRE_GT(Main_Data::game_variables->Get(1), 1);
+
+	Scene::instance.reset();
+}
+
+TEST_CASE("FrameBudgetYield") {
+	const MockGame mg(MockMap::ePass40x30);
+	Scene::Push(std::make_shared<Scene>());
+	Game_Interpreter::SetFrameBudget(Game_Clock::duration(1));
+
+	// Every update yields at the jump back to the label
+	Game_Interpreter_Map interp(true);
+	interp.Push(MakeEndlessLoop(), 0);
+	for (int i = 1; i <= 3; ++i) {
+		Game_Interpreter::ResetFrameBudget();
+		interp.Update();
+
+		REQUIRE(interp.IsRunning());
+		REQUIRE_FALSE(interp.ReachedLoopLimit());
+		REQUIRE_EQ(Main_Data::game_variables->Get(1), i);
+	}
+
+	Game_Interpreter::SetFrameBudget({});
+	Scene::instance.reset();
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,89 @@
+#include "test_mock_actor.h"
+#include "doctest.h"
+
+TEST_SUITE_BEGIN("Game_Party");
+
+TEST_CASE("ItemCount") {
+	const MockActor m;
+	auto& party = *Main_Data::game_party;
+
+	REQUIRE_EQ(party.GetItemCount(1), 0);
+
+	party.AddItem(5, 3);
+	party.AddItem(2, 1);
+	REQUIRE_EQ(party.GetItemCount(5), 3);
+	REQUIRE_EQ(party.GetItemCount(2), 1);
+	REQUIRE_EQ(party.GetItemCount(3), 0);
+
+	party.AddItem(5, 200);
+	REQUIRE_EQ(party.GetItemCount(5), 99);
+
+	party.RemoveItem(5, 98);
+	REQUIRE_EQ(party.GetItemCount(5), 1);
+
+	party.RemoveItem(5, 1);
+	REQUIRE_EQ(party.GetItemCount(5), 0);
+	REQUIRE_EQ(party.GetItemCount(2), 1);
+
+	std::vector<int> items;
+	party.GetItems(items);
+	REQUIRE_EQ(items, std::vector<int>{ 2 });
+}
+
+TEST_CASE("ItemCountInvalid") {
+	const MockActor m;
+	auto& party = *Main_Data::game_party;
+
+	party.AddItem(0, 1);
+	party.AddItem(-1, 1);
+	party.AddItem(lcf::Data::items.size() + 1, 1);
+
+	REQUIRE_EQ(party.GetItemCount(0), 0);
+	REQUIRE_EQ(party.GetItemCount(-1), 0);
+	REQUIRE_EQ(party.GetItemCount(lcf::Data::items.size() + 1), 0);
+	REQUIRE(party.GetSaveData().item_ids.empty());
+}
+
+TEST_CASE("ItemCountConsume") {
+	const MockActor m;
+	auto& party = *Main_Data::game_party;
+
+	auto& item = lcf::Data::items[0];
+	item.type = lcf::rpg::Item::Type_medicine;
+	item.uses = 2;
+
+	party.AddItem(1, 2);
+
+	party.ConsumeItemUse(1);
+	REQUIRE_EQ(party.GetItemCount(1), 2);
+	party.ConsumeItemUse(1);
+	REQUIRE_EQ(party.GetItemCount(1), 1);
+
+	party.ConsumeItemUse(1);
+	party.ConsumeItemUse(1);
+	REQUIRE_EQ(party.GetItemCount(1), 0);
+	REQUIRE(party.GetSaveData().item_ids.empty());
+}
+
+TEST_CASE("ItemCountFromSave") {
+	const MockActor m;
+	auto& party = *Main_Data::game_party;
+
+	lcf::rpg::SaveInventory save;
+	save.item_ids = { 7, 3 };
+	save.item_counts = { 10, 20 };
+	save.item_usage = { 0, 0 };
+	party.SetupFromSave(std::move(save));
+
+	REQUIRE_EQ(party.GetItemCount(3), 20);
+	REQUIRE_EQ(party.GetItemCount(7), 10);
+	REQUIRE_EQ(party.GetItemCount(5), 0);
+
+	party.AddItem(3, 1);
+	REQUIRE_EQ(party.GetItemCount(3), 21);
+
+	REQUIRE_EQ(party.GetSaveData().item_ids, std::vector<int16_t>{ 3, 7 });
+	REQUIRE_EQ(party.GetSaveData().item_counts, std::vector<uint8_t>{ 21, 10 });
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,111 @@
+#include "game_pictures.h"
+#include "options.h"
+#include "player.h"
+#include "doctest.h"
+
+TEST_SUITE_BEGIN("Game_Pictures");
+
+namespace {
+
+class EngineGuard {
+public:
+	EngineGuard() : engine(Player::engine) {
+		Player::engine = Player::EngineRpg2k3 | Player::EngineMajorUpdated | Player::EngineEnglish;
+	}
+	~EngineGuard() {
+		Player::engine = engine;
+	}
+private:
+	int engine;
+};
+
+Game_Pictures::ShowParams MakeShowParams() {
+	Game_Pictures::ShowParams params{};
+	params.magnify = 100;
+	return params;
+}
+
+int GetSavedFrames(const Game_Pictures& pictures, int id) {
+	return pictures.GetSaveData()[id - 1].frames;
+}
+
+}
+
+TEST_CASE("ActiveFrames") {
+	EngineGuard guard;
+	Game_Pictures pictures;
+
+	pictures.Show(1, MakeShowParams());
+
+	Game_Pictures::MoveParams move{};
+	move.position_x = 100;
+	move.magnify = 100;
+	move.duration = 1;
+	pictures.Move(1, move);
+
+	for (int i = 0; i < 10; ++i) {
+		pictures.Update(false);
+	}
+	REQUIRE_EQ(pictures.GetPicture(1).data.current_x, 100.0);
+	REQUIRE_EQ(GetSavedFrames(pictures, 1), 10);
+
+	// Settled pictures still count their frames
+	for (int i = 0; i < 5; ++i) {
+		pictures.Update(false);
+	}
+	REQUIRE_EQ(GetSavedFrames(pictures, 1), 15);
+
+	// Not on a battle layer
+	for (int i = 0; i < 3; ++i) {
+		pictures.Update(true);
+	}
+	REQUIRE_EQ(GetSavedFrames(pictures, 1), 15);
+
+	move.position_x = 0;
+	pictures.Move(1, move);
+	pictures.Update(false);
+	REQUIRE_EQ(pictures.GetPicture(1).data.frames, 16);
+	REQUIRE_LT(pictures.GetPicture(1).data.current_x, 100.0);
+	REQUIRE_GT(pictures.GetPicture(1).data.current_x, 0.0);
+}
+
+TEST_CASE("EmptyFrames") {
+	EngineGuard guard;
+	Game_Pictures pictures;
+
+	auto params = MakeShowParams();
+	pictures.Show(2, params);
+	pictures.Erase(2);
+
+	for (int i = 0; i < 4; ++i) {
+		pictures.Update(false);
+	}
+
+	// Picture 1 was created by Show(2) and was never shown
+	const auto save = pictures.GetSaveData();
+	REQUIRE_EQ(save[1].frames, 4);
+	REQUIRE_EQ(save[0].frames, pictures.GetPicture(1).IsOnMap() ? 4 : 0);
+}
+
+TEST_CASE("FixedToMap") {
+	EngineGuard guard;
+	Game_Pictures pictures;
+
+	auto params = MakeShowParams();
+	params.position_x = 50;
+	params.fixed_to_map = true;
+	pictures.Show(1, params);
+
+	params.fixed_to_map = false;
+	pictures.Show(2, params);
+
+	pictures.OnMapScrolled(2 * TILE_SIZE, 0);
+	REQUIRE_EQ(pictures.GetPicture(1).data.current_x, 48.0);
+	REQUIRE_EQ(pictures.GetPicture(2).data.current_x, 50.0);
+
+	pictures.Show(1, params);
+	pictures.OnMapScrolled(2 * TILE_SIZE, 0);
+	REQUIRE_EQ(pictures.GetPicture(1).data.current_x, 50.0);
+}
+
+TEST_SUITE_END();
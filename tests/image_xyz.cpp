@@ -0,0 +1,134 @@
+#include <cstdint>
+#include <cstdlib>
+#include <initializer_list>
+#include <vector>
+#include <zlib.h>
+#include "bitmap.h"
+#include "image_xyz.h"
+#include "pixel_format.h"
+#include "doctest.h"
+
+TEST_SUITE_BEGIN("ImageXYZ");
+
+namespace {
+
+constexpr int width = 7;
+constexpr int height = 5;
+
+uint8_t GetIndex(int x, int y) {
+	return static_cast<uint8_t>((x * 37 + y * 11) % 256);
+}
+
+std::vector<uint8_t> MakeXYZ() {
+	std::vector<uint8_t> raw;
+	for (int i = 0; i < 256; ++i) {
+		raw.push_back(static_cast<uint8_t>(i));
+		raw.push_back(static_cast<uint8_t>(255 - i));
+		raw.push_back(static_cast<uint8_t>(i * 7));
+	}
+	for (int y = 0; y < height; ++y) {
+		for (int x = 0; x < width; ++x) {
+			raw.push_back(GetIndex(x, y));
+		}
+	}
+
+	uLongf size = compressBound(raw.size());
+	std::vector<uint8_t> xyz = { 'X', 'Y', 'Z', '1', width, 0, height, 0 };
+	xyz.resize(8 + size);
+	compress(xyz.data() + 8, &size, raw.data(), raw.size());
+	xyz.resize(8 + size);
+	return xyz;
+}
+
+uint32_t GetPixel(const Bitmap& bitmap, int x, int y) {
+	return reinterpret_cast<const uint32_t*>(static_cast<const uint8_t*>(bitmap.pixels()) + y * bitmap.pitch())[x];
+}
+
+}
+
+TEST_CASE("ReadRGBA") {
+	const auto xyz = MakeXYZ();
+	int w = 0;
+	int h = 0;
+	void* pixels = nullptr;
+	REQUIRE(ImageXYZ::ReadXYZ(xyz.data(), xyz.size(), true, w, h, pixels));
+	REQUIRE_EQ(w, width);
+	REQUIRE_EQ(h, height);
+
+	const auto* rgba = static_cast<const uint8_t*>(pixels);
+	for (int y = 0; y < height; ++y) {
+		for (int x = 0; x < width; ++x) {
+			const uint8_t idx = GetIndex(x, y);
+			const uint8_t* p = rgba + (y * width + x) * 4;
+			REQUIRE_EQ(p[3], idx == 0 ? 0 : 255);
+			if (idx != 0) {
+				REQUIRE_EQ(p[0], idx);
+				REQUIRE_EQ(p[1], 255 - idx);
+				REQUIRE_EQ(p[2], static_cast<uint8_t>(idx * 7));
+			}
+		}
+	}
+	free(pixels);
+}
+
+TEST_CASE("ReadDirect") {
+	Bitmap::SetFormat(format_R8G8B8A8_a().format());
+	const auto xyz = MakeXYZ();
+
+	for (bool transparent: { false, true }) {
+		auto bitmap = Bitmap::Create(xyz.data(), xyz.size(), transparent);
+		REQUIRE_EQ(bitmap->GetWidth(), width);
+		REQUIRE_EQ(bitmap->GetHeight(), height);
+
+		for (int y = 0; y < height; ++y) {
+			for (int x = 0; x < width; ++x) {
+				const uint8_t idx = GetIndex(x, y);
+				uint8_t r, g, b, a;
+				Bitmap::pixel_format.uint32_to_rgba(GetPixel(*bitmap, x, y), r, g, b, a);
+				if (transparent && idx == 0) {
+					REQUIRE_EQ(a, 0);
+					continue;
+				}
+				REQUIRE_EQ(r, idx);
+				REQUIRE_EQ(g, 255 - idx);
+				REQUIRE_EQ(b, static_cast<uint8_t>(idx * 7));
+			}
+		}
+	}
+}
+
+TEST_CASE("ReadPaletted") {
+	Bitmap::SetFormat(format_R8G8B8A8_a().format());
+	const auto xyz = MakeXYZ();
+	const uint32_t flags = Bitmap::Flag_ReadOnly | Bitmap::Flag_Paletted | Bitmap::Flag_Chipset;
+
+	const bool storage = Bitmap::GetPalettedStorage();
+	Bitmap::SetPalettedStorage(false);
+	auto expanded = Bitmap::Create(xyz.data(), xyz.size(), true, flags);
+	Bitmap::SetPalettedStorage(true);
+	auto paletted = Bitmap::Create(xyz.data(), xyz.size(), true, flags);
+	Bitmap::SetPalettedStorage(storage);
+
+	REQUIRE_FALSE(expanded->IsPaletted());
+	REQUIRE(paletted->IsPaletted());
+	REQUIRE_LT(paletted->GetSize(), expanded->GetSize());
+	REQUIRE_EQ(paletted->GetImageOpacity(), expanded->GetImageOpacity());
+
+	// Drawn by pixman and by the blit kernels
+	for (bool flip: { false, true }) {
+		auto expected = Bitmap::Create(width + 4, height + 4, Color(20, 40, 60, 255));
+		auto result = Bitmap::Create(width + 4, height + 4, Color(20, 40, 60, 255));
+		expected->FlipBlit(2, 1, *expanded, expanded->GetRect(), flip, false, Opacity(200));
+		result->FlipBlit(2, 1, *paletted, paletted->GetRect(), flip, false, Opacity(200));
+		expected->Blit(0, 0, *expanded, Rect(1, 1, 3, 3), Opacity::Opaque());
+		result->Blit(0, 0, *paletted, Rect(1, 1, 3, 3), Opacity::Opaque());
+
+		for (int y = 0; y < result->GetHeight(); ++y) {
+			for (int x = 0; x < result->GetWidth(); ++x) {
+				REQUIRE_EQ(GetPixel(*result, x, y), GetPixel(*expected, x, y));
+			}
+		}
+	}
+}
+
+TEST_SUITE_END();
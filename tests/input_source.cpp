@@ -0,0 +1,79 @@
+#include <cstdio>
+#include <vector>
+#include "input_source.h"
+#include "input.h"
+#include "test_mock_actor.h"
+#include "doctest.h"
+
+TEST_SUITE_BEGIN("Input_Source");
+
+namespace {
+
+class RecordSource : public Input::Source {
+public:
+	RecordSource() : Source(Input::GetDefaultButtonMappings(), Input::GetDefaultDirectionMappings()) {}
+
+	void Update() override {
+		Record();
+	}
+	void UpdateSystem() override {}
+
+	void Press(const std::bitset<Input::BUTTON_COUNT>& buttons) {
+		pressed_buttons = buttons;
+	}
+};
+
+std::vector<std::bitset<Input::BUTTON_COUNT>> MakeFrames() {
+	std::vector<std::bitset<Input::BUTTON_COUNT>> frames(60);
+	for (int i = 0; i < 60; ++i) {
+		if (i < 10 || (i >= 30 && i < 32)) {
+			frames[i][Input::DECISION] = true;
+		}
+		if (i >= 20 && i < 45) {
+			frames[i][Input::UP] = true;
+		}
+		if (i == 50) {
+			frames[i][Input::CANCEL] = true;
+		}
+	}
+	return frames;
+}
+
+}
+
+TEST_CASE("RecordAndReplay") {
+	const MockActor m;
+	auto& system = *Main_Data::game_system;
+	const std::string path = "input_source_test.log";
+	const auto frames = MakeFrames();
+
+	for (bool binary: { false, true }) {
+		{
+			RecordSource source;
+			REQUIRE(source.InitRecording(path, binary));
+			source.AddRecordingData(Input::RecordingData::CommandLine, "test");
+
+			system.ResetFrameCounter();
+			for (const auto& buttons : frames) {
+				source.Press(buttons);
+				source.Update();
+				system.IncFrameCounter();
+			}
+		}
+
+		Input::LogSource replay(path.c_str(), Input::GetDefaultButtonMappings(), Input::GetDefaultDirectionMappings());
+		REQUIRE(replay);
+
+		system.ResetFrameCounter();
+		for (const auto& buttons : frames) {
+			replay.Update();
+			REQUIRE_EQ(replay.GetPressedNonSystemButtons(), buttons);
+			system.IncFrameCounter();
+		}
+		Player::exit_flag = false;
+	}
+
+	std::remove(path.c_str());
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,66 @@
+#include "job_system.h"
+#include <atomic>
+#include <vector>
+#include "doctest.h"
+
+TEST_SUITE_BEGIN("JobSystem");
+
+TEST_CASE("ParallelFor") {
+	JobSystem::Init(3);
+
+	std::vector<int> calls(100);
+	JobSystem::ParallelFor(static_cast<int>(calls.size()), [&](int i) {
+		++calls[i];
+	});
+	REQUIRE_EQ(calls, std::vector<int>(100, 1));
+
+	// Nested calls do not wait on each other
+	std::atomic<int> inner(0);
+	JobSystem::ParallelFor(4, [&](int) {
+		JobSystem::ParallelFor(8, [&](int) {
+			++inner;
+		});
+	});
+	REQUIRE_EQ(inner.load(), 32);
+
+	JobSystem::Quit();
+}
+
+TEST_CASE("Continuation") {
+	JobSystem::Init(2);
+
+	std::atomic<int> done(0);
+	int continued = 0;
+	for (int i = 0; i < 10; ++i) {
+		JobSystem::Submit([&]() { ++done; }, [&]() { ++continued; }, JobSystem::Priority::Low);
+	}
+	auto result = JobSystem::Async([]() { return 42; });
+	REQUIRE_EQ(result.get(), 42);
+
+	// With workers continuations only run on Update
+	while (done < 10) {
+	}
+	REQUIRE_EQ(continued, 0);
+	JobSystem::Quit();
+	REQUIRE_EQ(continued, 0);
+
+	JobSystem::Submit([&]() { ++done; }, [&]() { ++continued; });
+	JobSystem::Update();
+	REQUIRE_EQ(continued, 1);
+}
+
+TEST_CASE("NoWorkers") {
+	JobSystem::Init(0);
+	REQUIRE_EQ(JobSystem::GetThreadCount(), 0);
+
+	int calls = 0;
+	JobSystem::Submit([&]() { ++calls; });
+	REQUIRE_EQ(calls, 1);
+
+	JobSystem::ParallelFor(3, [&](int) { ++calls; });
+	REQUIRE_EQ(calls, 4);
+
+	JobSystem::Quit();
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,47 @@
+#include <vector>
+#include "memory_pressure.h"
+#include "doctest.h"
+
+TEST_SUITE_BEGIN("MemoryPressure");
+
+TEST_CASE("TrimOrder") {
+	std::vector<int> calls;
+	std::vector<MemoryPressure::Level> levels;
+
+	const int late = MemoryPressure::Register(20, [&](MemoryPressure::Level level) {
+		calls.push_back(20);
+		levels.push_back(level);
+	});
+	const int early = MemoryPressure::Register(10, [&](MemoryPressure::Level) {
+		calls.push_back(10);
+	});
+
+	// Nothing signaled
+	MemoryPressure::Update();
+	REQUIRE(calls.empty());
+
+	// The highest level of a frame is used
+	MemoryPressure::Signal(MemoryPressure::Level::Critical);
+	MemoryPressure::Signal(MemoryPressure::Level::Moderate);
+	MemoryPressure::Update();
+	REQUIRE_EQ(calls, std::vector<int>{ 10, 20 });
+	REQUIRE(levels.back() == MemoryPressure::Level::Critical);
+
+	MemoryPressure::Update();
+	REQUIRE_EQ(calls.size(), 2u);
+
+	MemoryPressure::Unregister(early);
+	MemoryPressure::Signal(MemoryPressure::Level::Moderate);
+	MemoryPressure::Update();
+	REQUIRE_EQ(calls, std::vector<int>{ 10, 20, 20 });
+	REQUIRE(levels.back() == MemoryPressure::Level::Moderate);
+
+	MemoryPressure::Unregister(late);
+}
+
+TEST_CASE("Floor") {
+	REQUIRE_EQ(MemoryPressure::GetFloor(MemoryPressure::Level::Moderate, 1000), 500u);
+	REQUIRE_EQ(MemoryPressure::GetFloor(MemoryPressure::Level::Critical, 1000), 0u);
+}
+
+TEST_SUITE_END();
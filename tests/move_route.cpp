@@ -5,6 +5,7 @@
 #include "game_vehicle.h"
 #include "main_data.h"
 #include "game_switches.h"
+#include "move_route_program.h"
 #include <climits>
 #include <initializer_list>
 
@@ -1171,4 +1172,48 @@ TEST_CASE("ClearPause") {
 	REQUIRE(!ch.IsPaused());
 }
 
+TEST_CASE("Program") {
+	using Code = lcf::rpg::MoveCommand::Code;
+	auto mr = MakeRoute({
+			{ static_cast<int>(Code::begin_jump) },
+			{ static_cast<int>(Code::move_up) },
+			{ static_cast<int>(Code::end_jump) },
+			{ static_cast<int>(Code::begin_jump) },
+			{ static_cast<int>(Code::play_sound_effect), "(OFF)" },
+			{ static_cast<int>(Code::change_graphic), "x", 3 }
+			});
+
+	auto program = MoveRouteProgram::Get(mr);
+	const auto copy = mr;
+	REQUIRE(program == MoveRouteProgram::Get(copy));
+
+	const auto& ops = program->GetOps();
+	REQUIRE_EQ(ops.size(), mr.move_commands.size());
+	REQUIRE_EQ(ops[0].jump_end, 2);
+	REQUIRE_EQ(ops[3].jump_end, -1);
+	REQUIRE_EQ(ops[4].param, -1);
+	REQUIRE_EQ(*ops[5].name, "x");
+	REQUIRE_EQ(ops[5].param, 3);
+
+	mr.move_commands[5].parameter_string = "y";
+	REQUIRE(program != MoveRouteProgram::Get(mr));
+}
+
+TEST_CASE("ProgramReplaced") {
+	const MapGuard mg;
+
+	auto ch = MoveRouteVehicle();
+	auto mr = MakeRoute({{ static_cast<int>(lcf::rpg::MoveCommand::Code::change_graphic), "x", 3 }});
+
+	ch.ForceMoveRoute(mr, 2);
+	ForceUpdate(ch);
+	REQUIRE_EQ(ch.GetSpriteName(), "x");
+
+	// The character data holds the new route at the same address
+	mr.move_commands[0].parameter_string = "y";
+	ch.ForceMoveRoute(mr, 2);
+	ForceUpdate(ch);
+	REQUIRE_EQ(ch.GetSpriteName(), "y");
+}
+
 TEST_SUITE_END();
@@ -1,3 +1,5 @@
+#include <iostream>
+#include <sstream>
 #include "graphics.h"
 #include "output.h"
 #include "main_data.h"
@@ -15,4 +17,37 @@ TEST_CASE("Message Output") {
 	Graphics::Quit();
 }
 
+TEST_CASE("Repeated Message Output") {
+	Graphics::Init();
+	Main_Data::Init();
+	for (int i = 0; i < 100; ++i) {
+		Output::Debug("Test {}", "repeat");
+	}
+	Output::Debug("Test {}", "done");
+	Main_Data::Cleanup();
+	Graphics::Quit();
+}
+
+TEST_CASE("Repeated Console Message Before Another") {
+	Graphics::Init();
+	Main_Data::Init();
+	// Writes the pending lines, later lines are written directly
+	Output::Quit();
+
+	std::ostringstream console;
+	auto* old_buf = std::cerr.rdbuf(console.rdbuf());
+	for (int i = 0; i < 5; ++i) {
+		Output::Debug("Test {}", "console repeat");
+	}
+	Output::Debug("Test {}", "console other");
+	std::cerr.rdbuf(old_buf);
+
+	CHECK_EQ(console.str(),
+		"Debug: Test console repeat\n"
+		"Debug: Test console repeat [5x]\n"
+		"Debug: Test console other\n");
+	Main_Data::Cleanup();
+	Graphics::Quit();
+}
+
 TEST_SUITE_END();
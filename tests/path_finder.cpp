@@ -0,0 +1,120 @@
+#include "path_finder.h"
+#include "doctest.h"
+#include <string>
+
+TEST_SUITE_BEGIN("PathFinder");
+
+namespace {
+
+constexpr int Up = 0;
+constexpr int Right = 1;
+constexpr int Down = 2;
+constexpr int Left = 3;
+
+/** Map where '#' tiles can not be entered */
+struct Grid {
+	int width;
+	int height;
+	std::vector<std::string> rows;
+
+	bool CanStep(int x, int y, int dir) const {
+		static const int dx[] = { 0, 1, 0, -1 };
+		static const int dy[] = { -1, 0, 1, 0 };
+		x = (x + dx[dir] + width) % width;
+		y = (y + dy[dir] + height) % height;
+		return rows[y][x] != '#';
+	}
+
+	PathFinder::StepFn StepFn() const {
+		return [this](int x, int y, int dir) { return CanStep(x, y, dir); };
+	}
+};
+
+}
+
+TEST_CASE("Open") {
+	Grid grid { 5, 4, { ".....", ".....", ".....", "....." } };
+	PathFinder pf;
+	pf.Reset(grid.width, grid.height, false, false);
+
+	REQUIRE_EQ(pf.GetDistance(0, 0, 4, 3, grid.StepFn()), 7);
+	REQUIRE_EQ(pf.GetDistance(4, 3, 4, 3, grid.StepFn()), 0);
+	REQUIRE_EQ(pf.GetDirection(4, 3, 4, 3, grid.StepFn()), -1);
+	REQUIRE_EQ(pf.GetDirection(4, 0, 4, 3, grid.StepFn()), Down);
+	REQUIRE_EQ(pf.GetDirection(0, 3, 4, 3, grid.StepFn()), Right);
+	REQUIRE_EQ(pf.GetDirection(4, 3, 0, 3, grid.StepFn()), Left);
+	REQUIRE_EQ(pf.GetDirection(0, 3, 0, 0, grid.StepFn()), Up);
+
+	// Outside of the map
+	REQUIRE_EQ(pf.GetDirection(-1, 0, 4, 3, grid.StepFn()), -1);
+	REQUIRE_EQ(pf.GetDistance(0, 0, 5, 3, grid.StepFn()), -1);
+}
+
+TEST_CASE("Wall") {
+	Grid grid { 5, 4, { "..#..", "..#..", "..#..", "....." } };
+	PathFinder pf;
+	pf.Reset(grid.width, grid.height, false, false);
+
+	REQUIRE_EQ(pf.GetDistance(0, 0, 4, 0, grid.StepFn()), 10);
+	REQUIRE_EQ(pf.GetDirection(1, 0, 4, 0, grid.StepFn()), Down);
+	REQUIRE_EQ(pf.GetDirection(1, 3, 4, 0, grid.StepFn()), Right);
+
+	// Walking along the path reaches the target
+	int x = 0;
+	int y = 0;
+	for (int i = 0; i < 10; ++i) {
+		const int dir = pf.GetDirection(x, y, 4, 0, grid.StepFn());
+		REQUIRE_GE(dir, 0);
+		x += (dir == Right) - (dir == Left);
+		y += (dir == Down) - (dir == Up);
+	}
+	REQUIRE_EQ(x, 4);
+	REQUIRE_EQ(y, 0);
+}
+
+TEST_CASE("Unreachable") {
+	Grid grid { 5, 3, { "..#..", "..#..", "..#.." } };
+	PathFinder pf;
+	pf.Reset(grid.width, grid.height, false, false);
+
+	REQUIRE_EQ(pf.GetDistance(0, 0, 4, 0, grid.StepFn()), -1);
+	REQUIRE_EQ(pf.GetDirection(0, 0, 4, 0, grid.StepFn()), -1);
+}
+
+TEST_CASE("Loop") {
+	Grid grid { 5, 3, { "..#..", "..#..", "..#.." } };
+	PathFinder pf;
+	pf.Reset(grid.width, grid.height, true, false);
+
+	REQUIRE_EQ(pf.GetDistance(0, 0, 4, 0, grid.StepFn()), 1);
+	REQUIRE_EQ(pf.GetDirection(0, 0, 4, 0, grid.StepFn()), Left);
+}
+
+TEST_CASE("Invalidate") {
+	Grid grid { 5, 3, { ".....", ".....", "....." } };
+	PathFinder pf;
+	pf.Reset(grid.width, grid.height, false, false);
+
+	REQUIRE_EQ(pf.GetDistance(0, 0, 4, 0, grid.StepFn()), 4);
+
+	// Cached fields are kept until invalidated
+	grid.rows = { "..#..", "..#..", "..#.." };
+	REQUIRE_EQ(pf.GetDistance(0, 0, 4, 0, grid.StepFn()), 4);
+
+	pf.Invalidate();
+	REQUIRE_EQ(pf.GetDistance(0, 0, 4, 0, grid.StepFn()), -1);
+}
+
+TEST_CASE("ManyTargets") {
+	Grid grid { 12, 3, { "............", "............", "............" } };
+	PathFinder pf;
+	pf.Reset(grid.width, grid.height, false, false);
+
+	for (int i = 0; i < 3; ++i) {
+		for (int target = 0; target < grid.width; ++target) {
+			REQUIRE_EQ(pf.GetDistance(0, 2, target, 0, grid.StepFn()), target + 2);
+		}
+	}
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,57 @@
+#include <cstdint>
+#include "pixel_pool.h"
+#include "doctest.h"
+
+TEST_SUITE_BEGIN("PixelPool");
+
+TEST_CASE("PixelPoolReuse") {
+	PixelPool::Clear();
+	const auto before = PixelPool::GetStats();
+
+	auto* data = static_cast<uint8_t*>(PixelPool::Allocate(320 * 240 * 4));
+	REQUIRE(data != nullptr);
+	REQUIRE_EQ(reinterpret_cast<uintptr_t>(data) % 16, 0);
+	data[0] = 0xFF;
+	PixelPool::Free(data);
+
+	// A slightly smaller buffer is in the same size class and zeroed again
+	auto* reused = static_cast<uint8_t*>(PixelPool::Allocate(320 * 240 * 4 - 64));
+	REQUIRE_EQ(reused, data);
+	REQUIRE_EQ(reused[0], 0);
+
+	const auto stats = PixelPool::GetStats();
+	REQUIRE_EQ(stats.allocations, before.allocations + 2);
+	REQUIRE_EQ(stats.hits, before.hits + 1);
+	REQUIRE_EQ(stats.used, before.used + 1);
+	REQUIRE_EQ(stats.kept, 0);
+
+	PixelPool::Free(reused);
+	REQUIRE_EQ(PixelPool::GetStats().kept, 1);
+	PixelPool::Clear();
+	REQUIRE_EQ(PixelPool::GetStats().kept_bytes, 0);
+}
+
+TEST_CASE("PixelPoolOversized") {
+	const auto before = PixelPool::GetStats();
+
+	void* data = PixelPool::Allocate(2048 * 1024 * 4);
+	REQUIRE(data != nullptr);
+	PixelPool::Free(data);
+
+	const auto stats = PixelPool::GetStats();
+	REQUIRE_EQ(stats.oversized, before.oversized + 1);
+	REQUIRE_EQ(stats.kept, before.kept);
+}
+
+TEST_CASE("PixelPoolLimit") {
+	PixelPool::Clear();
+	PixelPool::SetLimit(0);
+
+	void* data = PixelPool::Allocate(1024);
+	PixelPool::Free(data);
+	REQUIRE_EQ(PixelPool::GetStats().kept, 0);
+
+	PixelPool::SetLimit(8 * 1024 * 1024);
+}
+
+TEST_SUITE_END();
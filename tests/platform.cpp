@@ -75,4 +75,30 @@ TEST_CASE("ReadDirectory") {
 	CHECK(iterations <= 5);
 }
 
+TEST_CASE("FileMapping") {
+	Platform::FileMapping mapping(onekb);
+	if (mapping) {
+		CHECK(mapping.GetSize() == 1024);
+		CHECK(mapping.GetData() != nullptr);
+	}
+
+	CHECK(!Platform::FileMapping(empty));
+	CHECK(!Platform::FileMapping(bad));
+}
+
+TEST_CASE("FileMappingCopyOnWrite") {
+	CHECK(Platform::FileMapping(onekb).GetWritableData() == nullptr);
+
+	Platform::FileMapping mapping(onekb, true);
+	if (mapping) {
+		// Written pages are private, the file keeps its contents
+		mapping.GetWritableData()[0] = 1;
+		CHECK(mapping.GetData()[0] == 1);
+
+		Platform::FileMapping other(onekb);
+		REQUIRE(other);
+		CHECK(other.GetData()[0] == 0);
+	}
+}
+
 TEST_SUITE_END();
@@ -0,0 +1,54 @@
+#include <memory>
+#include "bitmap.h"
+#include "game_config.h"
+#include "graphics.h"
+#include "headless_ui.h"
+#include "options.h"
+#include "player.h"
+#include "doctest.h"
+
+TEST_SUITE_BEGIN("Player");
+
+namespace {
+
+/** Counts the presents, the pixels are read through non-const access while presenting */
+class PresentUi : public HeadlessUi {
+public:
+	PresentUi() : HeadlessUi(SCREEN_TARGET_WIDTH, SCREEN_TARGET_HEIGHT, Game_ConfigVideo()) {}
+
+	void UpdateDisplay() override {
+		main_surface->pixels();
+		++presents;
+	}
+
+	bool CanSkipPresent() const override {
+		return true;
+	}
+
+	int presents = 0;
+};
+
+}
+
+TEST_CASE("SkipUnchangedPresent") {
+	auto ui = std::make_shared<PresentUi>();
+	DisplayUi = ui;
+	Graphics::Init();
+
+	Player::Draw();
+	REQUIRE_EQ(ui->presents, 1);
+
+	// Nothing was drawn since the present
+	Player::Draw();
+	CHECK_EQ(ui->presents, 1);
+
+	// Changed outside of Graphics::Draw
+	DisplayUi->GetDisplaySurface()->Fill(Color(255, 0, 0, 255));
+	Player::Draw();
+	CHECK_EQ(ui->presents, 2);
+
+	Graphics::Quit();
+	DisplayUi.reset();
+}
+
+TEST_SUITE_END();
@@ -19,6 +19,89 @@ TEST_CASE("GetRandomNumber") {
 	testGetRandomNumber(-5, -2);
 }
 
+TEST_CASE("GetRandomNumbers") {
+	for (auto range: { std::make_pair(0, 43), std::make_pair(-21, 31), std::make_pair(5, 5), std::make_pair(INT32_MIN, INT32_MAX) }) {
+		std::vector<int32_t> batch(100);
+		Rand::SeedRandomNumberGenerator(1234);
+		Rand::GetRandomNumbers(MakeSpan(batch), range.first, range.second);
+
+		Rand::SeedRandomNumberGenerator(1234);
+		for (auto x: batch) {
+			REQUIRE_EQ(x, Rand::GetRandomNumber(range.first, range.second));
+		}
+	}
+
+	Rand::LockGuard lk(50);
+	std::vector<int32_t> batch(10);
+	Rand::GetRandomNumbers(MakeSpan(batch), 0, 20);
+	for (auto x: batch) {
+		REQUIRE_EQ(x, 20);
+	}
+}
+
+TEST_CASE("GetRandomNumbersUniform") {
+	// A range which does not divide 2^32, the biased numbers must be rejected
+	constexpr int32_t range = 3;
+	std::vector<int32_t> batch(30000);
+	Rand::SeedRandomNumberGenerator(1234);
+	Rand::GetRandomNumbers(MakeSpan(batch), 0, range - 1);
+
+	int counts[range] = {};
+	for (auto x: batch) {
+		REQUIRE_GE(x, 0);
+		REQUIRE_LT(x, range);
+		++counts[x];
+	}
+	for (auto c: counts) {
+		REQUIRE_GT(c, 9500);
+		REQUIRE_LT(c, 10500);
+	}
+}
+
+TEST_CASE("GetRandomNumberLargeRange") {
+	// 3 * 2^30 numbers, the lower two thirds are [INT32_MIN, 0)
+	constexpr int32_t from = INT32_MIN;
+	constexpr int32_t to = (1 << 30) - 1;
+	std::vector<int32_t> batch(30000);
+	Rand::SeedRandomNumberGenerator(1234);
+	Rand::GetRandomNumbers(MakeSpan(batch), from, to);
+
+	Rand::SeedRandomNumberGenerator(1234);
+	int lower = 0;
+	for (auto x: batch) {
+		REQUIRE_EQ(x, Rand::GetRandomNumber(from, to));
+		lower += x < 0;
+	}
+	REQUIRE_GT(lower, 19500);
+	REQUIRE_LT(lower, 20500);
+}
+
+TEST_CASE("Streams") {
+	std::vector<int32_t> expected(100);
+	Rand::SeedRandomNumberGenerator(1234);
+	Rand::GetRandomNumbers(MakeSpan(expected), 0, 1000);
+
+	// Cosmetic numbers in between don't change the game stream
+	Rand::SeedRandomNumberGenerator(1234);
+	for (auto x: expected) {
+		Rand::GetCosmeticNumber(0, 1000);
+		Rand::GetRNG(Rand::Stream::Cosmetic)();
+		REQUIRE_EQ(x, Rand::GetRandomNumber(0, 1000));
+	}
+
+	// The lock only fixes the game stream
+	Rand::LockGuard lk(50);
+	REQUIRE_EQ(Rand::GetRandomNumber(0, 20), 20);
+	bool varied = false;
+	for (int i = 0; i < 100; ++i) {
+		auto x = Rand::GetCosmeticNumber(0, 20);
+		REQUIRE_GE(x, 0);
+		REQUIRE_LE(x, 20);
+		varied |= x != 20;
+	}
+	REQUIRE(varied);
+}
+
 TEST_CASE("Lock") {
 	REQUIRE_FALSE(Rand::GetRandomLocked().first);
 
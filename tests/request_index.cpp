@@ -0,0 +1,76 @@
+#include <string>
+#include "request_index.h"
+#include "doctest.h"
+
+TEST_SUITE_BEGIN("RequestIndex");
+
+namespace {
+
+std::vector<std::pair<std::string, std::string>> MakeEntries(int count) {
+	std::vector<std::pair<std::string, std::string>> entries;
+	for (int i = 0; i < count; ++i) {
+		entries.emplace_back("charset/hero" + std::to_string(i), "CharSet/Hero" + std::to_string(i) + ".png");
+	}
+	entries.emplace_back("rpg_rt.ldb", "RPG_RT.ldb");
+	return entries;
+}
+
+}
+
+TEST_CASE("Find") {
+	RequestIndex index;
+	REQUIRE(index.Load(RequestIndex::Build(MakeEntries(500))));
+	REQUIRE(index.IsLoaded());
+	REQUIRE_EQ(index.GetSize(), 501);
+
+	for (int i = 0; i < 500; ++i) {
+		REQUIRE_EQ(ToString(index.Find("charset/hero" + std::to_string(i))), "CharSet/Hero" + std::to_string(i) + ".png");
+	}
+	REQUIRE_EQ(ToString(index.Find("rpg_rt.ldb")), "RPG_RT.ldb");
+	REQUIRE(index.Find("charset/hero500").empty());
+	REQUIRE(index.Find("").empty());
+}
+
+TEST_CASE("FindParts") {
+	RequestIndex index;
+	REQUIRE(index.Load(RequestIndex::Build(MakeEntries(50))));
+
+	REQUIRE_EQ(ToString(index.Find({ "charset/", "hero", "7" })), "CharSet/Hero7.png");
+	REQUIRE_EQ(ToString(index.Find({ "", "rpg_rt.ldb", "" })), "RPG_RT.ldb");
+	REQUIRE_EQ(RequestIndex::Hash("hero7", RequestIndex::Hash("charset/")), RequestIndex::Hash("charset/hero7"));
+	REQUIRE(index.Find({ "charset/", "hero" }).empty());
+	REQUIRE(index.Find({ "charset/hero7", "x" }).empty());
+}
+
+TEST_CASE("Empty") {
+	RequestIndex index;
+	REQUIRE_FALSE(index.IsLoaded());
+	REQUIRE(index.Find("rpg_rt.ldb").empty());
+
+	REQUIRE(index.Load(RequestIndex::Build({})));
+	REQUIRE_EQ(index.GetSize(), 0);
+	REQUIRE(index.Find("rpg_rt.ldb").empty());
+}
+
+TEST_CASE("Invalid") {
+	RequestIndex index;
+	auto data = RequestIndex::Build(MakeEntries(10));
+
+	auto truncated = data;
+	truncated.pop_back();
+	REQUIRE_FALSE(index.Load(truncated));
+	REQUIRE_FALSE(index.IsLoaded());
+
+	auto bad_magic = data;
+	bad_magic[0] = 'X';
+	REQUIRE_FALSE(index.Load(bad_magic));
+
+	// Entry count larger than the file
+	auto bad_count = data;
+	bad_count[11] = 0x7F;
+	REQUIRE_FALSE(index.Load(bad_count));
+
+	REQUIRE_FALSE(index.Load({ '{', '}' }));
+}
+
+TEST_SUITE_END();
@@ -80,6 +80,19 @@ TEST_CASE("RTP 2003: Detection") {
 	REQUIRE(hits[1].hits == 1);
 }
 
+TEST_CASE("RTP 2000: Detection counts a name once") {
+	auto tree = make_tree();
+	// Same name with another supported extension and with an unsupported one
+	tree->sub_members["sound"]["カーソル1.mp3"] = "カーソル1.mp3";
+	tree->sub_members["faceset"]["主人公1.bmp"] = "主人公1.bmp";
+
+	std::vector<RTP::RtpHitInfo> hits = RTP::Detect(tree, 2000);
+
+	REQUIRE(hits.size() == 2);
+	REQUIRE(hits[0].type == RTP::Type::RPG2000_OfficialJapanese);
+	REQUIRE(hits[0].hits == 4);
+}
+
 TEST_CASE("RTP 2000: Lookup Any to RTP with 1 hit") {
 	auto types = RTP::LookupAnyToRtp("faceset", "actor1", 2000);
 
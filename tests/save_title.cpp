@@ -0,0 +1,61 @@
+#include "save_title.h"
+#include "doctest.h"
+#include <sstream>
+#include <lcf/lsd/reader.h>
+
+TEST_SUITE_BEGIN("SaveTitle");
+
+namespace {
+
+std::string MakeSavegame() {
+	lcf::rpg::Save save;
+	save.title.timestamp = 44000.5;
+	save.title.hero_name = "Alex";
+	save.title.hero_level = 42;
+	save.title.hero_hp = 999;
+	save.title.face1_name = "Actor1";
+	save.title.face1_id = 3;
+	save.title.face4_name = "Actor4";
+	save.title.face4_id = 7;
+	save.party_location.map_id = 12;
+	save.system.switches.resize(200, true);
+
+	std::stringstream ss(std::ios_base::in | std::ios_base::out | std::ios_base::binary);
+	lcf::LSD_Reader::Save(ss, save, lcf::EngineVersion::e2k3, "1252");
+	return ss.str();
+}
+
+}
+
+TEST_CASE("Load") {
+	std::istringstream is(MakeSavegame(), std::ios_base::in | std::ios_base::binary);
+	auto title = SaveTitle::Load(is, "1252");
+	REQUIRE(title);
+
+	CHECK_EQ(title->timestamp, 44000.5);
+	CHECK_EQ(title->hero_name, "Alex");
+	CHECK_EQ(title->hero_level, 42);
+	CHECK_EQ(title->hero_hp, 999);
+	CHECK_EQ(title->face1_name, "Actor1");
+	CHECK_EQ(title->face1_id, 3);
+	CHECK_EQ(title->face2_name, "");
+	CHECK_EQ(title->face4_name, "Actor4");
+	CHECK_EQ(title->face4_id, 7);
+}
+
+TEST_CASE("Truncated") {
+	auto data = MakeSavegame();
+	data.resize(data.size() - 10);
+	std::istringstream is(data, std::ios_base::in | std::ios_base::binary);
+	CHECK_FALSE(SaveTitle::Load(is, "1252"));
+}
+
+TEST_CASE("NotASavegame") {
+	std::istringstream is(std::string("\x0bLcfMapUnit\x00", 12), std::ios_base::in | std::ios_base::binary);
+	CHECK_FALSE(SaveTitle::Load(is, "1252"));
+
+	std::istringstream empty;
+	CHECK_FALSE(SaveTitle::Load(empty, "1252"));
+}
+
+TEST_SUITE_END();
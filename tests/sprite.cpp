@@ -0,0 +1,133 @@
+#include <algorithm>
+#include <initializer_list>
+#include <cstdint>
+#include "sprite.h"
+#include "bitmap.h"
+#include "drawable_list.h"
+#include "drawable_mgr.h"
+#include "pixel_format.h"
+#include "doctest.h"
+
+TEST_SUITE_BEGIN("Sprite");
+
+namespace {
+
+class CachedSprite : public Sprite {
+public:
+	CachedSprite() {
+		SetTransformCache(true);
+	}
+};
+
+class FlashSprite : public Sprite {
+public:
+	FlashSprite() {
+		SetFlashBuffer(true);
+	}
+};
+
+BitmapRef MakeBitmap(int width, int height) {
+	auto bitmap = Bitmap::Create(width, height, true);
+	for (int y = 0; y < height; ++y) {
+		auto* row = reinterpret_cast<uint32_t*>(static_cast<uint8_t*>(bitmap->pixels()) + y * bitmap->pitch());
+		for (int x = 0; x < width; ++x) {
+			const uint8_t a = (x + y) % 4 == 0 ? 128 : 255;
+			row[x] = Bitmap::pixel_format.rgba_to_uint32_t((x * 17) * a / 255 % 256,
+					(y * 29) * a / 255 % 256, 64 * a / 255, a);
+		}
+	}
+	return bitmap;
+}
+
+BitmapRef MakeScreen() {
+	return Bitmap::Create(80, 60, Color(20, 40, 60, 255));
+}
+
+void Setup(Sprite& sprite, const BitmapRef& bitmap, int x) {
+	sprite.SetBitmap(bitmap);
+	sprite.SetX(x);
+	sprite.SetY(30);
+	sprite.SetOx(bitmap->GetWidth() / 2);
+	sprite.SetOy(bitmap->GetHeight() / 2);
+	sprite.SetZoomX(1.5);
+	sprite.SetZoomY(1.25);
+	sprite.SetOpacity(200);
+}
+
+bool SamePixels(const Bitmap& l, const Bitmap& r) {
+	for (int y = 0; y < l.GetHeight(); ++y) {
+		auto* lrow = static_cast<const uint8_t*>(l.pixels()) + y * l.pitch();
+		auto* rrow = static_cast<const uint8_t*>(r.pixels()) + y * r.pitch();
+		if (!std::equal(lrow, lrow + l.GetWidth() * 4, rrow)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+}
+
+TEST_CASE("TransformCache") {
+	Bitmap::SetFormat(format_R8G8B8A8_a().format());
+	DrawableList list;
+	DrawableMgr::SetLocalList(&list);
+
+	auto bitmap = MakeBitmap(24, 16);
+	{
+		Sprite sprite;
+		CachedSprite cached;
+		Setup(sprite, bitmap, 40);
+		Setup(cached, bitmap, 40);
+
+		// The first frames create the cache, later ones draw from it
+		for (int frame = 0; frame < 4; ++frame) {
+			if (frame == 2) {
+				sprite.SetX(10);
+				cached.SetX(10);
+			}
+			auto expected = MakeScreen();
+			auto result = MakeScreen();
+			sprite.Draw(*expected);
+			cached.Draw(*result);
+			REQUIRE(SamePixels(*expected, *result));
+		}
+	}
+
+	DrawableMgr::SetLocalList(nullptr);
+}
+
+TEST_CASE("FlashBuffer") {
+	Bitmap::SetFormat(format_R8G8B8A8_a().format());
+	DrawableList list;
+	DrawableMgr::SetLocalList(&list);
+
+	auto bitmap = MakeBitmap(48, 96);
+	{
+		Sprite sprite;
+		FlashSprite flash;
+		for (auto* s: { &sprite, static_cast<Sprite*>(&flash) }) {
+			s->SetBitmap(bitmap);
+			s->SetSpriteRect(Rect(0, 48, 48, 48));
+			s->SetSrcRect(Rect(16, 0, 16, 48));
+			s->SetX(20);
+			s->SetY(5);
+			s->SetFlipX(true);
+		}
+
+		// Fading flash, then no flash at all
+		for (int alpha: { 200, 150, 100, 50, 0 }) {
+			sprite.SetFlashEffect(Color(255, 255, 255, alpha));
+			flash.SetFlashEffect(Color(255, 255, 255, alpha));
+
+			auto expected = MakeScreen();
+			auto result = MakeScreen();
+			sprite.Draw(*expected);
+			flash.Draw(*result);
+			REQUIRE(SamePixels(*expected, *result));
+		}
+	}
+
+	DrawableMgr::SetLocalList(nullptr);
+}
+
+TEST_SUITE_END();
@@ -122,6 +122,74 @@ TEST_CASE("FlipRange") {
 	REQUIRE_FALSE(s.Get(n + 1));
 }
 
+TEST_CASE("RangeWords") {
+	constexpr int n = 200;
+	auto s = make();
+
+	s.SetRange(60, 130, true);
+	for (int i = 1; i <= n; ++i) {
+		REQUIRE_EQ(s.Get(i), i >= 60 && i <= 130);
+	}
+
+	s.FlipRange(64, 129);
+	for (int i = 1; i <= n; ++i) {
+		REQUIRE_EQ(s.Get(i), (i >= 60 && i < 64) || i == 130);
+	}
+
+	REQUIRE_EQ(s.GetData().size(), 130);
+}
+
+TEST_CASE("Data") {
+	auto s = make();
+	Game_Switches::Switches_t data = { true, false, true };
+	s.SetData(data);
+
+	REQUIRE(s.Get(1));
+	REQUIRE_FALSE(s.Get(2));
+	REQUIRE(s.Get(3));
+	REQUIRE_FALSE(s.Get(4));
+	REQUIRE_EQ(s.GetData(), data);
+	REQUIRE(s.GetChanges().empty());
+}
+
+TEST_CASE("Changes") {
+	auto s = make();
+
+	s.Set(3, false);
+	REQUIRE(s.GetChanges().empty());
+
+	s.Set(3, true);
+	s.Flip(1);
+	s.SetRange(1, 4, true);
+	REQUIRE_EQ(s.GetChanges(), std::vector<int>{ 3, 1, 2, 4 });
+
+	s.ClearChanges();
+	REQUIRE(s.GetChanges().empty());
+
+	s.FlipRange(2, 3);
+	REQUIRE_EQ(s.GetChanges(), std::vector<int>{ 2, 3 });
+}
+
+TEST_CASE("Revision") {
+	auto s = make();
+	auto rev = s.GetRevision();
+
+	s.Set(2, false);
+	s.SetRange(1, 3, false);
+	REQUIRE_EQ(s.GetRevision(), rev);
+
+	s.Set(2, true);
+	REQUIRE_NE(s.GetRevision(), rev);
+
+	rev = s.GetRevision();
+	s.FlipRange(1, 2);
+	REQUIRE_NE(s.GetRevision(), rev);
+
+	rev = s.GetRevision();
+	s.SetData({});
+	REQUIRE_NE(s.GetRevision(), rev);
+}
+
 TEST_CASE("GetSize") {
 	auto s = make();
 	REQUIRE_EQ(s.GetSize(), max_switches);
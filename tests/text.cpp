@@ -3,6 +3,7 @@
 #include "cache.h"
 #include "bitmap.h"
 #include "font.h"
+#include <algorithm>
 #include <iostream>
 #include "doctest.h"
 
@@ -31,6 +32,28 @@ TEST_CASE("TextDrawSystemStrReturn") {
 	REQUIRE_EQ(draw(3, 17, "$A $B"), Rect(3, 17, cwf * 2 + cwh, ch));
 }
 
+TEST_CASE("TextDrawSystemStrCached") {
+	Bitmap::SetFormat(format_R8G8B8A8_a().format());
+	auto font = Font::Default();
+	auto system = Cache::SysBlack();
+	auto expected = Bitmap::Create(width, height);
+	auto actual = Bitmap::Create(width, height);
+
+	int x = 5;
+	for (char32_t c: { U'a', U'b', U'c' }) {
+		x += Text::Draw(*expected, x, 7, *font, *system, 0, c, false).width;
+	}
+
+	// Second draw comes from the cache
+	REQUIRE_EQ(Text::Draw(*actual, 5, 7, *font, *system, 0, "abc"), Rect(5, 7, cwh * 3, ch));
+	actual->Clear();
+	REQUIRE_EQ(Text::Draw(*actual, 5, 7, *font, *system, 0, "abc"), Rect(5, 7, cwh * 3, ch));
+
+	const auto size = static_cast<size_t>(actual->pitch() * actual->GetHeight());
+	REQUIRE(std::equal(static_cast<const uint8_t*>(expected->pixels()), static_cast<const uint8_t*>(expected->pixels()) + size,
+		static_cast<const uint8_t*>(actual->pixels())));
+}
+
 TEST_CASE("TextDrawColorStrReturn") {
 	Bitmap::SetFormat(format_R8G8B8A8_a().format());
 	auto font = Font::Default();
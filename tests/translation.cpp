@@ -0,0 +1,61 @@
+#include <sstream>
+#include "translation.h"
+#include "doctest.h"
+
+TEST_SUITE_BEGIN("Translation");
+
+namespace {
+
+constexpr char po_file[] =
+	"msgid \"\"\n"
+	"msgstr \"\"\n"
+	"\n"
+	"msgctxt \"actors.1.name\"\n"
+	"msgid \"Alex\"\n"
+	"msgstr \"Alejandro\"\n"
+	"\n"
+	"msgid \"Alex\"\n"
+	"msgstr \"Alexander\"\n"
+	"\n"
+	"msgid \"Potion\"\n"
+	"msgstr \"\"\n";
+
+}
+
+TEST_CASE("FromPo") {
+	std::istringstream in(po_file);
+	Dictionary dict;
+	REQUIRE(Dictionary::FromPo(dict, in));
+
+	std::string name = "Alex";
+	REQUIRE(dict.TranslateString("actors.1.name", name));
+	REQUIRE_EQ(name, "Alejandro");
+
+	name = "Alex";
+	REQUIRE(dict.TranslateString("", name));
+	REQUIRE_EQ(name, "Alexander");
+
+	// Empty translations are not stored
+	std::string item = "Potion";
+	REQUIRE_FALSE(dict.TranslateString("", item));
+	REQUIRE_EQ(item, "Potion");
+
+	name = "Alex";
+	REQUIRE_FALSE(dict.TranslateString("actors.2.name", name));
+}
+
+TEST_CASE("FromCatalog") {
+	std::istringstream in(po_file);
+	Dictionary parsed;
+	REQUIRE(Dictionary::FromPo(parsed, in));
+
+	Dictionary dict;
+	REQUIRE(Dictionary::FromCatalog(dict, parsed.GetCatalog()));
+	std::string name = "Alex";
+	REQUIRE(dict.TranslateString("actors.1.name", name));
+	REQUIRE_EQ(name, "Alejandro");
+
+	REQUIRE_FALSE(Dictionary::FromCatalog(dict, { 1, 2, 3 }));
+}
+
+TEST_SUITE_END();
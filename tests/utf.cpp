@@ -58,6 +58,47 @@ TEST_CASE("8to32") {
 	}
 }
 
+TEST_CASE("8to16Buffer") {
+	std::u16string u16 = u"leftover";
+	for (auto& ts: tests) {
+		Utils::DecodeUTF16(ts.u8, u16);
+		REQUIRE_EQ(u16, ts.u16);
+	}
+}
+
+TEST_CASE("8to32Buffer") {
+	std::u32string u32 = U"leftover";
+	for (auto& ts: tests) {
+		Utils::DecodeUTF32(ts.u8, u32);
+		REQUIRE_EQ(u32, ts.u32);
+	}
+}
+
+TEST_CASE("8to32AsciiRuns") {
+	// Longer than the SIMD blocks, with multibyte characters at every position
+	const std::string ascii = "The quick brown fox jumps over the lazy dog";
+	for (size_t i = 0; i <= ascii.size(); ++i) {
+		std::string u8 = ascii;
+		u8.insert(i, u8"κ下");
+		std::u32string u32(ascii.begin(), ascii.end());
+		u32.insert(i, U"κ下");
+		REQUIRE_EQ(Utils::DecodeUTF32(u8), u32);
+	}
+}
+
+TEST_CASE("SkipAscii") {
+	const std::string text = std::string(40, 'a') + u8"ぽ" + "b";
+	const auto* begin = text.data();
+	const auto* end = text.data() + text.size();
+
+	for (size_t i = 0; i <= 40; ++i) {
+		REQUIRE_EQ(Utils::UTF8SkipAscii(begin + i, end), begin + 40);
+	}
+	REQUIRE_EQ(Utils::UTF8SkipAscii(begin + 40, end), begin + 40);
+	REQUIRE_EQ(Utils::UTF8SkipAscii(end - 1, end), end);
+	REQUIRE_EQ(Utils::UTF8SkipAscii(end, end), end);
+}
+
 TEST_CASE("16to8") {
 	for (auto& ts: tests) {
 		auto u8 = Utils::EncodeUTF(ts.u16);
@@ -1,5 +1,6 @@
 #include <cassert>
 #include <cstdlib>
+#include <sstream>
 #include "utils.h"
 #include "doctest.h"
 
@@ -51,4 +52,24 @@ TEST_CASE("StrICmp") {
 	}
 }
 
+TEST_CASE("CRC32") {
+	const std::string check = "123456789";
+	const auto* data = reinterpret_cast<const uint8_t*>(check.data());
+
+	REQUIRE_EQ(Utils::CRC32(Span<const uint8_t>()), 0u);
+	REQUIRE_EQ(Utils::CRC32(Span<const uint8_t>(data, check.size())), 0xCBF43926);
+
+	// Continued over several pieces
+	auto crc = Utils::CRC32(Span<const uint8_t>(data, 3));
+	crc = Utils::CRC32(Span<const uint8_t>(data + 3, check.size() - 3), crc);
+	REQUIRE_EQ(crc, 0xCBF43926);
+
+	std::string large;
+	for (int i = 0; i < 20000; ++i) {
+		large.push_back(static_cast<char>(i * 7));
+	}
+	std::istringstream is(large);
+	REQUIRE_EQ(Utils::CRC32(is), Utils::CRC32(Span<const uint8_t>(reinterpret_cast<const uint8_t*>(large.data()), large.size())));
+}
+
 TEST_SUITE_END();
@@ -176,6 +176,65 @@ TEST_CASE("Mod") {
 	REQUIRE_EQ(s.Get(2), 0);
 }
 
+TEST_CASE("RangeLong") {
+	// Long enough for the vectorized kernels and their scalar tail
+	constexpr int n = 37;
+	auto s = make();
+	for (int i = 1; i <= n; ++i) {
+		s.Set(i, (i % 2 ? 1 : -1) * i * 250000);
+	}
+
+	auto expect = [&](auto op) {
+		std::vector<Game_Variables::Var_t> vals;
+		for (int i = 1; i <= n; ++i) {
+			int64_t v = op(static_cast<int64_t>(s.Get(i)));
+			vals.push_back(static_cast<Game_Variables::Var_t>(std::min<int64_t>(std::max<int64_t>(v, minval), maxval)));
+		}
+		return vals;
+	};
+	auto check = [&](const std::vector<Game_Variables::Var_t>& vals) {
+		for (int i = 1; i <= n; ++i) {
+			REQUIRE_EQ(s.Get(i), vals[i - 1]);
+		}
+	};
+
+	auto vals = expect([](int64_t v) { return v + 3000000; });
+	s.AddRange(1, n, 3000000);
+	check(vals);
+
+	vals = expect([](int64_t v) { return v - 5000000; });
+	s.SubRange(1, n, 5000000);
+	check(vals);
+
+	vals = expect([](int64_t v) { return v * -3; });
+	s.MultRange(1, n, -3);
+	check(vals);
+
+	vals = expect([](int64_t v) { return v / 7; });
+	s.DivRange(1, n, 7);
+	check(vals);
+
+	vals = expect([](int64_t v) { return v % 1000; });
+	s.ModRange(1, n, 1000);
+	check(vals);
+}
+
+TEST_CASE("RangeWrap") {
+	// The 32 bit result wraps around before it is clamped
+	auto s = make();
+	s.SetRange(1, 20, 4);
+	s.MultRange(1, 20, 1 << 30);
+	for (int i = 1; i <= 20; ++i) {
+		REQUIRE_EQ(s.Get(i), 0);
+	}
+
+	s.SetRange(1, 20, maxval);
+	s.AddRange(1, 20, INT32_MAX);
+	for (int i = 1; i <= 20; ++i) {
+		REQUIRE_EQ(s.Get(i), minval);
+	}
+}
+
 TEST_CASE("RangeVariable") {
 	constexpr int n = max_vars * 2;
 	auto s = make();
@@ -279,6 +338,26 @@ TEST_CASE("RangeRandom") {
 	REQUIRE_NE(first_diff, 0);
 }
 
+TEST_CASE("Revision") {
+	auto s = make();
+	auto rev = s.GetRevision();
+
+	s.Set(0, 1);
+	s.SetRange(3, 2, 1);
+	REQUIRE_EQ(s.GetRevision(), rev);
+
+	s.Set(2, 5);
+	REQUIRE_NE(s.GetRevision(), rev);
+
+	rev = s.GetRevision();
+	s.AddRange(1, 3, 1);
+	REQUIRE_NE(s.GetRevision(), rev);
+
+	rev = s.GetRevision();
+	s.SetData({});
+	REQUIRE_NE(s.GetRevision(), rev);
+}
+
 
 
 TEST_SUITE_END();